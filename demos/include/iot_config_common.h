@@ -123,6 +123,8 @@
     #define IotMqtt_FreeOperation                vPortFree
     #define IotMqtt_MallocSubscription           pvPortMalloc
     #define IotMqtt_FreeSubscription             vPortFree
+    #define IotMqtt_MallocTopicNode              pvPortMalloc
+    #define IotMqtt_FreeTopicNode                vPortFree
 
     #define IotSerializer_MallocCborEncoder      pvPortMalloc
     #define IotSerializer_FreeCborEncoder        vPortFree
@@ -53,6 +53,19 @@
  */
 typedef struct _networkConnection IotNetworkConnectionAfr_t;
 
+/**
+ * @brief Receive counters of a network connection that uses FreeRTOS Secure
+ * Sockets.
+ *
+ * The average number of bytes per socket read is `socketBytes / socketReads`.
+ */
+typedef struct IotNetworkAfrReceiveStats
+{
+    uint32_t socketReads;   /**< @brief Number of socket reads that returned data. */
+    uint32_t socketBytes;   /**< @brief Total bytes returned by socket reads. */
+    uint32_t bufferedBytes; /**< @brief Bytes passed to the application from the receive buffer. */
+} IotNetworkAfrReceiveStats_t;
+
 /**
  * @brief Provides a default value for an #IotNetworkConnectionAfr_t.
  *
@@ -143,6 +156,14 @@ size_t IotNetworkAfr_Send( void * pConnection,
                            const uint8_t * pMessage,
                            size_t messageLength );
 
+/**
+ * @brief An implementation of #IotNetworkInterface_t::sendv for FreeRTOS
+ * Secure Sockets.
+ */
+size_t IotNetworkAfr_Sendv( void * pConnection,
+                            const IotNetworkIoVector_t * pVectors,
+                            size_t vectorCount );
+
 /**
  * @brief An implementation of #IotNetworkInterface_t::receive for FreeRTOS
  * Secure Sockets.
@@ -171,6 +192,31 @@ IotNetworkError_t IotNetworkAfr_Close( void * pConnection );
  */
 IotNetworkError_t IotNetworkAfr_Destroy( void * pConnection );
 
+/**
+ * @brief Get the receive counters of a network connection.
+ *
+ * @param[in] pConnection The connection to query.
+ * @param[out] pStats Set to the connection's receive counters.
+ */
+void IotNetworkAfr_GetReceiveStats( void * pConnection,
+                                    IotNetworkAfrReceiveStats_t * pStats );
+
+/**
+ * @brief Get the stack memory reserved by all network receive tasks.
+ *
+ * By default, each connection with a receive callback has its own receive
+ * task. If `IOT_NETWORK_SHARED_RECEIVE_TASK` is `1`, a single task reads all
+ * connections and runs receive callbacks in a dedicated task pool of
+ * `IOT_NETWORK_CALLBACK_THREADS` threads, so this value does not grow with the
+ * number of connections.
+ *
+ * This is the stack size the tasks were created with, not their actual use;
+ * use `uxTaskGetStackHighWaterMark` to measure the latter.
+ *
+ * @return The number of bytes of stack reserved for network receive tasks.
+ */
+size_t IotNetworkAfr_GetReceiveTaskStackBytes( void );
+
 /**
  * @cond DOXYGEN_IGNORE
  * Doxygen should ignore this section.
@@ -45,6 +45,34 @@
 /* FreeRTOS network include. */
 #include "platform/iot_network_freertos.h"
 
+/* Provide a default value for the shared receive task option. */
+#ifndef IOT_NETWORK_SHARED_RECEIVE_TASK
+    #define IOT_NETWORK_SHARED_RECEIVE_TASK    ( 0 )
+#endif
+
+#if IOT_NETWORK_SHARED_RECEIVE_TASK == 1
+    /* Container and task pool includes. */
+    #include "iot_linear_containers.h"
+    #include "iot_taskpool.h"
+
+/* Provide a default for how often the shared receive task reads connections
+ * whose sockets cannot notify it of new data, and how long it waits before
+ * invoking the receive callback again when the receive buffer is full. */
+    #ifndef IOT_NETWORK_SHARED_RECEIVE_POLL_MS
+        #define IOT_NETWORK_SHARED_RECEIVE_POLL_MS    ( 10 )
+    #endif
+
+/* Provide a default number of threads that run receive callbacks for the
+ * connections read by the shared receive task. */
+    #ifndef IOT_NETWORK_CALLBACK_THREADS
+        #define IOT_NETWORK_CALLBACK_THREADS    ( 1 )
+    #endif
+
+    #if IOT_NETWORK_CALLBACK_THREADS < 1
+        #error "IOT_NETWORK_CALLBACK_THREADS must be at least 1."
+    #endif
+#endif
+
 /* Configure logs for the functions in this file. */
 #ifdef IOT_LOG_LEVEL_NETWORK
     #define LIBRARY_LOG_LEVEL        IOT_LOG_LEVEL_NETWORK
@@ -65,6 +93,18 @@
     #define IOT_NETWORK_SOCKET_POLL_MS    ( 1000 )
 #endif
 
+/* Provide a default size for each connection's receive buffer. Incoming data is
+ * read from the socket in chunks of up to this size. */
+#ifndef IOT_NETWORK_RECEIVE_BUFFER_SIZE
+    #define IOT_NETWORK_RECEIVE_BUFFER_SIZE    ( 512 )
+#endif
+
+/* Provide a default size for the stack buffer that IotNetworkAfr_Sendv uses to
+ * join small buffers, so that each one is not sent as its own TLS record. */
+#ifndef IOT_NETWORK_SENDV_COALESCE_SIZE
+    #define IOT_NETWORK_SENDV_COALESCE_SIZE    ( 128 )
+#endif
+
 /**
  * @brief The event group bit to set when a connection's socket is shut down.
  */
@@ -81,6 +121,12 @@
  */
 #define _FLAG_CONNECTION_DESTROYED    ( 4 )
 
+/**
+ * @brief The event group bit that is set while the shared receive task is
+ * neither reading a connection's socket nor running its receive callback.
+ */
+#define _FLAG_CALLBACK_IDLE           ( 8 )
+
 /*-----------------------------------------------------------*/
 
 typedef struct _networkConnection
@@ -91,12 +137,76 @@ typedef struct _networkConnection
     TaskHandle_t receiveTask;                    /**< @brief Handle of the receive task, if any. */
     IotNetworkReceiveCallback_t receiveCallback; /**< @brief Network receive callback, if any. */
     void * pReceiveContext;                      /**< @brief The context for the receive callback. */
-    bool bufferedByteValid;                      /**< @brief Used to determine if the buffered byte is valid. */
-    uint8_t bufferedByte;                        /**< @brief A single byte buffered from a receive, since AFR Secure Sockets does not have poll(). */
+
+    /* Data read from the socket but not yet passed to the application, held
+     * in receiveBuffer[ receiveStart ] to receiveBuffer[ receiveEnd - 1 ]. */
+    size_t receiveStart;                                       /**< @brief Index of the first unread byte in the receive buffer. */
+    size_t receiveEnd;                                         /**< @brief Index after the last unread byte in the receive buffer. */
+    IotNetworkAfrReceiveStats_t receiveStats;                  /**< @brief Receive counters for this connection. */
+    uint8_t receiveBuffer[ IOT_NETWORK_RECEIVE_BUFFER_SIZE ]; /**< @brief Buffers socket reads, since AFR Secure Sockets does not have poll(). */
+
+    #if IOT_NETWORK_SHARED_RECEIVE_TASK == 1
+        IotLink_t link;                      /**< @brief Link in the list of connections read by the shared receive task. */
+        bool receiveClosed;                  /**< @brief Set when a socket read fails; the connection is no longer read. */
+        bool wakeupEnabled;                  /**< @brief Whether the socket notifies the shared receive task of new data. */
+        TaskHandle_t callbackTask;           /**< @brief The task running the receive callback, if any. */
+        IotTaskPoolJobStorage_t jobStorage;  /**< @brief Storage of the job that runs the receive callback. */
+        IotTaskPoolJob_t job;                /**< @brief The job that runs the receive callback. */
+    #endif
 } _networkConnection_t;
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Number of network receive tasks that currently exist.
+ */
+static volatile uint32_t _receiveTaskCount = 0;
+
+#if IOT_NETWORK_SHARED_RECEIVE_TASK == 1
+
+/*
+ * States of the shared receive task.
+ */
+    #define _SHARED_RECEIVE_TASK_STOPPED     ( 0 ) /**< @brief The shared receive task has not been created. */
+    #define _SHARED_RECEIVE_TASK_STARTING    ( 1 ) /**< @brief The shared receive task is being created. */
+    #define _SHARED_RECEIVE_TASK_RUNNING     ( 2 ) /**< @brief The shared receive task is running. */
+
+/**
+ * @brief State of the shared receive task.
+ */
+    static volatile uint32_t _sharedReceiveTaskState = _SHARED_RECEIVE_TASK_STOPPED;
+
+/**
+ * @brief Handle of the task that reads all connections, created on first use.
+ */
+    static TaskHandle_t _sharedReceiveTaskHandle = NULL;
+
+/**
+ * @brief Connections read by the shared receive task.
+ */
+    static IotListDouble_t _sharedReceiveList;
+
+/**
+ * @brief Number of connections in #_sharedReceiveList whose sockets do not
+ * support `SOCKETS_SO_WAKEUP_CALLBACK`. The shared receive task polls while
+ * this is not 0.
+ */
+    static size_t _sharedReceivePollCount = 0;
+
+/**
+ * @brief Protects #_sharedReceiveList.
+ */
+    static StaticSemaphore_t _sharedReceiveMutex;
+
+/**
+ * @brief Task pool that runs receive callbacks, created with the shared receive
+ * task.
+ */
+    static IotTaskPool_t _networkTaskPool = NULL;
+#endif
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief An #IotNetworkInterface_t that uses the functions in this file.
  */
@@ -108,7 +218,8 @@ const IotNetworkInterface_t IotNetworkAfr =
     .receive            = IotNetworkAfr_Receive,
     .receiveUpto        = IotNetworkAfr_ReceiveUpto,
     .close              = IotNetworkAfr_Close,
-    .destroy            = IotNetworkAfr_Destroy
+    .destroy            = IotNetworkAfr_Destroy,
+    .sendv              = IotNetworkAfr_Sendv
 };
 
 /*-----------------------------------------------------------*/
@@ -134,6 +245,85 @@ static void _destroyConnection( _networkConnection_t * pNetworkConnection )
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Read as much data as fits from the socket into the receive buffer.
+ *
+ * @param[in] pNetworkConnection The connection to read.
+ *
+ * @return The return value of `SOCKETS_Recv`, or `SOCKETS_ENOMEM` if the
+ * receive buffer is full. `SOCKETS_ENOMEM` means the application has not
+ * consumed the buffered data yet; it is not a connection error.
+ */
+static int32_t _fillReceiveBuffer( _networkConnection_t * pNetworkConnection )
+{
+    int32_t socketStatus = SOCKETS_ENOMEM;
+
+    /* Move any unread data to the front of the buffer to make room. */
+    if( pNetworkConnection->receiveStart > 0 )
+    {
+        pNetworkConnection->receiveEnd -= pNetworkConnection->receiveStart;
+        ( void ) memmove( pNetworkConnection->receiveBuffer,
+                          pNetworkConnection->receiveBuffer + pNetworkConnection->receiveStart,
+                          pNetworkConnection->receiveEnd );
+        pNetworkConnection->receiveStart = 0;
+    }
+
+    if( pNetworkConnection->receiveEnd < IOT_NETWORK_RECEIVE_BUFFER_SIZE )
+    {
+        socketStatus = SOCKETS_Recv( pNetworkConnection->socket,
+                                     pNetworkConnection->receiveBuffer + pNetworkConnection->receiveEnd,
+                                     IOT_NETWORK_RECEIVE_BUFFER_SIZE - pNetworkConnection->receiveEnd,
+                                     0 );
+
+        if( socketStatus > 0 )
+        {
+            pNetworkConnection->receiveEnd += ( size_t ) socketStatus;
+            pNetworkConnection->receiveStats.socketReads++;
+            pNetworkConnection->receiveStats.socketBytes += ( uint32_t ) socketStatus;
+        }
+    }
+
+    return socketStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Copy unread data from the receive buffer.
+ *
+ * @param[in] pNetworkConnection The connection to read.
+ * @param[out] pBuffer Where to copy the data.
+ * @param[in] bufferSize The size of `pBuffer`.
+ *
+ * @return The number of bytes copied.
+ */
+static size_t _readReceiveBuffer( _networkConnection_t * pNetworkConnection,
+                                  uint8_t * pBuffer,
+                                  size_t bufferSize )
+{
+    size_t bytesCopied = pNetworkConnection->receiveEnd - pNetworkConnection->receiveStart;
+
+    if( bytesCopied > bufferSize )
+    {
+        bytesCopied = bufferSize;
+    }
+
+    if( bytesCopied > 0 )
+    {
+        ( void ) memcpy( pBuffer,
+                         pNetworkConnection->receiveBuffer + pNetworkConnection->receiveStart,
+                         bytesCopied );
+        pNetworkConnection->receiveStart += bytesCopied;
+        pNetworkConnection->receiveStats.bufferedBytes += ( uint32_t ) bytesCopied;
+    }
+
+    return bytesCopied;
+}
+
+/*-----------------------------------------------------------*/
+
+#if IOT_NETWORK_SHARED_RECEIVE_TASK == 0
+
 /**
  * @brief Task routine that waits on incoming network data.
  *
@@ -141,8 +331,9 @@ static void _destroyConnection( _networkConnection_t * pNetworkConnection )
  */
 static void _networkReceiveTask( void * pArgument )
 {
-    bool destroyConnection = false;
+    bool destroyConnection = false, readSocket = true;
     int32_t socketStatus = 0;
+    uint32_t bufferedBytes = 0;
     EventBits_t connectionFlags = 0;
 
     /* Cast network connection to the correct type. */
@@ -150,35 +341,44 @@ static void _networkReceiveTask( void * pArgument )
 
     while( true )
     {
-        /* No buffered byte should be in the connection. */
-        configASSERT( pNetworkConnection->bufferedByteValid == false );
-
-        /* Block and wait for 1 byte of data. This simulates the behavior of poll().
-         * THIS IS A TEMPORARY WORKAROUND AND DOES NOT PROVIDE THREAD-SAFETY AGAINST
-         * MULTIPLE CALLS OF RECEIVE. */
-        do
+        /* Block and wait for data. This simulates the behavior of poll(), but
+         * reads as much as fits in the receive buffer so that the receive
+         * callback is served from memory. THIS DOES NOT PROVIDE THREAD-SAFETY
+         * AGAINST MULTIPLE CALLS OF RECEIVE. */
+        if( readSocket == true )
         {
-            socketStatus = SOCKETS_Recv( pNetworkConnection->socket,
-                                         &( pNetworkConnection->bufferedByte ),
-                                         1,
-                                         0 );
+            do
+            {
+                socketStatus = _fillReceiveBuffer( pNetworkConnection );
 
-            connectionFlags = xEventGroupGetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ) );
+                connectionFlags = xEventGroupGetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ) );
 
-            if( ( connectionFlags & _FLAG_SHUTDOWN ) == _FLAG_SHUTDOWN )
-            {
-                socketStatus = SOCKETS_ECLOSED;
-            }
+                if( ( connectionFlags & _FLAG_SHUTDOWN ) == _FLAG_SHUTDOWN )
+                {
+                    socketStatus = SOCKETS_ECLOSED;
+                }
 
-            /* Check for timeout. Some ports return 0, some return EWOULDBLOCK. */
-        } while( ( socketStatus == 0 ) || ( socketStatus == SOCKETS_EWOULDBLOCK ) );
+                /* Check for timeout. Some ports return 0, some return EWOULDBLOCK. */
+            } while( ( socketStatus == 0 ) || ( socketStatus == SOCKETS_EWOULDBLOCK ) );
 
-        if( socketStatus <= 0 )
-        {
-            break;
+            if( socketStatus == SOCKETS_ENOMEM )
+            {
+                /* The receive buffer is full and the callback has not consumed
+                 * any of it. This is backpressure, not a socket error: give the
+                 * application time to catch up, then invoke the callback again. */
+                vTaskDelay( 1 );
+            }
+            else if( socketStatus <= 0 )
+            {
+                break;
+            }
+            else
+            {
+                /* New data was read into the receive buffer. */
+            }
         }
 
-        pNetworkConnection->bufferedByteValid = true;
+        bufferedBytes = pNetworkConnection->receiveStats.bufferedBytes;
 
         /* Invoke the network callback. */
         pNetworkConnection->receiveCallback( pNetworkConnection,
@@ -194,10 +394,19 @@ static void _networkReceiveTask( void * pArgument )
             destroyConnection = true;
             break;
         }
+
+        /* A single read may contain several messages. Invoke the callback again
+         * without reading the socket as long as it keeps consuming buffered data. */
+        readSocket = ( pNetworkConnection->receiveStart == pNetworkConnection->receiveEnd ) ||
+                     ( pNetworkConnection->receiveStats.bufferedBytes == bufferedBytes );
     }
 
     IotLogDebug( "Network receive task terminating." );
 
+    taskENTER_CRITICAL();
+    _receiveTaskCount--;
+    taskEXIT_CRITICAL();
+
     /* If necessary, destroy the network connection before exiting. */
     if( destroyConnection == true )
     {
@@ -213,6 +422,438 @@ static void _networkReceiveTask( void * pArgument )
     vTaskDelete( NULL );
 }
 
+#else /* if IOT_NETWORK_SHARED_RECEIVE_TASK == 0 */
+
+/**
+ * @brief Set the receive timeout of a socket.
+ *
+ * @param[in] socket The socket to configure.
+ * @param[in] timeout The receive timeout, in ticks.
+ */
+static void _setReceiveTimeout( Socket_t socket,
+                                TickType_t timeout )
+{
+    int32_t socketStatus = SOCKETS_SetSockOpt( socket,
+                                               0,
+                                               SOCKETS_SO_RCVTIMEO,
+                                               &timeout,
+                                               sizeof( TickType_t ) );
+
+    if( socketStatus != SOCKETS_ERROR_NONE )
+    {
+        IotLogWarn( "Failed to set socket receive timeout. Socket status %ld.",
+                    ( long int ) socketStatus );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Socket wakeup callback that notifies the shared receive task.
+ *
+ * The socket handle passed here depends on the Secure Sockets port, so it is
+ * not matched to a connection; the shared receive task checks all of them.
+ *
+ * @param[in] socket Ignored.
+ */
+static void _socketWakeupCallback( Socket_t socket )
+{
+    ( void ) socket;
+
+    ( void ) xTaskNotifyGive( _sharedReceiveTaskHandle );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Remove a connection from the shared receive task.
+ *
+ * Must be called with #_sharedReceiveMutex held.
+ *
+ * @param[in] pNetworkConnection The connection to remove.
+ */
+static void _unlinkConnection( _networkConnection_t * pNetworkConnection )
+{
+    if( IotLink_IsLinked( &( pNetworkConnection->link ) ) == true )
+    {
+        IotListDouble_Remove( &( pNetworkConnection->link ) );
+
+        if( pNetworkConnection->wakeupEnabled == false )
+        {
+            _sharedReceivePollCount--;
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Remove a connection from the shared receive task and destroy it.
+ *
+ * @param[in] pNetworkConnection The connection to destroy.
+ */
+static void _removeAndDestroyConnection( _networkConnection_t * pNetworkConnection )
+{
+    ( void ) xSemaphoreTake( ( QueueHandle_t ) &_sharedReceiveMutex, portMAX_DELAY );
+    _unlinkConnection( pNetworkConnection );
+    ( void ) xSemaphoreGive( ( QueueHandle_t ) &_sharedReceiveMutex );
+
+    _destroyConnection( pNetworkConnection );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Task pool job that runs the receive callback of a connection with
+ * buffered data.
+ *
+ * @param[in] pTaskPool Ignored.
+ * @param[in] pJob Ignored.
+ * @param[in] pContext The network connection.
+ */
+static void _sharedReceiveJob( IotTaskPool_t pTaskPool,
+                               IotTaskPoolJob_t pJob,
+                               void * pContext )
+{
+    bool destroyConnection = false, callbackProgress = true;
+    uint32_t bufferedBytes = 0;
+    EventBits_t connectionFlags = 0;
+
+    /* Cast network connection to the correct type. */
+    _networkConnection_t * pNetworkConnection = pContext;
+
+    /* Silence warnings about unused parameters. */
+    ( void ) pTaskPool;
+    ( void ) pJob;
+
+    pNetworkConnection->callbackTask = xTaskGetCurrentTaskHandle();
+
+    /* Invoke the callback as long as it keeps consuming buffered data. Reading
+     * more data from the socket is left to the shared receive task. */
+    while( ( callbackProgress == true ) && ( destroyConnection == false ) )
+    {
+        bufferedBytes = pNetworkConnection->receiveStats.bufferedBytes;
+
+        pNetworkConnection->receiveCallback( pNetworkConnection,
+                                             pNetworkConnection->pReceiveContext );
+
+        connectionFlags = xEventGroupGetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ) );
+        destroyConnection = ( ( connectionFlags & _FLAG_CONNECTION_DESTROYED ) == _FLAG_CONNECTION_DESTROYED );
+
+        callbackProgress = ( pNetworkConnection->receiveStart != pNetworkConnection->receiveEnd ) &&
+                           ( pNetworkConnection->receiveStats.bufferedBytes != bufferedBytes );
+    }
+
+    pNetworkConnection->callbackTask = NULL;
+
+    /* Destroy the connection if the callback requested it. Otherwise, allow the
+     * shared receive task to read this connection again. */
+    if( destroyConnection == true )
+    {
+        _removeAndDestroyConnection( pNetworkConnection );
+    }
+    else
+    {
+        ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
+                                     _FLAG_CALLBACK_IDLE );
+    }
+
+    ( void ) xTaskNotifyGive( _sharedReceiveTaskHandle );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Schedule a job that runs a connection's receive callback.
+ *
+ * @param[in] pNetworkConnection The connection with buffered data. It must
+ * have been claimed with #_claimConnection.
+ * @param[in] delayMs How long to wait before running the callback.
+ */
+static void _dispatchReceiveCallback( _networkConnection_t * pNetworkConnection,
+                                      uint32_t delayMs )
+{
+    IotTaskPoolError_t taskPoolStatus = IOT_TASKPOOL_SUCCESS;
+
+    /* Creating a job with valid parameters should never fail. */
+    taskPoolStatus = IotTaskPool_CreateJob( _sharedReceiveJob,
+                                            pNetworkConnection,
+                                            &( pNetworkConnection->jobStorage ),
+                                            &( pNetworkConnection->job ) );
+    configASSERT( taskPoolStatus == IOT_TASKPOOL_SUCCESS );
+
+    if( delayMs == 0 )
+    {
+        taskPoolStatus = IotTaskPool_Schedule( _networkTaskPool,
+                                               pNetworkConnection->job,
+                                               0 );
+    }
+    else
+    {
+        taskPoolStatus = IotTaskPool_ScheduleDeferred( _networkTaskPool,
+                                                       pNetworkConnection->job,
+                                                       delayMs );
+    }
+
+    if( taskPoolStatus != IOT_TASKPOOL_SUCCESS )
+    {
+        IotLogError( "Failed to schedule network receive callback, error %s.",
+                     IotTaskPool_strerror( taskPoolStatus ) );
+
+        /* The data is already buffered, so the connection is closed for
+         * receiving rather than dropping it. */
+        pNetworkConnection->receiveClosed = true;
+        ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
+                                     _FLAG_CALLBACK_IDLE );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Claim a connection for a socket read by the shared receive task.
+ *
+ * Must be called with #_sharedReceiveMutex held. A claimed connection is not
+ * destroyed until #_FLAG_CALLBACK_IDLE is set again, so it may be read after
+ * the mutex is released.
+ *
+ * @param[in] pNetworkConnection The connection to claim.
+ *
+ * @return `true` if the connection was claimed; `false` if it is closed or its
+ * callback is still running.
+ */
+static bool _claimConnection( _networkConnection_t * pNetworkConnection )
+{
+    bool claimed = false;
+    EventBits_t connectionFlags = xEventGroupGetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ) );
+
+    if( ( pNetworkConnection->receiveClosed == false ) &&
+        ( ( connectionFlags & _FLAG_SHUTDOWN ) == 0 ) &&
+        ( ( connectionFlags & _FLAG_CALLBACK_IDLE ) == _FLAG_CALLBACK_IDLE ) )
+    {
+        ( void ) xEventGroupClearBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
+                                       _FLAG_CALLBACK_IDLE );
+        claimed = true;
+    }
+
+    return claimed;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Read a claimed connection's socket and dispatch its receive callback
+ * if data arrived.
+ *
+ * Called without #_sharedReceiveMutex held.
+ *
+ * @param[in] pNetworkConnection The connection to read.
+ */
+static void _readConnection( _networkConnection_t * pNetworkConnection )
+{
+    int32_t socketStatus = 0;
+
+    /* Secure Sockets cannot tell whether a socket has data without reading it,
+     * and a receive timeout of 0 means "wait forever". Read with the shortest
+     * timeout possible, then restore the timeout used by blocking receives
+     * from the callback, which may also run outside this task. */
+    _setReceiveTimeout( pNetworkConnection->socket, 1 );
+    socketStatus = _fillReceiveBuffer( pNetworkConnection );
+    _setReceiveTimeout( pNetworkConnection->socket, pdMS_TO_TICKS( IOT_NETWORK_SOCKET_POLL_MS ) );
+
+    if( socketStatus > 0 )
+    {
+        _dispatchReceiveCallback( pNetworkConnection, 0 );
+    }
+    else if( socketStatus == SOCKETS_ENOMEM )
+    {
+        /* The receive buffer is full and the last callback consumed none of
+         * it. Keep the connection open and run the callback again after
+         * IOT_NETWORK_SHARED_RECEIVE_POLL_MS so that the application can catch
+         * up. */
+        _dispatchReceiveCallback( pNetworkConnection, IOT_NETWORK_SHARED_RECEIVE_POLL_MS );
+    }
+    else if( ( socketStatus != 0 ) && ( socketStatus != SOCKETS_EWOULDBLOCK ) )
+    {
+        IotLogDebug( "Socket read error %ld; no longer reading connection.",
+                     ( long int ) socketStatus );
+
+        pNetworkConnection->receiveClosed = true;
+        ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
+                                     _FLAG_CALLBACK_IDLE );
+    }
+    else
+    {
+        /* No data within the socket receive timeout. */
+        ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
+                                     _FLAG_CALLBACK_IDLE );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Task routine that reads connections with incoming data.
+ *
+ * The task sleeps until a socket wakeup callback reports new data, a
+ * connection is added, or a receive callback finishes. Each wakeup then reads
+ * every connection once, in round-robin order, since the wakeup does not say
+ * which socket has data. The list mutex is only held to pick the next
+ * connection, so adding and destroying connections does not wait for socket
+ * reads. Connections whose sockets cannot notify the task are also read every
+ * IOT_NETWORK_SHARED_RECEIVE_POLL_MS.
+ *
+ * @param[in] pArgument Ignored.
+ */
+static void _sharedReceiveTask( void * pArgument )
+{
+    size_t i = 0, connectionCount = 0, pollCount = 0;
+    IotLink_t * pLink = NULL;
+    _networkConnection_t * pNetworkConnection = NULL;
+
+    /* Silence warnings about unused parameters. */
+    ( void ) pArgument;
+
+    while( true )
+    {
+        ( void ) xSemaphoreTake( ( QueueHandle_t ) &_sharedReceiveMutex, portMAX_DELAY );
+        connectionCount = IotListDouble_Count( &_sharedReceiveList );
+        pollCount = _sharedReceivePollCount;
+        ( void ) xSemaphoreGive( ( QueueHandle_t ) &_sharedReceiveMutex );
+
+        for( i = 0; i < connectionCount; i++ )
+        {
+            pNetworkConnection = NULL;
+
+            /* Move the next connection to the back of the list and claim it. */
+            ( void ) xSemaphoreTake( ( QueueHandle_t ) &_sharedReceiveMutex, portMAX_DELAY );
+
+            pLink = IotListDouble_RemoveHead( &_sharedReceiveList );
+
+            if( pLink != NULL )
+            {
+                IotListDouble_InsertTail( &_sharedReceiveList, pLink );
+
+                if( _claimConnection( IotLink_Container( _networkConnection_t, pLink, link ) ) == true )
+                {
+                    pNetworkConnection = IotLink_Container( _networkConnection_t, pLink, link );
+                }
+            }
+
+            ( void ) xSemaphoreGive( ( QueueHandle_t ) &_sharedReceiveMutex );
+
+            if( pNetworkConnection != NULL )
+            {
+                _readConnection( pNetworkConnection );
+            }
+        }
+
+        /* Notifications that arrived during the pass are kept, so data that
+         * arrived after its connection was read is not missed. */
+        ( void ) ulTaskNotifyTake( pdTRUE,
+                                   ( pollCount > 0 ) ? pdMS_TO_TICKS( IOT_NETWORK_SHARED_RECEIVE_POLL_MS ) : portMAX_DELAY );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Create the shared receive task and its callback task pool if they do
+ * not exist.
+ *
+ * @return `true` if the shared receive task exists; `false` otherwise.
+ */
+static bool _startSharedReceiveTask( void )
+{
+    bool createTask = false, waitForTask = true;
+    SemaphoreHandle_t pMutex = NULL;
+    TaskHandle_t newTask = NULL;
+    IotTaskPoolError_t taskPoolStatus = IOT_TASKPOOL_SUCCESS;
+    const IotTaskPoolInfo_t taskPoolInfo =
+    {
+        .minThreads = IOT_NETWORK_CALLBACK_THREADS,
+        .maxThreads = IOT_NETWORK_CALLBACK_THREADS,
+        .stackSize  = IOT_NETWORK_RECEIVE_TASK_STACK_SIZE,
+        .priority   = IOT_NETWORK_RECEIVE_TASK_PRIORITY
+    };
+
+    /* Only one caller creates the task; any others wait for it to finish. */
+    while( waitForTask == true )
+    {
+        taskENTER_CRITICAL();
+
+        if( _sharedReceiveTaskState == _SHARED_RECEIVE_TASK_STOPPED )
+        {
+            _sharedReceiveTaskState = _SHARED_RECEIVE_TASK_STARTING;
+            createTask = true;
+        }
+
+        waitForTask = ( _sharedReceiveTaskState == _SHARED_RECEIVE_TASK_STARTING ) && ( createTask == false );
+
+        taskEXIT_CRITICAL();
+
+        if( waitForTask == true )
+        {
+            vTaskDelay( 1 );
+        }
+    }
+
+    if( createTask == true )
+    {
+        pMutex = xSemaphoreCreateMutexStatic( &_sharedReceiveMutex );
+        configASSERT( pMutex == ( SemaphoreHandle_t ) &_sharedReceiveMutex );
+        ( void ) pMutex;
+
+        IotListDouble_Create( &_sharedReceiveList );
+
+        /* Receive callbacks run in their own task pool rather than the system
+         * task pool, so that a system task pool job may block on a network
+         * response without starving the callback that delivers it. */
+        taskPoolStatus = IotTaskPool_Create( &taskPoolInfo, &_networkTaskPool );
+
+        if( taskPoolStatus != IOT_TASKPOOL_SUCCESS )
+        {
+            IotLogError( "Failed to create network callback task pool, error %s.",
+                         IotTaskPool_strerror( taskPoolStatus ) );
+        }
+        else if( xTaskCreate( _sharedReceiveTask,
+                              "NetRecv",
+                              IOT_NETWORK_RECEIVE_TASK_STACK_SIZE,
+                              NULL,
+                              IOT_NETWORK_RECEIVE_TASK_PRIORITY,
+                              &newTask ) != pdPASS )
+        {
+            IotLogError( "Failed to create shared network receive task." );
+
+            ( void ) IotTaskPool_Destroy( _networkTaskPool );
+            _networkTaskPool = NULL;
+            taskPoolStatus = IOT_TASKPOOL_NO_MEMORY;
+        }
+        else
+        {
+            taskENTER_CRITICAL();
+            _sharedReceiveTaskHandle = newTask;
+            _sharedReceiveTaskState = _SHARED_RECEIVE_TASK_RUNNING;
+            _receiveTaskCount += 1 + IOT_NETWORK_CALLBACK_THREADS;
+            taskEXIT_CRITICAL();
+        }
+
+        if( taskPoolStatus != IOT_TASKPOOL_SUCCESS )
+        {
+            /* Allow a later call to try again. */
+            vSemaphoreDelete( pMutex );
+
+            taskENTER_CRITICAL();
+            _sharedReceiveTaskState = _SHARED_RECEIVE_TASK_STOPPED;
+            taskEXIT_CRITICAL();
+        }
+    }
+
+    return( _sharedReceiveTaskState == _SHARED_RECEIVE_TASK_RUNNING );
+}
+
+#endif /* if IOT_NETWORK_SHARED_RECEIVE_TASK == 0 */
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -444,6 +1085,10 @@ IotNetworkError_t IotNetworkAfr_SetReceiveCallback( void * pConnection,
 {
     IotNetworkError_t status = IOT_NETWORK_SUCCESS;
 
+    #if IOT_NETWORK_SHARED_RECEIVE_TASK == 1
+        int32_t socketStatus = SOCKETS_ERROR_NONE;
+    #endif
+
     /* Cast network connection to the correct type. */
     _networkConnection_t * pNetworkConnection = ( _networkConnection_t * ) pConnection;
 
@@ -454,18 +1099,65 @@ IotNetworkError_t IotNetworkAfr_SetReceiveCallback( void * pConnection,
     /* No flags should be set. */
     configASSERT( xEventGroupGetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ) ) == 0 );
 
-    /* Create task that waits for incoming data. */
-    if( xTaskCreate( _networkReceiveTask,
-                     "NetRecv",
-                     IOT_NETWORK_RECEIVE_TASK_STACK_SIZE,
-                     pNetworkConnection,
-                     IOT_NETWORK_RECEIVE_TASK_PRIORITY,
-                     &( pNetworkConnection->receiveTask ) ) != pdPASS )
-    {
-        IotLogError( "Failed to create network receive task." );
+    #if IOT_NETWORK_SHARED_RECEIVE_TASK == 1
+        /* Add this connection to the connections read by the shared receive
+         * task, creating the task if needed. */
+        if( _startSharedReceiveTask() == true )
+        {
+            /* Have the socket wake the shared receive task when data arrives.
+             * Sockets that do not support this are polled instead. */
+            socketStatus = SOCKETS_SetSockOpt( pNetworkConnection->socket,
+                                               0,
+                                               SOCKETS_SO_WAKEUP_CALLBACK,
+                                               ( void * ) _socketWakeupCallback,
+                                               sizeof( void * ) );
+            pNetworkConnection->wakeupEnabled = ( socketStatus == SOCKETS_ERROR_NONE );
+
+            if( pNetworkConnection->wakeupEnabled == false )
+            {
+                IotLogDebug( "Socket wakeup callback not supported, error %ld; polling connection.",
+                             ( long int ) socketStatus );
+            }
 
-        status = IOT_NETWORK_SYSTEM_ERROR;
-    }
+            ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
+                                         _FLAG_CALLBACK_IDLE );
+
+            ( void ) xSemaphoreTake( ( QueueHandle_t ) &_sharedReceiveMutex, portMAX_DELAY );
+            IotListDouble_InsertTail( &_sharedReceiveList, &( pNetworkConnection->link ) );
+
+            if( pNetworkConnection->wakeupEnabled == false )
+            {
+                _sharedReceivePollCount++;
+            }
+
+            ( void ) xSemaphoreGive( ( QueueHandle_t ) &_sharedReceiveMutex );
+
+            ( void ) xTaskNotifyGive( _sharedReceiveTaskHandle );
+        }
+        else
+        {
+            status = IOT_NETWORK_SYSTEM_ERROR;
+        }
+    #else /* if IOT_NETWORK_SHARED_RECEIVE_TASK == 1 */
+        /* Create task that waits for incoming data. */
+        if( xTaskCreate( _networkReceiveTask,
+                         "NetRecv",
+                         IOT_NETWORK_RECEIVE_TASK_STACK_SIZE,
+                         pNetworkConnection,
+                         IOT_NETWORK_RECEIVE_TASK_PRIORITY,
+                         &( pNetworkConnection->receiveTask ) ) != pdPASS )
+        {
+            IotLogError( "Failed to create network receive task." );
+
+            status = IOT_NETWORK_SYSTEM_ERROR;
+        }
+        else
+        {
+            taskENTER_CRITICAL();
+            _receiveTaskCount++;
+            taskEXIT_CRITICAL();
+        }
+    #endif /* if IOT_NETWORK_SHARED_RECEIVE_TASK == 1 */
 
     return status;
 }
@@ -509,6 +1201,103 @@ size_t IotNetworkAfr_Send( void * pConnection,
 
 /*-----------------------------------------------------------*/
 
+size_t IotNetworkAfr_Sendv( void * pConnection,
+                            const IotNetworkIoVector_t * pVectors,
+                            size_t vectorCount )
+{
+    size_t bytesSent = 0, i = 0, offset = 0;
+    size_t bytesRemaining = 0, bytesCoalesced = 0, copyLength = 0;
+    const uint8_t * pSendBuffer = NULL;
+    size_t sendLength = 0;
+    int32_t socketStatus = SOCKETS_ERROR_NONE;
+    bool sendComplete = true;
+    uint8_t pCoalesceBuffer[ IOT_NETWORK_SENDV_COALESCE_SIZE ];
+
+    /* Cast network connection to the correct type. */
+    _networkConnection_t * pNetworkConnection = ( _networkConnection_t * ) pConnection;
+
+    /* Hold the socket mutex across all buffers so that no other thread's data
+     * is interleaved with this message. */
+    if( xSemaphoreTake( ( QueueHandle_t ) &( pNetworkConnection->socketMutex ),
+                        portMAX_DELAY ) == pdTRUE )
+    {
+        /* Every SOCKETS_Send on a TLS connection is its own record, so small
+         * buffers are copied together into pCoalesceBuffer and sent at once. A
+         * large buffer tops up the coalesced data and its remainder is sent in
+         * place. Stop at the first send that is not complete, since the data
+         * after it would no longer be contiguous with it. */
+        while( ( i < vectorCount ) && ( sendComplete == true ) )
+        {
+            bytesRemaining = pVectors[ i ].length - offset;
+            sendLength = 0;
+
+            if( ( bytesCoalesced == 0 ) && ( bytesRemaining >= sizeof( pCoalesceBuffer ) ) )
+            {
+                pSendBuffer = pVectors[ i ].pBuffer + offset;
+                sendLength = bytesRemaining;
+                offset += bytesRemaining;
+            }
+            else
+            {
+                copyLength = sizeof( pCoalesceBuffer ) - bytesCoalesced;
+
+                if( copyLength > bytesRemaining )
+                {
+                    copyLength = bytesRemaining;
+                }
+
+                ( void ) memcpy( pCoalesceBuffer + bytesCoalesced,
+                                 pVectors[ i ].pBuffer + offset,
+                                 copyLength );
+                bytesCoalesced += copyLength;
+                offset += copyLength;
+            }
+
+            if( offset == pVectors[ i ].length )
+            {
+                i++;
+                offset = 0;
+            }
+
+            /* Send the coalesced data once the buffer is full or no buffers
+             * are left. Secure Sockets treats a zero-length send as an error,
+             * so nothing is sent for empty buffers. */
+            if( ( bytesCoalesced == sizeof( pCoalesceBuffer ) ) ||
+                ( ( bytesCoalesced > 0 ) && ( i == vectorCount ) ) )
+            {
+                pSendBuffer = pCoalesceBuffer;
+                sendLength = bytesCoalesced;
+                bytesCoalesced = 0;
+            }
+
+            if( sendLength > 0 )
+            {
+                socketStatus = SOCKETS_Send( pNetworkConnection->socket,
+                                             pSendBuffer,
+                                             sendLength,
+                                             0 );
+
+                if( socketStatus > 0 )
+                {
+                    bytesSent += ( size_t ) socketStatus;
+                    sendComplete = ( ( size_t ) socketStatus == sendLength );
+                }
+                else
+                {
+                    IotLogError( "Error %ld while sending data.", ( long int ) socketStatus );
+                    sendComplete = false;
+                }
+            }
+        }
+
+        xSemaphoreGive( ( QueueHandle_t ) &( pNetworkConnection->socketMutex ) );
+    }
+
+    return bytesSent;
+}
+
+/*-----------------------------------------------------------*/
+
 size_t IotNetworkAfr_Receive( void * pConnection,
                               uint8_t * pBuffer,
                               size_t bytesRequested )
@@ -522,23 +1311,28 @@ size_t IotNetworkAfr_Receive( void * pConnection,
     /* Caller should never request zero bytes. */
     configASSERT( bytesRequested > 0 );
 
-    /* Write the buffered byte. THIS IS A TEMPORARY WORKAROUND AND ASSUMES THIS
-     * FUNCTION IS ALWAYS CALLED FROM THE RECEIVE CALLBACK. */
-    if( pNetworkConnection->bufferedByteValid == true )
-    {
-        *pBuffer = pNetworkConnection->bufferedByte;
-        bytesReceived = 1;
-        bytesRemaining--;
-        pNetworkConnection->bufferedByteValid = false;
-    }
+    /* Copy any buffered data first. THIS ASSUMES THIS FUNCTION IS ALWAYS
+     * CALLED FROM THE RECEIVE CALLBACK. */
+    bytesReceived = _readReceiveBuffer( pNetworkConnection, pBuffer, bytesRequested );
+    bytesRemaining -= bytesReceived;
 
     /* Block and wait for incoming data. */
     while( bytesRemaining > 0 )
     {
-        socketStatus = SOCKETS_Recv( pNetworkConnection->socket,
-                                     pBuffer + bytesReceived,
-                                     bytesRemaining,
-                                     0 );
+        /* Small requests are served through the receive buffer so that the
+         * following requests do not need another socket read. Requests at
+         * least as large as the buffer are read directly. */
+        if( bytesRemaining < IOT_NETWORK_RECEIVE_BUFFER_SIZE )
+        {
+            socketStatus = _fillReceiveBuffer( pNetworkConnection );
+        }
+        else
+        {
+            socketStatus = SOCKETS_Recv( pNetworkConnection->socket,
+                                         pBuffer + bytesReceived,
+                                         bytesRemaining,
+                                         0 );
+        }
 
         if( socketStatus == SOCKETS_EWOULDBLOCK )
         {
@@ -551,13 +1345,22 @@ size_t IotNetworkAfr_Receive( void * pConnection,
             IotLogError( "Error %ld while receiving data.", ( long int ) socketStatus );
             break;
         }
+        else if( bytesRemaining < IOT_NETWORK_RECEIVE_BUFFER_SIZE )
+        {
+            socketStatus = ( int32_t ) _readReceiveBuffer( pNetworkConnection,
+                                                           pBuffer + bytesReceived,
+                                                           bytesRemaining );
+        }
         else
         {
-            bytesReceived += ( size_t ) socketStatus;
-            bytesRemaining -= ( size_t ) socketStatus;
-
-            configASSERT( bytesReceived + bytesRemaining == bytesRequested );
+            pNetworkConnection->receiveStats.socketReads++;
+            pNetworkConnection->receiveStats.socketBytes += ( uint32_t ) socketStatus;
         }
+
+        bytesReceived += ( size_t ) socketStatus;
+        bytesRemaining -= ( size_t ) socketStatus;
+
+        configASSERT( bytesReceived + bytesRemaining == bytesRequested );
     }
 
     if( bytesReceived < bytesRequested )
@@ -590,21 +1393,17 @@ size_t IotNetworkAfr_ReceiveUpto( void * pConnection,
     /* Caller should never pass a zero-length buffer. */
     configASSERT( bufferSize > 0 );
 
-    /* Write the buffered byte. THIS IS A TEMPORARY WORKAROUND AND ASSUMES THIS
-     * FUNCTION IS ALWAYS CALLED FROM THE RECEIVE CALLBACK. */
-    if( pNetworkConnection->bufferedByteValid == true )
-    {
-        *pBuffer = pNetworkConnection->bufferedByte;
-        bytesReceived = 1;
-        pNetworkConnection->bufferedByteValid = false;
-    }
+    /* Copy any buffered data. THIS ASSUMES THIS FUNCTION IS ALWAYS CALLED FROM
+     * THE RECEIVE CALLBACK. */
+    bytesReceived = _readReceiveBuffer( pNetworkConnection, pBuffer, bufferSize );
 
-    if( bufferSize - bytesReceived > 0 )
+    /* Only read the socket if nothing was buffered. */
+    if( bytesReceived == 0 )
     {
         /* Block and wait for incoming data. */
         socketStatus = SOCKETS_Recv( pNetworkConnection->socket,
-                                     pBuffer + bytesReceived,
-                                     bufferSize - bytesReceived,
+                                     pBuffer,
+                                     bufferSize,
                                      0 );
 
         if( socketStatus <= 0 )
@@ -613,7 +1412,9 @@ size_t IotNetworkAfr_ReceiveUpto( void * pConnection,
         }
         else
         {
-            bytesReceived += ( size_t ) socketStatus;
+            bytesReceived = ( size_t ) socketStatus;
+            pNetworkConnection->receiveStats.socketReads++;
+            pNetworkConnection->receiveStats.socketBytes += ( uint32_t ) socketStatus;
         }
     }
 
@@ -655,29 +1456,79 @@ IotNetworkError_t IotNetworkAfr_Destroy( void * pConnection )
     /* Cast network connection to the correct type. */
     _networkConnection_t * pNetworkConnection = ( _networkConnection_t * ) pConnection;
 
-    /* Check if this function is being called from the receive task. */
-    if( xTaskGetCurrentTaskHandle() == pNetworkConnection->receiveTask )
-    {
-        /* Set the flag specifying that the connection is destroyed. */
-        ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
-                                     _FLAG_CONNECTION_DESTROYED );
-    }
-    else
-    {
-        /* If a receive task was created, wait for it to exit. */
-        if( pNetworkConnection->receiveTask != NULL )
+    #if IOT_NETWORK_SHARED_RECEIVE_TASK == 1
+        /* Check if this function is being called from the receive callback. */
+        if( xTaskGetCurrentTaskHandle() == pNetworkConnection->callbackTask )
         {
-            ( void ) xEventGroupWaitBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
-                                          _FLAG_RECEIVE_TASK_EXITED,
-                                          pdTRUE,
-                                          pdTRUE,
-                                          portMAX_DELAY );
+            /* Set the flag specifying that the connection is destroyed. The
+             * receive callback job destroys the connection when it returns. */
+            ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
+                                         _FLAG_CONNECTION_DESTROYED );
         }
+        else
+        {
+            /* Stop reading this connection, then wait for any running receive
+             * callback to finish. */
+            if( pNetworkConnection->receiveCallback != NULL )
+            {
+                ( void ) xSemaphoreTake( ( QueueHandle_t ) &_sharedReceiveMutex, portMAX_DELAY );
+                _unlinkConnection( pNetworkConnection );
+                ( void ) xSemaphoreGive( ( QueueHandle_t ) &_sharedReceiveMutex );
+
+                ( void ) xEventGroupWaitBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
+                                              _FLAG_CALLBACK_IDLE,
+                                              pdFALSE,
+                                              pdTRUE,
+                                              portMAX_DELAY );
+            }
 
-        _destroyConnection( pNetworkConnection );
-    }
+            _destroyConnection( pNetworkConnection );
+        }
+    #else /* if IOT_NETWORK_SHARED_RECEIVE_TASK == 1 */
+        /* Check if this function is being called from the receive task. */
+        if( xTaskGetCurrentTaskHandle() == pNetworkConnection->receiveTask )
+        {
+            /* Set the flag specifying that the connection is destroyed. */
+            ( void ) xEventGroupSetBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
+                                         _FLAG_CONNECTION_DESTROYED );
+        }
+        else
+        {
+            /* If a receive task was created, wait for it to exit. */
+            if( pNetworkConnection->receiveTask != NULL )
+            {
+                ( void ) xEventGroupWaitBits( ( EventGroupHandle_t ) &( pNetworkConnection->connectionFlags ),
+                                              _FLAG_RECEIVE_TASK_EXITED,
+                                              pdTRUE,
+                                              pdTRUE,
+                                              portMAX_DELAY );
+            }
+
+            _destroyConnection( pNetworkConnection );
+        }
+    #endif /* if IOT_NETWORK_SHARED_RECEIVE_TASK == 1 */
 
     return IOT_NETWORK_SUCCESS;
 }
 
 /*-----------------------------------------------------------*/
+
+void IotNetworkAfr_GetReceiveStats( void * pConnection,
+                                    IotNetworkAfrReceiveStats_t * pStats )
+{
+    /* Cast network connection to the correct type. */
+    _networkConnection_t * pNetworkConnection = ( _networkConnection_t * ) pConnection;
+
+    *pStats = pNetworkConnection->receiveStats;
+}
+
+/*-----------------------------------------------------------*/
+
+size_t IotNetworkAfr_GetReceiveTaskStackBytes( void )
+{
+    return ( size_t ) _receiveTaskCount *
+           ( size_t ) IOT_NETWORK_RECEIVE_TASK_STACK_SIZE *
+           sizeof( StackType_t );
+}
+
+/*-----------------------------------------------------------*/
@@ -67,6 +67,8 @@ typedef enum IotNetworkError
  * @function_brief{platform_network_function_setreceivecallback}
  * - @function_name{platform_network_function_send}
  * @function_brief{platform_network_function_send}
+ * - @function_name{platform_network_function_sendv}
+ * @function_brief{platform_network_function_sendv}
  * - @function_name{platform_network_function_receive}
  * @function_brief{platform_network_function_receive}
  * - @function_name{platform_network_function_receiveupto}
@@ -89,6 +91,9 @@ typedef enum IotNetworkError
  * @function_page{IotNetworkInterface_t::send,platform_network,send}
  * @function_snippet{platform_network,send,this}
  * @copydoc IotNetworkInterface_t::send
+ * @function_page{IotNetworkInterface_t::sendv,platform_network,sendv}
+ * @function_snippet{platform_network,sendv,this}
+ * @copydoc IotNetworkInterface_t::sendv
  * @function_page{IotNetworkInterface_t::receive,platform_network,receive}
  * @function_snippet{platform_network,receive,this}
  * @copydoc IotNetworkInterface_t::receive
@@ -121,6 +126,19 @@ typedef void ( * IotNetworkReceiveCallback_t )( void * pConnection,
                                                 void * pContext );
 /* @[declare_platform_network_receivecallback] */
 
+/**
+ * @ingroup platform_datatypes_paramstructs
+ * @brief A single buffer of a scatter/gather send.
+ *
+ * An array of these is passed to @ref platform_network_function_sendv. The
+ * buffers are transmitted in array order as one contiguous stream of bytes.
+ */
+typedef struct IotNetworkIoVector
+{
+    const uint8_t * pBuffer; /**< @brief Data to send. */
+    size_t length;           /**< @brief Size of `pBuffer`. */
+} IotNetworkIoVector_t;
+
 /**
  * @ingroup platform_datatypes_paramstructs
  * @brief Represents the functions of a network stack.
@@ -281,6 +299,31 @@ typedef struct IotNetworkInterface
     /* @[declare_platform_network_destroy] */
     IotNetworkError_t ( * destroy )( void * pConnection );
     /* @[declare_platform_network_destroy] */
+
+    /**
+     * @brief Send several buffers over a connection as a single message.
+     *
+     * Transmits the buffers of `pVectors` in order, as if they were one
+     * contiguous message passed to @ref platform_network_function_send. Data
+     * from other sends on the same connection must not be interleaved with
+     * the buffers of one call. Returns the total number of bytes sent across
+     * all buffers, `0` on failure.
+     *
+     * This function is optional and may be `NULL`. Libraries that use it must
+     * fall back to @ref platform_network_function_send when it is not set.
+     *
+     * @param[in] pConnection The connection used to send data, defined by the
+     * network stack.
+     * @param[in] pVectors The buffers to send.
+     * @param[in] vectorCount The number of buffers in `pVectors`.
+     *
+     * @return The number of bytes successfully sent, `0` on failure.
+     */
+    /* @[declare_platform_network_sendv] */
+    size_t ( * sendv )( void * pConnection,
+                        const IotNetworkIoVector_t * pVectors,
+                        size_t vectorCount );
+    /* @[declare_platform_network_sendv] */
 } IotNetworkInterface_t;
 
 /**
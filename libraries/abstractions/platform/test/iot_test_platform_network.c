@@ -0,0 +1,701 @@
+/*
+ * FreeRTOS Platform V1.1.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_test_platform_network.c
+ * @brief Tests for the functions in iot_network_freertos.h
+ */
+
+#include "iot_config.h"
+
+/* Test framework includes. */
+#include <string.h>
+#include "unity_fixture.h"
+
+#include "platform/iot_clock.h"
+#include "platform/iot_network_freertos.h"
+#include "platform/iot_threads.h"
+#include "iot_taskpool.h"
+#include "task.h"
+
+/* Echo server used by the TCP tests. */
+#include "aws_test_tcp.h"
+
+/**
+ * @brief The number of connections to open at once.
+ *
+ * Limited by the number of sockets Secure Sockets allows.
+ */
+#if socketsconfigDEFAULT_MAX_NUM_SECURE_SOCKETS < 32
+    #define NETWORK_TEST_CONNECTION_COUNT    socketsconfigDEFAULT_MAX_NUM_SECURE_SOCKETS
+#else
+    #define NETWORK_TEST_CONNECTION_COUNT    32
+#endif
+
+/**
+ * @brief Stack size of one network receive task, in bytes.
+ */
+#define NETWORK_TEST_TASK_STACK_BYTES \
+    ( ( size_t ) IOT_NETWORK_RECEIVE_TASK_STACK_SIZE * sizeof( StackType_t ) )
+
+/**
+ * @brief The number of receive callback threads used with a shared receive task.
+ *
+ * Must match the default in iot_network_freertos.c.
+ */
+#ifndef IOT_NETWORK_CALLBACK_THREADS
+    #define IOT_NETWORK_CALLBACK_THREADS    ( 1 )
+#endif
+
+/**
+ * @brief The size of each connection's receive buffer.
+ *
+ * Must match the default in iot_network_freertos.c.
+ */
+#ifndef IOT_NETWORK_RECEIVE_BUFFER_SIZE
+    #define IOT_NETWORK_RECEIVE_BUFFER_SIZE    ( 512 )
+#endif
+
+/**
+ * @brief How long to wait for the echo server to respond, in milliseconds.
+ */
+#define NETWORK_TEST_ECHO_TIMEOUT_MS    ( 5000 )
+
+/**
+ * @brief Size of the messages sent to the echo server by the receive buffer
+ * tests. Larger than the receive buffer, so that it fills.
+ */
+#define NETWORK_TEST_MESSAGE_SIZE       ( 2 * IOT_NETWORK_RECEIVE_BUFFER_SIZE )
+
+/**
+ * @brief How many bytes the receive callback reads at a time in
+ * IotNetworkAfr_BufferedReceive.
+ */
+#define NETWORK_TEST_CHUNK_SIZE         ( 7 )
+
+/**
+ * @brief How long to check that a full receive buffer is not read further, in
+ * milliseconds.
+ */
+#define NETWORK_TEST_BACKPRESSURE_MS    ( 200 )
+
+/*
+ * Convert the echo server address to a string in decimal dot notation.
+ */
+#define NETWORK_TEST_STRINGIFY( x )    # x
+#define NETWORK_TEST_TO_STRING( x )    NETWORK_TEST_STRINGIFY( x )
+#define NETWORK_TEST_ECHO_SERVER_ADDRESS              \
+    NETWORK_TEST_TO_STRING( tcptestECHO_SERVER_ADDR0 ) "." \
+    NETWORK_TEST_TO_STRING( tcptestECHO_SERVER_ADDR1 ) "." \
+    NETWORK_TEST_TO_STRING( tcptestECHO_SERVER_ADDR2 ) "." \
+    NETWORK_TEST_TO_STRING( tcptestECHO_SERVER_ADDR3 )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Context shared by the echo receive callback and the task pool job in
+ * IotNetworkAfr_CallbackFromTaskPoolJob.
+ */
+typedef struct _echoContext
+{
+    void * pConnection;         /**< @brief The connection to the echo server. */
+    IotSemaphore_t received;    /**< @brief Posted by the receive callback. */
+    IotSemaphore_t jobDone;     /**< @brief Posted when the task pool job finishes. */
+    bool echoReceived;          /**< @brief Whether the job saw the echo arrive. */
+} _echoContext_t;
+
+/**
+ * @brief Context of the receive callback used by the receive buffer tests.
+ */
+typedef struct _receiveContext
+{
+    IotSemaphore_t done;             /**< @brief Posted when all expected bytes are received. */
+    size_t expected;                 /**< @brief How many bytes to receive. */
+    volatile size_t received;        /**< @brief How many bytes were received. */
+    volatile size_t readSize;        /**< @brief Bytes to read per callback; 0 leaves the data buffered. */
+    volatile uint32_t callbackCount; /**< @brief Number of times the callback was invoked. */
+} _receiveContext_t;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Data sent to the echo server by the receive buffer tests.
+ */
+static uint8_t _pSentData[ NETWORK_TEST_MESSAGE_SIZE ];
+
+/**
+ * @brief Data received from the echo server by the receive buffer tests.
+ */
+static uint8_t _pReceivedData[ NETWORK_TEST_MESSAGE_SIZE ];
+
+/**
+ * @brief The least free stack seen by #_stackCallback, in words.
+ */
+static volatile UBaseType_t _callbackStackFree = 0;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for Platform Network tests.
+ */
+TEST_GROUP( UTIL_Platform_Network );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for Platform Network tests.
+ */
+TEST_SETUP( UTIL_Platform_Network )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for Platform Network tests.
+ */
+TEST_TEAR_DOWN( UTIL_Platform_Network )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for Platform Network tests.
+ */
+TEST_GROUP_RUNNER( UTIL_Platform_Network )
+{
+    RUN_TEST_CASE( UTIL_Platform_Network, IotNetworkAfr_ReceiveTaskMemory );
+    RUN_TEST_CASE( UTIL_Platform_Network, IotNetworkAfr_CallbackFromTaskPoolJob );
+    RUN_TEST_CASE( UTIL_Platform_Network, IotNetworkAfr_BufferedReceive );
+    RUN_TEST_CASE( UTIL_Platform_Network, IotNetworkAfr_LargeReceive );
+    RUN_TEST_CASE( UTIL_Platform_Network, IotNetworkAfr_ReceiveBackpressure );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Receive callback that discards incoming data and signals the test.
+ */
+static void _echoCallback( void * pConnection,
+                           void * pContext )
+{
+    uint8_t buffer[ 32 ];
+    _echoContext_t * pEchoContext = pContext;
+
+    if( IotNetworkAfr_ReceiveUpto( pConnection, buffer, sizeof( buffer ) ) > 0 )
+    {
+        IotSemaphore_Post( &( pEchoContext->received ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Receive callback that records the free stack of the task running it
+ * in #_callbackStackFree, then discards incoming data and signals the test.
+ */
+static void _stackCallback( void * pConnection,
+                            void * pContext )
+{
+    #if INCLUDE_uxTaskGetStackHighWaterMark == 1
+        UBaseType_t stackFree = uxTaskGetStackHighWaterMark( NULL );
+
+        if( ( _callbackStackFree == 0 ) || ( stackFree < _callbackStackFree ) )
+        {
+            _callbackStackFree = stackFree;
+        }
+    #endif
+
+    _echoCallback( pConnection, pContext );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Receive callback that reads up to `readSize` bytes per invocation
+ * into #_pReceivedData.
+ */
+static void _receiveCallback( void * pConnection,
+                              void * pContext )
+{
+    size_t bytesRequested = 0, bytesReceived = 0;
+    _receiveContext_t * pReceiveContext = pContext;
+
+    pReceiveContext->callbackCount++;
+
+    if( pReceiveContext->received < pReceiveContext->expected )
+    {
+        bytesRequested = pReceiveContext->expected - pReceiveContext->received;
+
+        if( bytesRequested > pReceiveContext->readSize )
+        {
+            bytesRequested = pReceiveContext->readSize;
+        }
+    }
+
+    if( bytesRequested > 0 )
+    {
+        bytesReceived = IotNetworkAfr_Receive( pConnection,
+                                               _pReceivedData + pReceiveContext->received,
+                                               bytesRequested );
+        pReceiveContext->received += bytesReceived;
+
+        if( pReceiveContext->received == pReceiveContext->expected )
+        {
+            IotSemaphore_Post( &( pReceiveContext->done ) );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Connect to the echo server, set #_receiveCallback, and send
+ * #_pSentData.
+ *
+ * @param[in] pReceiveContext Context for the receive callback. Its `done`
+ * semaphore must be created.
+ * @param[out] pConnection Set to the new connection.
+ */
+static void _sendToEchoServer( _receiveContext_t * pReceiveContext,
+                               void ** pConnection )
+{
+    size_t i = 0;
+    IotNetworkServerInfo_t serverInfo = IOT_NETWORK_SERVER_INFO_AFR_INITIALIZER;
+
+    serverInfo.pHostName = NETWORK_TEST_ECHO_SERVER_ADDRESS;
+    serverInfo.port = tcptestECHO_PORT;
+
+    for( i = 0; i < sizeof( _pSentData ); i++ )
+    {
+        _pSentData[ i ] = ( uint8_t ) i;
+    }
+
+    ( void ) memset( _pReceivedData, 0x00, sizeof( _pReceivedData ) );
+    pReceiveContext->expected = sizeof( _pSentData );
+
+    TEST_ASSERT_EQUAL( IOT_NETWORK_SUCCESS,
+                       IotNetworkAfr_Create( &serverInfo, NULL, pConnection ) );
+    TEST_ASSERT_EQUAL( IOT_NETWORK_SUCCESS,
+                       IotNetworkAfr_SetReceiveCallback( *pConnection, _receiveCallback, pReceiveContext ) );
+    TEST_ASSERT_EQUAL( sizeof( _pSentData ),
+                       IotNetworkAfr_Send( *pConnection, _pSentData, sizeof( _pSentData ) ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Close and destroy a connection created by #_sendToEchoServer.
+ *
+ * @param[in] pConnection The connection; `NULL` if it was not created.
+ */
+static void _closeEchoConnection( void * pConnection )
+{
+    if( pConnection != NULL )
+    {
+        ( void ) IotNetworkAfr_Close( pConnection );
+        ( void ) IotNetworkAfr_Destroy( pConnection );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief System task pool job that sends to the echo server and blocks until
+ * the receive callback sees the reply.
+ */
+static void _echoJob( IotTaskPool_t pTaskPool,
+                      IotTaskPoolJob_t pJob,
+                      void * pContext )
+{
+    static const uint8_t pMessage[] = "echo";
+    _echoContext_t * pEchoContext = pContext;
+
+    ( void ) pTaskPool;
+    ( void ) pJob;
+
+    if( IotNetworkAfr_Send( pEchoContext->pConnection, pMessage, sizeof( pMessage ) ) == sizeof( pMessage ) )
+    {
+        pEchoContext->echoReceived = IotSemaphore_TimedWait( &( pEchoContext->received ),
+                                                             NETWORK_TEST_ECHO_TIMEOUT_MS );
+    }
+
+    IotSemaphore_Post( &( pEchoContext->jobDone ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check the memory used by network receive tasks as connections are
+ * added.
+ *
+ * With a shared receive task, the stack reserved for receiving stays the same
+ * from 1 to #NETWORK_TEST_CONNECTION_COUNT connections, and each additional
+ * connection costs less heap than a receive task stack. Otherwise, each
+ * connection adds one receive task.
+ *
+ * Each connection receives one echo so that the stack actually used by the
+ * receive path can be measured with uxTaskGetStackHighWaterMark.
+ */
+TEST( UTIL_Platform_Network, IotNetworkAfr_ReceiveTaskMemory )
+{
+    int32_t i = 0, connectionCount = 0;
+    IotNetworkServerInfo_t serverInfo = IOT_NETWORK_SERVER_INFO_AFR_INITIALIZER;
+    void * pConnections[ NETWORK_TEST_CONNECTION_COUNT ] = { NULL };
+    size_t baseStackBytes = IotNetworkAfr_GetReceiveTaskStackBytes();
+    size_t firstStackBytes = 0, firstFreeHeap = 0, freeHeap = 0;
+    bool receivedCreated = false;
+    _echoContext_t echoContext = { 0 };
+    uint8_t message = 0;
+
+    serverInfo.pHostName = NETWORK_TEST_ECHO_SERVER_ADDRESS;
+    serverInfo.port = tcptestECHO_PORT;
+    _callbackStackFree = 0;
+
+    if( TEST_PROTECT() )
+    {
+        receivedCreated = IotSemaphore_Create( &( echoContext.received ), 0, 1 );
+        TEST_ASSERT_TRUE( receivedCreated );
+
+        for( i = 0; i < NETWORK_TEST_CONNECTION_COUNT; i++ )
+        {
+            TEST_ASSERT_EQUAL( IOT_NETWORK_SUCCESS,
+                               IotNetworkAfr_Create( &serverInfo, NULL, &( pConnections[ i ] ) ) );
+            connectionCount++;
+
+            TEST_ASSERT_EQUAL( IOT_NETWORK_SUCCESS,
+                               IotNetworkAfr_SetReceiveCallback( pConnections[ i ], _stackCallback, &echoContext ) );
+
+            TEST_ASSERT_EQUAL( 1, IotNetworkAfr_Send( pConnections[ i ], &message, 1 ) );
+            TEST_ASSERT_TRUE( IotSemaphore_TimedWait( &( echoContext.received ),
+                                                      NETWORK_TEST_ECHO_TIMEOUT_MS ) );
+
+            freeHeap = xPortGetFreeHeapSize();
+
+            if( i == 0 )
+            {
+                firstStackBytes = IotNetworkAfr_GetReceiveTaskStackBytes();
+                firstFreeHeap = freeHeap;
+            }
+
+            #if IOT_NETWORK_SHARED_RECEIVE_TASK == 1
+                /* The shared receive task and its callback threads are created
+                 * at most once. */
+                TEST_ASSERT_EQUAL( firstStackBytes, IotNetworkAfr_GetReceiveTaskStackBytes() );
+                TEST_ASSERT_TRUE( firstStackBytes <= baseStackBytes +
+                                  ( size_t ) ( 1 + IOT_NETWORK_CALLBACK_THREADS ) * NETWORK_TEST_TASK_STACK_BYTES );
+
+                /* Connections after the first do not allocate a task stack. */
+                if( i > 0 )
+                {
+                    TEST_ASSERT_TRUE( firstFreeHeap - freeHeap < ( size_t ) i * NETWORK_TEST_TASK_STACK_BYTES );
+                }
+            #else
+                ( void ) firstStackBytes;
+
+                TEST_ASSERT_EQUAL( baseStackBytes + ( size_t ) ( i + 1 ) * NETWORK_TEST_TASK_STACK_BYTES,
+                                   IotNetworkAfr_GetReceiveTaskStackBytes() );
+            #endif
+        }
+
+        UnityPrintNumber( ( UNITY_INT ) connectionCount );
+        UnityPrint( " connections: " );
+        UnityPrintNumber( ( UNITY_INT ) IotNetworkAfr_GetReceiveTaskStackBytes() );
+        UnityPrint( " bytes of receive task stack reserved, " );
+        UnityPrintNumber( ( UNITY_INT ) ( firstFreeHeap - freeHeap ) );
+        UnityPrint( " bytes of heap after the first." );
+        UNITY_PRINT_EOL();
+
+        #if INCLUDE_uxTaskGetStackHighWaterMark == 1
+            /* The callback runs with a receive task or callback thread stack of
+             * this size, so the difference is the most it used. */
+            TEST_ASSERT_TRUE( _callbackStackFree > 0 );
+            UnityPrint( "Receive callback stack: " );
+            UnityPrintNumber( ( UNITY_INT ) ( IOT_NETWORK_RECEIVE_TASK_STACK_SIZE - _callbackStackFree ) );
+            UnityPrint( " words used, " );
+            UnityPrintNumber( ( UNITY_INT ) _callbackStackFree );
+            UnityPrint( " words never used." );
+            UNITY_PRINT_EOL();
+
+            #if ( IOT_NETWORK_SHARED_RECEIVE_TASK == 1 ) && ( INCLUDE_xTaskGetHandle == 1 )
+                UnityPrint( "Shared receive task stack: " );
+                UnityPrintNumber( ( UNITY_INT ) uxTaskGetStackHighWaterMark( xTaskGetHandle( "NetRecv" ) ) );
+                UnityPrint( " words never used." );
+                UNITY_PRINT_EOL();
+            #endif
+        #endif
+    }
+
+    for( i = 0; i < connectionCount; i++ )
+    {
+        ( void ) IotNetworkAfr_Close( pConnections[ i ] );
+        ( void ) IotNetworkAfr_Destroy( pConnections[ i ] );
+    }
+
+    if( receivedCreated == true )
+    {
+        IotSemaphore_Destroy( &( echoContext.received ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check that a system task pool job may block on a network response.
+ *
+ * The job sends to the echo server and waits for the receive callback to see
+ * the reply. This deadlocks if receive callbacks need a system task pool worker
+ * while every worker is blocked in such a job.
+ */
+TEST( UTIL_Platform_Network, IotNetworkAfr_CallbackFromTaskPoolJob )
+{
+    bool receivedCreated = false, jobDoneCreated = false, connectionCreated = false;
+    bool jobScheduled = false, jobFinished = false;
+    IotNetworkServerInfo_t serverInfo = IOT_NETWORK_SERVER_INFO_AFR_INITIALIZER;
+    _echoContext_t echoContext = { 0 };
+    IotTaskPoolJobStorage_t jobStorage = IOT_TASKPOOL_JOB_STORAGE_INITIALIZER;
+    IotTaskPoolJob_t job = IOT_TASKPOOL_JOB_INITIALIZER;
+
+    serverInfo.pHostName = NETWORK_TEST_ECHO_SERVER_ADDRESS;
+    serverInfo.port = tcptestECHO_PORT;
+
+    if( TEST_PROTECT() )
+    {
+        receivedCreated = IotSemaphore_Create( &( echoContext.received ), 0, 1 );
+        TEST_ASSERT_TRUE( receivedCreated );
+
+        jobDoneCreated = IotSemaphore_Create( &( echoContext.jobDone ), 0, 1 );
+        TEST_ASSERT_TRUE( jobDoneCreated );
+
+        TEST_ASSERT_EQUAL( IOT_NETWORK_SUCCESS,
+                           IotNetworkAfr_Create( &serverInfo, NULL, &( echoContext.pConnection ) ) );
+        connectionCreated = true;
+
+        TEST_ASSERT_EQUAL( IOT_NETWORK_SUCCESS,
+                           IotNetworkAfr_SetReceiveCallback( echoContext.pConnection, _echoCallback, &echoContext ) );
+
+        TEST_ASSERT_EQUAL( IOT_TASKPOOL_SUCCESS,
+                           IotTaskPool_CreateJob( _echoJob, &echoContext, &jobStorage, &job ) );
+        TEST_ASSERT_EQUAL( IOT_TASKPOOL_SUCCESS,
+                           IotTaskPool_Schedule( IOT_SYSTEM_TASKPOOL, job, 0 ) );
+        jobScheduled = true;
+
+        /* Wait for the job to finish, then check that it saw the echo. */
+        jobFinished = IotSemaphore_TimedWait( &( echoContext.jobDone ),
+                                              2 * NETWORK_TEST_ECHO_TIMEOUT_MS );
+        TEST_ASSERT_TRUE( jobFinished );
+        TEST_ASSERT_TRUE( echoContext.echoReceived );
+    }
+
+    if( connectionCreated == true )
+    {
+        ( void ) IotNetworkAfr_Close( echoContext.pConnection );
+    }
+
+    /* The job uses the context on this stack, so it must finish first. */
+    if( ( jobScheduled == true ) && ( jobFinished == false ) )
+    {
+        IotSemaphore_Wait( &( echoContext.jobDone ) );
+    }
+
+    if( connectionCreated == true )
+    {
+        ( void ) IotNetworkAfr_Destroy( echoContext.pConnection );
+    }
+
+    if( jobDoneCreated == true )
+    {
+        IotSemaphore_Destroy( &( echoContext.jobDone ) );
+    }
+
+    if( receivedCreated == true )
+    {
+        IotSemaphore_Destroy( &( echoContext.received ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check that small reads are served from the receive buffer.
+ *
+ * The receive callback reads a few bytes per invocation, leaving the rest of
+ * the buffered data for the next invocation. All data must arrive in order
+ * with fewer socket reads than application reads.
+ */
+TEST( UTIL_Platform_Network, IotNetworkAfr_BufferedReceive )
+{
+    bool doneCreated = false;
+    void * pConnection = NULL;
+    _receiveContext_t receiveContext = { 0 };
+    IotNetworkAfrReceiveStats_t stats = { 0 };
+
+    receiveContext.readSize = NETWORK_TEST_CHUNK_SIZE;
+
+    if( TEST_PROTECT() )
+    {
+        doneCreated = IotSemaphore_Create( &( receiveContext.done ), 0, 1 );
+        TEST_ASSERT_TRUE( doneCreated );
+
+        _sendToEchoServer( &receiveContext, &pConnection );
+
+        TEST_ASSERT_TRUE( IotSemaphore_TimedWait( &( receiveContext.done ),
+                                                  NETWORK_TEST_ECHO_TIMEOUT_MS ) );
+        TEST_ASSERT_EQUAL_UINT8_ARRAY( _pSentData, _pReceivedData, sizeof( _pSentData ) );
+
+        /* Every byte was read from the socket once and passed to the callback
+         * through the receive buffer. */
+        IotNetworkAfr_GetReceiveStats( pConnection, &stats );
+        TEST_ASSERT_EQUAL_UINT32( sizeof( _pSentData ), stats.socketBytes );
+        TEST_ASSERT_EQUAL_UINT32( sizeof( _pSentData ), stats.bufferedBytes );
+        TEST_ASSERT_TRUE( stats.socketReads < receiveContext.callbackCount );
+    }
+
+    _closeEchoConnection( pConnection );
+
+    if( doneCreated == true )
+    {
+        IotSemaphore_Destroy( &( receiveContext.done ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check that a read larger than the receive buffer is read from the
+ * socket directly after the buffered data.
+ */
+TEST( UTIL_Platform_Network, IotNetworkAfr_LargeReceive )
+{
+    bool doneCreated = false;
+    void * pConnection = NULL;
+    _receiveContext_t receiveContext = { 0 };
+    IotNetworkAfrReceiveStats_t stats = { 0 };
+
+    receiveContext.readSize = NETWORK_TEST_MESSAGE_SIZE;
+
+    if( TEST_PROTECT() )
+    {
+        doneCreated = IotSemaphore_Create( &( receiveContext.done ), 0, 1 );
+        TEST_ASSERT_TRUE( doneCreated );
+
+        _sendToEchoServer( &receiveContext, &pConnection );
+
+        TEST_ASSERT_TRUE( IotSemaphore_TimedWait( &( receiveContext.done ),
+                                                  NETWORK_TEST_ECHO_TIMEOUT_MS ) );
+        TEST_ASSERT_EQUAL_UINT8_ARRAY( _pSentData, _pReceivedData, sizeof( _pSentData ) );
+
+        /* The data read before the callback was invoked passed through the
+         * receive buffer; at least some of the rest was read into the
+         * callback's buffer directly. */
+        IotNetworkAfr_GetReceiveStats( pConnection, &stats );
+        TEST_ASSERT_EQUAL_UINT32( sizeof( _pSentData ), stats.socketBytes );
+        TEST_ASSERT_TRUE( stats.bufferedBytes > 0 );
+        TEST_ASSERT_TRUE( stats.bufferedBytes < sizeof( _pSentData ) );
+    }
+
+    _closeEchoConnection( pConnection );
+
+    if( doneCreated == true )
+    {
+        IotSemaphore_Destroy( &( receiveContext.done ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check that a full receive buffer holds off socket reads without
+ * closing the connection.
+ *
+ * The receive callback consumes nothing until the buffer is full. The
+ * connection must stop reading the socket, keep invoking the callback, and
+ * deliver all data in order once the callback starts reading.
+ */
+TEST( UTIL_Platform_Network, IotNetworkAfr_ReceiveBackpressure )
+{
+    bool doneCreated = false;
+    uint32_t i = 0, callbackCount = 0;
+    void * pConnection = NULL;
+    _receiveContext_t receiveContext = { 0 };
+    IotNetworkAfrReceiveStats_t stats = { 0 };
+
+    receiveContext.readSize = 0;
+
+    if( TEST_PROTECT() )
+    {
+        doneCreated = IotSemaphore_Create( &( receiveContext.done ), 0, 1 );
+        TEST_ASSERT_TRUE( doneCreated );
+
+        _sendToEchoServer( &receiveContext, &pConnection );
+
+        /* Wait for the receive buffer to fill. */
+        for( i = 0; i < NETWORK_TEST_ECHO_TIMEOUT_MS / 10; i++ )
+        {
+            IotNetworkAfr_GetReceiveStats( pConnection, &stats );
+
+            if( stats.socketBytes == IOT_NETWORK_RECEIVE_BUFFER_SIZE )
+            {
+                break;
+            }
+
+            IotClock_SleepMs( 10 );
+        }
+
+        TEST_ASSERT_EQUAL_UINT32( IOT_NETWORK_RECEIVE_BUFFER_SIZE, stats.socketBytes );
+        callbackCount = receiveContext.callbackCount;
+
+        /* The full buffer is not read further, but the callback is invoked
+         * again so that the application can catch up. */
+        IotClock_SleepMs( NETWORK_TEST_BACKPRESSURE_MS );
+
+        IotNetworkAfr_GetReceiveStats( pConnection, &stats );
+        TEST_ASSERT_EQUAL_UINT32( IOT_NETWORK_RECEIVE_BUFFER_SIZE, stats.socketBytes );
+        TEST_ASSERT_EQUAL_UINT32( 0, stats.bufferedBytes );
+        TEST_ASSERT_TRUE( receiveContext.callbackCount > callbackCount );
+
+        /* Start consuming. All data, including the data the socket held back,
+         * must arrive in order. */
+        receiveContext.readSize = NETWORK_TEST_CHUNK_SIZE;
+
+        TEST_ASSERT_TRUE( IotSemaphore_TimedWait( &( receiveContext.done ),
+                                                  NETWORK_TEST_ECHO_TIMEOUT_MS ) );
+        TEST_ASSERT_EQUAL_UINT8_ARRAY( _pSentData, _pReceivedData, sizeof( _pSentData ) );
+
+        IotNetworkAfr_GetReceiveStats( pConnection, &stats );
+        TEST_ASSERT_EQUAL_UINT32( sizeof( _pSentData ), stats.socketBytes );
+        TEST_ASSERT_EQUAL_UINT32( sizeof( _pSentData ), stats.bufferedBytes );
+    }
+
+    _closeEchoConnection( pConnection );
+
+    if( doneCreated == true )
+    {
+        IotSemaphore_Destroy( &( receiveContext.done ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
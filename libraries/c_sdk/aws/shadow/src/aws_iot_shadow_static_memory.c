@@ -83,11 +83,11 @@
 /*
  * Static memory buffers and flags, allocated and zeroed at compile-time.
  */
-    static bool _pInUseShadowOperations[ AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS ] = { 0 };                          /**< @brief Shadow operation in-use flags. */
-    static _shadowOperation_t _pShadowOperations[ AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS ] = { { .link = { 0 } } }; /**< @brief Shadow operations. */
+    static uint32_t _pInUseShadowOperations[ IOT_STATIC_MEMORY_BITMAP_SIZE( AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS ) ] = { 0 }; /**< @brief Shadow operation in-use bitmap. */
+    static _shadowOperation_t _pShadowOperations[ AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS ] = { { .link = { 0 } } };             /**< @brief Shadow operations. */
 
-    static bool _pInUseShadowSubscriptions[ AWS_IOT_SHADOW_SUBSCRIPTIONS ] = { 0 };                                    /**< @brief Shadow subscription in-use flags. */
-    static char _pShadowSubscriptions[ AWS_IOT_SHADOW_SUBSCRIPTIONS ][ SHADOW_SUBSCRIPTION_SIZE ] = { { 0 } };         /**< @brief Shadow subscriptions. */
+    static uint32_t _pInUseShadowSubscriptions[ IOT_STATIC_MEMORY_BITMAP_SIZE( AWS_IOT_SHADOW_SUBSCRIPTIONS ) ] = { 0 };           /**< @brief Shadow subscription in-use bitmap. */
+    static char _pShadowSubscriptions[ AWS_IOT_SHADOW_SUBSCRIPTIONS ][ SHADOW_SUBSCRIPTION_SIZE ] = { { 0 } };                     /**< @brief Shadow subscriptions. */
 
 /*-----------------------------------------------------------*/
 
@@ -100,8 +100,8 @@
         if( size == sizeof( _shadowOperation_t ) )
         {
             /* Find a free Shadow operation. */
-            freeIndex = IotStaticMemory_FindFree( _pInUseShadowOperations,
-                                                  AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS );
+            freeIndex = IotStaticMemory_FindFreeBit( _pInUseShadowOperations,
+                                                     AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS );
 
             if( freeIndex != -1 )
             {
@@ -117,11 +117,11 @@
     void AwsIotShadow_FreeOperation( void * ptr )
     {
         /* Return the in-use Shadow operation. */
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _pShadowOperations,
-                                     _pInUseShadowOperations,
-                                     AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS,
-                                     sizeof( _shadowOperation_t ) );
+        ( void ) IotStaticMemory_ReturnBit( ptr,
+                                            _pShadowOperations,
+                                            _pInUseShadowOperations,
+                                            AWS_IOT_SHADOW_MAX_IN_PROGRESS_OPERATIONS,
+                                            sizeof( _shadowOperation_t ) );
     }
 
 /*-----------------------------------------------------------*/
@@ -134,8 +134,8 @@
         if( size <= SHADOW_SUBSCRIPTION_SIZE )
         {
             /* Get the index of a free Shadow subscription. */
-            freeIndex = IotStaticMemory_FindFree( _pInUseShadowSubscriptions,
-                                                  AWS_IOT_SHADOW_SUBSCRIPTIONS );
+            freeIndex = IotStaticMemory_FindFreeBit( _pInUseShadowSubscriptions,
+                                                     AWS_IOT_SHADOW_SUBSCRIPTIONS );
 
             if( freeIndex != -1 )
             {
@@ -151,11 +151,11 @@
     void AwsIotShadow_FreeSubscription( void * ptr )
     {
         /* Return the in-use Shadow subscription. */
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _pShadowSubscriptions,
-                                     _pInUseShadowSubscriptions,
-                                     AWS_IOT_SHADOW_SUBSCRIPTIONS,
-                                     SHADOW_SUBSCRIPTION_SIZE );
+        ( void ) IotStaticMemory_ReturnBit( ptr,
+                                            _pShadowSubscriptions,
+                                            _pInUseShadowSubscriptions,
+                                            AWS_IOT_SHADOW_SUBSCRIPTIONS,
+                                            SHADOW_SUBSCRIPTION_SIZE );
     }
 
 /*-----------------------------------------------------------*/
@@ -69,8 +69,14 @@
  * @function_brief{taskpool_function_schedule}
  * - @function_name{taskpool_function_scheduledeferred}
  * @function_brief{taskpool_function_scheduledeferred}
+ * - @function_name{taskpool_function_schedulewithpriority}
+ * @function_brief{taskpool_function_schedulewithpriority}
+ * - @function_name{taskpool_function_scheduledeferredwithpriority}
+ * @function_brief{taskpool_function_scheduledeferredwithpriority}
  * - @function_name{taskpool_function_getstatus}
  * @function_brief{taskpool_function_getstatus}
+ * - @function_name{taskpool_function_getstatistics}
+ * @function_brief{taskpool_function_getstatistics}
  * - @function_name{taskpool_function_trycancel}
  * @function_brief{taskpool_function_trycancel}
  * - @function_name{taskpool_function_getjobstoragefromhandle}
@@ -113,9 +119,18 @@
  * @function_page{IotTaskPool_ScheduleDeferred,taskpool,scheduledeferred}
  * @function_snippet{taskpool,scheduledeferred,this}
  * @copydoc IotTaskPool_ScheduleDeferred
+ * @function_page{IotTaskPool_ScheduleWithPriority,taskpool,schedulewithpriority}
+ * @function_snippet{taskpool,schedulewithpriority,this}
+ * @copydoc IotTaskPool_ScheduleWithPriority
+ * @function_page{IotTaskPool_ScheduleDeferredWithPriority,taskpool,scheduledeferredwithpriority}
+ * @function_snippet{taskpool,scheduledeferredwithpriority,this}
+ * @copydoc IotTaskPool_ScheduleDeferredWithPriority
  * @function_page{IotTaskPool_GetStatus,taskpool,getstatus}
  * @function_snippet{taskpool,getstatus,this}
  * @copydoc IotTaskPool_GetStatus
+ * @function_page{IotTaskPool_GetStatistics,taskpool,getstatistics}
+ * @function_snippet{taskpool,getstatistics,this}
+ * @copydoc IotTaskPool_GetStatistics
  * @function_page{IotTaskPool_TryCancel,taskpool,trycancel}
  * @function_snippet{taskpool,trycancel,this}
  * @copydoc IotTaskPool_TryCancel
@@ -490,6 +505,73 @@ IotTaskPoolError_t IotTaskPool_ScheduleDeferred( IotTaskPool_t taskPool,
                                                  uint32_t timeMs );
 /* @[declare_taskpool_scheduledeferred] */
 
+/**
+ * @brief This function schedules a job created with @ref IotTaskPool_CreateJob or @ref IotTaskPool_CreateRecyclableJob
+ * against the task pool pointed to by `taskPool`, in the given priority class.
+ *
+ * Worker threads pick up all scheduled jobs of a higher priority class before any job of a lower class.
+ * Within a class, jobs with a deadline are picked up in order of their deadline, ahead of jobs without
+ * a deadline, which are picked up in FIFO order.
+ *
+ * @param[in] taskPool A handle to the task pool that must have been previously initialized with.
+ * a call to @ref IotTaskPool_Create.
+ * @param[in] job A job to schedule for execution. This must be first initialized with a call to @ref IotTaskPool_CreateJob.
+ * @param[in] priority The priority class of the job.
+ * @param[in] deadlineMs The time in milliseconds within which a worker thread should pick up the job,
+ * or `0` for no deadline. A deadline only orders jobs; a job that misses it still executes, and is
+ * counted in #IotTaskPoolPriorityStatistics_t.missedDeadlines.
+ *
+ * @return One of the following:
+ * - #IOT_TASKPOOL_SUCCESS
+ * - #IOT_TASKPOOL_BAD_PARAMETER
+ * - #IOT_TASKPOOL_ILLEGAL_OPERATION
+ * - #IOT_TASKPOOL_SHUTDOWN_IN_PROGRESS
+ *
+ * @note This function will not allocate memory.
+ *
+ * @warning The `taskPool` used in this function should be the same
+ * used to create the job pointed to by `job`, or the results will be undefined.
+ */
+/* @[declare_taskpool_schedulewithpriority] */
+IotTaskPoolError_t IotTaskPool_ScheduleWithPriority( IotTaskPool_t taskPool,
+                                                     IotTaskPoolJob_t job,
+                                                     IotTaskPoolPriority_t priority,
+                                                     uint32_t deadlineMs );
+/* @[declare_taskpool_schedulewithpriority] */
+
+/**
+ * @brief This function schedules a job created with @ref IotTaskPool_CreateJob against the task pool
+ * pointed to by `taskPool` to be executed after a user-defined time interval, in the given priority class.
+ *
+ * The job enters the dispatch queue of its priority class when `timeMs` expires. See
+ * @ref IotTaskPool_ScheduleWithPriority for how priority classes and deadlines order jobs.
+ *
+ * @param[in] taskPool A handle to the task pool that must have been previously initialized with.
+ * a call to @ref IotTaskPool_Create.
+ * @param[in] job A job to schedule for execution. This must be first initialized with a call to @ref IotTaskPool_CreateJob.
+ * @param[in] timeMs The time in milliseconds to wait before scheduling the job.
+ * @param[in] priority The priority class of the job.
+ * @param[in] deadlineMs The time in milliseconds, counted from when `timeMs` expires, within which a
+ * worker thread should pick up the job, or `0` for no deadline.
+ *
+ * @return One of the following:
+ * - #IOT_TASKPOOL_SUCCESS
+ * - #IOT_TASKPOOL_BAD_PARAMETER
+ * - #IOT_TASKPOOL_ILLEGAL_OPERATION
+ * - #IOT_TASKPOOL_NO_MEMORY
+ * - #IOT_TASKPOOL_SHUTDOWN_IN_PROGRESS
+ *
+ * @warning The `taskPool` used in this function should be the same
+ * used to create the job pointed to by `job`, or the results will be undefined.
+ */
+/* @[declare_taskpool_scheduledeferredwithpriority] */
+IotTaskPoolError_t IotTaskPool_ScheduleDeferredWithPriority( IotTaskPool_t taskPool,
+                                                             IotTaskPoolJob_t job,
+                                                             uint32_t timeMs,
+                                                             IotTaskPoolPriority_t priority,
+                                                             uint32_t deadlineMs );
+/* @[declare_taskpool_scheduledeferredwithpriority] */
+
 /**
  * @brief This function retrieves the current status of a job.
  *
@@ -512,6 +594,28 @@ IotTaskPoolError_t IotTaskPool_GetStatus( IotTaskPool_t taskPool,
                                           IotTaskPoolJobStatus_t * const pStatus );
 /* @[declare_taskpool_getstatus] */
 
+/**
+ * @brief This function retrieves the queue depth and wait time statistics of each priority class
+ * of a task pool.
+ *
+ * @param[in] taskPool A handle to the task pool that must have been previously initialized with
+ * a call to @ref IotTaskPool_Create or @ref IotTaskPool_CreateSystemTaskPool.
+ * @param[out] pStatistics Set to the statistics of the task pool.
+ *
+ * @return One of the following:
+ * - #IOT_TASKPOOL_SUCCESS
+ * - #IOT_TASKPOOL_BAD_PARAMETER
+ * - #IOT_TASKPOOL_SHUTDOWN_IN_PROGRESS
+ *
+ * @note With @ref IOT_TASKPOOL_ENABLE_WORK_STEALING, the statistics are the sum over all
+ * worker queues, except for #IotTaskPoolPriorityStatistics_t.maxQueueDepth and
+ * #IotTaskPoolPriorityStatistics_t.maxWaitMs, which are the largest values of any single queue.
+ */
+/* @[declare_taskpool_getstatistics] */
+IotTaskPoolError_t IotTaskPool_GetStatistics( IotTaskPool_t taskPool,
+                                              IotTaskPoolStatistics_t * const pStatistics );
+/* @[declare_taskpool_getstatistics] */
+
 /**
  * @brief This function tries to cancel a job that was previously scheduled with @ref IotTaskPool_Schedule.
  *
@@ -601,4 +705,39 @@ const char * IotTaskPool_strerror( IotTaskPoolError_t status );
     #define IOT_TASKPOOL_JOB_WAIT_TIMEOUT_MS    ( 60 * 1000UL )
 #endif
 
+/**
+ * @brief Set this to `1` to give each worker thread its own job queue.
+ *
+ * Scheduled jobs are distributed round-robin across the worker queues. A worker
+ * runs jobs from its own queue first and steals jobs from the other queues when
+ * its queue is empty, so workers do not contend on the task pool lock to pick up
+ * jobs. Scheduling a job only takes the lock of one worker queue, unless the job
+ * is high priority, is already scheduled or deferred, or needs a new worker
+ * thread. Jobs in the same queue still execute in FIFO order, but there is no
+ * ordering between jobs in different queues.
+ */
+#ifndef IOT_TASKPOOL_ENABLE_WORK_STEALING
+    #define IOT_TASKPOOL_ENABLE_WORK_STEALING    ( 0 )
+#endif
+
+/**
+ * @brief The resolution in milliseconds of the timer wheel that holds deferred jobs.
+ *
+ * A deferred job is placed in the dispatch queue on the first tick of the timer wheel
+ * at or after its expiration time, so it may be up to one tick late. A timer wheel
+ * covers 2^20 ticks; jobs deferred further than that are carried over until they are
+ * in range.
+ */
+#ifndef IOT_TASKPOOL_TIMER_WHEEL_TICK_MS
+    #define IOT_TASKPOOL_TIMER_WHEEL_TICK_MS    ( 10ULL )
+#endif
+
+/**
+ * @brief The number of worker queues of a task pool when @ref IOT_TASKPOOL_ENABLE_WORK_STEALING
+ * is `1`. Worker threads beyond this number do not own a queue and only steal jobs.
+ */
+#ifndef IOT_TASKPOOL_WORKER_QUEUES
+    #define IOT_TASKPOOL_WORKER_QUEUES    ( 4UL )
+#endif
+
 #endif /* ifndef IOT_TASKPOOL_H_ */
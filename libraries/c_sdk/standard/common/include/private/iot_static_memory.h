@@ -53,14 +53,43 @@
  * @function_brief{static_memory_function_findfree}
  * - @function_name{static_memory_function_returninuse}
  * @function_brief{static_memory_function_returninuse}
+ * - @function_name{static_memory_function_findfreebit}
+ * @function_brief{static_memory_function_findfreebit}
+ * - @function_name{static_memory_function_returnbit}
+ * @function_brief{static_memory_function_returnbit}
  * - @function_name{static_memory_function_messagebuffersize}
  * @function_brief{static_memory_function_messagebuffersize}
  * - @function_name{static_memory_function_mallocmessagebuffer}
  * @function_brief{static_memory_function_mallocmessagebuffer}
  * - @function_name{static_memory_function_freemessagebuffer}
  * @function_brief{static_memory_function_freemessagebuffer}
+ * - @function_name{static_memory_function_getmessagebufferstats}
+ * @function_brief{static_memory_function_getmessagebufferstats}
  */
 
+/**
+ * @brief The number of `uint32_t` words needed for an in-use bitmap of `count`
+ * buffers.
+ *
+ * Used to declare the in-use bitmaps passed to @ref static_memory_function_findfreebit
+ * and @ref static_memory_function_returnbit.
+ */
+    #define IOT_STATIC_MEMORY_BITMAP_SIZE( count )    ( ( ( count ) + 31 ) / 32 )
+
+/**
+ * @brief Usage statistics of one message buffer size class.
+ *
+ * Filled in by @ref static_memory_function_getmessagebufferstats.
+ */
+    typedef struct IotMessageBufferStats
+    {
+        size_t bufferSize;      /**< @brief Size of each buffer in this class. */
+        uint32_t bufferCount;   /**< @brief Number of buffers in this class. */
+        uint32_t inUse;         /**< @brief Number of buffers currently allocated. */
+        uint32_t highWaterMark; /**< @brief Largest value of `inUse` seen since initialization. */
+        uint32_t failures;      /**< @brief Number of requests this class could not satisfy. */
+    } IotMessageBufferStats_t;
+
 /*----------------------- Initialization and cleanup ------------------------*/
 
 /**
@@ -212,6 +241,58 @@
                                       size_t elementSize );
 /* @[declare_static_memory_returninuse] */
 
+/**
+ * @function_page{IotStaticMemory_FindFreeBit,static_memory,findfreebit}
+ * @function_snippet{static_memory,findfreebit,this}
+ * @copydoc IotStaticMemory_FindFreeBit
+ * @function_page{IotStaticMemory_ReturnBit,static_memory,returnbit}
+ * @function_snippet{static_memory,returnbit,this}
+ * @copydoc IotStaticMemory_ReturnBit
+ */
+
+/**
+ * @brief Find a free buffer using an "in-use" bitmap.
+ *
+ * Like @ref static_memory_function_findfree, but the in-use flags are packed
+ * into a bitmap and a buffer is claimed with an atomic compare-and-swap instead
+ * of in a critical section. Words with no free bits are skipped 32 buffers at a
+ * time.
+ *
+ * @param[in] pInUse The "in-use" bitmap to search. Must hold at least
+ * @ref IOT_STATIC_MEMORY_BITMAP_SIZE( `limit` ) words.
+ * @param[in] limit How many buffers the bitmap tracks.
+ *
+ * @return The index of a free buffer; `-1` if no free buffers are available.
+ */
+/* @[declare_static_memory_findfreebit] */
+    int32_t IotStaticMemory_FindFreeBit( uint32_t * pInUse,
+                                         size_t limit );
+/* @[declare_static_memory_findfreebit] */
+
+/**
+ * @brief Return a buffer claimed with @ref static_memory_function_findfreebit.
+ *
+ * The index of the buffer is computed from its address, so this function does
+ * not search `pPool`. Pointers that are not the start of an in-use element of
+ * `pPool` are ignored.
+ *
+ * @param[in] ptr Pointer to the buffer to return.
+ * @param[in] pPool The pool of buffers that the in-use buffer was allocated from.
+ * @param[in] pInUse The "in-use" bitmap for pPool.
+ * @param[in] limit How many buffers are in pPool.
+ * @param[in] elementSize The size of a single element in pPool.
+ *
+ * @return `true` if `ptr` was an in-use element of `pPool` and was returned;
+ * `false` otherwise.
+ */
+/* @[declare_static_memory_returnbit] */
+    bool IotStaticMemory_ReturnBit( void * ptr,
+                                    void * pPool,
+                                    uint32_t * pInUse,
+                                    size_t limit,
+                                    size_t elementSize );
+/* @[declare_static_memory_returnbit] */
+
 /*------------------------ Message buffer management ------------------------*/
 
 /**
@@ -224,6 +305,9 @@
  * @function_page{Iot_FreeMessageBuffer,static_memory,freemessagebuffer}
  * @function_snippet{static_memory,freemessagebuffer,this}
  * @copydoc Iot_FreeMessageBuffer
+ * @function_page{Iot_GetMessageBufferStats,static_memory,getmessagebufferstats}
+ * @function_snippet{static_memory,getmessagebufferstats,this}
+ * @copydoc Iot_GetMessageBufferStats
  */
 
 /**
@@ -233,7 +317,8 @@
  * (@ref IOT_MESSAGE_BUFFER_SIZE) that may not be visible to all source files.
  * This function allows other source files to know the size of a message buffer.
  *
- * @return The size, in bytes, of a single message buffer.
+ * @return The size, in bytes, of a single message buffer. This is the size of
+ * the largest message buffer class.
  */
 /* @[declare_static_memory_messagebuffersize] */
     size_t Iot_MessageBufferSize( void );
@@ -246,6 +331,13 @@
  * (http://pubs.opengroup.org/onlinepubs/9699919799/functions/malloc.html)
  * for message buffers.
  *
+ * Message buffers come in up to three size classes: @ref IOT_MESSAGE_BUFFER_SMALL_SIZE,
+ * @ref IOT_MESSAGE_BUFFER_MEDIUM_SIZE and @ref IOT_MESSAGE_BUFFER_SIZE. The small
+ * and medium classes are only present when @ref IOT_MESSAGE_BUFFERS_SMALL and
+ * @ref IOT_MESSAGE_BUFFERS_MEDIUM are set above `0`. A buffer is taken from the
+ * smallest class that fits `size`; if that class is exhausted, the next larger
+ * class is tried.
+ *
  * @param[in] size Requested size for a message buffer.
  *
  * @return Pointer to the start of a message buffer. If the `size` argument is larger
@@ -269,4 +361,22 @@
     void Iot_FreeMessageBuffer( void * ptr );
 /* @[declare_static_memory_freemessagebuffer] */
 
+/**
+ * @brief Get the usage statistics of a message buffer size class.
+ *
+ * Size classes are numbered from the smallest enabled class (`0`) to the
+ * largest, which is always the @ref IOT_MESSAGE_BUFFER_SIZE class. The
+ * statistics are read without locking, so they may be slightly stale while
+ * other tasks allocate or free message buffers.
+ *
+ * @param[in] sizeClass The size class to query.
+ * @param[out] pStats Set to the statistics of `sizeClass`.
+ *
+ * @return `true` if `sizeClass` is valid and `pStats` was set; `false` otherwise.
+ */
+/* @[declare_static_memory_getmessagebufferstats] */
+    bool Iot_GetMessageBufferStats( uint32_t sizeClass,
+                                    IotMessageBufferStats_t * pStats );
+/* @[declare_static_memory_getmessagebufferstats] */
+
 #endif /* if !defined( IOT_STATIC_MEMORY_H_ ) && ( IOT_STATIC_MEMORY_ONLY == 1 ) */
@@ -233,6 +233,70 @@ typedef struct _taskPoolCache
     uint32_t freeCount;       /**< @brief A counter to track the number of jobs in the cache. */
 } _taskPoolCache_t;
 
+/**
+ * @brief The queues of the jobs waiting to be executed, one for each priority class.
+ *
+ * @warning This is a system-level data type that should not be modified or used directly in any application.
+ * @warning This is a system-level data type that can and will change across different versions of the platform, with no regards for backward compatibility.
+ *
+ */
+typedef struct _taskPoolDispatchQueue
+{
+    IotDeQueue_t jobs[ IOT_TASKPOOL_PRIORITIES ];                          /**< @brief The jobs waiting to be executed in each priority class. */
+    IotTaskPoolPriorityStatistics_t statistics[ IOT_TASKPOOL_PRIORITIES ]; /**< @brief The statistics of each priority class. */
+} _taskPoolDispatchQueue_t;
+
+/**
+ * @brief The number of levels of the timer wheel for deferred jobs.
+ */
+#define TASKPOOL_TIMER_WHEEL_LEVELS       ( 4U )
+
+/**
+ * @brief The number of bits of a timer wheel tick that index the slots of one level.
+ */
+#define TASKPOOL_TIMER_WHEEL_SLOT_BITS    ( 5U )
+
+/**
+ * @brief The number of slots in each level of the timer wheel.
+ */
+#define TASKPOOL_TIMER_WHEEL_SLOTS        ( 1U << TASKPOOL_TIMER_WHEEL_SLOT_BITS )
+
+/**
+ * @brief The hierarchical timer wheel for the deferred jobs of a task pool.
+ *
+ * Level 0 has one slot per tick of @ref IOT_TASKPOOL_TIMER_WHEEL_TICK_MS. Each
+ * slot of level `n` spans a whole turn of level `n - 1`, and its timer events are
+ * moved to the lower levels when the wheel reaches the start of the slot.
+ *
+ * @warning This is a system-level data type that should not be modified or used directly in any application.
+ * @warning This is a system-level data type that can and will change across different versions of the platform, with no regards for backward compatibility.
+ *
+ */
+typedef struct _taskPoolTimerWheel
+{
+    IotListDouble_t slots[ TASKPOOL_TIMER_WHEEL_LEVELS ][ TASKPOOL_TIMER_WHEEL_SLOTS ]; /**< @brief The timer events in each slot of each level. */
+    uint64_t currentTick;                                                              /**< @brief The last tick processed by the timer wheel. */
+    uint64_t armedTime;                                                                /**< @brief When the task pool timer is armed to fire, or UINT64_MAX. */
+    uint32_t count;                                                                    /**< @brief The number of timer events in the timer wheel. */
+} _taskPoolTimerWheel_t;
+
+#if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+
+/**
+ * @brief The job queue of one task pool worker thread.
+ *
+ * @warning This is a system-level data type that should not be modified or used directly in any application.
+ * @warning This is a system-level data type that can and will change across different versions of the platform, with no regards for backward compatibility.
+ *
+ */
+    typedef struct _taskPoolWorkerQueue
+    {
+        _taskPoolDispatchQueue_t queue; /**< @brief The jobs waiting to be executed. */
+        IotMutex_t lock;                /**< @brief The lock to protect the queue and the status of the jobs in it. */
+        bool owned;                     /**< @brief Whether a worker thread owns this queue. */
+    } _taskPoolWorkerQueue_t;
+#endif
+
 /**
  * @brief The task pool data structure keeps track of the internal state and the signals for the dispatcher threads.
  * The task pool is a thread safe data structure.
@@ -243,8 +307,8 @@ typedef struct _taskPoolCache
  */
 typedef struct _taskPool
 {
-    IotDeQueue_t dispatchQueue;      /**< @brief The queue for the jobs waiting to be executed. */
-    IotListDouble_t timerEventsList; /**< @brief The timeouts queue for all deferred jobs waiting to be executed. */
+    _taskPoolDispatchQueue_t dispatchQueue; /**< @brief The queue for the jobs waiting to be executed. */
+    _taskPoolTimerWheel_t timerWheel; /**< @brief The timer wheel for all deferred jobs waiting to be executed. */
     _taskPoolCache_t jobsCache;      /**< @brief A cache to re-use jobs in order to limit memory allocations. */
     uint32_t minThreads;             /**< @brief The minimum number of threads for the task pool. */
     uint32_t maxThreads;             /**< @brief The maximum number of threads for the task pool. */
@@ -256,6 +320,10 @@ typedef struct _taskPool
     IotSemaphore_t startStopSignal;  /**< @brief The synchronization object for threads to signal start and stop condition. */
     IotTimer_t timer;                /**< @brief The timer for deferred jobs. */
     IotMutex_t lock;                 /**< @brief The lock to protect the task pool data structure access. */
+    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+        _taskPoolWorkerQueue_t workerQueues[ IOT_TASKPOOL_WORKER_QUEUES ]; /**< @brief The per-worker job queues. */
+        uint32_t nextWorkerQueue;                                          /**< @brief The next worker queue to schedule a job to. */
+    #endif
 } _taskPool_t;
 
 /**
@@ -267,18 +335,24 @@ typedef struct _taskPool
  */
 typedef struct _taskPoolJob
 {
-    IotLink_t link;                    /**< @brief The link to insert the job in the dispatch queue. */
-    IotTaskPoolRoutine_t userCallback; /**< @brief The user provided callback. */
-    void * pUserContext;               /**< @brief The user provided context. */
-    uint32_t flags;                    /**< @brief Internal flags. */
-    IotTaskPoolJobStatus_t status;     /**< @brief The status for the job. */
+    IotLink_t link;                           /**< @brief The link to insert the job in the dispatch queue. */
+    IotTaskPoolRoutine_t userCallback;        /**< @brief The user provided callback. */
+    void * pUserContext;                      /**< @brief The user provided context. */
+    uint32_t flags;                           /**< @brief Internal flags. */
+    IotTaskPoolJobStatus_t status;            /**< @brief The status for the job. */
+    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+        uint32_t workerQueue;                 /**< @brief The worker queue of a scheduled job. */
+    #endif
+    IotTaskPoolPriority_t priority;           /**< @brief The priority class of the job. */
+    uint32_t deadlineMs;                      /**< @brief The time within which the job should be picked up once ready, or 0. */
+    uint64_t readyTime;                       /**< @brief When the job was placed in the dispatch queue. */
+    struct _taskPoolTimerEvent * pTimerEvent; /**< @brief The timer event of a deferred job. */
 } _taskPoolJob_t;
 
 /**
  * @brief Represents an operation that is subject to a timer.
  *
- * These events are queued per MQTT connection. They are sorted by their
- * expiration time.
+ * These events are held in the slots of the task pool timer wheel.
  */
 typedef struct _taskPoolTimerEvent
 {
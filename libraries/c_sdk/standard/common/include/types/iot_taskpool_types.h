@@ -196,6 +196,32 @@ typedef enum IotTaskPoolJobStatus
     IOT_TASKPOOL_STATUS_UNDEFINED,
 } IotTaskPoolJobStatus_t;
 
+/**
+ * @ingroup taskpool_datatypes_enums
+ * @brief Priority classes of [task pool Job](@ref IotTaskPoolJob_t).
+ *
+ * Worker threads always execute all scheduled jobs of a higher class before any
+ * job of a lower class. Jobs scheduled with @ref taskpool_function_schedule or
+ * @ref taskpool_function_scheduledeferred have #IOT_TASKPOOL_PRIORITY_NORMAL.
+ */
+typedef enum IotTaskPoolPriority
+{
+    /**
+     * @brief Background jobs that may be delayed by any other job.
+     */
+    IOT_TASKPOOL_PRIORITY_LOW = 0,
+
+    /**
+     * @brief Default class for jobs.
+     */
+    IOT_TASKPOOL_PRIORITY_NORMAL,
+
+    /**
+     * @brief Latency-sensitive jobs, such as protocol keep-alives.
+     */
+    IOT_TASKPOOL_PRIORITY_HIGH
+} IotTaskPoolPriority_t;
+
 /*------------------------- Task pool types and handles --------------------------*/
 
 /**
@@ -231,6 +257,13 @@ typedef struct IotTaskPoolJobStorage
     void * dummy3;                 /**< @brief Placeholder. */
     uint32_t dummy4;               /**< @brief Placeholder. */
     IotTaskPoolJobStatus_t status; /**< @brief Placeholder. */
+    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+        uint32_t dummy5;           /**< @brief Placeholder. */
+    #endif
+    IotTaskPoolPriority_t dummy6;  /**< @brief Placeholder. */
+    uint32_t dummy7;               /**< @brief Placeholder. */
+    uint64_t dummy8;               /**< @brief Placeholder. */
+    void * dummy9;                 /**< @brief Placeholder. */
 } IotTaskPoolJobStorage_t;
 
 /**
@@ -291,6 +324,37 @@ typedef struct IotTaskPoolInfo
     int32_t priority;    /**< @brief priority for every task pool thread. The priority for each thread is fixed after the task pool is created and cannot be changed. */
 } IotTaskPoolInfo_t;
 
+/**
+ * @ingroup taskpool_datatypes_paramstructs
+ * @brief Statistics of the jobs of one priority class.
+ *
+ * Wait times are measured from when a job is placed in the dispatch queue (for
+ * deferred jobs, when their delay expires) until a worker thread picks it up.
+ */
+typedef struct IotTaskPoolPriorityStatistics
+{
+    uint32_t queueDepth;      /**< @brief Number of jobs waiting for a worker thread. */
+    uint32_t maxQueueDepth;   /**< @brief Largest number of jobs waiting for a worker thread. */
+    uint32_t dispatchedJobs;  /**< @brief Number of jobs picked up by a worker thread. */
+    uint32_t missedDeadlines; /**< @brief Number of jobs picked up by a worker thread after their deadline. */
+    uint64_t totalWaitMs;     /**< @brief Sum of the wait times of all dispatched jobs. */
+    uint32_t maxWaitMs;       /**< @brief Longest wait time of a dispatched job. */
+} IotTaskPoolPriorityStatistics_t;
+
+/**
+ * @ingroup taskpool_datatypes_paramstructs
+ * @brief Statistics of a task pool, as returned by @ref taskpool_function_getstatistics.
+ *
+ * @paramfor @ref taskpool_function_getstatistics
+ */
+typedef struct IotTaskPoolStatistics
+{
+    /**
+     * @brief Statistics of each priority class, indexed by #IotTaskPoolPriority_t.
+     */
+    IotTaskPoolPriorityStatistics_t priorities[ IOT_TASKPOOL_PRIORITY_HIGH + 1 ];
+} IotTaskPoolStatistics_t;
+
 /*------------------------- TASKPOOL defined constants --------------------------*/
 
 /**
@@ -353,6 +417,11 @@ typedef struct IotTaskPoolInfo
  */
 #define IOT_TASKPOOL_JOB_HIGH_PRIORITY    ( ( uint32_t ) 0x00000001 )
 
+/**
+ * @brief The number of job priority classes.
+ */
+#define IOT_TASKPOOL_PRIORITIES           ( IOT_TASKPOOL_PRIORITY_HIGH + 1 )
+
 /**
  * @brief Allows the use of the handle to the system task pool.
  *
@@ -43,6 +43,9 @@
 /* Platform layer includes. */
     #include "platform/iot_threads.h"
 
+/* Atomics include. */
+    #include "iot_atomic.h"
+
 /* Static memory include. */
     #include "private/iot_static_memory.h"
 
@@ -60,6 +63,23 @@
     #ifndef IOT_MESSAGE_BUFFER_SIZE
         #define IOT_MESSAGE_BUFFER_SIZE    ( 1024 )
     #endif
+    #ifndef IOT_MESSAGE_BUFFERS_SMALL
+        #define IOT_MESSAGE_BUFFERS_SMALL    ( 0 )
+    #endif
+    #ifndef IOT_MESSAGE_BUFFER_SMALL_SIZE
+        #define IOT_MESSAGE_BUFFER_SMALL_SIZE    ( 64 )
+    #endif
+    #ifndef IOT_MESSAGE_BUFFERS_MEDIUM
+        #define IOT_MESSAGE_BUFFERS_MEDIUM    ( 0 )
+    #endif
+    #ifndef IOT_MESSAGE_BUFFER_MEDIUM_SIZE
+        #define IOT_MESSAGE_BUFFER_MEDIUM_SIZE    ( 256 )
+    #endif
+
+/* Marks the empty statement of an else branch, as in the MQTT library. */
+    #ifndef EMPTY_ELSE_MARKER
+        #define EMPTY_ELSE_MARKER
+    #endif
 /** @endcond */
 
 /* Validate static memory configuration settings. */
@@ -69,6 +89,58 @@
     #if IOT_MESSAGE_BUFFER_SIZE <= 0
         #error "IOT_MESSAGE_BUFFER_SIZE cannot be 0 or negative."
     #endif
+    #if IOT_MESSAGE_BUFFERS_SMALL < 0
+        #error "IOT_MESSAGE_BUFFERS_SMALL cannot be negative."
+    #endif
+    #if IOT_MESSAGE_BUFFERS_MEDIUM < 0
+        #error "IOT_MESSAGE_BUFFERS_MEDIUM cannot be negative."
+    #endif
+    #if ( IOT_MESSAGE_BUFFERS_SMALL > 0 ) && ( ( IOT_MESSAGE_BUFFER_SMALL_SIZE <= 0 ) || ( IOT_MESSAGE_BUFFER_SMALL_SIZE >= IOT_MESSAGE_BUFFER_SIZE ) )
+        #error "IOT_MESSAGE_BUFFER_SMALL_SIZE must be positive and less than IOT_MESSAGE_BUFFER_SIZE."
+    #endif
+    #if ( IOT_MESSAGE_BUFFERS_MEDIUM > 0 ) && ( ( IOT_MESSAGE_BUFFER_MEDIUM_SIZE <= 0 ) || ( IOT_MESSAGE_BUFFER_MEDIUM_SIZE >= IOT_MESSAGE_BUFFER_SIZE ) )
+        #error "IOT_MESSAGE_BUFFER_MEDIUM_SIZE must be positive and less than IOT_MESSAGE_BUFFER_SIZE."
+    #endif
+    #if ( IOT_MESSAGE_BUFFERS_SMALL > 0 ) && ( IOT_MESSAGE_BUFFERS_MEDIUM > 0 ) && ( IOT_MESSAGE_BUFFER_SMALL_SIZE >= IOT_MESSAGE_BUFFER_MEDIUM_SIZE )
+        #error "IOT_MESSAGE_BUFFER_SMALL_SIZE must be less than IOT_MESSAGE_BUFFER_MEDIUM_SIZE."
+    #endif
+
+/**
+ * @brief Whether the small and medium message buffer size classes are enabled.
+ *
+ * A size class with no buffers is left out entirely, so it uses no memory.
+ */
+    #if IOT_MESSAGE_BUFFERS_SMALL > 0
+        #define MESSAGE_BUFFER_SMALL_CLASS     ( 1 )
+    #else
+        #define MESSAGE_BUFFER_SMALL_CLASS     ( 0 )
+    #endif
+    #if IOT_MESSAGE_BUFFERS_MEDIUM > 0
+        #define MESSAGE_BUFFER_MEDIUM_CLASS    ( 1 )
+    #else
+        #define MESSAGE_BUFFER_MEDIUM_CLASS    ( 0 )
+    #endif
+
+/**
+ * @brief The number of message buffer size classes.
+ */
+    #define MESSAGE_BUFFER_CLASSES    ( MESSAGE_BUFFER_SMALL_CLASS + MESSAGE_BUFFER_MEDIUM_CLASS + 1 )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Represents one message buffer size class.
+ */
+    typedef struct _messageBufferClass
+    {
+        size_t bufferSize;               /**< @brief Size of each buffer. */
+        uint32_t bufferCount;            /**< @brief Number of buffers. */
+        uint8_t * pBuffers;              /**< @brief The buffers, `bufferCount` of `bufferSize` bytes. */
+        uint32_t * pInUse;               /**< @brief In-use bitmap of the buffers. */
+        uint32_t volatile inUse;         /**< @brief Number of buffers allocated. */
+        uint32_t volatile highWaterMark; /**< @brief Largest value of `inUse`. */
+        uint32_t volatile failures;      /**< @brief Number of failed allocations. */
+    } _messageBufferClass_t;
 
 /*-----------------------------------------------------------*/
 
@@ -80,8 +152,71 @@
 /*
  * Static memory buffers and flags, allocated and zeroed at compile-time.
  */
-    static bool _pInUseMessageBuffers[ IOT_MESSAGE_BUFFERS ] = { 0 };                           /**< @brief Message buffer in-use flags. */
-    static char _pMessageBuffers[ IOT_MESSAGE_BUFFERS ][ IOT_MESSAGE_BUFFER_SIZE ] = { { 0 } }; /**< @brief Message buffers. */
+    #if MESSAGE_BUFFER_SMALL_CLASS == 1
+        static uint32_t _pInUseSmallMessageBuffers[ IOT_STATIC_MEMORY_BITMAP_SIZE( IOT_MESSAGE_BUFFERS_SMALL ) ] = { 0 };   /**< @brief Small message buffer in-use bitmap. */
+        static char _pSmallMessageBuffers[ IOT_MESSAGE_BUFFERS_SMALL ][ IOT_MESSAGE_BUFFER_SMALL_SIZE ] = { { 0 } };        /**< @brief Small message buffers. */
+    #endif
+    #if MESSAGE_BUFFER_MEDIUM_CLASS == 1
+        static uint32_t _pInUseMediumMessageBuffers[ IOT_STATIC_MEMORY_BITMAP_SIZE( IOT_MESSAGE_BUFFERS_MEDIUM ) ] = { 0 }; /**< @brief Medium message buffer in-use bitmap. */
+        static char _pMediumMessageBuffers[ IOT_MESSAGE_BUFFERS_MEDIUM ][ IOT_MESSAGE_BUFFER_MEDIUM_SIZE ] = { { 0 } };     /**< @brief Medium message buffers. */
+    #endif
+    static uint32_t _pInUseMessageBuffers[ IOT_STATIC_MEMORY_BITMAP_SIZE( IOT_MESSAGE_BUFFERS ) ] = { 0 };              /**< @brief Message buffer in-use bitmap. */
+    static char _pMessageBuffers[ IOT_MESSAGE_BUFFERS ][ IOT_MESSAGE_BUFFER_SIZE ] = { { 0 } };                         /**< @brief Message buffers. */
+
+/**
+ * @brief Message buffer size classes, from smallest to largest.
+ */
+    static _messageBufferClass_t _pMessageBufferClasses[ MESSAGE_BUFFER_CLASSES ] =
+    {
+        #if MESSAGE_BUFFER_SMALL_CLASS == 1
+            {
+                .bufferSize = IOT_MESSAGE_BUFFER_SMALL_SIZE,
+                .bufferCount = IOT_MESSAGE_BUFFERS_SMALL,
+                .pBuffers = ( uint8_t * ) _pSmallMessageBuffers,
+                .pInUse = _pInUseSmallMessageBuffers
+            },
+        #endif
+        #if MESSAGE_BUFFER_MEDIUM_CLASS == 1
+            {
+                .bufferSize = IOT_MESSAGE_BUFFER_MEDIUM_SIZE,
+                .bufferCount = IOT_MESSAGE_BUFFERS_MEDIUM,
+                .pBuffers = ( uint8_t * ) _pMediumMessageBuffers,
+                .pInUse = _pInUseMediumMessageBuffers
+            },
+        #endif
+        {
+            .bufferSize = IOT_MESSAGE_BUFFER_SIZE,
+            .bufferCount = IOT_MESSAGE_BUFFERS,
+            .pBuffers = ( uint8_t * ) _pMessageBuffers,
+            .pInUse = _pInUseMessageBuffers
+        }
+    };
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Update the statistics of a size class after a buffer is allocated.
+ *
+ * @param[in] pClass The size class that a buffer was allocated from.
+ */
+    static void _recordAllocation( _messageBufferClass_t * pClass );
+
+/*-----------------------------------------------------------*/
+
+    static void _recordAllocation( _messageBufferClass_t * pClass )
+    {
+        uint32_t inUse = Atomic_Increment_u32( &( pClass->inUse ) ) + 1U;
+        uint32_t highWaterMark = pClass->highWaterMark;
+
+        /* Raise the high-water mark unless another task raised it past inUse. */
+        while( ( inUse > highWaterMark ) &&
+               ( Atomic_CompareAndSwap_u32( &( pClass->highWaterMark ),
+                                            inUse,
+                                            highWaterMark ) != ATOMIC_COMPARE_AND_SWAP_SUCCESS ) )
+        {
+            highWaterMark = pClass->highWaterMark;
+        }
+    }
 
 /*-----------------------------------------------------------*/
 
@@ -147,6 +282,99 @@
         IotMutex_Unlock( &( _mutex ) );
     }
 
+/*-----------------------------------------------------------*/
+
+    int32_t IotStaticMemory_FindFreeBit( uint32_t * pInUse,
+                                         size_t limit )
+    {
+        size_t i = 0;
+        uint32_t word = 0, bit = 0;
+        int32_t freeIndex = -1;
+
+        while( ( i < limit ) && ( freeIndex == -1 ) )
+        {
+            word = pInUse[ i / 32U ];
+            bit = ( uint32_t ) 1U << ( i % 32U );
+
+            if( word == UINT32_MAX )
+            {
+                /* Every buffer tracked by this word is in use; move to the
+                 * first buffer of the next word. */
+                i = ( i | 31U ) + 1U;
+            }
+            else if( ( word & bit ) != 0U )
+            {
+                i++;
+            }
+            else
+            {
+                /* Claim the buffer. If another task changed this word first,
+                 * check the same buffer again with the new value. */
+                if( Atomic_CompareAndSwap_u32( &( pInUse[ i / 32U ] ),
+                                               word | bit,
+                                               word ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+                {
+                    freeIndex = ( int32_t ) i;
+                }
+                else
+                {
+                    EMPTY_ELSE_MARKER;
+                }
+            }
+        }
+
+        return freeIndex;
+    }
+
+/*-----------------------------------------------------------*/
+
+    bool IotStaticMemory_ReturnBit( void * ptr,
+                                    void * pPool,
+                                    uint32_t * pInUse,
+                                    size_t limit,
+                                    size_t elementSize )
+    {
+        bool status = false;
+        size_t offset = 0, index = 0;
+        uint32_t bit = 0;
+
+        /* Compute the index of ptr in pPool. Only pointers to the start of an
+         * element are valid. */
+        if( ( uint8_t * ) ptr >= ( uint8_t * ) pPool )
+        {
+            offset = ( size_t ) ( ( uint8_t * ) ptr - ( uint8_t * ) pPool );
+            index = offset / elementSize;
+
+            if( ( index < limit ) && ( ( offset % elementSize ) == 0U ) )
+            {
+                bit = ( uint32_t ) 1U << ( index % 32U );
+
+                if( ( pInUse[ index / 32U ] & bit ) != 0U )
+                {
+                    /* Clear the buffer before making it available again. */
+                    ( void ) memset( ptr, 0x00, elementSize );
+
+                    ( void ) Atomic_AND_u32( &( pInUse[ index / 32U ] ), ~bit );
+                    status = true;
+                }
+                else
+                {
+                    EMPTY_ELSE_MARKER;
+                }
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
+            }
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+
+        return status;
+    }
+
 /*-----------------------------------------------------------*/
 
     bool IotStaticMemory_Init( void )
@@ -172,19 +400,37 @@
 
     void * Iot_MallocMessageBuffer( size_t size )
     {
+        uint32_t i = 0;
         int32_t freeIndex = -1;
         void * pNewBuffer = NULL;
+        _messageBufferClass_t * pClass = NULL;
 
-        /* Check that size is within the fixed message buffer size. */
-        if( size <= IOT_MESSAGE_BUFFER_SIZE )
+        /* Find the smallest size class that fits size, then fall back to larger
+         * classes when it is exhausted. Sizes larger than the fixed message buffer
+         * size skip every class. */
+        for( i = 0; ( i < MESSAGE_BUFFER_CLASSES ) && ( pNewBuffer == NULL ); i++ )
         {
-            /* Get the index of a free message buffer. */
-            freeIndex = IotStaticMemory_FindFree( _pInUseMessageBuffers,
-                                                  IOT_MESSAGE_BUFFERS );
+            pClass = &( _pMessageBufferClasses[ i ] );
 
-            if( freeIndex != -1 )
+            if( size <= pClass->bufferSize )
             {
-                pNewBuffer = &( _pMessageBuffers[ freeIndex ][ 0 ] );
+                /* Get the index of a free message buffer. */
+                freeIndex = IotStaticMemory_FindFreeBit( pClass->pInUse,
+                                                         pClass->bufferCount );
+
+                if( freeIndex != -1 )
+                {
+                    pNewBuffer = pClass->pBuffers + ( ( size_t ) freeIndex * pClass->bufferSize );
+                    _recordAllocation( pClass );
+                }
+                else
+                {
+                    ( void ) Atomic_Increment_u32( &( pClass->failures ) );
+                }
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
             }
         }
 
@@ -195,12 +441,58 @@
 
     void Iot_FreeMessageBuffer( void * ptr )
     {
-        /* Return the in-use message buffer. */
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _pMessageBuffers,
-                                     _pInUseMessageBuffers,
-                                     IOT_MESSAGE_BUFFERS,
-                                     IOT_MESSAGE_BUFFER_SIZE );
+        uint32_t i = 0;
+        bool bufferReturned = false;
+        _messageBufferClass_t * pClass = NULL;
+
+        /* Return the in-use message buffer to the class that contains it. */
+        for( i = 0; ( i < MESSAGE_BUFFER_CLASSES ) && ( bufferReturned == false ); i++ )
+        {
+            pClass = &( _pMessageBufferClasses[ i ] );
+
+            bufferReturned = IotStaticMemory_ReturnBit( ptr,
+                                                        pClass->pBuffers,
+                                                        pClass->pInUse,
+                                                        pClass->bufferCount,
+                                                        pClass->bufferSize );
+
+            if( bufferReturned == true )
+            {
+                ( void ) Atomic_Decrement_u32( &( pClass->inUse ) );
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
+            }
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    bool Iot_GetMessageBufferStats( uint32_t sizeClass,
+                                    IotMessageBufferStats_t * pStats )
+    {
+        bool status = false;
+        const _messageBufferClass_t * pClass = NULL;
+
+        if( ( sizeClass < MESSAGE_BUFFER_CLASSES ) && ( pStats != NULL ) )
+        {
+            pClass = &( _pMessageBufferClasses[ sizeClass ] );
+
+            pStats->bufferSize = pClass->bufferSize;
+            pStats->bufferCount = pClass->bufferCount;
+            pStats->inUse = pClass->inUse;
+            pStats->highWaterMark = pClass->highWaterMark;
+            pStats->failures = pClass->failures;
+
+            status = true;
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+
+        return status;
     }
 
 /*-----------------------------------------------------------*/
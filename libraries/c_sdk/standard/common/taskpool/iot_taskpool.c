@@ -44,6 +44,11 @@
 /* Task pool internal include. */
 #include "private/iot_taskpool_internal.h"
 
+#if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+    /* Atomic include. */
+    #include "iot_atomic.h"
+#endif
+
 /**
  * @brief Enter a critical section by locking a mutex.
  *
@@ -66,6 +71,42 @@
  */
 #define TASKPOOL_JOB_RESCHEDULE_DELAY_MS    ( 10ULL )
 
+/**
+ * @brief Value of #_taskPoolTimerWheel_t.armedTime when the timer is not armed, and
+ * of #_nextTimerWheelTick when the timer wheel is empty.
+ */
+#define TASKPOOL_TIMER_NOT_ARMED            ( UINT64_MAX )
+
+/**
+ * @brief The number of ticks covered by the timer wheel.
+ */
+#define TASKPOOL_TIMER_WHEEL_RANGE          ( 1ULL << ( TASKPOOL_TIMER_WHEEL_LEVELS * TASKPOOL_TIMER_WHEEL_SLOT_BITS ) )
+
+/**
+ * @brief The first timer wheel tick at or after a time in milliseconds.
+ */
+#define TASKPOOL_TIMER_WHEEL_TICK( timeMs ) \
+    ( ( ( timeMs ) + IOT_TASKPOOL_TIMER_WHEEL_TICK_MS - 1ULL ) / IOT_TASKPOOL_TIMER_WHEEL_TICK_MS )
+
+/**
+ * @brief Worker queue index of a worker thread that does not own a queue.
+ */
+#define TASKPOOL_NO_WORKER_QUEUE            ( ( uint32_t ) IOT_TASKPOOL_WORKER_QUEUES )
+
+/**
+ * @brief Update the number of active jobs.
+ *
+ * With work stealing, workers update the number of active jobs without holding
+ * the task pool lock.
+ */
+#if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+    #define TASKPOOL_INCREMENT_ACTIVE_JOBS()    ( void ) Atomic_Increment_u32( &( pTaskPool->activeJobs ) )
+    #define TASKPOOL_DECREMENT_ACTIVE_JOBS()    ( void ) Atomic_Decrement_u32( &( pTaskPool->activeJobs ) )
+#else
+    #define TASKPOOL_INCREMENT_ACTIVE_JOBS()    pTaskPool->activeJobs++
+    #define TASKPOOL_DECREMENT_ACTIVE_JOBS()    pTaskPool->activeJobs--
+#endif
+
 /* ---------------------------------------------------------------------------------- */
 
 /**
@@ -76,7 +117,7 @@
  * the system libraries as well. The system task pool needs to be initialized before any library is used or
  * before any code that posts jobs to the task pool runs.
  */
-_taskPool_t _IotSystemTaskPool = { .dispatchQueue = IOT_DEQUEUE_INITIALIZER };
+_taskPool_t _IotSystemTaskPool = { .dispatchQueue = { .jobs = { IOT_DEQUEUE_INITIALIZER } } };
 
 /* -------------- Convenience functions to create/recycle/destroy jobs -------------- */
 
@@ -125,6 +166,75 @@ static void _recycleJob( _taskPoolCache_t * const pCache,
  */
 static void _destroyJob( _taskPoolJob_t * const pJob );
 
+/* -------------- Convenience functions to handle the queues of each priority class -------------- */
+
+/**
+ * Initializes the job queues and statistics of all priority classes.
+ *
+ * @param[in] pQueue The dispatch queue to initialize.
+ */
+static void _initDispatchQueue( _taskPoolDispatchQueue_t * const pQueue );
+
+/**
+ * Places a job in the queue of its priority class.
+ *
+ * @param[in] pQueue The dispatch queue to place the job in.
+ * @param[in] pJob The job to place.
+ * @param[in] atHead Whether the job should be placed ahead of all other jobs of its class.
+ */
+static void _enqueueJob( _taskPoolDispatchQueue_t * const pQueue,
+                         _taskPoolJob_t * const pJob,
+                         bool atHead );
+
+/**
+ * Dequeues the first job of a priority class.
+ *
+ * @param[in] pQueue The dispatch queue to dequeue the job from.
+ * @param[in] priority The priority class to dequeue from.
+ *
+ * @return The link of the dequeued job, or `NULL` if the class has no job.
+ */
+static IotLink_t * _dequeueJob( _taskPoolDispatchQueue_t * const pQueue,
+                                int32_t priority );
+
+#if IOT_TASKPOOL_ENABLE_WORK_STEALING == 0
+
+/**
+ * Dequeues the first job of the highest priority class that has a job.
+ *
+ * @param[in] pQueue The dispatch queue to dequeue the job from.
+ *
+ * @return The link of the dequeued job, or `NULL` if no class has a job.
+ */
+    static IotLink_t * _dequeueNextJob( _taskPoolDispatchQueue_t * const pQueue );
+#endif
+
+/**
+ * Removes a job from the queue of its priority class.
+ *
+ * @param[in] pQueue The dispatch queue that holds the job.
+ * @param[in] pJob The job to remove.
+ */
+static void _removeJob( _taskPoolDispatchQueue_t * const pQueue,
+                        _taskPoolJob_t * const pJob );
+
+/**
+ * Destroys all jobs in the queues of all priority classes.
+ *
+ * @param[in] pQueue The dispatch queue to clear.
+ */
+static void _destroyQueuedJobs( _taskPoolDispatchQueue_t * const pQueue );
+
+/**
+ * Comparer for jobs with a deadline in the queue of a priority class. Jobs
+ * without a deadline sort after all jobs with a deadline.
+ *
+ * @param[in] pJobLink1 The link to the first job.
+ * @param[in] pJobLink2 The link to the second job.
+ */
+static int32_t _jobDeadlineCompare( const IotLink_t * const pJobLink1,
+                                    const IotLink_t * const pJobLink2 );
+
 /* -------------- The worker thread procedure for a task pool thread -------------- */
 
 /**
@@ -135,25 +245,144 @@ static void _destroyJob( _taskPoolJob_t * const pJob );
  */
 static void _taskPoolWorker( void * pUserContext );
 
+#if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+
+/* -------------- Convenience functions to handle per-worker job queues -------------- */
+
+/**
+ * Claims a worker queue that is not owned by any worker thread.
+ *
+ * @param[in] pTaskPool The task pool of the worker thread.
+ *
+ * @return The index of the claimed queue, or #TASKPOOL_NO_WORKER_QUEUE if
+ * all queues are owned.
+ */
+    static uint32_t _claimWorkerQueue( _taskPool_t * const pTaskPool );
+
+/**
+ * Releases a worker queue when its worker thread exits.
+ *
+ * Jobs left in the queue will be stolen by the other worker threads.
+ *
+ * @param[in] pTaskPool The task pool of the worker thread.
+ * @param[in] workerQueue The index of the queue to release.
+ */
+    static void _releaseWorkerQueue( _taskPool_t * const pTaskPool,
+                                     uint32_t workerQueue );
+
+/**
+ * Places a job in a worker queue and marks it as scheduled, unless the task pool
+ * is shutting down.
+ *
+ * @param[in] pTaskPool The task pool to schedule the job with.
+ * @param[in] pJob The job to schedule.
+ * @param[in] atHead Whether the job should be placed at the head of the queue.
+ *
+ * @return `true` if the job was placed in a queue; `false` if the task pool is
+ * shutting down.
+ */
+    static bool _enqueueWorkerJob( _taskPool_t * const pTaskPool,
+                                   _taskPoolJob_t * const pJob,
+                                   bool atHead );
+
+/**
+ * Schedules a job without taking the task pool lock, if the job is not in any
+ * task pool queue and no worker thread needs to be created for it.
+ *
+ * @param[in] pTaskPool The task pool to schedule the job with.
+ * @param[in] pJob The job to schedule.
+ * @param[in] priority The priority class of the job.
+ * @param[in] deadlineMs The deadline of the job, or 0.
+ *
+ * @return #IOT_TASKPOOL_SUCCESS or #IOT_TASKPOOL_SHUTDOWN_IN_PROGRESS if the
+ * job was handled; #IOT_TASKPOOL_ILLEGAL_OPERATION if it must be scheduled with
+ * the task pool lock held instead.
+ */
+    static IotTaskPoolError_t _scheduleWithoutLock( _taskPool_t * const pTaskPool,
+                                                    _taskPoolJob_t * const pJob,
+                                                    IotTaskPoolPriority_t priority,
+                                                    uint32_t deadlineMs );
+
+/**
+ * Dequeues the next job for a worker thread, first from its own queue and then
+ * from the queues of the other workers.
+ *
+ * @param[in] pTaskPool The task pool of the worker thread.
+ * @param[in] workerQueue The index of the queue owned by the worker thread.
+ * @param[out] pUserCallback Set to the callback of the dequeued job.
+ *
+ * @return The dequeued job, or `NULL` if all queues are empty.
+ */
+    static _taskPoolJob_t * _dequeueWorkerJob( _taskPool_t * const pTaskPool,
+                                               uint32_t workerQueue,
+                                               IotTaskPoolRoutine_t * const pUserCallback );
+
+/**
+ * Removes a scheduled job from its worker queue, unless a worker thread dequeued
+ * it already. Must be called with the task pool lock held.
+ *
+ * @param[in] pTaskPool The task pool of the job.
+ * @param[in] pJob The job to remove.
+ *
+ * @return The status of the job when it was removed.
+ */
+    static IotTaskPoolJobStatus_t _removeWorkerJob( _taskPool_t * const pTaskPool,
+                                                    _taskPoolJob_t * const pJob );
+#endif /* if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1 */
+
 /* -------------- Convenience functions to handle timer events  -------------- */
 
 /**
- * Comparer for the time list.
+ * Initializes the timer wheel of a task pool.
+ *
+ * param[in] pWheel The timer wheel to initialize.
+ */
+static void _initTimerWheel( _taskPoolTimerWheel_t * const pWheel );
+
+/**
+ * Places a timer event in the slot of the timer wheel that covers its expiration time.
+ *
+ * param[in] pWheel The timer wheel to insert the timer event into.
+ * param[in] pTimerEvent The timer event to insert.
+ */
+static void _insertTimerEvent( _taskPoolTimerWheel_t * const pWheel,
+                               _taskPoolTimerEvent_t * const pTimerEvent );
+
+/**
+ * Removes a timer event from the timer wheel.
+ *
+ * param[in] pWheel The timer wheel the timer event is in.
+ * param[in] pTimerEvent The timer event to remove.
+ */
+static void _removeTimerEvent( _taskPoolTimerWheel_t * const pWheel,
+                               _taskPoolTimerEvent_t * const pTimerEvent );
+
+/**
+ * Finds the next tick at which the timer wheel has timer events to dispatch or to
+ * move to a lower level.
+ *
+ * param[in] pWheel The timer wheel to search.
+ *
+ * @return The next tick with work to do, or UINT64_MAX if the timer wheel is empty.
+ */
+static uint64_t _nextTimerWheelTick( const _taskPoolTimerWheel_t * const pWheel );
+
+/**
+ * Advances the timer wheel to the given tick and schedules all deferred jobs that expired.
  *
- * param[in] pTimerEventLink1 The link to the first timer event.
- * param[in] pTimerEventLink1 The link to the first timer event.
+ * param[in] pTaskPool The task pool that owns the timer wheel.
+ * param[in] nowTick The tick to advance the timer wheel to.
  */
-static int32_t _timerEventCompare( const IotLink_t * const pTimerEventLink1,
-                                   const IotLink_t * const pTimerEventLink2 );
+static void _advanceTimerWheel( _taskPool_t * const pTaskPool,
+                                uint64_t nowTick );
 
 /**
- * Reschedules the timer for handling deferred jobs to the next timeout.
+ * Arms the timer for handling deferred jobs for the next tick of the timer wheel with
+ * work to do, unless the timer is armed to fire earlier already.
  *
- * param[in] pTimer The timer to reschedule.
- * param[in] pFirstTimerEvent The timer event that carries the timeout and job information.
+ * param[in] pTaskPool The task pool that owns the timer.
  */
-static void _rescheduleDeferredJobsTimer( IotTimer_t * const pTimer,
-                                          _taskPoolTimerEvent_t * const pFirstTimerEvent );
+static void _rescheduleDeferredJobsTimer( _taskPool_t * const pTaskPool );
 
 /**
  * The task pool timer procedure for scheduling deferred jobs.
@@ -231,14 +460,36 @@ static IotTaskPoolError_t _scheduleInternal( _taskPool_t * const pTaskPool,
                                              uint32_t flags );
 
 /**
- * Matches a deferred job in the timer queue with its timer event wrapper.
+ * Schedules a job in a priority class.
+ *
+ * @param[in] pTaskPool The task pool to schedule the job with.
+ * @param[in] pJob The job to schedule.
+ * @param[in] flags The job flags.
+ * @param[in] priority The priority class of the job.
+ * @param[in] deadlineMs The deadline of the job, or 0.
+ *
+ */
+static IotTaskPoolError_t _scheduleWithPriority( _taskPool_t * const pTaskPool,
+                                                 _taskPoolJob_t * const pJob,
+                                                 uint32_t flags,
+                                                 IotTaskPoolPriority_t priority,
+                                                 uint32_t deadlineMs );
+
+/**
+ * Schedules a deferred job in a priority class.
  *
- * @param[in] pLink A pointer to the timer event link in the timer queue.
- * @param[in] pMatch A pointer to the job to match.
+ * @param[in] pTaskPool The task pool to schedule the job with.
+ * @param[in] pJob The job to schedule.
+ * @param[in] timeMs The time to wait before scheduling the job.
+ * @param[in] priority The priority class of the job.
+ * @param[in] deadlineMs The deadline of the job, or 0.
  *
  */
-static bool _matchJobByPointer( const IotLink_t * const pLink,
-                                void * pMatch );
+static IotTaskPoolError_t _scheduleDeferredWithPriority( _taskPool_t * const pTaskPool,
+                                                         _taskPoolJob_t * const pJob,
+                                                         uint32_t timeMs,
+                                                         IotTaskPoolPriority_t priority,
+                                                         uint32_t deadlineMs );
 
 /**
  * Tries to cancel a job.
@@ -358,72 +609,78 @@ IotTaskPoolError_t IotTaskPool_Destroy( IotTaskPool_t taskPoolHandle )
         /* Record how many active threads in the task pool. */
         activeThreads = pTaskPool->activeThreads;
 
-        /* Destroying a Task pool happens in six (6) stages: First, (1) we clear the job queue and (2) the timer queue.
-         * Then (3) we clear the jobs cache. We will then (4) wait for all worker threads to signal exit,
-         * before (5) setting the exit condition and wake up all active worker threads. Finally (6) destroying
+        /* Destroying a Task pool happens in six (6) stages: First, (1) we set the exit condition and wake up
+         * all active worker threads. Then (2) we clear the job queue and (3) the timer queue, and (4) the
+         * jobs cache. We will then (5) wait for all worker threads to signal exit. Finally (6) destroying
          * all task pool data structures and release the associated memory.
          */
 
-        /* (1) Clear the job queue. */
-        do
-        {
-            pItemLink = NULL;
+        /* (1) Set the exit condition. Worker threads only see it after this lock is released. With work
+         * stealing, jobs may be scheduled without this lock, and setting the exit condition first makes
+         * them fail instead of being left in a worker queue that was cleared already. */
+        _signalShutdown( pTaskPool, activeThreads );
 
-            pItemLink = IotDeQueue_DequeueHead( &pTaskPool->dispatchQueue );
+        /* (2) Clear the job queue. */
+        _destroyQueuedJobs( &pTaskPool->dispatchQueue );
 
-            if( pItemLink != NULL )
+        #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
             {
-                _taskPoolJob_t * pJob = IotLink_Container( _taskPoolJob_t, pItemLink, link );
+                uint32_t i;
 
-                _destroyJob( pJob );
+                for( i = 0; i < IOT_TASKPOOL_WORKER_QUEUES; i++ )
+                {
+                    IotMutex_Lock( &( pTaskPool->workerQueues[ i ].lock ) );
+                    _destroyQueuedJobs( &( pTaskPool->workerQueues[ i ].queue ) );
+                    IotMutex_Unlock( &( pTaskPool->workerQueues[ i ].lock ) );
+                }
             }
-        } while( pItemLink );
+        #endif
 
-        /* (2) Clear the timer queue. */
+        /* (3) Clear the timer queue. */
         {
+            _taskPoolTimerWheel_t * pWheel = &pTaskPool->timerWheel;
             _taskPoolTimerEvent_t * pTimerEvent;
+            uint32_t level, slot;
 
-            /* A deferred job may have fired already. Since deferred jobs will go through the same mutex
+            /* The timer may have fired already. Since the timer thread will go through the same mutex
              * the shutdown sequence is holding at this stage, there is no risk for race conditions. Yet, we
-             * need to let the deferred job to destroy the task pool. */
-
-            pItemLink = IotListDouble_PeekHead( &pTaskPool->timerEventsList );
-
-            if( pItemLink != NULL )
+             * need to let the timer thread to destroy the task pool. */
+            if( pWheel->armedTime <= IotClock_GetTimeMs() )
             {
-                uint64_t now = IotClock_GetTimeMs();
-
-                pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pItemLink, link );
-
-                if( pTimerEvent->expirationTime <= now )
-                {
-                    IotLogDebug( "Shutdown will be deferred to the timer thread" );
+                IotLogDebug( "Shutdown will be deferred to the timer thread" );
 
-                    /* Timer may have fired already! Let the timer thread destroy
-                     * complete the taskpool destruction sequence. */
-                    completeShutdown = false;
-                }
+                /* Timer may have fired already! Let the timer thread destroy
+                 * complete the taskpool destruction sequence. */
+                completeShutdown = false;
+            }
 
-                /* Remove all timers from the timeout list. */
-                for( ; ; )
+            /* Remove all timers from the timer wheel. */
+            for( level = 0; level < TASKPOOL_TIMER_WHEEL_LEVELS; level++ )
+            {
+                for( slot = 0; slot < TASKPOOL_TIMER_WHEEL_SLOTS; slot++ )
                 {
-                    pItemLink = IotListDouble_RemoveHead( &pTaskPool->timerEventsList );
-
-                    if( pItemLink == NULL )
+                    for( ; ; )
                     {
-                        break;
-                    }
+                        pItemLink = IotListDouble_RemoveHead( &pWheel->slots[ level ][ slot ] );
+
+                        if( pItemLink == NULL )
+                        {
+                            break;
+                        }
 
-                    pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pItemLink, link );
+                        pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pItemLink, link );
 
-                    _destroyJob( pTimerEvent->pJob );
+                        _destroyJob( pTimerEvent->pJob );
 
-                    IotTaskPool_FreeTimerEvent( pTimerEvent );
+                        IotTaskPool_FreeTimerEvent( pTimerEvent );
+                    }
                 }
             }
+
+            pWheel->count = 0;
         }
 
-        /* (3) Clear the job cache. */
+        /* (4) Clear the job cache. */
         do
         {
             pItemLink = NULL;
@@ -437,9 +694,6 @@ IotTaskPoolError_t IotTaskPool_Destroy( IotTaskPool_t taskPoolHandle )
                 _destroyJob( pJob );
             }
         } while( pItemLink );
-
-        /* (4) Set the exit condition. */
-        _signalShutdown( pTaskPool, activeThreads );
     }
     TASKPOOL_EXIT_CRITICAL();
 
@@ -696,34 +950,17 @@ IotTaskPoolError_t IotTaskPool_Schedule( IotTaskPool_t taskPoolHandle,
                                          uint32_t flags )
 {
     TASKPOOL_FUNCTION_ENTRY( IOT_TASKPOOL_SUCCESS );
-    _taskPool_t * pTaskPool = NULL;
 
     /* Parameter checking. */
     TASKPOOL_ON_NULL_ARG_GOTO_CLEANUP( taskPoolHandle );
     TASKPOOL_ON_NULL_ARG_GOTO_CLEANUP( pJob );
     TASKPOOL_ON_ARG_ERROR_GOTO_CLEANUP( ( flags != 0UL ) && ( flags != IOT_TASKPOOL_JOB_HIGH_PRIORITY ) );
 
-    pTaskPool = ( _taskPool_t * ) taskPoolHandle;
-
-    TASKPOOL_ENTER_CRITICAL();
-    {
-        /* Bail out early if this task pool is shutting down. */
-        if( _IsShutdownStarted( pTaskPool ) )
-        {
-            status = IOT_TASKPOOL_SHUTDOWN_IN_PROGRESS;
-        }
-        else
-        {
-            status = _trySafeExtraction( pTaskPool, pJob, false );
-        }
-
-        /* If all safety checks completed, proceed. */
-        if( TASKPOOL_SUCCEEDED( status ) )
-        {
-            status = _scheduleInternal( pTaskPool, pJob, flags );
-        }
-    }
-    TASKPOOL_EXIT_CRITICAL();
+    TASKPOOL_SET_AND_GOTO_CLEANUP( _scheduleWithPriority( ( _taskPool_t * ) taskPoolHandle,
+                                                          pJob,
+                                                          flags,
+                                                          IOT_TASKPOOL_PRIORITY_NORMAL,
+                                                          0 ) );
 
     TASKPOOL_NO_FUNCTION_CLEANUP();
 }
@@ -735,79 +972,96 @@ IotTaskPoolError_t IotTaskPool_ScheduleDeferred( IotTaskPool_t taskPoolHandle,
                                                  uint32_t timeMs )
 {
     TASKPOOL_FUNCTION_ENTRY( IOT_TASKPOOL_SUCCESS );
-    _taskPool_t * pTaskPool = NULL;
 
     /* Parameter checking. */
     TASKPOOL_ON_NULL_ARG_GOTO_CLEANUP( taskPoolHandle );
     TASKPOOL_ON_NULL_ARG_GOTO_CLEANUP( pJob );
 
-    pTaskPool = ( _taskPool_t * ) taskPoolHandle;
+    TASKPOOL_SET_AND_GOTO_CLEANUP( _scheduleDeferredWithPriority( ( _taskPool_t * ) taskPoolHandle,
+                                                                  pJob,
+                                                                  timeMs,
+                                                                  IOT_TASKPOOL_PRIORITY_NORMAL,
+                                                                  0 ) );
 
-    if( timeMs == 0UL )
-    {
-        TASKPOOL_SET_AND_GOTO_CLEANUP( IotTaskPool_Schedule( pTaskPool, pJob, 0 ) );
-    }
+    TASKPOOL_NO_FUNCTION_CLEANUP();
+}
 
-    TASKPOOL_ENTER_CRITICAL();
-    {
-        /* Bail out early if this task pool is shutting down. */
-        if( _IsShutdownStarted( pTaskPool ) )
-        {
-            TASKPOOL_EXIT_CRITICAL();
+/*-----------------------------------------------------------*/
 
-            TASKPOOL_SET_AND_GOTO_CLEANUP( IOT_TASKPOOL_SHUTDOWN_IN_PROGRESS );
-        }
+IotTaskPoolError_t IotTaskPool_ScheduleWithPriority( IotTaskPool_t taskPoolHandle,
+                                                     IotTaskPoolJob_t pJob,
+                                                     IotTaskPoolPriority_t priority,
+                                                     uint32_t deadlineMs )
+{
+    TASKPOOL_FUNCTION_ENTRY( IOT_TASKPOOL_SUCCESS );
 
-        /* If all safety checks completed, proceed. */
-        if( TASKPOOL_SUCCEEDED( _trySafeExtraction( pTaskPool, pJob, false ) ) )
-        {
-            IotLink_t * pTimerEventLink;
-            uint64_t now;
+    /* Parameter checking. */
+    TASKPOOL_ON_NULL_ARG_GOTO_CLEANUP( taskPoolHandle );
+    TASKPOOL_ON_NULL_ARG_GOTO_CLEANUP( pJob );
+    TASKPOOL_ON_ARG_ERROR_GOTO_CLEANUP( ( ( int32_t ) priority < 0 ) || ( ( int32_t ) priority >= IOT_TASKPOOL_PRIORITIES ) );
 
-            _taskPoolTimerEvent_t * pTimerEvent = ( _taskPoolTimerEvent_t * ) IotTaskPool_MallocTimerEvent( sizeof( _taskPoolTimerEvent_t ) );
+    TASKPOOL_SET_AND_GOTO_CLEANUP( _scheduleWithPriority( ( _taskPool_t * ) taskPoolHandle,
+                                                          pJob,
+                                                          0,
+                                                          priority,
+                                                          deadlineMs ) );
 
-            if( pTimerEvent == NULL )
-            {
-                TASKPOOL_EXIT_CRITICAL();
+    TASKPOOL_NO_FUNCTION_CLEANUP();
+}
 
-                TASKPOOL_SET_AND_GOTO_CLEANUP( IOT_TASKPOOL_NO_MEMORY );
-            }
+/*-----------------------------------------------------------*/
 
-            memset( pTimerEvent, 0x00, sizeof( _taskPoolTimerEvent_t ) );
+IotTaskPoolError_t IotTaskPool_ScheduleDeferredWithPriority( IotTaskPool_t taskPoolHandle,
+                                                             IotTaskPoolJob_t pJob,
+                                                             uint32_t timeMs,
+                                                             IotTaskPoolPriority_t priority,
+                                                             uint32_t deadlineMs )
+{
+    TASKPOOL_FUNCTION_ENTRY( IOT_TASKPOOL_SUCCESS );
 
-            now = IotClock_GetTimeMs();
+    /* Parameter checking. */
+    TASKPOOL_ON_NULL_ARG_GOTO_CLEANUP( taskPoolHandle );
+    TASKPOOL_ON_NULL_ARG_GOTO_CLEANUP( pJob );
+    TASKPOOL_ON_ARG_ERROR_GOTO_CLEANUP( ( ( int32_t ) priority < 0 ) || ( ( int32_t ) priority >= IOT_TASKPOOL_PRIORITIES ) );
 
-            pTimerEvent->link.pNext = NULL;
-            pTimerEvent->link.pPrevious = NULL;
-            pTimerEvent->expirationTime = now + timeMs;
-            pTimerEvent->pJob = ( _taskPoolJob_t * ) pJob;
+    TASKPOOL_SET_AND_GOTO_CLEANUP( _scheduleDeferredWithPriority( ( _taskPool_t * ) taskPoolHandle,
+                                                                  pJob,
+                                                                  timeMs,
+                                                                  priority,
+                                                                  deadlineMs ) );
+
+    TASKPOOL_NO_FUNCTION_CLEANUP();
+}
 
-            /* Append the timer event to the timer list. */
-            IotListDouble_InsertSorted( &pTaskPool->timerEventsList, &pTimerEvent->link, _timerEventCompare );
+/*-----------------------------------------------------------*/
 
-            /* Update the job status to 'scheduled'. */
-            pJob->status = IOT_TASKPOOL_STATUS_DEFERRED;
+IotTaskPoolError_t IotTaskPool_GetStatus( IotTaskPool_t taskPoolHandle,
+                                          IotTaskPoolJob_t pJob,
+                                          IotTaskPoolJobStatus_t * const pStatus )
+{
+    TASKPOOL_FUNCTION_ENTRY( IOT_TASKPOOL_SUCCESS );
+    _taskPool_t * pTaskPool = NULL;
 
-            /* Peek the first event in the timer event list. There must be at least one,
-             * since we just inserted it. */
-            pTimerEventLink = IotListDouble_PeekHead( &pTaskPool->timerEventsList );
-            IotTaskPool_Assert( pTimerEventLink != NULL );
+    /* Parameter checking. */
+    TASKPOOL_ON_NULL_ARG_GOTO_CLEANUP( taskPoolHandle );
+    TASKPOOL_ON_NULL_ARG_GOTO_CLEANUP( pJob );
+    TASKPOOL_ON_NULL_ARG_GOTO_CLEANUP( pStatus );
 
-            /* If the event we inserted is at the front of the queue, then
-             * we need to reschedule the underlying timer. */
-            if( pTimerEventLink == &pTimerEvent->link )
-            {
-                pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pTimerEventLink, link );
+    pTaskPool = ( _taskPool_t * ) taskPoolHandle;
 
-                _rescheduleDeferredJobsTimer( &pTaskPool->timer, pTimerEvent );
-            }
-        }
-        else
+    *pStatus = IOT_TASKPOOL_STATUS_UNDEFINED;
+
+    TASKPOOL_ENTER_CRITICAL();
+    {
+        /* Bail out early if this task pool is shutting down. */
+        if( _IsShutdownStarted( pTaskPool ) )
         {
             TASKPOOL_EXIT_CRITICAL();
 
-            TASKPOOL_SET_AND_GOTO_CLEANUP( IOT_TASKPOOL_ILLEGAL_OPERATION );
+            TASKPOOL_SET_AND_GOTO_CLEANUP( IOT_TASKPOOL_SHUTDOWN_IN_PROGRESS );
         }
+
+        *pStatus = pJob->status;
     }
     TASKPOOL_EXIT_CRITICAL();
 
@@ -816,22 +1070,18 @@ IotTaskPoolError_t IotTaskPool_ScheduleDeferred( IotTaskPool_t taskPoolHandle,
 
 /*-----------------------------------------------------------*/
 
-IotTaskPoolError_t IotTaskPool_GetStatus( IotTaskPool_t taskPoolHandle,
-                                          IotTaskPoolJob_t pJob,
-                                          IotTaskPoolJobStatus_t * const pStatus )
+IotTaskPoolError_t IotTaskPool_GetStatistics( IotTaskPool_t taskPoolHandle,
+                                              IotTaskPoolStatistics_t * const pStatistics )
 {
     TASKPOOL_FUNCTION_ENTRY( IOT_TASKPOOL_SUCCESS );
     _taskPool_t * pTaskPool = NULL;
 
     /* Parameter checking. */
     TASKPOOL_ON_NULL_ARG_GOTO_CLEANUP( taskPoolHandle );
-    TASKPOOL_ON_NULL_ARG_GOTO_CLEANUP( pJob );
-    TASKPOOL_ON_NULL_ARG_GOTO_CLEANUP( pStatus );
+    TASKPOOL_ON_NULL_ARG_GOTO_CLEANUP( pStatistics );
 
     pTaskPool = ( _taskPool_t * ) taskPoolHandle;
 
-    *pStatus = IOT_TASKPOOL_STATUS_UNDEFINED;
-
     TASKPOOL_ENTER_CRITICAL();
     {
         /* Bail out early if this task pool is shutting down. */
@@ -842,7 +1092,47 @@ IotTaskPoolError_t IotTaskPool_GetStatus( IotTaskPool_t taskPoolHandle,
             TASKPOOL_SET_AND_GOTO_CLEANUP( IOT_TASKPOOL_SHUTDOWN_IN_PROGRESS );
         }
 
-        *pStatus = pJob->status;
+        #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+            {
+                uint32_t i = 0;
+                int32_t priority = 0;
+                IotTaskPoolPriorityStatistics_t * pTotal = NULL;
+                const IotTaskPoolPriorityStatistics_t * pQueueStatistics = NULL;
+
+                memset( pStatistics, 0x00, sizeof( IotTaskPoolStatistics_t ) );
+
+                /* Add up the statistics of all worker queues. */
+                for( i = 0; i < IOT_TASKPOOL_WORKER_QUEUES; i++ )
+                {
+                    IotMutex_Lock( &( pTaskPool->workerQueues[ i ].lock ) );
+
+                    for( priority = 0; priority < IOT_TASKPOOL_PRIORITIES; priority++ )
+                    {
+                        pTotal = &( pStatistics->priorities[ priority ] );
+                        pQueueStatistics = &( pTaskPool->workerQueues[ i ].queue.statistics[ priority ] );
+
+                        pTotal->queueDepth += pQueueStatistics->queueDepth;
+                        pTotal->dispatchedJobs += pQueueStatistics->dispatchedJobs;
+                        pTotal->missedDeadlines += pQueueStatistics->missedDeadlines;
+                        pTotal->totalWaitMs += pQueueStatistics->totalWaitMs;
+
+                        if( pQueueStatistics->maxQueueDepth > pTotal->maxQueueDepth )
+                        {
+                            pTotal->maxQueueDepth = pQueueStatistics->maxQueueDepth;
+                        }
+
+                        if( pQueueStatistics->maxWaitMs > pTotal->maxWaitMs )
+                        {
+                            pTotal->maxWaitMs = pQueueStatistics->maxWaitMs;
+                        }
+                    }
+
+                    IotMutex_Unlock( &( pTaskPool->workerQueues[ i ].lock ) );
+                }
+            }
+        #else
+            memcpy( pStatistics->priorities, pTaskPool->dispatchQueue.statistics, sizeof( pStatistics->priorities ) );
+        #endif
     }
     TASKPOOL_EXIT_CRITICAL();
 
@@ -956,14 +1246,18 @@ static IotTaskPoolError_t _initTaskPoolControlStructures( const IotTaskPoolInfo_
     bool semDispatchInit = false;
     bool timerInit = false;
 
+    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+        uint32_t workerQueuesInit = 0;
+    #endif
+
     /* Zero out all data structures. */
     memset( ( void * ) pTaskPool, 0x00, sizeof( _taskPool_t ) );
 
     /* Initialize a job data structures that require no de-initialization.
      * All other data structures carry a value of 'NULL' before initialization.
      */
-    IotDeQueue_Create( &pTaskPool->dispatchQueue );
-    IotListDouble_Create( &pTaskPool->timerEventsList );
+    _initDispatchQueue( &pTaskPool->dispatchQueue );
+    _initTimerWheel( &pTaskPool->timerWheel );
 
     pTaskPool->minThreads = pInfo->minThreads;
     pTaskPool->maxThreads = pInfo->maxThreads;
@@ -990,6 +1284,19 @@ static IotTaskPoolError_t _initTaskPoolControlStructures( const IotTaskPoolInfo_
                 if( IotClock_TimerCreate( &( pTaskPool->timer ), _timerThread, pTaskPool ) == true )
                 {
                     timerInit = true;
+
+                    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+                        /* Create the worker queues. */
+                        for( ; workerQueuesInit < IOT_TASKPOOL_WORKER_QUEUES; workerQueuesInit++ )
+                        {
+                            _initDispatchQueue( &( pTaskPool->workerQueues[ workerQueuesInit ].queue ) );
+
+                            if( IotMutex_Create( &( pTaskPool->workerQueues[ workerQueuesInit ].lock ), false ) == false )
+                            {
+                                TASKPOOL_SET_AND_GOTO_CLEANUP( IOT_TASKPOOL_NO_MEMORY );
+                            }
+                        }
+                    #endif
                 }
                 else
                 {
@@ -1034,10 +1341,19 @@ static IotTaskPoolError_t _initTaskPoolControlStructures( const IotTaskPoolInfo_
         {
             IotClock_TimerDestroy( &pTaskPool->timer );
         }
-    }
 
-    TASKPOOL_FUNCTION_CLEANUP_END();
-}
+        #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+            while( workerQueuesInit > 0UL )
+            {
+                workerQueuesInit--;
+
+                IotMutex_Destroy( &( pTaskPool->workerQueues[ workerQueuesInit ].lock ) );
+            }
+        #endif
+    }
+
+    TASKPOOL_FUNCTION_CLEANUP_END();
+}
 
 static IotTaskPoolError_t _createTaskPool( const IotTaskPoolInfo_t * const pInfo,
                                            _taskPool_t * const pTaskPool )
@@ -1115,6 +1431,15 @@ static IotTaskPoolError_t _createTaskPool( const IotTaskPoolInfo_t * const pInfo
 
 static void _destroyTaskPool( _taskPool_t * const pTaskPool )
 {
+    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+        uint32_t i;
+
+        for( i = 0; i < IOT_TASKPOOL_WORKER_QUEUES; i++ )
+        {
+            IotMutex_Destroy( &( pTaskPool->workerQueues[ i ].lock ) );
+        }
+    #endif
+
     IotClock_TimerDestroy( &pTaskPool->timer );
     IotSemaphore_Destroy( &pTaskPool->dispatchSignal );
     IotSemaphore_Destroy( &pTaskPool->startStopSignal );
@@ -1133,6 +1458,11 @@ static void _taskPoolWorker( void * pUserContext )
     /* Extract pTaskPool pointer from context. */
     _taskPool_t * pTaskPool = ( _taskPool_t * ) pUserContext;
 
+    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+        /* Claim a job queue for this worker. */
+        uint32_t workerQueue = _claimWorkerQueue( pTaskPool );
+    #endif
+
     /* Signal that this worker completed initialization and it is ready to receive notifications. */
     IotSemaphore_Post( &pTaskPool->startStopSignal );
 
@@ -1142,7 +1472,7 @@ static void _taskPoolWorker( void * pUserContext )
      */
     do
     {
-        bool jobAvailable;
+        bool jobAvailable, checkExit = true;
         IotLink_t * pFirst;
         _taskPoolJob_t * pJob = NULL;
 
@@ -1151,52 +1481,50 @@ static void _taskPoolWorker( void * pUserContext )
          * to its minimum number of threads. */
         jobAvailable = IotSemaphore_TimedWait( &pTaskPool->dispatchSignal, IOT_TASKPOOL_JOB_WAIT_TIMEOUT_MS );
 
-        /* Acquire the lock to check the exit condition, and release the lock if the exit condition is verified,
-         * or before waiting for incoming notifications.
-         */
-        TASKPOOL_ENTER_CRITICAL();
+        #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+            /* A worker that was signaled a job only needs the task pool lock if it may have to exit.
+             * The exit conditions are only read as hints here: they are set before the worker is
+             * signaled, and checked again under the lock if a later wait times out. */
+            checkExit = ( jobAvailable == false ) ||
+                        ( _IsShutdownStarted( pTaskPool ) == true ) ||
+                        ( pTaskPool->activeThreads > pTaskPool->maxThreads );
+        #endif
+
+        if( checkExit == true )
         {
-            /* If the exit condition is verified, update the number of active threads and exit the loop. */
-            if( _IsShutdownStarted( pTaskPool ) )
+            /* Acquire the lock to check the exit condition, and release the lock if the exit condition is verified,
+             * or before waiting for incoming notifications.
+             */
+            TASKPOOL_ENTER_CRITICAL();
             {
-                IotLogDebug( "Worker thread exiting because shutdown condition was set." );
-
-                /* Decrease the number of active threads. */
-                pTaskPool->activeThreads--;
+                /* If the exit condition is verified, update the number of active threads and exit the loop. */
+                if( _IsShutdownStarted( pTaskPool ) )
+                {
+                    IotLogDebug( "Worker thread exiting because shutdown condition was set." );
 
-                TASKPOOL_EXIT_CRITICAL();
+                    /* Decrease the number of active threads. */
+                    pTaskPool->activeThreads--;
 
-                /* Signal that this worker is exiting. */
-                IotSemaphore_Post( &pTaskPool->startStopSignal );
+                    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+                        _releaseWorkerQueue( pTaskPool, workerQueue );
+                    #endif
 
-                /* On shutdown, abandon the OUTER LOOP immediately. */
-                break;
-            }
+                    TASKPOOL_EXIT_CRITICAL();
 
-            /* Check if this thread needs to exit because 'max threads' quota was exceeded.
-             * In that case, let it run once, so we can support the case for scheduling 'high priority'
-             * jobs that causes exceeding the max threads quota for the purpose of executing
-             * the high-priority task. */
-            if( pTaskPool->activeThreads > pTaskPool->maxThreads )
-            {
-                IotLogDebug( "Worker thread will exit because maximum quota was exceeded." );
+                    /* Signal that this worker is exiting. */
+                    IotSemaphore_Post( &pTaskPool->startStopSignal );
 
-                /* Decrease the number of active threads pro-actively. */
-                pTaskPool->activeThreads--;
+                    /* On shutdown, abandon the OUTER LOOP immediately. */
+                    break;
+                }
 
-                /* Mark this thread as dead. */
-                running = false;
-            }
-            /* Check if this thread needs to exit  because the worker woke up after a timeout. */
-            else if( jobAvailable == false )
-            {
-                /* If there was a timeout, shrink back the task pool to the minimum number of threads. */
-                if( pTaskPool->activeThreads > pTaskPool->minThreads )
+                /* Check if this thread needs to exit because 'max threads' quota was exceeded.
+                 * In that case, let it run once, so we can support the case for scheduling 'high priority'
+                 * jobs that causes exceeding the max threads quota for the purpose of executing
+                 * the high-priority task. */
+                if( pTaskPool->activeThreads > pTaskPool->maxThreads )
                 {
-                    /* After waking up from a timeout, the thread will try and pick up a new job.
-                     * But if there is no job available, the thread will exit to ensure that
-                     * the taskpool does not have more than minimum number of active threads. */
-                    IotLogDebug( "Worker will exit because task pool is shrinking." );
+                    IotLogDebug( "Worker thread will exit because maximum quota was exceeded." );
 
                     /* Decrease the number of active threads pro-actively. */
                     pTaskPool->activeThreads--;
@@ -1204,27 +1532,57 @@ static void _taskPoolWorker( void * pUserContext )
                     /* Mark this thread as dead. */
                     running = false;
                 }
-            }
-
-            /* Only look for a job if waiting did not timed out. */
-            if( jobAvailable == true )
-            {
-                /* Dequeue the first job in FIFO order. */
-                pFirst = IotDeQueue_DequeueHead( &pTaskPool->dispatchQueue );
-
-                /* If there is indeed a job, then update status under lock, and release the lock before processing the job. */
-                if( pFirst != NULL )
+                /* Check if this thread needs to exit  because the worker woke up after a timeout. */
+                else if( jobAvailable == false )
                 {
-                    /* Extract the job from its link. */
-                    pJob = IotLink_Container( _taskPoolJob_t, pFirst, link );
+                    /* If there was a timeout, shrink back the task pool to the minimum number of threads. */
+                    if( pTaskPool->activeThreads > pTaskPool->minThreads )
+                    {
+                        /* After waking up from a timeout, the thread will try and pick up a new job.
+                         * But if there is no job available, the thread will exit to ensure that
+                         * the taskpool does not have more than minimum number of active threads. */
+                        IotLogDebug( "Worker will exit because task pool is shrinking." );
 
-                    /* Update status to 'executing'. */
-                    pJob->status = IOT_TASKPOOL_STATUS_COMPLETED;
-                    userCallback = pJob->userCallback;
+                        /* Decrease the number of active threads pro-actively. */
+                        pTaskPool->activeThreads--;
+
+                        /* Mark this thread as dead. */
+                        running = false;
+                    }
                 }
+
+                /* Only look for a job if waiting did not timed out. */
+                #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 0
+                    if( jobAvailable == true )
+                    {
+                        /* Dequeue the first job of the highest priority class. */
+                        pFirst = _dequeueNextJob( &pTaskPool->dispatchQueue );
+
+                        /* If there is indeed a job, then update status under lock, and release the lock before processing the job. */
+                        if( pFirst != NULL )
+                        {
+                            /* Extract the job from its link. */
+                            pJob = IotLink_Container( _taskPoolJob_t, pFirst, link );
+
+                            /* Update status to 'executing'. */
+                            pJob->status = IOT_TASKPOOL_STATUS_COMPLETED;
+                            userCallback = pJob->userCallback;
+                        }
+                    }
+                #endif
             }
+            TASKPOOL_EXIT_CRITICAL();
         }
-        TASKPOOL_EXIT_CRITICAL();
+
+        #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+            /* Worker queues are not protected by the task pool lock. */
+            ( void ) pFirst;
+
+            if( jobAvailable == true )
+            {
+                pJob = _dequeueWorkerJob( pTaskPool, workerQueue, &userCallback );
+            }
+        #endif
 
         /* INNER LOOP: it controls the execution of jobs: the exit condition is the lack of a job to execute. */
         while( pJob != NULL )
@@ -1250,17 +1608,24 @@ static void _taskPoolWorker( void * pUserContext )
                 }
             }
 
+            #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+                /* Update the number of busy threads and look for the next job without
+                 * taking the task pool lock. */
+                TASKPOOL_DECREMENT_ACTIVE_JOBS();
+
+                pJob = _dequeueWorkerJob( pTaskPool, workerQueue, &userCallback );
+            #else
             /* Acquire the lock before updating the job status. */
             TASKPOOL_ENTER_CRITICAL();
             {
                 /* Update the number of busy threads, so new requests can be served by creating new threads, up to maxThreads. */
-                pTaskPool->activeJobs--;
+                TASKPOOL_DECREMENT_ACTIVE_JOBS();
 
                 /* Try and dequeue the next job in the dispatch queue. */
                 IotLink_t * pItem = NULL;
 
                 /* Dequeue the next job from the dispatch queue. */
-                pItem = IotDeQueue_DequeueHead( &pTaskPool->dispatchQueue );
+                pItem = _dequeueNextJob( &pTaskPool->dispatchQueue );
 
                 /* If there is no job left in the dispatch queue, update the worker status and leave. */
                 if( pItem == NULL )
@@ -1280,10 +1645,409 @@ static void _taskPoolWorker( void * pUserContext )
                 pJob->status = IOT_TASKPOOL_STATUS_COMPLETED;
             }
             TASKPOOL_EXIT_CRITICAL();
+            #endif /* if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1 */
         }
     } while( running == true );
+
+    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+        /* Give up the job queue of a worker that exits without a shutdown. */
+        if( running == false )
+        {
+            _releaseWorkerQueue( pTaskPool, workerQueue );
+        }
+    #endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+static void _initDispatchQueue( _taskPoolDispatchQueue_t * const pQueue )
+{
+    int32_t priority = 0;
+
+    for( priority = 0; priority < IOT_TASKPOOL_PRIORITIES; priority++ )
+    {
+        IotDeQueue_Create( &( pQueue->jobs[ priority ] ) );
+    }
+
+    memset( pQueue->statistics, 0x00, sizeof( pQueue->statistics ) );
+}
+
+/*-----------------------------------------------------------*/
+
+static void _enqueueJob( _taskPoolDispatchQueue_t * const pQueue,
+                         _taskPoolJob_t * const pJob,
+                         bool atHead )
+{
+    IotTaskPoolPriorityStatistics_t * pStatistics = &( pQueue->statistics[ pJob->priority ] );
+
+    /* Record when the job became ready, to measure how long it waits. */
+    pJob->readyTime = IotClock_GetTimeMs();
+
+    if( atHead == true )
+    {
+        IotDeQueue_EnqueueHead( &( pQueue->jobs[ pJob->priority ] ), &pJob->link );
+    }
+    /* Jobs with a deadline are sorted by deadline, ahead of jobs without one. */
+    else if( pJob->deadlineMs != 0UL )
+    {
+        IotListDouble_InsertSorted( &( pQueue->jobs[ pJob->priority ] ), &pJob->link, _jobDeadlineCompare );
+    }
+    else
+    {
+        IotDeQueue_EnqueueTail( &( pQueue->jobs[ pJob->priority ] ), &pJob->link );
+    }
+
+    pStatistics->queueDepth++;
+
+    if( pStatistics->queueDepth > pStatistics->maxQueueDepth )
+    {
+        pStatistics->maxQueueDepth = pStatistics->queueDepth;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static IotLink_t * _dequeueJob( _taskPoolDispatchQueue_t * const pQueue,
+                                int32_t priority )
+{
+    IotTaskPoolPriorityStatistics_t * pStatistics = &( pQueue->statistics[ priority ] );
+    IotLink_t * pItem = IotDeQueue_DequeueHead( &( pQueue->jobs[ priority ] ) );
+    _taskPoolJob_t * pJob = NULL;
+    uint64_t waitMs = 0;
+
+    if( pItem != NULL )
+    {
+        pJob = IotLink_Container( _taskPoolJob_t, pItem, link );
+        waitMs = IotClock_GetTimeMs() - pJob->readyTime;
+
+        IotTaskPool_Assert( pStatistics->queueDepth > 0 );
+
+        pStatistics->queueDepth--;
+        pStatistics->dispatchedJobs++;
+        pStatistics->totalWaitMs += waitMs;
+
+        if( waitMs > pStatistics->maxWaitMs )
+        {
+            pStatistics->maxWaitMs = ( uint32_t ) waitMs;
+        }
+
+        if( ( pJob->deadlineMs != 0UL ) && ( waitMs > pJob->deadlineMs ) )
+        {
+            IotLogDebug( "Job %p missed its deadline by %lu ms.",
+                         pJob,
+                         ( unsigned long ) ( waitMs - pJob->deadlineMs ) );
+
+            pStatistics->missedDeadlines++;
+        }
+    }
+
+    return pItem;
+}
+
+/*-----------------------------------------------------------*/
+
+#if IOT_TASKPOOL_ENABLE_WORK_STEALING == 0
+    static IotLink_t * _dequeueNextJob( _taskPoolDispatchQueue_t * const pQueue )
+    {
+        int32_t priority = 0;
+        IotLink_t * pItem = NULL;
+
+        for( priority = IOT_TASKPOOL_PRIORITIES - 1; ( priority >= 0 ) && ( pItem == NULL ); priority-- )
+        {
+            pItem = _dequeueJob( pQueue, priority );
+        }
+
+        return pItem;
+    }
+#endif
+
+/*-----------------------------------------------------------*/
+
+static void _removeJob( _taskPoolDispatchQueue_t * const pQueue,
+                        _taskPoolJob_t * const pJob )
+{
+    IotTaskPool_Assert( pQueue->statistics[ pJob->priority ].queueDepth > 0 );
+
+    IotDeQueue_Remove( &pJob->link );
+
+    pQueue->statistics[ pJob->priority ].queueDepth--;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _destroyQueuedJobs( _taskPoolDispatchQueue_t * const pQueue )
+{
+    int32_t priority = 0;
+    IotLink_t * pItemLink = NULL;
+
+    for( priority = 0; priority < IOT_TASKPOOL_PRIORITIES; priority++ )
+    {
+        do
+        {
+            pItemLink = IotDeQueue_DequeueHead( &( pQueue->jobs[ priority ] ) );
+
+            if( pItemLink != NULL )
+            {
+                _destroyJob( IotLink_Container( _taskPoolJob_t, pItemLink, link ) );
+            }
+        } while( pItemLink );
+
+        pQueue->statistics[ priority ].queueDepth = 0;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t _jobDeadlineCompare( const IotLink_t * const pJobLink1,
+                                    const IotLink_t * const pJobLink2 )
+{
+    const _taskPoolJob_t * const pJob1 = IotLink_Container( _taskPoolJob_t, pJobLink1, link );
+    const _taskPoolJob_t * const pJob2 = IotLink_Container( _taskPoolJob_t, pJobLink2, link );
+
+    /* Only jobs with a deadline are inserted in sorted order. */
+    IotTaskPool_Assert( pJob1->deadlineMs != 0UL );
+
+    if( pJob2->deadlineMs == 0UL )
+    {
+        return -1;
+    }
+
+    if( ( pJob1->readyTime + pJob1->deadlineMs ) < ( pJob2->readyTime + pJob2->deadlineMs ) )
+    {
+        return -1;
+    }
+
+    return 1;
 }
 
+#if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+
+/* ---------------------------------------------------------------------------------------------- */
+
+    static uint32_t _claimWorkerQueue( _taskPool_t * const pTaskPool )
+    {
+        uint32_t i = 0, workerQueue = TASKPOOL_NO_WORKER_QUEUE;
+
+        /* The task pool lock may be held by the thread creating this worker, so
+         * queue ownership is protected by the lock of each queue. */
+        for( i = 0; ( i < IOT_TASKPOOL_WORKER_QUEUES ) && ( workerQueue == TASKPOOL_NO_WORKER_QUEUE ); i++ )
+        {
+            IotMutex_Lock( &( pTaskPool->workerQueues[ i ].lock ) );
+
+            if( pTaskPool->workerQueues[ i ].owned == false )
+            {
+                pTaskPool->workerQueues[ i ].owned = true;
+                workerQueue = i;
+            }
+
+            IotMutex_Unlock( &( pTaskPool->workerQueues[ i ].lock ) );
+        }
+
+        if( workerQueue == TASKPOOL_NO_WORKER_QUEUE )
+        {
+            IotLogDebug( "All worker queues are owned. New worker will only steal jobs." );
+        }
+
+        return workerQueue;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void _releaseWorkerQueue( _taskPool_t * const pTaskPool,
+                                     uint32_t workerQueue )
+    {
+        if( workerQueue != TASKPOOL_NO_WORKER_QUEUE )
+        {
+            IotMutex_Lock( &( pTaskPool->workerQueues[ workerQueue ].lock ) );
+            pTaskPool->workerQueues[ workerQueue ].owned = false;
+            IotMutex_Unlock( &( pTaskPool->workerQueues[ workerQueue ].lock ) );
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+    static bool _enqueueWorkerJob( _taskPool_t * const pTaskPool,
+                                   _taskPoolJob_t * const pJob,
+                                   bool atHead )
+    {
+        bool enqueued = false;
+        uint32_t i = 0, workerQueue = Atomic_Increment_u32( &( pTaskPool->nextWorkerQueue ) ) % IOT_TASKPOOL_WORKER_QUEUES;
+        _taskPoolWorkerQueue_t * pQueue = NULL;
+
+        /* Pick the next queue with an owner in round-robin order. Ownership is
+         * only a hint here: a job in a queue without an owner is stolen by the
+         * other workers. */
+        for( i = 0; i < IOT_TASKPOOL_WORKER_QUEUES; i++ )
+        {
+            if( pTaskPool->workerQueues[ ( workerQueue + i ) % IOT_TASKPOOL_WORKER_QUEUES ].owned == true )
+            {
+                workerQueue = ( workerQueue + i ) % IOT_TASKPOOL_WORKER_QUEUES;
+
+                break;
+            }
+        }
+
+        pQueue = &( pTaskPool->workerQueues[ workerQueue ] );
+
+        IotMutex_Lock( &( pQueue->lock ) );
+        {
+            /* The task pool sets the exit condition before it clears the worker
+             * queues, each under the lock of the queue. So a job that is placed
+             * in a queue here is either cleared or executed. */
+            if( _IsShutdownStarted( pTaskPool ) == false )
+            {
+                pJob->status = IOT_TASKPOOL_STATUS_SCHEDULED;
+                pJob->workerQueue = workerQueue;
+
+                if( atHead == true )
+                {
+                    IotLogDebug( "High priority job: placing job at the head of worker queue %lu.",
+                                 ( unsigned long ) workerQueue );
+                }
+
+                _enqueueJob( &( pQueue->queue ), pJob, atHead );
+                enqueued = true;
+            }
+        }
+        IotMutex_Unlock( &( pQueue->lock ) );
+
+        return enqueued;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static IotTaskPoolError_t _scheduleWithoutLock( _taskPool_t * const pTaskPool,
+                                                    _taskPoolJob_t * const pJob,
+                                                    IotTaskPoolPriority_t priority,
+                                                    uint32_t deadlineMs )
+    {
+        IotTaskPoolError_t status = IOT_TASKPOOL_ILLEGAL_OPERATION;
+        IotTaskPoolJobStatus_t currentStatus = pJob->status;
+
+        /* A job that is scheduled, deferred or in the jobs cache must be taken
+         * out of its queue under the task pool lock. A job that is ready or
+         * canceled is only accessed by the caller. */
+        if( ( ( currentStatus == IOT_TASKPOOL_STATUS_READY ) ||
+              ( currentStatus == IOT_TASKPOOL_STATUS_CANCELED ) ) &&
+            ( IotLink_IsLinked( &pJob->link ) == false ) )
+        {
+            /* Growing the task pool needs the task pool lock. The number of
+             * threads is only read as a hint here: if a thread exits after this
+             * read, the job is executed by one of the remaining threads. */
+            if( ( pTaskPool->activeThreads > pTaskPool->activeJobs ) ||
+                ( pTaskPool->activeThreads >= pTaskPool->maxThreads ) )
+            {
+                pJob->priority = priority;
+                pJob->deadlineMs = deadlineMs;
+
+                TASKPOOL_INCREMENT_ACTIVE_JOBS();
+
+                if( _enqueueWorkerJob( pTaskPool, pJob, false ) == true )
+                {
+                    IotSemaphore_Post( &pTaskPool->dispatchSignal );
+
+                    status = IOT_TASKPOOL_SUCCESS;
+                }
+                else
+                {
+                    TASKPOOL_DECREMENT_ACTIVE_JOBS();
+
+                    status = IOT_TASKPOOL_SHUTDOWN_IN_PROGRESS;
+                }
+            }
+        }
+
+        return status;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static _taskPoolJob_t * _dequeueWorkerJob( _taskPool_t * const pTaskPool,
+                                               uint32_t workerQueue,
+                                               IotTaskPoolRoutine_t * const pUserCallback )
+    {
+        uint32_t i = 0, queueIndex = 0;
+        int32_t priority = 0;
+        IotLink_t * pItem = NULL;
+        _taskPoolJob_t * pJob = NULL;
+        _taskPoolWorkerQueue_t * pQueue = NULL;
+
+        /* A worker without a queue starts stealing from the first queue. */
+        if( workerQueue == TASKPOOL_NO_WORKER_QUEUE )
+        {
+            workerQueue = 0;
+        }
+
+        /* Drain higher priority classes first. In each class, look in the queue
+         * of this worker first, then steal from the others. */
+        for( priority = IOT_TASKPOOL_PRIORITIES - 1; ( priority >= 0 ) && ( pJob == NULL ); priority-- )
+        {
+            for( i = 0; ( i < IOT_TASKPOOL_WORKER_QUEUES ) && ( pJob == NULL ); i++ )
+            {
+                queueIndex = ( workerQueue + i ) % IOT_TASKPOOL_WORKER_QUEUES;
+                pQueue = &( pTaskPool->workerQueues[ queueIndex ] );
+
+                /* Skip empty classes without taking the queue lock. Like queue
+                 * ownership, the depth is only a hint here; it is checked again
+                 * under the lock. A job enqueued after this read is found by the
+                 * worker that takes its dispatch signal. This keeps a dequeue to
+                 * one lock in the common case, instead of one per class and
+                 * queue. */
+                if( pQueue->queue.statistics[ priority ].queueDepth == 0UL )
+                {
+                    continue;
+                }
+
+                IotMutex_Lock( &( pQueue->lock ) );
+                {
+                    /* Jobs are always taken from the head, so that jobs in the same
+                     * queue execute in order. */
+                    pItem = _dequeueJob( &( pQueue->queue ), priority );
+
+                    if( pItem != NULL )
+                    {
+                        pJob = IotLink_Container( _taskPoolJob_t, pItem, link );
+
+                        /* Update status to 'executing' while the job is still protected
+                         * by the queue lock, so it cannot be canceled from now on. */
+                        pJob->status = IOT_TASKPOOL_STATUS_COMPLETED;
+                        *pUserCallback = pJob->userCallback;
+                    }
+                }
+                IotMutex_Unlock( &( pQueue->lock ) );
+            }
+        }
+
+        return pJob;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static IotTaskPoolJobStatus_t _removeWorkerJob( _taskPool_t * const pTaskPool,
+                                                    _taskPoolJob_t * const pJob )
+    {
+        IotTaskPoolJobStatus_t currentStatus = IOT_TASKPOOL_STATUS_UNDEFINED;
+        _taskPoolWorkerQueue_t * pQueue = &( pTaskPool->workerQueues[ pJob->workerQueue ] );
+
+        IotMutex_Lock( &( pQueue->lock ) );
+        {
+            currentStatus = pJob->status;
+
+            /* A job that is still scheduled is in its worker queue. Otherwise, a
+             * worker dequeued the job and set its status to 'completed'. */
+            if( currentStatus == IOT_TASKPOOL_STATUS_SCHEDULED )
+            {
+                IotTaskPool_Assert( IotLink_IsLinked( &pJob->link ) );
+
+                _removeJob( &( pQueue->queue ), pJob );
+            }
+        }
+        IotMutex_Unlock( &( pQueue->lock ) );
+
+        return currentStatus;
+    }
+#endif /* if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1 */
+
 /* ---------------------------------------------------------------------------------------------- */
 
 static void _initJobsCache( _taskPoolCache_t * const pCache )
@@ -1304,6 +2068,10 @@ static void _initializeJob( _taskPoolJob_t * const pJob,
     pJob->link.pPrevious = NULL;
     pJob->userCallback = userCallback;
     pJob->pUserContext = pUserContext;
+    pJob->priority = IOT_TASKPOOL_PRIORITY_NORMAL;
+    pJob->deadlineMs = 0;
+    pJob->readyTime = 0;
+    pJob->pTimerEvent = NULL;
 
     if( isStatic )
     {
@@ -1439,7 +2207,7 @@ static IotTaskPoolError_t _scheduleInternal( _taskPool_t * const pTaskPool,
     pJob->status = IOT_TASKPOOL_STATUS_SCHEDULED;
 
     /* Update the number of active jobs optimistically, so new requests can be served by creating new threads. */
-    pTaskPool->activeJobs++;
+    TASKPOOL_INCREMENT_ACTIVE_JOBS();
 
     /* If all threads are busy, try and create a new one. Failing to create a new thread
      * only has performance implications on correctly executing the scheduled job.
@@ -1500,16 +2268,17 @@ static IotTaskPoolError_t _scheduleInternal( _taskPool_t * const pTaskPool,
     {
         /* Append the job to the dispatch queue.
          * Put the job at the front, if it is a high priority job. */
-        if( mustGrow == true )
-        {
-            IotLogDebug( "High priority job: placing job at the head of the queue." );
+        #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+            /* The caller checked the exit condition with the task pool lock held. */
+            ( void ) _enqueueWorkerJob( pTaskPool, pJob, mustGrow );
+        #else
+            if( mustGrow == true )
+            {
+                IotLogDebug( "High priority job: placing job at the head of the queue." );
+            }
 
-            IotDeQueue_EnqueueHead( &pTaskPool->dispatchQueue, &pJob->link );
-        }
-        else
-        {
-            IotDeQueue_EnqueueTail( &pTaskPool->dispatchQueue, &pJob->link );
-        }
+            _enqueueJob( &pTaskPool->dispatchQueue, pJob, mustGrow );
+        #endif
 
         /* Signal a worker to pick up the job. */
         IotSemaphore_Post( &pTaskPool->dispatchSignal );
@@ -1521,7 +2290,7 @@ static IotTaskPoolError_t _scheduleInternal( _taskPool_t * const pTaskPool,
         IotTaskPool_Assert( mustGrow == true );
 
         /* Revert updating the number of active jobs. */
-        pTaskPool->activeJobs--;
+        TASKPOOL_DECREMENT_ACTIVE_JOBS();
     }
 
     TASKPOOL_FUNCTION_CLEANUP_END();
@@ -1529,19 +2298,133 @@ static IotTaskPoolError_t _scheduleInternal( _taskPool_t * const pTaskPool,
 
 /*-----------------------------------------------------------*/
 
-static bool _matchJobByPointer( const IotLink_t * const pLink,
-                                void * pMatch )
+static IotTaskPoolError_t _scheduleWithPriority( _taskPool_t * const pTaskPool,
+                                                 _taskPoolJob_t * const pJob,
+                                                 uint32_t flags,
+                                                 IotTaskPoolPriority_t priority,
+                                                 uint32_t deadlineMs )
 {
-    const _taskPoolJob_t * const pJob = ( _taskPoolJob_t * ) pMatch;
+    TASKPOOL_FUNCTION_ENTRY( IOT_TASKPOOL_SUCCESS );
 
-    const _taskPoolTimerEvent_t * const pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pLink, link );
+    bool scheduled = false;
 
-    if( pJob == pTimerEvent->pJob )
+    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+        /* Most jobs can be placed in a worker queue without the task pool lock. */
+        if( ( flags & IOT_TASKPOOL_JOB_HIGH_PRIORITY ) == 0UL )
+        {
+            status = _scheduleWithoutLock( pTaskPool, pJob, priority, deadlineMs );
+            scheduled = ( status != IOT_TASKPOOL_ILLEGAL_OPERATION );
+        }
+    #endif
+
+    if( scheduled == false )
     {
-        return true;
+        TASKPOOL_ENTER_CRITICAL();
+        {
+            /* Bail out early if this task pool is shutting down. */
+            if( _IsShutdownStarted( pTaskPool ) )
+            {
+                status = IOT_TASKPOOL_SHUTDOWN_IN_PROGRESS;
+            }
+            else
+            {
+                status = _trySafeExtraction( pTaskPool, pJob, false );
+            }
+
+            /* If all safety checks completed, proceed. */
+            if( TASKPOOL_SUCCEEDED( status ) )
+            {
+                pJob->priority = priority;
+                pJob->deadlineMs = deadlineMs;
+
+                status = _scheduleInternal( pTaskPool, pJob, flags );
+            }
+        }
+        TASKPOOL_EXIT_CRITICAL();
     }
 
-    return false;
+    TASKPOOL_NO_FUNCTION_CLEANUP_NOLABEL();
+}
+
+/*-----------------------------------------------------------*/
+
+static IotTaskPoolError_t _scheduleDeferredWithPriority( _taskPool_t * const pTaskPool,
+                                                         _taskPoolJob_t * const pJob,
+                                                         uint32_t timeMs,
+                                                         IotTaskPoolPriority_t priority,
+                                                         uint32_t deadlineMs )
+{
+    TASKPOOL_FUNCTION_ENTRY( IOT_TASKPOOL_SUCCESS );
+
+    if( timeMs == 0UL )
+    {
+        TASKPOOL_SET_AND_GOTO_CLEANUP( _scheduleWithPriority( pTaskPool, pJob, 0, priority, deadlineMs ) );
+    }
+
+    TASKPOOL_ENTER_CRITICAL();
+    {
+        /* Bail out early if this task pool is shutting down. */
+        if( _IsShutdownStarted( pTaskPool ) )
+        {
+            TASKPOOL_EXIT_CRITICAL();
+
+            TASKPOOL_SET_AND_GOTO_CLEANUP( IOT_TASKPOOL_SHUTDOWN_IN_PROGRESS );
+        }
+
+        /* If all safety checks completed, proceed. */
+        if( TASKPOOL_SUCCEEDED( _trySafeExtraction( pTaskPool, pJob, false ) ) )
+        {
+            _taskPoolTimerWheel_t * pWheel = &pTaskPool->timerWheel;
+            uint64_t now;
+
+            _taskPoolTimerEvent_t * pTimerEvent = ( _taskPoolTimerEvent_t * ) IotTaskPool_MallocTimerEvent( sizeof( _taskPoolTimerEvent_t ) );
+
+            if( pTimerEvent == NULL )
+            {
+                TASKPOOL_EXIT_CRITICAL();
+
+                TASKPOOL_SET_AND_GOTO_CLEANUP( IOT_TASKPOOL_NO_MEMORY );
+            }
+
+            memset( pTimerEvent, 0x00, sizeof( _taskPoolTimerEvent_t ) );
+
+            now = IotClock_GetTimeMs();
+
+            pTimerEvent->link.pNext = NULL;
+            pTimerEvent->link.pPrevious = NULL;
+            pTimerEvent->expirationTime = now + timeMs;
+            pTimerEvent->pJob = ( _taskPoolJob_t * ) pJob;
+
+            /* An empty timer wheel is not advanced by the timer, so bring it to the
+             * current time before placing the timer event relative to it. */
+            if( pWheel->count == 0 )
+            {
+                pWheel->currentTick = now / IOT_TASKPOOL_TIMER_WHEEL_TICK_MS;
+            }
+
+            /* Add the timer event to the timer wheel. */
+            _insertTimerEvent( pWheel, pTimerEvent );
+
+            /* Update the job status to 'scheduled'. The job keeps its priority class
+             * until the timer places it in the dispatch queue. */
+            pJob->status = IOT_TASKPOOL_STATUS_DEFERRED;
+            pJob->priority = priority;
+            pJob->deadlineMs = deadlineMs;
+            pJob->pTimerEvent = pTimerEvent;
+
+            /* Bring the timer forward if the new event is due before the timer fires. */
+            _rescheduleDeferredJobsTimer( pTaskPool );
+        }
+        else
+        {
+            TASKPOOL_EXIT_CRITICAL();
+
+            TASKPOOL_SET_AND_GOTO_CLEANUP( IOT_TASKPOOL_ILLEGAL_OPERATION );
+        }
+    }
+    TASKPOOL_EXIT_CRITICAL();
+
+    TASKPOOL_NO_FUNCTION_CLEANUP();
 }
 
 /*-----------------------------------------------------------*/
@@ -1558,6 +2441,15 @@ static IotTaskPoolError_t _tryCancelInternal( _taskPool_t * const pTaskPool,
 
     IotTaskPoolJobStatus_t currentStatus = pJob->status;
 
+    #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+        /* Workers dequeue jobs without holding the task pool lock, so a scheduled
+         * job must be taken out of its worker queue before it can be canceled. */
+        if( currentStatus == IOT_TASKPOOL_STATUS_SCHEDULED )
+        {
+            currentStatus = _removeWorkerJob( pTaskPool, pJob );
+        }
+    #endif
+
     switch( currentStatus )
     {
         case IOT_TASKPOOL_STATUS_READY:
@@ -1597,46 +2489,34 @@ static IotTaskPoolError_t _tryCancelInternal( _taskPool_t * const pTaskPool,
          * queue and signal any waiting threads. */
         if( currentStatus == IOT_TASKPOOL_STATUS_SCHEDULED )
         {
-            /* A scheduled work items must be in the dispatch queue. */
-            IotTaskPool_Assert( IotLink_IsLinked( &pJob->link ) );
+            #if IOT_TASKPOOL_ENABLE_WORK_STEALING == 1
+                /* The job was removed from its worker queue already. */
+                IotTaskPool_Assert( IotLink_IsLinked( &pJob->link ) == false );
+            #else
+                /* A scheduled work items must be in the dispatch queue. */
+                IotTaskPool_Assert( IotLink_IsLinked( &pJob->link ) );
 
-            IotDeQueue_Remove( &pJob->link );
+                _removeJob( &pTaskPool->dispatchQueue, pJob );
+            #endif
         }
 
         /* If the job current status is 'deferred' then the job has to be pending
          * in the timeouts queue. */
         else if( currentStatus == IOT_TASKPOOL_STATUS_DEFERRED )
         {
-            /* Find the timer event associated with the current job. There MUST be one, hence assert if not. */
-            IotLink_t * pTimerEventLink = IotListDouble_FindFirstMatch( &pTaskPool->timerEventsList, NULL, _matchJobByPointer, pJob );
-            IotTaskPool_Assert( pTimerEventLink != NULL );
-
-            if( pTimerEventLink != NULL )
-            {
-                bool shouldReschedule = false;
-
-                /* If the job being cancelled was at the head of the timeouts queue, then we need to reschedule the timer
-                 * with the next job timeout */
-                IotLink_t * pHeadLink = IotListDouble_PeekHead( &pTaskPool->timerEventsList );
-
-                if( pHeadLink == pTimerEventLink )
-                {
-                    shouldReschedule = true;
-                }
+            _taskPoolTimerEvent_t * pTimerEvent = pJob->pTimerEvent;
 
-                /* Remove the timer event associated with the canceled job and free the associated memory. */
-                IotListDouble_Remove( pTimerEventLink );
-                IotTaskPool_FreeTimerEvent( IotLink_Container( _taskPoolTimerEvent_t, pTimerEventLink, link ) );
+            /* A deferred job MUST have a timer event, hence assert if not. */
+            IotTaskPool_Assert( pTimerEvent != NULL );
 
-                if( shouldReschedule )
-                {
-                    IotLink_t * pNextTimerEventLink = IotListDouble_PeekHead( &pTaskPool->timerEventsList );
+            if( pTimerEvent != NULL )
+            {
+                /* Remove the timer event associated with the canceled job and free the associated memory.
+                 * The timer is left armed; if it fires with nothing to do, it is simply re-armed. */
+                _removeTimerEvent( &pTaskPool->timerWheel, pTimerEvent );
+                IotTaskPool_FreeTimerEvent( pTimerEvent );
 
-                    if( pNextTimerEventLink != NULL )
-                    {
-                        _rescheduleDeferredJobsTimer( &pTaskPool->timer, IotLink_Container( _taskPoolTimerEvent_t, pNextTimerEventLink, link ) );
-                    }
-                }
+                pJob->pTimerEvent = NULL;
             }
         }
         else
@@ -1706,52 +2586,212 @@ static IotTaskPoolError_t _trySafeExtraction( _taskPool_t * const pTaskPool,
 
 /*-----------------------------------------------------------*/
 
-static int32_t _timerEventCompare( const IotLink_t * const pTimerEventLink1,
-                                   const IotLink_t * const pTimerEventLink2 )
+static void _initTimerWheel( _taskPoolTimerWheel_t * const pWheel )
 {
-    const _taskPoolTimerEvent_t * const pTimerEvent1 = IotLink_Container( _taskPoolTimerEvent_t,
-                                                                          pTimerEventLink1,
-                                                                          link );
-    const _taskPoolTimerEvent_t * const pTimerEvent2 = IotLink_Container( _taskPoolTimerEvent_t,
-                                                                          pTimerEventLink2,
-                                                                          link );
+    uint32_t level, slot;
 
-    if( pTimerEvent1->expirationTime < pTimerEvent2->expirationTime )
+    for( level = 0; level < TASKPOOL_TIMER_WHEEL_LEVELS; level++ )
     {
-        return -1;
+        for( slot = 0; slot < TASKPOOL_TIMER_WHEEL_SLOTS; slot++ )
+        {
+            IotListDouble_Create( &( pWheel->slots[ level ][ slot ] ) );
+        }
+    }
+
+    pWheel->currentTick = 0;
+    pWheel->armedTime = TASKPOOL_TIMER_NOT_ARMED;
+    pWheel->count = 0;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _insertTimerEvent( _taskPoolTimerWheel_t * const pWheel,
+                               _taskPoolTimerEvent_t * const pTimerEvent )
+{
+    uint32_t level = 0;
+    uint64_t tick = TASKPOOL_TIMER_WHEEL_TICK( pTimerEvent->expirationTime );
+
+    /* An event that is due already goes in the slot of the current tick. An event beyond
+     * the range of the timer wheel goes in the last slot within range, and is placed again
+     * when the timer wheel reaches that slot. */
+    if( tick < pWheel->currentTick )
+    {
+        tick = pWheel->currentTick;
+    }
+    else if( ( tick - pWheel->currentTick ) >= TASKPOOL_TIMER_WHEEL_RANGE )
+    {
+        tick = pWheel->currentTick + TASKPOOL_TIMER_WHEEL_RANGE - 1ULL;
+    }
+    else
+    {
+        /* Nothing to do. */
     }
 
-    if( pTimerEvent1->expirationTime > pTimerEvent2->expirationTime )
+    /* Level n holds the events between 2^(n * bits) and 2^((n + 1) * bits) ticks away. */
+    while( ( tick - pWheel->currentTick ) >= ( 1ULL << ( ( level + 1U ) * TASKPOOL_TIMER_WHEEL_SLOT_BITS ) ) )
     {
-        return 1;
+        level++;
     }
 
-    return 0;
+    IotListDouble_InsertTail( &( pWheel->slots[ level ][ ( tick >> ( level * TASKPOOL_TIMER_WHEEL_SLOT_BITS ) ) & ( TASKPOOL_TIMER_WHEEL_SLOTS - 1U ) ] ),
+                              &( pTimerEvent->link ) );
+
+    pWheel->count++;
 }
 
 /*-----------------------------------------------------------*/
 
-static void _rescheduleDeferredJobsTimer( IotTimer_t * const pTimer,
-                                          _taskPoolTimerEvent_t * const pFirstTimerEvent )
+static void _removeTimerEvent( _taskPoolTimerWheel_t * const pWheel,
+                               _taskPoolTimerEvent_t * const pTimerEvent )
 {
-    uint64_t delta = 0;
-    uint64_t now = IotClock_GetTimeMs();
+    IotTaskPool_Assert( IotLink_IsLinked( &( pTimerEvent->link ) ) );
+    IotTaskPool_Assert( pWheel->count > 0 );
+
+    IotListDouble_Remove( &( pTimerEvent->link ) );
+
+    pWheel->count--;
+}
 
-    if( pFirstTimerEvent->expirationTime > now )
+/*-----------------------------------------------------------*/
+
+static uint64_t _nextTimerWheelTick( const _taskPoolTimerWheel_t * const pWheel )
+{
+    uint32_t level, offset, firstOffset;
+    uint64_t turn, tick;
+    uint64_t nextTick = TASKPOOL_TIMER_NOT_ARMED;
+
+    if( pWheel->count > 0 )
     {
-        delta = pFirstTimerEvent->expirationTime - now;
+        /* The slots of each level are searched in order from the current position. A slot
+         * of level 0 is due at its tick, and a slot of a higher level is due at its first
+         * tick, when its events are moved to the lower levels. The current slot of a higher
+         * level was moved already. */
+        for( level = 0; level < TASKPOOL_TIMER_WHEEL_LEVELS; level++ )
+        {
+            turn = pWheel->currentTick >> ( level * TASKPOOL_TIMER_WHEEL_SLOT_BITS );
+            firstOffset = ( level == 0U ) ? 0U : 1U;
+
+            for( offset = firstOffset; offset < firstOffset + TASKPOOL_TIMER_WHEEL_SLOTS; offset++ )
+            {
+                if( IotListDouble_IsEmpty( &( pWheel->slots[ level ][ ( turn + offset ) & ( TASKPOOL_TIMER_WHEEL_SLOTS - 1U ) ] ) ) == false )
+                {
+                    tick = ( turn + offset ) << ( level * TASKPOOL_TIMER_WHEEL_SLOT_BITS );
+
+                    if( tick < nextTick )
+                    {
+                        nextTick = tick;
+                    }
+
+                    break;
+                }
+            }
+        }
     }
 
-    if( delta < TASKPOOL_JOB_RESCHEDULE_DELAY_MS )
+    return nextTick;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _advanceTimerWheel( _taskPool_t * const pTaskPool,
+                                uint64_t nowTick )
+{
+    _taskPoolTimerWheel_t * pWheel = &pTaskPool->timerWheel;
+    _taskPoolTimerEvent_t * pTimerEvent;
+    IotListDouble_t * pSlot;
+    IotLink_t * pLink;
+    uint64_t tick;
+    uint32_t level;
+
+    /* Jump from one tick with work to do to the next. No timer events can be in the
+     * slots skipped in between. */
+    for( tick = _nextTimerWheelTick( pWheel ); tick <= nowTick; tick = _nextTimerWheelTick( pWheel ) )
     {
-        delta = TASKPOOL_JOB_RESCHEDULE_DELAY_MS; /* The job will be late... */
+        pWheel->currentTick = tick;
+
+        /* Move the events of the higher level slots that start at this tick to the lower levels. */
+        for( level = TASKPOOL_TIMER_WHEEL_LEVELS - 1U; level > 0; level-- )
+        {
+            if( ( tick & ( ( 1ULL << ( level * TASKPOOL_TIMER_WHEEL_SLOT_BITS ) ) - 1ULL ) ) == 0 )
+            {
+                pSlot = &( pWheel->slots[ level ][ ( tick >> ( level * TASKPOOL_TIMER_WHEEL_SLOT_BITS ) ) & ( TASKPOOL_TIMER_WHEEL_SLOTS - 1U ) ] );
+
+                for( pLink = IotListDouble_RemoveHead( pSlot ); pLink != NULL; pLink = IotListDouble_RemoveHead( pSlot ) )
+                {
+                    pWheel->count--;
+
+                    _insertTimerEvent( pWheel, IotLink_Container( _taskPoolTimerEvent_t, pLink, link ) );
+                }
+            }
+        }
+
+        /* Dispatch all deferred jobs of the level 0 slot for this tick. */
+        pSlot = &( pWheel->slots[ 0 ][ tick & ( TASKPOOL_TIMER_WHEEL_SLOTS - 1U ) ] );
+
+        for( pLink = IotListDouble_RemoveHead( pSlot ); pLink != NULL; pLink = IotListDouble_RemoveHead( pSlot ) )
+        {
+            pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pLink, link );
+
+            IotTaskPool_Assert( TASKPOOL_TIMER_WHEEL_TICK( pTimerEvent->expirationTime ) <= tick );
+
+            pWheel->count--;
+
+            IotLogDebug( "Scheduling job from timer event." );
+
+            /* Queue the job associated with the timer event. */
+            pTimerEvent->pJob->pTimerEvent = NULL;
+
+            ( void ) _scheduleInternal( pTaskPool, pTimerEvent->pJob, 0 );
+
+            /* Free the timer event. */
+            IotTaskPool_FreeTimerEvent( pTimerEvent );
+        }
     }
 
-    IotTaskPool_Assert( delta > 0 );
+    /* There are no events due up to the current tick. */
+    if( pWheel->currentTick < nowTick )
+    {
+        pWheel->currentTick = nowTick;
+    }
+}
 
-    if( IotClock_TimerArm( pTimer, ( uint32_t ) delta, 0 ) == false )
+/*-----------------------------------------------------------*/
+
+static void _rescheduleDeferredJobsTimer( _taskPool_t * const pTaskPool )
+{
+    uint64_t delta = 0;
+    uint64_t now = IotClock_GetTimeMs();
+    uint64_t nextTick = _nextTimerWheelTick( &pTaskPool->timerWheel );
+    uint64_t nextTime = TASKPOOL_TIMER_NOT_ARMED;
+
+    if( nextTick != TASKPOOL_TIMER_NOT_ARMED )
     {
-        IotLogWarn( "Failed to re-arm timer for task pool" );
+        nextTime = nextTick * IOT_TASKPOOL_TIMER_WHEEL_TICK_MS;
+    }
+
+    /* Nothing to do if the timer wheel is empty, or the timer will fire before the next tick. */
+    if( nextTime < pTaskPool->timerWheel.armedTime )
+    {
+        if( nextTime > now )
+        {
+            delta = nextTime - now;
+        }
+
+        if( delta < TASKPOOL_JOB_RESCHEDULE_DELAY_MS )
+        {
+            delta = TASKPOOL_JOB_RESCHEDULE_DELAY_MS; /* The job will be late... */
+        }
+
+        IotTaskPool_Assert( delta > 0 );
+
+        if( IotClock_TimerArm( &pTaskPool->timer, ( uint32_t ) delta, 0 ) == false )
+        {
+            IotLogWarn( "Failed to re-arm timer for task pool" );
+        }
+        else
+        {
+            pTaskPool->timerWheel.armedTime = now + delta;
+        }
     }
 }
 
@@ -1760,7 +2800,6 @@ static void _rescheduleDeferredJobsTimer( IotTimer_t * const pTimer,
 static void _timerThread( void * pArgument )
 {
     _taskPool_t * pTaskPool = ( _taskPool_t * ) pArgument;
-    _taskPoolTimerEvent_t * pTimerEvent = NULL;
 
     IotLogDebug( "Timer thread started for task pool %p.", pTaskPool );
 
@@ -1783,53 +2822,14 @@ static void _timerThread( void * pArgument )
             return;
         }
 
+        /* The timer fired, so it is not armed anymore. */
+        pTaskPool->timerWheel.armedTime = TASKPOOL_TIMER_NOT_ARMED;
+
         /* Dispatch all deferred job whose timer expired, then reset the timer for the next
          * job down the line. */
-        for( ; ; )
-        {
-            /* Peek the first event in the timer event list. */
-            IotLink_t * pLink = IotListDouble_PeekHead( &pTaskPool->timerEventsList );
-
-            /* Check if the timer misfired for any reason.  */
-            if( pLink != NULL )
-            {
-                /* Record the current time. */
-                uint64_t now = IotClock_GetTimeMs();
-
-                /* Extract the job from its envelope. */
-                pTimerEvent = IotLink_Container( _taskPoolTimerEvent_t, pLink, link );
+        _advanceTimerWheel( pTaskPool, IotClock_GetTimeMs() / IOT_TASKPOOL_TIMER_WHEEL_TICK_MS );
 
-                /* Check if the first event should be processed now. */
-                if( pTimerEvent->expirationTime <= now )
-                {
-                    /*  Remove the timer event for immediate processing. */
-                    IotListDouble_Remove( &( pTimerEvent->link ) );
-                }
-                else
-                {
-                    /* The first element in the timer queue shouldn't be processed yet.
-                     * Arm the timer for when it should be processed and leave altogether. */
-                    _rescheduleDeferredJobsTimer( &pTaskPool->timer, pTimerEvent );
-
-                    break;
-                }
-            }
-            /* If there are no timer events to process, terminate this thread. */
-            else
-            {
-                IotLogDebug( "No further timer events to process. Exiting timer thread." );
-
-                break;
-            }
-
-            IotLogDebug( "Scheduling job from timer event." );
-
-            /* Queue the job associated with the received timer event. */
-            ( void ) _scheduleInternal( pTaskPool, pTimerEvent->pJob, 0 );
-
-            /* Free the timer event. */
-            IotTaskPool_FreeTimerEvent( pTimerEvent );
-        }
+        _rescheduleDeferredJobsTimer( pTaskPool );
     }
     TASKPOOL_EXIT_CRITICAL();
 }
@@ -57,14 +57,14 @@
 /*
  * Static memory buffers and flags, allocated and zeroed at compile-time.
  */
-    static bool _pInUseTaskPools[ IOT_TASKPOOLS ] = { 0 };                                                          /**< @brief Task pools in-use flags. */
-    static _taskPool_t _pTaskPools[ IOT_TASKPOOLS ] = { { .dispatchQueue = IOT_DEQUEUE_INITIALIZER } };             /**< @brief Task pools. */
+    static uint32_t _pInUseTaskPools[ IOT_STATIC_MEMORY_BITMAP_SIZE( IOT_TASKPOOLS ) ] = { 0 };                             /**< @brief Task pools in-use bitmap. */
+    static _taskPool_t _pTaskPools[ IOT_TASKPOOLS ] = { { .dispatchQueue = IOT_DEQUEUE_INITIALIZER } };                     /**< @brief Task pools. */
 
-    static bool _pInUseTaskPoolJobs[ IOT_TASKPOOL_JOBS_RECYCLE_LIMIT ] = { 0 };                                     /**< @brief Task pool jobs in-use flags. */
-    static _taskPoolJob_t _pTaskPoolJobs[ IOT_TASKPOOL_JOBS_RECYCLE_LIMIT ] = { { .link = IOT_LINK_INITIALIZER } }; /**< @brief Task pool jobs. */
+    static uint32_t _pInUseTaskPoolJobs[ IOT_STATIC_MEMORY_BITMAP_SIZE( IOT_TASKPOOL_JOBS_RECYCLE_LIMIT ) ] = { 0 };        /**< @brief Task pool jobs in-use bitmap. */
+    static _taskPoolJob_t _pTaskPoolJobs[ IOT_TASKPOOL_JOBS_RECYCLE_LIMIT ] = { { .link = IOT_LINK_INITIALIZER } };         /**< @brief Task pool jobs. */
 
-    static bool _pInUseTaskPoolTimerEvents[ IOT_TASKPOOL_JOBS_RECYCLE_LIMIT ] = { 0 };                              /**< @brief Task pool timer event in-use flags. */
-    static _taskPoolTimerEvent_t _pTaskPoolTimerEvents[ IOT_TASKPOOL_JOBS_RECYCLE_LIMIT ] = { { .link = { 0 } } };  /**< @brief Task pool timer events. */
+    static uint32_t _pInUseTaskPoolTimerEvents[ IOT_STATIC_MEMORY_BITMAP_SIZE( IOT_TASKPOOL_JOBS_RECYCLE_LIMIT ) ] = { 0 }; /**< @brief Task pool timer event in-use bitmap. */
+    static _taskPoolTimerEvent_t _pTaskPoolTimerEvents[ IOT_TASKPOOL_JOBS_RECYCLE_LIMIT ] = { { .link = { 0 } } };          /**< @brief Task pool timer events. */
 
 /*-----------------------------------------------------------*/
 
@@ -77,7 +77,7 @@
         if( size == sizeof( _taskPool_t ) )
         {
             /* Find a free task pool job. */
-            freeIndex = IotStaticMemory_FindFree( _pInUseTaskPools, IOT_TASKPOOLS );
+            freeIndex = IotStaticMemory_FindFreeBit( _pInUseTaskPools, IOT_TASKPOOLS );
 
             if( freeIndex != -1 )
             {
@@ -93,11 +93,11 @@
     void IotTaskPool_FreeTaskPool( void * ptr )
     {
         /* Return the in-use task pool job. */
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _pTaskPools,
-                                     _pInUseTaskPools,
-                                     IOT_TASKPOOLS,
-                                     sizeof( _taskPool_t ) );
+        ( void ) IotStaticMemory_ReturnBit( ptr,
+                                            _pTaskPools,
+                                            _pInUseTaskPools,
+                                            IOT_TASKPOOLS,
+                                            sizeof( _taskPool_t ) );
     }
 
 /*-----------------------------------------------------------*/
@@ -111,8 +111,8 @@
         if( size == sizeof( _taskPoolJob_t ) )
         {
             /* Find a free task pool job. */
-            freeIndex = IotStaticMemory_FindFree( _pInUseTaskPoolJobs,
-                                                  IOT_TASKPOOL_JOBS_RECYCLE_LIMIT );
+            freeIndex = IotStaticMemory_FindFreeBit( _pInUseTaskPoolJobs,
+                                                     IOT_TASKPOOL_JOBS_RECYCLE_LIMIT );
 
             if( freeIndex != -1 )
             {
@@ -128,11 +128,11 @@
     void IotTaskPool_FreeJob( void * ptr )
     {
         /* Return the in-use task pool job. */
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _pTaskPoolJobs,
-                                     _pInUseTaskPoolJobs,
-                                     IOT_TASKPOOL_JOBS_RECYCLE_LIMIT,
-                                     sizeof( _taskPoolJob_t ) );
+        ( void ) IotStaticMemory_ReturnBit( ptr,
+                                            _pTaskPoolJobs,
+                                            _pInUseTaskPoolJobs,
+                                            IOT_TASKPOOL_JOBS_RECYCLE_LIMIT,
+                                            sizeof( _taskPoolJob_t ) );
     }
 
 /*-----------------------------------------------------------*/
@@ -146,8 +146,8 @@
         if( size == sizeof( _taskPoolTimerEvent_t ) )
         {
             /* Find a free task pool timer event. */
-            freeIndex = IotStaticMemory_FindFree( _pInUseTaskPoolTimerEvents,
-                                                  IOT_TASKPOOL_JOBS_RECYCLE_LIMIT );
+            freeIndex = IotStaticMemory_FindFreeBit( _pInUseTaskPoolTimerEvents,
+                                                     IOT_TASKPOOL_JOBS_RECYCLE_LIMIT );
 
             if( freeIndex != -1 )
             {
@@ -163,11 +163,11 @@
     void IotTaskPool_FreeTimerEvent( void * ptr )
     {
         /* Return the in-use task pool timer event. */
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _pTaskPoolTimerEvents,
-                                     _pInUseTaskPoolTimerEvents,
-                                     IOT_TASKPOOL_JOBS_RECYCLE_LIMIT,
-                                     sizeof( _taskPoolTimerEvent_t ) );
+        ( void ) IotStaticMemory_ReturnBit( ptr,
+                                            _pTaskPoolTimerEvents,
+                                            _pInUseTaskPoolTimerEvents,
+                                            IOT_TASKPOOL_JOBS_RECYCLE_LIMIT,
+                                            sizeof( _taskPoolTimerEvent_t ) );
     }
 
 /*-----------------------------------------------------------*/
@@ -0,0 +1,348 @@
+/*
+ * FreeRTOS Common V1.1.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_tests_static_memory.c
+ * @brief Tests for the static memory message buffers.
+ */
+
+/* The config header is always included first. */
+#include "iot_config.h"
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* SDK initialization include. */
+#include "iot_init.h"
+
+/* Static memory include. */
+#include "private/iot_static_memory.h"
+
+/* Test framework includes. */
+#include "unity_fixture.h"
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The largest number of message buffers these tests allocate at once.
+ */
+#define TEST_STATIC_MEMORY_MAX_BUFFERS    ( 64 )
+
+/**
+ * @brief The largest number of message buffer size classes.
+ */
+#define TEST_STATIC_MEMORY_MAX_CLASSES    ( 3 )
+
+/*-----------------------------------------------------------*/
+
+#if IOT_STATIC_MEMORY_ONLY == 1
+
+/**
+ * @brief The statistics of every message buffer size class, read at the start
+ * of each test.
+ */
+    static IotMessageBufferStats_t _pStats[ TEST_STATIC_MEMORY_MAX_CLASSES ] = { { 0 } };
+
+/**
+ * @brief The number of message buffer size classes.
+ */
+    static uint32_t _classCount = 0;
+
+/**
+ * @brief Message buffers allocated by a test.
+ */
+    static void * _pBuffers[ TEST_STATIC_MEMORY_MAX_BUFFERS ] = { NULL };
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get the number of buffers in use in a size class.
+ *
+ * @param[in] sizeClass The size class to query.
+ *
+ * @return The number of buffers in use.
+ */
+    static uint32_t _inUse( uint32_t sizeClass )
+    {
+        IotMessageBufferStats_t stats = { 0 };
+
+        TEST_ASSERT_TRUE( Iot_GetMessageBufferStats( sizeClass, &stats ) );
+
+        return stats.inUse;
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Allocate every free buffer of a size class.
+ *
+ * @param[in] sizeClass The size class to exhaust.
+ * @param[in] firstIndex Where to start storing buffers in #_pBuffers.
+ *
+ * @return The number of buffers allocated.
+ */
+    static uint32_t _exhaustClass( uint32_t sizeClass,
+                                   uint32_t firstIndex )
+    {
+        uint32_t i = 0, freeBuffers = _pStats[ sizeClass ].bufferCount - _inUse( sizeClass );
+
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32( TEST_STATIC_MEMORY_MAX_BUFFERS, firstIndex + freeBuffers );
+
+        for( i = 0; i < freeBuffers; i++ )
+        {
+            _pBuffers[ firstIndex + i ] = Iot_MallocMessageBuffer( _pStats[ sizeClass ].bufferSize );
+            TEST_ASSERT_NOT_NULL( _pBuffers[ firstIndex + i ] );
+        }
+
+        TEST_ASSERT_EQUAL_UINT32( _pStats[ sizeClass ].bufferCount, _inUse( sizeClass ) );
+
+        return freeBuffers;
+    }
+
+#endif /* if IOT_STATIC_MEMORY_ONLY == 1 */
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group for static memory tests.
+ */
+TEST_GROUP( Common_Unit_Static_Memory );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test setup for static memory tests.
+ */
+TEST_SETUP( Common_Unit_Static_Memory )
+{
+    TEST_ASSERT_EQUAL_INT( true, IotSdk_Init() );
+
+    #if IOT_STATIC_MEMORY_ONLY == 1
+        ( void ) memset( _pBuffers, 0x00, sizeof( _pBuffers ) );
+
+        for( _classCount = 0; _classCount < TEST_STATIC_MEMORY_MAX_CLASSES; _classCount++ )
+        {
+            if( Iot_GetMessageBufferStats( _classCount, &( _pStats[ _classCount ] ) ) == false )
+            {
+                break;
+            }
+        }
+
+        TEST_ASSERT_GREATER_THAN( 0, _classCount );
+        TEST_ASSERT_FALSE( Iot_GetMessageBufferStats( _classCount, &( _pStats[ 0 ] ) ) );
+        TEST_ASSERT_TRUE( Iot_GetMessageBufferStats( 0, &( _pStats[ 0 ] ) ) );
+
+        /* The largest class is the fixed message buffer size. */
+        TEST_ASSERT_EQUAL( Iot_MessageBufferSize(), _pStats[ _classCount - 1 ].bufferSize );
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test tear down for static memory tests.
+ */
+TEST_TEAR_DOWN( Common_Unit_Static_Memory )
+{
+    #if IOT_STATIC_MEMORY_ONLY == 1
+        uint32_t i = 0;
+
+        for( i = 0; i < TEST_STATIC_MEMORY_MAX_BUFFERS; i++ )
+        {
+            if( _pBuffers[ i ] != NULL )
+            {
+                Iot_FreeMessageBuffer( _pBuffers[ i ] );
+                _pBuffers[ i ] = NULL;
+            }
+        }
+    #endif
+
+    IotSdk_Cleanup();
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group runner for static memory tests.
+ */
+TEST_GROUP_RUNNER( Common_Unit_Static_Memory )
+{
+    #if IOT_STATIC_MEMORY_ONLY == 1
+        RUN_TEST_CASE( Common_Unit_Static_Memory, MessageBufferClassSelection );
+        RUN_TEST_CASE( Common_Unit_Static_Memory, MessageBufferExhaustion );
+        RUN_TEST_CASE( Common_Unit_Static_Memory, MessageBufferFreeReallocate );
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
+#if IOT_STATIC_MEMORY_ONLY == 1
+
+/**
+ * @brief Test that a message buffer comes from the smallest size class that fits.
+ */
+    TEST( Common_Unit_Static_Memory, MessageBufferClassSelection )
+    {
+        uint32_t i = 0, j = 0;
+        size_t smallestSize = 0;
+        uint32_t pInUse[ TEST_STATIC_MEMORY_MAX_CLASSES ] = { 0 };
+
+        /* Requests larger than the largest class always fail. */
+        TEST_ASSERT_NULL( Iot_MallocMessageBuffer( Iot_MessageBufferSize() + 1 ) );
+
+        for( i = 0; i < _classCount; i++ )
+        {
+            /* Sizes from just above the previous class up to this class size
+             * must be served by this class. */
+            smallestSize = ( i == 0 ) ? 1 : _pStats[ i - 1 ].bufferSize + 1;
+
+            for( j = 0; j < _classCount; j++ )
+            {
+                pInUse[ j ] = _inUse( j );
+            }
+
+            _pBuffers[ 2 * i ] = Iot_MallocMessageBuffer( smallestSize );
+            _pBuffers[ 2 * i + 1 ] = Iot_MallocMessageBuffer( _pStats[ i ].bufferSize );
+            TEST_ASSERT_NOT_NULL( _pBuffers[ 2 * i ] );
+            TEST_ASSERT_NOT_NULL( _pBuffers[ 2 * i + 1 ] );
+
+            for( j = 0; j < _classCount; j++ )
+            {
+                TEST_ASSERT_EQUAL_UINT32( pInUse[ j ] + ( ( j == i ) ? 2U : 0U ), _inUse( j ) );
+            }
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test that an exhausted size class falls back to the next larger class,
+ * and that allocation fails once the largest class is exhausted.
+ */
+    TEST( Common_Unit_Static_Memory, MessageBufferExhaustion )
+    {
+        uint32_t i = 0, allocated = 0;
+        IotMessageBufferStats_t stats = { 0 };
+
+        for( i = 0; i < _classCount; i++ )
+        {
+            allocated += _pStats[ i ].bufferCount;
+        }
+
+        if( allocated + _classCount > TEST_STATIC_MEMORY_MAX_BUFFERS )
+        {
+            TEST_IGNORE_MESSAGE( "Too many message buffers to exhaust in this test." );
+        }
+
+        allocated = 0;
+
+        for( i = 0; i < _classCount; i++ )
+        {
+            allocated += _exhaustClass( i, allocated );
+
+            if( i + 1 < _classCount )
+            {
+                /* A request sized for the exhausted class is served by the next one. */
+                TEST_ASSERT_LESS_THAN_UINT32( TEST_STATIC_MEMORY_MAX_BUFFERS, allocated );
+                _pBuffers[ allocated ] = Iot_MallocMessageBuffer( _pStats[ i ].bufferSize );
+                TEST_ASSERT_NOT_NULL( _pBuffers[ allocated ] );
+                TEST_ASSERT_EQUAL_UINT32( _pStats[ i + 1 ].inUse + 1, _inUse( i + 1 ) );
+                allocated++;
+            }
+            else
+            {
+                /* Every class that fits is exhausted. */
+                TEST_ASSERT_NULL( Iot_MallocMessageBuffer( 1 ) );
+            }
+        }
+
+        /* Every class reached its high-water mark. Each class failed the last
+         * request, and every class but the largest also failed the request
+         * that fell back to the next class. */
+        for( i = 0; i < _classCount; i++ )
+        {
+            TEST_ASSERT_TRUE( Iot_GetMessageBufferStats( i, &stats ) );
+            TEST_ASSERT_EQUAL_UINT32( _pStats[ i ].failures + ( ( i + 1 < _classCount ) ? 2U : 1U ), stats.failures );
+            TEST_ASSERT_EQUAL_UINT32( stats.bufferCount, stats.highWaterMark );
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test that freed message buffers return to their own size class and
+ * can be allocated again.
+ */
+    TEST( Common_Unit_Static_Memory, MessageBufferFreeReallocate )
+    {
+        uint32_t i = 0;
+        size_t j = 0;
+        uint8_t * pBuffer = NULL;
+        void * pFreed = NULL;
+
+        for( i = 0; i < _classCount; i++ )
+        {
+            _pBuffers[ i ] = Iot_MallocMessageBuffer( _pStats[ i ].bufferSize );
+            TEST_ASSERT_NOT_NULL( _pBuffers[ i ] );
+            TEST_ASSERT_EQUAL_UINT32( _pStats[ i ].inUse + 1, _inUse( i ) );
+
+            /* Dirty the buffer; it must be cleared when freed. */
+            ( void ) memset( _pBuffers[ i ], 0xa5, _pStats[ i ].bufferSize );
+        }
+
+        /* Freeing a pointer that is not the start of a message buffer is ignored. */
+        pBuffer = _pBuffers[ _classCount - 1 ];
+        Iot_FreeMessageBuffer( pBuffer + 1 );
+        TEST_ASSERT_EQUAL_UINT32( _pStats[ _classCount - 1 ].inUse + 1, _inUse( _classCount - 1 ) );
+        TEST_ASSERT_EQUAL_UINT8( 0xa5, pBuffer[ 1 ] );
+
+        /* Free the buffers from the largest class down, so each free must find
+         * the right class. */
+        for( i = _classCount; i > 0; i-- )
+        {
+            pFreed = _pBuffers[ i - 1 ];
+            Iot_FreeMessageBuffer( pFreed );
+            _pBuffers[ i - 1 ] = NULL;
+
+            TEST_ASSERT_EQUAL_UINT32( _pStats[ i - 1 ].inUse, _inUse( i - 1 ) );
+
+            for( j = 0; j < _pStats[ i - 1 ].bufferSize; j++ )
+            {
+                TEST_ASSERT_EQUAL_UINT8( 0, ( ( uint8_t * ) pFreed )[ j ] );
+            }
+
+            /* The freed buffer is the first free buffer of its class again. */
+            _pBuffers[ i - 1 ] = Iot_MallocMessageBuffer( _pStats[ i - 1 ].bufferSize );
+            TEST_ASSERT_EQUAL_PTR( pFreed, _pBuffers[ i - 1 ] );
+            TEST_ASSERT_EQUAL_UINT32( _pStats[ i - 1 ].inUse + 1, _inUse( i - 1 ) );
+        }
+    }
+
+#endif /* if IOT_STATIC_MEMORY_ONLY == 1 */
+
+/*-----------------------------------------------------------*/
@@ -73,6 +73,33 @@ typedef struct JobBlockingUserContext
     IotSemaphore_t block;  /**< @brief A synch object to wait on. */
 } JobBlockingUserContext_t;
 
+/**
+ * @brief The number of jobs in the priority classes test.
+ */
+#define TEST_TASKPOOL_PRIORITY_JOBS    ( 5 )
+
+/**
+ * @brief A user context to record the order in which jobs execute.
+ */
+typedef struct JobOrderUserContext
+{
+    IotMutex_t lock;                                      /**< @brief Protection from concurrent updates. */
+    uint32_t counter;                                     /**< @brief A counter to keep track of callback invocations. */
+    IotTaskPoolJob_t order[ TEST_TASKPOOL_PRIORITY_JOBS ]; /**< @brief The jobs in the order they executed. */
+    IotSemaphore_t done;                                  /**< @brief A synch object to signal when all jobs executed. */
+} JobOrderUserContext_t;
+
+/**
+ * @brief A user context to measure the throughput of the taskpool.
+ */
+typedef struct JobThroughputUserContext
+{
+    IotMutex_t lock;     /**< @brief Protection from concurrent updates. */
+    uint32_t counter;    /**< @brief A counter to keep track of callback invocations. */
+    uint32_t target;     /**< @brief The number of callback invocations to wait for. */
+    IotSemaphore_t done; /**< @brief A synch object to signal when the target is reached. */
+} JobThroughputUserContext_t;
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -124,6 +151,9 @@ TEST_GROUP_RUNNER( Common_Unit_Task_Pool )
     RUN_TEST_CASE( Common_Unit_Task_Pool, ScheduleTasks_ReSchedule );
     RUN_TEST_CASE( Common_Unit_Task_Pool, ScheduleTasks_ReScheduleDeferred );
     RUN_TEST_CASE( Common_Unit_Task_Pool, ScheduleTasks_CancelTasks );
+    RUN_TEST_CASE( Common_Unit_Task_Pool, ScheduleTasks_PriorityClasses );
+    RUN_TEST_CASE( Common_Unit_Task_Pool, ScheduleTasks_Throughput );
+    RUN_TEST_CASE( Common_Unit_Task_Pool, ScheduleTasks_DeferredStress );
 }
 
 /*-----------------------------------------------------------*/
@@ -198,6 +228,34 @@ TEST_GROUP_RUNNER( Common_Unit_Task_Pool )
     #define TEST_TASKPOOL_MAX_THREADS    7
 #endif
 
+/**
+ * @brief Define the number of times the throughput test schedules all its jobs.
+ */
+#ifndef TEST_TASKPOOL_THROUGHPUT_ROUNDS
+    #define TEST_TASKPOOL_THROUGHPUT_ROUNDS    ( 50 )
+#endif
+
+/**
+ * @brief Define the amount of emulated work for each job of the throughput test.
+ */
+#ifndef TEST_TASKPOOL_THROUGHPUT_JOB_WORK
+    #define TEST_TASKPOOL_THROUGHPUT_JOB_WORK    ( 1000 )
+#endif
+
+/**
+ * @brief Define the number of jobs the deferred stress test schedules.
+ *
+ * Each job needs a job and a timer event from the heap. Raise this on targets
+ * with enough memory to stress the timer further.
+ */
+#ifndef TEST_TASKPOOL_DEFERRED_JOBS
+    #if IOT_STATIC_MEMORY_ONLY == 1
+        #define TEST_TASKPOOL_DEFERRED_JOBS    IOT_TASKPOOL_JOBS_RECYCLE_LIMIT
+    #else
+        #define TEST_TASKPOOL_DEFERRED_JOBS    ( 256 )
+    #endif
+#endif
+
 /**
  * @brief One hour in milliseconds.
  */
@@ -328,6 +386,86 @@ static void ExecutionLongWithoutDestroyCb( IotTaskPool_t pTaskPool,
     IotMutex_Unlock( &pUserContext->lock );
 }
 
+/**
+ * @brief A callback that records the order in which jobs execute.
+ */
+static void ExecutionRecordOrderCb( IotTaskPool_t pTaskPool,
+                                    IotTaskPoolJob_t pJob,
+                                    void * pContext )
+{
+    JobOrderUserContext_t * pUserContext = ( JobOrderUserContext_t * ) pContext;
+
+    ( void ) pTaskPool;
+
+    IotMutex_Lock( &pUserContext->lock );
+
+    if( pUserContext->counter < TEST_TASKPOOL_PRIORITY_JOBS )
+    {
+        pUserContext->order[ pUserContext->counter ] = pJob;
+    }
+
+    pUserContext->counter++;
+
+    if( pUserContext->counter == TEST_TASKPOOL_PRIORITY_JOBS )
+    {
+        IotSemaphore_Post( &pUserContext->done );
+    }
+
+    IotMutex_Unlock( &pUserContext->lock );
+}
+
+/**
+ * @brief A callback that emulates a short job without sleeping, for measuring throughput.
+ */
+static void ExecutionThroughputCb( IotTaskPool_t pTaskPool,
+                                   IotTaskPoolJob_t pJob,
+                                   void * pContext )
+{
+    JobThroughputUserContext_t * pUserContext;
+    volatile uint32_t work;
+
+    ( void ) pTaskPool;
+    ( void ) pJob;
+
+    for( work = 0; work < TEST_TASKPOOL_THROUGHPUT_JOB_WORK; work++ )
+    {
+    }
+
+    pUserContext = ( JobThroughputUserContext_t * ) pContext;
+
+    IotMutex_Lock( &pUserContext->lock );
+    pUserContext->counter++;
+
+    if( pUserContext->counter == pUserContext->target )
+    {
+        IotSemaphore_Post( &pUserContext->done );
+    }
+
+    IotMutex_Unlock( &pUserContext->lock );
+}
+
+/**
+ * @brief A callback that counts towards a target and recycles its job.
+ */
+static void ExecutionCountAndRecycleCb( IotTaskPool_t pTaskPool,
+                                        IotTaskPoolJob_t pJob,
+                                        void * pContext )
+{
+    JobThroughputUserContext_t * pUserContext = ( JobThroughputUserContext_t * ) pContext;
+
+    IotMutex_Lock( &pUserContext->lock );
+    pUserContext->counter++;
+
+    if( pUserContext->counter == pUserContext->target )
+    {
+        IotSemaphore_Post( &pUserContext->done );
+    }
+
+    IotMutex_Unlock( &pUserContext->lock );
+
+    IotTaskPool_RecycleJob( pTaskPool, pJob );
+}
+
 /**
  * @brief A callback that does not recycle its job.
  */
@@ -1853,3 +1991,270 @@ TEST( Common_Unit_Task_Pool, ScheduleTasks_CancelTasks )
 }
 
 /*-----------------------------------------------------------*/
+
+/**
+ * @brief Test that jobs execute by priority class, then by deadline, and that the
+ * statistics of each class are updated.
+ */
+TEST( Common_Unit_Task_Pool, ScheduleTasks_PriorityClasses )
+{
+    IotTaskPool_t taskPool = IOT_TASKPOOL_INITIALIZER;
+
+    /* Use a single worker thread, so that jobs queue up behind a blocking job. */
+    const IotTaskPoolInfo_t tpInfo = { .minThreads = 1, .maxThreads = 1, .stackSize = IOT_THREAD_DEFAULT_STACK_SIZE, .priority = IOT_THREAD_DEFAULT_PRIORITY };
+
+    JobBlockingUserContext_t blockingContext;
+    JobOrderUserContext_t orderContext;
+    IotTaskPoolStatistics_t statistics;
+
+    memset( &orderContext, 0, sizeof( JobOrderUserContext_t ) );
+    memset( &statistics, 0, sizeof( IotTaskPoolStatistics_t ) );
+
+    /* Initialize user contexts. */
+    TEST_ASSERT( IotSemaphore_Create( &blockingContext.signal, 0, 1 ) );
+    TEST_ASSERT( IotSemaphore_Create( &blockingContext.block, 0, 1 ) );
+    TEST_ASSERT( IotMutex_Create( &orderContext.lock, false ) );
+    TEST_ASSERT( IotSemaphore_Create( &orderContext.done, 0, 1 ) );
+
+    TEST_ASSERT( IotTaskPool_Create( &tpInfo, &taskPool ) == IOT_TASKPOOL_SUCCESS );
+
+    if( TEST_PROTECT() )
+    {
+        uint32_t count;
+        IotTaskPoolJobStorage_t blockingJobStorage;
+        IotTaskPoolJob_t blockingJob;
+        IotTaskPoolJobStorage_t jobsStorage[ TEST_TASKPOOL_PRIORITY_JOBS ];
+        IotTaskPoolJob_t jobs[ TEST_TASKPOOL_PRIORITY_JOBS ];
+
+        TEST_ASSERT( IotTaskPool_CreateJob( &ExecutionBlockingWithoutDestroyCb, &blockingContext, &blockingJobStorage, &blockingJob ) == IOT_TASKPOOL_SUCCESS );
+
+        for( count = 0; count < TEST_TASKPOOL_PRIORITY_JOBS; ++count )
+        {
+            TEST_ASSERT( IotTaskPool_CreateJob( &ExecutionRecordOrderCb, &orderContext, &jobsStorage[ count ], &jobs[ count ] ) == IOT_TASKPOOL_SUCCESS );
+        }
+
+        /* Invalid priority classes are rejected. */
+        TEST_ASSERT( IotTaskPool_ScheduleWithPriority( taskPool, jobs[ 0 ], ( IotTaskPoolPriority_t ) IOT_TASKPOOL_PRIORITIES, 0 ) == IOT_TASKPOOL_BAD_PARAMETER );
+        TEST_ASSERT( IotTaskPool_ScheduleDeferredWithPriority( taskPool, jobs[ 0 ], 10, ( IotTaskPoolPriority_t ) -1, 0 ) == IOT_TASKPOOL_BAD_PARAMETER );
+
+        /* Occupy the only worker thread. */
+        TEST_ASSERT( IotTaskPool_Schedule( taskPool, blockingJob, 0 ) == IOT_TASKPOOL_SUCCESS );
+        IotSemaphore_Wait( &blockingContext.signal );
+
+        /* Queue up jobs of all classes. */
+        TEST_ASSERT( IotTaskPool_ScheduleWithPriority( taskPool, jobs[ 0 ], IOT_TASKPOOL_PRIORITY_LOW, 0 ) == IOT_TASKPOOL_SUCCESS );
+        TEST_ASSERT( IotTaskPool_Schedule( taskPool, jobs[ 1 ], 0 ) == IOT_TASKPOOL_SUCCESS );
+        TEST_ASSERT( IotTaskPool_ScheduleWithPriority( taskPool, jobs[ 2 ], IOT_TASKPOOL_PRIORITY_HIGH, 0 ) == IOT_TASKPOOL_SUCCESS );
+        TEST_ASSERT( IotTaskPool_ScheduleWithPriority( taskPool, jobs[ 3 ], IOT_TASKPOOL_PRIORITY_HIGH, ONE_HOUR_FROM_NOW_MS ) == IOT_TASKPOOL_SUCCESS );
+        TEST_ASSERT( IotTaskPool_ScheduleWithPriority( taskPool, jobs[ 4 ], IOT_TASKPOOL_PRIORITY_NORMAL, 0 ) == IOT_TASKPOOL_SUCCESS );
+
+        TEST_ASSERT( IotTaskPool_GetStatistics( taskPool, &statistics ) == IOT_TASKPOOL_SUCCESS );
+        TEST_ASSERT_EQUAL( 1, statistics.priorities[ IOT_TASKPOOL_PRIORITY_LOW ].queueDepth );
+        TEST_ASSERT_EQUAL( 2, statistics.priorities[ IOT_TASKPOOL_PRIORITY_NORMAL ].queueDepth );
+        TEST_ASSERT_EQUAL( 2, statistics.priorities[ IOT_TASKPOOL_PRIORITY_HIGH ].queueDepth );
+
+        /* Release the worker thread and wait for all jobs. */
+        IotSemaphore_Post( &blockingContext.block );
+        IotSemaphore_Wait( &orderContext.done );
+
+        /* High priority jobs with a deadline go first, then by class in FIFO order. */
+        TEST_ASSERT( orderContext.order[ 0 ] == jobs[ 3 ] );
+        TEST_ASSERT( orderContext.order[ 1 ] == jobs[ 2 ] );
+        TEST_ASSERT( orderContext.order[ 2 ] == jobs[ 1 ] );
+        TEST_ASSERT( orderContext.order[ 3 ] == jobs[ 4 ] );
+        TEST_ASSERT( orderContext.order[ 4 ] == jobs[ 0 ] );
+
+        TEST_ASSERT( IotTaskPool_GetStatistics( taskPool, &statistics ) == IOT_TASKPOOL_SUCCESS );
+
+        for( count = 0; count < IOT_TASKPOOL_PRIORITIES; ++count )
+        {
+            TEST_ASSERT_EQUAL( 0, statistics.priorities[ count ].queueDepth );
+            TEST_ASSERT_EQUAL( 0, statistics.priorities[ count ].missedDeadlines );
+            TEST_ASSERT( statistics.priorities[ count ].maxWaitMs <= statistics.priorities[ count ].totalWaitMs );
+        }
+
+        TEST_ASSERT_EQUAL( 1, statistics.priorities[ IOT_TASKPOOL_PRIORITY_LOW ].dispatchedJobs );
+        TEST_ASSERT_EQUAL( 3, statistics.priorities[ IOT_TASKPOOL_PRIORITY_NORMAL ].dispatchedJobs );
+        TEST_ASSERT_EQUAL( 2, statistics.priorities[ IOT_TASKPOOL_PRIORITY_HIGH ].dispatchedJobs );
+        TEST_ASSERT_EQUAL( 2, statistics.priorities[ IOT_TASKPOOL_PRIORITY_HIGH ].maxQueueDepth );
+    }
+
+    TEST_ASSERT( IotTaskPool_Destroy( taskPool ) == IOT_TASKPOOL_SUCCESS );
+
+    /* Destroy user contexts. */
+    IotSemaphore_Destroy( &orderContext.done );
+    IotMutex_Destroy( &orderContext.lock );
+    IotSemaphore_Destroy( &blockingContext.block );
+    IotSemaphore_Destroy( &blockingContext.signal );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Measure the number of jobs executed per second with a growing number of worker threads.
+ *
+ * Each job only does a short amount of work, so that the result reflects the cost of
+ * scheduling and dispatching jobs. Compare the results with and without
+ * @ref IOT_TASKPOOL_ENABLE_WORK_STEALING.
+ */
+TEST( Common_Unit_Task_Pool, ScheduleTasks_Throughput )
+{
+    uint32_t threads, round, count;
+    uint64_t startTime, elapsedTime;
+    JobThroughputUserContext_t userContext;
+    IotTaskPoolJobStorage_t tpJobsStorage[ TEST_TASKPOOL_ITERATIONS ];
+    IotTaskPoolJob_t tpJobs[ TEST_TASKPOOL_ITERATIONS ];
+
+    memset( &userContext, 0, sizeof( JobThroughputUserContext_t ) );
+
+    /* Initialize user context. */
+    TEST_ASSERT( IotMutex_Create( &userContext.lock, false ) );
+    TEST_ASSERT( IotSemaphore_Create( &userContext.done, 0, 1 ) );
+
+    userContext.target = TEST_TASKPOOL_ITERATIONS;
+
+    for( threads = 1; threads <= TEST_TASKPOOL_MAX_THREADS; threads++ )
+    {
+        IotTaskPool_t taskPool = IOT_TASKPOOL_INITIALIZER;
+        const IotTaskPoolInfo_t tpInfo = { .minThreads = threads, .maxThreads = threads, .stackSize = IOT_THREAD_DEFAULT_STACK_SIZE, .priority = IOT_THREAD_DEFAULT_PRIORITY };
+
+        TEST_ASSERT( IotTaskPool_Create( &tpInfo, &taskPool ) == IOT_TASKPOOL_SUCCESS );
+
+        if( TEST_PROTECT() )
+        {
+            startTime = IotClock_GetTimeMs();
+
+            for( round = 0; round < TEST_TASKPOOL_THROUGHPUT_ROUNDS; round++ )
+            {
+                IotMutex_Lock( &userContext.lock );
+                userContext.counter = 0;
+                IotMutex_Unlock( &userContext.lock );
+
+                for( count = 0; count < TEST_TASKPOOL_ITERATIONS; ++count )
+                {
+                    TEST_ASSERT( IotTaskPool_CreateJob( &ExecutionThroughputCb, &userContext, &tpJobsStorage[ count ], &tpJobs[ count ] ) == IOT_TASKPOOL_SUCCESS );
+                    TEST_ASSERT( IotTaskPool_Schedule( taskPool, tpJobs[ count ], 0 ) == IOT_TASKPOOL_SUCCESS );
+                }
+
+                /* Wait until all callbacks are executed. */
+                IotSemaphore_Wait( &userContext.done );
+            }
+
+            elapsedTime = IotClock_GetTimeMs() - startTime;
+
+            /* Avoid dividing by zero on fast systems with a coarse clock. */
+            if( elapsedTime == 0 )
+            {
+                elapsedTime = 1;
+            }
+
+            UnityPrint( "Task pool with " );
+            UnityPrintNumber( ( UNITY_INT ) threads );
+            UnityPrint( " worker(s): " );
+            UnityPrintNumber( ( UNITY_INT ) ( ( ( uint64_t ) TEST_TASKPOOL_THROUGHPUT_ROUNDS * TEST_TASKPOOL_ITERATIONS * 1000ULL ) / elapsedTime ) );
+            UnityPrint( " jobs/sec." );
+            UNITY_PRINT_EOL();
+        }
+
+        TEST_ASSERT( IotTaskPool_Destroy( taskPool ) == IOT_TASKPOOL_SUCCESS );
+    }
+
+    /* Destroy user context. */
+    IotSemaphore_Destroy( &userContext.done );
+    IotMutex_Destroy( &userContext.lock );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The jobs of the deferred stress test.
+ */
+static IotTaskPoolJob_t _pDeferredJobs[ TEST_TASKPOOL_DEFERRED_JOBS ];
+
+/**
+ * @brief Stress the timer of the task pool with many deferred jobs, cancel half of them,
+ * and measure how long scheduling and canceling take.
+ */
+TEST( Common_Unit_Task_Pool, ScheduleTasks_DeferredStress )
+{
+    IotTaskPool_t taskPool = IOT_TASKPOOL_INITIALIZER;
+    const IotTaskPoolInfo_t tpInfo = { .minThreads = 2, .maxThreads = 3, .stackSize = IOT_THREAD_DEFAULT_STACK_SIZE, .priority = IOT_THREAD_DEFAULT_PRIORITY };
+    uint32_t count, scheduled = 0, canceled = 0;
+    uint64_t startTime, scheduleTime, cancelTime;
+    IotTaskPoolJobStatus_t status;
+    JobThroughputUserContext_t userContext;
+
+    memset( &userContext, 0, sizeof( JobThroughputUserContext_t ) );
+
+    /* Initialize user context. */
+    TEST_ASSERT( IotMutex_Create( &userContext.lock, false ) );
+    TEST_ASSERT( IotSemaphore_Create( &userContext.done, 0, 1 ) );
+
+    /* The target is set once it is known how many jobs were canceled. */
+    userContext.target = UINT32_MAX;
+
+    TEST_ASSERT( IotTaskPool_Create( &tpInfo, &taskPool ) == IOT_TASKPOOL_SUCCESS );
+
+    if( TEST_PROTECT() )
+    {
+        /* Schedule all jobs far enough in the future that none fires before they are all
+         * scheduled and half of them canceled. */
+        startTime = IotClock_GetTimeMs();
+
+        for( count = 0; count < TEST_TASKPOOL_DEFERRED_JOBS; ++count )
+        {
+            TEST_ASSERT( IotTaskPool_CreateRecyclableJob( taskPool, &ExecutionCountAndRecycleCb, &userContext, &_pDeferredJobs[ count ] ) == IOT_TASKPOOL_SUCCESS );
+            TEST_ASSERT( IotTaskPool_ScheduleDeferred( taskPool, _pDeferredJobs[ count ], 2000 + ( rand() % 1000 ) ) == IOT_TASKPOOL_SUCCESS );
+            ++scheduled;
+        }
+
+        scheduleTime = IotClock_GetTimeMs() - startTime;
+
+        /* Cancel every other job. */
+        startTime = IotClock_GetTimeMs();
+
+        for( count = 0; count < TEST_TASKPOOL_DEFERRED_JOBS; count += 2 )
+        {
+            if( IotTaskPool_TryCancel( taskPool, _pDeferredJobs[ count ], &status ) == IOT_TASKPOOL_SUCCESS )
+            {
+                TEST_ASSERT( status == IOT_TASKPOOL_STATUS_DEFERRED );
+                TEST_ASSERT( IotTaskPool_RecycleJob( taskPool, _pDeferredJobs[ count ] ) == IOT_TASKPOOL_SUCCESS );
+                ++canceled;
+            }
+        }
+
+        cancelTime = IotClock_GetTimeMs() - startTime;
+
+        IotMutex_Lock( &userContext.lock );
+        userContext.target = scheduled - canceled;
+
+        if( userContext.counter == userContext.target )
+        {
+            IotSemaphore_Post( &userContext.done );
+        }
+
+        IotMutex_Unlock( &userContext.lock );
+
+        /* Wait until all jobs that were not canceled are executed. */
+        TEST_ASSERT_TRUE( IotSemaphore_TimedWait( &userContext.done, 10000 ) );
+        TEST_ASSERT_EQUAL_UINT32( scheduled - canceled, userContext.counter );
+
+        UnityPrintNumber( ( UNITY_INT ) scheduled );
+        UnityPrint( " deferred jobs scheduled in " );
+        UnityPrintNumber( ( UNITY_INT ) scheduleTime );
+        UnityPrint( " ms, " );
+        UnityPrintNumber( ( UNITY_INT ) canceled );
+        UnityPrint( " canceled in " );
+        UnityPrintNumber( ( UNITY_INT ) cancelTime );
+        UnityPrint( " ms." );
+        UNITY_PRINT_EOL();
+    }
+
+    TEST_ASSERT( IotTaskPool_Destroy( taskPool ) == IOT_TASKPOOL_SUCCESS );
+
+    /* Destroy user context. */
+    IotSemaphore_Destroy( &userContext.done );
+    IotMutex_Destroy( &userContext.lock );
+}
+
+/*-----------------------------------------------------------*/
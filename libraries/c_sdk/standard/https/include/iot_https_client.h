@@ -48,6 +48,14 @@
  * @function_brief{https_client_function_disconnect}
  * - @function_name{https_client_function_connect}
  * @function_brief{https_client_function_connect}
+ * - @function_name{https_client_function_createconnectionpool}
+ * @function_brief{https_client_function_createconnectionpool}
+ * - @function_name{https_client_function_acquireconnection}
+ * @function_brief{https_client_function_acquireconnection}
+ * - @function_name{https_client_function_releaseconnection}
+ * @function_brief{https_client_function_releaseconnection}
+ * - @function_name{https_client_function_destroyconnectionpool}
+ * @function_brief{https_client_function_destroyconnectionpool}
  * - @function_name{https_client_function_initializerequest}
  * @function_brief{https_client_function_initializerequest}
  * - @function_name{https_client_function_addheader}
@@ -85,6 +93,18 @@
  * @page https_client_function_connect IotHttpsClient_Connect
  * @snippet this declare_https_client_connect
  * @copydoc IotHttpsClient_Connect
+ * @page https_client_function_createconnectionpool IotHttpsClient_CreateConnectionPool
+ * @snippet this declare_https_client_createconnectionpool
+ * @copydoc IotHttpsClient_CreateConnectionPool
+ * @page https_client_function_acquireconnection IotHttpsClient_AcquireConnection
+ * @snippet this declare_https_client_acquireconnection
+ * @copydoc IotHttpsClient_AcquireConnection
+ * @page https_client_function_releaseconnection IotHttpsClient_ReleaseConnection
+ * @snippet this declare_https_client_releaseconnection
+ * @copydoc IotHttpsClient_ReleaseConnection
+ * @page https_client_function_destroyconnectionpool IotHttpsClient_DestroyConnectionPool
+ * @snippet this declare_https_client_destroyconnectionpool
+ * @copydoc IotHttpsClient_DestroyConnectionPool
  * @page https_client_function_initializerequest IotHttpsClient_InitializeRequest
  * @snippet this declare_https_client_initializerequest
  * @copydoc IotHttpsClient_InitializeRequest
@@ -295,6 +315,133 @@ IotHttpsReturnCode_t IotHttpsClient_Connect( IotHttpsConnectionHandle_t * pConnH
 IotHttpsReturnCode_t IotHttpsClient_Disconnect( IotHttpsConnectionHandle_t connHandle );
 /* @[declare_https_client_disconnect] */
 
+/**
+ * @brief Create a pool of HTTPS connections that are kept open between requests.
+ *
+ * A connection acquired from the pool with @ref https_client_function_acquireconnection is an ordinary connection
+ * handle for @ref https_client_function_sendsync and @ref https_client_function_sendasync. When the application is
+ * done with it, @ref https_client_function_releaseconnection keeps it open in the pool. The next
+ * @ref https_client_function_acquireconnection to the same host, port, and ALPN protocols then returns that connection
+ * without a new TCP connection and TLS handshake.
+ *
+ * All of the memory of the pool, including the connection contexts, is in #IotHttpsConnectionPoolInfo_t.userBuffer.
+ * See @ref connectionPoolUserBufferMinimumSize for how to size it.
+ *
+ * @param[out] pPoolHandle - Handle returned representing the connection pool. NULL if the function failed.
+ * @param[in] pPoolInfo - Configurations for the connection pool.
+ *
+ * @return One of the following:
+ * - #IOT_HTTPS_OK if the pool was created.
+ * - #IOT_HTTPS_INVALID_PARAMETER if NULL parameters were passed in.
+ * - #IOT_HTTPS_INSUFFICIENT_MEMORY if the user buffer cannot fit a single connection.
+ * - #IOT_HTTPS_INTERNAL_ERROR if there was an error creating resources for the pool context.
+ */
+/* @[declare_https_client_createconnectionpool] */
+IotHttpsReturnCode_t IotHttpsClient_CreateConnectionPool( IotHttpsConnectionPoolHandle_t * pPoolHandle,
+                                                          IotHttpsConnectionPoolInfo_t * pPoolInfo );
+/* @[declare_https_client_createconnectionpool] */
+
+/**
+ * @brief Acquire a connection to the server in pConnInfo from a connection pool.
+ *
+ * An idle connection in the pool to the same #IotHttpsConnectionInfo_t.pAddress, #IotHttpsConnectionInfo_t.port,
+ * #IotHttpsConnectionInfo_t.pAlpnProtocols, #IotHttpsConnectionInfo_t.flags and network interface is returned as is.
+ * Before it is returned it is checked to still be connected and to have been idle for less than
+ * #IotHttpsConnectionPoolInfo_t.idleTimeoutMs; a connection that fails the check is connected again.
+ *
+ * If there is no such connection, then a new connection is made in a free slot of the pool. If there is no free slot,
+ * then the idle connection released the longest time ago is closed to make room. This routine blocks until the new
+ * connection is complete.
+ *
+ * This routine never waits for another thread to release a connection. If
+ * #IotHttpsConnectionPoolInfo_t.maxConnectionsPerHost connections to the server are all acquired, or all of the
+ * connections in the pool are acquired, then #IOT_HTTPS_BUSY is returned immediately. The application decides whether to wait and try again, or to fall back to
+ * @ref https_client_function_connect.
+ *
+ * #IotHttpsConnectionInfo_t.userBuffer is ignored: the connection context is in the pool's user buffer. The pool
+ * matches connections on the server only, so connections to the same server in one pool should use the same
+ * credentials.
+ *
+ * The connection handle returned must be given back with @ref https_client_function_releaseconnection, not with
+ * @ref https_client_function_disconnect, and must not be passed to @ref https_client_function_connect.
+ *
+ * @param[in] poolHandle - Valid handle representing a connection pool.
+ * @param[out] pConnHandle - Handle returned representing the open connection. NULL if the function failed.
+ * @param[in] pConnInfo - Configurations for the HTTPS connection.
+ *
+ * @return One of the following:
+ * - #IOT_HTTPS_OK if a connection was acquired.
+ * - #IOT_HTTPS_BUSY if #IotHttpsConnectionPoolInfo_t.maxConnectionsPerHost connections to the server are acquired, or
+ * all of the connections in the pool are acquired.
+ * - #IOT_HTTPS_CONNECTION_ERROR if a new connection failed.
+ * - #IOT_HTTPS_INVALID_PARAMETER if NULL parameters were passed in.
+ * - #IOT_HTTPS_INTERNAL_ERROR if there was an error creating resources for the connection context.
+ *
+ * <b>Example</b>
+ * @code{c}
+ * // A connection pool and connection configuration initialized elsewhere.
+ * IotHttpsConnectionPoolHandle_t poolHandle;
+ * IotHttpsConnectionInfo_t connInfo;
+ *
+ * IotHttpsConnectionHandle_t connHandle = IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER;
+ * IotHttpsReturnCode_t returnCode = IotHttpsClient_AcquireConnection( poolHandle, &connHandle, &connInfo );
+ *
+ * if( returnCode == IOT_HTTPS_OK )
+ * {
+ *      // Send persistent requests with IotHttpsClient_SendSync() or IotHttpsClient_SendAsync()...
+ *
+ *      // Keep the connection open for the next request to the same server.
+ *      IotHttpsClient_ReleaseConnection( poolHandle, connHandle );
+ * }
+ * @endcode
+ */
+/* @[declare_https_client_acquireconnection] */
+IotHttpsReturnCode_t IotHttpsClient_AcquireConnection( IotHttpsConnectionPoolHandle_t poolHandle,
+                                                       IotHttpsConnectionHandle_t * pConnHandle,
+                                                       IotHttpsConnectionInfo_t * pConnInfo );
+/* @[declare_https_client_acquireconnection] */
+
+/**
+ * @brief Give a connection acquired with @ref https_client_function_acquireconnection back to its pool.
+ *
+ * The connection is kept open for the next @ref https_client_function_acquireconnection to the same server. It is
+ * closed instead if it is already disconnected, for instance after a non-persistent request, if it still has requests
+ * outstanding, or if #IotHttpsConnectionPoolInfo_t.maxIdleConnections connections are idle already.
+ *
+ * Make sure that all requests on the connection have completed before calling this function, as for
+ * @ref https_client_function_disconnect. connHandle must not be used after this function returns successfully.
+ *
+ * @param[in] poolHandle - Valid handle representing the connection pool connHandle was acquired from.
+ * @param[in] connHandle - Valid handle representing an acquired connection.
+ *
+ * @return One of the following:
+ * - #IOT_HTTPS_OK if the connection was given back to the pool.
+ * - #IOT_HTTPS_INVALID_PARAMETER if NULL parameters were passed in, or connHandle is not acquired from the pool.
+ * - #IOT_HTTPS_BUSY if the connection had to be closed but is in use. The application may call this function again
+ * later to try again.
+ */
+/* @[declare_https_client_releaseconnection] */
+IotHttpsReturnCode_t IotHttpsClient_ReleaseConnection( IotHttpsConnectionPoolHandle_t poolHandle,
+                                                       IotHttpsConnectionHandle_t connHandle );
+/* @[declare_https_client_releaseconnection] */
+
+/**
+ * @brief Close the idle connections of a connection pool and destroy the pool.
+ *
+ * All connections acquired from the pool must be released before calling this function. After it returns successfully,
+ * #IotHttpsConnectionPoolInfo_t.userBuffer may be freed or reused.
+ *
+ * @param[in] poolHandle - Valid handle representing a connection pool.
+ *
+ * @return One of the following:
+ * - #IOT_HTTPS_OK if the pool was destroyed.
+ * - #IOT_HTTPS_INVALID_PARAMETER if NULL parameters were passed in.
+ * - #IOT_HTTPS_BUSY if a connection of the pool is still acquired.
+ */
+/* @[declare_https_client_destroyconnectionpool] */
+IotHttpsReturnCode_t IotHttpsClient_DestroyConnectionPool( IotHttpsConnectionPoolHandle_t poolHandle );
+/* @[declare_https_client_destroyconnectionpool] */
+
 /**
  * @brief Initializes the request by adding a formatted Request-Line to the start of HTTPS request header buffer.
  *
@@ -57,6 +57,10 @@
  *   @copybrief responseUserBufferMinimumSize
  * - @ref connectionUserBufferMinimumSize <br>
  *   @copybrief connectionUserBufferMinimumSize
+ * - @ref connectionPoolUserBufferMinimumSize <br>
+ *   @copybrief connectionPoolUserBufferMinimumSize
+ * - @ref connectionPoolUserBufferSizePerConnection <br>
+ *   @copybrief connectionPoolUserBufferSizePerConnection
  *
  * @section https_connection_flags HTTPS Client Connection Flags
  * @brief Flags that modify the behavior of the HTTPS Connection.
@@ -88,6 +92,8 @@
  * IotHttpsConnectionInfo_t connInfo = IOT_HTTPS_CONNECTION_INFO_INITIALIZER;
  * IotHttpsRequestInfo_t reqInfo = IOT_HTTPS_REQUEST_INFO_INITIALIZER
  * IotHttpsResponseInfo_t respInfo = IOT_HTTPS_RESPONSE_INFO_INITIALIZER
+ * IotHttpsConnectionPoolHandle_t poolHandle = IOT_HTTPS_CONNECTION_POOL_HANDLE_INITIALIZER;
+ * IotHttpsConnectionPoolInfo_t poolInfo = IOT_HTTPS_CONNECTION_POOL_INFO_INITIALIZER;
  * @endcode
  *
  * @section http_constants_connection_flags HTTPS Client Connection Flags
@@ -96,6 +102,8 @@
  *   @copybrief IOT_HTTPS_IS_NON_TLS_FLAG
  * - #IOT_HTTPS_DISABLE_SNI <br>
  *   @copybrief IOT_HTTPS_DISABLE_SNI
+ * - #IOT_HTTPS_ENABLE_PIPELINING <br>
+ *   @copybrief IOT_HTTPS_ENABLE_PIPELINING
  */
 
 /**
@@ -169,13 +177,42 @@ extern const uint32_t responseUserBufferMinimumSize;
  */
 extern const uint32_t connectionUserBufferMinimumSize;
 
+/**
+ * @brief The minimum user buffer size for the HTTP connection pool context.
+ *
+ * This helps to calculate the size of the buffer needed for #IotHttpsConnectionPoolInfo_t.userBuffer.
+ *
+ * A pool user buffer of this size fits the pool context only and holds no connections. Each connection in the pool
+ * needs another #connectionPoolUserBufferSizePerConnection bytes plus #IotHttpsConnectionPoolInfo_t.connectionBufferLen
+ * rounded up to a multiple of 8 bytes. See the example below for a pool of four connections.
+ * @code{c}
+ * #define CONN_BUFFER_LEN    ( 512 )
+ * uint32_t poolUserBufferLen = connectionPoolUserBufferMinimumSize +
+ *                              4 * ( connectionPoolUserBufferSizePerConnection + CONN_BUFFER_LEN );
+ * IotHttpsConnectionPoolInfo_t poolInfo = IOT_HTTPS_CONNECTION_POOL_INFO_INITIALIZER;
+ * poolInfo.userBuffer.pBuffer = ( uint8_t * ) malloc( poolUserBufferLen );
+ * poolInfo.userBuffer.bufferLen = poolUserBufferLen;
+ * poolInfo.connectionBufferLen = CONN_BUFFER_LEN;
+ * @endcode
+ */
+extern const uint32_t connectionPoolUserBufferMinimumSize;
+
+/**
+ * @brief The user buffer size for each connection of an HTTP connection pool, not counting its connection user buffer.
+ *
+ * This holds the state of the pooled connection and a copy of its host name and ALPN protocols, so it grows with
+ * @ref IOT_HTTPS_MAX_HOST_NAME_LENGTH and @ref IOT_HTTPS_MAX_ALPN_PROTOCOLS_LENGTH.
+ * See #connectionPoolUserBufferMinimumSize for sizing #IotHttpsConnectionPoolInfo_t.userBuffer.
+ */
+extern const uint32_t connectionPoolUserBufferSizePerConnection;
+
 /**
  * @brief Flag for #IotHttpsConnectionInfo_t that disables TLS.
  *
  * Set this bit in #IotHttpsConnectionInfo_t.flags to disable use of TLS when the connection is created. This library
  * creates secure connections by default.
  */
-#define IOT_HTTPS_IS_NON_TLS_FLAG    ( 0x00000001 )
+#define IOT_HTTPS_IS_NON_TLS_FLAG      ( 0x00000001 )
 
 /**
  * @brief Flag for #IotHttpsConnectionInfo_t that disables Server Name Indication (SNI).
@@ -183,27 +220,46 @@ extern const uint32_t connectionUserBufferMinimumSize;
  * Set this bit  #IotHttpsConnectionInfo_t.flags to disable SNI. SNI is enabled by default in this library. When SNI is
  * enabled  #IotHttpsConnectionInfo_t.pAddress will be used for the server name verification.
  */
-#define IOT_HTTPS_DISABLE_SNI        ( 0x00000008 )
+#define IOT_HTTPS_DISABLE_SNI          ( 0x00000008 )
+
+/**
+ * @brief Flag for #IotHttpsConnectionInfo_t that enables HTTP/1.1 request pipelining.
+ *
+ * Set this bit in #IotHttpsConnectionInfo_t.flags to have up to #IOT_HTTPS_MAX_PIPELINED_REQUESTS queued requests
+ * written back-to-back on the connection without waiting for each response. Responses are still matched to requests
+ * in the order they were sent. Pipelining is disabled by default.
+ *
+ * Bytes of the next response that are received together with the end of the current response are kept in the part of
+ * #IotHttpsConnectionInfo_t.userBuffer beyond #connectionUserBufferMinimumSize. That part should be at least as large
+ * as the largest response header or body buffer used on the connection; if the extra bytes do not fit, the connection
+ * is closed. Only idempotent requests should be pipelined, because every outstanding request fails with
+ * #IOT_HTTPS_RECEIVE_ABORT or #IOT_HTTPS_SEND_ABORT if the connection closes.
+ */
+#define IOT_HTTPS_ENABLE_PIPELINING    ( 0x00000010 )
 
 /* @[define_https_initializers] */
 /** @brief Initializer for #IotHttpsConnectionHandle_t. */
-#define IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER    NULL
+#define IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER         NULL
 /** @brief Initializer for #IotHttpsRequestHandle_t. */
-#define IOT_HTTPS_REQUEST_HANDLE_INITIALIZER       NULL
+#define IOT_HTTPS_REQUEST_HANDLE_INITIALIZER            NULL
 /** @brief Initializer for #IotHttpsResponseHandle_t. */
-#define IOT_HTTPS_RESPONSE_HANDLE_INITIALIZER      NULL
+#define IOT_HTTPS_RESPONSE_HANDLE_INITIALIZER           NULL
 /** @brief Initializer for #IotHttpsUserBuffer_t. */
-#define IOT_HTTPS_USER_BUFFER_INITIALIZER          { 0 }
+#define IOT_HTTPS_USER_BUFFER_INITIALIZER               { 0 }
 /** @brief Initializer for #IotHttpsSyncInfo_t. */
-#define IOT_HTTPS_SYNC_INFO_INITIALIZER            { 0 }
+#define IOT_HTTPS_SYNC_INFO_INITIALIZER                 { 0 }
 /** @brief Initializer for #IotHttpsAsyncInfo_t. */
-#define IOT_HTTPS_ASYNC_INFO_INITIALIZER           { 0 }
+#define IOT_HTTPS_ASYNC_INFO_INITIALIZER                { 0 }
 /** @brief Initializer for #IotHttpsConnectionInfo_t. */
-#define IOT_HTTPS_CONNECTION_INFO_INITIALIZER      { 0 }
+#define IOT_HTTPS_CONNECTION_INFO_INITIALIZER           { 0 }
 /** @brief Initializer for #IotHttpsRequestInfo_t. */
-#define IOT_HTTPS_REQUEST_INFO_INITIALIZER         { 0 }
+#define IOT_HTTPS_REQUEST_INFO_INITIALIZER              { 0 }
 /** @brief Initializer for #IotHttpsResponseInfo_t. */
-#define IOT_HTTPS_RESPONSE_INFO_INITIALIZER        { 0 }
+#define IOT_HTTPS_RESPONSE_INFO_INITIALIZER             { 0 }
+/** @brief Initializer for #IotHttpsConnectionPoolHandle_t. */
+#define IOT_HTTPS_CONNECTION_POOL_HANDLE_INITIALIZER    NULL
+/** @brief Initializer for #IotHttpsConnectionPoolInfo_t. */
+#define IOT_HTTPS_CONNECTION_POOL_INFO_INITIALIZER      { 0 }
 /* @[define_https_initializers] */
 
 /* Network include for the network types below. */
@@ -245,7 +301,7 @@ extern const uint32_t connectionUserBufferMinimumSize;
  * Multiple threads can call @ref https_client_function_sendasync or @ref https_client_function_sendsync with the same
  * connection handle.
  */
-typedef struct _httpsConnection   * IotHttpsConnectionHandle_t;
+typedef struct _httpsConnection     * IotHttpsConnectionHandle_t;
 
 /**
  * @ingroup https_client_datatypes_handles
@@ -260,7 +316,7 @@ typedef struct _httpsConnection   * IotHttpsConnectionHandle_t;
  *
  * A request handle is not thread safe. Multiple threads cannot write headers to the same request handle.
  */
-typedef struct _httpsRequest      * IotHttpsRequestHandle_t;
+typedef struct _httpsRequest        * IotHttpsRequestHandle_t;
 
 /**
  * @ingroup https_client_datatypes_handles
@@ -277,7 +333,21 @@ typedef struct _httpsRequest      * IotHttpsRequestHandle_t;
  *
  * A response handle is not thread safe. Multiple threads cannot read the headers in a response at the same time.
  */
-typedef struct _httpsResponse     * IotHttpsResponseHandle_t;
+typedef struct _httpsResponse       * IotHttpsResponseHandle_t;
+
+/**
+ * @ingroup https_client_datatypes_handles
+ * @brief Opaque handle of a pool of HTTP connections.
+ *
+ * A connection pool keeps connections open after the application releases them, so that the next request to the same
+ * server does not need a new TCP connection and TLS handshake. This handle is valid after a successful call to
+ * @ref https_client_function_createconnectionpool. A variable of this type is passed to
+ * @ref https_client_function_acquireconnection, @ref https_client_function_releaseconnection, and
+ * @ref https_client_function_destroyconnectionpool.
+ *
+ * Multiple threads can acquire and release connections with the same connection pool handle.
+ */
+typedef struct _httpsConnectionPool * IotHttpsConnectionPoolHandle_t;
 
 /*-------------------------- HTTPS enumerated types --------------------------*/
 
@@ -902,4 +972,56 @@ typedef struct IotHttpsResponseInfo
     IotHttpsSyncInfo_t * pSyncInfo;
 } IotHttpsResponseInfo_t;
 
+/**
+ * @ingroup https_client_datatypes_paramstructs
+ * @brief HTTP connection pool configuration.
+ *
+ * @paramfor @ref https_client_function_createconnectionpool
+ */
+typedef struct IotHttpsConnectionPoolInfo
+{
+    /**
+     * @brief Application owned buffer for storing the pool context and the connection contexts of the pool.
+     *
+     * The number of connections the pool can hold is set by the size of this buffer. See
+     * #connectionPoolUserBufferMinimumSize for how to size it. The buffer must not be modified, freed, or reused until
+     * @ref https_client_function_destroyconnectionpool returns successfully.
+     */
+    IotHttpsUserBuffer_t userBuffer;
+
+    /**
+     * @brief The size of the connection user buffer of each connection in the pool.
+     *
+     * This replaces #IotHttpsConnectionInfo_t.userBuffer for pooled connections. It must be at least
+     * #connectionUserBufferMinimumSize, and larger for connections with #IOT_HTTPS_ENABLE_PIPELINING.
+     */
+    uint32_t connectionBufferLen;
+
+    /**
+     * @brief The maximum number of connections kept open while not acquired.
+     *
+     * A connection released when this many are idle already is closed. If this is set to zero, then every connection
+     * released is kept open.
+     */
+    uint32_t maxIdleConnections;
+
+    /**
+     * @brief The maximum number of connections to the same server, whether acquired or idle.
+     *
+     * When this many connections to the server are acquired, @ref https_client_function_acquireconnection returns
+     * #IOT_HTTPS_BUSY right away instead of waiting for one to be released. The application may acquire again after
+     * releasing a connection to the server. If this is set to zero, then any number of the connections in the pool can
+     * be to the same server.
+     */
+    uint32_t maxConnectionsPerHost;
+
+    /**
+     * @brief Time in milliseconds after which an idle connection is not used again.
+     *
+     * Many web servers close a connection after 30-60 seconds without requests. A connection idle for longer than this
+     * is closed and connected again when it is acquired. If this is set to zero, then idle connections do not expire.
+     */
+    uint32_t idleTimeoutMs;
+} IotHttpsConnectionPoolInfo_t;
+
 #endif /* ifndef IOT_HTTPS_TYPES_H_ */
@@ -125,6 +125,19 @@ const uint32_t responseUserBufferMinimumSize = sizeof( _httpsResponse_t );
  */
 const uint32_t connectionUserBufferMinimumSize = sizeof( _httpsConnection_t );
 
+/**
+ * @brief Minimum size of the connection pool user buffer.
+ *
+ * The connection pool user buffer is configured in IotHttpsConnectionPoolInfo_t.userBuffer. This buffer stores the
+ * internal context of the pool, then the entry and the connection user buffer of each pooled connection.
+ */
+const uint32_t connectionPoolUserBufferMinimumSize = sizeof( _httpsConnectionPool_t );
+
+/**
+ * @brief Size of the connection pool user buffer needed for each pooled connection, besides its connection user buffer.
+ */
+const uint32_t connectionPoolUserBufferSizePerConnection = sizeof( _httpsPoolEntry_t );
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -286,6 +299,61 @@ static int _httpParserOnMessageCompleteCallback( http_parser * pHttpParser );
     static int _httpParserOnChunkCompleteCallback( http_parser * pHttpParser );
 #endif
 
+#if IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE > 0
+
+/**
+ * @brief Continue the FNV-1a hash of a header field name with the next part of the name.
+ *
+ * @param[in] hash - The hash of the previous parts of the name, or #HTTPS_HEADER_INDEX_HASH_OFFSET_BASIS to start.
+ * @param[in] pBuf - The next part of the header field name.
+ * @param[in] length - The length of pBuf.
+ *
+ * @return The hash of the name up to and including pBuf.
+ */
+    static uint32_t _headerIndexHash( uint32_t hash,
+                                      const char * pBuf,
+                                      size_t length );
+
+/**
+ * @brief Add the header field name, or the next part of it, found while filling the header buffer to the header index.
+ *
+ * @param[in] pHttpsResponse - HTTPS response context.
+ * @param[in] pLoc - The header field name, or the next part of it, in the header buffer.
+ * @param[in] length - The length of the header field name part.
+ */
+    static void _headerIndexAddField( _httpsResponse_t * pHttpsResponse,
+                                      const char * pLoc,
+                                      size_t length );
+
+/**
+ * @brief Add the header value, or the next part of it, found while filling the header buffer to the header index.
+ *
+ * @param[in] pHttpsResponse - HTTPS response context.
+ * @param[in] pLoc - The header value, or the next part of it, in the header buffer.
+ * @param[in] length - The length of the header value part.
+ */
+    static void _headerIndexAddValue( _httpsResponse_t * pHttpsResponse,
+                                      const char * pLoc,
+                                      size_t length );
+
+/**
+ * @brief Search the header index of the response for a header.
+ *
+ * If the header is found, then foundHeaderField, pReadHeaderValue, and readHeaderValueLength are set in the response
+ * context the same way as the http-parser callbacks set them while searching the header buffer.
+ *
+ * @param[in] pHttpsResponse - HTTPS response context.
+ * @param[in] pName - The header field name to search for.
+ * @param[in] nameLen - The length of pName.
+ *
+ * @return true if the header index holds all of the response headers, so the search result is final.
+ *         false if the header buffer must be parsed to search for the header.
+ */
+    static bool _headerIndexSearch( _httpsResponse_t * pHttpsResponse,
+                                    const char * pName,
+                                    size_t nameLen );
+#endif /* if IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE > 0 */
+
 /**
  * @brief Network receive callback for the HTTPS Client library.
  *
@@ -629,6 +697,108 @@ static void _incrementNextLocationToWriteBeyondParsed( uint8_t ** pBufCur,
 static IotHttpsReturnCode_t _sendHttpsHeadersAndBody( _httpsConnection_t * pHttpsConnection,
                                                       _httpsRequest_t * pHttpsRequest );
 
+/**
+ * @brief Check if another request can be sent on the connection before the outstanding responses are received.
+ *
+ * This must be called with _httpsConnection_t.connectionMutex locked.
+ *
+ * @param[in] pHttpsConnection - HTTPS connection context.
+ *
+ * @return true if fewer than _httpsConnection_t.maxOutstandingResponses responses are outstanding and the last request
+ * sent did not ask the server to close the connection, false otherwise.
+ */
+static bool _isResponseSlotAvailable( _httpsConnection_t * pHttpsConnection );
+
+/**
+ * @brief Schedule the request at the head of the connection's request queue if the connection can take it.
+ *
+ * The request is scheduled if it is not scheduled yet, the connection is connected, and fewer than
+ * _httpsConnection_t.maxOutstandingResponses responses are outstanding. A request is never pipelined behind a
+ * non-persistent request. Scheduling errors are reported to the request's application.
+ *
+ * @param[in] pHttpsConnection - HTTPS connection context.
+ */
+static void _scheduleNextHttpsRequest( _httpsConnection_t * pHttpsConnection );
+
+/**
+ * @brief Keep the bytes received past the end of a response for the next pipelined response.
+ *
+ * The bytes are put in front of any bytes already kept. Nothing is kept if pipelining is not enabled on the connection.
+ * If the bytes do not fit in the spare connection user buffer, then _httpsConnection_t.pipelineDataLost is set
+ * because the next response cannot be found anymore and the connection must be closed once the current response is
+ * finished.
+ *
+ * @param[in] pHttpsConnection - HTTPS connection context. This may be NULL.
+ * @param[in] pData - The bytes that belong to the next response.
+ * @param[in] dataLen - The number of bytes in pData.
+ */
+static void _savePipelinedData( _httpsConnection_t * pHttpsConnection,
+                                const uint8_t * pData,
+                                size_t dataLen );
+
+/**
+ * @brief Wait for the request of a pipelined response to be marked as finished sending.
+ *
+ * @param[in] pHttpsConnection - HTTPS connection context.
+ * @param[in] pHttpsResponse - The response at the head of the response queue.
+ *
+ * @return true if the request finished sending within the connection timeout, false otherwise.
+ */
+static bool _waitForPipelinedRequestSent( _httpsConnection_t * pHttpsConnection,
+                                          _httpsResponse_t * pHttpsResponse );
+
+/**
+ * @brief Fail every request and response still queued on a pipelined connection that is about to close.
+ *
+ * Without #IOT_HTTPS_ENABLE_PIPELINING at most one request is outstanding, so there is nothing to abort and the queued
+ * requests are left for the application to cancel or send again after reconnecting.
+ *
+ * Responses to requests that were already sent complete with #IOT_HTTPS_RECEIVE_ABORT and requests that were not
+ * scheduled yet complete with #IOT_HTTPS_SEND_ABORT. A request that is being sent, or is scheduled to be sent, is left
+ * alone because _sendHttpsRequest() reports its own failure.
+ *
+ * @param[in] pHttpsConnection - HTTPS connection context.
+ * @param[in] pCurrentHttpsResponse - The response that is reporting the error itself. This may be NULL.
+ */
+static void _abortPendingHttpsRequests( _httpsConnection_t * pHttpsConnection,
+                                        _httpsResponse_t * pCurrentHttpsResponse );
+
+/**
+ * @brief Check if a pooled connection is to the server in the connection configuration.
+ *
+ * @param[in] pEntry - Pool entry of the connection.
+ * @param[in] pConnInfo - The connection configuration passed to IotHttpsClient_AcquireConnection().
+ *
+ * @return true if the connection has the same host, port, ALPN protocols, flags, and network interface.
+ *         false otherwise.
+ */
+static bool _poolEntryMatches( _httpsPoolEntry_t * pEntry,
+                               IotHttpsConnectionInfo_t * pConnInfo );
+
+/**
+ * @brief Check that an idle pooled connection can be used again without connecting.
+ *
+ * @param[in] pHttpsConnectionPool - Connection pool of the connection.
+ * @param[in] pEntry - Pool entry of an idle connection.
+ * @param[in] nowMs - The current time.
+ *
+ * @return true if the connection is still open, has no requests queued, and has not been idle for too long.
+ *         false otherwise.
+ */
+static bool _isPooledConnectionHealthy( _httpsConnectionPool_t * pHttpsConnectionPool,
+                                        _httpsPoolEntry_t * pEntry,
+                                        uint64_t nowMs );
+
+/**
+ * @brief Close a pooled connection and free its resources so that its entry can hold another connection.
+ *
+ * @param[in] pEntry - Pool entry of the connection.
+ *
+ * @return #IOT_HTTPS_OK if the connection was closed.
+ *         #IOT_HTTPS_BUSY if the connection is in use, see IotHttpsClient_Disconnect().
+ */
+static IotHttpsReturnCode_t _closePooledConnection( _httpsPoolEntry_t * pEntry );
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -693,6 +863,9 @@ static int _httpParserOnHeaderFieldCallback( http_parser * pHttpParser,
      * pHttpsResponse->pHeadersCur. */
     if( pHttpsResponse->bufferProcessingState == PROCESSING_STATE_FILLING_HEADER_BUFFER )
     {
+        #if IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE > 0
+            _headerIndexAddField( pHttpsResponse, pLoc, length );
+        #endif
         pHttpsResponse->pHeadersCur = ( uint8_t * ) ( pLoc += length );
     }
 
@@ -727,6 +900,9 @@ static int _httpParserOnHeaderValueCallback( http_parser * pHttpParser,
      * pHttpsResponse->pHeadersCur. */
     if( pHttpsResponse->bufferProcessingState == PROCESSING_STATE_FILLING_HEADER_BUFFER )
     {
+        #if IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE > 0
+            _headerIndexAddValue( pHttpsResponse, pLoc, length );
+        #endif
         pHttpsResponse->pHeadersCur = ( uint8_t * ) ( pLoc += length );
     }
 
@@ -768,6 +944,12 @@ static int _httpParserOnHeadersCompleteCallback( http_parser * pHttpParser )
     if( pHttpsResponse->bufferProcessingState == PROCESSING_STATE_FILLING_HEADER_BUFFER )
     {
         pHttpsResponse->pHeadersCur += ( 2 * HTTPS_END_OF_HEADER_LINES_INDICATOR_LENGTH );
+
+        /* All of the headers are in the header buffer. If they all fit in the header index too, then
+         * IotHttpsClient_ReadHeader() can search the index instead of parsing the header buffer again. */
+        #if IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE > 0
+            pHttpsResponse->headerIndexComplete = ( pHttpsResponse->headerIndexOverflow == false );
+        #endif
     }
 
     /* This if-case is not incrementing any pHeaderCur pointers, so this case is safe to call when flushing the
@@ -934,6 +1116,147 @@ static int _httpParserOnMessageCompleteCallback( http_parser * pHttpParser )
 
 /*-----------------------------------------------------------*/
 
+#if IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE > 0
+    static uint32_t _headerIndexHash( uint32_t hash,
+                                      const char * pBuf,
+                                      size_t length )
+    {
+        size_t i = 0;
+
+        for( i = 0; i < length; i++ )
+        {
+            hash ^= ( uint32_t ) ( ( uint8_t ) pBuf[ i ] );
+            hash *= HTTPS_HEADER_INDEX_HASH_PRIME;
+        }
+
+        return hash;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void _headerIndexAddField( _httpsResponse_t * pHttpsResponse,
+                                      const char * pLoc,
+                                      size_t length )
+    {
+        _httpsHeaderIndexEntry_t * pEntry = NULL;
+        size_t offset = ( size_t ) ( ( const uint8_t * ) pLoc - pHttpsResponse->pHeaders );
+
+        if( pHttpsResponse->headerIndexOverflow == false )
+        {
+            if( ( pHttpsResponse->headerIndexCount > 0 ) && ( pHttpsResponse->headerIndexInValue == false ) )
+            {
+                /* The previous network receive ended in the middle of this header field name. The rest of the name
+                 * was received right after it in the header buffer. */
+                pEntry = &( pHttpsResponse->headerIndex[ pHttpsResponse->headerIndexCount - 1 ] );
+            }
+            else if( pHttpsResponse->headerIndexCount < IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE )
+            {
+                pEntry = &( pHttpsResponse->headerIndex[ pHttpsResponse->headerIndexCount ] );
+                pHttpsResponse->headerIndexCount++;
+
+                pEntry->fieldHash = HTTPS_HEADER_INDEX_HASH_OFFSET_BASIS;
+                pEntry->fieldOffset = ( uint16_t ) offset;
+                pEntry->fieldLength = 0;
+                pEntry->valueOffset = 0;
+                pEntry->valueLength = 0;
+            }
+            else
+            {
+                IotLogDebug( "The response has more than %d headers. Reading the rest of the headers will parse "
+                             "the header buffer.", IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE );
+                pHttpsResponse->headerIndexOverflow = true;
+            }
+
+            /* The offsets are stored in 16 bits. A header buffer larger than this is not expected, but if it is then
+             * the headers beyond 64 KB are found by parsing the header buffer. */
+            if( ( pEntry != NULL ) && ( ( offset + length ) > UINT16_MAX ) )
+            {
+                pHttpsResponse->headerIndexOverflow = true;
+            }
+            else if( pEntry != NULL )
+            {
+                pEntry->fieldLength = ( uint16_t ) ( offset + length - pEntry->fieldOffset );
+                pEntry->fieldHash = _headerIndexHash( pEntry->fieldHash, pLoc, length );
+            }
+        }
+
+        pHttpsResponse->headerIndexInValue = false;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static void _headerIndexAddValue( _httpsResponse_t * pHttpsResponse,
+                                      const char * pLoc,
+                                      size_t length )
+    {
+        _httpsHeaderIndexEntry_t * pEntry = NULL;
+        size_t offset = ( size_t ) ( ( const uint8_t * ) pLoc - pHttpsResponse->pHeaders );
+
+        if( ( pHttpsResponse->headerIndexOverflow == false ) && ( pHttpsResponse->headerIndexCount > 0 ) )
+        {
+            pEntry = &( pHttpsResponse->headerIndex[ pHttpsResponse->headerIndexCount - 1 ] );
+
+            if( ( offset + length ) > UINT16_MAX )
+            {
+                pHttpsResponse->headerIndexOverflow = true;
+            }
+            else
+            {
+                /* If the previous network receive ended in the middle of this header value, then the rest of the
+                 * value was received right after it in the header buffer. */
+                if( pHttpsResponse->headerIndexInValue == false )
+                {
+                    pEntry->valueOffset = ( uint16_t ) offset;
+                }
+
+                pEntry->valueLength = ( uint16_t ) ( offset + length - pEntry->valueOffset );
+            }
+        }
+
+        pHttpsResponse->headerIndexInValue = true;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static bool _headerIndexSearch( _httpsResponse_t * pHttpsResponse,
+                                    const char * pName,
+                                    size_t nameLen )
+    {
+        bool indexSearched = false;
+        uint32_t nameHash = 0;
+        uint8_t i = 0;
+        const _httpsHeaderIndexEntry_t * pEntry = NULL;
+
+        if( pHttpsResponse->headerIndexComplete )
+        {
+            indexSearched = true;
+            nameHash = _headerIndexHash( HTTPS_HEADER_INDEX_HASH_OFFSET_BASIS, pName, nameLen );
+
+            /* The first header in the response with this name is returned, as when parsing the header buffer. A header
+             * without a value is skipped. */
+            for( i = 0; i < pHttpsResponse->headerIndexCount; i++ )
+            {
+                pEntry = &( pHttpsResponse->headerIndex[ i ] );
+
+                if( ( pEntry->fieldHash == nameHash ) &&
+                    ( pEntry->fieldLength == nameLen ) &&
+                    ( pEntry->valueOffset != 0 ) &&
+                    ( strncmp( ( const char * ) ( pHttpsResponse->pHeaders + pEntry->fieldOffset ), pName, nameLen ) == 0 ) )
+                {
+                    pHttpsResponse->foundHeaderField = true;
+                    pHttpsResponse->pReadHeaderValue = ( char * ) ( pHttpsResponse->pHeaders + pEntry->valueOffset );
+                    pHttpsResponse->readHeaderValueLength = pEntry->valueLength;
+                    break;
+                }
+            }
+        }
+
+        return indexSearched;
+    }
+#endif /* if IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE > 0 */
+
+/*-----------------------------------------------------------*/
+
 static IotHttpsReturnCode_t _receiveHttpsBodyAsync( _httpsResponse_t * pHttpsResponse )
 {
     HTTPS_FUNCTION_ENTRY( IOT_HTTPS_OK );
@@ -1044,10 +1367,8 @@ static void _networkReceiveCallback( void * pNetworkConnection,
 
     IotHttpsReturnCode_t flushStatus = IOT_HTTPS_OK;
     IotHttpsReturnCode_t disconnectStatus = IOT_HTTPS_OK;
-    IotHttpsReturnCode_t scheduleStatus = IOT_HTTPS_OK;
     _httpsConnection_t * pHttpsConnection = ( _httpsConnection_t * ) pReceiveContext;
     _httpsResponse_t * pCurrentHttpsResponse = NULL;
-    _httpsRequest_t * pNextHttpsRequest = NULL;
     IotLink_t * pQItem = NULL;
     bool fatalDisconnect = false;
 
@@ -1072,8 +1393,10 @@ static void _networkReceiveCallback( void * pNetworkConnection,
     pCurrentHttpsResponse = IotLink_Container( _httpsResponse_t, pQItem, link );
 
     /* If the receive callback has invoked, but the request associated with this response has not finished sending
-     * to the server, then this is a violation of the HTTP/1.1 protocol.  */
-    if( pCurrentHttpsResponse->reqFinishedSending == false )
+     * to the server, then this is a violation of the HTTP/1.1 protocol. A pipelined request may be answered before
+     * the worker sending it gets to mark it finished, so that case is given until the connection timeout. */
+    if( ( pCurrentHttpsResponse->reqFinishedSending == false ) &&
+        ( _waitForPipelinedRequestSent( pHttpsConnection, pCurrentHttpsResponse ) == false ) )
     {
         IotLogError( "Received response data on the network when the request was not finished sending. This is unexpected." );
         fatalDisconnect = true;
@@ -1113,7 +1436,8 @@ static void _networkReceiveCallback( void * pNetworkConnection,
              * we ask for the full size of the receive buffer. Therefore, the only error that can be returned from receiving
              * the headers or body is a timeout. We always disconnect from the network when there is a timeout because the
              * server may be slow to respond. If the server happens to send the response later at the same time another response
-             * is waiting in the queue, then the workflow is corrupted. Pipelining is not current supported in this library. */
+             * is waiting in the queue, then the workflow is corrupted. Pipelined responses queued behind this one are
+             * aborted when disconnecting. */
             IotLogError( "Network error receiving the HTTPS headers for response %d. Error code: %d",
                          pCurrentHttpsResponse,
                          status );
@@ -1190,6 +1514,7 @@ static void _networkReceiveCallback( void * pNetworkConnection,
     if( fatalDisconnect && !pCurrentHttpsResponse )
     {
         IotLogError( "An out-of-order response was received. The connection will be disconnected." );
+        _abortPendingHttpsRequests( pHttpsConnection, NULL );
         disconnectStatus = IotHttpsClient_Disconnect( pHttpsConnection );
 
         if( HTTPS_FAILED( disconnectStatus ) )
@@ -1215,24 +1540,7 @@ static void _networkReceiveCallback( void * pNetworkConnection,
     /* If this is not a persistent request, the server would have closed it after sending a response, but we
      * disconnect anyways. If we are disconnecting there is is no point in wasting time
      * flushing the network. If the network is being disconnected we also do not schedule any pending requests. */
-    if( fatalDisconnect || pCurrentHttpsResponse->isNonPersistent )
-    {
-        IotLogDebug( "Disconnecting response %d.", pCurrentHttpsResponse );
-        disconnectStatus = IotHttpsClient_Disconnect( pHttpsConnection );
-
-        if( ( pCurrentHttpsResponse != NULL ) && pCurrentHttpsResponse->isAsync && pCurrentHttpsResponse->pCallbacks->connectionClosedCallback )
-        {
-            pCurrentHttpsResponse->pCallbacks->connectionClosedCallback( pCurrentHttpsResponse->pUserPrivData, pHttpsConnection, disconnectStatus );
-        }
-
-        if( HTTPS_FAILED( disconnectStatus ) )
-        {
-            IotLogWarn( "Failed to disconnect response %d. Error code: %d.", pCurrentHttpsResponse, disconnectStatus );
-        }
-
-        /* If we disconnect, we do not process anymore requests. */
-    }
-    else
+    if( ( fatalDisconnect == false ) && ( pCurrentHttpsResponse->isNonPersistent == false ) )
     {
         /* Set the processing state of the buffer to finished for completeness. This is also to prevent the parsing of the flush
          * data from incrementing any pointer in the HTTP response context. */
@@ -1258,45 +1566,20 @@ static void _networkReceiveCallback( void * pNetworkConnection,
             IotLogDebug( "Network error when flushing the https network data: %d", flushStatus );
         }
 
-        IotMutex_Lock( &( pHttpsConnection->connectionMutex ) );
-        /* Get the next request to process. */
-        pQItem = IotDeQueue_PeekHead( &( pHttpsConnection->reqQ ) );
-        IotMutex_Unlock( &( pHttpsConnection->connectionMutex ) );
-
-        /* If there is a next request to process, then create a taskpool job to send the request. */
-        if( pQItem != NULL )
-        {
-            /* Set this next request to send. */
-            pNextHttpsRequest = IotLink_Container( _httpsRequest_t, pQItem, link );
-
-            if( pNextHttpsRequest->scheduled == false )
-            {
-                IotLogDebug( "Request %d is next in the queue. Now scheduling a task to send the request.", pNextHttpsRequest );
-                scheduleStatus = _scheduleHttpsRequestSend( pNextHttpsRequest );
-
-                /* If there was an error with scheduling the new task, then report it. */
-                if( HTTPS_FAILED( scheduleStatus ) )
-                {
-                    IotLogError( "Error scheduling HTTPS request %d. Error code: %d", pNextHttpsRequest, scheduleStatus );
-
-                    if( pNextHttpsRequest->isAsync && pNextHttpsRequest->pCallbacks->errorCallback )
-                    {
-                        pNextHttpsRequest->pCallbacks->errorCallback( pNextHttpsRequest->pUserPrivData, pNextHttpsRequest, NULL, scheduleStatus );
-                    }
-                    else
-                    {
-                        pNextHttpsRequest->pHttpsResponse->syncStatus = scheduleStatus;
-                    }
-                }
-            }
-        }
-        else
+        /* With pipelining the next response starts right after the end of this one. If the end was not found, or the
+         * start of the next response could not be kept, then the next response cannot be found and the connection must
+         * be closed. */
+        if( ( pHttpsConnection->maxOutstandingResponses > 1 ) &&
+            ( HTTPS_FAILED( flushStatus ) || pHttpsConnection->pipelineDataLost ) )
         {
-            IotLogDebug( "Network receive callback found the request queue empty. A network send task was not scheduled." );
+            IotLogError( "Lost the end of pipelined response %d. The connection will be disconnected.", pCurrentHttpsResponse );
+            fatalDisconnect = true;
         }
     }
 
-    /* Dequeue response from the response queue now that it is finished. */
+    /* Dequeue response from the response queue now that it is finished. This is done before the next request is
+     * scheduled: if that request is cancelled or fails before it is sent, the task pool worker schedules the request
+     * after it, which must not find this response still outstanding. */
     IotMutex_Lock( &( pHttpsConnection->connectionMutex ) );
 
     /* There could be a scenario where the request fails to send and the network server still responds,
@@ -1310,6 +1593,30 @@ static void _networkReceiveCallback( void * pNetworkConnection,
 
     IotMutex_Unlock( &( pHttpsConnection->connectionMutex ) );
 
+    if( fatalDisconnect || pCurrentHttpsResponse->isNonPersistent )
+    {
+        IotLogDebug( "Disconnecting response %d.", pCurrentHttpsResponse );
+        _abortPendingHttpsRequests( pHttpsConnection, pCurrentHttpsResponse );
+        disconnectStatus = IotHttpsClient_Disconnect( pHttpsConnection );
+
+        if( ( pCurrentHttpsResponse != NULL ) && pCurrentHttpsResponse->isAsync && pCurrentHttpsResponse->pCallbacks->connectionClosedCallback )
+        {
+            pCurrentHttpsResponse->pCallbacks->connectionClosedCallback( pCurrentHttpsResponse->pUserPrivData, pHttpsConnection, disconnectStatus );
+        }
+
+        if( HTTPS_FAILED( disconnectStatus ) )
+        {
+            IotLogWarn( "Failed to disconnect response %d. Error code: %d.", pCurrentHttpsResponse, disconnectStatus );
+        }
+
+        /* If we disconnect, we do not process anymore requests. */
+    }
+    else
+    {
+        /* Schedule the next request in the queue. */
+        _scheduleNextHttpsRequest( pHttpsConnection );
+    }
+
     /* The first if-case below notifies IotHttpsClient_SendSync() that the response is finished receiving. When
      * IotHttpsClient_SendSync() returns the user is allowed to modify the user buffer used for the response context.
      * In the asynchronous case, the responseCompleteCallback notifies the application that the user buffer used for the
@@ -1325,6 +1632,14 @@ static void _networkReceiveCallback( void * pNetworkConnection,
         /* Signal to a synchronous response that the response is complete. */
         pCurrentHttpsResponse->pCallbacks->responseCompleteCallback( pCurrentHttpsResponse->pUserPrivData, pCurrentHttpsResponse, status, pCurrentHttpsResponse->status );
     }
+
+    /* Part or all of the next pipelined response may have been received together with this one. The network layer
+     * does not invoke this callback again for data that was already read, so the next response is received now. The
+     * depth of this call is bounded by the number of responses outstanding on the connection. */
+    if( ( pHttpsConnection->pipelineDataLen > 0 ) && ( pHttpsConnection->isConnected ) )
+    {
+        _networkReceiveCallback( pNetworkConnection, pReceiveContext );
+    }
 }
 
 /*-----------------------------------------------------------*/
@@ -1344,6 +1659,7 @@ static IotHttpsReturnCode_t _createHttpsConnection( IotHttpsConnectionHandle_t *
      * This +1 is for the NULL terminator needed by IotNetworkServerInfo_t.pHostName. */
     char pHostName[ IOT_HTTPS_MAX_HOST_NAME_LENGTH + 1 ] = { 0 };
     bool connectionMutexCreated = false;
+    bool reqSentSemCreated = false;
     IotNetworkServerInfo_t networkServerInfo = { 0 };
     IotNetworkCredentials_t networkCredentials = { 0 };
     _httpsConnection_t * pHttpsConnection = NULL;
@@ -1387,6 +1703,25 @@ static IotHttpsReturnCode_t _createHttpsConnection( IotHttpsConnectionHandle_t *
     IotDeQueue_Create( &( pHttpsConnection->reqQ ) );
     IotDeQueue_Create( &( pHttpsConnection->respQ ) );
 
+    /* With pipelining, the rest of the user buffer after the connection context keeps the bytes of the next response
+     * that are received together with the end of the current response. */
+    if( ( pConnInfo->flags & IOT_HTTPS_ENABLE_PIPELINING ) != 0 )
+    {
+        pHttpsConnection->maxOutstandingResponses = IOT_HTTPS_MAX_PIPELINED_REQUESTS;
+        pHttpsConnection->pPipelineBuf = pConnInfo->userBuffer.pBuffer + connectionUserBufferMinimumSize;
+        pHttpsConnection->pipelineBufLen = pConnInfo->userBuffer.bufferLen - connectionUserBufferMinimumSize;
+    }
+    else
+    {
+        pHttpsConnection->maxOutstandingResponses = 1;
+        pHttpsConnection->pPipelineBuf = NULL;
+        pHttpsConnection->pipelineBufLen = 0;
+    }
+
+    pHttpsConnection->pPipelineData = pHttpsConnection->pPipelineBuf;
+    pHttpsConnection->pipelineDataLen = 0;
+    pHttpsConnection->pipelineDataLost = false;
+
     /* This timeout is used to wait for a response on the connection as well as
      * for the timeout for the connect operation. */
     if( pConnInfo->timeout == 0 )
@@ -1498,6 +1833,19 @@ static IotHttpsReturnCode_t _createHttpsConnection( IotHttpsConnectionHandle_t *
         HTTPS_SET_AND_GOTO_CLEANUP( IOT_HTTPS_INTERNAL_ERROR );
     }
 
+    if( pHttpsConnection->maxOutstandingResponses > 1 )
+    {
+        reqSentSemCreated = IotSemaphore_Create( &( pHttpsConnection->reqSentSem ),
+                                                 0 /* initialValue */,
+                                                 pHttpsConnection->maxOutstandingResponses /* maxValue */ );
+
+        if( !reqSentSemCreated )
+        {
+            IotLogError( "Failed to create an internal semaphore." );
+            HTTPS_SET_AND_GOTO_CLEANUP( IOT_HTTPS_INTERNAL_ERROR );
+        }
+    }
+
     /* Return the new connection information. */
     *pConnHandle = pHttpsConnection;
 
@@ -1518,6 +1866,11 @@ static IotHttpsReturnCode_t _createHttpsConnection( IotHttpsConnectionHandle_t *
             IotMutex_Destroy( &( pHttpsConnection->connectionMutex ) );
         }
 
+        if( reqSentSemCreated )
+        {
+            IotSemaphore_Destroy( &( pHttpsConnection->reqSentSem ) );
+        }
+
         /* Set the connection handle as NULL if everything failed. */
         *pConnHandle = NULL;
     }
@@ -1642,6 +1995,18 @@ static IotHttpsReturnCode_t _networkRecv( _httpsConnection_t * pHttpsConnection,
 {
     HTTPS_FUNCTION_ENTRY( IOT_HTTPS_OK );
 
+    /* Bytes of a pipelined response that were received together with the end of the previous response come first. */
+    if( pHttpsConnection->pipelineDataLen > 0 )
+    {
+        *numBytesRecv = ( bufLen < pHttpsConnection->pipelineDataLen ) ? bufLen : pHttpsConnection->pipelineDataLen;
+        memcpy( pBuf, pHttpsConnection->pPipelineData, *numBytesRecv );
+        pHttpsConnection->pPipelineData += *numBytesRecv;
+        pHttpsConnection->pipelineDataLen -= *numBytesRecv;
+
+        IotLogDebug( "Received %d bytes kept from the previous pipelined response.", *numBytesRecv );
+        HTTPS_GOTO_CLEANUP();
+    }
+
     /* The HTTP server could send the header and the body in two separate TCP packets. If that is the case, then
      * receiveUpTo will return return the full headers first. Then on a second call, the body will be returned.
      * If the http parser receives just the headers despite the content length being greater than  */
@@ -1779,6 +2144,7 @@ static IotHttpsReturnCode_t _parseHttpsMessage( _httpParserInfo_t * pHttpParserI
     size_t parsedBytes = 0;
     const char * pHttpParserErrorDescription = NULL;
     http_parser * pHttpParser = &( pHttpParserInfo->responseParser );
+    _httpsResponse_t * pHttpsResponse = ( _httpsResponse_t * ) ( pHttpParser->data );
 
     IotLogDebug( "Now parsing HTTP message buffer to process a response." );
     parsedBytes = pHttpParserInfo->parseFunc( pHttpParser, &_httpParserSettings, pBuf, len );
@@ -1801,6 +2167,12 @@ static IotHttpsReturnCode_t _parseHttpsMessage( _httpParserInfo_t * pHttpParserI
         HTTPS_SET_AND_GOTO_CLEANUP( IOT_HTTPS_PARSING_ERROR );
     }
 
+    /* The parser stops at the end of the message. Anything after that is the start of the next pipelined response. */
+    if( ( pHttpsResponse->parserState == PARSER_STATE_BODY_COMPLETE ) && ( parsedBytes < len ) )
+    {
+        _savePipelinedData( pHttpsResponse->pHttpsConnection, ( uint8_t * ) ( pBuf + parsedBytes ), len - parsedBytes );
+    }
+
     HTTPS_FUNCTION_EXIT_NO_CLEANUP();
 }
 
@@ -2110,9 +2482,6 @@ static void _sendHttpsRequest( IotTaskPool_t pTaskPool,
     _httpsConnection_t * pHttpsConnection = pHttpsRequest->pHttpsConnection;
     _httpsResponse_t * pHttpsResponse = pHttpsRequest->pHttpsResponse;
     IotHttpsReturnCode_t disconnectStatus = IOT_HTTPS_OK;
-    IotHttpsReturnCode_t scheduleStatus = IOT_HTTPS_OK;
-    IotLink_t * pQItem = NULL;
-    _httpsRequest_t * pNextHttpsRequest = NULL;
 
     ( void ) pTaskPool;
     ( void ) pJob;
@@ -2125,6 +2494,13 @@ static void _sendHttpsRequest( IotTaskPool_t pTaskPool,
         HTTPS_SET_AND_GOTO_CLEANUP( IOT_HTTPS_SEND_ABORT );
     }
 
+    /* A pipelined request can be scheduled right before an error on an earlier response closes the connection. */
+    if( pHttpsConnection->isConnected == false )
+    {
+        IotLogDebug( "Request ID: %d was scheduled on a connection that is now closed.", pHttpsRequest );
+        HTTPS_SET_AND_GOTO_CLEANUP( IOT_HTTPS_SEND_ABORT );
+    }
+
     /* To protect against out of order network data from a rouge server, signal that the request is
      * not finished sending. */
     pHttpsResponse->reqFinishedSending = false;
@@ -2193,6 +2569,12 @@ static void _sendHttpsRequest( IotTaskPool_t pTaskPool,
      * IotHttpsClient_Disconnect() know that the connection is not busy, so the connection can be destroyed. */
     pHttpsResponse->reqFinishedSending = true;
 
+    /* The network receive callback may already be waiting for this with the response of a pipelined request. */
+    if( pHttpsConnection->maxOutstandingResponses > 1 )
+    {
+        IotSemaphore_Post( &( pHttpsConnection->reqSentSem ) );
+    }
+
     if( HTTPS_FAILED( status ) )
     {
         /* If the headers or body failed to send, then there should be no response expected from the server. */
@@ -2222,6 +2604,7 @@ static void _sendHttpsRequest( IotTaskPool_t pTaskPool,
         if( status == IOT_HTTPS_NETWORK_ERROR )
         {
             IotLogDebug( "Disconnecting request %d.", pHttpsRequest );
+            _abortPendingHttpsRequests( pHttpsConnection, pHttpsResponse );
             disconnectStatus = IotHttpsClient_Disconnect( pHttpsConnection );
 
             if( pHttpsRequest->isAsync && pHttpsRequest->pCallbacks->connectionClosedCallback )
@@ -2236,53 +2619,35 @@ static void _sendHttpsRequest( IotTaskPool_t pTaskPool,
                 IotLogWarn( "Failed to disconnect request %d. Error code: %d.", pHttpsRequest, disconnectStatus );
             }
         }
-        else
-        {
-            /* Because this request failed, the network receive callback may never be invoked to schedule other possible
-             * requests in the queue. In order to avoid requests never getting scheduled on a connected connection,
-             * the first item in the queue is scheduled if it can be. */
-            IotMutex_Lock( &( pHttpsConnection->connectionMutex ) );
+    }
 
-            /* Get the next item in the queue by removing this current (which is the first) and peeking at the head
-             * again. */
-            IotDeQueue_Remove( &( pHttpsRequest->link ) );
-            pQItem = IotDeQueue_PeekHead( &( pHttpsConnection->reqQ ) );
-            /* This current request is put back because it is removed again for all cases at the end of this routine. */
-            IotDeQueue_EnqueueHead( &( pHttpsConnection->reqQ ), &( pHttpsRequest->link ) );
-            IotMutex_Unlock( &( pHttpsConnection->connectionMutex ) );
+    IotMutex_Lock( &( pHttpsConnection->connectionMutex ) );
 
-            if( pQItem != NULL )
-            {
-                /* Set this next request to send. */
-                pNextHttpsRequest = IotLink_Container( _httpsRequest_t, pQItem, link );
+    /* Now that the current request is finished, we remove the current request from the queue. It is the head of the
+     * queue unless a disconnect already emptied the queue. */
+    if( IotLink_IsLinked( &( pHttpsRequest->link ) ) )
+    {
+        IotDeQueue_Remove( &( pHttpsRequest->link ) );
+    }
 
-                if( pNextHttpsRequest->scheduled == false )
-                {
-                    IotLogDebug( "Request %d is next in the queue. Now scheduling a task to send the request.", pNextHttpsRequest );
-                    scheduleStatus = _scheduleHttpsRequestSend( pNextHttpsRequest );
-
-                    /* If there was an error with scheduling the new task, then report it. */
-                    if( HTTPS_FAILED( scheduleStatus ) )
-                    {
-                        IotLogError( "Error scheduling HTTPS request %d. Error code: %d", pNextHttpsRequest, scheduleStatus );
-
-                        if( pNextHttpsRequest->isAsync && pNextHttpsRequest->pCallbacks->errorCallback )
-                        {
-                            pNextHttpsRequest->pCallbacks->errorCallback( pNextHttpsRequest->pUserPrivData, pNextHttpsRequest, NULL, scheduleStatus );
-                        }
-                        else
-                        {
-                            pNextHttpsRequest->pHttpsResponse->syncStatus = scheduleStatus;
-                        }
-                    }
-                }
-            }
-        }
+    IotMutex_Unlock( &( pHttpsConnection->connectionMutex ) );
 
-        /* Post to the response finished semaphore to unlock the application waiting on a synchronous request. */
-        if( pHttpsRequest->isAsync == false )
-        {
-            IotSemaphore_Post( &( pHttpsResponse->respFinishedSem ) );
+    /* If this request failed, the network receive callback may never be invoked to schedule other possible requests
+     * in the queue, so the next request is scheduled here. The same is done if the response was received before this
+     * routine finished. With pipelining, the next request is sent right away while fewer than the maximum number of
+     * responses are outstanding. After a network error the connection is closed and nothing is scheduled. Like in the
+     * network receive callback, this is done before the application is told that the request is finished. */
+    if( status != IOT_HTTPS_NETWORK_ERROR )
+    {
+        _scheduleNextHttpsRequest( pHttpsConnection );
+    }
+
+    if( HTTPS_FAILED( status ) )
+    {
+        /* Post to the response finished semaphore to unlock the application waiting on a synchronous request. */
+        if( pHttpsRequest->isAsync == false )
+        {
+            IotSemaphore_Post( &( pHttpsResponse->respFinishedSem ) );
         }
         else if( pHttpsRequest->pCallbacks->responseCompleteCallback )
         {
@@ -2292,11 +2657,6 @@ static void _sendHttpsRequest( IotTaskPool_t pTaskPool,
         }
     }
 
-    IotMutex_Lock( &( pHttpsConnection->connectionMutex ) );
-    /* Now that the current request is finished, we dequeue the current request from the queue. */
-    IotDeQueue_DequeueHead( &( pHttpsConnection->reqQ ) );
-    IotMutex_Unlock( &( pHttpsConnection->connectionMutex ) );
-
     /* This routine returns a void so there is no HTTPS_FUNCTION_CLEANUP_END();. */
 }
 
@@ -2374,14 +2734,19 @@ IotHttpsReturnCode_t _addRequestToConnectionReqQ( _httpsRequest_t * pHttpsReques
     /* If there is an active response, scheduling the next request at the same time may corrupt the workflow. Part of
      * the next response for the next request may be present in the currently receiving response's buffers. To avoid
      * this, check if there are pending responses to determine if this request should be scheduled right away or not.
+     * With pipelining, responses for earlier requests may be pending up to the connection's maximum, because the
+     * bytes of the next response are kept for it.
      *
      * If there are other requests in the queue, and there are responses in the queue, then the network receive callback
      * will handle scheduling the next requests (or is already scheduled and currently sending). */
     if( ( IotDeQueue_IsEmpty( &( pHttpsConnection->reqQ ) ) ) &&
-        ( IotDeQueue_IsEmpty( &( pHttpsConnection->respQ ) ) ) )
+        ( _isResponseSlotAvailable( pHttpsConnection ) ) )
     {
-        IotLogDebug( "Both the request and response queue are empty, so schedule the request to run in the taskpool." );
+        IotLogDebug( "The request queue is empty and a response can be received, so schedule the request to run in the taskpool." );
         scheduleRequest = true;
+
+        /* Mark the request scheduled while the queues are locked so that no other context schedules it too. */
+        pHttpsRequest->scheduled = true;
     }
 
     /* Place into the connection's request to have a taskpool worker schedule to serve it later. */
@@ -2412,6 +2777,332 @@ IotHttpsReturnCode_t _addRequestToConnectionReqQ( _httpsRequest_t * pHttpsReques
 
 /*-----------------------------------------------------------*/
 
+static bool _isResponseSlotAvailable( _httpsConnection_t * pHttpsConnection )
+{
+    size_t outstandingResponses = IotDeQueue_Count( &( pHttpsConnection->respQ ) );
+    bool slotAvailable = false;
+    _httpsResponse_t * pLastHttpsResponse = NULL;
+
+    if( outstandingResponses < pHttpsConnection->maxOutstandingResponses )
+    {
+        slotAvailable = true;
+
+        /* The server closes the connection after responding to a non-persistent request, so nothing is pipelined
+         * behind one. */
+        if( outstandingResponses > 0 )
+        {
+            pLastHttpsResponse = IotLink_Container( _httpsResponse_t, IotDeQueue_PeekTail( &( pHttpsConnection->respQ ) ), link );
+            slotAvailable = ( pLastHttpsResponse->isNonPersistent == false );
+        }
+    }
+
+    return slotAvailable;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _scheduleNextHttpsRequest( _httpsConnection_t * pHttpsConnection )
+{
+    IotHttpsReturnCode_t scheduleStatus = IOT_HTTPS_OK;
+    IotLink_t * pQItem = NULL;
+    _httpsRequest_t * pNextHttpsRequest = NULL;
+
+    IotMutex_Lock( &( pHttpsConnection->connectionMutex ) );
+
+    /* Get the next request to process. It is claimed while the queues are locked because the network receive callback,
+     * the task pool worker that sent the previous request, and the application adding a request may all try to
+     * schedule it. */
+    pQItem = IotDeQueue_PeekHead( &( pHttpsConnection->reqQ ) );
+
+    if( pQItem != NULL )
+    {
+        pNextHttpsRequest = IotLink_Container( _httpsRequest_t, pQItem, link );
+
+        if( ( pNextHttpsRequest->scheduled == false ) &&
+            ( pHttpsConnection->isConnected ) &&
+            ( _isResponseSlotAvailable( pHttpsConnection ) ) )
+        {
+            pNextHttpsRequest->scheduled = true;
+        }
+        else
+        {
+            pNextHttpsRequest = NULL;
+        }
+    }
+
+    IotMutex_Unlock( &( pHttpsConnection->connectionMutex ) );
+
+    /* If there is a next request to process, then create a taskpool job to send the request. */
+    if( pNextHttpsRequest != NULL )
+    {
+        IotLogDebug( "Request %d is next in the queue. Now scheduling a task to send the request.", pNextHttpsRequest );
+        scheduleStatus = _scheduleHttpsRequestSend( pNextHttpsRequest );
+
+        /* If there was an error with scheduling the new task, then report it. */
+        if( HTTPS_FAILED( scheduleStatus ) )
+        {
+            IotLogError( "Error scheduling HTTPS request %d. Error code: %d", pNextHttpsRequest, scheduleStatus );
+
+            if( pNextHttpsRequest->isAsync && pNextHttpsRequest->pCallbacks->errorCallback )
+            {
+                pNextHttpsRequest->pCallbacks->errorCallback( pNextHttpsRequest->pUserPrivData, pNextHttpsRequest, NULL, scheduleStatus );
+            }
+            else
+            {
+                pNextHttpsRequest->pHttpsResponse->syncStatus = scheduleStatus;
+            }
+        }
+    }
+    else
+    {
+        IotLogDebug( "No request in the queue can be scheduled to send now." );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void _savePipelinedData( _httpsConnection_t * pHttpsConnection,
+                                const uint8_t * pData,
+                                size_t dataLen )
+{
+    /* Without pipelining, data beyond the end of the response is ignored. */
+    if( ( pHttpsConnection == NULL ) || ( pHttpsConnection->pPipelineBuf == NULL ) )
+    {
+        return;
+    }
+
+    if( dataLen + pHttpsConnection->pipelineDataLen > pHttpsConnection->pipelineBufLen )
+    {
+        IotLogError( "%d bytes of the next pipelined response do not fit in the %d bytes of connection user buffer "
+                     "left after the connection context.",
+                     dataLen + pHttpsConnection->pipelineDataLen,
+                     pHttpsConnection->pipelineBufLen );
+        pHttpsConnection->pipelineDataLost = true;
+        return;
+    }
+
+    /* The new data was received before the data that is still kept, so it goes in front. The data still kept is moved
+     * to the end of the new data; it never overlaps pData because pData is in a response buffer. */
+    memmove( pHttpsConnection->pPipelineBuf + dataLen, pHttpsConnection->pPipelineData, pHttpsConnection->pipelineDataLen );
+    memcpy( pHttpsConnection->pPipelineBuf, pData, dataLen );
+    pHttpsConnection->pPipelineData = pHttpsConnection->pPipelineBuf;
+    pHttpsConnection->pipelineDataLen += dataLen;
+
+    IotLogDebug( "Kept %d bytes of the next pipelined response.", dataLen );
+}
+
+/*-----------------------------------------------------------*/
+
+static bool _waitForPipelinedRequestSent( _httpsConnection_t * pHttpsConnection,
+                                          _httpsResponse_t * pHttpsResponse )
+{
+    uint64_t startTimeMs = 0;
+    uint64_t waitedMs = 0;
+
+    /* Without pipelining, a response before the request finished sending is always a protocol violation. */
+    if( pHttpsConnection->maxOutstandingResponses > 1 )
+    {
+        startTimeMs = IotClock_GetTimeMs();
+
+        /* reqSentSem is posted for every request on the connection that finishes sending, so a post may be for an
+         * earlier request. Check again after each one. */
+        while( ( pHttpsResponse->reqFinishedSending == false ) && ( waitedMs < pHttpsConnection->timeout ) )
+        {
+            ( void ) IotSemaphore_TimedWait( &( pHttpsConnection->reqSentSem ),
+                                             ( uint32_t ) ( pHttpsConnection->timeout - waitedMs ) );
+            waitedMs = IotClock_GetTimeMs() - startTimeMs;
+        }
+    }
+
+    return pHttpsResponse->reqFinishedSending;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _abortPendingHttpsRequests( _httpsConnection_t * pHttpsConnection,
+                                        _httpsResponse_t * pCurrentHttpsResponse )
+{
+    IotDeQueue_t abortedRespQ;
+    IotDeQueue_t abortedReqQ;
+    IotLink_t * pQItem = NULL;
+    IotLink_t * pNextQItem = NULL;
+    _httpsResponse_t * pHttpsResponse = NULL;
+    _httpsRequest_t * pHttpsRequest = NULL;
+
+    if( pHttpsConnection->maxOutstandingResponses == 1 )
+    {
+        return;
+    }
+
+    IotDeQueue_Create( &abortedRespQ );
+    IotDeQueue_Create( &abortedReqQ );
+
+    /* Move everything that nobody else will report out of the connection's queues, so that the application callbacks
+     * below are invoked without the connection locked. */
+    IotMutex_Lock( &( pHttpsConnection->connectionMutex ) );
+
+    pQItem = IotDeQueue_PeekHead( &( pHttpsConnection->respQ ) );
+
+    while( ( pQItem != NULL ) && ( pQItem != &( pHttpsConnection->respQ ) ) )
+    {
+        pNextQItem = pQItem->pNext;
+        pHttpsResponse = IotLink_Container( _httpsResponse_t, pQItem, link );
+
+        if( ( pHttpsResponse != pCurrentHttpsResponse ) && ( pHttpsResponse->reqFinishedSending ) )
+        {
+            IotDeQueue_Remove( pQItem );
+            IotDeQueue_EnqueueTail( &abortedRespQ, pQItem );
+        }
+
+        pQItem = pNextQItem;
+    }
+
+    pQItem = IotDeQueue_PeekHead( &( pHttpsConnection->reqQ ) );
+
+    while( ( pQItem != NULL ) && ( pQItem != &( pHttpsConnection->reqQ ) ) )
+    {
+        pNextQItem = pQItem->pNext;
+        pHttpsRequest = IotLink_Container( _httpsRequest_t, pQItem, link );
+
+        if( pHttpsRequest->scheduled == false )
+        {
+            IotDeQueue_Remove( pQItem );
+            IotDeQueue_EnqueueTail( &abortedReqQ, pQItem );
+        }
+
+        pQItem = pNextQItem;
+    }
+
+    IotMutex_Unlock( &( pHttpsConnection->connectionMutex ) );
+
+    /* These requests were sent, but their responses will never be received. */
+    while( ( pQItem = IotDeQueue_DequeueHead( &abortedRespQ ) ) != NULL )
+    {
+        pHttpsResponse = IotLink_Container( _httpsResponse_t, pQItem, link );
+        IotLogDebug( "Aborting pipelined response %d because the connection is closing.", pHttpsResponse );
+        _cancelResponse( pHttpsResponse );
+        pHttpsResponse->syncStatus = IOT_HTTPS_RECEIVE_ABORT;
+
+        if( pHttpsResponse->isAsync == false )
+        {
+            IotSemaphore_Post( &( pHttpsResponse->respFinishedSem ) );
+        }
+        else
+        {
+            if( pHttpsResponse->pCallbacks->errorCallback )
+            {
+                pHttpsResponse->pCallbacks->errorCallback( pHttpsResponse->pUserPrivData, NULL, pHttpsResponse, IOT_HTTPS_RECEIVE_ABORT );
+            }
+
+            if( pHttpsResponse->pCallbacks->responseCompleteCallback )
+            {
+                pHttpsResponse->pCallbacks->responseCompleteCallback( pHttpsResponse->pUserPrivData, pHttpsResponse, IOT_HTTPS_RECEIVE_ABORT, 0 );
+            }
+        }
+    }
+
+    /* These requests were never sent. */
+    while( ( pQItem = IotDeQueue_DequeueHead( &abortedReqQ ) ) != NULL )
+    {
+        pHttpsRequest = IotLink_Container( _httpsRequest_t, pQItem, link );
+        IotLogDebug( "Aborting queued request %d because the connection is closing.", pHttpsRequest );
+        pHttpsRequest->pHttpsResponse->syncStatus = IOT_HTTPS_SEND_ABORT;
+
+        if( pHttpsRequest->isAsync == false )
+        {
+            IotSemaphore_Post( &( pHttpsRequest->pHttpsResponse->respFinishedSem ) );
+        }
+        else
+        {
+            if( pHttpsRequest->pCallbacks->errorCallback )
+            {
+                pHttpsRequest->pCallbacks->errorCallback( pHttpsRequest->pUserPrivData, pHttpsRequest, NULL, IOT_HTTPS_SEND_ABORT );
+            }
+
+            if( pHttpsRequest->pCallbacks->responseCompleteCallback )
+            {
+                pHttpsRequest->pCallbacks->responseCompleteCallback( pHttpsRequest->pUserPrivData, NULL, IOT_HTTPS_SEND_ABORT, 0 );
+            }
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static bool _poolEntryMatches( _httpsPoolEntry_t * pEntry,
+                               IotHttpsConnectionInfo_t * pConnInfo )
+{
+    bool matches = false;
+    uint32_t alpnProtocolsLen = 0;
+
+    if( pConnInfo->pAlpnProtocols != NULL )
+    {
+        alpnProtocolsLen = pConnInfo->alpnProtocolsLen;
+    }
+
+    /* Only compare the strings once all of the cheaper fields match. */
+    if( ( pEntry->port == pConnInfo->port ) &&
+        ( pEntry->flags == pConnInfo->flags ) &&
+        ( pEntry->pNetworkInterface == pConnInfo->pNetworkInterface ) &&
+        ( pEntry->addressLen == pConnInfo->addressLen ) &&
+        ( pEntry->alpnProtocolsLen == alpnProtocolsLen ) )
+    {
+        matches = ( memcmp( pEntry->pAddress, pConnInfo->pAddress, pEntry->addressLen ) == 0 ) &&
+                  ( ( alpnProtocolsLen == 0 ) ||
+                    ( memcmp( pEntry->pAlpnProtocols, pConnInfo->pAlpnProtocols, alpnProtocolsLen ) == 0 ) );
+    }
+
+    return matches;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool _isPooledConnectionHealthy( _httpsConnectionPool_t * pHttpsConnectionPool,
+                                        _httpsPoolEntry_t * pEntry,
+                                        uint64_t nowMs )
+{
+    _httpsConnection_t * pHttpsConnection = pEntry->pHttpsConnection;
+
+    /* isConnected is cleared by the network receive callback when the server closes an idle connection, if the
+     * network layer reports the close. Servers that close quietly are caught by the idle timeout instead. */
+    bool healthy = ( pHttpsConnection->isConnected ) &&
+                   ( IotDeQueue_IsEmpty( &( pHttpsConnection->reqQ ) ) ) &&
+                   ( IotDeQueue_IsEmpty( &( pHttpsConnection->respQ ) ) );
+
+    if( healthy && ( pHttpsConnectionPool->idleTimeoutMs != 0 ) )
+    {
+        healthy = ( nowMs - pEntry->idleSinceMs ) < pHttpsConnectionPool->idleTimeoutMs;
+    }
+
+    return healthy;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotHttpsReturnCode_t _closePooledConnection( _httpsPoolEntry_t * pEntry )
+{
+    IotHttpsReturnCode_t status = IotHttpsClient_Disconnect( pEntry->pHttpsConnection );
+
+    if( HTTPS_SUCCEEDED( status ) )
+    {
+        /* The connection user buffer will hold a new connection context, with a new mutex and semaphore. */
+        IotMutex_Destroy( &( pEntry->pHttpsConnection->connectionMutex ) );
+
+        if( pEntry->pHttpsConnection->maxOutstandingResponses > 1 )
+        {
+            IotSemaphore_Destroy( &( pEntry->pHttpsConnection->reqSentSem ) );
+        }
+    }
+    else
+    {
+        IotLogWarn( "Failed to close pooled connection %d. Error code: %d.", pEntry->pHttpsConnection, status );
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
 static void _cancelRequest( _httpsRequest_t * pHttpsRequest )
 {
     pHttpsRequest->cancelled = true;
@@ -2545,6 +3236,13 @@ static IotHttpsReturnCode_t _initializeResponse( IotHttpsResponseHandle_t * pRes
     pHttpsResponse->reqFinishedSending = true;
     pHttpsResponse->isNonPersistent = pHttpsRequest->isNonPersistent;
 
+    #if IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE > 0
+        pHttpsResponse->headerIndexCount = 0;
+        pHttpsResponse->headerIndexInValue = false;
+        pHttpsResponse->headerIndexOverflow = false;
+        pHttpsResponse->headerIndexComplete = false;
+    #endif
+
     /* Set the response handle to return. */
     *pRespHandle = pHttpsResponse;
 
@@ -2632,14 +3330,30 @@ IotHttpsReturnCode_t IotHttpsClient_Disconnect( IotHttpsConnectionHandle_t connH
         /* Mark the network as disconnected whether the disconnect passes or not. */
         connHandle->isConnected = false;
         _networkDisconnect( connHandle );
+
+        /* Bytes kept for the next pipelined response are of no use anymore. */
+        connHandle->pipelineDataLen = 0;
     }
 
     /* If there is a response in the connection's response queue and the associated request has not finished sending,
-     * then we cannot destroy the connection until it finishes. */
-    pRespItem = IotDeQueue_DequeueHead( &( connHandle->respQ ) );
+     * then we cannot destroy the connection until it finishes. With pipelining, that response may be behind responses
+     * to requests that were already sent, so the response of the request being sent is looked for. */
+    IotContainers_ForEach( &( connHandle->respQ ), pRespItem )
+    {
+        if( IotLink_Container( _httpsResponse_t, pRespItem, link )->reqFinishedSending == false )
+        {
+            break;
+        }
+    }
+
+    if( pRespItem == &( connHandle->respQ ) )
+    {
+        pRespItem = IotDeQueue_PeekHead( &( connHandle->respQ ) );
+    }
 
     if( pRespItem != NULL )
     {
+        IotDeQueue_Remove( pRespItem );
         pHttpsResponse = IotLink_Container( _httpsResponse_t, pRespItem, link );
         IotLogDebug( "Response %d found in the queue during disconnect.", pHttpsResponse );
 
@@ -2709,6 +3423,398 @@ IotHttpsReturnCode_t IotHttpsClient_Disconnect( IotHttpsConnectionHandle_t connH
 
 /*-----------------------------------------------------------*/
 
+IotHttpsReturnCode_t IotHttpsClient_CreateConnectionPool( IotHttpsConnectionPoolHandle_t * pPoolHandle,
+                                                          IotHttpsConnectionPoolInfo_t * pPoolInfo )
+{
+    HTTPS_FUNCTION_ENTRY( IOT_HTTPS_OK );
+
+    _httpsConnectionPool_t * pHttpsConnectionPool = NULL;
+    uint8_t * pConnUserBuffer = NULL;
+    uint32_t connectionBufferLen = 0;
+    uint32_t entryCount = 0;
+    uint32_t i = 0;
+
+    HTTPS_ON_NULL_ARG_GOTO_CLEANUP( pPoolHandle );
+    HTTPS_ON_NULL_ARG_GOTO_CLEANUP( pPoolInfo );
+    HTTPS_ON_NULL_ARG_GOTO_CLEANUP( pPoolInfo->userBuffer.pBuffer );
+
+    /* Make sure a connection context can fit in each connection user buffer. */
+    HTTPS_ON_ARG_ERROR_MSG_GOTO_CLEANUP( pPoolInfo->connectionBufferLen >= connectionUserBufferMinimumSize,
+                                         IOT_HTTPS_INSUFFICIENT_MEMORY,
+                                         "IotHttpsConnectionPoolInfo_t.connectionBufferLen %d is too small for the connection context. Required minimum size: %d.",
+                                         pPoolInfo->connectionBufferLen,
+                                         connectionUserBufferMinimumSize );
+
+    /* Round the connection user buffers up so that the connection context in each one is aligned. */
+    connectionBufferLen = ( pPoolInfo->connectionBufferLen + HTTPS_POOL_CONNECTION_BUFFER_ALIGNMENT - 1 ) &
+                          ~( ( uint32_t ) HTTPS_POOL_CONNECTION_BUFFER_ALIGNMENT - 1 );
+
+    /* The number of connections in the pool is however many fit in the user buffer. */
+    if( pPoolInfo->userBuffer.bufferLen > connectionPoolUserBufferMinimumSize )
+    {
+        entryCount = ( pPoolInfo->userBuffer.bufferLen - connectionPoolUserBufferMinimumSize ) /
+                     ( connectionPoolUserBufferSizePerConnection + connectionBufferLen );
+    }
+
+    HTTPS_ON_ARG_ERROR_MSG_GOTO_CLEANUP( entryCount > 0,
+                                         IOT_HTTPS_INSUFFICIENT_MEMORY,
+                                         "Buffer size is too small to initialize a connection pool. User buffer size: %d, required minimum size: %d.",
+                                         pPoolInfo->userBuffer.bufferLen,
+                                         connectionPoolUserBufferMinimumSize + connectionPoolUserBufferSizePerConnection + connectionBufferLen );
+
+    pHttpsConnectionPool = ( _httpsConnectionPool_t * ) ( pPoolInfo->userBuffer.pBuffer );
+
+    if( IotMutex_Create( &( pHttpsConnectionPool->poolMutex ), false ) == false )
+    {
+        IotLogError( "Failed to create the connection pool mutex." );
+        HTTPS_SET_AND_GOTO_CLEANUP( IOT_HTTPS_INTERNAL_ERROR );
+    }
+
+    pHttpsConnectionPool->connectionBufferLen = connectionBufferLen;
+    pHttpsConnectionPool->maxIdleConnections = pPoolInfo->maxIdleConnections;
+    pHttpsConnectionPool->maxConnectionsPerHost = pPoolInfo->maxConnectionsPerHost;
+    pHttpsConnectionPool->idleTimeoutMs = pPoolInfo->idleTimeoutMs;
+    pHttpsConnectionPool->entryCount = entryCount;
+
+    /* The connection user buffers follow the entries. */
+    pConnUserBuffer = ( uint8_t * ) &( pHttpsConnectionPool->entries[ entryCount ] );
+
+    for( i = 0; i < entryCount; i++ )
+    {
+        pHttpsConnectionPool->entries[ i ].state = POOL_ENTRY_STATE_FREE;
+        pHttpsConnectionPool->entries[ i ].pHttpsConnection = NULL;
+        pHttpsConnectionPool->entries[ i ].pConnUserBuffer = pConnUserBuffer + ( i * connectionBufferLen );
+    }
+
+    IotLogDebug( "Created connection pool %d with %d connections.", pHttpsConnectionPool, entryCount );
+
+    *pPoolHandle = pHttpsConnectionPool;
+
+    HTTPS_FUNCTION_CLEANUP_BEGIN();
+
+    if( HTTPS_FAILED( status ) && ( pPoolHandle != NULL ) )
+    {
+        *pPoolHandle = NULL;
+    }
+
+    HTTPS_FUNCTION_CLEANUP_END();
+}
+
+/*-----------------------------------------------------------*/
+
+IotHttpsReturnCode_t IotHttpsClient_AcquireConnection( IotHttpsConnectionPoolHandle_t poolHandle,
+                                                       IotHttpsConnectionHandle_t * pConnHandle,
+                                                       IotHttpsConnectionInfo_t * pConnInfo )
+{
+    HTTPS_FUNCTION_ENTRY( IOT_HTTPS_OK );
+
+    _httpsPoolEntry_t * pEntry = NULL;
+    _httpsPoolEntry_t * pReadyEntry = NULL;
+    _httpsPoolEntry_t * pStaleEntry = NULL;
+    _httpsPoolEntry_t * pFreeEntry = NULL;
+    _httpsPoolEntry_t * pOldestIdleEntry = NULL;
+    bool closeEntry = false;
+    bool poolLocked = false;
+    uint32_t hostConnections = 0;
+    uint64_t nowMs = 0;
+    uint32_t i = 0;
+    IotHttpsConnectionInfo_t pooledConnInfo = IOT_HTTPS_CONNECTION_INFO_INITIALIZER;
+
+    HTTPS_ON_NULL_ARG_GOTO_CLEANUP( poolHandle );
+    HTTPS_ON_NULL_ARG_GOTO_CLEANUP( pConnHandle );
+    HTTPS_ON_NULL_ARG_GOTO_CLEANUP( pConnInfo );
+    HTTPS_ON_NULL_ARG_GOTO_CLEANUP( pConnInfo->pAddress );
+
+    /* The server of the connection is kept in its pool entry, so it has to fit there. */
+    HTTPS_ON_ARG_ERROR_MSG_GOTO_CLEANUP( pConnInfo->addressLen <= IOT_HTTPS_MAX_HOST_NAME_LENGTH,
+                                         IOT_HTTPS_INVALID_PARAMETER,
+                                         "IotHttpsConnectionInfo_t.addressLen has a host name length %d that exceeds maximum length %d.",
+                                         pConnInfo->addressLen,
+                                         IOT_HTTPS_MAX_HOST_NAME_LENGTH );
+    HTTPS_ON_ARG_ERROR_MSG_GOTO_CLEANUP( pConnInfo->alpnProtocolsLen <= IOT_HTTPS_MAX_ALPN_PROTOCOLS_LENGTH,
+                                         IOT_HTTPS_INVALID_PARAMETER,
+                                         "IotHttpsConnectionInfo_t.alpnProtocolsLen of %d exceeds the configured maximum protocol length %d. See IOT_HTTPS_MAX_ALPN_PROTOCOLS_LENGTH for more information.",
+                                         pConnInfo->alpnProtocolsLen,
+                                         IOT_HTTPS_MAX_ALPN_PROTOCOLS_LENGTH );
+
+    nowMs = IotClock_GetTimeMs();
+
+    IotMutex_Lock( &( poolHandle->poolMutex ) );
+    poolLocked = true;
+
+    /* Look for an idle connection to the server that can be used as is. On the way, count the connections to the server
+     * and remember where a new connection could go. */
+    for( i = 0; i < poolHandle->entryCount; i++ )
+    {
+        pEntry = &( poolHandle->entries[ i ] );
+
+        if( pEntry->state == POOL_ENTRY_STATE_FREE )
+        {
+            if( pFreeEntry == NULL )
+            {
+                pFreeEntry = pEntry;
+            }
+        }
+        else if( _poolEntryMatches( pEntry, pConnInfo ) )
+        {
+            hostConnections++;
+
+            if( pEntry->state == POOL_ENTRY_STATE_IDLE )
+            {
+                if( _isPooledConnectionHealthy( poolHandle, pEntry, nowMs ) )
+                {
+                    pReadyEntry = pEntry;
+                    break;
+                }
+                else if( pStaleEntry == NULL )
+                {
+                    pStaleEntry = pEntry;
+                }
+            }
+        }
+        else if( pEntry->state == POOL_ENTRY_STATE_IDLE )
+        {
+            if( ( pOldestIdleEntry == NULL ) || ( pEntry->idleSinceMs < pOldestIdleEntry->idleSinceMs ) )
+            {
+                pOldestIdleEntry = pEntry;
+            }
+        }
+    }
+
+    if( pReadyEntry != NULL )
+    {
+        pReadyEntry->state = POOL_ENTRY_STATE_IN_USE;
+        *pConnHandle = pReadyEntry->pHttpsConnection;
+        IotLogDebug( "Reusing pooled connection %d to %.*s.", *pConnHandle, pConnInfo->addressLen, pConnInfo->pAddress );
+        HTTPS_GOTO_CLEANUP();
+    }
+
+    /* A stale connection to the server is replaced in place, so it does not count against the per-host limit. */
+    if( pStaleEntry != NULL )
+    {
+        pEntry = pStaleEntry;
+    }
+    else if( ( poolHandle->maxConnectionsPerHost != 0 ) && ( hostConnections >= poolHandle->maxConnectionsPerHost ) )
+    {
+        IotLogError( "There are already %d pooled connections to %.*s.",
+                     hostConnections,
+                     pConnInfo->addressLen,
+                     pConnInfo->pAddress );
+        HTTPS_SET_AND_GOTO_CLEANUP( IOT_HTTPS_BUSY );
+    }
+    else if( pFreeEntry != NULL )
+    {
+        pEntry = pFreeEntry;
+    }
+    else if( pOldestIdleEntry != NULL )
+    {
+        pEntry = pOldestIdleEntry;
+    }
+    else
+    {
+        IotLogError( "All of the connections in connection pool %d are in use.", poolHandle );
+        HTTPS_SET_AND_GOTO_CLEANUP( IOT_HTTPS_BUSY );
+    }
+
+    /* Claim the entry for the server, so that the connection can be closed and made without the pool locked. The
+     * server is set before the pool is unlocked, so that the entry counts against the per-host limit of this server
+     * while the connection is made. */
+    closeEntry = ( pEntry->state == POOL_ENTRY_STATE_IDLE );
+    pEntry->state = POOL_ENTRY_STATE_IN_USE;
+    pEntry->pNetworkInterface = pConnInfo->pNetworkInterface;
+    pEntry->flags = pConnInfo->flags;
+    pEntry->port = pConnInfo->port;
+    pEntry->addressLen = pConnInfo->addressLen;
+    memcpy( pEntry->pAddress, pConnInfo->pAddress, pConnInfo->addressLen );
+
+    if( pConnInfo->pAlpnProtocols != NULL )
+    {
+        pEntry->alpnProtocolsLen = pConnInfo->alpnProtocolsLen;
+        memcpy( pEntry->pAlpnProtocols, pConnInfo->pAlpnProtocols, pConnInfo->alpnProtocolsLen );
+    }
+    else
+    {
+        pEntry->alpnProtocolsLen = 0;
+    }
+
+    IotMutex_Unlock( &( poolHandle->poolMutex ) );
+    poolLocked = false;
+
+    if( closeEntry )
+    {
+        status = _closePooledConnection( pEntry );
+
+        if( HTTPS_FAILED( status ) )
+        {
+            /* The connection is being closed by the network receive callback. Leave it idle to be closed again by
+             * the next call. It is disconnected, so it is never handed out to the server it is now listed for. */
+            IotMutex_Lock( &( poolHandle->poolMutex ) );
+            pEntry->state = POOL_ENTRY_STATE_IDLE;
+            IotMutex_Unlock( &( poolHandle->poolMutex ) );
+            HTTPS_GOTO_CLEANUP();
+        }
+    }
+
+    /* The connection context goes in the entry's connection user buffer instead of the one in pConnInfo. */
+    pooledConnInfo = *pConnInfo;
+    pooledConnInfo.userBuffer.pBuffer = pEntry->pConnUserBuffer;
+    pooledConnInfo.userBuffer.bufferLen = poolHandle->connectionBufferLen;
+
+    status = _createHttpsConnection( &( pEntry->pHttpsConnection ), &pooledConnInfo );
+
+    if( HTTPS_FAILED( status ) )
+    {
+        IotLogError( "Error connecting a pooled connection. Error code %d.", status );
+
+        IotMutex_Lock( &( poolHandle->poolMutex ) );
+        pEntry->state = POOL_ENTRY_STATE_FREE;
+        IotMutex_Unlock( &( poolHandle->poolMutex ) );
+        HTTPS_GOTO_CLEANUP();
+    }
+
+    *pConnHandle = pEntry->pHttpsConnection;
+
+    HTTPS_FUNCTION_CLEANUP_BEGIN();
+
+    if( poolLocked )
+    {
+        IotMutex_Unlock( &( poolHandle->poolMutex ) );
+    }
+
+    if( HTTPS_FAILED( status ) && ( pConnHandle != NULL ) )
+    {
+        *pConnHandle = NULL;
+    }
+
+    HTTPS_FUNCTION_CLEANUP_END();
+}
+
+/*-----------------------------------------------------------*/
+
+IotHttpsReturnCode_t IotHttpsClient_ReleaseConnection( IotHttpsConnectionPoolHandle_t poolHandle,
+                                                       IotHttpsConnectionHandle_t connHandle )
+{
+    HTTPS_FUNCTION_ENTRY( IOT_HTTPS_OK );
+
+    _httpsPoolEntry_t * pEntry = NULL;
+    uint32_t idleConnections = 0;
+    bool keepOpen = false;
+    uint32_t i = 0;
+
+    HTTPS_ON_NULL_ARG_GOTO_CLEANUP( poolHandle );
+    HTTPS_ON_NULL_ARG_GOTO_CLEANUP( connHandle );
+
+    IotMutex_Lock( &( poolHandle->poolMutex ) );
+
+    for( i = 0; i < poolHandle->entryCount; i++ )
+    {
+        if( poolHandle->entries[ i ].state == POOL_ENTRY_STATE_IDLE )
+        {
+            idleConnections++;
+        }
+        else if( ( poolHandle->entries[ i ].state == POOL_ENTRY_STATE_IN_USE ) &&
+                 ( poolHandle->entries[ i ].pHttpsConnection == connHandle ) )
+        {
+            pEntry = &( poolHandle->entries[ i ] );
+        }
+    }
+
+    /* Only a connection that is open and has nothing left to do can be handed out again. */
+    if( pEntry != NULL )
+    {
+        keepOpen = ( connHandle->isConnected ) &&
+                   ( IotDeQueue_IsEmpty( &( connHandle->reqQ ) ) ) &&
+                   ( IotDeQueue_IsEmpty( &( connHandle->respQ ) ) ) &&
+                   ( ( poolHandle->maxIdleConnections == 0 ) || ( idleConnections < poolHandle->maxIdleConnections ) );
+
+        if( keepOpen )
+        {
+            pEntry->idleSinceMs = IotClock_GetTimeMs();
+            pEntry->state = POOL_ENTRY_STATE_IDLE;
+        }
+    }
+
+    IotMutex_Unlock( &( poolHandle->poolMutex ) );
+
+    HTTPS_ON_ARG_ERROR_MSG_GOTO_CLEANUP( pEntry != NULL,
+                                         IOT_HTTPS_INVALID_PARAMETER,
+                                         "Connection %d is not acquired from connection pool %d.",
+                                         connHandle,
+                                         poolHandle );
+
+    if( keepOpen == false )
+    {
+        /* The entry stays in use until the connection is closed, so that nobody else takes it meanwhile. */
+        status = _closePooledConnection( pEntry );
+
+        if( HTTPS_SUCCEEDED( status ) )
+        {
+            IotMutex_Lock( &( poolHandle->poolMutex ) );
+            pEntry->state = POOL_ENTRY_STATE_FREE;
+            pEntry->pHttpsConnection = NULL;
+            IotMutex_Unlock( &( poolHandle->poolMutex ) );
+        }
+    }
+
+    HTTPS_FUNCTION_EXIT_NO_CLEANUP();
+}
+
+/*-----------------------------------------------------------*/
+
+IotHttpsReturnCode_t IotHttpsClient_DestroyConnectionPool( IotHttpsConnectionPoolHandle_t poolHandle )
+{
+    HTTPS_FUNCTION_ENTRY( IOT_HTTPS_OK );
+
+    uint32_t i = 0;
+
+    HTTPS_ON_NULL_ARG_GOTO_CLEANUP( poolHandle );
+
+    IotMutex_Lock( &( poolHandle->poolMutex ) );
+
+    for( i = 0; i < poolHandle->entryCount; i++ )
+    {
+        if( poolHandle->entries[ i ].state == POOL_ENTRY_STATE_IN_USE )
+        {
+            IotLogError( "Connection %d of connection pool %d is still acquired.",
+                         poolHandle->entries[ i ].pHttpsConnection,
+                         poolHandle );
+            status = IOT_HTTPS_BUSY;
+            break;
+        }
+    }
+
+    if( HTTPS_SUCCEEDED( status ) )
+    {
+        for( i = 0; i < poolHandle->entryCount; i++ )
+        {
+            if( poolHandle->entries[ i ].state == POOL_ENTRY_STATE_IDLE )
+            {
+                /* A connection that fails to close stays idle, so that calling this function again retries it. */
+                if( HTTPS_SUCCEEDED( _closePooledConnection( &( poolHandle->entries[ i ] ) ) ) )
+                {
+                    poolHandle->entries[ i ].state = POOL_ENTRY_STATE_FREE;
+                    poolHandle->entries[ i ].pHttpsConnection = NULL;
+                }
+                else
+                {
+                    status = IOT_HTTPS_BUSY;
+                }
+            }
+        }
+    }
+
+    IotMutex_Unlock( &( poolHandle->poolMutex ) );
+
+    if( HTTPS_SUCCEEDED( status ) )
+    {
+        IotMutex_Destroy( &( poolHandle->poolMutex ) );
+    }
+
+    HTTPS_FUNCTION_EXIT_NO_CLEANUP();
+}
+
+/*-----------------------------------------------------------*/
+
 IotHttpsReturnCode_t IotHttpsClient_InitializeRequest( IotHttpsRequestHandle_t * pReqHandle,
                                                        IotHttpsRequestInfo_t * pReqInfo )
 {
@@ -3254,6 +4360,7 @@ IotHttpsReturnCode_t IotHttpsClient_ReadHeader( IotHttpsResponseHandle_t respHan
     IotHttpsResponseBufferState_t savedBufferState = PROCESSING_STATE_NONE;
     IotHttpsResponseParserState_t savedParserState = PARSER_STATE_NONE;
     size_t numParsed = 0;
+    bool indexSearched = false;
 
     HTTPS_ON_NULL_ARG_GOTO_CLEANUP( respHandle );
     HTTPS_ON_NULL_ARG_GOTO_CLEANUP( pName );
@@ -3282,22 +4389,31 @@ IotHttpsReturnCode_t IotHttpsClient_ReadHeader( IotHttpsResponseHandle_t respHan
     respHandle->pReadHeaderValue = NULL;
     respHandle->readHeaderValueLength = 0;
 
-    /* Start over the HTTP parser so that it will parser from the beginning of the message. */
-    http_parser_init( &( respHandle->httpParserInfo.readHeaderParser ), HTTP_RESPONSE );
-
-    IotLogDebug( "Now parsing HTTP Message buffer to read a header." );
-    numParsed = respHandle->httpParserInfo.parseFunc( &( respHandle->httpParserInfo.readHeaderParser ), &_httpParserSettings, ( char * ) ( respHandle->pHeaders ), respHandle->pHeadersCur - respHandle->pHeaders );
-    IotLogDebug( "Parsed %d characters in IotHttpsClient_ReadHeader().", numParsed );
+    /* The offsets of the headers are indexed while the response is first received into the header buffer. If all of
+     * the headers are in the index, then the header buffer does not need to be parsed again. */
+    #if IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE > 0
+        indexSearched = _headerIndexSearch( respHandle, pName, nameLen );
+    #endif
 
-    /* There shouldn't be any errors parsing the response body given that the handle is from a validly
-     * received response, so this check is defensive. If there were errors parsing the original response headers, then
-     * the response handle would have been invalidated and the connection closed. */
-    if( ( respHandle->httpParserInfo.readHeaderParser.http_errno != 0 ) &&
-        ( HTTP_PARSER_ERRNO( &( respHandle->httpParserInfo.readHeaderParser ) ) > HPE_CB_chunk_complete ) )
+    if( indexSearched == false )
     {
-        pHttpParserErrorDescription = http_errno_description( HTTP_PARSER_ERRNO( &( respHandle->httpParserInfo.readHeaderParser ) ) );
-        IotLogError( "http_parser failed on the http response with error: %s", pHttpParserErrorDescription );
-        HTTPS_SET_AND_GOTO_CLEANUP( IOT_HTTPS_PARSING_ERROR );
+        /* Start over the HTTP parser so that it will parser from the beginning of the message. */
+        http_parser_init( &( respHandle->httpParserInfo.readHeaderParser ), HTTP_RESPONSE );
+
+        IotLogDebug( "Now parsing HTTP Message buffer to read a header." );
+        numParsed = respHandle->httpParserInfo.parseFunc( &( respHandle->httpParserInfo.readHeaderParser ), &_httpParserSettings, ( char * ) ( respHandle->pHeaders ), respHandle->pHeadersCur - respHandle->pHeaders );
+        IotLogDebug( "Parsed %d characters in IotHttpsClient_ReadHeader().", numParsed );
+
+        /* There shouldn't be any errors parsing the response body given that the handle is from a validly
+         * received response, so this check is defensive. If there were errors parsing the original response headers, then
+         * the response handle would have been invalidated and the connection closed. */
+        if( ( respHandle->httpParserInfo.readHeaderParser.http_errno != 0 ) &&
+            ( HTTP_PARSER_ERRNO( &( respHandle->httpParserInfo.readHeaderParser ) ) > HPE_CB_chunk_complete ) )
+        {
+            pHttpParserErrorDescription = http_errno_description( HTTP_PARSER_ERRNO( &( respHandle->httpParserInfo.readHeaderParser ) ) );
+            IotLogError( "http_parser failed on the http response with error: %s", pHttpParserErrorDescription );
+            HTTPS_SET_AND_GOTO_CLEANUP( IOT_HTTPS_PARSING_ERROR );
+        }
     }
 
     /* Not only do we need an indication that the header field was found, but also that the value was found as well.
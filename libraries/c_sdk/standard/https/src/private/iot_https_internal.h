@@ -52,6 +52,7 @@
 
 /* Platform layer includes. */
 #include "platform/iot_threads.h"
+#include "platform/iot_clock.h"
 #include "platform/iot_network.h"
 
 /* Error handling include. */
@@ -160,22 +161,28 @@
  * Provide default values for undefined configuration constants.
  */
 #ifndef AWS_IOT_HTTPS_ENABLE_METRICS
-    #define AWS_IOT_HTTPS_ENABLE_METRICS           ( 1 )
+    #define AWS_IOT_HTTPS_ENABLE_METRICS            ( 1 )
 #endif
 #ifndef IOT_HTTPS_USER_AGENT
-    #define IOT_HTTPS_USER_AGENT                   "amazon-freertos"
+    #define IOT_HTTPS_USER_AGENT                    "amazon-freertos"
 #endif
 #ifndef IOT_HTTPS_MAX_FLUSH_BUFFER_SIZE
-    #define IOT_HTTPS_MAX_FLUSH_BUFFER_SIZE        ( 1024 )
+    #define IOT_HTTPS_MAX_FLUSH_BUFFER_SIZE         ( 1024 )
 #endif
 #ifndef IOT_HTTPS_RESPONSE_WAIT_MS
-    #define IOT_HTTPS_RESPONSE_WAIT_MS             ( 1000 )
+    #define IOT_HTTPS_RESPONSE_WAIT_MS              ( 1000 )
 #endif
 #ifndef IOT_HTTPS_MAX_HOST_NAME_LENGTH
-    #define IOT_HTTPS_MAX_HOST_NAME_LENGTH         ( 255 ) /* Per FQDN, the maximum host name length is 255 bytes. */
+    #define IOT_HTTPS_MAX_HOST_NAME_LENGTH          ( 255 ) /* Per FQDN, the maximum host name length is 255 bytes. */
 #endif
 #ifndef IOT_HTTPS_MAX_ALPN_PROTOCOLS_LENGTH
-    #define IOT_HTTPS_MAX_ALPN_PROTOCOLS_LENGTH    ( 255 ) /* The maximum alpn protocols length is chosen arbitrarily. */
+    #define IOT_HTTPS_MAX_ALPN_PROTOCOLS_LENGTH     ( 255 ) /* The maximum alpn protocols length is chosen arbitrarily. */
+#endif
+#ifndef IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE
+    #define IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE    ( 8 ) /* Set to 0 to always search the header buffer with http-parser. */
+#endif
+#ifndef IOT_HTTPS_MAX_PIPELINED_REQUESTS
+    #define IOT_HTTPS_MAX_PIPELINED_REQUESTS        ( 4 ) /* Only used by connections created with IOT_HTTPS_ENABLE_PIPELINING. */
 #endif
 
 /** @endcond */
@@ -247,6 +254,20 @@
  */
 #define HTTPS_MAX_CONTENT_LENGTH_LINE_LENGTH          ( 26 )
 
+/*
+ * Constants for the FNV-1a hash of the header field names in the response header index.
+ */
+#define HTTPS_HEADER_INDEX_HASH_OFFSET_BASIS          ( 2166136261UL ) /**< @brief FNV-1a 32-bit offset basis. */
+#define HTTPS_HEADER_INDEX_HASH_PRIME                 ( 16777619UL )   /**< @brief FNV-1a 32-bit prime. */
+
+/**
+ * @brief Alignment of the connection user buffers in a connection pool user buffer.
+ *
+ * Each connection user buffer length is rounded up to this so that every connection context in the pool is aligned
+ * like the first one.
+ */
+#define HTTPS_POOL_CONNECTION_BUFFER_ALIGNMENT        ( 8 )
+
 /**
  * @brief Macro for fast string length calculation of string macros.
  *
@@ -390,6 +411,28 @@ typedef struct _httpsConnection
     IotDeQueue_t respQ;                         /**< @brief The queue for the responses that are waiting to be processed. */
     IotTaskPoolJobStorage_t taskPoolJobStorage; /**< @brief An asynchronous operation requires storage for the task pool job. */
     IotTaskPoolJob_t taskPoolJob;               /**< @brief The task pool job identifier for an asynchronous request. */
+
+    /**
+     * @brief The number of responses that may be outstanding on this connection at once.
+     *
+     * This is 1 unless the connection was created with #IOT_HTTPS_ENABLE_PIPELINING, in which case it is
+     * #IOT_HTTPS_MAX_PIPELINED_REQUESTS and that many requests are written back-to-back without waiting for responses.
+     */
+    uint32_t maxOutstandingResponses;
+    uint8_t * pPipelineBuf;    /**< @brief Spare connection user buffer holding bytes received past the end of a pipelined response. NULL without pipelining. */
+    size_t pipelineBufLen;     /**< @brief The length of pPipelineBuf. */
+    uint8_t * pPipelineData;   /**< @brief The next byte in pPipelineBuf that has not been handed to the next response. */
+    size_t pipelineDataLen;    /**< @brief The number of bytes in pPipelineBuf that have not been handed to the next response. */
+    bool pipelineDataLost;     /**< @brief Set when bytes of the next pipelined response did not fit in pPipelineBuf. */
+
+    /**
+     * @brief Posted each time a request on a pipelined connection finishes sending.
+     *
+     * The server may answer a pipelined request before the task pool worker sending it has marked it finished. The
+     * network receive callback waits on this semaphore for that, up to the connection timeout. It is only created
+     * when maxOutstandingResponses is greater than 1.
+     */
+    IotSemaphore_t reqSentSem;
 } _httpsConnection_t;
 
 /**
@@ -410,6 +453,30 @@ typedef struct _httpParserInfo
     http_parser readHeaderParser;         /**< @brief http_parser state information for parsing the header buffer for reading a header. */
 } _httpParserInfo_t;
 
+#if IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE > 0
+
+/**
+ * @brief The location of one header line in the header buffer of a response.
+ *
+ * The index is filled in by the http-parser callbacks while the response headers are received into the header buffer,
+ * so that IotHttpsClient_ReadHeader() does not have to parse the header buffer again. The offsets are relative to
+ * #_httpsResponse_t.pHeaders. A valueOffset of zero means that the value was not received yet; the header buffer
+ * starts with the status line, so a header value is never at offset zero.
+ */
+    typedef struct _httpsHeaderIndexEntry
+    {
+        uint32_t fieldHash;   /**< @brief FNV-1a hash of the header field name. */
+        uint16_t fieldOffset; /**< @brief Offset of the header field name in the header buffer. */
+        uint16_t fieldLength; /**< @brief Length of the header field name. */
+        uint16_t valueOffset; /**< @brief Offset of the header value in the header buffer. */
+        uint16_t valueLength; /**< @brief Length of the header value. */
+    } _httpsHeaderIndexEntry_t;
+
+    #if IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE > 255
+        #error "IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE must not be larger than 255."
+    #endif
+#endif /* if IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE > 0 */
+
 /**
  * @brief Represents an HTTP response.
  */
@@ -454,6 +521,14 @@ typedef struct _httpsResponse
     IotHttpsClientCallbacks_t * pCallbacks; /**< @brief Pointer to the asynchronous request callbacks. */
     void * pUserPrivData;                   /**< @brief User private data to hand back in the asynchronous callbacks for context. */
     bool isNonPersistent;                   /**< @brief Non-persistent flag to indicate closing the connection immediately after receiving the response. */
+
+    #if IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE > 0
+        _httpsHeaderIndexEntry_t headerIndex[ IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE ]; /**< @brief Location of the first headers received in the header buffer. */
+        uint8_t headerIndexCount;                                                     /**< @brief Number of entries used in headerIndex. */
+        bool headerIndexInValue;                                                      /**< @brief true if the last header callback while filling the header buffer was for a header value. */
+        bool headerIndexOverflow;                                                     /**< @brief true if a header could not be indexed, so the header buffer must be parsed to search for it. */
+        bool headerIndexComplete;                                                     /**< @brief true if all of the headers of the response are in headerIndex. */
+    #endif
 } _httpsResponse_t;
 
 /**
@@ -480,6 +555,54 @@ typedef struct _httpsRequest
     bool scheduled;                             /**< @brief Set to true when this request has already been scheduled to the task pool. */
 } _httpsRequest_t;
 
+/**
+ * @brief The state of an entry in a connection pool.
+ */
+typedef enum IotHttpsPoolEntryState
+{
+    POOL_ENTRY_STATE_FREE = 0, /**< @brief The entry has no connection. */
+    POOL_ENTRY_STATE_IDLE,     /**< @brief The entry has an open connection that is waiting to be acquired. */
+    POOL_ENTRY_STATE_IN_USE    /**< @brief The connection is acquired by the application, or is being connected or closed. */
+} IotHttpsPoolEntryState_t;
+
+/**
+ * @brief A connection slot in a connection pool.
+ *
+ * The host name and ALPN protocols are copied here because the strings in the #IotHttpsConnectionInfo_t used to
+ * create the connection are not required to live longer than the call to IotHttpsClient_AcquireConnection().
+ */
+typedef struct _httpsPoolEntry
+{
+    IotHttpsPoolEntryState_t state;                             /**< @brief See #IotHttpsPoolEntryState_t. */
+    struct _httpsConnection * pHttpsConnection;                 /**< @brief The connection context, in pConnUserBuffer, when the entry is not free. */
+    uint8_t * pConnUserBuffer;                                  /**< @brief The connection user buffer of this entry. */
+    uint64_t idleSinceMs;                                       /**< @brief The time the connection was released to the pool. */
+    const IotNetworkInterface_t * pNetworkInterface;            /**< @brief The network interface the connection was created with. */
+    uint32_t flags;                                             /**< @brief #IotHttpsConnectionInfo_t.flags the connection was created with. */
+    uint16_t port;                                              /**< @brief The remote port of the connection. */
+    uint32_t addressLen;                                        /**< @brief The length of pAddress. */
+    uint32_t alpnProtocolsLen;                                  /**< @brief The length of pAlpnProtocols. */
+    char pAddress[ IOT_HTTPS_MAX_HOST_NAME_LENGTH ];            /**< @brief The remote host name of the connection. */
+    char pAlpnProtocols[ IOT_HTTPS_MAX_ALPN_PROTOCOLS_LENGTH ]; /**< @brief The ALPN protocols of the connection. */
+} _httpsPoolEntry_t;
+
+/**
+ * @brief Represents a pool of HTTP connections that are kept open to be used again.
+ *
+ * The pool context is at the start of #IotHttpsConnectionPoolInfo_t.userBuffer. It is followed by the entries and then
+ * by the connection user buffer of each entry.
+ */
+typedef struct _httpsConnectionPool
+{
+    IotMutex_t poolMutex;           /**< @brief Mutex protecting the state of the entries. */
+    uint32_t connectionBufferLen;   /**< @brief The length of the connection user buffer of each entry. */
+    uint32_t maxIdleConnections;    /**< @brief The maximum number of idle connections kept open. 0 for no limit. */
+    uint32_t maxConnectionsPerHost; /**< @brief The maximum number of connections to the same server. 0 for no limit. */
+    uint32_t idleTimeoutMs;         /**< @brief The time after which an idle connection is not used again. 0 for no limit. */
+    uint32_t entryCount;            /**< @brief The number of entries in the pool. */
+    _httpsPoolEntry_t entries[];    /**< @brief The connection slots of the pool. */
+} _httpsConnectionPool_t;
+
 /*-----------------------------------------------------------*/
 
 /**
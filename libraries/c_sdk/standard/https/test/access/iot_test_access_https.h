@@ -51,5 +51,14 @@ IotHttpsReturnCode_t IotTestHttps_initializeResponse( IotHttpsResponseHandle_t *
 void IotTestHttps_networkReceiveCallback( void * pNetworkConnection,
                                           void * pReceiveContext );
 
+/**
+ * @brief Test access function for #_parseHttpsMessage.
+ *
+ * @see #_parseHttpsMessage.
+ */
+IotHttpsReturnCode_t IotTestHttps_parseHttpsMessage( _httpParserInfo_t * pHttpParserInfo,
+                                                     char * pBuf,
+                                                     size_t len );
+
 
 #endif /* ifndef IOT_TEST_ACCESS_HTTPS_ */
@@ -51,3 +51,12 @@ void IotTestHttps_networkReceiveCallback( void * pNetworkConnection,
 }
 
 /*-----------------------------------------------------------*/
+
+IotHttpsReturnCode_t IotTestHttps_parseHttpsMessage( _httpParserInfo_t * pHttpParserInfo,
+                                                     char * pBuf,
+                                                     size_t len )
+{
+    return _parseHttpsMessage( pHttpParserInfo, pBuf, len );
+}
+
+/*-----------------------------------------------------------*/
@@ -52,6 +52,13 @@
  */
 #define HTTPS_TEST_NETWORK_RECEIVE_CALLBACK_WAIT_MS    ( ( uint32_t ) 300 )
 
+/**
+ * @brief A short response that the server sends back-to-back for each pipelined request.
+ *
+ * The body is the start of the generic test body so that the shared readReadyCallback can verify it.
+ */
+#define HTTPS_TEST_PIPELINED_RESPONSE                  "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nab"
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -110,6 +117,16 @@ static IotHttpsResponseInfo_t _pAsyncRespInfos[ HTTPS_TEST_MAX_ASYNC_REQUESTS ]
 static IotHttpsRequestHandle_t _pAsyncRequestHandles[ HTTPS_TEST_MAX_ASYNC_REQUESTS ];   /**< @brief Request handles for scheduling multiple requests. */
 static IotHttpsResponseHandle_t _pAsyncResponseHandles[ HTTPS_TEST_MAX_ASYNC_REQUESTS ]; /**< @brief Response handles for scheduling multiple requests. */
 
+/**
+ * @brief A connection user buffer with room for pipelined response bytes after the connection context.
+ */
+static uint8_t _pPipelinedConnUserBuffer[ HTTPS_TEST_CONN_USER_BUFFER_SIZE + HTTPS_TEST_PIPELINE_BUFFER_SIZE ] = { 0 };
+
+/**
+ * @brief The number of requests whose body was sent by _networkSendPipelined().
+ */
+static uint8_t _pipelinedRequestsSent = 0;
+
 /**
  * @brief A base IotHttpsAsyncInfo_t to copy to each of the request information configurations for each request.
  *
@@ -465,6 +482,64 @@ static size_t _networkSendSuccessWithSettingParseFailForBody( void * pConnection
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Network abstraction send function that succeeds without a response following.
+ *
+ * The pipelining tests invoke the network receive callback themselves once all of the requests they expect have been
+ * sent, so this only counts the requests sent.
+ */
+static size_t _networkSendPipelined( void * pConnection,
+                                     const uint8_t * pMessage,
+                                     size_t messageLength )
+{
+    _httpsRequest_t * pHttpsRequest = ( _httpsRequest_t * ) pConnection;
+
+    /* The body is sent last, see _networkSendSuccess(). */
+    if( pHttpsRequest->pBody == pMessage )
+    {
+        _pipelinedRequestsSent++;
+    }
+
+    return messageLength;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Network abstraction receive function that mimics the server closing the connection.
+ */
+static size_t _networkReceiveDisconnected( void * pConnection,
+                                           uint8_t * pBuffer,
+                                           size_t bytesRequested )
+{
+    ( void ) pConnection;
+    ( void ) pBuffer;
+    ( void ) bytesRequested;
+
+    return 0;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get a connected pipelined connection handle using _pPipelinedConnUserBuffer.
+ */
+static IotHttpsConnectionHandle_t _getPipelinedConnHandle( void )
+{
+    IotHttpsConnectionHandle_t connHandle = IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER;
+    IotHttpsConnectionInfo_t connInfo = _connInfo;
+
+    connInfo.flags |= IOT_HTTPS_ENABLE_PIPELINING;
+    connInfo.userBuffer.pBuffer = _pPipelinedConnUserBuffer;
+    connInfo.userBuffer.bufferLen = sizeof( _pPipelinedConnUserBuffer );
+    _networkInterface.create = _networkCreateSuccess;
+    _networkInterface.setReceiveCallback = _setReceiveCallbackSuccess;
+    IotHttpsClient_Connect( &connHandle, &connInfo );
+    return connHandle;
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Asynchronous #IotHttpsClientCallbacks_t.appendHeaderCallback implementation to share among the tests.
  */
@@ -683,6 +758,7 @@ TEST_SETUP( HTTPS_Client_Unit_Async )
     ( void ) memset( &_networkInterface, 0x00, sizeof( IotNetworkInterface_t ) );
     ( void ) memset( _pRespMessageBuffer, 0x00, sizeof( _pRespMessageBuffer ) );
     _nextRespMessageBufferByteToReceive = 0;
+    _pipelinedRequestsSent = 0;
 }
 
 /*-----------------------------------------------------------*/
@@ -727,6 +803,8 @@ TEST_GROUP_RUNNER( HTTPS_Client_Unit_Async )
     RUN_TEST_CASE( HTTPS_Client_Unit_Async, SendAsyncMultipleRequestsFirstIsNonPersistent );
     RUN_TEST_CASE( HTTPS_Client_Unit_Async, SendAsyncMultipleRequestsFirstIgnoresPresentResponseBody );
     RUN_TEST_CASE( HTTPS_Client_Unit_Async, SendAsyncMultipleRequestsOneGetsCancelled );
+    RUN_TEST_CASE( HTTPS_Client_Unit_Async, SendAsyncPipelinedRequestsSentBackToBack );
+    RUN_TEST_CASE( HTTPS_Client_Unit_Async, SendAsyncPipelinedDisconnectAbortsPending );
     RUN_TEST_CASE( HTTPS_Client_Unit_Async, SendAsyncChunkedResponse );
 }
 
@@ -2030,6 +2108,154 @@ TEST( HTTPS_Client_Unit_Async, SendAsyncMultipleRequestsOneGetsCancelled )
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Verify that requests on a pipelined connection are all sent before the first response is received, and that
+ * their responses are then received from a single network read.
+ */
+TEST( HTTPS_Client_Unit_Async, SendAsyncPipelinedRequestsSentBackToBack )
+{
+    IotHttpsReturnCode_t returnCode = IOT_HTTPS_OK;
+    IotHttpsConnectionHandle_t connHandle = IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER;
+    int reqIndex = 0;
+
+    _networkInterface.send = _networkSendPipelined;
+    _networkInterface.receiveUpto = _networkReceiveSuccess;
+    _networkInterface.close = _networkCloseSuccess;
+    _networkInterface.destroy = _networkDestroySuccess;
+
+    connHandle = _getPipelinedConnHandle();
+    TEST_ASSERT_NOT_NULL( connHandle );
+
+    /* This test is only valid if all of the requests can be outstanding at once. */
+    TEST_ASSERT_GREATER_THAN( HTTPS_TEST_MAX_ASYNC_REQUESTS - 1, connHandle->maxOutstandingResponses );
+
+    for( reqIndex = 0; reqIndex < HTTPS_TEST_MAX_ASYNC_REQUESTS; reqIndex++ )
+    {
+        _pAsyncRequestHandles[ reqIndex ] = _getReqHandle( &( _pAsyncReqInfos[ reqIndex ] ) );
+        TEST_ASSERT_NOT_NULL( _pAsyncRequestHandles[ reqIndex ] );
+    }
+
+    _verifParams.numRequestsTotal = HTTPS_TEST_MAX_ASYNC_REQUESTS;
+    _verifParams.numRequestsLeft = HTTPS_TEST_MAX_ASYNC_REQUESTS;
+
+    for( reqIndex = 0; reqIndex < HTTPS_TEST_MAX_ASYNC_REQUESTS; reqIndex++ )
+    {
+        returnCode = IotHttpsClient_SendAsync( connHandle,
+                                               _pAsyncRequestHandles[ reqIndex ],
+                                               &( _pAsyncResponseHandles[ reqIndex ] ),
+                                               &( _pAsyncRespInfos[ reqIndex ] ) );
+        TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    }
+
+    /* Give the task pool time to send the requests. No response is received in the meantime. */
+    IotClock_SleepMs( HTTPS_TEST_NETWORK_RECEIVE_CALLBACK_WAIT_MS );
+
+    TEST_ASSERT_EQUAL( HTTPS_TEST_MAX_ASYNC_REQUESTS, _pipelinedRequestsSent );
+    TEST_ASSERT_EQUAL( HTTPS_TEST_MAX_ASYNC_REQUESTS, IotDeQueue_Count( &( connHandle->respQ ) ) );
+    TEST_ASSERT_EQUAL( true, IotDeQueue_IsEmpty( &( connHandle->reqQ ) ) );
+    TEST_ASSERT_EQUAL( 0, _verifParams.responseCompleteCallbackCount );
+
+    /* The server answers all of the requests back-to-back, so they are received in one network read. */
+    for( reqIndex = 0; reqIndex < HTTPS_TEST_MAX_ASYNC_REQUESTS; reqIndex++ )
+    {
+        strcat( ( char * ) _pRespMessageBuffer, HTTPS_TEST_PIPELINED_RESPONSE );
+    }
+
+    IotTestHttps_networkReceiveCallback( connHandle->pNetworkConnection, connHandle );
+
+    TEST_ASSERT_TRUE( IotSemaphore_TimedWait( &( _verifParams.completeSem ), HTTPS_TEST_ASYNC_TIMEOUT_MS ) );
+
+    for( reqIndex = 0; reqIndex < HTTPS_TEST_MAX_ASYNC_REQUESTS; reqIndex++ )
+    {
+        TEST_ASSERT_EQUAL( IOT_HTTPS_OK, _verifParams.returnCode[ reqIndex ] );
+    }
+
+    TEST_ASSERT_EQUAL( HTTPS_TEST_MAX_ASYNC_REQUESTS, _verifParams.readReadyCallbackCount );
+    TEST_ASSERT_EQUAL( HTTPS_TEST_MAX_ASYNC_REQUESTS, _verifParams.responseCompleteCallbackCount );
+    TEST_ASSERT_EQUAL( 0, _verifParams.connectionClosedCallbackCount );
+    TEST_ASSERT_EQUAL( 0, _verifParams.errorCallbackCount );
+    /* Verify that the whole network read was used and the connection is still open. */
+    TEST_ASSERT_EQUAL( strlen( ( char * ) _pRespMessageBuffer ), _nextRespMessageBufferByteToReceive );
+    TEST_ASSERT_EQUAL( 0, connHandle->pipelineDataLen );
+    TEST_ASSERT_TRUE( connHandle->isConnected );
+    TEST_ASSERT_EQUAL( true, IotDeQueue_IsEmpty( &( connHandle->respQ ) ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Verify that when a pipelined connection is closed by the server, the responses still expected are aborted and
+ * the requests not sent yet are dropped.
+ */
+TEST( HTTPS_Client_Unit_Async, SendAsyncPipelinedDisconnectAbortsPending )
+{
+    IotHttpsReturnCode_t returnCode = IOT_HTTPS_OK;
+    IotHttpsConnectionHandle_t connHandle = IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER;
+    int reqIndex = 0;
+
+    /* This test is only valid if there are 3 or more async requests available to schedule. */
+    TEST_ASSERT_GREATER_THAN( 2, HTTPS_TEST_MAX_ASYNC_REQUESTS );
+
+    _networkInterface.send = _networkSendPipelined;
+    _networkInterface.receiveUpto = _networkReceiveDisconnected;
+    _networkInterface.close = _networkCloseSuccess;
+    _networkInterface.destroy = _networkDestroySuccess;
+
+    connHandle = _getPipelinedConnHandle();
+    TEST_ASSERT_NOT_NULL( connHandle );
+
+    /* Keep the last request in the queue, waiting for a response slot. */
+    connHandle->maxOutstandingResponses = HTTPS_TEST_MAX_ASYNC_REQUESTS - 1;
+
+    for( reqIndex = 0; reqIndex < HTTPS_TEST_MAX_ASYNC_REQUESTS; reqIndex++ )
+    {
+        _pAsyncRequestHandles[ reqIndex ] = _getReqHandle( &( _pAsyncReqInfos[ reqIndex ] ) );
+        TEST_ASSERT_NOT_NULL( _pAsyncRequestHandles[ reqIndex ] );
+    }
+
+    _verifParams.numRequestsTotal = HTTPS_TEST_MAX_ASYNC_REQUESTS;
+    _verifParams.numRequestsLeft = HTTPS_TEST_MAX_ASYNC_REQUESTS;
+
+    for( reqIndex = 0; reqIndex < HTTPS_TEST_MAX_ASYNC_REQUESTS; reqIndex++ )
+    {
+        returnCode = IotHttpsClient_SendAsync( connHandle,
+                                               _pAsyncRequestHandles[ reqIndex ],
+                                               &( _pAsyncResponseHandles[ reqIndex ] ),
+                                               &( _pAsyncRespInfos[ reqIndex ] ) );
+        TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    }
+
+    /* Give the task pool time to send the requests. */
+    IotClock_SleepMs( HTTPS_TEST_NETWORK_RECEIVE_CALLBACK_WAIT_MS );
+
+    TEST_ASSERT_EQUAL( HTTPS_TEST_MAX_ASYNC_REQUESTS - 1, _pipelinedRequestsSent );
+    TEST_ASSERT_EQUAL( HTTPS_TEST_MAX_ASYNC_REQUESTS - 1, IotDeQueue_Count( &( connHandle->respQ ) ) );
+    TEST_ASSERT_EQUAL( 1, IotDeQueue_Count( &( connHandle->reqQ ) ) );
+
+    /* The server closes the connection before the first response. */
+    IotTestHttps_networkReceiveCallback( connHandle->pNetworkConnection, connHandle );
+
+    TEST_ASSERT_TRUE( IotSemaphore_TimedWait( &( _verifParams.completeSem ), HTTPS_TEST_ASYNC_TIMEOUT_MS ) );
+
+    /* The pending requests are completed before the one that failed, when the connection is closed. */
+    TEST_ASSERT_EQUAL( IOT_HTTPS_RECEIVE_ABORT, _verifParams.returnCode[ 0 ] );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_SEND_ABORT, _verifParams.returnCode[ 1 ] );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_NETWORK_ERROR, _verifParams.returnCode[ 2 ] );
+    TEST_ASSERT_EQUAL( HTTPS_TEST_MAX_ASYNC_REQUESTS - 1, _verifParams.appendHeaderCallbackCount );
+    TEST_ASSERT_EQUAL( HTTPS_TEST_MAX_ASYNC_REQUESTS - 1, _verifParams.writeCallbackCount );
+    TEST_ASSERT_EQUAL( 0, _verifParams.readReadyCallbackCount );
+    TEST_ASSERT_EQUAL( HTTPS_TEST_MAX_ASYNC_REQUESTS, _verifParams.responseCompleteCallbackCount );
+    TEST_ASSERT_EQUAL( HTTPS_TEST_MAX_ASYNC_REQUESTS, _verifParams.errorCallbackCount );
+    TEST_ASSERT_EQUAL( 1, _verifParams.connectionClosedCallbackCount );
+    /* Verify that the connection is closed. */
+    TEST_ASSERT_FALSE( connHandle->isConnected );
+    /* Verify that there are no pending requests or responses. */
+    TEST_ASSERT_EQUAL( true, IotDeQueue_IsEmpty( &( connHandle->reqQ ) ) );
+    TEST_ASSERT_EQUAL( true, IotDeQueue_IsEmpty( &( connHandle->respQ ) ) );
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Test receiving a chunked HTTP response message in the asynchronous workflow.
  */
@@ -30,6 +30,9 @@
 
 #include "iot_tests_https_common.h"
 
+/* Platform layer includes. */
+#include "platform/iot_clock.h"
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -77,6 +80,64 @@
     "xserver: www1021\r\n\r\n"
 #define HTTPS_TEST_RESPONSE_HEADER_LINES_NO_CONTENT_LENGTH_LENGTH    sizeof( HTTPS_TEST_RESPONSE_HEADER_LINES_NO_CONTENT_LENGTH ) - 1 /**< @brief Length of the HTTP test response headers where there is no Content-Length. */
 
+/**
+ * @brief Complete header lines, that fit in the test header buffer, to share among the header index tests.
+ */
+#define HTTPS_TEST_RESPONSE_HEADER_LINES_COMPLETE \
+    "HTTP/1.1 200 OK\r\n"                         \
+    "Content-Length: 43\r\n"                      \
+    "ETag: \"3356-5233\"\r\n"                     \
+    "Vary: *\r\n"                                 \
+    "xserver: www1021\r\n\r\n"
+#define HTTPS_TEST_RESPONSE_HEADER_LINES_COMPLETE_LENGTH    sizeof( HTTPS_TEST_RESPONSE_HEADER_LINES_COMPLETE ) - 1 /**< @brief The length of the complete HTTP response test header lines. */
+
+/**
+ * @brief Complete header lines with more headers than the default size of the header index.
+ */
+#define HTTPS_TEST_RESPONSE_HEADER_LINES_MANY \
+    "HTTP/1.1 200 OK\r\n"                     \
+    "h1: 1\r\n"                               \
+    "h2: 2\r\n"                               \
+    "h3: 3\r\n"                               \
+    "h4: 4\r\n"                               \
+    "h5: 5\r\n"                               \
+    "h6: 6\r\n"                               \
+    "h7: 7\r\n"                               \
+    "h8: 8\r\n"                               \
+    "h9: 9\r\n"                               \
+    "h10: 10\r\n\r\n"
+#define HTTPS_TEST_RESPONSE_HEADER_LINES_MANY_LENGTH    sizeof( HTTPS_TEST_RESPONSE_HEADER_LINES_MANY ) - 1 /**< @brief The length of the HTTP response test header lines with many headers. */
+
+/**
+ * @brief The number of times each header is read in the header read benchmark.
+ */
+#define HTTPS_TEST_HEADER_READ_ITERATIONS    ( 2000 )
+
+/**
+ * Two responses to pipelined requests that are received in a single network read.
+ */
+#define HTTPS_TEST_PIPELINED_RESPONSE_FIRST     "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok" /**< @brief The first pipelined test response. */
+#define HTTPS_TEST_PIPELINED_RESPONSE_SECOND    "HTTP/1.1 204 No Content\r\n\r\n"                /**< @brief The second pipelined test response. */
+#define HTTPS_TEST_PIPELINED_RESPONSES          HTTPS_TEST_PIPELINED_RESPONSE_FIRST HTTPS_TEST_PIPELINED_RESPONSE_SECOND
+
+/**
+ * @brief The number of connections in the test connection pool.
+ */
+#define HTTPS_TEST_POOL_CONNECTIONS            ( 2 )
+
+/**
+ * @brief The connection user buffer size of each pooled connection, rounded up like the pool does.
+ */
+#define HTTPS_TEST_POOL_CONN_BUFFER_SIZE                                         \
+    ( ( ( HTTPS_TEST_CONN_USER_BUFFER_SIZE + HTTPS_POOL_CONNECTION_BUFFER_ALIGNMENT - 1 ) / \
+        HTTPS_POOL_CONNECTION_BUFFER_ALIGNMENT ) * HTTPS_POOL_CONNECTION_BUFFER_ALIGNMENT )
+
+/**
+ * @brief The size of the test connection pool user buffer.
+ */
+#define HTTPS_TEST_POOL_USER_BUFFER_SIZE \
+    ( sizeof( _httpsConnectionPool_t ) + HTTPS_TEST_POOL_CONNECTIONS * ( sizeof( _httpsPoolEntry_t ) + HTTPS_TEST_POOL_CONN_BUFFER_SIZE ) )
+
 /**
  * Header name and values to verify reading the header.
  */
@@ -85,6 +146,8 @@
 #define HTTPS_NONEXISTENT_HEADER                                     "Non-Existent-Header"           /**< @brief HTTP header field name of a non-existing header for testing. */
 #define HTTPS_DATE_HEADER_VALUE                                      "Sun, 14 Jul 2019 06:07:52 GMT" /**< @brief Test header value for the "Date" header field. */
 #define HTTPS_ETAG_HEADER_VALUE                                      "\"3356-5233\""                 /**< @brief Test header value for the "ETag" header field. */
+#define HTTPS_XSERVER_HEADER                                         "xserver"                       /**< @brief "xserver" HTTP header field name. */
+#define HTTPS_XSERVER_HEADER_VALUE                                   "www1021"                       /**< @brief Test header value for the "xserver" header field. */
 #define HTTPS_CONTENT_LENGTH_VALUE                                   ( ( uint32_t ) 43 )             /**< @brief Test header value as a unsigned integer for the "Content-Length" header field. */
 
 /**
@@ -133,6 +196,21 @@ static IotHttpsResponseInfo_t _respInfo =
     .pSyncInfo            = NULL
 };
 
+/**
+ * @brief A connection user buffer with room for pipelined response bytes after the connection context.
+ */
+static uint8_t _pPipelinedConnUserBuffer[ HTTPS_TEST_CONN_USER_BUFFER_SIZE + HTTPS_TEST_PIPELINE_BUFFER_SIZE ] = { 0 };
+
+/**
+ * @brief The user buffer of the test connection pool.
+ */
+static uint8_t _pPoolUserBuffer[ HTTPS_TEST_POOL_USER_BUFFER_SIZE ] = { 0 };
+
+/**
+ * @brief The number of network connections created, to check when the connection pool connects.
+ */
+static uint32_t _networkCreateCount = 0;
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -250,6 +328,22 @@ static IotNetworkError_t _networkCreateFail( void * pConnectionInfo,
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Network Abstraction create function that succeeds and counts the connections made.
+ */
+static IotNetworkError_t _networkCreateCounted( void * pConnectionInfo,
+                                                void * pCredentialInfo,
+                                                void ** pConnection )
+{
+    ( void ) pConnectionInfo;
+    ( void ) pCredentialInfo;
+    ( void ) pConnection;
+    _networkCreateCount++;
+    return IOT_NETWORK_SUCCESS;
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Network Abstraction setReceiveCallback that fails.
  */
@@ -280,6 +374,43 @@ static size_t _httpParserExecuteFail( http_parser * parser,
     return 0;
 }
 
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Receive the header lines into the header buffer of a response and parse them in the given number of parts.
+ *
+ * This mirrors how the header buffer is filled from the network, so that the header index of the response is built
+ * with the header names and values split over the parts.
+ */
+static void _receiveTestHeaders( IotHttpsResponseHandle_t respHandle,
+                                 const char * pHeaderLines,
+                                 size_t headerLinesLength,
+                                 const size_t * pSplits,
+                                 size_t numSplits )
+{
+    IotHttpsReturnCode_t returnCode = IOT_HTTPS_OK;
+    size_t partStart = 0;
+    size_t partEnd = 0;
+    size_t i = 0;
+
+    TEST_ASSERT_TRUE( headerLinesLength <= ( size_t ) ( respHandle->pHeadersEnd - respHandle->pHeadersCur ) );
+    memcpy( respHandle->pHeaders, pHeaderLines, headerLinesLength );
+    respHandle->bufferProcessingState = PROCESSING_STATE_FILLING_HEADER_BUFFER;
+
+    for( i = 0; i <= numSplits; i++ )
+    {
+        partEnd = ( i < numSplits ) ? pSplits[ i ] : headerLinesLength;
+        returnCode = IotTestHttps_parseHttpsMessage( &( respHandle->httpParserInfo ),
+                                                     ( char * ) ( respHandle->pHeaders + partStart ),
+                                                     partEnd - partStart );
+        TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+        partStart = partEnd;
+    }
+
+    respHandle->bufferProcessingState = PROCESSING_STATE_FINISHED;
+    TEST_ASSERT_EQUAL( PARSER_STATE_HEADERS_COMPLETE, respHandle->parserState );
+}
+
 
 /*-----------------------------------------------------------*/
 
@@ -327,9 +458,13 @@ TEST_GROUP_RUNNER( HTTPS_Client_Unit_API )
     RUN_TEST_CASE( HTTPS_Client_Unit_API, ConnectInvalidParameters );
     RUN_TEST_CASE( HTTPS_Client_Unit_API, ConnectFailure );
     RUN_TEST_CASE( HTTPS_Client_Unit_API, ConnectSuccess );
+    RUN_TEST_CASE( HTTPS_Client_Unit_API, ConnectPipelinedKeepsNextResponse );
     RUN_TEST_CASE( HTTPS_Client_Unit_API, DisconnectInvalidParameters );
     RUN_TEST_CASE( HTTPS_Client_Unit_API, DisconnectFailure );
     RUN_TEST_CASE( HTTPS_Client_Unit_API, DisconnectSuccess );
+    RUN_TEST_CASE( HTTPS_Client_Unit_API, ConnectionPoolInvalidParameters );
+    RUN_TEST_CASE( HTTPS_Client_Unit_API, ConnectionPoolReusesConnection );
+    RUN_TEST_CASE( HTTPS_Client_Unit_API, ConnectionPoolLimits );
     RUN_TEST_CASE( HTTPS_Client_Unit_API, InitializeRequestInvalidParameters );
     RUN_TEST_CASE( HTTPS_Client_Unit_API, InitializeRequestFormatCheck );
     RUN_TEST_CASE( HTTPS_Client_Unit_API, AddHeaderInvalidParameters );
@@ -337,6 +472,9 @@ TEST_GROUP_RUNNER( HTTPS_Client_Unit_API )
     RUN_TEST_CASE( HTTPS_Client_Unit_API, AddHeaderMultipleHeaders );
     RUN_TEST_CASE( HTTPS_Client_Unit_API, ReadHeaderInvalidParameters );
     RUN_TEST_CASE( HTTPS_Client_Unit_API, ReadHeaderVaryingValues );
+    RUN_TEST_CASE( HTTPS_Client_Unit_API, ReadHeaderIndexed );
+    RUN_TEST_CASE( HTTPS_Client_Unit_API, ReadHeaderIndexOverflow );
+    RUN_TEST_CASE( HTTPS_Client_Unit_API, ReadHeaderBenchmark );
     RUN_TEST_CASE( HTTPS_Client_Unit_API, ReadContentLengthInvalidParameters );
     RUN_TEST_CASE( HTTPS_Client_Unit_API, ReadContentLengthSuccess );
     RUN_TEST_CASE( HTTPS_Client_Unit_API, ReadContentLengthNotFound );
@@ -524,6 +662,84 @@ TEST( HTTPS_Client_Unit_API, ConnectSuccess )
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Test that a pipelined connection keeps the bytes of the next response that are received with the current one.
+ */
+TEST( HTTPS_Client_Unit_API, ConnectPipelinedKeepsNextResponse )
+{
+    IotHttpsReturnCode_t returnCode = IOT_HTTPS_OK;
+    IotHttpsConnectionHandle_t connHandle = IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER;
+    IotHttpsRequestHandle_t reqHandle = IOT_HTTPS_REQUEST_HANDLE_INITIALIZER;
+    IotHttpsResponseHandle_t respHandle = IOT_HTTPS_RESPONSE_HANDLE_INITIALIZER;
+    IotHttpsConnectionInfo_t connInfo = _connInfo;
+    char pResponses[] = HTTPS_TEST_PIPELINED_RESPONSES;
+
+    /* The rest of the connection user buffer is used for pipelining. */
+    connInfo.flags |= IOT_HTTPS_ENABLE_PIPELINING;
+    connInfo.userBuffer.pBuffer = _pPipelinedConnUserBuffer;
+    connInfo.userBuffer.bufferLen = sizeof( _pPipelinedConnUserBuffer );
+    _networkInterface.create = _networkCreateSuccess;
+    _networkInterface.setReceiveCallback = _setReceiveCallbackSuccess;
+    returnCode = IotHttpsClient_Connect( &connHandle, &connInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_NOT_NULL( connHandle );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_MAX_PIPELINED_REQUESTS, connHandle->maxOutstandingResponses );
+    TEST_ASSERT_EQUAL( HTTPS_TEST_PIPELINE_BUFFER_SIZE, connHandle->pipelineBufLen );
+
+    /* Parsing the first response keeps the second response for the next network read. */
+    reqHandle = _getReqHandle( &_reqInfo );
+    TEST_ASSERT_NOT_NULL( reqHandle );
+    respHandle = _getRespHandle( &_respInfo, reqHandle );
+    TEST_ASSERT_NOT_NULL( respHandle );
+    respHandle->pHttpsConnection = connHandle;
+    respHandle->bufferProcessingState = PROCESSING_STATE_FINISHED;
+    returnCode = IotTestHttps_parseHttpsMessage( &( respHandle->httpParserInfo ), pResponses, sizeof( pResponses ) - 1 );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_EQUAL( PARSER_STATE_BODY_COMPLETE, respHandle->parserState );
+    TEST_ASSERT_EQUAL( sizeof( HTTPS_TEST_PIPELINED_RESPONSE_SECOND ) - 1, connHandle->pipelineDataLen );
+    TEST_ASSERT_EQUAL( 0, memcmp( connHandle->pPipelineData,
+                                  HTTPS_TEST_PIPELINED_RESPONSE_SECOND,
+                                  sizeof( HTTPS_TEST_PIPELINED_RESPONSE_SECOND ) - 1 ) );
+
+    /* The kept bytes are a complete second response. */
+    respHandle = _getRespHandle( &_respInfo, reqHandle );
+    TEST_ASSERT_NOT_NULL( respHandle );
+    respHandle->pHttpsConnection = connHandle;
+    respHandle->bufferProcessingState = PROCESSING_STATE_FINISHED;
+    memcpy( pResponses, connHandle->pPipelineData, connHandle->pipelineDataLen );
+    returnCode = IotTestHttps_parseHttpsMessage( &( respHandle->httpParserInfo ), pResponses, connHandle->pipelineDataLen );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_EQUAL( PARSER_STATE_BODY_COMPLETE, respHandle->parserState );
+
+    /* If the next response does not fit, then the connection is marked to be closed. */
+    connHandle->pipelineDataLen = 0;
+    connHandle->pipelineBufLen = sizeof( HTTPS_TEST_PIPELINED_RESPONSE_SECOND ) - 2;
+    memcpy( pResponses, HTTPS_TEST_PIPELINED_RESPONSES, sizeof( pResponses ) );
+    respHandle = _getRespHandle( &_respInfo, reqHandle );
+    TEST_ASSERT_NOT_NULL( respHandle );
+    respHandle->pHttpsConnection = connHandle;
+    respHandle->bufferProcessingState = PROCESSING_STATE_FINISHED;
+    returnCode = IotTestHttps_parseHttpsMessage( &( respHandle->httpParserInfo ), pResponses, sizeof( pResponses ) - 1 );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_EQUAL( 0, connHandle->pipelineDataLen );
+    TEST_ASSERT_TRUE( connHandle->pipelineDataLost );
+
+    /* Without pipelining the bytes after the end of the response are ignored. */
+    connHandle = _getConnHandle();
+    TEST_ASSERT_NOT_NULL( connHandle );
+    TEST_ASSERT_EQUAL( 1, connHandle->maxOutstandingResponses );
+    respHandle = _getRespHandle( &_respInfo, reqHandle );
+    TEST_ASSERT_NOT_NULL( respHandle );
+    respHandle->pHttpsConnection = connHandle;
+    respHandle->bufferProcessingState = PROCESSING_STATE_FINISHED;
+    returnCode = IotTestHttps_parseHttpsMessage( &( respHandle->httpParserInfo ), pResponses, sizeof( pResponses ) - 1 );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_EQUAL( PARSER_STATE_BODY_COMPLETE, respHandle->parserState );
+    TEST_ASSERT_EQUAL( 0, connHandle->pipelineDataLen );
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Test various invalid parameters in the @ref https_client_function_disconnect API.
  */
@@ -626,6 +842,199 @@ TEST( HTTPS_Client_Unit_API, DisconnectSuccess )
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Test various invalid parameters in the connection pool APIs.
+ */
+TEST( HTTPS_Client_Unit_API, ConnectionPoolInvalidParameters )
+{
+    IotHttpsReturnCode_t returnCode = IOT_HTTPS_OK;
+    IotHttpsConnectionPoolHandle_t poolHandle = IOT_HTTPS_CONNECTION_POOL_HANDLE_INITIALIZER;
+    IotHttpsConnectionHandle_t connHandle = IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER;
+    IotHttpsConnectionPoolInfo_t poolInfo = IOT_HTTPS_CONNECTION_POOL_INFO_INITIALIZER;
+
+    poolInfo.userBuffer.pBuffer = _pPoolUserBuffer;
+    poolInfo.userBuffer.bufferLen = sizeof( _pPoolUserBuffer );
+    poolInfo.connectionBufferLen = HTTPS_TEST_CONN_USER_BUFFER_SIZE;
+
+    /* NULL pPoolHandle. */
+    returnCode = IotHttpsClient_CreateConnectionPool( NULL, &poolInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_INVALID_PARAMETER, returnCode );
+
+    /* NULL pPoolInfo. */
+    returnCode = IotHttpsClient_CreateConnectionPool( &poolHandle, NULL );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_INVALID_PARAMETER, returnCode );
+    TEST_ASSERT_NULL( poolHandle );
+
+    /* Connection user buffers that cannot fit a connection context. */
+    poolInfo.connectionBufferLen = connectionUserBufferMinimumSize - 1;
+    returnCode = IotHttpsClient_CreateConnectionPool( &poolHandle, &poolInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_INSUFFICIENT_MEMORY, returnCode );
+    TEST_ASSERT_NULL( poolHandle );
+
+    /* A pool user buffer that cannot fit a single connection. */
+    poolInfo.connectionBufferLen = HTTPS_TEST_CONN_USER_BUFFER_SIZE;
+    poolInfo.userBuffer.bufferLen = connectionPoolUserBufferMinimumSize + connectionPoolUserBufferSizePerConnection;
+    returnCode = IotHttpsClient_CreateConnectionPool( &poolHandle, &poolInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_INSUFFICIENT_MEMORY, returnCode );
+    TEST_ASSERT_NULL( poolHandle );
+
+    /* NULL parameters to the other pool APIs. */
+    poolInfo.userBuffer.bufferLen = sizeof( _pPoolUserBuffer );
+    returnCode = IotHttpsClient_CreateConnectionPool( &poolHandle, &poolInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_INVALID_PARAMETER, IotHttpsClient_AcquireConnection( NULL, &connHandle, &_connInfo ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_INVALID_PARAMETER, IotHttpsClient_AcquireConnection( poolHandle, NULL, &_connInfo ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_INVALID_PARAMETER, IotHttpsClient_AcquireConnection( poolHandle, &connHandle, NULL ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_INVALID_PARAMETER, IotHttpsClient_ReleaseConnection( NULL, connHandle ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_INVALID_PARAMETER, IotHttpsClient_ReleaseConnection( poolHandle, NULL ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_INVALID_PARAMETER, IotHttpsClient_DestroyConnectionPool( NULL ) );
+
+    /* A connection that was not acquired from the pool. */
+    connHandle = _getConnHandle();
+    TEST_ASSERT_NOT_NULL( connHandle );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_INVALID_PARAMETER, IotHttpsClient_ReleaseConnection( poolHandle, connHandle ) );
+
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, IotHttpsClient_DestroyConnectionPool( poolHandle ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test that a released connection is acquired again without connecting.
+ */
+TEST( HTTPS_Client_Unit_API, ConnectionPoolReusesConnection )
+{
+    IotHttpsReturnCode_t returnCode = IOT_HTTPS_OK;
+    IotHttpsConnectionPoolHandle_t poolHandle = IOT_HTTPS_CONNECTION_POOL_HANDLE_INITIALIZER;
+    IotHttpsConnectionHandle_t connHandle = IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER;
+    IotHttpsConnectionHandle_t firstConnHandle = IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER;
+    IotHttpsConnectionHandle_t secondConnHandle = IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER;
+    IotHttpsConnectionPoolInfo_t poolInfo = IOT_HTTPS_CONNECTION_POOL_INFO_INITIALIZER;
+    IotHttpsConnectionInfo_t otherConnInfo = _connInfo;
+
+    _networkInterface.create = _networkCreateCounted;
+    _networkInterface.setReceiveCallback = _setReceiveCallbackSuccess;
+    _networkInterface.close = _networkCloseSuccess;
+    _networkInterface.destroy = _networkDestroySuccess;
+    _networkCreateCount = 0;
+
+    poolInfo.userBuffer.pBuffer = _pPoolUserBuffer;
+    poolInfo.userBuffer.bufferLen = sizeof( _pPoolUserBuffer );
+    poolInfo.connectionBufferLen = HTTPS_TEST_CONN_USER_BUFFER_SIZE;
+    returnCode = IotHttpsClient_CreateConnectionPool( &poolHandle, &poolInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_EQUAL( HTTPS_TEST_POOL_CONNECTIONS, poolHandle->entryCount );
+
+    /* The first connection is made, then kept open when released. */
+    returnCode = IotHttpsClient_AcquireConnection( poolHandle, &firstConnHandle, &_connInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_NOT_NULL( firstConnHandle );
+    TEST_ASSERT_TRUE( firstConnHandle->isConnected );
+    TEST_ASSERT_EQUAL( 1, _networkCreateCount );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, IotHttpsClient_ReleaseConnection( poolHandle, firstConnHandle ) );
+    TEST_ASSERT_TRUE( firstConnHandle->isConnected );
+
+    /* The same server gets the same connection back without connecting. */
+    returnCode = IotHttpsClient_AcquireConnection( poolHandle, &connHandle, &_connInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_EQUAL_PTR( firstConnHandle, connHandle );
+    TEST_ASSERT_EQUAL( 1, _networkCreateCount );
+
+    /* While it is acquired, the same server gets a second connection. */
+    returnCode = IotHttpsClient_AcquireConnection( poolHandle, &secondConnHandle, &_connInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_NOT_NULL( secondConnHandle );
+    TEST_ASSERT_NOT_EQUAL( firstConnHandle, secondConnHandle );
+    TEST_ASSERT_EQUAL( 2, _networkCreateCount );
+
+    /* The pool is full and all of its connections are acquired. */
+    returnCode = IotHttpsClient_AcquireConnection( poolHandle, &connHandle, &_connInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_BUSY, returnCode );
+    TEST_ASSERT_NULL( connHandle );
+
+    /* The pool cannot be destroyed while connections are acquired. */
+    TEST_ASSERT_EQUAL( IOT_HTTPS_BUSY, IotHttpsClient_DestroyConnectionPool( poolHandle ) );
+
+    /* A different port is a different server, so the idle connection to the first server is closed to make room. */
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, IotHttpsClient_ReleaseConnection( poolHandle, firstConnHandle ) );
+    otherConnInfo.port = HTTPS_TEST_PORT + 1;
+    returnCode = IotHttpsClient_AcquireConnection( poolHandle, &connHandle, &otherConnInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_EQUAL_PTR( firstConnHandle, connHandle );
+    TEST_ASSERT_EQUAL( 3, _networkCreateCount );
+
+    /* A connection closed after a non-persistent request is not kept in the pool. */
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, IotHttpsClient_Disconnect( secondConnHandle ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, IotHttpsClient_ReleaseConnection( poolHandle, secondConnHandle ) );
+    TEST_ASSERT_EQUAL( POOL_ENTRY_STATE_FREE, poolHandle->entries[ 1 ].state );
+
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, IotHttpsClient_ReleaseConnection( poolHandle, connHandle ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, IotHttpsClient_DestroyConnectionPool( poolHandle ) );
+    TEST_ASSERT_FALSE( connHandle->isConnected );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test the per-host, idle connection, and idle time limits of a connection pool.
+ */
+TEST( HTTPS_Client_Unit_API, ConnectionPoolLimits )
+{
+    IotHttpsReturnCode_t returnCode = IOT_HTTPS_OK;
+    IotHttpsConnectionPoolHandle_t poolHandle = IOT_HTTPS_CONNECTION_POOL_HANDLE_INITIALIZER;
+    IotHttpsConnectionHandle_t connHandle = IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER;
+    IotHttpsConnectionHandle_t otherConnHandle = IOT_HTTPS_CONNECTION_HANDLE_INITIALIZER;
+    IotHttpsConnectionPoolInfo_t poolInfo = IOT_HTTPS_CONNECTION_POOL_INFO_INITIALIZER;
+    IotHttpsConnectionInfo_t otherConnInfo = _connInfo;
+
+    _networkInterface.create = _networkCreateCounted;
+    _networkInterface.setReceiveCallback = _setReceiveCallbackSuccess;
+    _networkInterface.close = _networkCloseSuccess;
+    _networkInterface.destroy = _networkDestroySuccess;
+    _networkCreateCount = 0;
+
+    poolInfo.userBuffer.pBuffer = _pPoolUserBuffer;
+    poolInfo.userBuffer.bufferLen = sizeof( _pPoolUserBuffer );
+    poolInfo.connectionBufferLen = HTTPS_TEST_CONN_USER_BUFFER_SIZE;
+    poolInfo.maxConnectionsPerHost = 1;
+    poolInfo.maxIdleConnections = 1;
+    poolInfo.idleTimeoutMs = 1;
+    returnCode = IotHttpsClient_CreateConnectionPool( &poolHandle, &poolInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+
+    /* Only one connection to the same server. */
+    returnCode = IotHttpsClient_AcquireConnection( poolHandle, &connHandle, &_connInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    returnCode = IotHttpsClient_AcquireConnection( poolHandle, &otherConnHandle, &_connInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_BUSY, returnCode );
+    TEST_ASSERT_NULL( otherConnHandle );
+
+    /* Different ALPN protocols are a different server. */
+    otherConnInfo.pAlpnProtocols = NULL;
+    otherConnInfo.alpnProtocolsLen = 0;
+    returnCode = IotHttpsClient_AcquireConnection( poolHandle, &otherConnHandle, &otherConnInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_EQUAL( 2, _networkCreateCount );
+
+    /* Only one connection is kept idle, the second one released is closed. */
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, IotHttpsClient_ReleaseConnection( poolHandle, connHandle ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, IotHttpsClient_ReleaseConnection( poolHandle, otherConnHandle ) );
+    TEST_ASSERT_TRUE( connHandle->isConnected );
+    TEST_ASSERT_FALSE( otherConnHandle->isConnected );
+
+    /* A connection idle for longer than the idle timeout is connected again. */
+    IotClock_SleepMs( 10 );
+    returnCode = IotHttpsClient_AcquireConnection( poolHandle, &otherConnHandle, &_connInfo );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_EQUAL_PTR( connHandle, otherConnHandle );
+    TEST_ASSERT_EQUAL( 3, _networkCreateCount );
+
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, IotHttpsClient_ReleaseConnection( poolHandle, otherConnHandle ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, IotHttpsClient_DestroyConnectionPool( poolHandle ) );
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Test intitializing an HTTP request with various invalid parameters.
  */
@@ -997,6 +1406,155 @@ TEST( HTTPS_Client_Unit_API, ReadHeaderVaryingValues )
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Test IotHttpsClient_ReadHeader() with the headers indexed while the header buffer was filled.
+ */
+TEST( HTTPS_Client_Unit_API, ReadHeaderIndexed )
+{
+    IotHttpsReturnCode_t returnCode = IOT_HTTPS_OK;
+    IotHttpsResponseHandle_t respHandle = IOT_HTTPS_RESPONSE_HANDLE_INITIALIZER;
+    IotHttpsRequestHandle_t reqHandle = IOT_HTTPS_REQUEST_HANDLE_INITIALIZER;
+    char valueBuffer[ HTTPS_TEST_VALUE_BUFFER_LENGTH_LARGE_ENOUGH ] = { 0 };
+    uint32_t contentLength = 0;
+    const char * pHeaderLines = HTTPS_TEST_RESPONSE_HEADER_LINES_COMPLETE;
+    size_t splits[ 2 ] = { 0 };
+
+    /* Split the header lines in the middle of the "ETag" header name and in the middle of the "xserver" value. */
+    splits[ 0 ] = ( size_t ) ( strstr( pHeaderLines, HTTPS_ETAG_HEADER ) - pHeaderLines ) + 2;
+    splits[ 1 ] = ( size_t ) ( strstr( pHeaderLines, HTTPS_XSERVER_HEADER_VALUE ) - pHeaderLines ) + 3;
+
+    reqHandle = _getReqHandle( &_reqInfo );
+    TEST_ASSERT_NOT_NULL( reqHandle );
+    respHandle = _getRespHandle( &_respInfo, reqHandle );
+    TEST_ASSERT_NOT_NULL( respHandle );
+
+    _receiveTestHeaders( respHandle, pHeaderLines, HTTPS_TEST_RESPONSE_HEADER_LINES_COMPLETE_LENGTH, splits, 2 );
+
+    /* HTTPS_TEST_RESPONSE_HEADER_LINES_COMPLETE has four headers. */
+    #if IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE >= 4
+        TEST_ASSERT_TRUE( respHandle->headerIndexComplete );
+
+        /* The header buffer must not be parsed again to read a header. */
+        respHandle->httpParserInfo.parseFunc = _httpParserExecuteFail;
+    #endif
+
+    returnCode = IotHttpsClient_ReadHeader( respHandle, HTTPS_ETAG_HEADER, FAST_MACRO_STRLEN( HTTPS_ETAG_HEADER ), valueBuffer, sizeof( valueBuffer ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_EQUAL_STRING( HTTPS_ETAG_HEADER_VALUE, valueBuffer );
+
+    returnCode = IotHttpsClient_ReadHeader( respHandle, HTTPS_XSERVER_HEADER, FAST_MACRO_STRLEN( HTTPS_XSERVER_HEADER ), valueBuffer, sizeof( valueBuffer ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_EQUAL_STRING( HTTPS_XSERVER_HEADER_VALUE, valueBuffer );
+
+    returnCode = IotHttpsClient_ReadContentLength( respHandle, &contentLength );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_EQUAL( HTTPS_CONTENT_LENGTH_VALUE, contentLength );
+
+    /* The header name must match in length and content. */
+    returnCode = IotHttpsClient_ReadHeader( respHandle, HTTPS_ETAG_HEADER, FAST_MACRO_STRLEN( HTTPS_ETAG_HEADER ) - 1, valueBuffer, sizeof( valueBuffer ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_NOT_FOUND, returnCode );
+    returnCode = IotHttpsClient_ReadHeader( respHandle, HTTPS_NONEXISTENT_HEADER, FAST_MACRO_STRLEN( HTTPS_NONEXISTENT_HEADER ), valueBuffer, sizeof( valueBuffer ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_NOT_FOUND, returnCode );
+
+    /* The value buffer must be large enough for the value and the NULL terminator. */
+    returnCode = IotHttpsClient_ReadHeader( respHandle, HTTPS_ETAG_HEADER, FAST_MACRO_STRLEN( HTTPS_ETAG_HEADER ), valueBuffer, FAST_MACRO_STRLEN( HTTPS_ETAG_HEADER_VALUE ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_INSUFFICIENT_MEMORY, returnCode );
+
+    /* Reading a header must not change the state of the response. */
+    TEST_ASSERT_EQUAL( PROCESSING_STATE_FINISHED, respHandle->bufferProcessingState );
+    TEST_ASSERT_EQUAL( PARSER_STATE_HEADERS_COMPLETE, respHandle->parserState );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test IotHttpsClient_ReadHeader() when the response has more headers than fit in the header index.
+ */
+TEST( HTTPS_Client_Unit_API, ReadHeaderIndexOverflow )
+{
+    IotHttpsReturnCode_t returnCode = IOT_HTTPS_OK;
+    IotHttpsResponseHandle_t respHandle = IOT_HTTPS_RESPONSE_HANDLE_INITIALIZER;
+    IotHttpsRequestHandle_t reqHandle = IOT_HTTPS_REQUEST_HANDLE_INITIALIZER;
+    char valueBuffer[ HTTPS_TEST_VALUE_BUFFER_LENGTH_LARGE_ENOUGH ] = { 0 };
+
+    reqHandle = _getReqHandle( &_reqInfo );
+    TEST_ASSERT_NOT_NULL( reqHandle );
+    respHandle = _getRespHandle( &_respInfo, reqHandle );
+    TEST_ASSERT_NOT_NULL( respHandle );
+
+    _receiveTestHeaders( respHandle, HTTPS_TEST_RESPONSE_HEADER_LINES_MANY, HTTPS_TEST_RESPONSE_HEADER_LINES_MANY_LENGTH, NULL, 0 );
+
+    /* The first and the last headers are found whether or not they fit in the header index. */
+    returnCode = IotHttpsClient_ReadHeader( respHandle, "h1", 2, valueBuffer, sizeof( valueBuffer ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_EQUAL_STRING( "1", valueBuffer );
+
+    returnCode = IotHttpsClient_ReadHeader( respHandle, "h10", 3, valueBuffer, sizeof( valueBuffer ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+    TEST_ASSERT_EQUAL_STRING( "10", valueBuffer );
+
+    returnCode = IotHttpsClient_ReadHeader( respHandle, "h11", 3, valueBuffer, sizeof( valueBuffer ) );
+    TEST_ASSERT_EQUAL( IOT_HTTPS_NOT_FOUND, returnCode );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Measure the time to read every header of a response many times, from the header index and by parsing the
+ * header buffer.
+ */
+TEST( HTTPS_Client_Unit_API, ReadHeaderBenchmark )
+{
+    IotHttpsReturnCode_t returnCode = IOT_HTTPS_OK;
+    IotHttpsResponseHandle_t respHandle = IOT_HTTPS_RESPONSE_HANDLE_INITIALIZER;
+    IotHttpsRequestHandle_t reqHandle = IOT_HTTPS_REQUEST_HANDLE_INITIALIZER;
+    char valueBuffer[ HTTPS_TEST_VALUE_BUFFER_LENGTH_LARGE_ENOUGH ] = { 0 };
+    const char * pNames[] = { HTTPS_CONTENT_LENGTH_HEADER, HTTPS_ETAG_HEADER, "Vary", HTTPS_XSERVER_HEADER };
+    uint32_t iteration = 0, name = 0, pass = 0;
+    uint64_t startTime = 0, elapsedTime[ 2 ] = { 0 };
+
+    reqHandle = _getReqHandle( &_reqInfo );
+    TEST_ASSERT_NOT_NULL( reqHandle );
+    respHandle = _getRespHandle( &_respInfo, reqHandle );
+    TEST_ASSERT_NOT_NULL( respHandle );
+
+    _receiveTestHeaders( respHandle, HTTPS_TEST_RESPONSE_HEADER_LINES_COMPLETE, HTTPS_TEST_RESPONSE_HEADER_LINES_COMPLETE_LENGTH, NULL, 0 );
+
+    /* The first pass reads the headers as received; the second pass parses the header buffer for every read. */
+    for( pass = 0; pass < 2; pass++ )
+    {
+        #if IOT_HTTPS_RESPONSE_HEADER_INDEX_SIZE > 0
+            if( pass == 1 )
+            {
+                respHandle->headerIndexComplete = false;
+            }
+        #endif
+
+        startTime = IotClock_GetTimeMs();
+
+        for( iteration = 0; iteration < HTTPS_TEST_HEADER_READ_ITERATIONS; iteration++ )
+        {
+            for( name = 0; name < ( sizeof( pNames ) / sizeof( pNames[ 0 ] ) ); name++ )
+            {
+                returnCode = IotHttpsClient_ReadHeader( respHandle, ( char * ) pNames[ name ], strlen( pNames[ name ] ), valueBuffer, sizeof( valueBuffer ) );
+                TEST_ASSERT_EQUAL( IOT_HTTPS_OK, returnCode );
+            }
+        }
+
+        elapsedTime[ pass ] = IotClock_GetTimeMs() - startTime;
+    }
+
+    UnityPrintNumber( ( UNITY_INT ) ( HTTPS_TEST_HEADER_READ_ITERATIONS * ( sizeof( pNames ) / sizeof( pNames[ 0 ] ) ) ) );
+    UnityPrint( " header reads: " );
+    UnityPrintNumber( ( UNITY_INT ) elapsedTime[ 0 ] );
+    UnityPrint( " ms with the header index, " );
+    UnityPrintNumber( ( UNITY_INT ) elapsedTime[ 1 ] );
+    UnityPrint( " ms parsing the header buffer." );
+    UNITY_PRINT_EOL();
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Test IotHttpsClient_ReadContentLength() with invalid parameters.
  */
@@ -136,6 +136,11 @@
  */
 #define HTTPS_TEST_RESP_HEADER_BUFFER_LENGTH    ( HTTPS_TEST_RESP_USER_BUFFER_SIZE - sizeof( _httpsResponse_t ) )
 
+/**
+ * @brief The size of the connection user buffer after the connection context, for keeping pipelined response bytes.
+ */
+#define HTTPS_TEST_PIPELINE_BUFFER_SIZE         ( 128 )
+
 /**
  * @brief Test HTTP request body to share among the tests.
  */
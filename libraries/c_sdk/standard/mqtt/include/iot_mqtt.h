@@ -639,6 +639,11 @@ IotMqttError_t IotMqtt_TimedUnsubscribe( IotMqttConnection_t mqttConnection,
  * @note The parameters `pCallbackInfo` and `pPublishOperation` should only be used for QoS
  * 1 publishes. For QoS 0, they should both be `NULL`.
  *
+ * @note The payload is copied into the PUBLISH packet unless #IOT_MQTT_FLAG_ZERO_COPY
+ * is set, in which case it must remain valid until the publish completes. A QoS 0
+ * publish with #IOT_MQTT_FLAG_ZERO_COPY is sent before this function returns; it
+ * returns #IOT_MQTT_NETWORK_ERROR if the send fails.
+ *
  * @see @ref mqtt_function_timedpublish for a blocking variant of this function.
  *
  * <b>Example</b>
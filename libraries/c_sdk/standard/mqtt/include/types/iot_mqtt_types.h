@@ -157,6 +157,9 @@ typedef enum IotMqttError
     /**
      * @brief MQTT operation failed because of memory allocation failure.
      *
+     * This value is also returned when a connection already has
+     * `IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS` operations in progress.
+     *
      * Functions that may return this value:
      * - @ref mqtt_function_connect
      * - @ref mqtt_function_subscribe and @ref mqtt_function_timedsubscribe
@@ -1034,6 +1037,8 @@ typedef struct IotMqttNetworkInfo
  *   @copybrief IOT_MQTT_FLAG_WAITABLE
  * - #IOT_MQTT_FLAG_CLEANUP_ONLY <br>
  *   @copybrief IOT_MQTT_FLAG_CLEANUP_ONLY
+ * - #IOT_MQTT_FLAG_ZERO_COPY <br>
+ *   @copybrief IOT_MQTT_FLAG_ZERO_COPY
  *
  * Flags should be bitwise-ORed with each other to change the behavior of
  * @ref mqtt_function_subscribe, @ref mqtt_function_unsubscribe,
@@ -1088,4 +1093,26 @@ typedef struct IotMqttNetworkInfo
  */
 #define IOT_MQTT_FLAG_CLEANUP_ONLY    ( 0x00000001 )
 
+/**
+ * @brief Causes @ref mqtt_function_publish to send the payload directly from
+ * [pPublishInfo->pPayload](@ref IotMqttPublishInfo_t.pPayload) instead of
+ * copying it into the PUBLISH packet.
+ *
+ * This flag is only valid for @ref mqtt_function_publish. A QoS 1 or QoS 2
+ * PUBLISH must also be combined with #IOT_MQTT_FLAG_WAITABLE or an
+ * #IotMqttCallbackInfo_t; otherwise, @ref mqtt_function_publish returns
+ * #IOT_MQTT_BAD_PARAMETER. Its payload buffer <b>MUST</b> remain valid and
+ * unmodified until the PUBLISH operation completes.
+ *
+ * A QoS 0 PUBLISH is sent before @ref mqtt_function_publish returns, so its
+ * payload buffer may be reused as soon as the function returns. Its headers are
+ * written to a stack buffer of `IOT_MQTT_PUBLISH_HEADER_BUFFER_SIZE` bytes and
+ * only allocated if the topic name is too long to fit.
+ *
+ * This flag is ignored (and the payload copied) if the network interface does
+ * not provide @ref platform_network_function_sendv or a PUBLISH serializer
+ * override is in use.
+ */
+#define IOT_MQTT_FLAG_ZERO_COPY       ( 0x00000002 )
+
 #endif /* ifndef IOT_MQTT_TYPES_H_ */
@@ -143,6 +143,21 @@ static IotMqttError_t _subscriptionCommon( IotMqttOperationType_t operation,
                                            const IotMqttCallbackInfo_t * pCallbackInfo,
                                            IotMqttOperation_t * pOperationReference );
 
+/**
+ * @brief Send a zero-copy QoS 0 PUBLISH before returning.
+ *
+ * A QoS 0 PUBLISH has no completion notification, so its payload can only be
+ * referenced while this function runs. The headers are serialized into a stack
+ * buffer (or allocated if they don't fit) and sent together with the payload.
+ *
+ * @param[in] pMqttConnection The connection to send on.
+ * @param[in] pPublishInfo The QoS 0 PUBLISH to send.
+ *
+ * @return #IOT_MQTT_SUCCESS, #IOT_MQTT_NO_MEMORY, or #IOT_MQTT_NETWORK_ERROR.
+ */
+static IotMqttError_t _sendPublishInPlace( _mqttConnection_t * pMqttConnection,
+                                           const IotMqttPublishInfo_t * pPublishInfo );
+
 /*-----------------------------------------------------------*/
 
 static bool _mqttSubscription_setUnsubscribe( const IotLink_t * pSubscriptionLink,
@@ -162,6 +177,10 @@ static bool _mqttSubscription_setUnsubscribe( const IotLink_t * pSubscriptionLin
     /* Set the unsubscribed flag. */
     pSubscription->unsubscribed = true;
 
+    /* The subscription index is destroyed with its connection, so detach this
+     * subscription from it. */
+    pSubscription->pIndexNode = NULL;
+
     return true;
 }
 
@@ -224,6 +243,10 @@ static void _mqttOperation_tryDestroy( void * pData )
     }
     else
     {
+        /* The operation was removed from its list; also remove it from the
+         * pending response index. */
+        _IotMqtt_UnlinkOperation( pOperation );
+
         /* Decrement reference count and destroy operation if possible. */
         if( _IotMqtt_DecrementOperationReferences( pOperation, true ) == true )
         {
@@ -505,6 +528,7 @@ static void _destroyMqttConnection( _mqttConnection_t * pMqttConnection )
                                     NULL,
                                     _mqttSubscription_tryDestroy,
                                     offsetof( _mqttSubscription_t, link ) );
+    _IotMqtt_DestroySubscriptionIndex( pMqttConnection );
     IotMutex_Unlock( &( pMqttConnection->subscriptionMutex ) );
 
     /* Destroy an owned network connection. */
@@ -756,6 +780,94 @@ static IotMqttError_t _subscriptionCommon( IotMqttOperationType_t operation,
 
 /*-----------------------------------------------------------*/
 
+static IotMqttError_t _sendPublishInPlace( _mqttConnection_t * pMqttConnection,
+                                           const IotMqttPublishInfo_t * pPublishInfo )
+{
+    IOT_FUNCTION_ENTRY( IotMqttError_t, IOT_MQTT_SUCCESS );
+    bool connectionReferenced = false;
+    uint8_t pHeaderBuffer[ IOT_MQTT_PUBLISH_HEADER_BUFFER_SIZE ] = { 0 };
+    uint8_t * pHeader = NULL;
+    size_t headerSize = 0, bytesSent = 0;
+    uint16_t packetIdentifier = 0;
+    IotNetworkIoVector_t sendVectors[ 2 ];
+
+    /* A QoS 0 PUBLISH is never scheduled, so the connection must be referenced
+     * here to keep it open while sending. */
+    connectionReferenced = _IotMqtt_IncrementConnectionReferences( pMqttConnection );
+
+    if( connectionReferenced == false )
+    {
+        IOT_SET_AND_GOTO_CLEANUP( IOT_MQTT_NETWORK_ERROR );
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    status = _IotMqtt_SerializePublishHeader( pPublishInfo,
+                                              pHeaderBuffer,
+                                              sizeof( pHeaderBuffer ),
+                                              &pHeader,
+                                              &headerSize,
+                                              &packetIdentifier,
+                                              NULL );
+
+    if( status != IOT_MQTT_SUCCESS )
+    {
+        IOT_GOTO_CLEANUP();
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    sendVectors[ 0 ].pBuffer = pHeader;
+    sendVectors[ 0 ].length = headerSize;
+    sendVectors[ 1 ].pBuffer = pPublishInfo->pPayload;
+    sendVectors[ 1 ].length = pPublishInfo->payloadLength;
+
+    bytesSent = pMqttConnection->pNetworkInterface->sendv( pMqttConnection->pNetworkConnection,
+                                                           sendVectors,
+                                                           2 );
+
+    if( bytesSent != headerSize + pPublishInfo->payloadLength )
+    {
+        IotLogError( "(MQTT connection %p) Failed to send zero-copy PUBLISH.",
+                     pMqttConnection );
+
+        status = IOT_MQTT_NETWORK_ERROR;
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    IOT_FUNCTION_CLEANUP_BEGIN();
+
+    /* Free the headers if they did not fit in the stack buffer. */
+    if( ( pHeader != NULL ) && ( pHeader != pHeaderBuffer ) )
+    {
+        _IotMqtt_FreePacket( pHeader );
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    if( connectionReferenced == true )
+    {
+        _IotMqtt_DecrementConnectionReferences( pMqttConnection );
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    IOT_FUNCTION_CLEANUP_END();
+}
+
+/*-----------------------------------------------------------*/
+
 bool _IotMqtt_IncrementConnectionReferences( _mqttConnection_t * pMqttConnection )
 {
     bool disconnected = false;
@@ -1154,9 +1266,13 @@ IotMqttError_t IotMqtt_Connect( const IotMqttNetworkInfo_t * pNetworkInfo,
         {
             IotLogDebug( "Scheduling first MQTT keep-alive job." );
 
-            taskPoolStatus = IotTaskPool_ScheduleDeferred( IOT_SYSTEM_TASKPOOL,
-                                                           pNewMqttConnection->keepAliveJob,
-                                                           pNewMqttConnection->nextKeepAliveMs );
+            /* Keep-alive jobs are scheduled ahead of other MQTT jobs, so that a
+             * PINGREQ is not delayed by a backlog of sends. */
+            taskPoolStatus = IotTaskPool_ScheduleDeferredWithPriority( IOT_SYSTEM_TASKPOOL,
+                                                                       pNewMqttConnection->keepAliveJob,
+                                                                       pNewMqttConnection->nextKeepAliveMs,
+                                                                       IOT_TASKPOOL_PRIORITY_HIGH,
+                                                                       0 );
 
             if( taskPoolStatus != IOT_TASKPOOL_SUCCESS )
             {
@@ -1505,6 +1621,7 @@ IotMqttError_t IotMqtt_Publish( IotMqttConnection_t mqttConnection,
     IOT_FUNCTION_ENTRY( IotMqttError_t, IOT_MQTT_SUCCESS );
     _mqttOperation_t * pOperation = NULL;
     uint8_t ** pPacketIdentifierHigh = NULL;
+    bool zeroCopy = false;
 
     /* Default PUBLISH serializer function. */
     IotMqttError_t ( * serializePublish )( const IotMqttPublishInfo_t *,
@@ -1577,25 +1694,31 @@ IotMqttError_t IotMqtt_Publish( IotMqttConnection_t mqttConnection,
         EMPTY_ELSE_MARKER;
     }
 
-    /* Create a PUBLISH operation. */
-    status = _IotMqtt_CreateOperation( mqttConnection,
-                                       flags,
-                                       pCallbackInfo,
-                                       &pOperation );
-
-    if( status != IOT_MQTT_SUCCESS )
+    /* Check that a zero-copy PUBLISH will notify the application when its
+     * payload is no longer in use. A QoS 0 PUBLISH has no notification; it is
+     * sent before this function returns instead. */
+    if( ( flags & IOT_MQTT_FLAG_ZERO_COPY ) == IOT_MQTT_FLAG_ZERO_COPY )
     {
-        IOT_GOTO_CLEANUP();
+        if( ( pPublishInfo->qos != IOT_MQTT_QOS_0 ) &&
+            ( pCallbackInfo == NULL ) &&
+            ( ( flags & IOT_MQTT_FLAG_WAITABLE ) == 0 ) )
+        {
+            IotLogError( "Zero-copy QoS 1 or 2 PUBLISH must be waitable or have a callback." );
+
+            IOT_SET_AND_GOTO_CLEANUP( IOT_MQTT_BAD_PARAMETER );
+        }
+        else
+        {
+            /* The payload can only be sent in place if the network can send it
+             * together with the PUBLISH headers. */
+            zeroCopy = ( mqttConnection->pNetworkInterface->sendv != NULL );
+        }
     }
     else
     {
         EMPTY_ELSE_MARKER;
     }
 
-    /* Check the PUBLISH operation data and set the operation type. */
-    IotMqtt_Assert( pOperation->u.operation.status == IOT_MQTT_STATUS_PENDING );
-    pOperation->u.operation.type = IOT_MQTT_PUBLISH_TO_SERVER;
-
     /* Choose a PUBLISH serializer function. */
     #if IOT_MQTT_ENABLE_SERIALIZER_OVERRIDES == 1
         if( mqttConnection->pSerializer != NULL )
@@ -1603,6 +1726,9 @@ IotMqttError_t IotMqtt_Publish( IotMqttConnection_t mqttConnection,
             if( mqttConnection->pSerializer->serialize.publish != NULL )
             {
                 serializePublish = mqttConnection->pSerializer->serialize.publish;
+
+                /* A custom serializer always copies the payload. */
+                zeroCopy = false;
             }
             else
             {
@@ -1615,6 +1741,37 @@ IotMqttError_t IotMqtt_Publish( IotMqttConnection_t mqttConnection,
         }
     #endif /* if IOT_MQTT_ENABLE_SERIALIZER_OVERRIDES == 1 */
 
+    /* A zero-copy QoS 0 PUBLISH does not need an operation. */
+    if( ( zeroCopy == true ) && ( pPublishInfo->qos == IOT_MQTT_QOS_0 ) )
+    {
+        status = _sendPublishInPlace( mqttConnection, pPublishInfo );
+
+        IOT_GOTO_CLEANUP();
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    /* Create a PUBLISH operation. */
+    status = _IotMqtt_CreateOperation( mqttConnection,
+                                       flags,
+                                       pCallbackInfo,
+                                       &pOperation );
+
+    if( status != IOT_MQTT_SUCCESS )
+    {
+        IOT_GOTO_CLEANUP();
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    /* Check the PUBLISH operation data and set the operation type. */
+    IotMqtt_Assert( pOperation->u.operation.status == IOT_MQTT_STATUS_PENDING );
+    pOperation->u.operation.type = IOT_MQTT_PUBLISH_TO_SERVER;
+
     /* In AWS IoT MQTT mode, a pointer to the packet identifier must be saved. */
     if( mqttConnection->awsIotMqttMode == true )
     {
@@ -1625,12 +1782,31 @@ IotMqttError_t IotMqtt_Publish( IotMqttConnection_t mqttConnection,
         EMPTY_ELSE_MARKER;
     }
 
-    /* Generate a PUBLISH packet from pPublishInfo. */
-    status = serializePublish( pPublishInfo,
-                               &( pOperation->u.operation.pMqttPacket ),
-                               &( pOperation->u.operation.packetSize ),
-                               &( pOperation->u.operation.packetIdentifier ),
-                               pPacketIdentifierHigh );
+    /* For a zero-copy PUBLISH, serialize only the headers and keep a reference
+     * to the payload to send after them. The operation may outlive this call,
+     * so its headers are always allocated. */
+    if( zeroCopy == true )
+    {
+        pOperation->u.operation.pPayload = pPublishInfo->pPayload;
+        pOperation->u.operation.payloadLength = pPublishInfo->payloadLength;
+
+        status = _IotMqtt_SerializePublishHeader( pPublishInfo,
+                                                  NULL,
+                                                  0,
+                                                  &( pOperation->u.operation.pMqttPacket ),
+                                                  &( pOperation->u.operation.packetSize ),
+                                                  &( pOperation->u.operation.packetIdentifier ),
+                                                  pPacketIdentifierHigh );
+    }
+    else
+    {
+        /* Generate a PUBLISH packet from pPublishInfo. */
+        status = serializePublish( pPublishInfo,
+                                   &( pOperation->u.operation.pMqttPacket ),
+                                   &( pOperation->u.operation.packetSize ),
+                                   &( pOperation->u.operation.packetIdentifier ),
+                                   pPacketIdentifierHigh );
+    }
 
     if( status != IOT_MQTT_SUCCESS )
     {
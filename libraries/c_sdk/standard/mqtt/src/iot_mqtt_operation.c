@@ -91,6 +91,50 @@ static bool _checkRetryLimit( _mqttOperation_t * pOperation );
  */
 static bool _scheduleNextRetry( _mqttOperation_t * pOperation );
 
+/**
+ * @brief Get the first slot to probe for a packet identifier in the pending
+ * response index.
+ *
+ * @param[in] packetIdentifier The packet identifier of an operation.
+ *
+ * @return A slot of the pending response index.
+ */
+static uint32_t _pendingResponseHash( uint16_t packetIdentifier );
+
+/**
+ * @brief Find an operation in the pending response index.
+ *
+ * @param[in] pMqttConnection The connection that owns the index.
+ * @param[in] type The operation type to look for.
+ * @param[in] packetIdentifier The packet identifier to look for.
+ * @param[in] pOperation A specific operation to look for; `NULL` to match any
+ * operation with the given type and packet identifier.
+ *
+ * @return The slot of the operation; #MQTT_PENDING_RESPONSE_INDEX_SIZE if
+ * it is not in the index.
+ */
+static uint32_t _pendingResponseIndexFind( const _mqttConnection_t * pMqttConnection,
+                                           IotMqttOperationType_t type,
+                                           uint16_t packetIdentifier,
+                                           const _mqttOperation_t * pOperation );
+
+/**
+ * @brief Add an operation to the pending response index of its connection.
+ *
+ * Operations without a packet identifier are not added; they are found by
+ * searching the pending response list.
+ *
+ * @param[in] pOperation The operation to add.
+ */
+static void _pendingResponseIndexInsert( _mqttOperation_t * pOperation );
+
+/**
+ * @brief Remove an operation from the pending response index of its connection.
+ *
+ * @param[in] pOperation The operation to remove. Must be in the index.
+ */
+static void _pendingResponseIndexRemove( _mqttOperation_t * pOperation );
+
 /*-----------------------------------------------------------*/
 
 static bool _mqttOperation_match( const IotLink_t * pOperationLink,
@@ -133,7 +177,9 @@ static bool _mqttOperation_match( const IotLink_t * pOperationLink,
 static bool _checkRetryLimit( _mqttOperation_t * pOperation )
 {
     _mqttConnection_t * pMqttConnection = pOperation->pMqttConnection;
-    bool status = true;
+    bool status = true, setDup = false;
+
+    bool reindex = false;
 
     /* Choose a set DUP function. */
     void ( * publishSetDup )( uint8_t *,
@@ -179,24 +225,50 @@ static bool _checkRetryLimit( _mqttOperation_t * pOperation )
     else if( pOperation->u.operation.retry.count == 1 )
     {
         /* Always set the DUP flag on the first retry. */
-        publishSetDup( pOperation->u.operation.pMqttPacket,
-                       pOperation->u.operation.pPacketIdentifierHigh,
-                       &( pOperation->u.operation.packetIdentifier ) );
+        setDup = true;
     }
     else
     {
         /* In AWS IoT MQTT mode, the DUP flag (really a change to the packet
          * identifier) must be reset on every retry. */
-        if( pMqttConnection->awsIotMqttMode == true )
+        setDup = pMqttConnection->awsIotMqttMode;
+    }
+
+    if( setDup == true )
+    {
+        /* Setting the DUP flag may change the packet identifier, so an operation
+         * in the pending response index must be indexed again. */
+        IotMutex_Lock( &( pMqttConnection->referencesMutex ) );
+
+        reindex = pOperation->u.operation.indexed;
+
+        if( reindex == true )
+        {
+            _pendingResponseIndexRemove( pOperation );
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+
+        publishSetDup( pOperation->u.operation.pMqttPacket,
+                       pOperation->u.operation.pPacketIdentifierHigh,
+                       &( pOperation->u.operation.packetIdentifier ) );
+
+        if( reindex == true )
         {
-            publishSetDup( pOperation->u.operation.pMqttPacket,
-                           pOperation->u.operation.pPacketIdentifierHigh,
-                           &( pOperation->u.operation.packetIdentifier ) );
+            _pendingResponseIndexInsert( pOperation );
         }
         else
         {
             EMPTY_ELSE_MARKER;
         }
+
+        IotMutex_Unlock( &( pMqttConnection->referencesMutex ) );
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
     }
 
     return status;
@@ -285,9 +357,7 @@ static bool _scheduleNextRetry( _mqttOperation_t * pOperation )
             IotMqtt_Assert( IotLink_IsLinked( &( pOperation->link ) ) == true );
 
             /* Transfer to pending response list. */
-            IotListDouble_Remove( &( pOperation->link ) );
-            IotListDouble_InsertHead( &( pMqttConnection->pendingResponse ),
-                                      &( pOperation->link ) );
+            _IotMqtt_AddPendingResponse( pOperation );
         }
         else
         {
@@ -315,13 +385,151 @@ static bool _scheduleNextRetry( _mqttOperation_t * pOperation )
 
 /*-----------------------------------------------------------*/
 
+static uint32_t _pendingResponseHash( uint16_t packetIdentifier )
+{
+    /* Packet identifiers are assigned in sequence, so their low bits spread the
+     * operations in flight evenly over the index. */
+    return ( uint32_t ) packetIdentifier & ( uint32_t ) ( MQTT_PENDING_RESPONSE_INDEX_SIZE - 1 );
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t _pendingResponseIndexFind( const _mqttConnection_t * pMqttConnection,
+                                           IotMqttOperationType_t type,
+                                           uint16_t packetIdentifier,
+                                           const _mqttOperation_t * pOperation )
+{
+    uint32_t probes = 0, slot = _pendingResponseHash( packetIdentifier );
+    uint32_t result = MQTT_PENDING_RESPONSE_INDEX_SIZE;
+    const _mqttOperation_t * pEntry = pMqttConnection->pPendingResponseIndex[ slot ];
+
+    /* Probe from the first slot for the packet identifier until an empty slot. */
+    while( ( pEntry != NULL ) &&
+           ( result == MQTT_PENDING_RESPONSE_INDEX_SIZE ) &&
+           ( probes < MQTT_PENDING_RESPONSE_INDEX_SIZE ) )
+    {
+        if( pOperation != NULL )
+        {
+            if( pEntry == pOperation )
+            {
+                result = slot;
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
+            }
+        }
+        else if( ( pEntry->u.operation.type == type ) &&
+                 ( pEntry->u.operation.packetIdentifier == packetIdentifier ) )
+        {
+            result = slot;
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+
+        probes++;
+        slot = ( slot + 1U ) & ( uint32_t ) ( MQTT_PENDING_RESPONSE_INDEX_SIZE - 1 );
+        pEntry = pMqttConnection->pPendingResponseIndex[ slot ];
+    }
+
+    return result;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _pendingResponseIndexInsert( _mqttOperation_t * pOperation )
+{
+    _mqttConnection_t * pMqttConnection = pOperation->pMqttConnection;
+    uint32_t slot = _pendingResponseHash( pOperation->u.operation.packetIdentifier );
+
+    if( pOperation->u.operation.packetIdentifier != 0 )
+    {
+        /* The index is sized so that it is at most 3/4 full, which keeps probe
+         * sequences short, when every operation of the connection is in it. */
+        IotMqtt_Assert( pMqttConnection->pendingResponseIndexCount <
+                        ( MQTT_PENDING_RESPONSE_INDEX_SIZE - ( MQTT_PENDING_RESPONSE_INDEX_SIZE / 4 ) ) );
+
+        while( pMqttConnection->pPendingResponseIndex[ slot ] != NULL )
+        {
+            slot = ( slot + 1U ) & ( uint32_t ) ( MQTT_PENDING_RESPONSE_INDEX_SIZE - 1 );
+        }
+
+        pMqttConnection->pPendingResponseIndex[ slot ] = pOperation;
+        ( pMqttConnection->pendingResponseIndexCount )++;
+        pOperation->u.operation.indexed = true;
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void _pendingResponseIndexRemove( _mqttOperation_t * pOperation )
+{
+    _mqttConnection_t * pMqttConnection = pOperation->pMqttConnection;
+    _mqttOperation_t * pEntry = NULL;
+    uint32_t hole = 0, slot = 0, home = 0;
+    const uint32_t mask = ( uint32_t ) ( MQTT_PENDING_RESPONSE_INDEX_SIZE - 1 );
+
+    hole = _pendingResponseIndexFind( pMqttConnection,
+                                      pOperation->u.operation.type,
+                                      pOperation->u.operation.packetIdentifier,
+                                      pOperation );
+
+    /* An indexed operation must be in the index. */
+    IotMqtt_Assert( hole != MQTT_PENDING_RESPONSE_INDEX_SIZE );
+
+    if( hole != MQTT_PENDING_RESPONSE_INDEX_SIZE )
+    {
+        /* Move back the entries after the hole that would no longer be found
+         * once their probe sequence is broken by an empty slot. */
+        slot = ( hole + 1U ) & mask;
+        pEntry = pMqttConnection->pPendingResponseIndex[ slot ];
+
+        while( pEntry != NULL )
+        {
+            home = _pendingResponseHash( pEntry->u.operation.packetIdentifier );
+
+            /* An entry may fill the hole if the hole is between its first
+             * slot and its current slot. */
+            if( ( ( slot - home ) & mask ) >= ( ( slot - hole ) & mask ) )
+            {
+                pMqttConnection->pPendingResponseIndex[ hole ] = pEntry;
+                hole = slot;
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
+            }
+
+            slot = ( slot + 1U ) & mask;
+            pEntry = pMqttConnection->pPendingResponseIndex[ slot ];
+        }
+
+        pMqttConnection->pPendingResponseIndex[ hole ] = NULL;
+        ( pMqttConnection->pendingResponseIndexCount )--;
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    pOperation->u.operation.indexed = false;
+}
+
+/*-----------------------------------------------------------*/
+
 IotMqttError_t _IotMqtt_CreateOperation( _mqttConnection_t * pMqttConnection,
                                          uint32_t flags,
                                          const IotMqttCallbackInfo_t * pCallbackInfo,
                                          _mqttOperation_t ** pNewOperation )
 {
     IOT_FUNCTION_ENTRY( IotMqttError_t, IOT_MQTT_SUCCESS );
-    bool decrementOnError = false;
+    bool decrementOnError = false, operationCounted = false;
     _mqttOperation_t * pOperation = NULL;
     bool waitable = ( ( flags & IOT_MQTT_FLAG_WAITABLE ) == IOT_MQTT_FLAG_WAITABLE );
 
@@ -363,6 +571,36 @@ IotMqttError_t _IotMqtt_CreateOperation( _mqttConnection_t * pMqttConnection,
         decrementOnError = true;
     }
 
+    /* Limit the operations in progress, so that all of them fit in the pending
+     * response index. */
+    IotMutex_Lock( &( pMqttConnection->referencesMutex ) );
+
+    if( pMqttConnection->operationCount < IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS )
+    {
+        ( pMqttConnection->operationCount )++;
+        operationCounted = true;
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    IotMutex_Unlock( &( pMqttConnection->referencesMutex ) );
+
+    if( operationCounted == false )
+    {
+        IotLogError( "(MQTT connection %p) New operation record cannot be created;"
+                     " %lu operations are already in progress.",
+                     pMqttConnection,
+                     ( unsigned long ) IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS );
+
+        IOT_SET_AND_GOTO_CLEANUP( IOT_MQTT_NO_MEMORY );
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
     /* Allocate memory for a new operation. */
     pOperation = IotMqtt_MallocOperation( sizeof( _mqttOperation_t ) );
 
@@ -434,6 +672,17 @@ IotMqttError_t _IotMqtt_CreateOperation( _mqttConnection_t * pMqttConnection,
 
     if( status != IOT_MQTT_SUCCESS )
     {
+        if( operationCounted == true )
+        {
+            IotMutex_Lock( &( pMqttConnection->referencesMutex ) );
+            ( pMqttConnection->operationCount )--;
+            IotMutex_Unlock( &( pMqttConnection->referencesMutex ) );
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+
         if( decrementOnError == true )
         {
             _IotMqtt_DecrementConnectionReferences( pMqttConnection );
@@ -565,8 +814,6 @@ void _IotMqtt_DestroyOperation( _mqttOperation_t * pOperation )
                      IotMqtt_OperationType( pOperation->u.operation.type ),
                      pOperation,
                      pMqttConnection );
-
-        IotListDouble_Remove( &( pOperation->link ) );
     }
     else
     {
@@ -576,6 +823,12 @@ void _IotMqtt_DestroyOperation( _mqttOperation_t * pOperation )
                      pOperation );
     }
 
+    _IotMqtt_UnlinkOperation( pOperation );
+
+    /* This operation no longer counts against the operations in progress. */
+    IotMqtt_Assert( pMqttConnection->operationCount > 0U );
+    ( pMqttConnection->operationCount )--;
+
     IotMutex_Unlock( &( pMqttConnection->referencesMutex ) );
 
     /* Free any allocated MQTT packet. */
@@ -735,9 +988,11 @@ void _IotMqtt_ProcessKeepAlive( IotTaskPool_t pTaskPool,
      * response shortly. */
     if( status == true )
     {
-        taskPoolStatus = IotTaskPool_ScheduleDeferred( pTaskPool,
-                                                       pKeepAliveJob,
-                                                       pMqttConnection->nextKeepAliveMs );
+        taskPoolStatus = IotTaskPool_ScheduleDeferredWithPriority( pTaskPool,
+                                                                   pKeepAliveJob,
+                                                                   pMqttConnection->nextKeepAliveMs,
+                                                                   IOT_TASKPOOL_PRIORITY_HIGH,
+                                                                   0 );
 
         if( taskPoolStatus == IOT_TASKPOOL_SUCCESS )
         {
@@ -830,8 +1085,9 @@ void _IotMqtt_ProcessSend( IotTaskPool_t pTaskPool,
                            IotTaskPoolJob_t pSendJob,
                            void * pContext )
 {
-    size_t bytesSent = 0;
+    size_t bytesSent = 0, bytesExpected = 0;
     bool destroyOperation = false, waitable = false, networkPending = false;
+    IotNetworkIoVector_t sendVectors[ 2 ];
     _mqttOperation_t * pOperation = ( _mqttOperation_t * ) pContext;
     _mqttConnection_t * pMqttConnection = pOperation->pMqttConnection;
 
@@ -875,13 +1131,33 @@ void _IotMqtt_ProcessSend( IotTaskPool_t pTaskPool,
                      IotMqtt_OperationType( pOperation->u.operation.type ),
                      pOperation );
 
-        /* Transmit the MQTT packet from the operation over the network. */
-        bytesSent = pMqttConnection->pNetworkInterface->send( pMqttConnection->pNetworkConnection,
-                                                              pOperation->u.operation.pMqttPacket,
-                                                              pOperation->u.operation.packetSize );
+        /* Transmit the MQTT packet from the operation over the network. A
+         * zero-copy PUBLISH sends its payload directly after the headers. */
+        if( pOperation->u.operation.pPayload != NULL )
+        {
+            IotMqtt_Assert( pMqttConnection->pNetworkInterface->sendv != NULL );
+
+            sendVectors[ 0 ].pBuffer = pOperation->u.operation.pMqttPacket;
+            sendVectors[ 0 ].length = pOperation->u.operation.packetSize;
+            sendVectors[ 1 ].pBuffer = pOperation->u.operation.pPayload;
+            sendVectors[ 1 ].length = pOperation->u.operation.payloadLength;
+            bytesExpected = pOperation->u.operation.packetSize + pOperation->u.operation.payloadLength;
+
+            bytesSent = pMqttConnection->pNetworkInterface->sendv( pMqttConnection->pNetworkConnection,
+                                                                   sendVectors,
+                                                                   2 );
+        }
+        else
+        {
+            bytesExpected = pOperation->u.operation.packetSize;
+
+            bytesSent = pMqttConnection->pNetworkInterface->send( pMqttConnection->pNetworkConnection,
+                                                                  pOperation->u.operation.pMqttPacket,
+                                                                  pOperation->u.operation.packetSize );
+        }
 
         /* Check transmission status. */
-        if( bytesSent != pOperation->u.operation.packetSize )
+        if( bytesSent != bytesExpected )
         {
             pOperation->u.operation.status = IOT_MQTT_NETWORK_ERROR;
         }
@@ -959,9 +1235,7 @@ void _IotMqtt_ProcessSend( IotTaskPool_t pTaskPool,
                 IotMqtt_Assert( IotLink_IsLinked( &( pOperation->link ) ) );
 
                 /* Transfer to pending response list. */
-                IotListDouble_Remove( &( pOperation->link ) );
-                IotListDouble_InsertHead( &( pMqttConnection->pendingResponse ),
-                                          &( pOperation->link ) );
+                _IotMqtt_AddPendingResponse( pOperation );
 
                 IotMutex_Unlock( &( pMqttConnection->referencesMutex ) );
 
@@ -1122,12 +1396,34 @@ _mqttOperation_t * _IotMqtt_FindOperation( _mqttConnection_t * pMqttConnection,
                      IotMqtt_OperationType( type ) );
     }
 
-    /* Find and remove the first matching element in the list. */
+    /* Find and remove the first matching element. Every operation with a packet
+     * identifier is in the pending response index; only operations without one
+     * are searched for in the list. */
     IotMutex_Lock( &( pMqttConnection->referencesMutex ) );
-    pResultLink = IotListDouble_FindFirstMatch( &( pMqttConnection->pendingResponse ),
-                                                NULL,
-                                                _mqttOperation_match,
-                                                &param );
+
+    if( pPacketIdentifier != NULL )
+    {
+        uint32_t slot = _pendingResponseIndexFind( pMqttConnection,
+                                                   type,
+                                                   *pPacketIdentifier,
+                                                   NULL );
+
+        if( slot != MQTT_PENDING_RESPONSE_INDEX_SIZE )
+        {
+            pResultLink = &( pMqttConnection->pPendingResponseIndex[ slot ]->link );
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+    }
+    else
+    {
+        pResultLink = IotListDouble_FindFirstMatch( &( pMqttConnection->pendingResponse ),
+                                                    NULL,
+                                                    _mqttOperation_match,
+                                                    &param );
+    }
 
     /* Check if a match was found. */
     if( pResultLink != NULL )
@@ -1190,7 +1486,7 @@ _mqttOperation_t * _IotMqtt_FindOperation( _mqttConnection_t * pMqttConnection,
                      IotMqtt_OperationType( type ) );
 
         /* Remove the matched operation from the list. */
-        IotListDouble_Remove( &( pResult->link ) );
+        _IotMqtt_UnlinkOperation( pResult );
     }
     else
     {
@@ -1206,6 +1502,54 @@ _mqttOperation_t * _IotMqtt_FindOperation( _mqttConnection_t * pMqttConnection,
 
 /*-----------------------------------------------------------*/
 
+void _IotMqtt_AddPendingResponse( _mqttOperation_t * pOperation )
+{
+    _mqttConnection_t * pMqttConnection = pOperation->pMqttConnection;
+
+    /* Only operations sent to the server await a response. */
+    IotMqtt_Assert( pOperation->incomingPublish == false );
+
+    _IotMqtt_UnlinkOperation( pOperation );
+
+    IotListDouble_InsertHead( &( pMqttConnection->pendingResponse ),
+                              &( pOperation->link ) );
+
+    _pendingResponseIndexInsert( pOperation );
+}
+
+/*-----------------------------------------------------------*/
+
+void _IotMqtt_UnlinkOperation( _mqttOperation_t * pOperation )
+{
+    if( IotLink_IsLinked( &( pOperation->link ) ) == true )
+    {
+        IotListDouble_Remove( &( pOperation->link ) );
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    /* Incoming PUBLISH operations are never indexed. */
+    if( pOperation->incomingPublish == false )
+    {
+        if( pOperation->u.operation.indexed == true )
+        {
+            _pendingResponseIndexRemove( pOperation );
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
 void _IotMqtt_Notify( _mqttOperation_t * pOperation )
 {
     IotMqttError_t status = IOT_MQTT_SCHEDULING_ERROR;
@@ -1262,14 +1606,7 @@ void _IotMqtt_Notify( _mqttOperation_t * pOperation )
 
                 /* Place the scheduled operation back in the list of operations pending
                  * processing. */
-                if( IotLink_IsLinked( &( pOperation->link ) ) == true )
-                {
-                    IotListDouble_Remove( &( pOperation->link ) );
-                }
-                else
-                {
-                    EMPTY_ELSE_MARKER;
-                }
+                _IotMqtt_UnlinkOperation( pOperation );
 
                 IotListDouble_InsertHead( &( pMqttConnection->pendingProcessing ),
                                           &( pOperation->link ) );
@@ -251,6 +251,33 @@ static bool _publishPacketSize( const IotMqttPublishInfo_t * pPublishInfo,
                                 size_t * pRemainingLength,
                                 size_t * pPacketSize );
 
+/**
+ * @brief Generate a PUBLISH packet, optionally leaving out the payload.
+ *
+ * @param[in] pPublishInfo User-provided PUBLISH information.
+ * @param[in] includePayload Whether the payload is copied into the packet. If
+ * `false`, only the fixed and variable headers are written, and the payload
+ * must be sent immediately after them.
+ * @param[in] pFixedBuffer Buffer to write the packet to if it fits; `NULL` to
+ * always allocate one.
+ * @param[in] fixedBufferSize Size of `pFixedBuffer`.
+ * @param[out] pPublishPacket Where the PUBLISH packet is written.
+ * @param[out] pPacketSize Size of the packet written to `pPublishPacket`.
+ * @param[out] pPacketIdentifier The packet identifier generated for this PUBLISH.
+ * @param[out] pPacketIdentifierHigh Where the high byte of the packet identifier
+ * is written.
+ *
+ * @return #IOT_MQTT_SUCCESS, #IOT_MQTT_NO_MEMORY, or #IOT_MQTT_BAD_PARAMETER.
+ */
+static IotMqttError_t _serializePublish( const IotMqttPublishInfo_t * pPublishInfo,
+                                         bool includePayload,
+                                         uint8_t * pFixedBuffer,
+                                         size_t fixedBufferSize,
+                                         uint8_t ** pPublishPacket,
+                                         size_t * pPacketSize,
+                                         uint16_t * pPacketIdentifier,
+                                         uint8_t ** pPacketIdentifierHigh );
+
 /**
  * @brief Calculate the size and "Remaining length" of a SUBSCRIBE or UNSUBSCRIBE
  * packet generated from the given parameters.
@@ -1019,11 +1046,14 @@ IotMqttError_t _IotMqtt_DeserializeConnack( _mqttPacket_t * pConnack )
 
 /*-----------------------------------------------------------*/
 
-IotMqttError_t _IotMqtt_SerializePublish( const IotMqttPublishInfo_t * pPublishInfo,
-                                          uint8_t ** pPublishPacket,
-                                          size_t * pPacketSize,
-                                          uint16_t * pPacketIdentifier,
-                                          uint8_t ** pPacketIdentifierHigh )
+static IotMqttError_t _serializePublish( const IotMqttPublishInfo_t * pPublishInfo,
+                                         bool includePayload,
+                                         uint8_t * pFixedBuffer,
+                                         size_t fixedBufferSize,
+                                         uint8_t ** pPublishPacket,
+                                         size_t * pPacketSize,
+                                         uint16_t * pPacketIdentifier,
+                                         uint8_t ** pPacketIdentifierHigh )
 {
     IOT_FUNCTION_ENTRY( IotMqttError_t, IOT_MQTT_SUCCESS );
     uint8_t publishFlags = 0;
@@ -1050,8 +1080,27 @@ IotMqttError_t _IotMqtt_SerializePublish( const IotMqttPublishInfo_t * pPublishI
      * field. */
     IotMqtt_Assert( publishPacketSize > remainingLength );
 
-    /* Allocate memory to hold the PUBLISH packet. */
-    pBuffer = IotMqtt_MallocMessage( publishPacketSize );
+    /* Without the payload, only the fixed and variable headers are written. The
+     * "Remaining length" still accounts for the payload sent after them. */
+    if( includePayload == false )
+    {
+        publishPacketSize -= pPublishInfo->payloadLength;
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    /* Use the fixed buffer if the packet fits; otherwise, allocate memory to
+     * hold the PUBLISH packet. */
+    if( ( pFixedBuffer != NULL ) && ( publishPacketSize <= fixedBufferSize ) )
+    {
+        pBuffer = pFixedBuffer;
+    }
+    else
+    {
+        pBuffer = IotMqtt_MallocMessage( publishPacketSize );
+    }
 
     /* Check that sufficient memory was allocated. */
     if( pBuffer == NULL )
@@ -1135,7 +1184,7 @@ IotMqttError_t _IotMqtt_SerializePublish( const IotMqttPublishInfo_t * pPublishI
     }
 
     /* The payload is placed after the packet identifier. */
-    if( pPublishInfo->payloadLength > 0 )
+    if( ( includePayload == true ) && ( pPublishInfo->payloadLength > 0 ) )
     {
         ( void ) memcpy( pBuffer, pPublishInfo->pPayload, pPublishInfo->payloadLength );
         pBuffer += pPublishInfo->payloadLength;
@@ -1157,6 +1206,44 @@ IotMqttError_t _IotMqtt_SerializePublish( const IotMqttPublishInfo_t * pPublishI
 
 /*-----------------------------------------------------------*/
 
+IotMqttError_t _IotMqtt_SerializePublish( const IotMqttPublishInfo_t * pPublishInfo,
+                                          uint8_t ** pPublishPacket,
+                                          size_t * pPacketSize,
+                                          uint16_t * pPacketIdentifier,
+                                          uint8_t ** pPacketIdentifierHigh )
+{
+    return _serializePublish( pPublishInfo,
+                              true,
+                              NULL,
+                              0,
+                              pPublishPacket,
+                              pPacketSize,
+                              pPacketIdentifier,
+                              pPacketIdentifierHigh );
+}
+
+/*-----------------------------------------------------------*/
+
+IotMqttError_t _IotMqtt_SerializePublishHeader( const IotMqttPublishInfo_t * pPublishInfo,
+                                                uint8_t * pHeaderBuffer,
+                                                size_t headerBufferSize,
+                                                uint8_t ** pPublishPacket,
+                                                size_t * pPacketSize,
+                                                uint16_t * pPacketIdentifier,
+                                                uint8_t ** pPacketIdentifierHigh )
+{
+    return _serializePublish( pPublishInfo,
+                              false,
+                              pHeaderBuffer,
+                              headerBufferSize,
+                              pPublishPacket,
+                              pPacketSize,
+                              pPacketIdentifier,
+                              pPacketIdentifierHigh );
+}
+
+/*-----------------------------------------------------------*/
+
 void _IotMqtt_PublishSetDup( uint8_t * pPublishPacket,
                              uint8_t * pPacketIdentifierHigh,
                              uint16_t * pNewPacketIdentifier )
@@ -62,6 +62,9 @@
     #ifndef IOT_MQTT_SUBSCRIPTIONS
         #define IOT_MQTT_SUBSCRIPTIONS                 ( 8 )
     #endif
+    #ifndef IOT_MQTT_SUBSCRIPTION_INDEX_NODES
+        #define IOT_MQTT_SUBSCRIPTION_INDEX_NODES      ( 4 * IOT_MQTT_SUBSCRIPTIONS )
+    #endif
 /** @endcond */
 
 /* Validate static memory configuration settings. */
@@ -74,6 +77,9 @@
     #if IOT_MQTT_SUBSCRIPTIONS <= 0
         #error "IOT_MQTT_SUBSCRIPTIONS cannot be 0 or negative."
     #endif
+    #if IOT_MQTT_SUBSCRIPTION_INDEX_NODES <= 0
+        #error "IOT_MQTT_SUBSCRIPTION_INDEX_NODES cannot be 0 or negative."
+    #endif
 
 /**
  * @brief The size of a static memory MQTT subscription.
@@ -89,14 +95,17 @@
 /*
  * Static memory buffers and flags, allocated and zeroed at compile-time.
  */
-    static bool _pInUseMqttConnections[ IOT_MQTT_CONNECTIONS ] = { 0 };                                      /**< @brief MQTT connection in-use flags. */
-    static _mqttConnection_t _pMqttConnections[ IOT_MQTT_CONNECTIONS ] = { { 0 } };                          /**< @brief MQTT connections. */
+    static uint32_t _pInUseMqttConnections[ IOT_STATIC_MEMORY_BITMAP_SIZE( IOT_MQTT_CONNECTIONS ) ] = { 0 };               /**< @brief MQTT connection in-use bitmap. */
+    static _mqttConnection_t _pMqttConnections[ IOT_MQTT_CONNECTIONS ] = { { 0 } };                                        /**< @brief MQTT connections. */
+
+    static uint32_t _pInUseMqttOperations[ IOT_STATIC_MEMORY_BITMAP_SIZE( IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS ) ] = { 0 }; /**< @brief MQTT operation in-use bitmap. */
+    static _mqttOperation_t _pMqttOperations[ IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS ] = { { .link = { 0 } } };               /**< @brief MQTT operations. */
 
-    static bool _pInUseMqttOperations[ IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS ] = { 0 };                        /**< @brief MQTT operation in-use flags. */
-    static _mqttOperation_t _pMqttOperations[ IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS ] = { { .link = { 0 } } }; /**< @brief MQTT operations. */
+    static uint32_t _pInUseMqttSubscriptions[ IOT_STATIC_MEMORY_BITMAP_SIZE( IOT_MQTT_SUBSCRIPTIONS ) ] = { 0 };           /**< @brief MQTT subscription in-use bitmap. */
+    static char _pMqttSubscriptions[ IOT_MQTT_SUBSCRIPTIONS ][ MQTT_SUBSCRIPTION_SIZE ] = { { 0 } };                       /**< @brief MQTT subscriptions. */
 
-    static bool _pInUseMqttSubscriptions[ IOT_MQTT_SUBSCRIPTIONS ] = { 0 };                                  /**< @brief MQTT subscription in-use flags. */
-    static char _pMqttSubscriptions[ IOT_MQTT_SUBSCRIPTIONS ][ MQTT_SUBSCRIPTION_SIZE ] = { { 0 } };         /**< @brief MQTT subscriptions. */
+    static uint32_t _pInUseMqttTopicNodes[ IOT_STATIC_MEMORY_BITMAP_SIZE( IOT_MQTT_SUBSCRIPTION_INDEX_NODES ) ] = { 0 };   /**< @brief MQTT subscription index node in-use bitmap. */
+    static _mqttTopicNode_t _pMqttTopicNodes[ IOT_MQTT_SUBSCRIPTION_INDEX_NODES ] = { { 0 } };                             /**< @brief MQTT subscription index nodes. */
 
 /*-----------------------------------------------------------*/
 
@@ -109,8 +118,8 @@
         if( size == sizeof( _mqttConnection_t ) )
         {
             /* Find a free MQTT connection. */
-            freeIndex = IotStaticMemory_FindFree( _pInUseMqttConnections,
-                                                  IOT_MQTT_CONNECTIONS );
+            freeIndex = IotStaticMemory_FindFreeBit( _pInUseMqttConnections,
+                                                     IOT_MQTT_CONNECTIONS );
 
             if( freeIndex != -1 )
             {
@@ -126,11 +135,11 @@
     void IotMqtt_FreeConnection( void * ptr )
     {
         /* Return the in-use MQTT connection. */
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _pMqttConnections,
-                                     _pInUseMqttConnections,
-                                     IOT_MQTT_CONNECTIONS,
-                                     sizeof( _mqttConnection_t ) );
+        ( void ) IotStaticMemory_ReturnBit( ptr,
+                                            _pMqttConnections,
+                                            _pInUseMqttConnections,
+                                            IOT_MQTT_CONNECTIONS,
+                                            sizeof( _mqttConnection_t ) );
     }
 
 /*-----------------------------------------------------------*/
@@ -144,8 +153,8 @@
         if( size == sizeof( _mqttOperation_t ) )
         {
             /* Find a free MQTT operation. */
-            freeIndex = IotStaticMemory_FindFree( _pInUseMqttOperations,
-                                                  IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS );
+            freeIndex = IotStaticMemory_FindFreeBit( _pInUseMqttOperations,
+                                                     IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS );
 
             if( freeIndex != -1 )
             {
@@ -161,11 +170,11 @@
     void IotMqtt_FreeOperation( void * ptr )
     {
         /* Return the in-use MQTT operation. */
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _pMqttOperations,
-                                     _pInUseMqttOperations,
-                                     IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS,
-                                     sizeof( _mqttOperation_t ) );
+        ( void ) IotStaticMemory_ReturnBit( ptr,
+                                            _pMqttOperations,
+                                            _pInUseMqttOperations,
+                                            IOT_MQTT_MAX_IN_PROGRESS_OPERATIONS,
+                                            sizeof( _mqttOperation_t ) );
     }
 
 /*-----------------------------------------------------------*/
@@ -178,8 +187,8 @@
         if( size <= MQTT_SUBSCRIPTION_SIZE )
         {
             /* Get the index of a free MQTT subscription. */
-            freeIndex = IotStaticMemory_FindFree( _pInUseMqttSubscriptions,
-                                                  IOT_MQTT_SUBSCRIPTIONS );
+            freeIndex = IotStaticMemory_FindFreeBit( _pInUseMqttSubscriptions,
+                                                     IOT_MQTT_SUBSCRIPTIONS );
 
             if( freeIndex != -1 )
             {
@@ -195,11 +204,46 @@
     void IotMqtt_FreeSubscription( void * ptr )
     {
         /* Return the in-use MQTT subscription. */
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _pMqttSubscriptions,
-                                     _pInUseMqttSubscriptions,
-                                     IOT_MQTT_SUBSCRIPTIONS,
-                                     MQTT_SUBSCRIPTION_SIZE );
+        ( void ) IotStaticMemory_ReturnBit( ptr,
+                                            _pMqttSubscriptions,
+                                            _pInUseMqttSubscriptions,
+                                            IOT_MQTT_SUBSCRIPTIONS,
+                                            MQTT_SUBSCRIPTION_SIZE );
+    }
+
+/*-----------------------------------------------------------*/
+
+    void * IotMqtt_MallocTopicNode( size_t size )
+    {
+        int32_t freeIndex = -1;
+        void * pNewTopicNode = NULL;
+
+        /* Check size argument. */
+        if( size == sizeof( _mqttTopicNode_t ) )
+        {
+            /* Find a free subscription index node. */
+            freeIndex = IotStaticMemory_FindFreeBit( _pInUseMqttTopicNodes,
+                                                     IOT_MQTT_SUBSCRIPTION_INDEX_NODES );
+
+            if( freeIndex != -1 )
+            {
+                pNewTopicNode = &( _pMqttTopicNodes[ freeIndex ] );
+            }
+        }
+
+        return pNewTopicNode;
+    }
+
+/*-----------------------------------------------------------*/
+
+    void IotMqtt_FreeTopicNode( void * ptr )
+    {
+        /* Return the in-use subscription index node. */
+        ( void ) IotStaticMemory_ReturnBit( ptr,
+                                            _pMqttTopicNodes,
+                                            _pInUseMqttTopicNodes,
+                                            IOT_MQTT_SUBSCRIPTION_INDEX_NODES,
+                                            sizeof( _mqttTopicNode_t ) );
     }
 
 /*-----------------------------------------------------------*/
@@ -61,10 +61,48 @@ typedef struct _topicMatchParams
  */
 typedef struct _packetMatchParams
 {
-    uint16_t packetIdentifier; /**< Packet identifier to match. */
-    int32_t order;             /**< Order to match. Set to `-1` to ignore. */
+    uint16_t packetIdentifier;           /**< Packet identifier to match. */
+    int32_t order;                       /**< Order to match. Set to `-1` to ignore. */
+    _mqttConnection_t * pMqttConnection; /**< MQTT connection whose subscription index is updated on a match. */
 } _packetMatchParams_t;
 
+/**
+ * @brief A subscription found in the subscription index for an incoming PUBLISH.
+ */
+typedef struct _subscriptionMatch
+{
+    _mqttSubscription_t * pSubscription; /**< @brief The matching subscription. */
+    IotMqttCallbackInfo_t callback;      /**< @brief Copy of the subscription's callback. */
+} _subscriptionMatch_t;
+
+/**
+ * @brief A pending step of the subscription index search.
+ */
+typedef struct _topicIndexStep
+{
+    const _mqttTopicNode_t * pNode; /**< @brief A node that matches the topic name up to `levelStart`. */
+    size_t levelStart;              /**< @brief Offset of the next topic level in the topic name. */
+} _topicIndexStep_t;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The maximum number of pending steps in a subscription index search.
+ *
+ * A search that needs more steps falls back to walking the subscription list.
+ */
+#define TOPIC_INDEX_MAX_STEPS       ( 16 )
+
+/**
+ * @brief Initial value of the subscription index hash (32-bit FNV-1a offset basis).
+ */
+#define TOPIC_INDEX_HASH_INITIAL    ( 2166136261UL )
+
+/**
+ * @brief Multiplier of the subscription index hash (32-bit FNV-1a prime).
+ */
+#define TOPIC_INDEX_HASH_PRIME      ( 16777619UL )
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -92,6 +130,132 @@ static bool _topicMatch( const IotLink_t * pSubscriptionLink,
 static bool _packetMatch( const IotLink_t * pSubscriptionLink,
                           void * pMatch );
 
+/**
+ * @brief Calculate the subscription index hash of a topic level.
+ *
+ * @param[in] pParent The node of the previous topic level.
+ * @param[in] pLevel The topic level (not NULL-terminated).
+ * @param[in] levelLength Length of `pLevel`.
+ *
+ * @return The hash of the topic filter up to and including `pLevel`.
+ */
+static uint32_t _hashTopicLevel( const _mqttTopicNode_t * pParent,
+                                 const char * pLevel,
+                                 size_t levelLength );
+
+/**
+ * @brief Find a child node in the subscription index.
+ *
+ * @param[in] pMqttConnection The MQTT connection that owns the index.
+ * @param[in] pParent The node of the previous topic level.
+ * @param[in] pLevel The topic level to find (not NULL-terminated).
+ * @param[in] levelLength Length of `pLevel`.
+ * @param[in] allowWildcards Whether a level of "+" or "#" refers to the wildcard
+ * child slots. Topic names should pass `false`; topic filters should pass `true`.
+ *
+ * @return The child node; `NULL` if no such node exists.
+ */
+static _mqttTopicNode_t * _findTopicNode( const _mqttConnection_t * pMqttConnection,
+                                          const _mqttTopicNode_t * pParent,
+                                          const char * pLevel,
+                                          size_t levelLength,
+                                          bool allowWildcards );
+
+/**
+ * @brief Remove nodes that no longer have subscriptions or children from the
+ * subscription index, starting at the given node and moving towards the root.
+ *
+ * @param[in] pMqttConnection The MQTT connection that owns the index.
+ * @param[in] pNode The first node to check.
+ */
+static void _pruneTopicNode( _mqttConnection_t * pMqttConnection,
+                             _mqttTopicNode_t * pNode );
+
+/**
+ * @brief Add a subscription to the subscription index, creating any missing
+ * nodes for its topic filter.
+ *
+ * @param[in] pMqttConnection The MQTT connection that owns the index.
+ * @param[in] pSubscription The subscription to add.
+ *
+ * @return `true` if the subscription was added; `false` if memory for a node
+ * could not be allocated.
+ */
+static bool _indexSubscription( _mqttConnection_t * pMqttConnection,
+                                _mqttSubscription_t * pSubscription );
+
+/**
+ * @brief Remove a subscription from the subscription index. If the subscription
+ * could not be indexed, it is no longer counted as unindexed.
+ *
+ * @param[in] pMqttConnection The MQTT connection that owns the index.
+ * @param[in] pSubscription The subscription to remove.
+ */
+static void _unindexSubscription( _mqttConnection_t * pMqttConnection,
+                                  _mqttSubscription_t * pSubscription );
+
+/**
+ * @brief Find a subscription with exactly the given topic filter using the
+ * subscription index.
+ *
+ * @param[in] pMqttConnection The MQTT connection that owns the index.
+ * @param[in] pTopicFilter The topic filter to find.
+ * @param[in] topicFilterLength Length of `pTopicFilter`.
+ *
+ * @return The matching subscription; `NULL` if not found.
+ */
+static _mqttSubscription_t * _findIndexedSubscription( const _mqttConnection_t * pMqttConnection,
+                                                       const char * pTopicFilter,
+                                                       uint16_t topicFilterLength );
+
+/**
+ * @brief Find a subscription with exactly the given topic filter. The
+ * subscription list is searched if the index does not have it and some
+ * subscriptions could not be indexed.
+ *
+ * @param[in] pMqttConnection The MQTT connection that owns the subscriptions.
+ * @param[in] pTopicFilter The topic filter to find.
+ * @param[in] topicFilterLength Length of `pTopicFilter`.
+ *
+ * @return The matching subscription; `NULL` if not found.
+ */
+static _mqttSubscription_t * _findSubscription( _mqttConnection_t * pMqttConnection,
+                                                const char * pTopicFilter,
+                                                uint16_t topicFilterLength );
+
+/**
+ * @brief Find the subscriptions matching a topic name using the subscription
+ * index.
+ *
+ * @param[in] pMqttConnection The MQTT connection that owns the index.
+ * @param[in] pTopicMatchParams The topic name to match.
+ * @param[out] pMatches Where matching subscriptions are written.
+ * @param[out] pMatchCount Set to the number of matching subscriptions.
+ *
+ * @return `true` if all matching subscriptions were written to `pMatches`;
+ * `false` if the search did not fit in #IOT_MQTT_SUBSCRIPTION_DISPATCH_BATCH
+ * matches or #TOPIC_INDEX_MAX_STEPS steps.
+ */
+static bool _findIndexedMatches( const _mqttConnection_t * pMqttConnection,
+                                 _topicMatchParams_t * pTopicMatchParams,
+                                 _subscriptionMatch_t * pMatches,
+                                 size_t * pMatchCount );
+
+/**
+ * @brief Invoke the callbacks of all subscriptions matching a topic name by
+ * walking the subscription list.
+ *
+ * Used when a search of the subscription index does not fit in its fixed-size
+ * buffers.
+ *
+ * @param[in] pMqttConnection The MQTT connection associated with the PUBLISH.
+ * @param[in] pTopicMatchParams The topic name to match.
+ * @param[in] pCallbackParam The parameter to pass to the subscription callbacks.
+ */
+static void _invokeListedSubscriptions( _mqttConnection_t * pMqttConnection,
+                                        _topicMatchParams_t * pTopicMatchParams,
+                                        IotMqttCallbackParam_t * pCallbackParam );
+
 /*-----------------------------------------------------------*/
 
 static bool _topicMatch( const IotLink_t * pSubscriptionLink,
@@ -118,17 +282,23 @@ static bool _topicMatch( const IotLink_t * pSubscriptionLink,
     /* Check for an exact match. */
     if( topicNameLength == topicFilterLength )
     {
-        status = ( strncmp( pTopicName, pTopicFilter, topicNameLength ) == 0 );
-
-        IOT_GOTO_CLEANUP();
+        if( strncmp( pTopicName, pTopicFilter, topicNameLength ) == 0 )
+        {
+            IOT_SET_AND_GOTO_CLEANUP( true );
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
     }
     else
     {
         EMPTY_ELSE_MARKER;
     }
 
-    /* If the topic lengths are different but an exact match is required, return
-     * false. */
+    /* If the topic strings are different but an exact match is required, return
+     * false. Otherwise, a topic filter of the same length may still match through
+     * its wildcards. */
     if( pParam->exactMatchOnly == true )
     {
         IOT_SET_AND_GOTO_CLEANUP( false );
@@ -285,6 +455,10 @@ static bool _packetMatch( const IotLink_t * pSubscriptionLink,
         /* Reference count must not be negative. */
         IotMqtt_Assert( pSubscription->references >= 0 );
 
+        /* A removed subscription must not be found by incoming PUBLISH messages,
+         * so remove it from the subscription index now. */
+        _unindexSubscription( pParam->pMqttConnection, pSubscription );
+
         /* If the reference count is positive, this subscription cannot be
          * removed yet because there are subscription callbacks using it. */
         if( pSubscription->references > 0 )
@@ -310,209 +484,792 @@ static bool _packetMatch( const IotLink_t * pSubscriptionLink,
 
 /*-----------------------------------------------------------*/
 
-IotMqttError_t _IotMqtt_AddSubscriptions( _mqttConnection_t * pMqttConnection,
-                                          uint16_t subscribePacketIdentifier,
-                                          const IotMqttSubscription_t * pSubscriptionList,
-                                          size_t subscriptionCount )
+static uint32_t _hashTopicLevel( const _mqttTopicNode_t * pParent,
+                                 const char * pLevel,
+                                 size_t levelLength )
 {
-    IotMqttError_t status = IOT_MQTT_SUCCESS;
     size_t i = 0;
-    _mqttSubscription_t * pNewSubscription = NULL;
-    IotLink_t * pSubscriptionLink = NULL;
-    _topicMatchParams_t topicMatchParams = { .exactMatchOnly = true };
+    uint32_t hash = pParent->hash;
 
-    IotMutex_Lock( &( pMqttConnection->subscriptionMutex ) );
+    /* Nodes of the first topic level start from the FNV-1a offset basis. The
+     * level separator is hashed so that "a/bc" and "ab/c" differ. */
+    if( pParent->pParent == NULL )
+    {
+        hash = ( uint32_t ) TOPIC_INDEX_HASH_INITIAL;
+    }
+    else
+    {
+        hash = ( hash ^ ( uint32_t ) '/' ) * ( uint32_t ) TOPIC_INDEX_HASH_PRIME;
+    }
 
-    for( i = 0; i < subscriptionCount; i++ )
+    for( i = 0; i < levelLength; i++ )
     {
-        /* Check if this topic filter is already registered. */
-        topicMatchParams.pTopicName = pSubscriptionList[ i ].pTopicFilter;
-        topicMatchParams.topicNameLength = pSubscriptionList[ i ].topicFilterLength;
-        pSubscriptionLink = IotListDouble_FindFirstMatch( &( pMqttConnection->subscriptionList ),
-                                                          NULL,
-                                                          _topicMatch,
-                                                          &topicMatchParams );
+        hash = ( hash ^ ( uint32_t ) ( uint8_t ) pLevel[ i ] ) * ( uint32_t ) TOPIC_INDEX_HASH_PRIME;
+    }
 
-        if( pSubscriptionLink != NULL )
-        {
-            pNewSubscription = IotLink_Container( _mqttSubscription_t, pSubscriptionLink, link );
+    return hash;
+}
 
-            /* The lengths of exactly matching topic filters must match. */
-            IotMqtt_Assert( pNewSubscription->topicFilterLength == pSubscriptionList[ i ].topicFilterLength );
+/*-----------------------------------------------------------*/
 
-            /* Replace the callback and packet info with the new parameters. */
-            pNewSubscription->callback = pSubscriptionList[ i ].callback;
-            pNewSubscription->packetInfo.identifier = subscribePacketIdentifier;
-            pNewSubscription->packetInfo.order = i;
-        }
-        else
-        {
-            /* Allocate memory for a new subscription. */
-            pNewSubscription = IotMqtt_MallocSubscription( sizeof( _mqttSubscription_t ) +
-                                                           pSubscriptionList[ i ].topicFilterLength );
+static _mqttTopicNode_t * _findTopicNode( const _mqttConnection_t * pMqttConnection,
+                                          const _mqttTopicNode_t * pParent,
+                                          const char * pLevel,
+                                          size_t levelLength,
+                                          bool allowWildcards )
+{
+    _mqttTopicNode_t * pNode = NULL;
+    uint32_t hash = 0;
 
-            if( pNewSubscription == NULL )
+    if( ( allowWildcards == true ) && ( levelLength == 1U ) && ( pLevel[ 0 ] == '+' ) )
+    {
+        pNode = pParent->pSingleLevelChild;
+    }
+    else if( ( allowWildcards == true ) && ( levelLength == 1U ) && ( pLevel[ 0 ] == '#' ) )
+    {
+        pNode = pParent->pMultiLevelChild;
+    }
+    else
+    {
+        hash = _hashTopicLevel( pParent, pLevel, levelLength );
+        pNode = pMqttConnection->pTopicIndex[ hash % IOT_MQTT_SUBSCRIPTION_INDEX_BUCKETS ];
+
+        /* Search the bucket for a literal level with the same parent. Levels with
+         * colliding hashes share a node; the topic filters of subscriptions are
+         * always compared before they are used. */
+        while( pNode != NULL )
+        {
+            if( ( pNode->pParent == pParent ) &&
+                ( pNode->hash == hash ) &&
+                ( pNode->levelLength == levelLength ) &&
+                ( pNode->wildcard == '\0' ) )
             {
-                status = IOT_MQTT_NO_MEMORY;
                 break;
             }
             else
             {
-                /* Clear the new subscription. */
-                ( void ) memset( pNewSubscription,
-                                 0x00,
-                                 sizeof( _mqttSubscription_t ) + pSubscriptionList[ i ].topicFilterLength );
-
-                /* Set the members of the new subscription and add it to the list. */
-                pNewSubscription->packetInfo.identifier = subscribePacketIdentifier;
-                pNewSubscription->packetInfo.order = i;
-                pNewSubscription->callback = pSubscriptionList[ i ].callback;
-                pNewSubscription->topicFilterLength = pSubscriptionList[ i ].topicFilterLength;
-                ( void ) memcpy( pNewSubscription->pTopicFilter,
-                                 pSubscriptionList[ i ].pTopicFilter,
-                                 ( size_t ) ( pSubscriptionList[ i ].topicFilterLength ) );
-
-                IotListDouble_InsertHead( &( pMqttConnection->subscriptionList ),
-                                          &( pNewSubscription->link ) );
+                pNode = pNode->pNextInBucket;
             }
         }
     }
 
-    IotMutex_Unlock( &( pMqttConnection->subscriptionMutex ) );
-
-    /* If memory allocation failed, remove all previously added subscriptions. */
-    if( status != IOT_MQTT_SUCCESS )
-    {
-        _IotMqtt_RemoveSubscriptionByTopicFilter( pMqttConnection,
-                                                  pSubscriptionList,
-                                                  i );
-    }
-    else
-    {
-        EMPTY_ELSE_MARKER;
-    }
-
-    return status;
+    return pNode;
 }
 
 /*-----------------------------------------------------------*/
 
-void _IotMqtt_InvokeSubscriptionCallback( _mqttConnection_t * pMqttConnection,
-                                          IotMqttCallbackParam_t * pCallbackParam )
+static void _pruneTopicNode( _mqttConnection_t * pMqttConnection,
+                             _mqttTopicNode_t * pNode )
 {
-    _mqttSubscription_t * pSubscription = NULL;
-    IotLink_t * pCurrentLink = NULL, * pNextLink = NULL;
-    void * pCallbackContext = NULL;
+    _mqttTopicNode_t * pParent = NULL;
+    _mqttTopicNode_t ** ppBucketEntry = NULL;
 
-    void ( * callbackFunction )( void *,
-                                 IotMqttCallbackParam_t * ) = NULL;
-    _topicMatchParams_t topicMatchParams =
+    /* Remove nodes until the root or a node that is still in use is reached. */
+    while( ( pNode->pParent != NULL ) &&
+           ( pNode->childCount == 0U ) &&
+           ( IotListDouble_IsEmpty( &( pNode->subscriptions ) ) == true ) )
     {
-        .pTopicName      = pCallbackParam->u.message.info.pTopicName,
-        .topicNameLength = pCallbackParam->u.message.info.topicNameLength,
-        .exactMatchOnly  = false
-    };
+        pParent = pNode->pParent;
 
-    /* Prevent any other thread from modifying the subscription list while this
-     * function is searching. */
-    IotMutex_Lock( &( pMqttConnection->subscriptionMutex ) );
+        /* Unlink the node from its hash bucket. */
+        ppBucketEntry = &( pMqttConnection->pTopicIndex[ pNode->hash % IOT_MQTT_SUBSCRIPTION_INDEX_BUCKETS ] );
 
-    /* Search the subscription list for all matching subscriptions starting at
-     * the list head. */
-    while( true )
-    {
-        pCurrentLink = IotListDouble_FindFirstMatch( &( pMqttConnection->subscriptionList ),
-                                                     pCurrentLink,
-                                                     _topicMatch,
-                                                     &topicMatchParams );
+        while( *ppBucketEntry != pNode )
+        {
+            IotMqtt_Assert( *ppBucketEntry != NULL );
+            ppBucketEntry = &( ( *ppBucketEntry )->pNextInBucket );
+        }
 
-        /* No subscription found. Exit loop. */
-        if( pCurrentLink == NULL )
+        *ppBucketEntry = pNode->pNextInBucket;
+
+        /* Clear the parent's wildcard slot. */
+        if( pParent->pSingleLevelChild == pNode )
         {
-            break;
+            pParent->pSingleLevelChild = NULL;
+        }
+        else if( pParent->pMultiLevelChild == pNode )
+        {
+            pParent->pMultiLevelChild = NULL;
         }
         else
         {
             EMPTY_ELSE_MARKER;
         }
 
-        /* Subscription found. Calculate pointer to subscription object. */
-        pSubscription = IotLink_Container( _mqttSubscription_t, pCurrentLink, link );
-
-        /* Subscription validation should not have allowed a NULL callback function. */
-        IotMqtt_Assert( pSubscription->callback.function != NULL );
+        IotMqtt_Assert( pParent->childCount > 0U );
+        ( pParent->childCount )--;
 
-        /* Increment the subscription's reference count. */
-        ( pSubscription->references )++;
+        IotMqtt_FreeTopicNode( pNode );
+        pNode = pParent;
+    }
+}
 
-        /* Copy the necessary members of the subscription before releasing the
-         * subscription list mutex. */
-        pCallbackContext = pSubscription->callback.pCallbackContext;
-        callbackFunction = pSubscription->callback.function;
+/*-----------------------------------------------------------*/
 
-        /* Unlock the subscription list mutex. */
-        IotMutex_Unlock( &( pMqttConnection->subscriptionMutex ) );
+static bool _indexSubscription( _mqttConnection_t * pMqttConnection,
+                                _mqttSubscription_t * pSubscription )
+{
+    bool status = true;
+    size_t levelStart = 0, levelEnd = 0;
+    const char * pLevel = NULL;
+    _mqttTopicNode_t * pNode = &( pMqttConnection->topicIndexRoot );
+    _mqttTopicNode_t * pChild = NULL;
+    uint32_t bucket = 0;
+
+    /* Walk the topic filter one level at a time. A topic filter of length n with
+     * k separators has k + 1 levels, some of which may be empty. */
+    while( levelStart <= pSubscription->topicFilterLength )
+    {
+        levelEnd = levelStart;
 
-        /* Set the members of the callback parameter. */
-        pCallbackParam->mqttConnection = pMqttConnection;
-        pCallbackParam->u.message.pTopicFilter = pSubscription->pTopicFilter;
-        pCallbackParam->u.message.topicFilterLength = pSubscription->topicFilterLength;
+        while( ( levelEnd < pSubscription->topicFilterLength ) &&
+               ( pSubscription->pTopicFilter[ levelEnd ] != '/' ) )
+        {
+            levelEnd++;
+        }
 
-        /* Invoke the subscription callback. */
-        callbackFunction( pCallbackContext, pCallbackParam );
+        pLevel = &( pSubscription->pTopicFilter[ levelStart ] );
+        pChild = _findTopicNode( pMqttConnection,
+                                 pNode,
+                                 pLevel,
+                                 levelEnd - levelStart,
+                                 true );
 
-        /* Lock the subscription list mutex to decrement the reference count. */
-        IotMutex_Lock( &( pMqttConnection->subscriptionMutex ) );
+        if( pChild == NULL )
+        {
+            pChild = IotMqtt_MallocTopicNode( sizeof( _mqttTopicNode_t ) );
 
-        /* Decrement the reference count. It must still be positive. */
-        ( pSubscription->references )--;
-        IotMqtt_Assert( pSubscription->references >= 0 );
+            if( pChild == NULL )
+            {
+                /* Remove any nodes created for this topic filter. */
+                _pruneTopicNode( pMqttConnection, pNode );
+                status = false;
 
-        /* Save the pointer to the next link in case this subscription is freed. */
-        pNextLink = pCurrentLink->pNext;
+                break;
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
+            }
 
-        /* Remove this subscription if it has no references and the unsubscribed
-         * flag is set. */
-        if( pSubscription->unsubscribed == true )
-        {
-            /* An unsubscribed subscription should have been removed from the list. */
-            IotMqtt_Assert( IotLink_IsLinked( &( pSubscription->link ) ) == false );
+            ( void ) memset( pChild, 0x00, sizeof( _mqttTopicNode_t ) );
+            pChild->pParent = pNode;
+            pChild->levelLength = ( uint16_t ) ( levelEnd - levelStart );
+            pChild->hash = _hashTopicLevel( pNode, pLevel, levelEnd - levelStart );
+            IotListDouble_Create( &( pChild->subscriptions ) );
 
-            /* Free subscriptions with no references. */
-            if( pSubscription->references == 0 )
+            /* Wildcard levels are also placed in the hash buckets so that all
+             * nodes may be found when the index is destroyed. */
+            if( ( pChild->levelLength == 1U ) && ( ( *pLevel == '+' ) || ( *pLevel == '#' ) ) )
             {
-                IotMqtt_FreeSubscription( pSubscription );
+                pChild->wildcard = *pLevel;
+
+                if( *pLevel == '+' )
+                {
+                    pNode->pSingleLevelChild = pChild;
+                }
+                else
+                {
+                    pNode->pMultiLevelChild = pChild;
+                }
             }
             else
             {
                 EMPTY_ELSE_MARKER;
             }
+
+            bucket = pChild->hash % IOT_MQTT_SUBSCRIPTION_INDEX_BUCKETS;
+            pChild->pNextInBucket = pMqttConnection->pTopicIndex[ bucket ];
+            pMqttConnection->pTopicIndex[ bucket ] = pChild;
+            ( pNode->childCount )++;
         }
         else
         {
             EMPTY_ELSE_MARKER;
         }
 
-        /* Move current link pointer. */
-        pCurrentLink = pNextLink;
+        pNode = pChild;
+        levelStart = levelEnd + 1U;
     }
 
-    IotMutex_Unlock( &( pMqttConnection->subscriptionMutex ) );
+    if( status == true )
+    {
+        IotListDouble_InsertHead( &( pNode->subscriptions ),
+                                  &( pSubscription->indexLink ) );
+        pSubscription->pIndexNode = pNode;
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
 
-    _IotMqtt_DecrementConnectionReferences( pMqttConnection );
+    return status;
 }
 
 /*-----------------------------------------------------------*/
 
-void _IotMqtt_RemoveSubscriptionByPacket( _mqttConnection_t * pMqttConnection,
-                                          uint16_t packetIdentifier,
-                                          int32_t order )
+static void _unindexSubscription( _mqttConnection_t * pMqttConnection,
+                                  _mqttSubscription_t * pSubscription )
 {
-    const _packetMatchParams_t packetMatchParams =
+    _mqttTopicNode_t * pNode = pSubscription->pIndexNode;
+
+    if( pNode != NULL )
     {
-        .packetIdentifier = packetIdentifier,
-        .order            = order
-    };
+        IotListDouble_Remove( &( pSubscription->indexLink ) );
+        pSubscription->pIndexNode = NULL;
+
+        _pruneTopicNode( pMqttConnection, pNode );
+    }
+    else if( pSubscription->unindexed == true )
+    {
+        pSubscription->unindexed = false;
+        ( pMqttConnection->unindexedSubscriptions )--;
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static _mqttSubscription_t * _findIndexedSubscription( const _mqttConnection_t * pMqttConnection,
+                                                       const char * pTopicFilter,
+                                                       uint16_t topicFilterLength )
+{
+    size_t levelStart = 0, levelEnd = 0;
+    const _mqttTopicNode_t * pNode = &( pMqttConnection->topicIndexRoot );
+    _mqttSubscription_t * pSubscription = NULL;
+    IotLink_t * pSubscriptionLink = NULL;
+
+    /* Find the node of the last level of the topic filter. */
+    while( ( pNode != NULL ) && ( levelStart <= topicFilterLength ) )
+    {
+        levelEnd = levelStart;
+
+        while( ( levelEnd < topicFilterLength ) && ( pTopicFilter[ levelEnd ] != '/' ) )
+        {
+            levelEnd++;
+        }
+
+        pNode = _findTopicNode( pMqttConnection,
+                                pNode,
+                                &( pTopicFilter[ levelStart ] ),
+                                levelEnd - levelStart,
+                                true );
+        levelStart = levelEnd + 1U;
+    }
+
+    /* Compare the topic filters of the node's subscriptions. */
+    if( pNode != NULL )
+    {
+        IotContainers_ForEach( &( pNode->subscriptions ), pSubscriptionLink )
+        {
+            pSubscription = IotLink_Container( _mqttSubscription_t, pSubscriptionLink, indexLink );
+
+            if( ( pSubscription->topicFilterLength == topicFilterLength ) &&
+                ( strncmp( pSubscription->pTopicFilter, pTopicFilter, topicFilterLength ) == 0 ) )
+            {
+                break;
+            }
+            else
+            {
+                pSubscription = NULL;
+            }
+        }
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    return pSubscription;
+}
+
+/*-----------------------------------------------------------*/
+
+static _mqttSubscription_t * _findSubscription( _mqttConnection_t * pMqttConnection,
+                                                const char * pTopicFilter,
+                                                uint16_t topicFilterLength )
+{
+    _mqttSubscription_t * pSubscription = NULL;
+    IotLink_t * pSubscriptionLink = NULL;
+    _topicMatchParams_t topicMatchParams =
+    {
+        .pTopicName      = pTopicFilter,
+        .topicNameLength = topicFilterLength,
+        .exactMatchOnly  = true
+    };
+
+    pSubscription = _findIndexedSubscription( pMqttConnection,
+                                              pTopicFilter,
+                                              topicFilterLength );
+
+    if( ( pSubscription == NULL ) && ( pMqttConnection->unindexedSubscriptions > 0U ) )
+    {
+        pSubscriptionLink = IotListDouble_FindFirstMatch( &( pMqttConnection->subscriptionList ),
+                                                          NULL,
+                                                          _topicMatch,
+                                                          &topicMatchParams );
+
+        if( pSubscriptionLink != NULL )
+        {
+            pSubscription = IotLink_Container( _mqttSubscription_t, pSubscriptionLink, link );
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    return pSubscription;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool _findIndexedMatches( const _mqttConnection_t * pMqttConnection,
+                                 _topicMatchParams_t * pTopicMatchParams,
+                                 _subscriptionMatch_t * pMatches,
+                                 size_t * pMatchCount )
+{
+    bool status = true;
+    size_t stepCount = 0, matchCount = 0, levelEnd = 0, i = 0;
+    _topicIndexStep_t steps[ TOPIC_INDEX_MAX_STEPS ] = { { 0 } };
+    _topicIndexStep_t currentStep = { 0 };
+    const _mqttTopicNode_t * pCandidates[ 2 ] = { NULL };
+    const _mqttTopicNode_t * pChildren[ 2 ] = { NULL };
+    _mqttSubscription_t * pSubscription = NULL;
+    IotLink_t * pSubscriptionLink = NULL;
+    const char * pTopicName = pTopicMatchParams->pTopicName;
+    const size_t topicNameLength = pTopicMatchParams->topicNameLength;
+
+    /* Start the search at the root, before the first topic level. */
+    steps[ 0 ].pNode = &( pMqttConnection->topicIndexRoot );
+    steps[ 0 ].levelStart = 0;
+    stepCount = 1;
+
+    while( ( status == true ) && ( stepCount > 0U ) )
+    {
+        stepCount--;
+        currentStep = steps[ stepCount ];
+
+        /* A '#' child matches all remaining levels, including none. */
+        pCandidates[ 0 ] = currentStep.pNode->pMultiLevelChild;
+        pCandidates[ 1 ] = NULL;
+
+        if( currentStep.levelStart > topicNameLength )
+        {
+            /* All levels of the topic name were matched by this node. */
+            pCandidates[ 1 ] = currentStep.pNode;
+        }
+        else
+        {
+            levelEnd = currentStep.levelStart;
+
+            while( ( levelEnd < topicNameLength ) && ( pTopicName[ levelEnd ] != '/' ) )
+            {
+                levelEnd++;
+            }
+
+            /* The next level may be matched literally or by a '+' child. */
+            pChildren[ 0 ] = _findTopicNode( pMqttConnection,
+                                             currentStep.pNode,
+                                             &( pTopicName[ currentStep.levelStart ] ),
+                                             levelEnd - currentStep.levelStart,
+                                             false );
+            pChildren[ 1 ] = currentStep.pNode->pSingleLevelChild;
+
+            for( i = 0; i < 2U; i++ )
+            {
+                if( pChildren[ i ] != NULL )
+                {
+                    if( stepCount == TOPIC_INDEX_MAX_STEPS )
+                    {
+                        status = false;
+                        break;
+                    }
+                    else
+                    {
+                        steps[ stepCount ].pNode = pChildren[ i ];
+                        steps[ stepCount ].levelStart = levelEnd + 1U;
+                        stepCount++;
+                    }
+                }
+                else
+                {
+                    EMPTY_ELSE_MARKER;
+                }
+            }
+        }
+
+        /* Collect the subscriptions of matching nodes. */
+        for( i = 0; ( status == true ) && ( i < 2U ); i++ )
+        {
+            if( pCandidates[ i ] != NULL )
+            {
+                IotContainers_ForEach( &( pCandidates[ i ]->subscriptions ), pSubscriptionLink )
+                {
+                    pSubscription = IotLink_Container( _mqttSubscription_t, pSubscriptionLink, indexLink );
+
+                    /* Confirm the match, as colliding topic levels may share a node. */
+                    if( _topicMatch( &( pSubscription->link ), pTopicMatchParams ) == true )
+                    {
+                        if( matchCount == IOT_MQTT_SUBSCRIPTION_DISPATCH_BATCH )
+                        {
+                            status = false;
+                            break;
+                        }
+                        else
+                        {
+                            pMatches[ matchCount ].pSubscription = pSubscription;
+                            matchCount++;
+                        }
+                    }
+                    else
+                    {
+                        EMPTY_ELSE_MARKER;
+                    }
+                }
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
+            }
+        }
+    }
+
+    *pMatchCount = matchCount;
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _invokeListedSubscriptions( _mqttConnection_t * pMqttConnection,
+                                        _topicMatchParams_t * pTopicMatchParams,
+                                        IotMqttCallbackParam_t * pCallbackParam )
+{
+    _mqttSubscription_t * pSubscription = NULL;
+    IotLink_t * pCurrentLink = NULL, * pNextLink = NULL;
+    void * pCallbackContext = NULL;
+
+    void ( * callbackFunction )( void *,
+                                 IotMqttCallbackParam_t * ) = NULL;
+
+    /* Prevent any other thread from modifying the subscription list while this
+     * function is searching. */
+    IotMutex_Lock( &( pMqttConnection->subscriptionMutex ) );
+
+    /* Search the subscription list for all matching subscriptions starting at
+     * the list head. */
+    while( true )
+    {
+        pCurrentLink = IotListDouble_FindFirstMatch( &( pMqttConnection->subscriptionList ),
+                                                     pCurrentLink,
+                                                     _topicMatch,
+                                                     pTopicMatchParams );
+
+        /* No subscription found. Exit loop. */
+        if( pCurrentLink == NULL )
+        {
+            break;
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+
+        /* Subscription found. Calculate pointer to subscription object. */
+        pSubscription = IotLink_Container( _mqttSubscription_t, pCurrentLink, link );
+
+        /* Subscription validation should not have allowed a NULL callback function. */
+        IotMqtt_Assert( pSubscription->callback.function != NULL );
+
+        /* Increment the subscription's reference count. */
+        ( pSubscription->references )++;
+
+        /* Copy the necessary members of the subscription before releasing the
+         * subscription list mutex. */
+        pCallbackContext = pSubscription->callback.pCallbackContext;
+        callbackFunction = pSubscription->callback.function;
+
+        /* Unlock the subscription list mutex. */
+        IotMutex_Unlock( &( pMqttConnection->subscriptionMutex ) );
+
+        /* Set the members of the callback parameter. */
+        pCallbackParam->mqttConnection = pMqttConnection;
+        pCallbackParam->u.message.pTopicFilter = pSubscription->pTopicFilter;
+        pCallbackParam->u.message.topicFilterLength = pSubscription->topicFilterLength;
+
+        /* Invoke the subscription callback. */
+        callbackFunction( pCallbackContext, pCallbackParam );
+
+        /* Lock the subscription list mutex to decrement the reference count. */
+        IotMutex_Lock( &( pMqttConnection->subscriptionMutex ) );
+
+        /* Decrement the reference count. It must still be positive. */
+        ( pSubscription->references )--;
+        IotMqtt_Assert( pSubscription->references >= 0 );
+
+        /* Save the pointer to the next link in case this subscription is freed. */
+        pNextLink = pCurrentLink->pNext;
+
+        /* Remove this subscription if it has no references and the unsubscribed
+         * flag is set. */
+        if( pSubscription->unsubscribed == true )
+        {
+            /* An unsubscribed subscription should have been removed from the list. */
+            IotMqtt_Assert( IotLink_IsLinked( &( pSubscription->link ) ) == false );
+
+            /* Free subscriptions with no references. */
+            if( pSubscription->references == 0 )
+            {
+                IotMqtt_FreeSubscription( pSubscription );
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
+            }
+        }
+        else
+        {
+            EMPTY_ELSE_MARKER;
+        }
+
+        /* Move current link pointer. */
+        pCurrentLink = pNextLink;
+    }
+
+    IotMutex_Unlock( &( pMqttConnection->subscriptionMutex ) );
+}
+
+/*-----------------------------------------------------------*/
+
+IotMqttError_t _IotMqtt_AddSubscriptions( _mqttConnection_t * pMqttConnection,
+                                          uint16_t subscribePacketIdentifier,
+                                          const IotMqttSubscription_t * pSubscriptionList,
+                                          size_t subscriptionCount )
+{
+    IotMqttError_t status = IOT_MQTT_SUCCESS;
+    size_t i = 0;
+    _mqttSubscription_t * pNewSubscription = NULL;
+
+    IotMutex_Lock( &( pMqttConnection->subscriptionMutex ) );
+
+    for( i = 0; i < subscriptionCount; i++ )
+    {
+        /* Check if this topic filter is already registered. */
+        pNewSubscription = _findSubscription( pMqttConnection,
+                                              pSubscriptionList[ i ].pTopicFilter,
+                                              pSubscriptionList[ i ].topicFilterLength );
+
+        if( pNewSubscription != NULL )
+        {
+            /* The lengths of exactly matching topic filters must match. */
+            IotMqtt_Assert( pNewSubscription->topicFilterLength == pSubscriptionList[ i ].topicFilterLength );
+
+            /* Replace the callback and packet info with the new parameters. */
+            pNewSubscription->callback = pSubscriptionList[ i ].callback;
+            pNewSubscription->packetInfo.identifier = subscribePacketIdentifier;
+            pNewSubscription->packetInfo.order = i;
+        }
+        else
+        {
+            /* Allocate memory for a new subscription. */
+            pNewSubscription = IotMqtt_MallocSubscription( sizeof( _mqttSubscription_t ) +
+                                                           pSubscriptionList[ i ].topicFilterLength );
+
+            if( pNewSubscription == NULL )
+            {
+                status = IOT_MQTT_NO_MEMORY;
+                break;
+            }
+            else
+            {
+                /* Clear the new subscription. */
+                ( void ) memset( pNewSubscription,
+                                 0x00,
+                                 sizeof( _mqttSubscription_t ) + pSubscriptionList[ i ].topicFilterLength );
+
+                /* Set the members of the new subscription and add it to the list. */
+                pNewSubscription->packetInfo.identifier = subscribePacketIdentifier;
+                pNewSubscription->packetInfo.order = i;
+                pNewSubscription->callback = pSubscriptionList[ i ].callback;
+                pNewSubscription->topicFilterLength = pSubscriptionList[ i ].topicFilterLength;
+                ( void ) memcpy( pNewSubscription->pTopicFilter,
+                                 pSubscriptionList[ i ].pTopicFilter,
+                                 ( size_t ) ( pSubscriptionList[ i ].topicFilterLength ) );
+
+                /* Add the new subscription to the subscription index. If no index
+                 * node is available, the subscription is still added to the list;
+                 * lookups then search the list for it. */
+                if( _indexSubscription( pMqttConnection, pNewSubscription ) == false )
+                {
+                    IotLogWarn( "(MQTT connection %p) No memory to index subscription %.*s; "
+                                "it will be found by searching all subscriptions.",
+                                pMqttConnection,
+                                pNewSubscription->topicFilterLength,
+                                pNewSubscription->pTopicFilter );
+
+                    pNewSubscription->unindexed = true;
+                    ( pMqttConnection->unindexedSubscriptions )++;
+                }
+                else
+                {
+                    EMPTY_ELSE_MARKER;
+                }
+
+                IotListDouble_InsertHead( &( pMqttConnection->subscriptionList ),
+                                          &( pNewSubscription->link ) );
+            }
+        }
+    }
+
+    IotMutex_Unlock( &( pMqttConnection->subscriptionMutex ) );
+
+    /* If memory allocation failed, remove all previously added subscriptions. */
+    if( status != IOT_MQTT_SUCCESS )
+    {
+        _IotMqtt_RemoveSubscriptionByTopicFilter( pMqttConnection,
+                                                  pSubscriptionList,
+                                                  i );
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
+void _IotMqtt_InvokeSubscriptionCallback( _mqttConnection_t * pMqttConnection,
+                                          IotMqttCallbackParam_t * pCallbackParam )
+{
+    bool indexSearched = false;
+    size_t i = 0, matchCount = 0;
+    _mqttSubscription_t * pSubscription = NULL;
+    _subscriptionMatch_t pMatches[ IOT_MQTT_SUBSCRIPTION_DISPATCH_BATCH ];
+    _topicMatchParams_t topicMatchParams =
+    {
+        .pTopicName      = pCallbackParam->u.message.info.pTopicName,
+        .topicNameLength = pCallbackParam->u.message.info.topicNameLength,
+        .exactMatchOnly  = false
+    };
+
+    /* Prevent any other thread from modifying the subscription index while this
+     * function is searching. */
+    IotMutex_Lock( &( pMqttConnection->subscriptionMutex ) );
+
+    /* Subscriptions that could not be indexed are only found in the list. */
+    if( pMqttConnection->unindexedSubscriptions == 0U )
+    {
+        indexSearched = _findIndexedMatches( pMqttConnection,
+                                             &topicMatchParams,
+                                             pMatches,
+                                             &matchCount );
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    if( indexSearched == true )
+    {
+        /* Reference all matching subscriptions and copy their callbacks before
+         * releasing the subscription mutex. */
+        for( i = 0; i < matchCount; i++ )
+        {
+            pSubscription = pMatches[ i ].pSubscription;
+
+            /* Subscription validation should not have allowed a NULL callback function. */
+            IotMqtt_Assert( pSubscription->callback.function != NULL );
+
+            ( pSubscription->references )++;
+            pMatches[ i ].callback = pSubscription->callback;
+        }
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    IotMutex_Unlock( &( pMqttConnection->subscriptionMutex ) );
+
+    if( indexSearched == true )
+    {
+        /* Invoke the subscription callbacks. */
+        for( i = 0; i < matchCount; i++ )
+        {
+            pCallbackParam->mqttConnection = pMqttConnection;
+            pCallbackParam->u.message.pTopicFilter = pMatches[ i ].pSubscription->pTopicFilter;
+            pCallbackParam->u.message.topicFilterLength = pMatches[ i ].pSubscription->topicFilterLength;
+
+            pMatches[ i ].callback.function( pMatches[ i ].callback.pCallbackContext,
+                                             pCallbackParam );
+        }
+
+        /* Lock the subscription mutex to decrement the reference counts. */
+        IotMutex_Lock( &( pMqttConnection->subscriptionMutex ) );
+
+        for( i = 0; i < matchCount; i++ )
+        {
+            pSubscription = pMatches[ i ].pSubscription;
+
+            /* Decrement the reference count. It must still be positive. */
+            ( pSubscription->references )--;
+            IotMqtt_Assert( pSubscription->references >= 0 );
+
+            /* Free this subscription if it has no references and the unsubscribed
+             * flag is set. */
+            if( ( pSubscription->unsubscribed == true ) && ( pSubscription->references == 0 ) )
+            {
+                /* An unsubscribed subscription should have been removed from the index. */
+                IotMqtt_Assert( pSubscription->pIndexNode == NULL );
+
+                IotMqtt_FreeSubscription( pSubscription );
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
+            }
+        }
+
+        IotMutex_Unlock( &( pMqttConnection->subscriptionMutex ) );
+    }
+    else
+    {
+        /* The search did not fit in the fixed-size buffers or some subscriptions
+         * are not indexed; walk the whole subscription list instead. */
+        IotLogDebug( "(MQTT connection %p) Subscription index search exceeded its "
+                     "limits or is incomplete; searching all subscriptions.",
+                     pMqttConnection );
+
+        _invokeListedSubscriptions( pMqttConnection,
+                                    &topicMatchParams,
+                                    pCallbackParam );
+    }
+
+    _IotMqtt_DecrementConnectionReferences( pMqttConnection );
+}
+
+/*-----------------------------------------------------------*/
+
+void _IotMqtt_RemoveSubscriptionByPacket( _mqttConnection_t * pMqttConnection,
+                                          uint16_t packetIdentifier,
+                                          int32_t order )
+{
+    const _packetMatchParams_t packetMatchParams =
+    {
+        .packetIdentifier = packetIdentifier,
+        .order            = order,
+        .pMqttConnection  = pMqttConnection
+    };
 
     IotMutex_Lock( &( pMqttConnection->subscriptionMutex ) );
     IotListDouble_RemoveAllMatches( &( pMqttConnection->subscriptionList ),
@@ -557,8 +1314,9 @@ void _IotMqtt_RemoveSubscriptionByTopicFilter( _mqttConnection_t * pMqttConnecti
             /* Reference count must not be negative. */
             IotMqtt_Assert( pSubscription->references >= 0 );
 
-            /* Remove subscription from list. */
+            /* Remove subscription from list and index. */
             IotListDouble_Remove( pSubscriptionLink );
+            _unindexSubscription( pMqttConnection, pSubscription );
 
             /* Check the reference count. This subscription cannot be removed if
              * there are subscription callbacks using it. */
@@ -585,6 +1343,31 @@ void _IotMqtt_RemoveSubscriptionByTopicFilter( _mqttConnection_t * pMqttConnecti
 
 /*-----------------------------------------------------------*/
 
+void _IotMqtt_DestroySubscriptionIndex( _mqttConnection_t * pMqttConnection )
+{
+    size_t i = 0;
+    _mqttTopicNode_t * pNode = NULL, * pNextNode = NULL;
+
+    /* Every node other than the root is in a hash bucket. */
+    for( i = 0; i < IOT_MQTT_SUBSCRIPTION_INDEX_BUCKETS; i++ )
+    {
+        pNode = pMqttConnection->pTopicIndex[ i ];
+
+        while( pNode != NULL )
+        {
+            pNextNode = pNode->pNextInBucket;
+            IotMqtt_FreeTopicNode( pNode );
+            pNode = pNextNode;
+        }
+
+        pMqttConnection->pTopicIndex[ i ] = NULL;
+    }
+
+    ( void ) memset( &( pMqttConnection->topicIndexRoot ), 0x00, sizeof( _mqttTopicNode_t ) );
+    pMqttConnection->unindexedSubscriptions = 0;
+}
+/*-----------------------------------------------------------*/
+
 bool IotMqtt_IsSubscribed( IotMqttConnection_t mqttConnection,
                            const char * pTopicFilter,
                            uint16_t topicFilterLength,
@@ -592,29 +1375,19 @@ bool IotMqtt_IsSubscribed( IotMqttConnection_t mqttConnection,
 {
     bool status = false;
     _mqttSubscription_t * pSubscription = NULL;
-    IotLink_t * pSubscriptionLink = NULL;
-    _topicMatchParams_t topicMatchParams =
-    {
-        .pTopicName      = pTopicFilter,
-        .topicNameLength = topicFilterLength,
-        .exactMatchOnly  = true
-    };
 
     /* Prevent any other thread from modifying the subscription list while this
      * function is running. */
     IotMutex_Lock( &( mqttConnection->subscriptionMutex ) );
 
     /* Search for a matching subscription. */
-    pSubscriptionLink = IotListDouble_FindFirstMatch( &( mqttConnection->subscriptionList ),
-                                                      NULL,
-                                                      _topicMatch,
-                                                      &topicMatchParams );
+    pSubscription = _findSubscription( mqttConnection,
+                                       pTopicFilter,
+                                       topicFilterLength );
 
     /* Check if a matching subscription was found. */
-    if( pSubscriptionLink != NULL )
+    if( pSubscription != NULL )
     {
-        pSubscription = IotLink_Container( _mqttSubscription_t, pSubscriptionLink, link );
-
         /* Copy the matching subscription to the output parameter. */
         if( pCurrentSubscription != NULL )
         {
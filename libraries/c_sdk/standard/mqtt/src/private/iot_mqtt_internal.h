@@ -138,6 +138,20 @@
  * (http://pubs.opengroup.org/onlinepubs/9699919799/functions/free.html).
  */
     void IotMqtt_FreeSubscription( void * ptr );
+
+/**
+ * @brief Allocate an #_mqttTopicNode_t. This function should have the same
+ * signature as [malloc]
+ * (http://pubs.opengroup.org/onlinepubs/9699919799/functions/malloc.html).
+ */
+    void * IotMqtt_MallocTopicNode( size_t size );
+
+/**
+ * @brief Free an #_mqttTopicNode_t. This function should have the same
+ * signature as [free]
+ * (http://pubs.opengroup.org/onlinepubs/9699919799/functions/free.html).
+ */
+    void IotMqtt_FreeTopicNode( void * ptr );
 #else /* if IOT_STATIC_MEMORY_ONLY == 1 */
     #include <stdlib.h>
 
@@ -172,6 +186,14 @@
     #ifndef IotMqtt_FreeSubscription
         #define IotMqtt_FreeSubscription    free
     #endif
+
+    #ifndef IotMqtt_MallocTopicNode
+        #define IotMqtt_MallocTopicNode    malloc
+    #endif
+
+    #ifndef IotMqtt_FreeTopicNode
+        #define IotMqtt_FreeTopicNode    free
+    #endif
 #endif /* if IOT_STATIC_MEMORY_ONLY == 1 */
 
 /**
@@ -192,8 +214,67 @@
 #ifndef IOT_MQTT_RETRY_MS_CEILING
     #define IOT_MQTT_RETRY_MS_CEILING               ( 60000 )
 #endif
+#ifndef IOT_MQTT_SUBSCRIPTION_INDEX_BUCKETS
+    #define IOT_MQTT_SUBSCRIPTION_INDEX_BUCKETS     ( 64 )
+#endif
+#ifndef IOT_MQTT_SUBSCRIPTION_DISPATCH_BATCH
+    #define IOT_MQTT_SUBSCRIPTION_DISPATCH_BATCH    ( 8 )
+#endif
+#ifndef IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS
+    #define IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS       ( 32 )
+#endif
+#ifndef IOT_MQTT_PUBLISH_HEADER_BUFFER_SIZE
+    #define IOT_MQTT_PUBLISH_HEADER_BUFFER_SIZE     ( 64 )
+#endif
 /** @endcond */
 
+/* Validate subscription index configuration settings. */
+#if IOT_MQTT_SUBSCRIPTION_INDEX_BUCKETS <= 0
+    #error "IOT_MQTT_SUBSCRIPTION_INDEX_BUCKETS cannot be 0 or negative."
+#endif
+#if IOT_MQTT_SUBSCRIPTION_DISPATCH_BATCH <= 0
+    #error "IOT_MQTT_SUBSCRIPTION_DISPATCH_BATCH cannot be 0 or negative."
+#endif
+
+/* Validate in-flight operation configuration settings. */
+#if IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS <= 0
+    #error "IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS cannot be 0 or negative."
+#endif
+#if IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS > 3072
+    #error "IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS cannot be more than 3072."
+#endif
+
+/**
+ * @brief The number of slots in the pending response index of a connection.
+ *
+ * The smallest power of 2 that keeps the index at most 3/4 full with
+ * #IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS operations in it.
+ */
+#if IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS <= 12
+    #define MQTT_PENDING_RESPONSE_INDEX_SIZE    ( 16 )
+#elif IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS <= 24
+    #define MQTT_PENDING_RESPONSE_INDEX_SIZE    ( 32 )
+#elif IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS <= 48
+    #define MQTT_PENDING_RESPONSE_INDEX_SIZE    ( 64 )
+#elif IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS <= 96
+    #define MQTT_PENDING_RESPONSE_INDEX_SIZE    ( 128 )
+#elif IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS <= 192
+    #define MQTT_PENDING_RESPONSE_INDEX_SIZE    ( 256 )
+#elif IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS <= 384
+    #define MQTT_PENDING_RESPONSE_INDEX_SIZE    ( 512 )
+#elif IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS <= 768
+    #define MQTT_PENDING_RESPONSE_INDEX_SIZE    ( 1024 )
+#elif IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS <= 1536
+    #define MQTT_PENDING_RESPONSE_INDEX_SIZE    ( 2048 )
+#else
+    #define MQTT_PENDING_RESPONSE_INDEX_SIZE    ( 4096 )
+#endif
+
+/* Validate zero-copy PUBLISH configuration settings. */
+#if IOT_MQTT_PUBLISH_HEADER_BUFFER_SIZE <= 0
+    #error "IOT_MQTT_PUBLISH_HEADER_BUFFER_SIZE cannot be 0 or negative."
+#endif
+
 /**
  * @brief Marks the empty statement of an `else` branch.
  *
@@ -247,6 +328,28 @@
 
 /*---------------------- MQTT internal data structures ----------------------*/
 
+/**
+ * @brief A single topic level in the subscription index of an MQTT connection.
+ *
+ * Topic filters are split on '/' and stored as a trie of these nodes, so that
+ * the subscriptions matching a topic name can be found by walking the topic
+ * levels instead of every subscription. Literal levels are found through the
+ * hash buckets of #_mqttConnection_t.pTopicIndex; the '+' and '#' wildcard
+ * levels have dedicated child slots.
+ */
+typedef struct _mqttTopicNode
+{
+    struct _mqttTopicNode * pParent;           /**< @brief The node of the previous topic level. */
+    struct _mqttTopicNode * pNextInBucket;     /**< @brief Next node in the same hash bucket. */
+    struct _mqttTopicNode * pSingleLevelChild; /**< @brief The '+' wildcard child of this level. */
+    struct _mqttTopicNode * pMultiLevelChild;  /**< @brief The '#' wildcard child of this level. */
+    IotListDouble_t subscriptions;             /**< @brief Subscriptions whose topic filter ends at this level. */
+    uint32_t hash;                             /**< @brief Hash of the topic filter up to and including this level. */
+    uint16_t levelLength;                      /**< @brief Length of the topic level represented by this node. */
+    uint16_t childCount;                       /**< @brief Number of nodes with this node as their parent. */
+    char wildcard;                             /**< @brief '+' or '#' for wildcard levels; '\0' for literal levels. */
+} _mqttTopicNode_t;
+
 /**
  * @brief Represents an MQTT connection.
  */
@@ -267,10 +370,18 @@ typedef struct _mqttConnection
     int32_t references;                          /**< @brief Counts callbacks and operations using this connection. */
     IotListDouble_t pendingProcessing;           /**< @brief List of operations waiting to be processed by a task pool routine. */
     IotListDouble_t pendingResponse;             /**< @brief List of processed operations awaiting a server response. */
+    uint32_t operationCount;                     /**< @brief Number of operations created for this connection and not yet destroyed. */
+
+    struct _mqttOperation * pPendingResponseIndex[ MQTT_PENDING_RESPONSE_INDEX_SIZE ]; /**< @brief Open-addressing index of pendingResponse by type and packet identifier. */
+    uint32_t pendingResponseIndexCount;                                                 /**< @brief Number of operations in the pending response index. */
 
     IotListDouble_t subscriptionList;            /**< @brief Holds subscriptions associated with this connection. */
     IotMutex_t subscriptionMutex;                /**< @brief Grants exclusive access to the subscription list. */
 
+    _mqttTopicNode_t topicIndexRoot;                                       /**< @brief Root of the subscription index; represents no topic level. */
+    _mqttTopicNode_t * pTopicIndex[ IOT_MQTT_SUBSCRIPTION_INDEX_BUCKETS ]; /**< @brief Hash buckets of the subscription index. Protected by the subscription mutex. */
+    size_t unindexedSubscriptions;                                         /**< @brief Number of subscriptions in the subscription list that could not be indexed. Protected by the subscription mutex. */
+
     bool keepAliveFailure;                       /**< @brief Failure flag for keep-alive operation. */
     uint32_t keepAliveMs;                        /**< @brief Keep-alive interval in milliseconds. Its max value (per spec) is 65,535,000. */
     uint32_t nextKeepAliveMs;                    /**< @brief Relative delay for next keep-alive job. */
@@ -308,6 +419,10 @@ typedef struct _mqttSubscription
 
     IotMqttCallbackInfo_t callback; /**< @brief Callback information for this subscription. */
 
+    IotLink_t indexLink;            /**< @brief Link in the subscription list of #_mqttSubscription_t.pIndexNode. */
+    _mqttTopicNode_t * pIndexNode;  /**< @brief Subscription index node of this topic filter; `NULL` if not indexed. */
+    bool unindexed;                 /**< @brief Whether this subscription is in the subscription list but could not be added to the index. */
+
     uint16_t topicFilterLength;     /**< @brief Length of #_mqttSubscription_t.pTopicFilter. */
     char pTopicFilter[];            /**< @brief The subscription topic filter. */
 } _mqttSubscription_t;
@@ -339,11 +454,14 @@ typedef struct _mqttOperation
             IotMqttOperationType_t type; /**< @brief What operation this structure represents. */
             uint32_t flags;              /**< @brief Flags passed to the function that created this operation. */
             uint16_t packetIdentifier;   /**< @brief The packet identifier used with this operation. */
+            bool indexed;                /**< @brief Whether this operation is in the pending response index of its connection. */
 
             /* Serialized packet and size. */
             uint8_t * pMqttPacket;           /**< @brief The MQTT packet to send over the network. */
             uint8_t * pPacketIdentifierHigh; /**< @brief The location of the high byte of the packet identifier in the MQTT packet. */
             size_t packetSize;               /**< @brief Size of `pMqttPacket`. */
+            const uint8_t * pPayload;        /**< @brief PUBLISH payload sent after `pMqttPacket` without copying; `NULL` if not used. */
+            size_t payloadLength;            /**< @brief Size of `pPayload`. */
 
             /* How to notify of an operation's completion. */
             union
@@ -522,6 +640,34 @@ IotMqttError_t _IotMqtt_SerializePublish( const IotMqttPublishInfo_t * pPublishI
                                           uint16_t * pPacketIdentifier,
                                           uint8_t ** pPacketIdentifierHigh );
 
+/**
+ * @brief Generate the headers of a PUBLISH packet without its payload.
+ *
+ * The generated packet is identical to the one from #_IotMqtt_SerializePublish
+ * up to the payload, which is not copied. The payload must be sent directly
+ * after the generated packet.
+ *
+ * @param[in] pPublishInfo User-provided PUBLISH information.
+ * @param[in] pHeaderBuffer Fixed buffer for the headers. Memory is only
+ * allocated if the headers don't fit in it.
+ * @param[in] headerBufferSize Size of `pHeaderBuffer`.
+ * @param[out] pPublishPacket Where the PUBLISH headers are written. This is
+ * `pHeaderBuffer` if they fit.
+ * @param[out] pPacketSize Size of the headers written to `pPublishPacket`.
+ * @param[out] pPacketIdentifier The packet identifier generated for this PUBLISH.
+ * @param[out] pPacketIdentifierHigh Where the high byte of the packet identifier
+ * is written.
+ *
+ * @return #IOT_MQTT_SUCCESS, #IOT_MQTT_NO_MEMORY, or #IOT_MQTT_BAD_PARAMETER.
+ */
+IotMqttError_t _IotMqtt_SerializePublishHeader( const IotMqttPublishInfo_t * pPublishInfo,
+                                                uint8_t * pHeaderBuffer,
+                                                size_t headerBufferSize,
+                                                uint8_t ** pPublishPacket,
+                                                size_t * pPacketSize,
+                                                uint16_t * pPacketIdentifier,
+                                                uint8_t ** pPacketIdentifierHigh );
+
 /**
  * @brief Set the DUP bit in a QoS 1 PUBLISH packet.
  *
@@ -796,6 +942,26 @@ _mqttOperation_t * _IotMqtt_FindOperation( _mqttConnection_t * pMqttConnection,
                                            IotMqttOperationType_t type,
                                            const uint16_t * pPacketIdentifier );
 
+/**
+ * @brief Move an operation to the list of MQTT operations pending responses,
+ * and add it to the pending response index (if enabled) by its packet identifier.
+ *
+ * The connection's references mutex must be locked when calling this function.
+ *
+ * @param[in] pOperation The operation awaiting a response.
+ */
+void _IotMqtt_AddPendingResponse( _mqttOperation_t * pOperation );
+
+/**
+ * @brief Remove an operation from the MQTT connection list it is in, and from
+ * the pending response index.
+ *
+ * The connection's references mutex must be locked when calling this function.
+ *
+ * @param[in] pOperation The operation to remove.
+ */
+void _IotMqtt_UnlinkOperation( _mqttOperation_t * pOperation );
+
 /**
  * @brief Notify of a completed MQTT operation.
  *
@@ -862,6 +1028,19 @@ void _IotMqtt_RemoveSubscriptionByTopicFilter( _mqttConnection_t * pMqttConnecti
                                                const IotMqttSubscription_t * pSubscriptionList,
                                                size_t subscriptionCount );
 
+/**
+ * @brief Free all nodes of the subscription index of an MQTT connection.
+ *
+ * Subscriptions are not affected by this function; they should be removed
+ * from the subscription list separately.
+ *
+ * @param[in] pMqttConnection The MQTT connection that owns the index.
+ *
+ * @warning The subscription mutex of `pMqttConnection` must be locked when
+ * calling this function.
+ */
+void _IotMqtt_DestroySubscriptionIndex( _mqttConnection_t * pMqttConnection );
+
 /*------------------ MQTT connection management functions -------------------*/
 
 /**
@@ -73,6 +73,7 @@ typedef struct _packetMatchParams
 {
     uint16_t packetIdentifier;
     int32_t order;
+    _mqttConnection_t * pMqttConnection;
 } _packetMatchParams_t;
 
 /**
@@ -122,6 +122,11 @@
       4 * DUP_CHECK_RETRY_MS + \
       IOT_MQTT_RESPONSE_WAIT_MS )
 
+/**
+ * @brief Payload used by #TEST_MQTT_Unit_API_PublishZeroCopy.
+ */
+#define ZERO_COPY_PAYLOAD    ( "zero-copy payload" )
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -403,6 +408,59 @@ static size_t _dupChecker( void * pSendContext,
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief A vectored send function that checks that a PUBLISH payload was sent
+ * directly from the application buffer.
+ */
+static size_t _sendvZeroCopy( void * pSendContext,
+                              const IotNetworkIoVector_t * pVectors,
+                              size_t vectorCount )
+{
+    bool * pZeroCopyResult = ( bool * ) pSendContext;
+    size_t i = 0, bytesSent = 0;
+
+    /* The PUBLISH headers and payload should be sent as separate buffers, with
+     * the payload buffer pointing to the application's payload. */
+    if( vectorCount == 2 )
+    {
+        *pZeroCopyResult = ( ( pVectors[ 0 ].pBuffer[ 0 ] & 0xf0 ) == MQTT_PACKET_TYPE_PUBLISH ) &&
+                           ( pVectors[ 0 ].pBuffer[ 1 ] == ( pVectors[ 0 ].length - 2 + pVectors[ 1 ].length ) ) &&
+                           ( pVectors[ 1 ].pBuffer == ( const uint8_t * ) ZERO_COPY_PAYLOAD ) &&
+                           ( pVectors[ 1 ].length == sizeof( ZERO_COPY_PAYLOAD ) - 1 );
+    }
+    else
+    {
+        *pZeroCopyResult = false;
+    }
+
+    for( i = 0; i < vectorCount; i++ )
+    {
+        bytesSent += pVectors[ i ].length;
+    }
+
+    /* Return the total length to simulate a successful send. */
+    return bytesSent;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A vectored send function that always fails.
+ */
+static size_t _sendvFail( void * pSendContext,
+                          const IotNetworkIoVector_t * pVectors,
+                          size_t vectorCount )
+{
+    /* Silence warnings about unused parameters. */
+    ( void ) pSendContext;
+    ( void ) pVectors;
+    ( void ) vectorCount;
+
+    return 0;
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief A network receive function that simulates receiving a PINGRESP.
  */
@@ -556,6 +614,7 @@ TEST_TEAR_DOWN( MQTT_Unit_API )
 TEST_GROUP_RUNNER( MQTT_Unit_API )
 {
     RUN_TEST_CASE( MQTT_Unit_API, OperationCreateDestroy );
+    RUN_TEST_CASE( MQTT_Unit_API, OperationLimit );
     RUN_TEST_CASE( MQTT_Unit_API, OperationWaitTimeout );
     RUN_TEST_CASE( MQTT_Unit_API, ConnectParameters );
     RUN_TEST_CASE( MQTT_Unit_API, ConnectMallocFail );
@@ -565,6 +624,7 @@ TEST_GROUP_RUNNER( MQTT_Unit_API )
     RUN_TEST_CASE( MQTT_Unit_API, PublishQoS0MallocFail );
     RUN_TEST_CASE( MQTT_Unit_API, PublishQoS1 );
     RUN_TEST_CASE( MQTT_Unit_API, PublishDuplicates );
+    RUN_TEST_CASE( MQTT_Unit_API, PublishZeroCopy );
     RUN_TEST_CASE( MQTT_Unit_API, SubscribeUnsubscribeParameters );
     RUN_TEST_CASE( MQTT_Unit_API, SubscribeMallocFail );
     RUN_TEST_CASE( MQTT_Unit_API, UnsubscribeMallocFail );
@@ -634,6 +694,73 @@ TEST( MQTT_Unit_API, OperationCreateDestroy )
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Test that a connection has at most #IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS
+ * operations in progress.
+ */
+TEST( MQTT_Unit_API, OperationLimit )
+{
+    uint32_t i = 0;
+    _mqttOperation_t * pExtraOperation = NULL;
+    static _mqttOperation_t * pOperations[ IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS ] = { NULL };
+
+    #if IOT_STATIC_MEMORY_ONLY == 1
+        /* The static operation pool may run out before the limit. */
+        TEST_IGNORE();
+    #endif
+
+    /* Create a new MQTT connection. */
+    _pMqttConnection = IotTestMqtt_createMqttConnection( AWS_IOT_MQTT_SERVER,
+                                                         &_networkInfo,
+                                                         0 );
+    TEST_ASSERT_NOT_NULL( _pMqttConnection );
+
+    if( TEST_PROTECT() )
+    {
+        for( i = 0; i < IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS; i++ )
+        {
+            TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS, _IotMqtt_CreateOperation( _pMqttConnection,
+                                                                           0,
+                                                                           NULL,
+                                                                           &( pOperations[ i ] ) ) );
+        }
+
+        TEST_ASSERT_EQUAL_UINT32( IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS, _pMqttConnection->operationCount );
+
+        /* No more operations may be created at the limit. */
+        TEST_ASSERT_EQUAL( IOT_MQTT_NO_MEMORY, _IotMqtt_CreateOperation( _pMqttConnection,
+                                                                         0,
+                                                                         NULL,
+                                                                         &pExtraOperation ) );
+        TEST_ASSERT_NULL( pExtraOperation );
+        TEST_ASSERT_EQUAL_UINT32( IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS, _pMqttConnection->operationCount );
+
+        /* Destroying an operation allows another to be created. */
+        _IotMqtt_DestroyOperation( pOperations[ 0 ] );
+        pOperations[ 0 ] = NULL;
+
+        TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS, _IotMqtt_CreateOperation( _pMqttConnection,
+                                                                       0,
+                                                                       NULL,
+                                                                       &( pOperations[ 0 ] ) ) );
+    }
+
+    for( i = 0; i < IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS; i++ )
+    {
+        if( pOperations[ i ] != NULL )
+        {
+            _IotMqtt_DestroyOperation( pOperations[ i ] );
+            pOperations[ i ] = NULL;
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32( 0, _pMqttConnection->operationCount );
+
+    IotMqtt_Disconnect( _pMqttConnection, IOT_MQTT_FLAG_CLEANUP_ONLY );
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Test that an operation is correctly cleaned up if @ref mqtt_function_wait
  * times out while its job is executing.
@@ -1172,6 +1299,104 @@ TEST( MQTT_Unit_API, PublishDuplicates )
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Tests that a PUBLISH with #IOT_MQTT_FLAG_ZERO_COPY sends its payload
+ * without copying it into the PUBLISH packet.
+ */
+TEST( MQTT_Unit_API, PublishZeroCopy )
+{
+    IotMqttError_t status = IOT_MQTT_STATUS_PENDING;
+    IotMqttPublishInfo_t publishInfo = IOT_MQTT_PUBLISH_INFO_INITIALIZER;
+    IotMqttOperation_t publishOperation = IOT_MQTT_OPERATION_INITIALIZER;
+    bool zeroCopyResult = false;
+    char pLongTopicName[ IOT_MQTT_PUBLISH_HEADER_BUFFER_SIZE ] = { 0 };
+
+    ( void ) memset( pLongTopicName, 'a', sizeof( pLongTopicName ) );
+
+    /* Initialize parameters. */
+    _networkInterface.send = _sendSuccess;
+    _networkInterface.sendv = _sendvZeroCopy;
+
+    /* Create a new MQTT connection. */
+    _pMqttConnection = IotTestMqtt_createMqttConnection( AWS_IOT_MQTT_SERVER,
+                                                         &_networkInfo,
+                                                         0 );
+    TEST_ASSERT_NOT_NULL( _pMqttConnection );
+
+    /* Set the parameter to the send function. */
+    _pMqttConnection->pNetworkConnection = &zeroCopyResult;
+
+    /* Set the publish info. */
+    publishInfo.qos = IOT_MQTT_QOS_1;
+    publishInfo.pTopicName = TEST_TOPIC_NAME;
+    publishInfo.topicNameLength = TEST_TOPIC_NAME_LENGTH;
+    publishInfo.pPayload = ZERO_COPY_PAYLOAD;
+    publishInfo.payloadLength = sizeof( ZERO_COPY_PAYLOAD ) - 1;
+
+    if( TEST_PROTECT() )
+    {
+        /* A zero-copy PUBLISH must provide some notification of completion. */
+        status = IotMqtt_Publish( _pMqttConnection,
+                                  &publishInfo,
+                                  IOT_MQTT_FLAG_ZERO_COPY,
+                                  NULL,
+                                  &publishOperation );
+        TEST_ASSERT_EQUAL( IOT_MQTT_BAD_PARAMETER, status );
+
+        /* Send a zero-copy PUBLISH. No PUBACK is expected. */
+        status = IotMqtt_Publish( _pMqttConnection,
+                                  &publishInfo,
+                                  IOT_MQTT_FLAG_WAITABLE | IOT_MQTT_FLAG_ZERO_COPY,
+                                  NULL,
+                                  &publishOperation );
+        TEST_ASSERT_EQUAL( IOT_MQTT_STATUS_PENDING, status );
+        TEST_ASSERT_EQUAL( IOT_MQTT_TIMEOUT, IotMqtt_Wait( publishOperation, TIMEOUT_MS ) );
+
+        /* Check that the payload was sent in place. */
+        TEST_ASSERT_EQUAL_INT( true, zeroCopyResult );
+
+        /* A zero-copy QoS 0 PUBLISH is sent before IotMqtt_Publish returns. */
+        zeroCopyResult = false;
+        publishInfo.qos = IOT_MQTT_QOS_0;
+
+        status = IotMqtt_Publish( _pMqttConnection,
+                                  &publishInfo,
+                                  IOT_MQTT_FLAG_ZERO_COPY,
+                                  NULL,
+                                  NULL );
+        TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS, status );
+        TEST_ASSERT_EQUAL_INT( true, zeroCopyResult );
+
+        /* Headers that don't fit in the stack buffer are allocated. */
+        zeroCopyResult = false;
+        publishInfo.pTopicName = pLongTopicName;
+        publishInfo.topicNameLength = sizeof( pLongTopicName );
+
+        status = IotMqtt_Publish( _pMqttConnection,
+                                  &publishInfo,
+                                  IOT_MQTT_FLAG_ZERO_COPY,
+                                  NULL,
+                                  NULL );
+        TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS, status );
+        TEST_ASSERT_EQUAL_INT( true, zeroCopyResult );
+
+        /* A failed send is reported to the caller. */
+        _networkInterface.sendv = _sendvFail;
+
+        status = IotMqtt_Publish( _pMqttConnection,
+                                  &publishInfo,
+                                  IOT_MQTT_FLAG_ZERO_COPY,
+                                  NULL,
+                                  NULL );
+        TEST_ASSERT_EQUAL( IOT_MQTT_NETWORK_ERROR, status );
+    }
+
+    /* Clean up MQTT connection. */
+    IotMqtt_Disconnect( _pMqttConnection, IOT_MQTT_FLAG_CLEANUP_ONLY );
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Tests the behavior of @ref mqtt_function_subscribe and
  * @ref mqtt_function_unsubscribe with various invalid parameters.
@@ -38,6 +38,7 @@
 #include "iot_init.h"
 
 /* Platform layer includes. */
+#include "platform/iot_clock.h"
 #include "platform/iot_threads.h"
 
 /* MQTT internal include. */
@@ -107,6 +108,23 @@ static const uint8_t _pPingrespTemplate[] = { 0xd0, 0x00 };
  */
 #define PUBLISH_CALLBACK_TIMEOUT    ( 1000 )
 
+/**
+ * @brief The largest number of operations awaiting a response in the PUBACK
+ * latency test.
+ *
+ * A connection has at most #IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS operations in
+ * progress. Set it to 512 to measure all of the latency test's cases.
+ */
+#define TEST_MQTT_ACK_IN_FLIGHT_MAX    IOT_MQTT_MAX_IN_FLIGHT_OPERATIONS
+
+/**
+ * @brief The number of PUBACKs processed for each measurement of the PUBACK
+ * latency test.
+ */
+#ifndef TEST_MQTT_ACK_COUNT
+    #define TEST_MQTT_ACK_COUNT    ( 10240 )
+#endif
+
 /**
  * @brief Declare a buffer holding a packet and its size.
  */
@@ -292,7 +310,23 @@ static void _operationResetAndPush( _mqttOperation_t * pOperation )
 {
     pOperation->u.operation.status = IOT_MQTT_STATUS_PENDING;
     pOperation->u.operation.jobReference = 1;
-    IotListDouble_InsertHead( &( _pMqttConnection->pendingResponse ), &( pOperation->link ) );
+
+    IotMutex_Lock( &( _pMqttConnection->referencesMutex ) );
+    _IotMqtt_AddPendingResponse( pOperation );
+    IotMutex_Unlock( &( _pMqttConnection->referencesMutex ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Remove an #_mqttOperation_t that did not receive a response from the
+ * list of MQTT operations awaiting network response.
+ */
+static void _operationRemove( _mqttOperation_t * pOperation )
+{
+    IotMutex_Lock( &( _pMqttConnection->referencesMutex ) );
+    _IotMqtt_UnlinkOperation( pOperation );
+    IotMutex_Unlock( &( _pMqttConnection->referencesMutex ) );
 }
 
 /*-----------------------------------------------------------*/
@@ -609,6 +643,7 @@ TEST_GROUP_RUNNER( MQTT_Unit_Receive )
     RUN_TEST_CASE( MQTT_Unit_Receive, PublishInvalid );
     RUN_TEST_CASE( MQTT_Unit_Receive, PubackValid );
     RUN_TEST_CASE( MQTT_Unit_Receive, PubackInvalid );
+    RUN_TEST_CASE( MQTT_Unit_Receive, PubackLatency );
     RUN_TEST_CASE( MQTT_Unit_Receive, SubackValid );
     RUN_TEST_CASE( MQTT_Unit_Receive, SubackInvalid );
     RUN_TEST_CASE( MQTT_Unit_Receive, UnsubackValid );
@@ -1262,12 +1297,101 @@ TEST( MQTT_Unit_Receive, PubackInvalid )
     }
 
     /* Remove unprocessed PUBLISH if present. */
-    if( IotLink_IsLinked( &( publish.link ) ) == true )
+    _operationRemove( &publish );
+
+    IotSemaphore_Destroy( &( publish.u.operation.notify.waitSemaphore ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The operations awaiting a PUBACK in the PUBACK latency test.
+ */
+static _mqttOperation_t _pPublishesInFlight[ TEST_MQTT_ACK_IN_FLIGHT_MAX ];
+
+/**
+ * @brief Measure how long it takes to process a PUBACK with 1, 64, and 512
+ * PUBLISH operations awaiting a response, up to #TEST_MQTT_ACK_IN_FLIGHT_MAX.
+ *
+ * The time includes adding each PUBLISH to the operations awaiting a response.
+ * The PUBLISH operations are acknowledged oldest first, so that a search of
+ * the pending response list from its head must pass all newer operations.
+ */
+TEST( MQTT_Unit_Receive, PubackLatency )
+{
+    const uint32_t pInFlight[] = { 1, 64, 512 };
+    uint32_t i = 0, j = 0, round = 0, rounds = 0, inFlight = 0, lastInFlight = 0;
+    uint64_t startTime = 0, elapsedTime = 0;
+    const _mqttOperation_t publishTemplate = INITIALIZE_OPERATION( IOT_MQTT_PUBLISH_TO_SERVER );
+
+    for( i = 0; i < TEST_MQTT_ACK_IN_FLIGHT_MAX; i++ )
     {
-        IotDeQueue_Remove( &( publish.link ) );
+        _pPublishesInFlight[ i ] = publishTemplate;
+        _pPublishesInFlight[ i ].u.operation.packetIdentifier = ( uint16_t ) ( i + 1 );
+
+        /* Create the wait semaphore so notifications don't crash. The value of
+         * this semaphore will not be checked, so the maxValue argument is arbitrary. */
+        TEST_ASSERT_EQUAL_INT( true, IotSemaphore_Create( &( _pPublishesInFlight[ i ].u.operation.notify.waitSemaphore ),
+                                                          0,
+                                                          TEST_MQTT_ACK_COUNT ) );
     }
 
-    IotSemaphore_Destroy( &( publish.u.operation.notify.waitSemaphore ) );
+    for( i = 0; i < sizeof( pInFlight ) / sizeof( pInFlight[ 0 ] ); i++ )
+    {
+        /* Cases beyond the limit are measured at the limit, once. */
+        inFlight = pInFlight[ i ];
+
+        if( inFlight > TEST_MQTT_ACK_IN_FLIGHT_MAX )
+        {
+            inFlight = TEST_MQTT_ACK_IN_FLIGHT_MAX;
+        }
+
+        if( inFlight == lastInFlight )
+        {
+            continue;
+        }
+
+        lastInFlight = inFlight;
+        rounds = TEST_MQTT_ACK_COUNT / inFlight;
+        startTime = IotClock_GetTimeMs();
+
+        for( round = 0; round < rounds; round++ )
+        {
+            for( j = 0; j < inFlight; j++ )
+            {
+                _operationResetAndPush( &( _pPublishesInFlight[ j ] ) );
+            }
+
+            for( j = 0; j < inFlight; j++ )
+            {
+                DECLARE_PACKET( _pPubackTemplate, pPuback, pubackSize );
+                pPuback[ 2 ] = ( uint8_t ) ( _pPublishesInFlight[ j ].u.operation.packetIdentifier >> 8 );
+                pPuback[ 3 ] = ( uint8_t ) ( _pPublishesInFlight[ j ].u.operation.packetIdentifier & 0x00ff );
+
+                TEST_ASSERT_EQUAL_INT( true, _processBuffer( &( _pPublishesInFlight[ j ] ),
+                                                             pPuback,
+                                                             pubackSize,
+                                                             IOT_MQTT_SUCCESS ) );
+            }
+        }
+
+        elapsedTime = IotClock_GetTimeMs() - startTime;
+
+        UnityPrintNumber( ( UNITY_INT ) inFlight );
+        UnityPrint( " PUBLISH operation(s) in flight: " );
+        UnityPrintNumber( ( UNITY_INT ) ( ( elapsedTime * 1000000ULL ) / ( ( uint64_t ) rounds * inFlight ) ) );
+        UnityPrint( " ns per PUBLISH and PUBACK." );
+        UNITY_PRINT_EOL();
+    }
+
+    for( i = 0; i < TEST_MQTT_ACK_IN_FLIGHT_MAX; i++ )
+    {
+        IotSemaphore_Destroy( &( _pPublishesInFlight[ i ].u.operation.notify.waitSemaphore ) );
+    }
+
+    /* Network close function should not have been invoked. */
+    TEST_ASSERT_EQUAL_INT( false, _networkCloseCalled );
+    TEST_ASSERT_EQUAL_INT( false, _disconnectCallbackCalled );
 }
 
 /*-----------------------------------------------------------*/
@@ -1630,10 +1754,7 @@ TEST( MQTT_Unit_Receive, UnsubackInvalid )
     }
 
     /* Remove unprocessed UNSUBSCRIBE if present. */
-    if( IotLink_IsLinked( &( unsubscribe.link ) ) == true )
-    {
-        IotDeQueue_Remove( &( unsubscribe.link ) );
-    }
+    _operationRemove( &unsubscribe );
 
     IotSemaphore_Destroy( &( unsubscribe.u.operation.notify.waitSemaphore ) );
 }
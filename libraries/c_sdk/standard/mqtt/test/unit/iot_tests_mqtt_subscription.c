@@ -95,6 +95,22 @@
  */
 #define TOPIC_FILTER_MATCH_MAX_LENGTH    ( 32 )
 
+/**
+ * @brief Number of PUBLISH messages dispatched for each subscription count in
+ * #TEST_MQTT_Unit_Subscription_ProcessPublishThroughput_.
+ */
+#define THROUGHPUT_PUBLISH_COUNT         ( 10000 )
+
+/**
+ * @brief Format of the topic filters in #TEST_MQTT_Unit_Subscription_ProcessPublishThroughput_.
+ */
+#define THROUGHPUT_TOPIC_FILTER_FORMAT   ( "$aws/things/thing%lu/shadow/update/accepted" )
+
+/**
+ * @brief Maximum length of the topic filters in #TEST_MQTT_Unit_Subscription_ProcessPublishThroughput_.
+ */
+#define THROUGHPUT_TOPIC_FILTER_LENGTH   ( sizeof( THROUGHPUT_TOPIC_FILTER_FORMAT ) + 4 )
+
 /**
  * @brief Macro to check a single topic name against a topic filter.
  *
@@ -244,6 +260,22 @@ static void _publishCallback( void * pArgument,
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief A subscription callback function that counts its invocations.
+ */
+static void _countingCallback( void * pArgument,
+                               IotMqttCallbackParam_t * pPublish )
+{
+    uint32_t * pInvokeCount = ( uint32_t * ) pArgument;
+
+    /* Silence warnings about unused parameters. */
+    ( void ) pPublish;
+
+    ( *pInvokeCount )++;
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief A subscription callback function that blocks on a semaphore until signaled.
  */
@@ -326,8 +358,11 @@ TEST_GROUP_RUNNER( MQTT_Unit_Subscription )
     RUN_TEST_CASE( MQTT_Unit_Subscription, SubscriptionRemoveByTopicFilter );
     RUN_TEST_CASE( MQTT_Unit_Subscription, SubscriptionAddDuplicate );
     RUN_TEST_CASE( MQTT_Unit_Subscription, SubscriptionAddMallocFail );
+    RUN_TEST_CASE( MQTT_Unit_Subscription, SubscriptionAddUnindexed );
     RUN_TEST_CASE( MQTT_Unit_Subscription, ProcessPublish );
     RUN_TEST_CASE( MQTT_Unit_Subscription, ProcessPublishMultiple );
+    RUN_TEST_CASE( MQTT_Unit_Subscription, ProcessPublishIndex );
+    RUN_TEST_CASE( MQTT_Unit_Subscription, ProcessPublishThroughput );
     RUN_TEST_CASE( MQTT_Unit_Subscription, SubscriptionReferences );
     RUN_TEST_CASE( MQTT_Unit_Subscription, TopicFilterMatchTrue );
     RUN_TEST_CASE( MQTT_Unit_Subscription, TopicFilterMatchFalse );
@@ -674,6 +709,81 @@ TEST( MQTT_Unit_Subscription, SubscriptionAddMallocFail )
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Tests that a subscription is still added and found when there is no
+ * memory to add it to the subscription index.
+ */
+TEST( MQTT_Unit_Subscription, SubscriptionAddUnindexed )
+{
+    #if IOT_STATIC_MEMORY_ONLY == 1
+        TEST_IGNORE_MESSAGE( "This test requires dynamic memory allocation." );
+    #else
+        uint32_t invokeCount[ 2 ] = { 0 };
+        IotMqttSubscription_t subscription[ 2 ] = { IOT_MQTT_SUBSCRIPTION_INITIALIZER };
+        IotMqttCallbackParam_t callbackParam = { .u.message = { 0 } };
+
+        subscription[ 0 ].pTopicFilter = "a/b";
+        subscription[ 0 ].topicFilterLength = 3;
+        subscription[ 0 ].callback.function = _countingCallback;
+        subscription[ 0 ].callback.pCallbackContext = &( invokeCount[ 0 ] );
+
+        subscription[ 1 ].pTopicFilter = "a/+";
+        subscription[ 1 ].topicFilterLength = 3;
+        subscription[ 1 ].callback.function = _countingCallback;
+        subscription[ 1 ].callback.pCallbackContext = &( invokeCount[ 1 ] );
+
+        callbackParam.u.message.info.pTopicName = "a/b";
+        callbackParam.u.message.info.topicNameLength = 3;
+        callbackParam.u.message.info.pPayload = "";
+        callbackParam.u.message.info.payloadLength = 0;
+
+        /* Allow the subscription to be allocated, but not its index nodes. */
+        UnityMalloc_MakeMallocFailAfterCount( 1 );
+
+        TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS,
+                           _IotMqtt_AddSubscriptions( _pMqttConnection,
+                                                      1,
+                                                      &( subscription[ 0 ] ),
+                                                      1 ) );
+
+        UnityMalloc_MakeMallocFailAfterCount( -1 );
+
+        TEST_ASSERT_EQUAL_UINT32( 1, _pMqttConnection->unindexedSubscriptions );
+        TEST_ASSERT_EQUAL_UINT16( 0, _pMqttConnection->topicIndexRoot.childCount );
+        TEST_ASSERT_EQUAL_INT( true, IotMqtt_IsSubscribed( _pMqttConnection, "a/b", 3, NULL ) );
+
+        /* Adding the same topic filter again replaces the unindexed subscription. */
+        TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS,
+                           _IotMqtt_AddSubscriptions( _pMqttConnection,
+                                                      2,
+                                                      subscription,
+                                                      2 ) );
+        TEST_ASSERT_EQUAL_UINT32( 1, _pMqttConnection->unindexedSubscriptions );
+
+        /* Both the unindexed and the indexed subscription should be invoked. */
+        TEST_ASSERT_EQUAL_INT( true, _IotMqtt_IncrementConnectionReferences( _pMqttConnection ) );
+        _IotMqtt_InvokeSubscriptionCallback( _pMqttConnection,
+                                             &callbackParam );
+        TEST_ASSERT_EQUAL_UINT32( 1, invokeCount[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT32( 1, invokeCount[ 1 ] );
+
+        /* Once the unindexed subscription is removed, the index is used again. */
+        _IotMqtt_RemoveSubscriptionByTopicFilter( _pMqttConnection,
+                                                  &( subscription[ 0 ] ),
+                                                  1 );
+        TEST_ASSERT_EQUAL_UINT32( 0, _pMqttConnection->unindexedSubscriptions );
+        TEST_ASSERT_EQUAL_INT( false, IotMqtt_IsSubscribed( _pMqttConnection, "a/b", 3, NULL ) );
+
+        TEST_ASSERT_EQUAL_INT( true, _IotMqtt_IncrementConnectionReferences( _pMqttConnection ) );
+        _IotMqtt_InvokeSubscriptionCallback( _pMqttConnection,
+                                             &callbackParam );
+        TEST_ASSERT_EQUAL_UINT32( 1, invokeCount[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT32( 2, invokeCount[ 1 ] );
+    #endif /* if IOT_STATIC_MEMORY_ONLY == 1 */
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Tests invoking subscription callbacks with PUBLISH messages.
  */
@@ -768,6 +878,158 @@ TEST( MQTT_Unit_Subscription, ProcessPublishMultiple )
 
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Tests that the subscription index finds exactly the subscriptions
+ * matching a topic name, and that it is emptied when subscriptions are removed.
+ */
+TEST( MQTT_Unit_Subscription, ProcessPublishIndex )
+{
+    size_t i = 0;
+    uint32_t invokeCount[ 8 ] = { 0 };
+    IotMqttSubscription_t subscription[ 8 ] = { IOT_MQTT_SUBSCRIPTION_INITIALIZER };
+    IotMqttCallbackParam_t callbackParam = { .u.message = { 0 } };
+
+    /* The first 5 topic filters match "aws/iot/shadow"; the rest do not. */
+    const char * const pTopicFilters[ 8 ] =
+    {
+        "aws/iot/shadow", "aws/+/shadow", "aws/#", "#", "+/iot/+",
+        "aws/iot",        "aws/+/thing",  "+/iot/shadow/+"
+    };
+
+    for( i = 0; i < 8; i++ )
+    {
+        subscription[ i ].pTopicFilter = pTopicFilters[ i ];
+        subscription[ i ].topicFilterLength = ( uint16_t ) strlen( pTopicFilters[ i ] );
+        subscription[ i ].callback.function = _countingCallback;
+        subscription[ i ].callback.pCallbackContext = &( invokeCount[ i ] );
+    }
+
+    callbackParam.u.message.info.pTopicName = "aws/iot/shadow";
+    callbackParam.u.message.info.topicNameLength = 14;
+    callbackParam.u.message.info.pPayload = "";
+    callbackParam.u.message.info.payloadLength = 0;
+
+    TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS,
+                       _IotMqtt_AddSubscriptions( _pMqttConnection,
+                                                  1,
+                                                  subscription,
+                                                  8 ) );
+
+    /* Increment connection reference count for processing subscription callbacks. */
+    TEST_ASSERT_EQUAL_INT( true, _IotMqtt_IncrementConnectionReferences( _pMqttConnection ) );
+
+    _IotMqtt_InvokeSubscriptionCallback( _pMqttConnection,
+                                         &callbackParam );
+
+    /* Each matching callback should be invoked exactly once. */
+    for( i = 0; i < 8; i++ )
+    {
+        TEST_ASSERT_EQUAL_UINT32( ( i < 5 ) ? 1 : 0, invokeCount[ i ] );
+    }
+
+    /* Removing all subscriptions should remove all index nodes. */
+    _IotMqtt_RemoveSubscriptionByTopicFilter( _pMqttConnection,
+                                              subscription,
+                                              8 );
+    TEST_ASSERT_EQUAL_INT( true, IotListDouble_IsEmpty( &( _pMqttConnection->subscriptionList ) ) );
+    TEST_ASSERT_EQUAL_UINT16( 0, _pMqttConnection->topicIndexRoot.childCount );
+
+    for( i = 0; i < IOT_MQTT_SUBSCRIPTION_INDEX_BUCKETS; i++ )
+    {
+        TEST_ASSERT_NULL( _pMqttConnection->pTopicIndex[ i ] );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Measures the rate at which PUBLISH messages are dispatched to
+ * subscription callbacks with 10, 100, and 1000 subscriptions.
+ */
+TEST( MQTT_Unit_Subscription, ProcessPublishThroughput )
+{
+    #if IOT_STATIC_MEMORY_ONLY == 1
+        TEST_IGNORE_MESSAGE( "This test requires dynamic memory allocation." );
+    #else
+        size_t i = 0, subscriptionCount = 0, publishCount = 0;
+        uint32_t invokeCount = 0;
+        uint64_t startTime = 0, elapsedMs = 0;
+        char pTopicName[ THROUGHPUT_TOPIC_FILTER_LENGTH ] = { 0 };
+        char ( * pTopicFilters )[ THROUGHPUT_TOPIC_FILTER_LENGTH ] = NULL;
+        IotMqttSubscription_t * pSubscriptions = NULL;
+        IotMqttCallbackParam_t callbackParam = { .u.message = { 0 } };
+
+        pTopicFilters = IotTest_Malloc( 1000 * THROUGHPUT_TOPIC_FILTER_LENGTH );
+        TEST_ASSERT_NOT_NULL( pTopicFilters );
+        pSubscriptions = IotTest_Malloc( 1000 * sizeof( IotMqttSubscription_t ) );
+        TEST_ASSERT_NOT_NULL( pSubscriptions );
+
+        if( TEST_PROTECT() )
+        {
+            for( subscriptionCount = 10; subscriptionCount <= 1000; subscriptionCount *= 10 )
+            {
+                /* Subscribe to the shadow topics of many things. */
+                for( i = 0; i < subscriptionCount; i++ )
+                {
+                    pSubscriptions[ i ].qos = IOT_MQTT_QOS_0;
+                    pSubscriptions[ i ].pTopicFilter = pTopicFilters[ i ];
+                    pSubscriptions[ i ].topicFilterLength = ( uint16_t ) snprintf( pTopicFilters[ i ],
+                                                                                   THROUGHPUT_TOPIC_FILTER_LENGTH,
+                                                                                   THROUGHPUT_TOPIC_FILTER_FORMAT,
+                                                                                   ( unsigned long ) i );
+                    pSubscriptions[ i ].callback.function = _countingCallback;
+                    pSubscriptions[ i ].callback.pCallbackContext = &invokeCount;
+                }
+
+                TEST_ASSERT_EQUAL( IOT_MQTT_SUCCESS,
+                                   _IotMqtt_AddSubscriptions( _pMqttConnection,
+                                                              1,
+                                                              pSubscriptions,
+                                                              subscriptionCount ) );
+
+                /* Publish to the topic of the last thing. */
+                callbackParam.u.message.info.pTopicName = pTopicName;
+                callbackParam.u.message.info.topicNameLength = ( uint16_t ) snprintf( pTopicName,
+                                                                                      THROUGHPUT_TOPIC_FILTER_LENGTH,
+                                                                                      THROUGHPUT_TOPIC_FILTER_FORMAT,
+                                                                                      ( unsigned long ) ( subscriptionCount - 1 ) );
+                callbackParam.u.message.info.pPayload = "";
+                callbackParam.u.message.info.payloadLength = 0;
+
+                invokeCount = 0;
+                startTime = IotClock_GetTimeMs();
+
+                for( publishCount = 0; publishCount < THROUGHPUT_PUBLISH_COUNT; publishCount++ )
+                {
+                    TEST_ASSERT_EQUAL_INT( true, _IotMqtt_IncrementConnectionReferences( _pMqttConnection ) );
+                    _IotMqtt_InvokeSubscriptionCallback( _pMqttConnection,
+                                                         &callbackParam );
+                }
+
+                elapsedMs = IotClock_GetTimeMs() - startTime;
+                TEST_ASSERT_EQUAL_UINT32( THROUGHPUT_PUBLISH_COUNT, invokeCount );
+
+                UnityPrint( "ProcessPublishThroughput " );
+                UnityPrintNumber( ( UNITY_INT ) subscriptionCount );
+                UnityPrint( " subscriptions: " );
+                UnityPrintNumber( ( UNITY_INT ) ( ( THROUGHPUT_PUBLISH_COUNT * 1000ULL ) /
+                                                  ( ( elapsedMs > 0 ) ? elapsedMs : 1 ) ) );
+                UnityPrint( " messages/sec." );
+                UNITY_PRINT_EOL();
+
+                _IotMqtt_RemoveSubscriptionByTopicFilter( _pMqttConnection,
+                                                          pSubscriptions,
+                                                          subscriptionCount );
+            }
+        }
+
+        IotTest_Free( pSubscriptions );
+        IotTest_Free( pTopicFilters );
+    #endif /* if IOT_STATIC_MEMORY_ONLY == 1 */
+}
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Tests that subscriptions are properly reference counted.
  */
@@ -910,6 +1172,8 @@ TEST( MQTT_Unit_Subscription, TopicFilterMatchTrue )
         TEST_TOPIC_MATCH( "aws//iot", "aws/+/iot", false, true );
         TEST_TOPIC_MATCH( "aws//iot", "aws//+", false, true );
         TEST_TOPIC_MATCH( "aws///iot", "aws/+/+/iot", false, true );
+        TEST_TOPIC_MATCH( "/a", "/+", false, true );
+        TEST_TOPIC_MATCH( "a/b/c", "a/+/c", false, true );
 
         /* Multi level wildcard matching. */
         TEST_TOPIC_MATCH( "/aws/iot/shadow", "#", false, true );
@@ -958,6 +1222,8 @@ TEST( MQTT_Unit_Subscription, TopicFilterMatchFalse )
         TEST_TOPIC_MATCH( "aws/iot/shadow", "aws/+", false, false );
         TEST_TOPIC_MATCH( "aws/iot/shadow", "aws/+/thing", false, false );
         TEST_TOPIC_MATCH( "/aws", "+", false, false );
+        TEST_TOPIC_MATCH( "a/b/c", "a/+/d", false, false );
+        TEST_TOPIC_MATCH( "a/b", "a/+", true, false );
 
         /* Multi level wildcard matching. */
         TEST_TOPIC_MATCH( "aws/iot/shadow", "iot/#", false, false );
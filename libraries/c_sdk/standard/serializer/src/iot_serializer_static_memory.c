@@ -90,16 +90,16 @@
 /*
  * Static memory buffers and flags, allocated and zeroed at compile-time.
  */
-    static bool _inUseCborEncoders[ IOT_SERIALIZER_CBOR_ENCODERS ] = { 0 };
+    static uint32_t _inUseCborEncoders[ IOT_STATIC_MEMORY_BITMAP_SIZE( IOT_SERIALIZER_CBOR_ENCODERS ) ] = { 0 };
     static CborEncoder _cborEncoders[ IOT_SERIALIZER_CBOR_ENCODERS ] = { { .data = { 0 } } };
 
-    static bool _inUseCborParsers[ IOT_SERIALIZER_CBOR_PARSERS ] = { 0 };
+    static uint32_t _inUseCborParsers[ IOT_STATIC_MEMORY_BITMAP_SIZE( IOT_SERIALIZER_CBOR_PARSERS ) ] = { 0 };
     static CborParser _cborParsers[ IOT_SERIALIZER_CBOR_PARSERS ] = { { 0 } };
 
-    static bool _inUseCborValues[ IOT_SERIALIZER_CBOR_VALUES ] = { 0 };
+    static uint32_t _inUseCborValues[ IOT_STATIC_MEMORY_BITMAP_SIZE( IOT_SERIALIZER_CBOR_VALUES ) ] = { 0 };
     static _cborValueWrapper_t _cborValues[ IOT_SERIALIZER_CBOR_VALUES ] = { { .isOutermost = false } };
 
-    static bool _inUseDecoderObjects[ IOT_SERIALIZER_DECODER_OBJECTS ] = { 0 };
+    static uint32_t _inUseDecoderObjects[ IOT_STATIC_MEMORY_BITMAP_SIZE( IOT_SERIALIZER_DECODER_OBJECTS ) ] = { 0 };
     static IotSerializerDecoderObject_t _decoderObjects[ IOT_SERIALIZER_DECODER_OBJECTS ] = { { 0 } };
 
 /*-----------------------------------------------------------*/
@@ -111,8 +111,8 @@
 
         if( size == sizeof( CborEncoder ) )
         {
-            freeIndex = IotStaticMemory_FindFree( _inUseCborEncoders,
-                                                  IOT_SERIALIZER_CBOR_ENCODERS );
+            freeIndex = IotStaticMemory_FindFreeBit( _inUseCborEncoders,
+                                                     IOT_SERIALIZER_CBOR_ENCODERS );
 
             if( freeIndex != -1 )
             {
@@ -127,11 +127,11 @@
 
     void IotSerializer_FreeCborEncoder( void * ptr )
     {
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _cborEncoders,
-                                     _inUseCborEncoders,
-                                     IOT_SERIALIZER_CBOR_ENCODERS,
-                                     sizeof( CborEncoder ) );
+        ( void ) IotStaticMemory_ReturnBit( ptr,
+                                            _cborEncoders,
+                                            _inUseCborEncoders,
+                                            IOT_SERIALIZER_CBOR_ENCODERS,
+                                            sizeof( CborEncoder ) );
     }
 
 /*-----------------------------------------------------------*/
@@ -143,8 +143,8 @@
 
         if( size == sizeof( CborParser ) )
         {
-            freeIndex = IotStaticMemory_FindFree( _inUseCborParsers,
-                                                  IOT_SERIALIZER_CBOR_PARSERS );
+            freeIndex = IotStaticMemory_FindFreeBit( _inUseCborParsers,
+                                                     IOT_SERIALIZER_CBOR_PARSERS );
 
             if( freeIndex != -1 )
             {
@@ -159,11 +159,11 @@
 
     void IotSerializer_FreeCborParser( void * ptr )
     {
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _cborParsers,
-                                     _inUseCborParsers,
-                                     IOT_SERIALIZER_CBOR_PARSERS,
-                                     sizeof( CborParser ) );
+        ( void ) IotStaticMemory_ReturnBit( ptr,
+                                            _cborParsers,
+                                            _inUseCborParsers,
+                                            IOT_SERIALIZER_CBOR_PARSERS,
+                                            sizeof( CborParser ) );
     }
 
 /*-----------------------------------------------------------*/
@@ -175,8 +175,8 @@
 
         if( size == sizeof( _cborValueWrapper_t ) )
         {
-            freeIndex = IotStaticMemory_FindFree( _inUseCborValues,
-                                                  IOT_SERIALIZER_CBOR_VALUES );
+            freeIndex = IotStaticMemory_FindFreeBit( _inUseCborValues,
+                                                     IOT_SERIALIZER_CBOR_VALUES );
 
             if( freeIndex != -1 )
             {
@@ -191,11 +191,11 @@
 
     void IotSerializer_FreeCborValue( void * ptr )
     {
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _cborValues,
-                                     _inUseCborValues,
-                                     IOT_SERIALIZER_CBOR_VALUES,
-                                     sizeof( _cborValueWrapper_t ) );
+        ( void ) IotStaticMemory_ReturnBit( ptr,
+                                            _cborValues,
+                                            _inUseCborValues,
+                                            IOT_SERIALIZER_CBOR_VALUES,
+                                            sizeof( _cborValueWrapper_t ) );
     }
 
 /*-----------------------------------------------------------*/
@@ -207,8 +207,8 @@
 
         if( size == sizeof( IotSerializerDecoderObject_t ) )
         {
-            freeIndex = IotStaticMemory_FindFree( _inUseDecoderObjects,
-                                                  IOT_SERIALIZER_DECODER_OBJECTS );
+            freeIndex = IotStaticMemory_FindFreeBit( _inUseDecoderObjects,
+                                                     IOT_SERIALIZER_DECODER_OBJECTS );
 
             if( freeIndex != -1 )
             {
@@ -223,11 +223,11 @@
 
     void IotSerializer_FreeDecoderObject( void * ptr )
     {
-        IotStaticMemory_ReturnInUse( ptr,
-                                     _decoderObjects,
-                                     _inUseDecoderObjects,
-                                     IOT_SERIALIZER_DECODER_OBJECTS,
-                                     sizeof( IotSerializerDecoderObject_t ) );
+        ( void ) IotStaticMemory_ReturnBit( ptr,
+                                            _decoderObjects,
+                                            _inUseDecoderObjects,
+                                            IOT_SERIALIZER_DECODER_OBJECTS,
+                                            sizeof( IotSerializerDecoderObject_t ) );
     }
 
 #endif /* if IOT_STATIC_MEMORY_ONLY == 1 */
@@ -295,7 +295,10 @@ static OTA_AgentContext_t xOTA_Agent =
     .ulNumOfBlocksToReceive        = 1,
     .xStatistics                   = { 0 },
     .xOTA_ThreadSafetyMutex        = NULL,
-    .ulRequestMomentum             = 0
+    .xOTA_BufferFreeSemaphore      = NULL,
+    .ulBufferWaiters               = 0,
+    .ulRequestMomentum             = 0,
+    .ulNumOfDuplicateBlocks        = 0
 };
 
 OTAStateTableEntry_t OTATransitionTable[] =
@@ -1157,6 +1160,9 @@ void prvOTAEventBufferFree( OTA_EventData_t * const pxBuffer )
     {
         pxBuffer->bBufferUsed = false;
         xSemaphoreGive( xOTA_Agent.xOTA_ThreadSafetyMutex );
+
+        /* Wake a data transfer callback waiting for a buffer. */
+        ( void ) xSemaphoreGive( xOTA_Agent.xOTA_BufferFreeSemaphore );
     }
     else
     {
@@ -1192,6 +1198,38 @@ OTA_EventData_t * prvOTAEventBufferGet( void )
     return pxOTAFreeMsg;
 }
 
+OTA_EventData_t * prvOTAEventBufferWait( TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+    OTA_EventData_t * pxOTAFreeMsg = prvOTAEventBufferGet();
+
+    /* Counted so that the agent does not delete the semaphore while it is waited on. */
+    taskENTER_CRITICAL();
+    xOTA_Agent.ulBufferWaiters++;
+    taskEXIT_CRITICAL();
+
+    vTaskSetTimeOutState( &xTimeOut );
+
+    /* The semaphore is given for every buffer freed, but another task may take the buffer first,
+     * so try again after each one until the wait times out. */
+    while( ( pxOTAFreeMsg == NULL ) &&
+           ( xOTA_Agent.eState != eOTA_AgentState_Stopped ) &&
+           ( xOTA_Agent.eState != eOTA_AgentState_ShuttingDown ) &&
+           ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE ) )
+    {
+        if( xSemaphoreTake( xOTA_Agent.xOTA_BufferFreeSemaphore, xTicksToWait ) == pdTRUE )
+        {
+            pxOTAFreeMsg = prvOTAEventBufferGet();
+        }
+    }
+
+    taskENTER_CRITICAL();
+    xOTA_Agent.ulBufferWaiters--;
+    taskEXIT_CRITICAL();
+
+    return pxOTAFreeMsg;
+}
+
 static void prvOTA_FreeContext( OTA_FileContext_t * const C )
 {
     if( C != NULL )
@@ -2173,6 +2211,7 @@ static IngestResult_t prvIngestDataBlock( OTA_FileContext_t * C,
                                         C->ulBlocksRemaining );
                             eIngestResult = eIngest_Result_Duplicate_Continue;
                             *pxCloseResult = kOTA_Err_None; /* This is a success path. */
+                            xOTA_Agent.ulNumOfDuplicateBlocks++;
                         }
                         else /* Otherwise, process it normally... */
                         {
@@ -2283,6 +2322,12 @@ static void prvAgentShutdownCleanup( void )
 
     xOTA_Agent.eState = eOTA_AgentState_ShuttingDown;
 
+    /* Wake a data transfer callback waiting for a buffer, so that it sees the agent is stopping. */
+    if( xOTA_Agent.xOTA_BufferFreeSemaphore != NULL )
+    {
+        ( void ) xSemaphoreGive( xOTA_Agent.xOTA_BufferFreeSemaphore );
+    }
+
     /*
      * Stop and delete any existing self test timer.
      */
@@ -2309,6 +2354,17 @@ static void prvAgentShutdownCleanup( void )
         xOTA_DataInterface.prvCleanup( &xOTA_Agent );
     }
 
+    /* Wake the callbacks still waiting for a buffer until they have all returned, so that none of
+     * them uses the buffer free semaphore or the thread safety mutex after they are deleted. */
+    if( xOTA_Agent.xOTA_BufferFreeSemaphore != NULL )
+    {
+        while( xOTA_Agent.ulBufferWaiters > 0U )
+        {
+            ( void ) xSemaphoreGive( xOTA_Agent.xOTA_BufferFreeSemaphore );
+            vTaskDelay( 1 );
+        }
+    }
+
     /*
      * Close any open OTA transfers.
      */
@@ -2345,6 +2401,12 @@ static void prvAgentShutdownCleanup( void )
     {
         vSemaphoreDelete( xOTA_Agent.xOTA_ThreadSafetyMutex );
     }
+
+    if( xOTA_Agent.xOTA_BufferFreeSemaphore != NULL )
+    {
+        vSemaphoreDelete( xOTA_Agent.xOTA_BufferFreeSemaphore );
+        xOTA_Agent.xOTA_BufferFreeSemaphore = NULL;
+    }
 }
 
 static void prvOTAAgentTask( void * pUnused )
@@ -2660,6 +2722,12 @@ OTA_State_t OTA_AgentInit_internal( void * pvConnectionContext,
             xOTA_Agent.xOTA_ThreadSafetyMutex = xSemaphoreCreateMutex();
             configASSERT( xOTA_Agent.xOTA_ThreadSafetyMutex );
 
+            /*
+             * Create the semaphore given each time a data buffer is freed.
+             */
+            xOTA_Agent.xOTA_BufferFreeSemaphore = xSemaphoreCreateBinary();
+            configASSERT( xOTA_Agent.xOTA_BufferFreeSemaphore );
+
             /*
              * Initialize all file paths to NULL.
              */
@@ -261,7 +261,10 @@ typedef struct ota_agent_context
     uint32_t ulNumOfBlocksToReceive;                        /* Number of data blocks to receive per data request. */
     OTA_AgentStatistics_t xStatistics;                      /* The OTA agent statistics block. */
     SemaphoreHandle_t xOTA_ThreadSafetyMutex;               /* Mutex used to ensure thread safety while managing data buffers. */
+    SemaphoreHandle_t xOTA_BufferFreeSemaphore;             /* Semaphore given each time a data buffer is freed. */
+    volatile uint32_t ulBufferWaiters;                      /* The number of data transfer callbacks waiting on xOTA_BufferFreeSemaphore. */
     uint32_t ulRequestMomentum;                             /* The number of requests sent before a response was received. */
+    uint32_t ulNumOfDuplicateBlocks;                        /* The number of duplicate data blocks received. */
 } OTA_AgentContext_t;
 
 /* The OTA Agent event and data structures. */
@@ -284,6 +287,12 @@ typedef struct
  */
 OTA_EventData_t * prvOTAEventBufferGet( void );
 
+/*
+ * Get buffer available from static pool of OTA buffers, waiting up to xTicksToWait for one
+ * to be freed if none is available. Returns NULL on timeout or if the OTA agent is stopping.
+ */
+OTA_EventData_t * prvOTAEventBufferWait( TickType_t xTicksToWait );
+
 /*
  * Free OTA buffer.
  */
@@ -98,22 +98,41 @@
     "R9I4LtD+gdwyah617jzV/OeBHRnDJELqYzmp\n"                             \
     "-----END CERTIFICATE-----\n"
 
-/* Buffer size for HTTP connection context. This is the minimum size from HTTP library, we cannot
- * use it directly because it's only available at runtime. */
-#define HTTPS_CONNECTION_USER_BUFFER_SIZE       256
-
-/* Buffer size for HTTP request context and header.*/
-#define HTTPS_REQUEST_USER_BUFFER_SIZE          2048
-
 /* Buffer size for HTTP response context and header.*/
 #define HTTPS_RESPONSE_USER_BUFFER_SIZE         1024
 
 /* Buffer size for HTTP response body.*/
 #define HTTPS_RESPONSE_BODY_BUFFER_SIZE         OTA_FILE_BLOCK_SIZE
 
+/* Buffer size for HTTP connection context. This is the minimum size from HTTP library, we cannot
+ * use it directly because it's only available at runtime. When requests are pipelined, the rest of
+ * the buffer keeps the bytes of the next response read together with the end of the current one,
+ * which can be as many as fit in the response header or body buffer. */
+#if ( otaconfigHTTP_MAX_RANGES_IN_FLIGHT > 1U )
+    #define HTTPS_CONNECTION_USER_BUFFER_SIZE                                                              \
+    ( 256 + ( ( HTTPS_RESPONSE_BODY_BUFFER_SIZE > HTTPS_RESPONSE_USER_BUFFER_SIZE ) ?                      \
+              HTTPS_RESPONSE_BODY_BUFFER_SIZE : HTTPS_RESPONSE_USER_BUFFER_SIZE ) )
+#else
+    #define HTTPS_CONNECTION_USER_BUFFER_SIZE    256
+#endif
+
+/* Time after which the idle connection kept in the connection pool is connected again instead of being used, as the
+ * server may have closed it in the meantime. */
+#define HTTPS_CONNECTION_IDLE_TIMEOUT_MS        20000
+
+/* Buffer size for HTTP request context and header.*/
+#define HTTPS_REQUEST_USER_BUFFER_SIZE          2048
+
 /* Default timeout for HTTP synchronous request. */
 #define HTTP_SYNC_TIMEOUT                       3000
 
+/* Maximum time to wait for a free OTA data buffer before dropping a received file block. Waiting
+ * keeps the download from running ahead of the OTA agent. */
+#define HTTP_EVENT_BUFFER_WAIT_MS               HTTP_SYNC_TIMEOUT
+
+/* Size of the block index put in front of the file block data passed to the OTA agent. */
+#define HTTP_BLOCK_HEADER_SIZE                  sizeof( uint32_t )
+
 /**
  * The maximum length of the "Range" field in HTTP header.
  *
@@ -131,17 +150,12 @@
  */
 #define HTTP_HEADER_CONNECTION_VALUE_MAX_LEN    ( sizeof( "keep-alive" ) )
 
-/* Struct for HTTP callback data. */
-typedef struct _httpCallbackData
-{
-    char pRangeValueStr[ HTTP_HEADER_RANGE_VALUE_MAX_LEN ]; /* Buffer to write the HTTP "range" header value string. */
-} _httpCallbackData_t;
-
 /* Struct for HTTP connection configuration and handle. */
 typedef struct _httpConnection
 {
     IotHttpsConnectionInfo_t connectionConfig;   /* Configurations for the HTTPS connection. */
     IotHttpsConnectionHandle_t connectionHandle; /* Handle identifying the HTTPS connection. */
+    IotHttpsConnectionPoolHandle_t poolHandle;   /* Handle identifying the pool the connection is acquired from. */
 } _httpConnection_t;
 
 /* Struct for HTTP request configuration and handle. */
@@ -186,29 +200,48 @@ typedef enum
     OTA_HTTP_PROCESSING_RESPONSE
 } _httpState;
 
-/* Struct for OTA HTTP downloader. */
-typedef struct _httpDownloader
+/* Struct for HTTP callback data, one for each range request. */
+typedef struct _httpCallbackData
+{
+    char pRangeValueStr[ HTTP_HEADER_RANGE_VALUE_MAX_LEN ]; /* Buffer to write the HTTP "range" header value string. */
+    _httpErr err;                                           /* Error status of this range request. */
+    uint32_t firstBlock;                                    /* First file block of the requested range. */
+    uint32_t numBlocks;                                     /* Number of file blocks in the requested range. */
+    uint32_t rangeSize;                                     /* Size of the requested range in bytes. */
+    uint32_t currBlock;                                     /* File block being read into the response body buffer. */
+    uint32_t currBlockLen;                                  /* Number of bytes of currBlock read so far. */
+} _httpCallbackData_t;
+
+/* Struct for one HTTP range request that can be in flight on the connection. */
+typedef struct _httpRange
 {
-    OTA_AgentContext_t * pAgentCtx;       /* OTA agent context. */
-    _httpState state;                     /* HTTP downloader state. */
-    _httpErr err;                         /* HTTP downloader error status. */
-    _httpUrlInfo_t httpUrlInfo;           /* HTTP url of the file to download. */
-    _httpConnection_t httpConnection;     /* HTTP connection data. */
     _httpRequest_t httpRequest;           /* HTTP request data. */
     _httpResponse_t httpResponse;         /* HTTP response data. */
     _httpCallbackData_t httpCallbackData; /* Data used in the HTTP callback. */
-    uint32_t currBlock;                   /* Current requesting block in bitmap. */
-    uint32_t currBlockSize;               /* Size of current requesting block. */
+} _httpRange_t;
+
+/* Struct for OTA HTTP downloader. */
+typedef struct _httpDownloader
+{
+    OTA_AgentContext_t * pAgentCtx;                                /* OTA agent context. */
+    _httpState state;                                              /* HTTP downloader state. */
+    _httpErr err;                                                  /* HTTP downloader error status. */
+    _httpUrlInfo_t httpUrlInfo;                                    /* HTTP url of the file to download. */
+    _httpConnection_t httpConnection;                              /* HTTP connection data. */
+    _httpRange_t httpRanges[ otaconfigHTTP_MAX_RANGES_IN_FLIGHT ]; /* HTTP range requests. */
+    uint32_t rangesInFlight;                                       /* Number of range requests that have not completed. */
+    bool blocksMissed;                                             /* Set when a range request completed without all of its blocks. */
+    uint32_t currBlock;                                            /* Block in bitmap to start looking for the next range from. */
 } _httpDownloader_t;
 
 /* Global HTTP downloader instance. */
 static _httpDownloader_t _httpDownloader = { 0 };
 
 /* Buffers for HTTP library. */
-uint8_t * pConnectionUserBuffer = NULL; /* Buffer to store the HTTP connection context. */
-uint8_t * pRequestUserBuffer = NULL;    /* Buffer to store the HTTP request context and header. */
-uint8_t * pResponseUserBuffer = NULL;   /* Buffer to store the HTTP response context and header. */
-uint8_t * pResponseBodyBuffer = NULL;   /* Buffer to store the HTTP response body. */
+uint8_t * pConnectionPoolUserBuffer = NULL; /* Buffer to store the HTTP connection pool and its connection context. */
+uint8_t * pRequestUserBuffer = NULL;        /* Buffers to store the HTTP request context and header of each range request. */
+uint8_t * pResponseUserBuffer = NULL;       /* Buffers to store the HTTP response context and header of each range request. */
+uint8_t * pResponseBodyBuffer = NULL;       /* Buffer to store the HTTP response body. */
 
 /* We need to use this function defined in iot_logging_task_dynamic_buffers.c to print HTTP message
  * without appending the task name and tick count. */
@@ -221,15 +254,18 @@ static bool _httpAllocateBuffers()
 {
     bool isSuccess = true;
 
-    pConnectionUserBuffer = pvPortMalloc( HTTPS_CONNECTION_USER_BUFFER_SIZE );
+    /* The pool holds a single connection. The sizes of the pool contexts are only available at runtime. */
+    pConnectionPoolUserBuffer = pvPortMalloc( connectionPoolUserBufferMinimumSize +
+                                              connectionPoolUserBufferSizePerConnection +
+                                              HTTPS_CONNECTION_USER_BUFFER_SIZE );
 
-    if( pConnectionUserBuffer == NULL )
+    if( pConnectionPoolUserBuffer == NULL )
     {
-        IotLogError( "Failed to allocate memory for HTTP connection user buffer." );
+        IotLogError( "Failed to allocate memory for HTTP connection pool user buffer." );
         isSuccess = false;
     }
 
-    pRequestUserBuffer = pvPortMalloc( HTTPS_REQUEST_USER_BUFFER_SIZE );
+    pRequestUserBuffer = pvPortMalloc( HTTPS_REQUEST_USER_BUFFER_SIZE * otaconfigHTTP_MAX_RANGES_IN_FLIGHT );
 
     if( isSuccess && ( pRequestUserBuffer == NULL ) )
     {
@@ -237,7 +273,7 @@ static bool _httpAllocateBuffers()
         isSuccess = false;
     }
 
-    pResponseUserBuffer = pvPortMalloc( HTTPS_RESPONSE_USER_BUFFER_SIZE );
+    pResponseUserBuffer = pvPortMalloc( HTTPS_RESPONSE_USER_BUFFER_SIZE * otaconfigHTTP_MAX_RANGES_IN_FLIGHT );
 
     if( isSuccess && ( pResponseUserBuffer == NULL ) )
     {
@@ -277,16 +313,83 @@ static void _httpFreeBuffers()
         pRequestUserBuffer = NULL;
     }
 
-    if( pConnectionUserBuffer )
+    if( pConnectionPoolUserBuffer )
+    {
+        vPortFree( pConnectionPoolUserBuffer );
+        pConnectionPoolUserBuffer = NULL;
+    }
+}
+
+/* Helper function to give the connection back and close it with the connection pool, before the
+ * buffers of the pool are freed. Returns false if the pool is still in use, the handles are kept
+ * then and the buffers must not be freed. */
+static bool _httpDestroyConnectionPool()
+{
+    IotHttpsReturnCode_t httpsStatus = IOT_HTTPS_OK;
+
+    /* HTTP connection data. */
+    _httpConnection_t * pConnection = &_httpDownloader.httpConnection;
+
+    if( pConnection->connectionHandle != NULL )
+    {
+        httpsStatus = IotHttpsClient_ReleaseConnection( pConnection->poolHandle, pConnection->connectionHandle );
+
+        if( httpsStatus == IOT_HTTPS_OK )
+        {
+            pConnection->connectionHandle = NULL;
+        }
+        else
+        {
+            IotLogError( "Failed to give back the HTTP connection. Error code: %d.", httpsStatus );
+        }
+    }
+
+    if( ( httpsStatus == IOT_HTTPS_OK ) && ( pConnection->poolHandle != NULL ) )
     {
-        vPortFree( pConnectionUserBuffer );
-        pConnectionUserBuffer = NULL;
+        httpsStatus = IotHttpsClient_DestroyConnectionPool( pConnection->poolHandle );
+
+        if( httpsStatus == IOT_HTTPS_OK )
+        {
+            pConnection->poolHandle = NULL;
+        }
+        else
+        {
+            IotLogError( "Failed to close the HTTP connection, it is still in use. Error code: %d.", httpsStatus );
+        }
     }
+
+    return( httpsStatus == IOT_HTTPS_OK );
+}
+
+/* Get the size of a block in a requested range. Only the last block of the file can be smaller
+ * than OTA_FILE_BLOCK_SIZE. */
+static uint32_t _httpGetBlockSize( const _httpCallbackData_t * pCallbackData,
+                                   uint32_t blockIndex )
+{
+    uint32_t blockSize = OTA_FILE_BLOCK_SIZE;
+
+    if( blockIndex == ( pCallbackData->firstBlock + pCallbackData->numBlocks - 1U ) )
+    {
+        blockSize = pCallbackData->rangeSize - ( ( pCallbackData->numBlocks - 1U ) * OTA_FILE_BLOCK_SIZE );
+    }
+
+    return blockSize;
+}
+
+/* Check the block bitmap of the file for a block that has not been received. */
+static bool _httpIsBlockMissing( const OTA_FileContext_t * fileContext,
+                                 uint32_t blockIndex )
+{
+    uint8_t bitMask = ( uint8_t ) ( 1U << ( blockIndex % BITS_PER_BYTE ) );
+
+    return ( fileContext->pucRxBlockBitmap[ blockIndex >> LOG2_BITS_PER_BYTE ] & bitMask ) != 0U;
 }
 
-/* Process the HTTP response body, copy to another buffer and signal OTA agent the file block
- * download is complete. */
-static void _httpProcessResponseBody( OTA_AgentContext_t * pAgentCtx,
+/* Process a file block from the HTTP response body, copy it with its block index to an OTA data
+ * buffer and signal OTA agent the file block download is complete. Returns false if the block is
+ * dropped. */
+static bool _httpProcessResponseBody( OTA_AgentContext_t * pAgentCtx,
+                                      uint32_t blockIndex,
                                       uint8_t * pResponseBodyBuffer,
                                       uint32_t bufferSize )
 {
@@ -297,8 +400,9 @@ static void _httpProcessResponseBody( OTA_AgentContext_t * pAgentCtx,
 
     pAgentCtx->xStatistics.ulOTA_PacketsReceived++;
 
-    /* Try to get OTA data buffer. */
-    pMessage = prvOTAEventBufferGet();
+    /* Try to get OTA data buffer. Blocks of a range arrive faster than the OTA agent writes them, so
+     * wait for the agent to free a buffer rather than dropping the block. */
+    pMessage = prvOTAEventBufferWait( pdMS_TO_TICKS( HTTP_EVENT_BUFFER_WAIT_MS ) );
 
     if( pMessage == NULL )
     {
@@ -307,21 +411,44 @@ static void _httpProcessResponseBody( OTA_AgentContext_t * pAgentCtx,
     }
     else
     {
-        pMessage->ulDataLength = bufferSize;
+        pMessage->ulDataLength = HTTP_BLOCK_HEADER_SIZE + bufferSize;
 
-        memcpy( pMessage->ucData, pResponseBodyBuffer, pMessage->ulDataLength );
+        memcpy( pMessage->ucData, &blockIndex, HTTP_BLOCK_HEADER_SIZE );
+        memcpy( pMessage->ucData + HTTP_BLOCK_HEADER_SIZE, pResponseBodyBuffer, bufferSize );
         eventMsg.xEventId = eOTA_AgentEvent_ReceivedFileBlock;
         eventMsg.pxEventData = pMessage;
         /* Send job document received event. */
         OTA_SignalEvent( &eventMsg );
     }
+
+    return pMessage != NULL;
+}
+
+/* Mark one range request as completed. Returns true if no other range request is in flight. */
+static bool _httpRangeCompleted()
+{
+    bool lastRange = false;
+
+    taskENTER_CRITICAL();
+
+    if( _httpDownloader.rangesInFlight > 0U )
+    {
+        _httpDownloader.rangesInFlight--;
+    }
+
+    lastRange = ( _httpDownloader.rangesInFlight == 0U );
+
+    taskEXIT_CRITICAL();
+
+    return lastRange;
 }
 
-/* Error handler for HTTP response code. */
-static void _httpErrorHandler( uint16_t responseCode )
+/* Error handler for HTTP response code. Returns the downloader error for the response. */
+static _httpErr _httpErrorHandler( uint16_t responseCode )
 {
     const char * pResponseBody = ( const char * ) pResponseBodyBuffer;
     char * endPos = NULL;
+    _httpErr err = OTA_HTTP_ERR_GENERIC;
 
     /* Force the response body to be NULL terminated. */
     pResponseBodyBuffer[ HTTPS_RESPONSE_BODY_BUFFER_SIZE - 1 ] = '\0';
@@ -344,26 +471,42 @@ static void _httpErrorHandler( uint16_t responseCode )
         if( NULL != strstr( pResponseBody, "Request has expired" ) )
         {
             IotLogInfo( "Pre-signed URL have expired, requesting new job document." );
-            _httpDownloader.err = OTA_HTTP_ERR_URL_EXPIRED;
-        }
-        else
-        {
-            _httpDownloader.err = OTA_HTTP_ERR_GENERIC;
+            err = OTA_HTTP_ERR_URL_EXPIRED;
         }
     }
-    else
-    {
-        _httpDownloader.err = OTA_HTTP_ERR_GENERIC;
-    }
+
+    return err;
 }
 
 /* Helper function to reconnect to the HTTP server. */
 static IotHttpsReturnCode_t _httpReconnect()
 {
     /* HTTP API return status. */
-    IotHttpsReturnCode_t httpsStatus = IotHttpsClient_Connect(
-        &_httpDownloader.httpConnection.connectionHandle,
-        &_httpDownloader.httpConnection.connectionConfig );
+    IotHttpsReturnCode_t httpsStatus = IOT_HTTPS_OK;
+
+    /* HTTP connection data. */
+    _httpConnection_t * pConnection = &_httpDownloader.httpConnection;
+
+    /* The server closes the connection or does not answer on it anymore, so disconnect before
+     * giving it back. Otherwise the pool keeps it open and hands it out again. */
+    if( pConnection->connectionHandle != NULL )
+    {
+        IotHttpsClient_Disconnect( pConnection->connectionHandle );
+        httpsStatus = IotHttpsClient_ReleaseConnection( pConnection->poolHandle, pConnection->connectionHandle );
+
+        /* The connection is given back once the request being sent on it is cancelled. */
+        if( httpsStatus == IOT_HTTPS_OK )
+        {
+            pConnection->connectionHandle = NULL;
+        }
+    }
+
+    if( httpsStatus == IOT_HTTPS_OK )
+    {
+        httpsStatus = IotHttpsClient_AcquireConnection( pConnection->poolHandle,
+                                                        &pConnection->connectionHandle,
+                                                        &pConnection->connectionConfig );
+    }
 
     if( httpsStatus != IOT_HTTPS_OK )
     {
@@ -386,8 +529,11 @@ static void _httpAppendHeaderCallback( void * pPrivateData,
 {
     IotLogDebug( "Invoking _httpAppendHeaderCallback." );
 
-    /* Value of the "Range" field in HTTP GET request header, set when requesting the file block. */
-    char * pRangeValueStr = ( ( _httpCallbackData_t * ) ( pPrivateData ) )->pRangeValueStr;
+    /* Data of the range request. */
+    _httpCallbackData_t * pCallbackData = ( _httpCallbackData_t * ) pPrivateData;
+
+    /* Value of the "Range" field in HTTP GET request header, set when requesting the file blocks. */
+    char * pRangeValueStr = pCallbackData->pRangeValueStr;
 
     /* Set the header for this range request. */
     IotHttpsReturnCode_t status = IotHttpsClient_AddHeader( requestHandle,
@@ -402,7 +548,7 @@ static void _httpAppendHeaderCallback( void * pPrivateData,
     {
         IotLogError( "Failed to add HTTP header. Error code: %d. Canceling current request.", status );
         IotHttpsClient_CancelRequestAsync( requestHandle );
-        _httpDownloader.err = OTA_HTTP_ERR_CANCELED;
+        pCallbackData->err = OTA_HTTP_ERR_CANCELED;
     }
     else
     {
@@ -412,6 +558,10 @@ static void _httpAppendHeaderCallback( void * pPrivateData,
     }
 }
 
+/* HTTP async callback for reading the response body. It is invoked again until the whole range is
+ * read, and every block of the range except the last is passed to the OTA agent as soon as it is
+ * read. The last block is passed in _httpResponseCompleteCallback, after this range request is
+ * marked as completed, so the OTA agent can request the next ranges once it has all the blocks. */
 static void _httpReadReadyCallback( void * pPrivateData,
                                     IotHttpsResponseHandle_t responseHandle,
                                     IotHttpsReturnCode_t returnCode,
@@ -420,9 +570,11 @@ static void _httpReadReadyCallback( void * pPrivateData,
     IotLogDebug( "Invoking _httpReadReadyCallback." );
 
     /* Unused parameters. */
-    ( void ) pPrivateData;
     ( void ) returnCode;
 
+    /* Data of the range request. */
+    _httpCallbackData_t * pCallbackData = ( _httpCallbackData_t * ) pPrivateData;
+
     /* HTTP return status. */
     IotHttpsReturnCode_t httpsStatus = IOT_HTTPS_OK;
 
@@ -432,75 +584,113 @@ static void _httpReadReadyCallback( void * pPrivateData,
     /* Size of the response body returned from HTTP API. */
     uint32_t responseBodyLength = 0;
 
+    /* Size of the block being read. */
+    uint32_t blockSize = _httpGetBlockSize( pCallbackData, pCallbackData->currBlock );
+
+    /* The status and headers are checked the first time this callback is invoked for the response. */
+    bool firstRead = ( pCallbackData->currBlock == pCallbackData->firstBlock ) &&
+                     ( pCallbackData->currBlockLen == 0 );
+
     /* Buffer to read the "Connection" field in HTTP header. */
     char connectionValueStr[ HTTP_HEADER_CONNECTION_VALUE_MAX_LEN ] = { 0 };
 
     /* A response is received from the server, setting the state to processing response. */
     _httpDownloader.state = OTA_HTTP_PROCESSING_RESPONSE;
 
-    /* Read the data from the network. */
-    responseBodyLength = HTTPS_RESPONSE_BODY_BUFFER_SIZE;
+    /* Only the last block of the range is kept in the response body buffer after all of it is read,
+     * so there is more in the response body than what we have requested. */
+    if( pCallbackData->currBlockLen == blockSize )
+    {
+        IotLogError( "Received more data than requested for blocks %d-%d.", pCallbackData->firstBlock, pCallbackData->currBlock );
+        pCallbackData->err = OTA_HTTP_ERR_GENERIC;
+        OTA_GOTO_CLEANUP();
+    }
+
+    /* Read the rest of the current block from the network. */
+    responseBodyLength = blockSize - pCallbackData->currBlockLen;
     httpsStatus = IotHttpsClient_ReadResponseBody( responseHandle,
-                                                   pResponseBodyBuffer,
+                                                   pResponseBodyBuffer + pCallbackData->currBlockLen,
                                                    &responseBodyLength );
 
     if( httpsStatus != IOT_HTTPS_OK )
     {
         IotLogError( "Failed to read the response body. Error code: %d.", httpsStatus );
-        _httpDownloader.err = OTA_HTTP_ERR_GENERIC;
+        pCallbackData->err = OTA_HTTP_ERR_GENERIC;
         OTA_GOTO_CLEANUP();
     }
 
-    /* The HTTP response should be partial content with response code 206. */
-    if( responseStatus != IOT_HTTPS_STATUS_PARTIAL_CONTENT )
+    pCallbackData->currBlockLen += responseBodyLength;
+
+    if( firstRead )
     {
-        IotLogError( "Expect a HTTP partial response, but received code %d", responseStatus );
-        _httpErrorHandler( responseStatus );
-        OTA_GOTO_CLEANUP();
-    }
+        /* The HTTP response should be partial content with response code 206. */
+        if( responseStatus != IOT_HTTPS_STATUS_PARTIAL_CONTENT )
+        {
+            IotLogError( "Expect a HTTP partial response, but received code %d", responseStatus );
+            pCallbackData->err = _httpErrorHandler( responseStatus );
+            OTA_GOTO_CLEANUP();
+        }
 
-    /* Read the "Content-Length" field from HTTP header. */
-    httpsStatus = IotHttpsClient_ReadContentLength( responseHandle, &contentLength );
+        /* Read the "Content-Length" field from HTTP header. */
+        httpsStatus = IotHttpsClient_ReadContentLength( responseHandle, &contentLength );
 
-    if( ( httpsStatus != IOT_HTTPS_OK ) || ( contentLength == 0 ) )
-    {
-        IotLogError( "Failed to retrieve the Content-Length from the response. " );
-        _httpDownloader.err = OTA_HTTP_ERR_GENERIC;
-        OTA_GOTO_CLEANUP();
+        if( ( httpsStatus != IOT_HTTPS_OK ) || ( contentLength == 0 ) )
+        {
+            IotLogError( "Failed to retrieve the Content-Length from the response. " );
+            pCallbackData->err = OTA_HTTP_ERR_GENERIC;
+            OTA_GOTO_CLEANUP();
+        }
+
+        /* Check if the value of "Content-Length" matches what we have requested. */
+        if( contentLength != pCallbackData->rangeSize )
+        {
+            IotLogError( "Content-Length value in HTTP header does not match what we requested. " );
+            pCallbackData->err = OTA_HTTP_ERR_GENERIC;
+            OTA_GOTO_CLEANUP();
+        }
     }
 
-    /* Check if the value of "Content-Length" matches what we have requested. */
-    if( contentLength != _httpDownloader.currBlockSize )
+    /* Pass the block to the OTA agent once all of it is read, and start reading the next one. */
+    if( ( pCallbackData->currBlockLen == blockSize ) &&
+        ( pCallbackData->currBlock < ( pCallbackData->firstBlock + pCallbackData->numBlocks - 1U ) ) )
     {
-        IotLogError( "Content-Length value in HTTP header does not match what we requested. " );
-        _httpDownloader.err = OTA_HTTP_ERR_GENERIC;
-        OTA_GOTO_CLEANUP();
+        if( _httpProcessResponseBody( _httpDownloader.pAgentCtx, pCallbackData->currBlock, pResponseBodyBuffer, blockSize ) == false )
+        {
+            _httpDownloader.blocksMissed = true;
+        }
+
+        pCallbackData->currBlock++;
+        pCallbackData->currBlockLen = 0;
     }
 
     OTA_FUNCTION_CLEANUP_BEGIN();
 
     /* The connection could be closed by S3 after 100 requests, so we need to check the value
-     * of the "Connection" filed in HTTP header to see if we need to reconnect. */
-    memset( connectionValueStr, 0, sizeof( connectionValueStr ) );
-    httpsStatus = IotHttpsClient_ReadHeader( responseHandle,
-                                             "Connection",
-                                             sizeof( "Connection" ) - 1,
-                                             connectionValueStr,
-                                             sizeof( connectionValueStr ) );
-
-    /* Check if there is any other error besides not found when parsing the http header. */
-    if( ( httpsStatus != IOT_HTTPS_OK ) && ( httpsStatus != IOT_HTTPS_NOT_FOUND ) )
+     * of the "Connection" filed in HTTP header to see if we need to reconnect. Other requests
+     * could still be in flight on the connection, so reconnect before sending the next request. */
+    if( firstRead )
     {
-        IotLogError( "Failed to read header Connection. Error code: %d.", httpsStatus );
-        _httpDownloader.err = OTA_HTTP_ERR_GENERIC;
-    }
-    else
-    {
-        /* Check if the server returns a response with connection field set to "close". */
-        if( strncmp( "close", connectionValueStr, sizeof( "close" ) ) == 0 )
+        memset( connectionValueStr, 0, sizeof( connectionValueStr ) );
+        httpsStatus = IotHttpsClient_ReadHeader( responseHandle,
+                                                 "Connection",
+                                                 sizeof( "Connection" ) - 1,
+                                                 connectionValueStr,
+                                                 sizeof( connectionValueStr ) );
+
+        /* Check if there is any other error besides not found when parsing the http header. */
+        if( ( httpsStatus != IOT_HTTPS_OK ) && ( httpsStatus != IOT_HTTPS_NOT_FOUND ) )
         {
-            IotLogInfo( "Connection has been closed by the HTTP server, reconnecting to the server..." );
-            _httpReconnect();
+            IotLogError( "Failed to read header Connection. Error code: %d.", httpsStatus );
+            pCallbackData->err = OTA_HTTP_ERR_GENERIC;
+        }
+        else
+        {
+            /* Check if the server returns a response with connection field set to "close". */
+            if( strncmp( "close", connectionValueStr, sizeof( "close" ) ) == 0 )
+            {
+                IotLogInfo( "Connection will be closed by the HTTP server, reconnecting before next request..." );
+                _httpDownloader.err = OTA_HTTP_ERR_NEED_RECONNECT;
+            }
         }
     }
 
@@ -508,7 +698,7 @@ static void _httpReadReadyCallback( void * pPrivateData,
      * If the HTTP error is IOT_HTTPS_NETWORK_ERROR, the connection will then be closed by the HTTP
      * client, followed by invoking _httpConnectionClosedCallback and _httpResponseCompleteCallback.
      * In other cases, only _httpResponseCompleteCallback will be invoked. */
-    if( _httpDownloader.err != OTA_HTTP_ERR_NONE )
+    if( pCallbackData->err != OTA_HTTP_ERR_NONE )
     {
         IotHttpsClient_CancelResponseAsync( responseHandle );
     }
@@ -524,11 +714,21 @@ static void _httpResponseCompleteCallback( void * pPrivateData,
     IotLogDebug( "Invoking _httpResponseCompleteCallback." );
 
     /* Unused parameters. */
-    ( void ) pPrivateData;
     ( void ) responseHandle;
-    ( void ) returnCode;
     ( void ) responseStatus;
 
+    /* Data of the range request. */
+    _httpCallbackData_t * pCallbackData = ( _httpCallbackData_t * ) pPrivateData;
+
+    /* Last block of the range. */
+    uint32_t lastBlock = pCallbackData->firstBlock + pCallbackData->numBlocks - 1U;
+
+    /* Whether the last block of the range is read and can be passed to the OTA agent. */
+    bool lastBlockRead = false;
+
+    /* Whether this is the last range request in flight. */
+    bool lastRange = false;
+
     /* OTA Event. */
     OTA_EventMsg_t eventMsg = { 0 };
 
@@ -538,19 +738,78 @@ static void _httpResponseCompleteCallback( void * pPrivateData,
         return;
     }
 
-    if( _httpDownloader.err == OTA_HTTP_ERR_NONE )
+    /* The response could be completed early by the HTTP client without invoking the error callback,
+     * for example when it is aborted on disconnect. */
+    if( ( pCallbackData->err == OTA_HTTP_ERR_NONE ) && ( returnCode != IOT_HTTPS_OK ) )
     {
-        _httpProcessResponseBody( _httpDownloader.pAgentCtx, pResponseBodyBuffer, _httpDownloader.currBlockSize );
+        pCallbackData->err = OTA_HTTP_ERR_GENERIC;
     }
-    else
+
+    lastBlockRead = ( pCallbackData->err == OTA_HTTP_ERR_NONE ) &&
+                    ( pCallbackData->currBlock == lastBlock ) &&
+                    ( pCallbackData->currBlockLen == _httpGetBlockSize( pCallbackData, lastBlock ) );
+
+    if( pCallbackData->err != OTA_HTTP_ERR_NONE )
     {
-        /* Reset the state to idle when current download fails. */
+        switch( pCallbackData->err )
+        {
+            case OTA_HTTP_ERR_CANCELED:
+                IotLogError( "Request to download blocks %d-%d has been canceled.", pCallbackData->firstBlock, lastBlock );
+                break;
+
+            default:
+                IotLogError( "Fail to download blocks %d-%d.", pCallbackData->firstBlock, lastBlock );
+                break;
+        }
+
+        /* Keep the first error of the range requests for when the last one completes. */
+        if( ( _httpDownloader.err == OTA_HTTP_ERR_NONE ) || ( pCallbackData->err == OTA_HTTP_ERR_URL_EXPIRED ) )
+        {
+            _httpDownloader.err = pCallbackData->err;
+        }
+    }
+
+    if( lastBlockRead == false )
+    {
+        _httpDownloader.blocksMissed = true;
+    }
+
+    lastRange = _httpRangeCompleted();
+
+    if( lastRange )
+    {
+        /* All range requests are completed, new ones can be sent. */
         _httpDownloader.state = OTA_HTTP_IDLE;
+    }
 
+    if( lastBlockRead )
+    {
+        if( _httpProcessResponseBody( _httpDownloader.pAgentCtx, lastBlock, pResponseBodyBuffer, pCallbackData->currBlockLen ) == false )
+        {
+            _httpDownloader.blocksMissed = true;
+        }
+    }
+
+    if( lastRange )
+    {
         switch( _httpDownloader.err )
         {
+            case OTA_HTTP_ERR_NONE:
             case OTA_HTTP_ERR_NEED_RECONNECT:
-                IotLogInfo( "HTTP connection is closed, will reconnection in next request." );
+
+                if( _httpDownloader.err == OTA_HTTP_ERR_NEED_RECONNECT )
+                {
+                    IotLogInfo( "HTTP connection is closed, will reconnection in next request." );
+                }
+
+                /* Blocks that were not received are still missing in the bitmap. Request them now
+                 * instead of waiting for the OTA agent request timer. */
+                if( _httpDownloader.blocksMissed )
+                {
+                    eventMsg.xEventId = eOTA_AgentEvent_RequestFileBlock;
+                    OTA_SignalEvent( &eventMsg );
+                }
+
                 break;
 
             case OTA_HTTP_ERR_URL_EXPIRED:
@@ -560,11 +819,7 @@ static void _httpResponseCompleteCallback( void * pPrivateData,
                 break;
 
             case OTA_HTTP_ERR_CANCELED:
-                IotLogError( "Request to download block %d has been canceled.", _httpDownloader.currBlock );
-                break;
-
             case OTA_HTTP_ERR_GENERIC:
-                IotLogError( "Fail to download block %d.", _httpDownloader.currBlock );
                 break;
 
             default:
@@ -584,14 +839,15 @@ static void _httpErrorCallback( void * pPrivateData,
     IotLogDebug( "Invoking _httpErrorCallback." );
 
     /* Unused parameters. */
-    ( void ) pPrivateData;
     ( void ) requestHandle;
     ( void ) responseHandle;
-    ( void ) returnCode;
 
-    if( _httpDownloader.err == OTA_HTTP_ERR_NONE )
+    /* Data of the range request. */
+    _httpCallbackData_t * pCallbackData = ( _httpCallbackData_t * ) pPrivateData;
+
+    if( pCallbackData->err == OTA_HTTP_ERR_NONE )
     {
-        _httpDownloader.err = OTA_HTTP_ERR_GENERIC;
+        pCallbackData->err = OTA_HTTP_ERR_GENERIC;
     }
 
     IotLogError( "An error occurred for HTTP async request: %d", returnCode );
@@ -608,8 +864,14 @@ static void _httpConnectionClosedCallback( void * pPrivateData,
     ( void ) connectionHandle;
     ( void ) returnCode;
 
-    IotLogInfo( "Connection has been closed by the HTTP client due to an error, reconnecting to the server..." );
-    _httpReconnect();
+    /* Reconnecting here would close the connection from its own network receive callback, so it is
+     * done before the next request is sent, see _requestDataBlockPreCheck. */
+    IotLogInfo( "Connection has been closed by the HTTP client due to an error, will reconnect in next request." );
+
+    if( _httpDownloader.err != OTA_HTTP_ERR_URL_EXPIRED )
+    {
+        _httpDownloader.err = OTA_HTTP_ERR_NEED_RECONNECT;
+    }
 }
 
 static IotHttpsReturnCode_t _httpInitUrl( const char * pURL )
@@ -663,54 +925,105 @@ static IotHttpsReturnCode_t _httpConnect( const IotNetworkInterface_t * pNetwork
     /* HTTP connection configuration. */
     IotHttpsConnectionInfo_t * pConnectionConfig = &pConnection->connectionConfig;
 
+    /* HTTP connection pool configuration. */
+    IotHttpsConnectionPoolInfo_t poolConfig = IOT_HTTPS_CONNECTION_POOL_INFO_INITIALIZER;
+
+    /* HTTP range request data. */
+    _httpRange_t * pRange = NULL;
+
     /* HTTP request data. */
-    _httpRequest_t * pRequest = &_httpDownloader.httpRequest;
+    _httpRequest_t * pRequest = NULL;
 
     /* HTTP response data. */
-    _httpResponse_t * pResponse = &_httpDownloader.httpResponse;
+    _httpResponse_t * pResponse = NULL;
 
     /* HTTP URL information. */
     _httpUrlInfo_t * pUrlInfo = &_httpDownloader.httpUrlInfo;
 
+    /* Index of the range request. */
+    uint32_t rangeIndex = 0;
+
     /* Set the connection configurations. */
     pConnectionConfig->pAddress = pUrlInfo->pAddress;
     pConnectionConfig->addressLen = pUrlInfo->addressLength;
     pConnectionConfig->port = HTTPS_PORT;
     pConnectionConfig->pCaCert = HTTPS_TRUSTED_ROOT_CA;
     pConnectionConfig->caCertLen = sizeof( HTTPS_TRUSTED_ROOT_CA );
-    pConnectionConfig->userBuffer.pBuffer = pConnectionUserBuffer;
-    pConnectionConfig->userBuffer.bufferLen = HTTPS_CONNECTION_USER_BUFFER_SIZE;
     pConnectionConfig->pClientCert = pNetworkCredentials->pClientCert;
     pConnectionConfig->clientCertLen = pNetworkCredentials->clientCertSize;
     pConnectionConfig->pPrivateKey = pNetworkCredentials->pPrivateKey;
     pConnectionConfig->privateKeyLen = pNetworkCredentials->privateKeySize;
     pConnectionConfig->pNetworkInterface = pNetworkInterface;
 
-    /* Initialize HTTP request configuration. */
-    pRequest->requestConfig.pPath = pUrlInfo->pPath;
-    pRequest->requestConfig.pathLen = pUrlInfo->pathLength;
-    pRequest->requestConfig.pHost = pUrlInfo->pAddress;
-    pRequest->requestConfig.hostLen = pUrlInfo->addressLength;
-    pRequest->requestConfig.method = IOT_HTTPS_METHOD_GET;
-    pRequest->requestConfig.userBuffer.pBuffer = pRequestUserBuffer;
-    pRequest->requestConfig.userBuffer.bufferLen = HTTPS_REQUEST_USER_BUFFER_SIZE;
-    pRequest->requestConfig.isAsync = true;
-    pRequest->requestConfig.u.pAsyncInfo = &pRequest->asyncInfo;
-
-    /* Initialize HTTP response configuration. */
-    pResponse->responseConfig.userBuffer.pBuffer = pResponseUserBuffer;
-    pResponse->responseConfig.userBuffer.bufferLen = HTTPS_RESPONSE_USER_BUFFER_SIZE;
-    pResponse->responseConfig.pSyncInfo = NULL;
-
-    /* Initialize HTTP asynchronous configuration. */
-    pRequest->asyncInfo.callbacks.appendHeaderCallback = _httpAppendHeaderCallback;
-    pRequest->asyncInfo.callbacks.readReadyCallback = _httpReadReadyCallback;
-    pRequest->asyncInfo.callbacks.responseCompleteCallback = _httpResponseCompleteCallback;
-    pRequest->asyncInfo.callbacks.errorCallback = _httpErrorCallback;
-    pRequest->asyncInfo.callbacks.connectionClosedCallback = _httpConnectionClosedCallback;
-    pRequest->asyncInfo.pPrivData = ( void * ) ( &_httpDownloader.httpCallbackData );
-
-    httpsStatus = IotHttpsClient_Connect( &pConnection->connectionHandle, pConnectionConfig );
+    /* Range requests are only for data already in the file, so they can be pipelined safely. */
+    if( otaconfigHTTP_MAX_RANGES_IN_FLIGHT > 1U )
+    {
+        pConnectionConfig->flags |= IOT_HTTPS_ENABLE_PIPELINING;
+    }
+
+    for( rangeIndex = 0; rangeIndex < otaconfigHTTP_MAX_RANGES_IN_FLIGHT; rangeIndex++ )
+    {
+        pRange = &_httpDownloader.httpRanges[ rangeIndex ];
+        pRequest = &pRange->httpRequest;
+        pResponse = &pRange->httpResponse;
+
+        /* Initialize HTTP request configuration. */
+        pRequest->requestConfig.pPath = pUrlInfo->pPath;
+        pRequest->requestConfig.pathLen = pUrlInfo->pathLength;
+        pRequest->requestConfig.pHost = pUrlInfo->pAddress;
+        pRequest->requestConfig.hostLen = pUrlInfo->addressLength;
+        pRequest->requestConfig.method = IOT_HTTPS_METHOD_GET;
+        pRequest->requestConfig.userBuffer.pBuffer = pRequestUserBuffer + ( rangeIndex * HTTPS_REQUEST_USER_BUFFER_SIZE );
+        pRequest->requestConfig.userBuffer.bufferLen = HTTPS_REQUEST_USER_BUFFER_SIZE;
+        pRequest->requestConfig.isAsync = true;
+        pRequest->requestConfig.u.pAsyncInfo = &pRequest->asyncInfo;
+
+        /* Initialize HTTP response configuration. */
+        pResponse->responseConfig.userBuffer.pBuffer = pResponseUserBuffer + ( rangeIndex * HTTPS_RESPONSE_USER_BUFFER_SIZE );
+        pResponse->responseConfig.userBuffer.bufferLen = HTTPS_RESPONSE_USER_BUFFER_SIZE;
+        pResponse->responseConfig.pSyncInfo = NULL;
+
+        /* Initialize HTTP asynchronous configuration. */
+        pRequest->asyncInfo.callbacks.appendHeaderCallback = _httpAppendHeaderCallback;
+        pRequest->asyncInfo.callbacks.readReadyCallback = _httpReadReadyCallback;
+        pRequest->asyncInfo.callbacks.responseCompleteCallback = _httpResponseCompleteCallback;
+        pRequest->asyncInfo.callbacks.errorCallback = _httpErrorCallback;
+        pRequest->asyncInfo.callbacks.connectionClosedCallback = _httpConnectionClosedCallback;
+        pRequest->asyncInfo.pPrivData = ( void * ) ( &pRange->httpCallbackData );
+    }
+
+    /* The pool is created for the first file and kept for the next ones, so that the connection
+     * of the previous file is used again if the next file is on the same server. */
+    if( pConnection->poolHandle == NULL )
+    {
+        poolConfig.userBuffer.pBuffer = pConnectionPoolUserBuffer;
+        poolConfig.userBuffer.bufferLen = connectionPoolUserBufferMinimumSize +
+                                          connectionPoolUserBufferSizePerConnection +
+                                          HTTPS_CONNECTION_USER_BUFFER_SIZE;
+        poolConfig.connectionBufferLen = HTTPS_CONNECTION_USER_BUFFER_SIZE;
+        poolConfig.maxIdleConnections = 1;
+        poolConfig.idleTimeoutMs = HTTPS_CONNECTION_IDLE_TIMEOUT_MS;
+
+        httpsStatus = IotHttpsClient_CreateConnectionPool( &pConnection->poolHandle, &poolConfig );
+    }
+
+    /* Give back the connection of the previous file. It stays open if nothing is left to do on it. */
+    if( ( httpsStatus == IOT_HTTPS_OK ) && ( pConnection->connectionHandle != NULL ) )
+    {
+        httpsStatus = IotHttpsClient_ReleaseConnection( pConnection->poolHandle, pConnection->connectionHandle );
+
+        if( httpsStatus == IOT_HTTPS_OK )
+        {
+            pConnection->connectionHandle = NULL;
+        }
+    }
+
+    if( httpsStatus == IOT_HTTPS_OK )
+    {
+        httpsStatus = IotHttpsClient_AcquireConnection( pConnection->poolHandle,
+                                                        &pConnection->connectionHandle,
+                                                        pConnectionConfig );
+    }
 
     return httpsStatus;
 }
@@ -825,7 +1138,7 @@ static _httpErr _httpGetFileSize( uint32_t * pFileSize )
     {
         IotLogError( "Fail to get the object size from HTTP server, HTTP response code from server: %d", responseStatus );
         status = OTA_HTTP_ERR_GENERIC;
-        _httpErrorHandler( responseStatus );
+        _httpDownloader.err = _httpErrorHandler( responseStatus );
         OTA_GOTO_CLEANUP();
     }
 
@@ -912,6 +1225,69 @@ static _httpErr _requestDataBlockPreCheck()
     return status;
 }
 
+/* Find the next ranges of blocks that have not been received in the block bitmap and set them in the
+ * range requests. The search starts after the last requested range and wraps around to the start of
+ * the file, so blocks that were missed earlier are requested again. A range never wraps around and
+ * never includes a received block. Returns the number of ranges found. */
+static uint32_t _httpFindMissingRanges( const OTA_FileContext_t * fileContext )
+{
+    /* Number of ranges found. */
+    uint32_t numRanges = 0;
+
+    /* Number of blocks in the file. */
+    uint32_t numBlocks = ( fileContext->ulFileSize + ( OTA_FILE_BLOCK_SIZE - 1U ) ) >> otaconfigLOG2_FILE_BLOCK_SIZE;
+
+    /* Number of blocks searched so far, every block is searched at most once. */
+    uint32_t numSearched = 0;
+
+    /* Block being searched. */
+    uint32_t block = _httpDownloader.currBlock;
+
+    /* Callback data of the range request being set. */
+    _httpCallbackData_t * pCallbackData = NULL;
+
+    if( block >= numBlocks )
+    {
+        block = 0;
+    }
+
+    while( ( numSearched < numBlocks ) && ( numRanges < otaconfigHTTP_MAX_RANGES_IN_FLIGHT ) )
+    {
+        if( _httpIsBlockMissing( fileContext, block ) )
+        {
+            pCallbackData = &_httpDownloader.httpRanges[ numRanges ].httpCallbackData;
+            pCallbackData->firstBlock = block;
+            pCallbackData->numBlocks = 0;
+
+            while( ( numSearched < numBlocks ) &&
+                   ( block < numBlocks ) &&
+                   ( pCallbackData->numBlocks < otaconfigHTTP_MAX_BLOCKS_PER_RANGE ) &&
+                   _httpIsBlockMissing( fileContext, block ) )
+            {
+                pCallbackData->numBlocks++;
+                block++;
+                numSearched++;
+            }
+
+            numRanges++;
+        }
+        else
+        {
+            block++;
+            numSearched++;
+        }
+
+        if( block >= numBlocks )
+        {
+            block = 0;
+        }
+    }
+
+    _httpDownloader.currBlock = block;
+
+    return numRanges;
+}
+
 OTA_Err_t _AwsIotOTA_InitFileTransfer_HTTP( OTA_AgentContext_t * pAgentCtx )
 {
     IotLogDebug( "Invoking _AwsIotOTA_InitFileTransfer_HTTP" );
@@ -967,8 +1343,9 @@ OTA_Err_t _AwsIotOTA_InitFileTransfer_HTTP( OTA_AgentContext_t * pAgentCtx )
         OTA_GOTO_CLEANUP();
     }
 
-    /* Allocate buffers for HTTP library. */
-    if( _httpAllocateBuffers() == false )
+    /* Allocate buffers for HTTP library. They are kept until the OTA agent is stopped, together with
+     * the connection pool in them. */
+    if( ( pConnectionPoolUserBuffer == NULL ) && ( _httpAllocateBuffers() == false ) )
     {
         cleanupRequired = true;
         OTA_GOTO_CLEANUP();
@@ -1025,7 +1402,14 @@ OTA_Err_t _AwsIotOTA_InitFileTransfer_HTTP( OTA_AgentContext_t * pAgentCtx )
 
     if( cleanupRequired )
     {
-        _httpFreeBuffers();
+        if( _httpDestroyConnectionPool() )
+        {
+            _httpFreeBuffers();
+        }
+        else
+        {
+            IotLogWarn( "HTTP buffers are kept, the connection pool in them is still in use." );
+        }
     }
 
     OTA_FUNCTION_CLEANUP_END();
@@ -1044,17 +1428,21 @@ OTA_Err_t _AwsIotOTA_RequestDataBlock_HTTP( OTA_AgentContext_t * pAgentCtx )
     /* HTTP connection data. */
     _httpConnection_t * pConnection = &_httpDownloader.httpConnection;
 
-    /* HTTP request data. */
-    _httpRequest_t * pRequest = &_httpDownloader.httpRequest;
-
-    /* HTTP response data. */
-    _httpResponse_t * pResponse = &_httpDownloader.httpResponse;
+    /* HTTP range request data. */
+    _httpRange_t * pRange = NULL;
 
     /* Values for the "Range" field in HTTP header. */
     uint32_t rangeStart = 0;
     uint32_t rangeEnd = 0;
     int numWritten = 0;
 
+    /* Number of range requests to send, and number sent. */
+    uint32_t numRanges = 0;
+    uint32_t numSent = 0;
+
+    /* Number of blocks in the range requests sent. */
+    uint32_t numBlocksSent = 0;
+
     /* File context from OTA agent. */
     OTA_FileContext_t * fileContext = &( pAgentCtx->pxOTA_Files[ pAgentCtx->ulFileIndex ] );
 
@@ -1067,67 +1455,112 @@ OTA_Err_t _AwsIotOTA_RequestDataBlock_HTTP( OTA_AgentContext_t * pAgentCtx )
 
     _httpDownloader.state = OTA_HTTP_SENDING_REQUEST;
     _httpDownloader.err = OTA_HTTP_ERR_NONE;
+    _httpDownloader.blocksMissed = false;
 
-    if( fileContext == NULL )
+    if( ( fileContext == NULL ) || ( fileContext->pucRxBlockBitmap == NULL ) )
     {
         IotLogError( "File context from OTA agent is NULL." );
         status = kOTA_Err_Panic;
         OTA_GOTO_CLEANUP();
     }
 
-    /* Set number of blocks to request to 1. */
-    pAgentCtx->ulNumOfBlocksToReceive = 1;
+    /* Find the ranges of blocks to request from the block bitmap. */
+    numRanges = _httpFindMissingRanges( fileContext );
 
-    /* Calculate ranges. */
-    rangeStart = _httpDownloader.currBlock * OTA_FILE_BLOCK_SIZE;
-
-    if( fileContext->ulBlocksRemaining == 1 )
+    if( numRanges == 0 )
     {
-        rangeEnd = fileContext->ulFileSize - 1;
+        IotLogError( "No block is missing in the block bitmap." );
+        status = kOTA_Err_HTTPRequestFailed;
+        OTA_GOTO_CLEANUP();
     }
-    else
+
+    /* The callbacks of the first range request can be invoked before the next one is sent, so count
+     * all of them as in flight first. */
+    _httpDownloader.rangesInFlight = numRanges;
+
+    for( numSent = 0; numSent < numRanges; numSent++ )
     {
-        rangeEnd = rangeStart + OTA_FILE_BLOCK_SIZE - 1;
-    }
+        pRange = &_httpDownloader.httpRanges[ numSent ];
 
-    _httpDownloader.currBlockSize = rangeEnd - rangeStart + 1;
+        /* Calculate ranges. */
+        rangeStart = pRange->httpCallbackData.firstBlock * OTA_FILE_BLOCK_SIZE;
+        rangeEnd = rangeStart + ( pRange->httpCallbackData.numBlocks * OTA_FILE_BLOCK_SIZE ) - 1;
 
-    /* Creating the "range" field in HTTP header. */
-    numWritten = snprintf( _httpDownloader.httpCallbackData.pRangeValueStr,
-                           HTTP_HEADER_RANGE_VALUE_MAX_LEN,
-                           "bytes=%u-%u",
-                           ( unsigned int ) rangeStart,
-                           ( unsigned int ) rangeEnd );
+        if( rangeEnd >= fileContext->ulFileSize )
+        {
+            rangeEnd = fileContext->ulFileSize - 1;
+        }
 
-    if( ( numWritten < 0 ) || ( numWritten >= HTTP_HEADER_RANGE_VALUE_MAX_LEN ) )
-    {
-        IotLogError( "Fail to write the \"Range\" value for HTTP header." );
-        status = kOTA_Err_HTTPRequestFailed;
-        OTA_GOTO_CLEANUP();
+        pRange->httpCallbackData.rangeSize = rangeEnd - rangeStart + 1;
+        pRange->httpCallbackData.currBlock = pRange->httpCallbackData.firstBlock;
+        pRange->httpCallbackData.currBlockLen = 0;
+        pRange->httpCallbackData.err = OTA_HTTP_ERR_NONE;
+
+        /* Creating the "range" field in HTTP header. */
+        numWritten = snprintf( pRange->httpCallbackData.pRangeValueStr,
+                               HTTP_HEADER_RANGE_VALUE_MAX_LEN,
+                               "bytes=%u-%u",
+                               ( unsigned int ) rangeStart,
+                               ( unsigned int ) rangeEnd );
+
+        if( ( numWritten < 0 ) || ( numWritten >= HTTP_HEADER_RANGE_VALUE_MAX_LEN ) )
+        {
+            IotLogError( "Fail to write the \"Range\" value for HTTP header." );
+            status = kOTA_Err_HTTPRequestFailed;
+            break;
+        }
+
+        /* Re-initialize the request handle as it could be changed when handling last response. */
+        httpsStatus = IotHttpsClient_InitializeRequest( &pRange->httpRequest.requestHandle, &pRange->httpRequest.requestConfig );
+
+        if( httpsStatus != IOT_HTTPS_OK )
+        {
+            IotLogError( "Fail to initialize the HTTP request. Error code: %d.", httpsStatus );
+            status = kOTA_Err_HTTPRequestFailed;
+            break;
+        }
+
+        /* Send the request asynchronously. Receiving is handled in a callback. */
+        IotLogInfo( "Sending HTTP request to download blocks %d-%d.",
+                    pRange->httpCallbackData.firstBlock,
+                    pRange->httpCallbackData.firstBlock + pRange->httpCallbackData.numBlocks - 1U );
+        httpsStatus = IotHttpsClient_SendAsync( pConnection->connectionHandle,
+                                                pRange->httpRequest.requestHandle,
+                                                &pRange->httpResponse.responseHandle,
+                                                &pRange->httpResponse.responseConfig );
+
+        if( httpsStatus != IOT_HTTPS_OK )
+        {
+            IotLogError( "Fail to send the HTTP request asynchronously. Error code: %d.", httpsStatus );
+            status = kOTA_Err_HTTPRequestFailed;
+            break;
+        }
+
+        numBlocksSent += pRange->httpCallbackData.numBlocks;
     }
 
-    /* Re-initialize the request handle as it could be changed when handling last response. */
-    httpsStatus = IotHttpsClient_InitializeRequest( &pRequest->requestHandle, &pRequest->requestConfig );
+    /* The OTA agent requests the next blocks after it receives all the blocks requested. */
+    pAgentCtx->ulNumOfBlocksToReceive = numBlocksSent;
 
-    if( httpsStatus != IOT_HTTPS_OK )
+    /* The range requests that are not sent will not be completed by the HTTP client. Search the
+     * bitmap from the first of them next time. */
+    if( numSent < numRanges )
     {
-        IotLogError( "Fail to initialize the HTTP request. Error code: %d.", httpsStatus );
-        status = kOTA_Err_HTTPRequestFailed;
-        OTA_GOTO_CLEANUP();
-    }
+        _httpDownloader.currBlock = _httpDownloader.httpRanges[ numSent ].httpCallbackData.firstBlock;
 
-    /* Send the request asynchronously. Receiving is handled in a callback. */
-    IotLogInfo( "Sending HTTP request to download block %d.", _httpDownloader.currBlock );
-    httpsStatus = IotHttpsClient_SendAsync( pConnection->connectionHandle,
-                                            pRequest->requestHandle,
-                                            &pResponse->responseHandle,
-                                            &pResponse->responseConfig );
+        for( ; numSent < numRanges; numSent++ )
+        {
+            if( _httpRangeCompleted() )
+            {
+                _httpDownloader.state = OTA_HTTP_IDLE;
+            }
+        }
+    }
 
-    if( httpsStatus != IOT_HTTPS_OK )
+    /* Some of the requests are sent, the blocks of the others will be requested again. */
+    if( numBlocksSent > 0U )
     {
-        IotLogError( "Fail to send the HTTP request asynchronously. Error code: %d.", httpsStatus );
-        status = kOTA_Err_HTTPRequestFailed;
-        OTA_GOTO_CLEANUP();
+        status = kOTA_Err_None;
     }
 
     OTA_FUNCTION_CLEANUP_BEGIN();
@@ -1153,20 +1586,29 @@ OTA_Err_t _AwsIotOTA_DecodeFileBlock_HTTP( uint8_t * pMessageBuffer,
 {
     IotLogDebug( "Invoking _AwsIotOTA_DecodeFileBlock_HTTP" );
 
-    /* Unused parameters. */
-    ( void ) messageSize;
+    /* Return status. */
+    OTA_Err_t status = kOTA_Err_None;
 
-    *pPayload = pMessageBuffer;
-    *pFileId = 0;
-    *pBlockId = _httpDownloader.currBlock;
-    *pBlockSize = _httpDownloader.currBlockSize;
-    *pPayloadSize = _httpDownloader.currBlockSize;
+    /* Index of the block, put in front of the block data by _httpProcessResponseBody. */
+    uint32_t blockIndex = 0;
+
+    if( messageSize <= HTTP_BLOCK_HEADER_SIZE )
+    {
+        IotLogError( "File block message is too small: %d bytes.", messageSize );
+        status = kOTA_Err_GenericIngestError;
+    }
+    else
+    {
+        memcpy( &blockIndex, pMessageBuffer, HTTP_BLOCK_HEADER_SIZE );
 
-    /* Current block is processed, set the file block to next one and the state to idle. */
-    _httpDownloader.state = OTA_HTTP_IDLE;
-    _httpDownloader.currBlock += 1;
+        *pPayload = pMessageBuffer + HTTP_BLOCK_HEADER_SIZE;
+        *pFileId = 0;
+        *pBlockId = ( int32_t ) blockIndex;
+        *pBlockSize = ( int32_t ) ( messageSize - HTTP_BLOCK_HEADER_SIZE );
+        *pPayloadSize = messageSize - HTTP_BLOCK_HEADER_SIZE;
+    }
 
-    return kOTA_Err_None;
+    return status;
 }
 
 
@@ -1174,12 +1616,35 @@ OTA_Err_t _AwsIotOTA_Cleanup_HTTP( OTA_AgentContext_t * pAgentCtx )
 {
     IotLogDebug( "Invoking _AwsIotOTA_Cleanup_HTTP" );
 
+    /* HTTP connection data, kept if the connection pool cannot be destroyed. */
+    _httpConnection_t connection;
+
     /* Unused parameters. */
     ( void ) pAgentCtx;
 
-    memset( &_httpDownloader, 0, sizeof( _httpDownloader_t ) );
+    if( _httpDestroyConnectionPool() )
+    {
+        memset( &_httpDownloader, 0, sizeof( _httpDownloader_t ) );
+
+        _httpFreeBuffers();
+    }
+    else
+    {
+        /* Keep the pool, its buffers and the handles to it, so that the next file uses them again
+         * and a later cleanup retries to close them. */
+        connection = _httpDownloader.httpConnection;
+        memset( &_httpDownloader, 0, sizeof( _httpDownloader_t ) );
+        _httpDownloader.httpConnection = connection;
 
-    _httpFreeBuffers();
+        IotLogWarn( "HTTP buffers are kept, the connection pool in them is still in use." );
+    }
 
     return kOTA_Err_None;
 }
+
+/*-----------------------------------------------------------*/
+
+/* Provide access to private members for testing. */
+#ifdef AMAZON_FREERTOS_ENABLE_UNIT_TESTS
+    #include "aws_ota_http_test_access_define.h"
+#endif
@@ -30,6 +30,20 @@
 #include "aws_iot_ota_agent.h"
 #include "aws_iot_ota_agent_internal.h"
 
+/* Maximum number of file blocks requested with one HTTP range request. The blocks are passed to the
+ * OTA agent one at a time as they are received, so this does not change the size of any buffer. */
+#ifndef otaconfigHTTP_MAX_BLOCKS_PER_RANGE
+    #define otaconfigHTTP_MAX_BLOCKS_PER_RANGE    16U
+#endif
+
+/* Maximum number of HTTP range requests in flight on the connection. Each one needs its own request
+ * and response user buffer. With more than one, the requests are pipelined on the connection.
+ * These defaults cut the number of requests per file, their effect on the download time has not
+ * been measured against a real server. */
+#ifndef otaconfigHTTP_MAX_RANGES_IN_FLIGHT
+    #define otaconfigHTTP_MAX_RANGES_IN_FLIGHT    2U
+#endif
+
 
 OTA_Err_t _AwsIotOTA_InitFileTransfer_HTTP( OTA_AgentContext_t * pxAgentCtx );
 
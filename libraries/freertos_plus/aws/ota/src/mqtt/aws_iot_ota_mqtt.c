@@ -40,6 +40,7 @@
 #include "aws_iot_ota_agent_internal.h"
 #include "aws_application_version.h"
 #include "aws_iot_ota_cbor.h"
+#include "aws_iot_ota_mqtt.h"
 
 /* General constants. */
 #define OTA_SUBSCRIBE_WAIT_MS          30000UL
@@ -103,6 +104,18 @@ const char * pcOTA_JobStatus_Strings[ eNumJobStatusMappings ] =
  */
 const char * pcOTA_JobReason_Strings[ eNumJobReasons ] = { "", "ready", "active", "accepted", "rejected", "aborted" };
 
+/* Window of data blocks requested from the stream service. */
+typedef struct
+{
+    uint16_t usOutstandingBlocks[ otaconfigMAX_NUM_BLOCKS_WINDOW ]; /* Blocks requested but not received yet, in the order they are sent. */
+    uint32_t ulNumOutstanding;                                      /* Number of entries in usOutstandingBlocks. */
+    uint8_t ucRequestBitmap[ OTA_MAX_BLOCK_BITMAP_SIZE ];           /* Blocks offered in the next get stream request. */
+    uint32_t ulWindowSize;                                          /* Number of blocks allowed to be outstanding. */
+    uint32_t ulNumOfDuplicateBlocks;                                /* Agent duplicate block count at the last request. */
+} OTA_BlockWindow_t;
+
+static OTA_BlockWindow_t xBlockWindow;
+
 /* Queue MQTT callback event for processing. */
 
 static void prvSendCallbackEvent( void * pvCallbackContext,
@@ -119,6 +132,30 @@ static void prvJobPublishCallback( void * pvCallbackContext,
 static void prvDataPublishCallback( void * pvCallbackContext,
                                     IotMqttCallbackParam_t * const pxPublishData );
 
+/* Forget the requested blocks that were received or lost since the last request and adapt the window. */
+
+static void prvUpdateBlockWindow( const OTA_AgentContext_t * pxAgentCtx,
+                                  const OTA_FileContext_t * C );
+
+/* Build the bitmap of blocks to request next and return how many of them the service will send. */
+
+static uint32_t prvBuildRequestBitmap( const OTA_FileContext_t * C,
+                                       uint32_t ulBitmapLen,
+                                       uint32_t ulMaxBlocks );
+
+/* Add the first blocks of the request bitmap to the outstanding blocks. */
+
+static void prvMarkRequestedBlocks( uint32_t ulBitmapLen,
+                                    uint32_t ulNumBlocks );
+
+/* Publish a get stream request for blocks of the current file. */
+
+static OTA_Err_t prvPublishGetStreamRequest( const OTA_AgentContext_t * pxAgentCtx,
+                                             const OTA_FileContext_t * C,
+                                             uint8_t * pucBitmap,
+                                             uint32_t ulBitmapLen,
+                                             uint32_t ulNumBlocks );
+
 /* Subscribe to the jobs notification topic (i.e. New file version available). */
 
 static bool_t prvSubscribeToJobNotificationTopics( const OTA_AgentContext_t * pxAgentCtx );
@@ -728,6 +765,11 @@ OTA_Err_t prvInitFileTransfer_Mqtt( OTA_AgentContext_t * pxAgentCtx )
         {
             OTA_LOG_L1( "[%s] OK: %s\n\r", OTA_METHOD_NAME, xOTAUpdateDataSubscription.pTopicFilter );
             xResult = kOTA_Err_None;
+
+            /* Start the new file with an empty window of one request. */
+            memset( &xBlockWindow, 0, sizeof( xBlockWindow ) );
+            xBlockWindow.ulWindowSize = otaconfigMAX_NUM_BLOCKS_REQUEST;
+            xBlockWindow.ulNumOfDuplicateBlocks = pxAgentCtx->ulNumOfDuplicateBlocks;
         }
     }
     else
@@ -739,20 +781,233 @@ OTA_Err_t prvInitFileTransfer_Mqtt( OTA_AgentContext_t * pxAgentCtx )
 }
 
 /*
- * Request file block by publishing to the get stream topic.
+ * Forget the requested blocks that were received or lost since the last request and adapt
+ * the window.
  */
-OTA_Err_t prvRequestFileBlock_Mqtt( OTA_AgentContext_t * pxAgentCtx )
+static void prvUpdateBlockWindow( const OTA_AgentContext_t * pxAgentCtx,
+                                  const OTA_FileContext_t * C )
+{
+    DEFINE_OTA_METHOD_NAME( "prvUpdateBlockWindow" );
+
+    uint32_t ulIndex, ulBlock;
+    uint32_t ulNumKept = 0U, ulNumReceived = 0U, ulNumLost = 0U;
+    uint32_t ulLastReceived = 0U;
+    uint32_t ulNumDuplicates = pxAgentCtx->ulNumOfDuplicateBlocks - xBlockWindow.ulNumOfDuplicateBlocks;
+
+    for( ulIndex = 0U; ulIndex < xBlockWindow.ulNumOutstanding; ulIndex++ )
+    {
+        ulBlock = xBlockWindow.usOutstandingBlocks[ ulIndex ];
+
+        if( ( C->pucRxBlockBitmap[ ulBlock >> LOG2_BITS_PER_BYTE ] & ( 1U << ( ulBlock % BITS_PER_BYTE ) ) ) == 0U )
+        {
+            ulLastReceived = ulIndex;
+            ulNumReceived++;
+        }
+    }
+
+    /* The stream service sends the blocks in the order they were requested, so a block requested
+     * before the last one received is lost. If none was received, the agent asks again because the
+     * request timed out and everything outstanding is lost. */
+    for( ulIndex = 0U; ulIndex < xBlockWindow.ulNumOutstanding; ulIndex++ )
+    {
+        ulBlock = xBlockWindow.usOutstandingBlocks[ ulIndex ];
+
+        /* Received blocks are dropped from the window. */
+        if( ( C->pucRxBlockBitmap[ ulBlock >> LOG2_BITS_PER_BYTE ] & ( 1U << ( ulBlock % BITS_PER_BYTE ) ) ) != 0U )
+        {
+            if( ( ulNumReceived == 0U ) || ( ulIndex < ulLastReceived ) )
+            {
+                ulNumLost++;
+            }
+            else
+            {
+                xBlockWindow.usOutstandingBlocks[ ulNumKept ] = ( uint16_t ) ulBlock;
+                ulNumKept++;
+            }
+        }
+    }
+
+    xBlockWindow.ulNumOutstanding = ulNumKept;
+    xBlockWindow.ulNumOfDuplicateBlocks = pxAgentCtx->ulNumOfDuplicateBlocks;
+
+    /* Halve the window on loss or duplicates, otherwise grow it by one request per round trip. */
+    if( ( ulNumLost > 0U ) || ( ulNumDuplicates > 0U ) )
+    {
+        xBlockWindow.ulWindowSize /= 2U;
+
+        if( xBlockWindow.ulWindowSize < otaconfigMAX_NUM_BLOCKS_REQUEST )
+        {
+            xBlockWindow.ulWindowSize = otaconfigMAX_NUM_BLOCKS_REQUEST;
+        }
+
+        OTA_LOG_L1( "[%s] %u lost, %u duplicate blocks. Window is %u blocks.\r\n", OTA_METHOD_NAME,
+                    ulNumLost,
+                    ulNumDuplicates,
+                    xBlockWindow.ulWindowSize );
+    }
+    else if( ulNumReceived > 0U )
+    {
+        xBlockWindow.ulWindowSize += otaconfigMAX_NUM_BLOCKS_REQUEST;
+
+        if( xBlockWindow.ulWindowSize > otaconfigMAX_NUM_BLOCKS_WINDOW )
+        {
+            xBlockWindow.ulWindowSize = otaconfigMAX_NUM_BLOCKS_WINDOW;
+        }
+    }
+    else
+    {
+        /* Nothing was received or lost, keep the window as is. */
+    }
+}
+
+/*
+ * Build the bitmap of missing blocks that are not outstanding. The stream service sends the
+ * first ulMaxBlocks blocks of the bitmap, so return how many of them it will send.
+ */
+static uint32_t prvBuildRequestBitmap( const OTA_FileContext_t * C,
+                                       uint32_t ulBitmapLen,
+                                       uint32_t ulMaxBlocks )
+{
+    uint32_t ulIndex, ulBlock;
+    uint32_t ulNumBlocks = 0U;
+
+    memcpy( xBlockWindow.ucRequestBitmap, C->pucRxBlockBitmap, ulBitmapLen );
+
+    for( ulIndex = 0U; ulIndex < xBlockWindow.ulNumOutstanding; ulIndex++ )
+    {
+        ulBlock = xBlockWindow.usOutstandingBlocks[ ulIndex ];
+        xBlockWindow.ucRequestBitmap[ ulBlock >> LOG2_BITS_PER_BYTE ] &= ( uint8_t ) ~( 1U << ( ulBlock % BITS_PER_BYTE ) );
+    }
+
+    for( ulBlock = 0U; ( ulBlock < ( ulBitmapLen * BITS_PER_BYTE ) ) && ( ulNumBlocks < ulMaxBlocks ); ulBlock++ )
+    {
+        if( ( xBlockWindow.ucRequestBitmap[ ulBlock >> LOG2_BITS_PER_BYTE ] & ( 1U << ( ulBlock % BITS_PER_BYTE ) ) ) != 0U )
+        {
+            ulNumBlocks++;
+        }
+    }
+
+    return ulNumBlocks;
+}
+
+/*
+ * Add the first ulNumBlocks blocks of the request bitmap to the outstanding blocks. They are
+ * sent in ascending order after the blocks already outstanding.
+ */
+static void prvMarkRequestedBlocks( uint32_t ulBitmapLen,
+                                    uint32_t ulNumBlocks )
 {
-    DEFINE_OTA_METHOD_NAME( "prvRequestFileBlock_Mqtt" );
+    uint32_t ulBlock;
+
+    for( ulBlock = 0U; ( ulBlock < ( ulBitmapLen * BITS_PER_BYTE ) ) && ( ulNumBlocks > 0U ); ulBlock++ )
+    {
+        if( ( xBlockWindow.ucRequestBitmap[ ulBlock >> LOG2_BITS_PER_BYTE ] & ( 1U << ( ulBlock % BITS_PER_BYTE ) ) ) != 0U )
+        {
+            xBlockWindow.usOutstandingBlocks[ xBlockWindow.ulNumOutstanding ] = ( uint16_t ) ulBlock;
+            xBlockWindow.ulNumOutstanding++;
+            ulNumBlocks--;
+        }
+    }
+}
+
+/*
+ * Publish a get stream request for the first ulNumBlocks blocks set in pucBitmap.
+ */
+static OTA_Err_t prvPublishGetStreamRequest( const OTA_AgentContext_t * pxAgentCtx,
+                                             const OTA_FileContext_t * C,
+                                             uint8_t * pucBitmap,
+                                             uint32_t ulBitmapLen,
+                                             uint32_t ulNumBlocks )
+{
+    DEFINE_OTA_METHOD_NAME( "prvPublishGetStreamRequest" );
 
     uint32_t ulMsgSizeToPublish;
     size_t xMsgSizeFromStream;
-    uint32_t ulNumBlocks, ulBitmapLen, ulTopicLen;
+    uint32_t ulTopicLen;
     IotMqttError_t eResult;
     OTA_Err_t xErr = kOTA_Err_None;
     char pcMsg[ OTA_REQUEST_MSG_MAX_SIZE ];
     char pcTopicBuffer[ OTA_MAX_TOPIC_LEN ];
 
+    if( pdTRUE == OTA_CBOR_Encode_GetStreamRequestMessage(
+            ( uint8_t * ) pcMsg,
+            sizeof( pcMsg ),
+            &xMsgSizeFromStream,
+            OTA_CLIENT_TOKEN,
+            ( int32_t ) C->ulServerFileID,
+            ( int32_t ) ( OTA_FILE_BLOCK_SIZE & 0x7fffffffUL ), /* Mask to keep lint happy. It's still a constant. */
+            0,
+            pucBitmap,
+            ulBitmapLen,
+            ulNumBlocks ) )
+    {
+        ulMsgSizeToPublish = ( uint32_t ) xMsgSizeFromStream;
+
+        /* Try to build the dynamic data REQUEST topic and subscribe to it. */
+        ulTopicLen = ( uint32_t ) snprintf( pcTopicBuffer, /*lint -e586 Intentionally using snprintf. */
+                                            sizeof( pcTopicBuffer ),
+                                            pcOTA_GetStream_TopicTemplate,
+                                            pxAgentCtx->pcThingName,
+                                            ( const char * ) C->pucStreamName );
+
+        if( ( ulTopicLen > 0U ) && ( ulTopicLen < sizeof( pcTopicBuffer ) ) )
+        {
+            eResult = prvPublishMessage(
+                pxAgentCtx,
+                pcTopicBuffer,
+                ( uint16_t ) ulTopicLen,
+                &pcMsg[ 0 ],
+                ulMsgSizeToPublish,
+                IOT_MQTT_QOS_0 );
+
+            if( eResult != IOT_MQTT_SUCCESS )
+            {
+                OTA_LOG_L1( "[%s] Failed: %s\r\n", OTA_METHOD_NAME, pcTopicBuffer );
+                xErr = kOTA_Err_PublishFailed;
+            }
+            else
+            {
+                OTA_LOG_L1( "[%s] OK: %s\r\n", OTA_METHOD_NAME, pcTopicBuffer );
+            }
+
+            /* Restart the timer regardless if we published the Get Stream Request message
+             * or not.
+             *
+             * If we published the message, then the timer will be used to time
+             * out the OTA not continuing again.
+             *
+             * If we failed to publish the message, then
+             * the timer will be used to retry publishing the message again later.
+             *
+             * In both cases the max momentum, if reached, will be used to stop publishing
+             * the Get Stream Request message. */
+            /*prvStartRequestTimer(C);*/
+        }
+        else
+        {
+            /* 0 should never happen since we supply the format strings. It must be overflow. */
+            OTA_LOG_L1( "[%s] Failed to build stream topic!\r\n", OTA_METHOD_NAME );
+            xErr = kOTA_Err_TopicTooLarge;
+        }
+    }
+    else
+    {
+        OTA_LOG_L1( "[%s] CBOR encode failed.\r\n", OTA_METHOD_NAME );
+        xErr = kOTA_Err_FailedToEncodeCBOR;
+    }
+
+    return xErr;
+}
+
+/*
+ * Request file blocks by publishing to the get stream topic until the window is full.
+ */
+OTA_Err_t prvRequestFileBlock_Mqtt( OTA_AgentContext_t * pxAgentCtx )
+{
+    uint32_t ulNumBlocks, ulBitmapLen;
+    uint32_t ulNumToRequest;
+    OTA_Err_t xErr = kOTA_Err_None;
+
     /*
      * Get the current file context.
      */
@@ -766,72 +1021,49 @@ OTA_Err_t prvRequestFileBlock_Mqtt( OTA_AgentContext_t * pxAgentCtx )
         ulNumBlocks = ( C->ulFileSize + ( OTA_FILE_BLOCK_SIZE - 1U ) ) >> otaconfigLOG2_FILE_BLOCK_SIZE;
         ulBitmapLen = ( ulNumBlocks + ( BITS_PER_BYTE - 1U ) ) >> LOG2_BITS_PER_BYTE;
 
-        if( pdTRUE == OTA_CBOR_Encode_GetStreamRequestMessage(
-                ( uint8_t * ) pcMsg,
-                sizeof( pcMsg ),
-                &xMsgSizeFromStream,
-                OTA_CLIENT_TOKEN,
-                ( int32_t ) C->ulServerFileID,
-                ( int32_t ) ( OTA_FILE_BLOCK_SIZE & 0x7fffffffUL ), /* Mask to keep lint happy. It's still a constant. */
-                0,
-                C->pucRxBlockBitmap,
-                ulBitmapLen,
-                otaconfigMAX_NUM_BLOCKS_REQUEST ) )
+        if( ulBitmapLen > OTA_MAX_BLOCK_BITMAP_SIZE )
         {
-            ulMsgSizeToPublish = ( uint32_t ) xMsgSizeFromStream;
-
-            /* Try to build the dynamic data REQUEST topic and subscribe to it. */
-            ulTopicLen = ( uint32_t ) snprintf( pcTopicBuffer, /*lint -e586 Intentionally using snprintf. */
-                                                sizeof( pcTopicBuffer ),
-                                                pcOTA_GetStream_TopicTemplate,
-                                                pxAgentCtx->pcThingName,
-                                                ( const char * ) C->pucStreamName );
+            /* The request bitmap can't hold this many blocks. Request the first missing ones instead. */
+            xErr = prvPublishGetStreamRequest( pxAgentCtx, C, C->pucRxBlockBitmap, ulBitmapLen, otaconfigMAX_NUM_BLOCKS_REQUEST );
+        }
+        else
+        {
+            prvUpdateBlockWindow( pxAgentCtx, C );
 
-            if( ( ulTopicLen > 0U ) && ( ulTopicLen < sizeof( pcTopicBuffer ) ) )
+            /* Request the missing blocks that are not outstanding yet, one request at a time, until
+             * the window is full. */
+            while( ( xErr == kOTA_Err_None ) && ( xBlockWindow.ulNumOutstanding < xBlockWindow.ulWindowSize ) )
             {
-                eResult = prvPublishMessage(
-                    pxAgentCtx,
-                    pcTopicBuffer,
-                    ( uint16_t ) ulTopicLen,
-                    &pcMsg[ 0 ],
-                    ulMsgSizeToPublish,
-                    IOT_MQTT_QOS_0 );
-
-                if( eResult != IOT_MQTT_SUCCESS )
+                ulNumToRequest = xBlockWindow.ulWindowSize - xBlockWindow.ulNumOutstanding;
+
+                if( ulNumToRequest > otaconfigMAX_NUM_BLOCKS_REQUEST )
                 {
-                    OTA_LOG_L1( "[%s] Failed: %s\r\n", OTA_METHOD_NAME, pcTopicBuffer );
-                    xErr = kOTA_Err_PublishFailed;
+                    ulNumToRequest = otaconfigMAX_NUM_BLOCKS_REQUEST;
                 }
-                else
+
+                ulNumToRequest = prvBuildRequestBitmap( C, ulBitmapLen, ulNumToRequest );
+
+                if( ulNumToRequest == 0U )
                 {
-                    OTA_LOG_L1( "[%s] OK: %s\r\n", OTA_METHOD_NAME, pcTopicBuffer );
+                    /* Every missing block is outstanding already. */
+                    break;
                 }
 
-                /* Restart the timer regardless if we published the Get Stream Request message
-                 * or not.
-                 *
-                 * If we published the message, then the timer will be used to time
-                 * out the OTA not continuing again.
-                 *
-                 * If we failed to publish the message, then
-                 * the timer will be used to retry publishing the message again later.
-                 *
-                 * In both cases the max momentum, if reached, will be used to stop publishing
-                 * the Get Stream Request message. */
-                /*prvStartRequestTimer(C);*/
+                xErr = prvPublishGetStreamRequest( pxAgentCtx, C, xBlockWindow.ucRequestBitmap, ulBitmapLen, ulNumToRequest );
+
+                if( xErr == kOTA_Err_None )
+                {
+                    prvMarkRequestedBlocks( ulBitmapLen, ulNumToRequest );
+                }
             }
-            else
+
+            /* Ask again once a request's worth of blocks has arrived, which frees that much of the
+             * window. */
+            if( ( xBlockWindow.ulNumOutstanding > 0U ) && ( xBlockWindow.ulNumOutstanding < otaconfigMAX_NUM_BLOCKS_REQUEST ) )
             {
-                /* 0 should never happen since we supply the format strings. It must be overflow. */
-                OTA_LOG_L1( "[%s] Failed to build stream topic!\r\n", OTA_METHOD_NAME );
-                xErr = kOTA_Err_TopicTooLarge;
+                pxAgentCtx->ulNumOfBlocksToReceive = xBlockWindow.ulNumOutstanding;
             }
         }
-        else
-        {
-            OTA_LOG_L1( "[%s] CBOR encode failed.\r\n", OTA_METHOD_NAME );
-            xErr = kOTA_Err_FailedToEncodeCBOR;
-        }
     }
 
     return xErr;
@@ -894,3 +1126,10 @@ OTA_Err_t prvCleanup_Mqtt( OTA_AgentContext_t * pxAgentCtx )
 
     return kOTA_Err_None;
 }
+
+/*-----------------------------------------------------------*/
+
+/* Provide access to private members for testing. */
+#ifdef AMAZON_FREERTOS_ENABLE_UNIT_TESTS
+    #include "aws_ota_mqtt_test_access_define.h"
+#endif
@@ -30,6 +30,20 @@
 #include "aws_iot_ota_agent.h"
 #include "aws_iot_ota_agent_internal.h"
 
+/* Maximum number of data blocks outstanding from the stream service. Blocks are still requested
+ * up to otaconfigMAX_NUM_BLOCKS_REQUEST at a time, but a new request is published as soon as the
+ * window has room for it rather than after every block of the previous request has arrived. The
+ * window starts at one request, grows while blocks arrive in order and shrinks on lost or duplicate
+ * blocks. The window is opt-in: the default keeps a single request outstanding, as before. Its
+ * effect on transfer time has not been measured, so measure it on the target before raising this. */
+#ifndef otaconfigMAX_NUM_BLOCKS_WINDOW
+    #define otaconfigMAX_NUM_BLOCKS_WINDOW    otaconfigMAX_NUM_BLOCKS_REQUEST
+#endif
+
+#if ( otaconfigMAX_NUM_BLOCKS_WINDOW < otaconfigMAX_NUM_BLOCKS_REQUEST )
+    #error "otaconfigMAX_NUM_BLOCKS_WINDOW must be at least otaconfigMAX_NUM_BLOCKS_REQUEST."
+#endif
+
 /**
  * @brief Check for available OTA job over MQTT.
  *
@@ -0,0 +1,59 @@
+/*
+ * FreeRTOS OTA V1.1.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_ota_http_test_access_define.h
+ * @brief Function wrappers that access private methods in aws_iot_ota_http.c.
+ *
+ * Needed for testing private functions.
+ */
+
+#ifndef _AWS_OTA_HTTP_TEST_ACCESS_DEFINE_H_
+#define _AWS_OTA_HTTP_TEST_ACCESS_DEFINE_H_
+
+/*-----------------------------------------------------------*/
+
+uint32_t TEST_OTA_httpFindMissingRanges( const OTA_FileContext_t * C,
+                                         uint32_t * pulCurrBlock,
+                                         uint32_t * pulFirstBlock,
+                                         uint32_t * pulNumBlocks )
+{
+    uint32_t ulNumRanges = 0;
+    uint32_t ulRange = 0;
+
+    _httpDownloader.currBlock = *pulCurrBlock;
+    ulNumRanges = _httpFindMissingRanges( C );
+    *pulCurrBlock = _httpDownloader.currBlock;
+
+    for( ulRange = 0; ulRange < ulNumRanges; ulRange++ )
+    {
+        pulFirstBlock[ ulRange ] = _httpDownloader.httpRanges[ ulRange ].httpCallbackData.firstBlock;
+        pulNumBlocks[ ulRange ] = _httpDownloader.httpRanges[ ulRange ].httpCallbackData.numBlocks;
+    }
+
+    return ulNumRanges;
+}
+
+#endif /* _AWS_OTA_HTTP_TEST_ACCESS_DEFINE_H_ */
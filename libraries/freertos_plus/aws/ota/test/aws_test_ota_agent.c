@@ -42,6 +42,15 @@
 #include "aws_iot_ota_agent.h"
 #include "aws_clientcredential.h"
 #include "aws_iot_ota_agent_internal.h"
+#include "aws_iot_ota_interface.h"
+
+/* The data transfers are only built when they are enabled. */
+#if ( configENABLED_DATA_PROTOCOLS & OTA_DATA_OVER_MQTT )
+    #include "aws_ota_mqtt_test_access_declare.h"
+#endif
+#if ( configENABLED_DATA_PROTOCOLS & OTA_DATA_OVER_HTTP )
+    #include "aws_ota_http_test_access_declare.h"
+#endif
 
 /* Test network header include. */
 #include IOT_TEST_NETWORK_HEADER
@@ -227,6 +236,13 @@ TEST_GROUP_RUNNER( Full_OTA_AGENT )
     RUN_TEST_CASE( Full_OTA_AGENT, OTA_GetStatistics_BeforeInit );
     RUN_TEST_CASE( Full_OTA_AGENT, prvParseJobDocFromJSONandPrvOTA_Close );
     RUN_TEST_CASE( Full_OTA_AGENT, prvParseJSONbyModel_Errors );
+    #if ( configENABLED_DATA_PROTOCOLS & OTA_DATA_OVER_MQTT )
+        RUN_TEST_CASE( Full_OTA_AGENT, prvUpdateBlockWindow_LossAndGrowth );
+        RUN_TEST_CASE( Full_OTA_AGENT, prvBuildRequestBitmap_SkipOutstanding );
+    #endif
+    #if ( configENABLED_DATA_PROTOCOLS & OTA_DATA_OVER_HTTP )
+        RUN_TEST_CASE( Full_OTA_AGENT, httpFindMissingRanges );
+    #endif
 }
 
 TEST( Full_OTA_AGENT, OTA_SetImageState_AbortBeforeInit )
@@ -486,3 +502,219 @@ TEST( Full_OTA_AGENT, prvParseJSONbyModel_Errors )
     /* Shut down the OTA Agent. */
     ( void ) OTA_AgentShutdown( otatestSHUTDOWN_WAIT );
 }
+
+#if ( configENABLED_DATA_PROTOCOLS & OTA_DATA_OVER_MQTT )
+
+/* Window size after it grew by one request from otaconfigMAX_NUM_BLOCKS_REQUEST blocks. */
+    #define otatestWINDOW_GROWN                                                        \
+    ( ( ( 2U * otaconfigMAX_NUM_BLOCKS_REQUEST ) < otaconfigMAX_NUM_BLOCKS_WINDOW ) ? \
+      ( 2U * otaconfigMAX_NUM_BLOCKS_REQUEST ) : otaconfigMAX_NUM_BLOCKS_WINDOW )
+
+/* Window size after it was halved from otaconfigMAX_NUM_BLOCKS_WINDOW blocks. */
+    #define otatestWINDOW_HALVED                                                        \
+    ( ( ( otaconfigMAX_NUM_BLOCKS_WINDOW / 2U ) > otaconfigMAX_NUM_BLOCKS_REQUEST ) ? \
+      ( otaconfigMAX_NUM_BLOCKS_WINDOW / 2U ) : otaconfigMAX_NUM_BLOCKS_REQUEST )
+
+/**
+ * @brief Mark a block as received or missing in the block bitmap.
+ */
+    static void prvSetBlockMissing( uint8_t * pucBitmap,
+                                    uint32_t ulBlock,
+                                    bool_t xMissing )
+    {
+        if( xMissing == pdTRUE )
+        {
+            pucBitmap[ ulBlock >> LOG2_BITS_PER_BYTE ] |= ( uint8_t ) ( 1U << ( ulBlock % BITS_PER_BYTE ) );
+        }
+        else
+        {
+            pucBitmap[ ulBlock >> LOG2_BITS_PER_BYTE ] &= ( uint8_t ) ~( 1U << ( ulBlock % BITS_PER_BYTE ) );
+        }
+    }
+
+    TEST( Full_OTA_AGENT, prvUpdateBlockWindow_LossAndGrowth )
+    {
+        static OTA_AgentContext_t xAgent;
+        uint8_t ucBitmap[ 4 ];
+        OTA_FileContext_t xFile = { 0 };
+        uint16_t usOutstanding[ otaconfigMAX_NUM_BLOCKS_WINDOW ] = { 0 };
+        uint32_t ulWindowSize = 0;
+
+        memset( &xAgent, 0, sizeof( xAgent ) );
+        memset( ucBitmap, 0xff, sizeof( ucBitmap ) );
+        xFile.pucRxBlockBitmap = ucBitmap;
+
+        /* Every outstanding block arrived, the window grows by one request up to its maximum. */
+        usOutstanding[ 0 ] = 0;
+        usOutstanding[ 1 ] = 1;
+        prvSetBlockMissing( ucBitmap, 0, pdFALSE );
+        prvSetBlockMissing( ucBitmap, 1, pdFALSE );
+        TEST_OTA_SetBlockWindow( usOutstanding, 2, otaconfigMAX_NUM_BLOCKS_REQUEST, 0 );
+        TEST_OTA_prvUpdateBlockWindow( &xAgent, &xFile );
+        TEST_ASSERT_EQUAL_UINT32( 0, TEST_OTA_GetBlockWindow( usOutstanding, &ulWindowSize ) );
+        TEST_ASSERT_EQUAL_UINT32( otatestWINDOW_GROWN, ulWindowSize );
+
+        TEST_OTA_SetBlockWindow( usOutstanding, 2, otaconfigMAX_NUM_BLOCKS_WINDOW, 0 );
+        TEST_OTA_prvUpdateBlockWindow( &xAgent, &xFile );
+        TEST_ASSERT_EQUAL_UINT32( 0, TEST_OTA_GetBlockWindow( usOutstanding, &ulWindowSize ) );
+        TEST_ASSERT_EQUAL_UINT32( otaconfigMAX_NUM_BLOCKS_WINDOW, ulWindowSize );
+
+        /* Blocks 2 to 5 are outstanding and only 3 arrived. Block 2 was sent before it so it is
+         * lost, blocks 4 and 5 may still arrive and stay outstanding. */
+        usOutstanding[ 0 ] = 2;
+        usOutstanding[ 1 ] = 3;
+        usOutstanding[ 2 ] = 4;
+        usOutstanding[ 3 ] = 5;
+        prvSetBlockMissing( ucBitmap, 3, pdFALSE );
+        TEST_OTA_SetBlockWindow( usOutstanding, 4, otaconfigMAX_NUM_BLOCKS_WINDOW, 0 );
+        TEST_OTA_prvUpdateBlockWindow( &xAgent, &xFile );
+        TEST_ASSERT_EQUAL_UINT32( 2, TEST_OTA_GetBlockWindow( usOutstanding, &ulWindowSize ) );
+        TEST_ASSERT_EQUAL_UINT32( 4, usOutstanding[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT32( 5, usOutstanding[ 1 ] );
+        TEST_ASSERT_EQUAL_UINT32( otatestWINDOW_HALVED, ulWindowSize );
+
+        /* Nothing arrived before the request timed out, so blocks 4 and 5 are lost too. The window
+         * does not shrink below one request. */
+        TEST_OTA_SetBlockWindow( usOutstanding, 2, otaconfigMAX_NUM_BLOCKS_REQUEST, 0 );
+        TEST_OTA_prvUpdateBlockWindow( &xAgent, &xFile );
+        TEST_ASSERT_EQUAL_UINT32( 0, TEST_OTA_GetBlockWindow( usOutstanding, &ulWindowSize ) );
+        TEST_ASSERT_EQUAL_UINT32( otaconfigMAX_NUM_BLOCKS_REQUEST, ulWindowSize );
+
+        /* Duplicate blocks received since the last request shrink the window even though every
+         * outstanding block arrived. */
+        usOutstanding[ 0 ] = 4;
+        prvSetBlockMissing( ucBitmap, 4, pdFALSE );
+        xAgent.ulNumOfDuplicateBlocks = 5;
+        TEST_OTA_SetBlockWindow( usOutstanding, 1, otaconfigMAX_NUM_BLOCKS_WINDOW, 2 );
+        TEST_OTA_prvUpdateBlockWindow( &xAgent, &xFile );
+        TEST_ASSERT_EQUAL_UINT32( 0, TEST_OTA_GetBlockWindow( usOutstanding, &ulWindowSize ) );
+        TEST_ASSERT_EQUAL_UINT32( otatestWINDOW_HALVED, ulWindowSize );
+
+        /* The duplicates are only counted once, and the window is kept when nothing was
+         * outstanding. */
+        TEST_OTA_prvUpdateBlockWindow( &xAgent, &xFile );
+        TEST_ASSERT_EQUAL_UINT32( 0, TEST_OTA_GetBlockWindow( usOutstanding, &ulWindowSize ) );
+        TEST_ASSERT_EQUAL_UINT32( otatestWINDOW_HALVED, ulWindowSize );
+    }
+
+    TEST( Full_OTA_AGENT, prvBuildRequestBitmap_SkipOutstanding )
+    {
+        uint8_t ucBitmap[ 4 ] = { 0 };
+        uint8_t ucRequestBitmap[ 4 ] = { 0 };
+        OTA_FileContext_t xFile = { 0 };
+        uint16_t usOutstanding[ 2 ] = { 2, 3 };
+        uint32_t ulBlock;
+
+        xFile.pucRxBlockBitmap = ucBitmap;
+
+        /* Blocks 0 to 9 and 20 are missing, blocks 2 and 3 are requested already. */
+        for( ulBlock = 0; ulBlock < 10U; ulBlock++ )
+        {
+            prvSetBlockMissing( ucBitmap, ulBlock, pdTRUE );
+        }
+
+        prvSetBlockMissing( ucBitmap, 20, pdTRUE );
+        TEST_OTA_SetBlockWindow( usOutstanding, 2, otaconfigMAX_NUM_BLOCKS_WINDOW, 0 );
+
+        /* The outstanding blocks are not requested again and the count is limited to ulMaxBlocks. */
+        TEST_ASSERT_EQUAL_UINT32( 5, TEST_OTA_prvBuildRequestBitmap( &xFile, sizeof( ucBitmap ), 5, ucRequestBitmap ) );
+        TEST_ASSERT_EQUAL_UINT8( 0xf3, ucRequestBitmap[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT8( 0x03, ucRequestBitmap[ 1 ] );
+        TEST_ASSERT_EQUAL_UINT8( 0x10, ucRequestBitmap[ 2 ] );
+        TEST_ASSERT_EQUAL_UINT8( 0x00, ucRequestBitmap[ 3 ] );
+
+        /* Every other missing block is counted when ulMaxBlocks allows it. */
+        TEST_ASSERT_EQUAL_UINT32( 9, TEST_OTA_prvBuildRequestBitmap( &xFile, sizeof( ucBitmap ), 32, ucRequestBitmap ) );
+
+        /* The file's block bitmap is left untouched. */
+        TEST_ASSERT_EQUAL_UINT8( 0xff, ucBitmap[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT8( 0x03, ucBitmap[ 1 ] );
+    }
+
+#endif /* if ( configENABLED_DATA_PROTOCOLS & OTA_DATA_OVER_MQTT ) */
+
+#if ( configENABLED_DATA_PROTOCOLS & OTA_DATA_OVER_HTTP )
+
+/**
+ * @brief Mark ulCount blocks from ulFirst as not received in the block bitmap.
+ */
+    static void prvSetBlocksMissing( uint8_t * pucBitmap,
+                                     uint32_t ulFirst,
+                                     uint32_t ulCount )
+    {
+        uint32_t ulBlock;
+
+        for( ulBlock = ulFirst; ulBlock < ( ulFirst + ulCount ); ulBlock++ )
+        {
+            pucBitmap[ ulBlock >> LOG2_BITS_PER_BYTE ] |= ( uint8_t ) ( 1U << ( ulBlock % BITS_PER_BYTE ) );
+        }
+    }
+
+    TEST( Full_OTA_AGENT, httpFindMissingRanges )
+    {
+        /* Bitmap of the largest file below, plus a byte to check that no block past the end of the
+         * file is requested. */
+        uint8_t ucBitmap[ ( ( otaconfigHTTP_MAX_BLOCKS_PER_RANGE + 2U + BITS_PER_BYTE - 1U ) / BITS_PER_BYTE ) + 1U ];
+        OTA_FileContext_t xFile = { 0 };
+        uint32_t ulFirstBlock[ otaconfigHTTP_MAX_RANGES_IN_FLIGHT ] = { 0 };
+        uint32_t ulNumBlocks[ otaconfigHTTP_MAX_RANGES_IN_FLIGHT ] = { 0 };
+        uint32_t ulCurrBlock = 0;
+
+        /* The cases below look for two ranges of at least two blocks. */
+        TEST_ASSERT_TRUE( otaconfigHTTP_MAX_RANGES_IN_FLIGHT >= 2U );
+        TEST_ASSERT_TRUE( otaconfigHTTP_MAX_BLOCKS_PER_RANGE >= 2U );
+
+        xFile.pucRxBlockBitmap = ucBitmap;
+
+        /* A file of 10 blocks with a gap of received blocks between the missing ones. */
+        xFile.ulFileSize = 10U * OTA_FILE_BLOCK_SIZE;
+        memset( ucBitmap, 0, sizeof( ucBitmap ) );
+        prvSetBlocksMissing( ucBitmap, 1, 2 );
+        prvSetBlocksMissing( ucBitmap, 5, 1 );
+        ulCurrBlock = 0;
+        TEST_ASSERT_EQUAL_UINT32( 2, TEST_OTA_httpFindMissingRanges( &xFile, &ulCurrBlock, ulFirstBlock, ulNumBlocks ) );
+        TEST_ASSERT_EQUAL_UINT32( 1, ulFirstBlock[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT32( 2, ulNumBlocks[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT32( 5, ulFirstBlock[ 1 ] );
+        TEST_ASSERT_EQUAL_UINT32( 1, ulNumBlocks[ 1 ] );
+
+        /* Missing blocks at the end and the start of the file are found by wrapping around from the
+         * last requested block, but a single range never wraps around. */
+        memset( ucBitmap, 0, sizeof( ucBitmap ) );
+        prvSetBlocksMissing( ucBitmap, 0, 2 );
+        prvSetBlocksMissing( ucBitmap, 8, 2 );
+        ulCurrBlock = 8;
+        TEST_ASSERT_EQUAL_UINT32( 2, TEST_OTA_httpFindMissingRanges( &xFile, &ulCurrBlock, ulFirstBlock, ulNumBlocks ) );
+        TEST_ASSERT_EQUAL_UINT32( 8, ulFirstBlock[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT32( 2, ulNumBlocks[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT32( 0, ulFirstBlock[ 1 ] );
+        TEST_ASSERT_EQUAL_UINT32( 2, ulNumBlocks[ 1 ] );
+
+        /* The search starts over if the last requested block is past the end of the file. */
+        memset( ucBitmap, 0, sizeof( ucBitmap ) );
+        prvSetBlocksMissing( ucBitmap, 3, 1 );
+        ulCurrBlock = 40;
+        TEST_ASSERT_EQUAL_UINT32( 1, TEST_OTA_httpFindMissingRanges( &xFile, &ulCurrBlock, ulFirstBlock, ulNumBlocks ) );
+        TEST_ASSERT_EQUAL_UINT32( 3, ulFirstBlock[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT32( 1, ulNumBlocks[ 0 ] );
+
+        /* Nothing is requested once every block is received, and the search position is kept. */
+        memset( ucBitmap, 0, sizeof( ucBitmap ) );
+        ulCurrBlock = 4;
+        TEST_ASSERT_EQUAL_UINT32( 0, TEST_OTA_httpFindMissingRanges( &xFile, &ulCurrBlock, ulFirstBlock, ulNumBlocks ) );
+        TEST_ASSERT_EQUAL_UINT32( 4, ulCurrBlock );
+
+        /* A file with a short last block, with every block missing. The first range is limited to
+         * otaconfigHTTP_MAX_BLOCKS_PER_RANGE blocks, the second one ends with the short last block and
+         * the bits past it in the bitmap are ignored. */
+        xFile.ulFileSize = ( ( otaconfigHTTP_MAX_BLOCKS_PER_RANGE + 1U ) * OTA_FILE_BLOCK_SIZE ) + 1U;
+        memset( ucBitmap, 0xff, sizeof( ucBitmap ) );
+        ulCurrBlock = 0;
+        TEST_ASSERT_EQUAL_UINT32( 2, TEST_OTA_httpFindMissingRanges( &xFile, &ulCurrBlock, ulFirstBlock, ulNumBlocks ) );
+        TEST_ASSERT_EQUAL_UINT32( 0, ulFirstBlock[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT32( otaconfigHTTP_MAX_BLOCKS_PER_RANGE, ulNumBlocks[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT32( otaconfigHTTP_MAX_BLOCKS_PER_RANGE, ulFirstBlock[ 1 ] );
+        TEST_ASSERT_EQUAL_UINT32( 2, ulNumBlocks[ 1 ] );
+    }
+
+#endif /* if ( configENABLED_DATA_PROTOCOLS & OTA_DATA_OVER_HTTP ) */
@@ -143,11 +143,62 @@ from the FreeRTOSIPConfig.h configuration header file. */
 		#define	ipconfigTCP_WIN_SEG_COUNT		( 256 )
 	#endif
 
+	#ifndef ipconfigTCP_DELAYED_ACK_SEGMENTS
+		/* Only used when ipconfigUSE_TCP_WIN is 1.  When non-zero, in-order
+		data segments are acknowledged together: the delayed ACK is sent as
+		soon as this number of segments has been received without being
+		acknowledged, instead of waiting for the delayed-ACK timer.  A value of
+		2 follows RFC 1122.  Higher values send fewer ACKs during a burst of
+		received segments.  Must be lower than 256.  When 0, delayed ACKs are
+		only sent when the timer expires. */
+		#define ipconfigTCP_DELAYED_ACK_SEGMENTS	( 0 )
+	#endif
+
+	#if( ipconfigTCP_DELAYED_ACK_SEGMENTS > 255 )
+		/* The count is kept in the uint8_t 'ucDelayedAckCount'. */
+		#error ipconfigTCP_DELAYED_ACK_SEGMENTS must be lower than 256
+	#endif
+
 	#ifndef ipconfigIGNORE_UNKNOWN_PACKETS
 		/* When non-zero, TCP will not send RST packets in reply to
 		TCP packets which are unknown, or out-of-order. */
 		#define ipconfigIGNORE_UNKNOWN_PACKETS	( 0 )
 	#endif
+
+	#ifndef ipconfigTCP_LARGE_SEND
+		/* When non-zero, new data segments that follow each other are taken
+		from the TX stream together, up to ipconfigTCP_LARGE_SEND_SEGMENTS of
+		them, and sent as one large segment.  The headers are prepared once,
+		for the first frame.  The frames that follow copy those headers and
+		take their payload directly from the TX stream.  Requires
+		ipconfigUSE_TCP_WIN. */
+		#define ipconfigTCP_LARGE_SEND			( 0 )
+	#endif
+
+	#ifndef ipconfigTCP_LARGE_SEND_SEGMENTS
+		#define ipconfigTCP_LARGE_SEND_SEGMENTS	( 4 )
+	#endif
+
+	#ifndef ipconfigTCP_LARGE_SEND_OFFLOAD
+		/* When non-zero, the network interface can segment TCP packets itself
+		(TSO): large segments are passed whole to
+		xNetworkInterfaceOutputLarge(), which must be provided by the driver.
+		The driver also calculates the checksums of each frame.  Requires
+		ipconfigTCP_LARGE_SEND, and network buffers of a variable size, as with
+		BufferAllocation_2.c.  With fixed-size buffers, segments are sent one at
+		a time. */
+		#define ipconfigTCP_LARGE_SEND_OFFLOAD	( 0 )
+	#endif
+
+	#if( ipconfigTCP_LARGE_SEND != 0 )
+		#if( ipconfigUSE_TCP_WIN == 0 )
+			#error ipconfigTCP_LARGE_SEND requires ipconfigUSE_TCP_WIN
+		#endif
+	#endif
+
+	#if( ( ipconfigTCP_LARGE_SEND_OFFLOAD != 0 ) && ( ipconfigTCP_LARGE_SEND == 0 ) )
+		#error ipconfigTCP_LARGE_SEND_OFFLOAD requires ipconfigTCP_LARGE_SEND
+	#endif
 #endif
 
 /*
@@ -289,6 +340,19 @@ from the FreeRTOSIPConfig.h configuration header file. */
 	#define ipconfigMAX_ARP_AGE			150u
 #endif
 
+/* When ipconfigUSE_ARP_CACHE_HASH is 1, the ARP cache is indexed by IP address
+and by MAC address in ipconfigARP_CACHE_HASH_SIZE buckets, the last destination
+that was looked up is checked first, and the entries are aged with a timer
+wheel instead of visiting each of them at every ARP timer event.  This is useful
+when ipconfigARP_CACHE_ENTRIES is large.  It must be less than 65535. */
+#ifndef ipconfigUSE_ARP_CACHE_HASH
+	#define ipconfigUSE_ARP_CACHE_HASH		0
+#endif
+
+#ifndef ipconfigARP_CACHE_HASH_SIZE
+	#define ipconfigARP_CACHE_HASH_SIZE		ipconfigARP_CACHE_ENTRIES
+#endif
+
 #ifndef ipconfigUSE_ARP_REVERSED_LOOKUP
 	#define ipconfigUSE_ARP_REVERSED_LOOKUP		0
 #endif
@@ -413,6 +477,28 @@ from the FreeRTOSIPConfig.h configuration header file. */
 	#ifndef ipconfigDNS_CACHE_ENTRIES
 		#define ipconfigDNS_CACHE_ENTRIES			1
 	#endif
+
+	/* Number of buckets in the hash table that indexes the DNS cache by
+	name.  Each bucket heads a short chain of cache entries, so look-ups do
+	not have to compare the name of every entry. */
+	#ifndef ipconfigDNS_CACHE_HASH_SIZE
+		#define ipconfigDNS_CACHE_HASH_SIZE			ipconfigDNS_CACHE_ENTRIES
+	#endif
+
+	/* The number of IPv4 addresses that are remembered for a single name.
+	When a DNS reply carries several A records, FreeRTOS_dnslookup() will
+	hand them out in a round-robin way. */
+	#ifndef ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY
+		#define ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY	1
+	#endif
+
+	/* When non-zero, a name that could not be resolved (NXDOMAIN, or no reply
+	after ipconfigDNS_REQUEST_ATTEMPTS) is stored in the cache as a negative
+	entry for this many seconds.  During that time FreeRTOS_gethostbyname()
+	returns 0 immediately instead of querying the DNS server again. */
+	#ifndef ipconfigDNS_CACHE_NEGATIVE_TTL_S
+		#define ipconfigDNS_CACHE_NEGATIVE_TTL_S	0
+	#endif
 #endif /* ipconfigUSE_DNS_CACHE != 0 */
 
 #ifndef ipconfigCHECK_IP_QUEUE_SPACE
@@ -496,6 +582,18 @@ from the FreeRTOSIPConfig.h configuration header file. */
 	#define ipconfigZERO_COPY_RX_DRIVER		( 0 )
 #endif
 
+#ifndef ipconfigUSE_LINKED_RX_MESSAGES
+	/* When non-zero, a driver may pass a chain of received packets, linked
+	through 'pxNextBuffer', to the IP-task in a single eNetworkRxEvent.  The
+	IP-task will process the whole chain before it reads the next event from
+	its queue.  This saves one queue message per chained packet; the packets
+	themselves are still processed one by one.  Sending still posts one event
+	per buffer, so ipconfigEVENT_QUEUE_LENGTH must still cover all network
+	buffers.  Drivers that do not chain packets must set 'pxNextBuffer' to
+	NULL, which BufferAllocation_[12].c already do. */
+	#define ipconfigUSE_LINKED_RX_MESSAGES	( 0 )
+#endif
+
 #ifndef ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM
 	#define ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM 0
 #endif
@@ -504,6 +602,24 @@ from the FreeRTOSIPConfig.h configuration header file. */
 	#define ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM 0
 #endif
 
+#ifndef ipconfigUSE_64BIT_CHECKSUM
+	/* When set to 1, usGenerateChecksum() adds 32-bit words into a 64-bit
+	accumulator, which needs no carry counting in the inner loop.  This is
+	meant for 64-bit CPUs and for 32-bit CPUs that have an add-with-carry
+	instruction; measure it with the usGenerateChecksum test before enabling
+	it on a target. */
+	#define ipconfigUSE_64BIT_CHECKSUM	0
+#endif
+
+#ifndef ipconfigUSE_SIMD_CHECKSUM
+	/* When set to 1 together with ipconfigUSE_64BIT_CHECKSUM, the bulk of the
+	checksum is calculated with SSE2 or NEON instructions, if the compiler
+	targets either of them (__SSE2__ or __ARM_NEON).  Otherwise the 64-bit
+	loop is used.  The NEON variant has not yet been built with an ARM
+	compiler. */
+	#define ipconfigUSE_SIMD_CHECKSUM	0
+#endif
+
 #ifndef ipconfigDHCP_REGISTER_HOSTNAME
 	#define ipconfigDHCP_REGISTER_HOSTNAME 0
 #endif
@@ -547,6 +663,34 @@ connections, hang protection can help reduce the impact of SYN floods. */
 	#define ipconfigTCP_HANG_PROTECTION_TIME 30
 #endif
 
+/* When ipconfigUSE_TCP_SOCKET_HASH is 1, incoming TCP segments are matched with
+their socket through two hash tables, one for listening sockets and one for all
+other bound sockets, in stead of walking through xBoundTCPSocketsList.  This
+saves time when there are many TCP connections, at the cost of two tables of
+ipconfigTCP_SOCKET_HASH_SIZE lists each. */
+#ifndef ipconfigUSE_TCP_SOCKET_HASH
+	#define ipconfigUSE_TCP_SOCKET_HASH	0
+#endif
+
+#ifndef ipconfigTCP_SOCKET_HASH_SIZE
+	#define ipconfigTCP_SOCKET_HASH_SIZE	16
+#endif
+
+/* When ipconfigUSE_TCP_WIN_SEGMENT_INDEX is 1, the TCP sliding windows find
+their segments by sequence number through a hash table of
+ipconfigTCP_WIN_SEGMENT_HASH_SIZE lists, shared by all sockets, and reception
+segments are kept sorted on sequence number.  This is meant to save time when
+many segments are outstanding, for instance while recovering from packet loss
+with large windows; it has not been measured on a target yet.  Every segment
+descriptor grows by one list item. */
+#ifndef ipconfigUSE_TCP_WIN_SEGMENT_INDEX
+	#define ipconfigUSE_TCP_WIN_SEGMENT_INDEX	0
+#endif
+
+#ifndef ipconfigTCP_WIN_SEGMENT_HASH_SIZE
+	#define ipconfigTCP_WIN_SEGMENT_HASH_SIZE	64
+#endif
+
 #ifndef ipconfigTCP_IP_SANITY
 	#define ipconfigTCP_IP_SANITY 0
 #endif
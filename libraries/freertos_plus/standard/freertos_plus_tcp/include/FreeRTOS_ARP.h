@@ -45,6 +45,15 @@ typedef struct xARP_CACHE_TABLE_ROW
 	MACAddress_t xMACAddress;  /* The MAC address of an ARP cache entry. */
 	uint8_t ucAge;				/* A value that is periodically decremented but can also be refreshed by active communication.  The ARP cache entry is removed if the value reaches zero. */
     uint8_t ucValid;			/* pdTRUE: xMACAddress is valid, pdFALSE: waiting for ARP reply */
+#if( ipconfigUSE_ARP_CACHE_HASH != 0 )
+	uint8_t ucInUse;			/* pdTRUE when the row holds an entry, pdFALSE when it is on the free list. */
+	uint16_t usNextByIP;		/* Index + 1 of the next row in the same IP hash bucket or in the free list, 0 ends the list. */
+	uint16_t usNextByMAC;		/* Index + 1 of the next row in the same MAC hash bucket. */
+	uint16_t usTimerNext;		/* Index + 1 of the next and previous row in the same slot of the ageing wheel. */
+	uint16_t usTimerPrev;
+	uint8_t ucTimerSlot;		/* The slot of the ageing wheel that holds this row. */
+	uint32_t ulAgeTick;			/* Value of the ARP tick counter when ucAge was set.  ucAge is not decremented, the current age is derived from it. */
+#endif
 } ARPCacheRow_t;
 
 typedef enum
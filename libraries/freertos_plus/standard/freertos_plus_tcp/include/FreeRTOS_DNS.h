@@ -103,6 +103,11 @@ uint32_t ulDNSHandlePacket( NetworkBufferDescriptor_t *pxNetworkBuffer );
 	/*
 	 * Asynchronous version of gethostbyname()
 	 * xTimeout is in units of ms.
+	 * When a callback is given, the query is sent through a socket that is
+	 * shared by all asynchronous look-ups and the function returns without
+	 * waiting.  The callback is called from the IP-task, with the address or
+	 * with zero when the name can not be resolved within xTimeout, so it must
+	 * not block.  Several look-ups may be in progress at the same time.
 	 */
 	uint32_t FreeRTOS_gethostbyname_a( const char *pcHostName, FOnDNSEvent pCallback, void *pvSearchID, TickType_t xTimeout );
 	void FreeRTOS_gethostbyname_cancel( void *pvSearchID );
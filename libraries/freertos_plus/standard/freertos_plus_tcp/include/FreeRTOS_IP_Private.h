@@ -255,6 +255,7 @@ typedef enum
 	eSocketCloseEvent,		/*10: Send a message to the IP-task to close a socket. */
 	eSocketSelectEvent,		/*11: Send a message to the IP-task for select(). */
 	eSocketSignalEvent,		/*12: A socket must be signalled. */
+	eSocketHashEvent,		/*13: A TCP socket must be moved to another hash table bucket. */
 } eIPEvent_t;
 
 typedef struct IP_TASK_COMMANDS
@@ -436,6 +437,14 @@ eFrameProcessingResult_t eConsiderFrameForProcessing( const uint8_t * const pucE
  */
 uint16_t usGenerateChecksum( uint32_t ulSum, const uint8_t * pucNextData, size_t uxDataLengthBytes );
 
+/*
+ * Update a checksum after a 16-bit or 32-bit field of the data has been
+ * changed from usOldValue/ulOldValue into usNewValue/ulNewValue (RFC 1624).
+ * All values are in network byte order, as found in the packet.
+ */
+uint16_t usIncrementalChecksum16( uint16_t usChecksum, uint16_t usOldValue, uint16_t usNewValue );
+uint16_t usIncrementalChecksum32( uint16_t usChecksum, uint32_t ulOldValue, uint32_t ulNewValue );
+
 /* Socket related private functions. */
 
 /* 
@@ -553,6 +562,9 @@ BaseType_t xIPIsNetworkTaskReady( void );
 		#if( ipconfigTCP_HANG_PROTECTION == 1 )
 			TickType_t xLastActTime;
 		#endif /* ipconfigTCP_HANG_PROTECTION */
+		#if( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+			ListItem_t xHashListItem;	/* Used to reference the socket from a TCP socket hash table */
+		#endif /* ipconfigUSE_TCP_SOCKET_HASH */
 		size_t uxLittleSpace;
 		size_t uxEnoughSpace;
 		size_t uxRxStreamSize;
@@ -561,7 +573,14 @@ BaseType_t xIPIsNetworkTaskReady( void );
 		StreamBuffer_t *txStream;
 		#if( ipconfigUSE_TCP_WIN == 1 )
 			NetworkBufferDescriptor_t *pxAckMessage;
+			#if( ipconfigTCP_DELAYED_ACK_SEGMENTS > 0 )
+				uint8_t ucDelayedAckCount;	/* Number of data segments received since the last ACK was sent */
+			#endif /* ipconfigTCP_DELAYED_ACK_SEGMENTS */
 		#endif /* ipconfigUSE_TCP_WIN */
+		#if( ( ipconfigTCP_LARGE_SEND != 0 ) && ( ipconfigTCP_LARGE_SEND_OFFLOAD == 0 ) )
+			size_t uxLargeSendOffset;	/* Offset from the tail of txStream of the data that follows the first frame of a large send */
+			size_t uxLargeSendLength;	/* Length of that data, or 0 when no large send is pending */
+		#endif /* ipconfigTCP_LARGE_SEND */
 		/* Buffer space to store the last TCP header received. */
 		LastTCPPacket_t xPacket;
 		uint8_t tcpflags;		/* TCP flags */
@@ -662,6 +681,16 @@ typedef struct xSOCKET
 	 */
 	FreeRTOS_Socket_t *pxTCPSocketLookup( uint32_t ulLocalIP, UBaseType_t uxLocalPort, uint32_t ulRemoteIP, UBaseType_t uxRemotePort );
 
+	#if( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+		/*
+		 * Move a TCP socket to the hash table bucket that matches its current
+		 * state, local port and remote address, or take it out of the hash
+		 * tables when it is not bound.  Must be called by the IP-task only,
+		 * other tasks send an eSocketHashEvent.
+		 */
+		void vTCPSocketHashUpdate( FreeRTOS_Socket_t *pxSocket );
+	#endif /* ipconfigUSE_TCP_SOCKET_HASH */
+
 #endif /* ipconfigUSE_TCP */
 
 /*
@@ -802,6 +831,10 @@ void vIPReloadDHCPTimer( uint32_t ulLeaseTime );
 #if( ipconfigDNS_USE_CALLBACKS != 0 )
 	void vIPReloadDNSTimer( uint32_t ulCheckTime );
 	void vIPSetDnsTimerEnableState( BaseType_t xEnableState );
+
+	/* Returns pdTRUE if xSocket is the socket shared by asynchronous DNS
+	look-ups.  Its packets are passed to ulDNSHandlePacket() by the IP-task. */
+	BaseType_t xIsDNSSocket( Socket_t xSocket );
 #endif
 
 /* Send the network-up event and start the ARP timer. */
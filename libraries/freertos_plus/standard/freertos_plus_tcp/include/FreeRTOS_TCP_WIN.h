@@ -65,6 +65,9 @@ typedef struct xTCP_SEGMENT
 #if( ipconfigUSE_TCP_WIN != 0 )
 	struct xLIST_ITEM xQueueItem;	/* TX only: segments can be linked in one of three queues: xPriorityQueue, xTxQueue, and xWaitQueue */
 	struct xLIST_ITEM xListItem;	/* With this item the segment can be connected to a list, depending on who is owning it */
+	#if( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+		struct xLIST_ITEM xIndexItem;	/* Links the segment in a bucket of the segment index, while it is in use */
+	#endif
 #endif
 } TCPSegment_t;
 
@@ -125,7 +128,8 @@ typedef struct xTCP_WINDOW
 	TCPSegment_t *pxHeadSegment;		/* points to a segment which has not been transmitted and it's size is still growing (user data being added) */
 	uint32_t ulOptionsData[ipSIZE_TCP_OPTIONS/sizeof(uint32_t)];	/* Contains the options we send out */
 	List_t xTxSegments;					/* A linked list of all transmission segments, sorted on sequence number */
-	List_t xRxSegments;					/* A linked list of reception segments, order depends on sequence of arrival */
+	List_t xRxSegments;					/* A linked list of reception segments, order depends on sequence of arrival,
+										 * or sorted on sequence number when ipconfigUSE_TCP_WIN_SEGMENT_INDEX is 1 */
 #else
 	/* For tiny TCP, there is only 1 outstanding TX segment */
 	TCPSegment_t xTxSegment;			/* Priority queue */
@@ -199,6 +203,18 @@ BaseType_t xTCPWindowTxDone( TCPWindow_t *pxWindow );
  * apPos will point to a location with the circular data buffer: txStream */
 uint32_t ulTCPWindowTxGet( TCPWindow_t *pxWindow, uint32_t ulWindowSize, int32_t *plPosition );
 
+#if( ipconfigTCP_LARGE_SEND != 0 )
+	/* Fetches the next new segment, only when it directly follows the data
+	 * fetched so far and it is not longer than ulMaxLength.  Unlike
+	 * ulTCPWindowTxGet(), 'ulOurSequenceNumber' is not changed: it keeps the
+	 * sequence number of the first segment of a large send. */
+	uint32_t ulTCPWindowTxGetNext( TCPWindow_t *pxWindow, uint32_t ulWindowSize, uint32_t ulMaxLength, int32_t *plPosition );
+
+	/* Segments of a large send, from sequence number ulFirst onwards, have not
+	 * been sent: queue them to be sent with priority. */
+	void vTCPWindowTxRequeue( TCPWindow_t *pxWindow, uint32_t ulFirst );
+#endif
+
 /* Receive a normal ACK */
 uint32_t ulTCPWindowTxAck( TCPWindow_t *pxWindow, uint32_t ulSequenceNumber );
 
@@ -45,6 +45,20 @@ UBaseType_t uxGetNumberOfFreeNetworkBuffers( void );
 /* Get the lowest number of free network buffers. */
 UBaseType_t uxGetMinimumFreeNetworkBuffers( void );
 
+/* Statistics of BufferAllocation_3.c: the number of requests that could not
+be served, the number of times a free list update had to be retried because
+of contention, the number of requests that had to wait for a buffer, the sum
+of those waits, and the longest wait. */
+UBaseType_t uxGetNetworkBufferAllocFailures( void );
+UBaseType_t uxGetNetworkBufferAllocRetries( void );
+UBaseType_t uxGetNetworkBufferAllocWaits( void );
+TickType_t xGetNetworkBufferTotalWaitTime( void );
+TickType_t xGetNetworkBufferMaxWaitTime( void );
+
+/* BufferAllocation_3.c: move the free buffers that are cached per core back
+to the shared free lists. */
+void vNetworkBufferFlushCaches( void );
+
 /* Copy a network buffer into a bigger buffer. */
 NetworkBufferDescriptor_t *pxDuplicateNetworkBufferWithDescriptor( NetworkBufferDescriptor_t * const pxNetworkBuffer,
 	size_t uxNewLength);
@@ -36,6 +36,12 @@ BaseType_t xNetworkInterfaceOutput( NetworkBufferDescriptor_t * const pxNetworkB
 void vNetworkInterfaceAllocateRAMToBuffers( NetworkBufferDescriptor_t pxNetworkBuffers[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ] );
 BaseType_t xGetPhyLinkStatus( void );
 
+#if( ipconfigTCP_LARGE_SEND_OFFLOAD != 0 )
+	/* Send a TCP packet that is larger than the MTU: the interface must cut the
+	payload in frames of usMSS bytes, and calculate the checksums. */
+	BaseType_t xNetworkInterfaceOutputLarge( NetworkBufferDescriptor_t * const pxNetworkBuffer, uint16_t usMSS, BaseType_t xReleaseAfterSend );
+#endif
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
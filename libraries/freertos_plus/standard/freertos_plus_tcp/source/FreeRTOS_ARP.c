@@ -185,6 +185,8 @@ uint32_t ulTargetProtocolAddress, ulSenderProtocolAddress;
 }
 /*-----------------------------------------------------------*/
 
+#if( ipconfigUSE_ARP_CACHE_HASH == 0 )
+
 #if( ipconfigUSE_ARP_REMOVE_ENTRY != 0 )
 
 	uint32_t ulARPRemoveCacheEntryByMac( const MACAddress_t * pxMACAddress )
@@ -365,7 +367,9 @@ uint8_t ucMinAgeFound = 0U;
 		return eReturn;
 	}
 #endif /* ipconfigUSE_ARP_REVERSED_LOOKUP */
+/*-----------------------------------------------------------*/
 
+#endif /* ipconfigUSE_ARP_CACHE_HASH == 0 */
 /*-----------------------------------------------------------*/
 
 eARPLookupResult_t eARPGetCacheEntry( uint32_t *pulIPAddress, MACAddress_t * const pxMACAddress )
@@ -458,6 +462,8 @@ uint32_t ulAddressToLookup;
 
 /*-----------------------------------------------------------*/
 
+#if( ipconfigUSE_ARP_CACHE_HASH == 0 )
+
 static eARPLookupResult_t prvCacheLookup( uint32_t ulAddressToLookup, MACAddress_t * const pxMACAddress )
 {
 BaseType_t x;
@@ -490,11 +496,553 @@ eARPLookupResult_t eReturn = eARPCacheMiss;
 }
 /*-----------------------------------------------------------*/
 
+#endif /* ipconfigUSE_ARP_CACHE_HASH == 0 */
+
+#if( ipconfigUSE_ARP_CACHE_HASH != 0 )
+
+/* The ARP cache is indexed by IP address and by MAC address.  Rows are linked
+with 'index + 1' values, zero ends a list.  A row that is not in use is kept in
+a free list, the rows above usARPRowsUsed have never been used.
+
+The ages are not decremented at every ARP timer event.  Each row remembers the
+value of ulARPTick at which ucAge was set, and it is stored in a slot of a timer
+wheel at the tick when it will need attention: an ARP request must be sent or
+the entry expires.  As ucAge can not be larger than 255, no row is scheduled
+further than arpAGE_WHEEL_SLOTS ticks ahead.  A refresh only changes ucAge and
+ulAgeTick, which always postpones the deadline.  When the slot comes up, a row
+that is not due yet is moved to the slot of its new deadline. */
+#define arpAGE_WHEEL_SLOTS		( 256u )
+
+static uint16_t usARPBucketsByIP[ ipconfigARP_CACHE_HASH_SIZE ];
+static uint16_t usARPBucketsByMAC[ ipconfigARP_CACHE_HASH_SIZE ];
+static uint16_t usARPAgeWheel[ arpAGE_WHEEL_SLOTS ];
+static uint16_t usARPFreeList = 0u;
+static uint16_t usARPRowsUsed = 0u;
+
+/* Counts the calls to vARPAgeCache(). */
+static uint32_t ulARPTick = 0ul;
+
+/* Most packets go to the same destination as the previous one, so the row that
+was found last is checked before the hash buckets. */
+static BaseType_t xARPLastEntry = -1;
+
+static BaseType_t prvARPHashIP( uint32_t ulIPAddress )
+{
+uint32_t ulHash;
+
+	/* Multiplicative hashing: the upper bits depend on all bytes of the
+	address. */
+	ulHash = ulIPAddress * 0x9E3779B1ul;
+
+	return ( BaseType_t ) ( ( ulHash >> 16 ) % ( uint32_t ) ipconfigARP_CACHE_HASH_SIZE );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvARPHashMAC( const MACAddress_t * pxMACAddress )
+{
+uint32_t ulHash = 0ul;
+BaseType_t x;
+
+	for( x = 0; x < ( BaseType_t ) ipMAC_ADDRESS_LENGTH_BYTES; x++ )
+	{
+		ulHash = ( ulHash * 31ul ) + pxMACAddress->ucBytes[ x ];
+	}
+	ulHash *= 0x9E3779B1ul;
+
+	return ( BaseType_t ) ( ( ulHash >> 16 ) % ( uint32_t ) ipconfigARP_CACHE_HASH_SIZE );
+}
+/*-----------------------------------------------------------*/
+
+static uint8_t prvARPCurrentAge( const ARPCacheRow_t *pxRow )
+{
+uint32_t ulElapsed = ulARPTick - pxRow->ulAgeTick;
+uint8_t ucAge;
+
+	if( ulElapsed >= ( uint32_t ) pxRow->ucAge )
+	{
+		ucAge = 0u;
+	}
+	else
+	{
+		ucAge = ( uint8_t ) ( pxRow->ucAge - ulElapsed );
+	}
+
+	return ucAge;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvARPDueTick( const ARPCacheRow_t *pxRow )
+{
+uint32_t ulDelay = 1ul;
+
+	/* A valid entry needs attention when its age has ticked down to
+	arpMAX_ARP_AGE_BEFORE_NEW_ARP_REQUEST, any other entry at the next tick. */
+	if( ( pxRow->ucValid != ( uint8_t ) pdFALSE ) && ( pxRow->ucAge > ( uint8_t ) arpMAX_ARP_AGE_BEFORE_NEW_ARP_REQUEST ) )
+	{
+		ulDelay = ( uint32_t ) pxRow->ucAge - ( uint32_t ) arpMAX_ARP_AGE_BEFORE_NEW_ARP_REQUEST;
+	}
+
+	return pxRow->ulAgeTick + ulDelay;
+}
+/*-----------------------------------------------------------*/
+
+static void prvARPSetAge( BaseType_t x, uint8_t ucAge, uint8_t ucValid )
+{
+	xARPCache[ x ].ucAge = ucAge;
+	xARPCache[ x ].ucValid = ucValid;
+	xARPCache[ x ].ulAgeTick = ulARPTick;
+}
+/*-----------------------------------------------------------*/
+
+static void prvARPWheelInsert( BaseType_t x, uint32_t ulTick )
+{
+uint8_t ucSlot = ( uint8_t ) ( ulTick % arpAGE_WHEEL_SLOTS );
+uint16_t usHead = usARPAgeWheel[ ucSlot ];
+
+	xARPCache[ x ].ucTimerSlot = ucSlot;
+	xARPCache[ x ].usTimerPrev = 0u;
+	xARPCache[ x ].usTimerNext = usHead;
+	if( usHead != 0u )
+	{
+		xARPCache[ usHead - 1u ].usTimerPrev = ( uint16_t ) ( x + 1 );
+	}
+	usARPAgeWheel[ ucSlot ] = ( uint16_t ) ( x + 1 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvARPWheelRemove( BaseType_t x )
+{
+uint16_t usNext = xARPCache[ x ].usTimerNext;
+uint16_t usPrev = xARPCache[ x ].usTimerPrev;
+
+	if( usPrev != 0u )
+	{
+		xARPCache[ usPrev - 1u ].usTimerNext = usNext;
+	}
+	else
+	{
+		usARPAgeWheel[ xARPCache[ x ].ucTimerSlot ] = usNext;
+	}
+	if( usNext != 0u )
+	{
+		xARPCache[ usNext - 1u ].usTimerPrev = usPrev;
+	}
+	xARPCache[ x ].usTimerNext = 0u;
+	xARPCache[ x ].usTimerPrev = 0u;
+}
+/*-----------------------------------------------------------*/
+
+static void prvARPLinkIP( BaseType_t x )
+{
+BaseType_t xBucket = prvARPHashIP( xARPCache[ x ].ulIPAddress );
+
+	xARPCache[ x ].usNextByIP = usARPBucketsByIP[ xBucket ];
+	usARPBucketsByIP[ xBucket ] = ( uint16_t ) ( x + 1 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvARPUnlinkIP( BaseType_t x )
+{
+uint16_t *pusLink = &( usARPBucketsByIP[ prvARPHashIP( xARPCache[ x ].ulIPAddress ) ] );
+
+	while( *pusLink != 0u )
+	{
+		if( *pusLink == ( uint16_t ) ( x + 1 ) )
+		{
+			*pusLink = xARPCache[ x ].usNextByIP;
+			break;
+		}
+		pusLink = &( xARPCache[ *pusLink - 1u ].usNextByIP );
+	}
+	xARPCache[ x ].usNextByIP = 0u;
+}
+/*-----------------------------------------------------------*/
+
+static void prvARPLinkMAC( BaseType_t x )
+{
+BaseType_t xBucket = prvARPHashMAC( &( xARPCache[ x ].xMACAddress ) );
+
+	xARPCache[ x ].usNextByMAC = usARPBucketsByMAC[ xBucket ];
+	usARPBucketsByMAC[ xBucket ] = ( uint16_t ) ( x + 1 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvARPUnlinkMAC( BaseType_t x )
+{
+uint16_t *pusLink = &( usARPBucketsByMAC[ prvARPHashMAC( &( xARPCache[ x ].xMACAddress ) ) ] );
+
+	while( *pusLink != 0u )
+	{
+		if( *pusLink == ( uint16_t ) ( x + 1 ) )
+		{
+			*pusLink = xARPCache[ x ].usNextByMAC;
+			break;
+		}
+		pusLink = &( xARPCache[ *pusLink - 1u ].usNextByMAC );
+	}
+	xARPCache[ x ].usNextByMAC = 0u;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvARPFindByIP( uint32_t ulIPAddress )
+{
+uint16_t usEntry = usARPBucketsByIP[ prvARPHashIP( ulIPAddress ) ];
+
+	while( ( usEntry != 0u ) && ( xARPCache[ usEntry - 1u ].ulIPAddress != ulIPAddress ) )
+	{
+		usEntry = xARPCache[ usEntry - 1u ].usNextByIP;
+	}
+
+	return ( BaseType_t ) usEntry - 1;
+}
+/*-----------------------------------------------------------*/
+
+/* Release a row that is in use.  When xInWheel is pdFALSE, the row has already
+been taken from the timer wheel by the caller. */
+static void prvARPReleaseRow( BaseType_t x, BaseType_t xInWheel )
+{
+	prvARPUnlinkIP( x );
+	prvARPUnlinkMAC( x );
+	if( xInWheel != pdFALSE )
+	{
+		prvARPWheelRemove( x );
+	}
+	if( xARPLastEntry == x )
+	{
+		xARPLastEntry = -1;
+	}
+
+	memset( &xARPCache[ x ], '\0', sizeof( xARPCache[ x ] ) );
+	xARPCache[ x ].usNextByIP = usARPFreeList;
+	usARPFreeList = ( uint16_t ) ( x + 1 );
+}
+/*-----------------------------------------------------------*/
+
+/* Get an unused row.  When the table is full, the row with the lowest age is
+evicted, like the linear cache does. */
+static BaseType_t prvARPAllocateRow( void )
+{
+BaseType_t x;
+BaseType_t xOldest = 0;
+uint8_t ucAge, ucMinAgeFound = 0xffu;
+
+	if( ( usARPFreeList == 0u ) && ( usARPRowsUsed < ( uint16_t ) ipconfigARP_CACHE_ENTRIES ) )
+	{
+		x = ( BaseType_t ) usARPRowsUsed;
+		usARPRowsUsed++;
+	}
+	else
+	{
+		if( usARPFreeList == 0u )
+		{
+			/* This only happens when all rows are in use. */
+			for( x = 0; x < ( BaseType_t ) ipconfigARP_CACHE_ENTRIES; x++ )
+			{
+				ucAge = prvARPCurrentAge( &xARPCache[ x ] );
+				if( ucAge < ucMinAgeFound )
+				{
+					ucMinAgeFound = ucAge;
+					xOldest = x;
+				}
+			}
+			prvARPReleaseRow( xOldest, pdTRUE );
+		}
+
+		x = ( BaseType_t ) usARPFreeList - 1;
+		usARPFreeList = xARPCache[ x ].usNextByIP;
+		xARPCache[ x ].usNextByIP = 0u;
+	}
+
+	xARPCache[ x ].ucInUse = ( uint8_t ) pdTRUE;
+
+	return x;
+}
+/*-----------------------------------------------------------*/
+
+static void prvARPAgeWheelTick( void )
+{
+BaseType_t x;
+uint16_t usEntry;
+uint8_t ucSlot, ucAge;
+uint32_t ulDue;
+
+	ulARPTick++;
+	ucSlot = ( uint8_t ) ( ulARPTick % arpAGE_WHEEL_SLOTS );
+
+	/* Detach the list of this slot, each row in it will either be inserted
+	again or released. */
+	usEntry = usARPAgeWheel[ ucSlot ];
+	usARPAgeWheel[ ucSlot ] = 0u;
+
+	while( usEntry != 0u )
+	{
+		x = ( BaseType_t ) usEntry - 1;
+		usEntry = xARPCache[ x ].usTimerNext;
+		xARPCache[ x ].usTimerNext = 0u;
+		xARPCache[ x ].usTimerPrev = 0u;
+
+		ulDue = prvARPDueTick( &xARPCache[ x ] );
+		if( ( int32_t ) ( ulDue - ulARPTick ) > 0 )
+		{
+			/* The entry was refreshed after it was scheduled. */
+			prvARPWheelInsert( x, ulDue );
+			continue;
+		}
+
+		ucAge = prvARPCurrentAge( &xARPCache[ x ] );
+
+		/* If the entry is not yet valid, then it is waiting an ARP reply, and
+		the ARP request should be retransmitted. */
+		if( xARPCache[ x ].ucValid == ( uint8_t ) pdFALSE )
+		{
+			FreeRTOS_OutputARPRequest( xARPCache[ x ].ulIPAddress );
+		}
+		else if( ucAge <= ( uint8_t ) arpMAX_ARP_AGE_BEFORE_NEW_ARP_REQUEST )
+		{
+			/* This entry will get removed soon.  See if the MAC address is
+			still valid to prevent this happening. */
+			iptraceARP_TABLE_ENTRY_WILL_EXPIRE( xARPCache[ x ].ulIPAddress );
+			FreeRTOS_OutputARPRequest( xARPCache[ x ].ulIPAddress );
+		}
+		else
+		{
+			/* The age has just ticked down, with nothing to do. */
+		}
+
+		if( ucAge == 0u )
+		{
+			/* The entry is no longer valid.  Wipe it out. */
+			iptraceARP_TABLE_ENTRY_EXPIRED( xARPCache[ x ].ulIPAddress );
+			prvARPReleaseRow( x, pdFALSE );
+		}
+		else
+		{
+			prvARPWheelInsert( x, ulARPTick + 1ul );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_ARP_REMOVE_ENTRY != 0 )
+
+	uint32_t ulARPRemoveCacheEntryByMac( const MACAddress_t * pxMACAddress )
+	{
+	uint16_t usEntry;
+	uint32_t lResult = 0;
+
+		usEntry = usARPBucketsByMAC[ prvARPHashMAC( pxMACAddress ) ];
+		while( usEntry != 0u )
+		{
+			if( memcmp( xARPCache[ usEntry - 1u ].xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) ) == 0 )
+			{
+				lResult = xARPCache[ usEntry - 1u ].ulIPAddress;
+				prvARPReleaseRow( ( BaseType_t ) usEntry - 1, pdTRUE );
+				break;
+			}
+			usEntry = xARPCache[ usEntry - 1u ].usNextByMAC;
+		}
+
+		return lResult;
+	}
+
+#endif	/* ipconfigUSE_ARP_REMOVE_ENTRY != 0 */
+/*-----------------------------------------------------------*/
+
+void vARPRefreshCacheEntry( const MACAddress_t * pxMACAddress, const uint32_t ulIPAddress )
+{
+BaseType_t xIpEntry;
+BaseType_t xMacEntry = -1;
+BaseType_t xUseEntry;
+uint16_t usEntry;
+
+	#if( ipconfigARP_STORES_REMOTE_ADDRESSES == 0 )
+		/* Only process the IP address if it is on the local network.
+		Unless: when '*ipLOCAL_IP_ADDRESS_POINTER' equals zero, the IP-address
+		and netmask are still unknown. */
+		if( ( ( ulIPAddress & xNetworkAddressing.ulNetMask ) == ( ( *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) ) ||
+			( *ipLOCAL_IP_ADDRESS_POINTER == 0ul ) )
+	#else
+		/* See the comments in the linear version of this function. */
+		if( pdTRUE )
+	#endif
+	{
+		xIpEntry = prvARPFindByIP( ulIPAddress );
+
+		if( xIpEntry >= 0 )
+		{
+			if( pxMACAddress == NULL )
+			{
+				/* There is already an entry, possibly one that is waiting for
+				an ARP reply. */
+				return;
+			}
+
+			if( memcmp( xARPCache[ xIpEntry ].xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) ) == 0 )
+			{
+				/* The most common path: the timer wheel will see the new age
+				when the slot of this row comes up. */
+				prvARPSetAge( xIpEntry, ( uint8_t ) ipconfigMAX_ARP_AGE, ( uint8_t ) pdTRUE );
+				return;
+			}
+		}
+
+		if( pxMACAddress != NULL )
+		{
+			/* Look for an entry with the given MAC-address but a different
+			IP-address. */
+			usEntry = usARPBucketsByMAC[ prvARPHashMAC( pxMACAddress ) ];
+			while( usEntry != 0u )
+			{
+			const ARPCacheRow_t *pxRow = &( xARPCache[ usEntry - 1u ] );
+
+				if( ( pxRow->ulIPAddress != ulIPAddress ) &&
+					( memcmp( pxRow->xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) ) == 0 ) )
+				{
+		#if( ipconfigARP_STORES_REMOTE_ADDRESSES != 0 )
+					/* The MAC address of the gateway should not be overwritten
+					by the address of a remote IP address. */
+					BaseType_t bIsLocal[ 2 ];
+					bIsLocal[ 0 ] = ( ( pxRow->ulIPAddress & xNetworkAddressing.ulNetMask ) == ( ( *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) );
+					bIsLocal[ 1 ] = ( ( ulIPAddress & xNetworkAddressing.ulNetMask ) == ( ( *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) );
+					if( bIsLocal[ 0 ] == bIsLocal[ 1 ] )
+		#endif
+					{
+						xMacEntry = ( BaseType_t ) usEntry - 1;
+						break;
+					}
+				}
+				usEntry = pxRow->usNextByMAC;
+			}
+		}
+
+		if( xMacEntry >= 0 )
+		{
+			xUseEntry = xMacEntry;
+
+			if( xIpEntry >= 0 )
+			{
+				/* Both the MAC address as well as the IP address were found in
+				different rows: clear the row which matches the IP-address. */
+				prvARPReleaseRow( xIpEntry, pdTRUE );
+			}
+
+			prvARPUnlinkIP( xUseEntry );
+			xARPCache[ xUseEntry ].ulIPAddress = ulIPAddress;
+			prvARPLinkIP( xUseEntry );
+		}
+		else if( xIpEntry >= 0 )
+		{
+			/* An entry containing the IP-address was found, but it had a
+			different MAC address. */
+			xUseEntry = xIpEntry;
+			prvARPUnlinkMAC( xUseEntry );
+		}
+		else
+		{
+			xUseEntry = prvARPAllocateRow();
+			xARPCache[ xUseEntry ].ulIPAddress = ulIPAddress;
+			prvARPLinkIP( xUseEntry );
+			if( pxMACAddress == NULL )
+			{
+				/* The MAC address is not known yet, the row is kept in the
+				bucket of the zero address. */
+				prvARPLinkMAC( xUseEntry );
+			}
+		}
+
+		if( pxMACAddress != NULL )
+		{
+			if( xUseEntry != xMacEntry )
+			{
+				memcpy( xARPCache[ xUseEntry ].xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) );
+				prvARPLinkMAC( xUseEntry );
+			}
+
+			iptraceARP_TABLE_ENTRY_CREATED( ulIPAddress, (*pxMACAddress) );
+			/* And this entry does not need immediate attention */
+			prvARPSetAge( xUseEntry, ( uint8_t ) ipconfigMAX_ARP_AGE, ( uint8_t ) pdTRUE );
+		}
+		else
+		{
+			/* An entry is reserved to indicate that there is an outstanding
+			ARP request. */
+			prvARPSetAge( xUseEntry, ( uint8_t ) ipconfigMAX_ARP_RETRANSMISSIONS, ( uint8_t ) pdFALSE );
+		}
+
+		if( ( xMacEntry < 0 ) && ( xIpEntry < 0 ) )
+		{
+			prvARPWheelInsert( xUseEntry, prvARPDueTick( &xARPCache[ xUseEntry ] ) );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_ARP_REVERSED_LOOKUP == 1 )
+	eARPLookupResult_t eARPGetCacheEntryByMac( MACAddress_t * const pxMACAddress, uint32_t *pulIPAddress )
+	{
+	uint16_t usEntry;
+	eARPLookupResult_t eReturn = eARPCacheMiss;
+
+		usEntry = usARPBucketsByMAC[ prvARPHashMAC( pxMACAddress ) ];
+		while( usEntry != 0u )
+		{
+			if( memcmp( pxMACAddress->ucBytes, xARPCache[ usEntry - 1u ].xMACAddress.ucBytes, sizeof( MACAddress_t ) ) == 0 )
+			{
+				*pulIPAddress = xARPCache[ usEntry - 1u ].ulIPAddress;
+				eReturn = eARPCacheHit;
+				break;
+			}
+			usEntry = xARPCache[ usEntry - 1u ].usNextByMAC;
+		}
+
+		return eReturn;
+	}
+#endif /* ipconfigUSE_ARP_REVERSED_LOOKUP */
+/*-----------------------------------------------------------*/
+
+static eARPLookupResult_t prvCacheLookup( uint32_t ulAddressToLookup, MACAddress_t * const pxMACAddress )
+{
+BaseType_t x = xARPLastEntry;
+eARPLookupResult_t eReturn = eARPCacheMiss;
+
+	if( ( x < 0 ) || ( xARPCache[ x ].ulIPAddress != ulAddressToLookup ) )
+	{
+		x = prvARPFindByIP( ulAddressToLookup );
+	}
+
+	if( x >= 0 )
+	{
+		if( xARPCache[ x ].ucValid == ( uint8_t ) pdFALSE )
+		{
+			/* This entry is waiting an ARP reply, so is not valid. */
+			eReturn = eCantSendPacket;
+		}
+		else
+		{
+			/* A valid entry was found. */
+			memcpy( pxMACAddress->ucBytes, xARPCache[ x ].xMACAddress.ucBytes, sizeof( MACAddress_t ) );
+			eReturn = eARPCacheHit;
+			xARPLastEntry = x;
+		}
+	}
+
+	return eReturn;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_ARP_CACHE_HASH */
+
 void vARPAgeCache( void )
 {
+#if( ipconfigUSE_ARP_CACHE_HASH == 0 )
 BaseType_t x;
+#endif
 TickType_t xTimeNow;
 
+#if( ipconfigUSE_ARP_CACHE_HASH != 0 )
+	/* Only the rows in the current slot of the timer wheel are visited. */
+	prvARPAgeWheelTick();
+#else
 	/* Loop through each entry in the ARP cache. */
 	for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
 	{
@@ -531,6 +1079,7 @@ TickType_t xTimeNow;
 			}
 		}
 	}
+#endif /* ipconfigUSE_ARP_CACHE_HASH */
 
 	xTimeNow = xTaskGetTickCount ();
 
@@ -640,6 +1189,17 @@ ARPPacket_t *pxARPPacket;
 void FreeRTOS_ClearARP( void )
 {
 	memset( xARPCache, '\0', sizeof( xARPCache ) );
+
+	#if( ipconfigUSE_ARP_CACHE_HASH != 0 )
+	{
+		memset( usARPBucketsByIP, '\0', sizeof( usARPBucketsByIP ) );
+		memset( usARPBucketsByMAC, '\0', sizeof( usARPBucketsByMAC ) );
+		memset( usARPAgeWheel, '\0', sizeof( usARPAgeWheel ) );
+		usARPFreeList = 0u;
+		usARPRowsUsed = 0u;
+		xARPLastEntry = -1;
+	}
+	#endif /* ipconfigUSE_ARP_CACHE_HASH */
 }
 /*-----------------------------------------------------------*/
 
@@ -648,16 +1208,23 @@ void FreeRTOS_ClearARP( void )
 	void FreeRTOS_PrintARPCache( void )
 	{
 	BaseType_t x, xCount = 0;
+	uint8_t ucAge;
 
 		/* Loop through each entry in the ARP cache. */
 		for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
 		{
-			if( ( xARPCache[ x ].ulIPAddress != 0ul ) && ( xARPCache[ x ].ucAge > 0U ) )
+			#if( ipconfigUSE_ARP_CACHE_HASH != 0 )
+				ucAge = prvARPCurrentAge( &xARPCache[ x ] );
+			#else
+				ucAge = xARPCache[ x ].ucAge;
+			#endif
+
+			if( ( xARPCache[ x ].ulIPAddress != 0ul ) && ( ucAge > 0U ) )
 			{
 				/* See if the MAC-address also matches, and we're all happy */
 				FreeRTOS_printf( ( "Arp %2ld: %3u - %16lxip : %02x:%02x:%02x : %02x:%02x:%02x\n",
 					x,
-					xARPCache[ x ].ucAge,
+					ucAge,
 					xARPCache[ x ].ulIPAddress,
 					xARPCache[ x ].xMACAddress.ucBytes[0],
 					xARPCache[ x ].xMACAddress.ucBytes[1],
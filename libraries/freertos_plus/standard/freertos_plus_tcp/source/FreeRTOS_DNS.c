@@ -52,12 +52,14 @@
 	#define dnsOUTGOING_FLAGS		0x0001u     /* Standard query. */
 	#define dnsRX_FLAGS_MASK		0x0f80u     /* The bits of interest in the flags field of incoming DNS messages. */
 	#define dnsEXPECTED_RX_FLAGS	0x0080u     /* Should be a response, without any errors. */
+	#define dnsNXDOMAIN_RX_FLAGS	0x0380u     /* A response with RCODE 3: the name does not exist. */
 #else
 	#define dnsDNS_PORT				0x0035u
 	#define dnsONE_QUESTION			0x0001u
 	#define dnsOUTGOING_FLAGS		0x0100u     /* Standard query. */
 	#define dnsRX_FLAGS_MASK		0x800fu     /* The bits of interest in the flags field of incoming DNS messages. */
 	#define dnsEXPECTED_RX_FLAGS	0x8000u     /* Should be a response, without any errors. */
+	#define dnsNXDOMAIN_RX_FLAGS	0x8003u     /* A response with RCODE 3: the name does not exist. */
 
 #endif /* ipconfigBYTE_ORDER */
 
@@ -129,8 +131,17 @@ static uint32_t prvParseDNSReply( uint8_t *pucUDPPayloadBuffer,
 								  BaseType_t xExpected );
 
 /*
- * Prepare and send a message to a DNS server.  'uxReadTimeOut_ticks' will be passed as
- * zero, in case the user has supplied a call-back function.
+ * Create a DNS query for 'pcHostName' and send it through 'xDNSSocket', to the
+ * DNS server or, for a name without a dot, to the LLMNR group.  Returns pdTRUE
+ * when the query was handed to the IP-task.
+ */
+static BaseType_t prvSendDNSRequest( Socket_t xDNSSocket,
+									 const char *pcHostName,
+									 TickType_t uxIdentifier,
+									 TickType_t uxBlockTimeTicks );
+
+/*
+ * Prepare and send a message to a DNS server and wait for the reply.
  */
 static uint32_t prvGetHostByName( const char *pcHostName,
 								  TickType_t uxIdentifier,
@@ -159,24 +170,52 @@ static uint32_t prvGetHostByName( const char *pcHostName,
 #endif /* ipconfigUSE_DNS_CACHE || ipconfigDNS_USE_CALLBACKS */
 
 #if( ipconfigUSE_DNS_CACHE == 1 )
-	static void prvProcessDNSCache( const char *pcName,
-									uint32_t *pulIP,
-									uint32_t ulTTL,
-									BaseType_t xLookUp );
+	/*
+	 * Look up ( xLookUp != pdFALSE ) or store a name in the DNS cache.  When
+	 * storing, 'ulTTL' is the time-to-live in seconds, in host byte order, and
+	 * an address of zero stores a negative entry.  'xFirstAddress' is pdTRUE
+	 * when *pulIP is the first address of a new reply: the addresses that were
+	 * cached earlier for the name are then dropped.  A look-up returns pdTRUE
+	 * when a fresh entry was found, which may be a negative one: *pulIP is then
+	 * zero.
+	 */
+	static BaseType_t prvProcessDNSCache( const char *pcName,
+										  uint32_t *pulIP,
+										  uint32_t ulTTL,
+										  BaseType_t xLookUp,
+										  BaseType_t xFirstAddress );
+
+	#if( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 255 )
+		#error ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY must be less than 256
+	#endif
 
 	typedef struct xDNS_CACHE_TABLE_ROW
 	{
-		uint32_t ulIPAddress;                         /* The IP address of an ARP cache entry. */
+		uint32_t ulIPAddresses[ ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY ]; /* The IP addresses found for this name. */
 		char pcName[ ipconfigDNS_CACHE_NAME_LENGTH ]; /* The name of the host */
 		uint32_t ulTTL;                               /* Time-to-Live (in seconds) from the DNS server. */
 		uint32_t ulTimeWhenAddedInSeconds;
+		uint32_t ulHash;                              /* Hash of pcName, compared before calling strcmp(). */
+		uint32_t ulLastUsed;                          /* Value of ulDNSCacheUseCount when last used, for LRU eviction. */
+		uint16_t usNextInBucket;                      /* Index + 1 of the next entry in the same hash bucket, 0 ends the chain. */
+		uint8_t ucNumIPAddresses;                     /* Zero for a negative entry: the name could not be resolved. */
+		uint8_t ucCurrentIPAddress;                   /* The address to be returned by the next look-up. */
 	} DNSCacheRow_t;
 
 	static DNSCacheRow_t xDNSCache[ ipconfigDNS_CACHE_ENTRIES ];
 
+	/* Heads of the hash chains, stored as index + 1 so that a cleared table
+	contains empty chains. */
+	static uint16_t usDNSCacheBuckets[ ipconfigDNS_CACHE_HASH_SIZE ];
+
+	/* Incremented at every use of the cache, to find the least recently used
+	entry. */
+	static uint32_t ulDNSCacheUseCount = 0uL;
+
 	void FreeRTOS_dnsclear()
 	{
 		memset( xDNSCache, 0x0, sizeof( xDNSCache ) );
+		memset( usDNSCacheBuckets, 0x0, sizeof( usDNSCacheBuckets ) );
 	}
 #endif /* ipconfigUSE_DNS_CACHE == 1 */
 
@@ -284,7 +323,7 @@ typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
 	{
 	uint32_t ulIPAddress = 0uL;
 
-		prvProcessDNSCache( pcHostName, &ulIPAddress, 0, pdTRUE );
+		( void ) prvProcessDNSCache( pcHostName, &ulIPAddress, 0, pdTRUE, pdFALSE );
 		return ulIPAddress;
 	}
 #endif /* ipconfigUSE_DNS_CACHE == 1 */
@@ -297,6 +336,9 @@ typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
 		TickType_t uxRemaningTime;		/* Timeout in ms */
 		FOnDNSEvent pCallbackFunction;	/* Function to be called when the address has been found or when a timeout has beeen reached */
 		TimeOut_t uxTimeoutState;
+		TickType_t xResendTime;			/* Ticks until the request is sent again */
+		TimeOut_t xResendState;
+		BaseType_t xAttempts;			/* The number of times the request has been sent */
 		void *pvSearchID;
 		struct xLIST_ITEM xListItem;
 		char pcName[ 1 ];
@@ -304,6 +346,12 @@ typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
 
 	static List_t xCallbackList;
 
+	/* All asynchronous look-ups share this socket.  It stays open, and its
+	replies are parsed by the IP-task as soon as they arrive, see
+	xIsDNSSocket().  The identifier in the reply tells which request it
+	answers. */
+	static Socket_t xDNSAsyncSocket = NULL;
+
 	/* Define FreeRTOS_gethostbyname() as a normal blocking call. */
 	uint32_t FreeRTOS_gethostbyname( const char *pcHostName )
 	{
@@ -316,6 +364,64 @@ typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
 	void vDNSInitialise( void )
 	{
 		vListInitialise( &xCallbackList );
+		xDNSAsyncSocket = NULL;
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xIsDNSSocket( Socket_t xSocket )
+	{
+	BaseType_t xReturn;
+
+		if( ( xDNSAsyncSocket != NULL ) && ( xSocket == xDNSAsyncSocket ) )
+		{
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			xReturn = pdFALSE;
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Return the shared socket for asynchronous look-ups, creating it the
+	first time.  Must be called from a user task, never from the IP-task,
+	because FreeRTOS_bind() waits for the IP-task. */
+	static Socket_t prvGetAsyncDNSSocket( void )
+	{
+	Socket_t xSocket = xDNSAsyncSocket;
+	TickType_t uxWriteTimeOut_ticks = ipconfigDNS_SEND_BLOCK_TIME_TICKS;
+
+		if( xSocket == NULL )
+		{
+			xSocket = prvCreateDNSSocket();
+
+			if( xSocket != NULL )
+			{
+				FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_SNDTIMEO, ( void * ) &uxWriteTimeOut_ticks, sizeof( TickType_t ) );
+
+				taskENTER_CRITICAL();
+				{
+					if( xDNSAsyncSocket == NULL )
+					{
+						xDNSAsyncSocket = xSocket;
+						xSocket = NULL;
+					}
+				}
+				taskEXIT_CRITICAL();
+
+				if( xSocket != NULL )
+				{
+					/* Another task was quicker to create the socket. */
+					FreeRTOS_closesocket( xSocket );
+				}
+			}
+
+			xSocket = xDNSAsyncSocket;
+		}
+
+		return xSocket;
 	}
 	/*-----------------------------------------------------------*/
 
@@ -352,6 +458,18 @@ typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
 					uxListRemove( &pxCallback->xListItem );
 					vPortFree( ( void * ) pxCallback );
 				}
+				else if( ( pvSearchID == NULL ) &&
+						 ( xDNSAsyncSocket != NULL ) &&
+						 ( pxCallback->xAttempts < ipconfigDNS_REQUEST_ATTEMPTS ) &&
+						 ( xTaskCheckForTimeOut( &pxCallback->xResendState, &pxCallback->xResendTime ) != pdFALSE ) )
+				{
+					/* No reply yet, send the request again.  This runs in the
+					IP-task, so the send will not block. */
+					pxCallback->xAttempts++;
+					pxCallback->xResendTime = ipconfigDNS_RECEIVE_BLOCK_TIME_TICKS;
+					vTaskSetTimeOutState( &pxCallback->xResendState );
+					( void ) prvSendDNSRequest( xDNSAsyncSocket, pxCallback->pcName, listGET_LIST_ITEM_VALUE( &( pxCallback->xListItem ) ), 0u );
+				}
 			}
 		}
 		xTaskResumeAll();
@@ -393,8 +511,9 @@ typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
 		{
 			if( listLIST_IS_EMPTY( &xCallbackList ) )
 			{
-				/* This is the first one, start the DNS timer to check for timeouts */
-				vIPReloadDNSTimer( FreeRTOS_min_uint32( 1000U, uxTimeout ) );
+				/* This is the first one, start the DNS timer to check for
+				timeouts and to repeat unanswered requests. */
+				vIPReloadDNSTimer( FreeRTOS_min_uint32( FreeRTOS_min_uint32( 1000U, uxTimeout ), ipconfigDNS_RECEIVE_BLOCK_TIME_TICKS ) );
 			}
 
 			strcpy( pxCallback->pcName, pcHostName );
@@ -402,6 +521,9 @@ typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
 			pxCallback->pvSearchID = pvSearchID;
 			pxCallback->uxRemaningTime = uxTimeout;
 			vTaskSetTimeOutState( &pxCallback->uxTimeoutState );
+			pxCallback->xAttempts = 1;
+			pxCallback->xResendTime = ipconfigDNS_RECEIVE_BLOCK_TIME_TICKS;
+			vTaskSetTimeOutState( &pxCallback->xResendState );
 			listSET_LIST_ITEM_OWNER( &( pxCallback->xListItem ), ( void * ) pxCallback );
 			listSET_LIST_ITEM_VALUE( &( pxCallback->xListItem ), uxIdentifier );
 			vTaskSuspendAll();
@@ -472,6 +594,7 @@ uint32_t ulIPAddress = 0uL;
 TickType_t uxReadTimeOut_ticks = ipconfigDNS_RECEIVE_BLOCK_TIME_TICKS;
 TickType_t uxIdentifier = 0u;
 BaseType_t xHasRandom = pdFALSE;
+BaseType_t xIsNegative = pdFALSE;
 
 	if( pcHostName != NULL )
 	{
@@ -489,11 +612,19 @@ BaseType_t xHasRandom = pdFALSE;
 		{
 			if( ulIPAddress == 0uL )
 			{
-				ulIPAddress = FreeRTOS_dnslookup( pcHostName );
-
-				if( ulIPAddress != 0 )
+				if( prvProcessDNSCache( pcHostName, &ulIPAddress, 0, pdTRUE, pdFALSE ) != pdFALSE )
 				{
-					FreeRTOS_debug_printf( ( "FreeRTOS_gethostbyname: found '%s' in cache: %lxip\n", pcHostName, ulIPAddress ) );
+					if( ulIPAddress != 0 )
+					{
+						FreeRTOS_debug_printf( ( "FreeRTOS_gethostbyname: found '%s' in cache: %lxip\n", pcHostName, ulIPAddress ) );
+					}
+					else
+					{
+						/* The name failed to resolve recently, do not ask
+						the DNS server again until the negative entry has
+						expired. */
+						xIsNegative = pdTRUE;
+					}
 				}
 				else
 				{
@@ -504,7 +635,7 @@ BaseType_t xHasRandom = pdFALSE;
 		#endif /* ipconfigUSE_DNS_CACHE == 1 */
 
 		/* Generate a unique identifier. */
-		if( ulIPAddress == 0uL )
+		if( ( ulIPAddress == 0uL ) && ( xIsNegative == pdFALSE ) )
 		{
 		uint32_t ulNumber;
 
@@ -518,18 +649,18 @@ BaseType_t xHasRandom = pdFALSE;
 		{
 			if( pCallback != NULL )
 			{
-				if( ulIPAddress == 0uL )
+				if( ( ulIPAddress == 0uL ) && ( xIsNegative == pdFALSE ) )
 				{
 					/* The user has provided a callback function, so do not block on recvfrom() */
 					if( xHasRandom != pdFALSE )
 					{
-						uxReadTimeOut_ticks = 0u;
 						vDNSSetCallBack( pcHostName, pvSearchID, pCallback, uxTimeout, uxIdentifier );
 					}
 				}
 				else
 				{
-					/* The IP address is known, do the call-back now. */
+					/* The IP address is known, or the name is known not to
+					resolve: do the call-back now. */
 					pCallback( pcHostName, pvSearchID, ulIPAddress );
 				}
 			}
@@ -538,26 +669,40 @@ BaseType_t xHasRandom = pdFALSE;
 
 		if( ( ulIPAddress == 0uL ) && ( xHasRandom != pdFALSE ) )
 		{
-			ulIPAddress = prvGetHostByName( pcHostName, uxIdentifier, uxReadTimeOut_ticks );
+			#if( ipconfigDNS_USE_CALLBACKS == 1 )
+				if( pCallback != NULL )
+				{
+				Socket_t xSocket = prvGetAsyncDNSSocket();
+
+					/* Send the request through the shared socket and return
+					at once.  The reply will be handled by the IP-task, and
+					vDNSCheckCallBack() repeats the request when needed. */
+					if( xSocket != NULL )
+					{
+						( void ) prvSendDNSRequest( xSocket, pcHostName, uxIdentifier, ipconfigDNS_SEND_BLOCK_TIME_TICKS );
+					}
+				}
+				else
+			#endif /* ipconfigDNS_USE_CALLBACKS == 1 */
+			{
+				ulIPAddress = prvGetHostByName( pcHostName, uxIdentifier, uxReadTimeOut_ticks );
+			}
 		}
 	}
 	return ulIPAddress;
 }
 /*-----------------------------------------------------------*/
 
-static uint32_t prvGetHostByName( const char *pcHostName,
-								  TickType_t uxIdentifier,
-								  TickType_t uxReadTimeOut_ticks )
+static BaseType_t prvSendDNSRequest( Socket_t xDNSSocket,
+									 const char *pcHostName,
+									 TickType_t uxIdentifier,
+									 TickType_t uxBlockTimeTicks )
 {
 struct freertos_sockaddr xAddress;
-Socket_t xDNSSocket;
-uint32_t ulIPAddress = 0uL;
 uint8_t *pucUDPPayloadBuffer;
-uint32_t ulAddressLength = sizeof( struct freertos_sockaddr );
-BaseType_t xAttempt;
-int32_t lBytes;
+uint32_t ulIPAddress = 0uL;
 size_t uxPayloadLength, uxExpectedPayloadLength;
-TickType_t uxWriteTimeOut_ticks = ipconfigDNS_SEND_BLOCK_TIME_TICKS;
+BaseType_t xReturn = pdFALSE;
 
 #if( ipconfigUSE_LLMNR == 1 )
 	BaseType_t bHasDot = pdFALSE;
@@ -584,6 +729,69 @@ TickType_t uxWriteTimeOut_ticks = ipconfigDNS_SEND_BLOCK_TIME_TICKS;
 	subdomain part and the string end byte. */
 	uxExpectedPayloadLength = sizeof( DNSMessage_t ) + strlen( pcHostName ) + sizeof( uint16_t ) + sizeof( uint16_t ) + 2u;
 
+	/* Get a buffer.  The delay will be capped to
+	ipconfigUDP_MAX_SEND_BLOCK_TIME_TICKS so the return value still needs to be
+	tested. */
+	pucUDPPayloadBuffer = ( uint8_t * ) FreeRTOS_GetUDPPayloadBuffer( uxExpectedPayloadLength, uxBlockTimeTicks );
+
+	if( pucUDPPayloadBuffer != NULL )
+	{
+		/* Create the message in the obtained buffer. */
+		uxPayloadLength = prvCreateDNSMessage( pucUDPPayloadBuffer, pcHostName, uxIdentifier );
+
+		iptraceSENDING_DNS_REQUEST();
+
+		/* Obtain the DNS server address. */
+		FreeRTOS_GetAddressConfiguration( NULL, NULL, NULL, &ulIPAddress );
+
+		/* Send the DNS message. */
+#if( ipconfigUSE_LLMNR == 1 )
+		if( bHasDot == pdFALSE )
+		{
+			/* Use LLMNR addressing. */
+			( ( DNSMessage_t * ) pucUDPPayloadBuffer )->usFlags = 0;
+			xAddress.sin_addr = ipLLMNR_IP_ADDR; /* Is in network byte order. */
+			xAddress.sin_port = FreeRTOS_ntohs( ipLLMNR_PORT );
+		}
+		else
+#endif
+		{
+			/* Use DNS server. */
+			xAddress.sin_addr = ulIPAddress;
+			xAddress.sin_port = dnsDNS_PORT;
+		}
+
+		if( FreeRTOS_sendto( xDNSSocket, pucUDPPayloadBuffer, uxPayloadLength, FREERTOS_ZERO_COPY, &xAddress, sizeof( xAddress ) ) != 0 )
+		{
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			/* The message was not sent so the stack will not be
+			releasing the zero copy - it must be released here. */
+			FreeRTOS_ReleaseUDPPayloadBuffer( ( void * ) pucUDPPayloadBuffer );
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvGetHostByName( const char *pcHostName,
+								  TickType_t uxIdentifier,
+								  TickType_t uxReadTimeOut_ticks )
+{
+struct freertos_sockaddr xAddress;
+Socket_t xDNSSocket;
+uint32_t ulIPAddress = 0uL;
+uint8_t *pucUDPPayloadBuffer;
+uint32_t ulAddressLength = sizeof( struct freertos_sockaddr );
+BaseType_t xAttempt;
+int32_t lBytes;
+TickType_t uxWriteTimeOut_ticks = ipconfigDNS_SEND_BLOCK_TIME_TICKS;
+BaseType_t xRequestSent = pdFALSE;
+BaseType_t xNameNotFound = pdFALSE;
+
 	xDNSSocket = prvCreateDNSSocket();
 
 	if( xDNSSocket != NULL )
@@ -593,101 +801,82 @@ TickType_t uxWriteTimeOut_ticks = ipconfigDNS_SEND_BLOCK_TIME_TICKS;
 
 		for( xAttempt = 0; xAttempt < ipconfigDNS_REQUEST_ATTEMPTS; xAttempt++ )
 		{
-			/* Get a buffer.  This uses a maximum delay, but the delay will be
-			capped to ipconfigUDP_MAX_SEND_BLOCK_TIME_TICKS so the return value
-			still needs to be tested. */
-			pucUDPPayloadBuffer = ( uint8_t * ) FreeRTOS_GetUDPPayloadBuffer( uxExpectedPayloadLength, portMAX_DELAY );
-
-			if( pucUDPPayloadBuffer != NULL )
+			/* Send a request.  This uses a maximum delay to get a network
+			buffer, which will be capped to ipconfigUDP_MAX_SEND_BLOCK_TIME_TICKS. */
+			if( prvSendDNSRequest( xDNSSocket, pcHostName, uxIdentifier, portMAX_DELAY ) != pdFALSE )
 			{
-				/* Create the message in the obtained buffer. */
-				uxPayloadLength = prvCreateDNSMessage( pucUDPPayloadBuffer, pcHostName, uxIdentifier );
-
-				iptraceSENDING_DNS_REQUEST();
-
-				/* Obtain the DNS server address. */
-				FreeRTOS_GetAddressConfiguration( NULL, NULL, NULL, &ulIPAddress );
-
-				/* Send the DNS message. */
-#if( ipconfigUSE_LLMNR == 1 )
-				if( bHasDot == pdFALSE )
-				{
-					/* Use LLMNR addressing. */
-					( ( DNSMessage_t * ) pucUDPPayloadBuffer )->usFlags = 0;
-					xAddress.sin_addr = ipLLMNR_IP_ADDR; /* Is in network byte order. */
-					xAddress.sin_port = FreeRTOS_ntohs( ipLLMNR_PORT );
-				}
-				else
-#endif
-				{
-					/* Use DNS server. */
-					xAddress.sin_addr = ulIPAddress;
-					xAddress.sin_port = dnsDNS_PORT;
-				}
+				xRequestSent = pdTRUE;
 
-				ulIPAddress = 0uL;
+				/* Wait for the reply. */
+				lBytes = FreeRTOS_recvfrom( xDNSSocket, &pucUDPPayloadBuffer, 0, FREERTOS_ZERO_COPY, &xAddress, &ulAddressLength );
 
-				if( FreeRTOS_sendto( xDNSSocket, pucUDPPayloadBuffer, uxPayloadLength, FREERTOS_ZERO_COPY, &xAddress, sizeof( xAddress ) ) != 0 )
+				if( lBytes > 0 )
 				{
-					/* Wait for the reply. */
-					lBytes = FreeRTOS_recvfrom( xDNSSocket, &pucUDPPayloadBuffer, 0, FREERTOS_ZERO_COPY, &xAddress, &ulAddressLength );
+				BaseType_t xExpected;
+				DNSMessage_t *pxDNSMessageHeader = ( DNSMessage_t * ) pucUDPPayloadBuffer;
 
-					if( lBytes > 0 )
+					/* See if the identifiers match. */
+					if( uxIdentifier == ( TickType_t ) pxDNSMessageHeader->usIdentifier )
 					{
-					BaseType_t xExpected;
-					DNSMessage_t *pxDNSMessageHeader = ( DNSMessage_t * ) pucUDPPayloadBuffer;
+						xExpected = pdTRUE;
+					}
+					else
+					{
+						/* The reply was not expected. */
+						xExpected = pdFALSE;
+					}
 
-						/* See if the identifiers match. */
-						if( uxIdentifier == ( TickType_t ) pxDNSMessageHeader->usIdentifier )
-						{
-							xExpected = pdTRUE;
-						}
-						else
-						{
-							/* The reply was not expected. */
-							xExpected = pdFALSE;
-						}
+					/* The reply was received.  Process it. */
+				#if( ipconfigDNS_USE_CALLBACKS == 0 )
+					/* It is useless to analyse the unexpected reply
+					unless asynchronous look-ups are enabled. */
+					if( xExpected != pdFALSE )
+				#endif /* ipconfigDNS_USE_CALLBACKS == 0 */
+					{
+						ulIPAddress = prvParseDNSReply( pucUDPPayloadBuffer, ( size_t ) lBytes, xExpected );
+					}
 
-						/* The reply was received.  Process it. */
-					#if( ipconfigDNS_USE_CALLBACKS == 0 )
-						/* It is useless to analyse the unexpected reply
-						unless asynchronous look-ups are enabled. */
-						if( xExpected != pdFALSE )
-					#endif /* ipconfigDNS_USE_CALLBACKS == 0 */
-						{
-							ulIPAddress = prvParseDNSReply( pucUDPPayloadBuffer, ( size_t ) lBytes, xExpected );
-						}
+					if( ( xExpected != pdFALSE ) &&
+						( ( pxDNSMessageHeader->usFlags & dnsRX_FLAGS_MASK ) == dnsNXDOMAIN_RX_FLAGS ) )
+					{
+						/* The server says that the name does not exist,
+						asking again will not change the answer. */
+						xNameNotFound = pdTRUE;
+					}
 
-						/* Finished with the buffer.  The zero copy interface
-						is being used, so the buffer must be freed by the
-						task. */
-						FreeRTOS_ReleaseUDPPayloadBuffer( ( void * ) pucUDPPayloadBuffer );
+					/* Finished with the buffer.  The zero copy interface
+					is being used, so the buffer must be freed by the
+					task. */
+					FreeRTOS_ReleaseUDPPayloadBuffer( ( void * ) pucUDPPayloadBuffer );
 
-						if( ulIPAddress != 0uL )
-						{
-							/* All done. */
-							break;
-						}
+					if( ( ulIPAddress != 0uL ) || ( xNameNotFound != pdFALSE ) )
+					{
+						/* All done. */
+						break;
 					}
 				}
-				else
-				{
-					/* The message was not sent so the stack will not be
-					releasing the zero copy - it must be released here. */
-					FreeRTOS_ReleaseUDPPayloadBuffer( ( void * ) pucUDPPayloadBuffer );
-				}
-			}
-
-			if( uxReadTimeOut_ticks == 0u )
-			{
-				/* This DNS lookup is asynchronous, using a call-back:
-				send the request only once. */
-				break;
 			}
 		}
 
 		/* Finished with the socket. */
 		FreeRTOS_closesocket( xDNSSocket );
+
+		#if( ipconfigUSE_DNS_CACHE == 1 ) && ( ipconfigDNS_CACHE_NEGATIVE_TTL_S != 0 )
+		{
+			/* A blocking look-up that was sent but never answered is
+			remembered as a negative entry.  An NXDOMAIN reply has already
+			been stored by prvParseDNSReply(). */
+			if( ( ulIPAddress == 0uL ) && ( xRequestSent != pdFALSE ) && ( xNameNotFound == pdFALSE ) )
+			{
+				( void ) prvProcessDNSCache( pcHostName, &ulIPAddress, ipconfigDNS_CACHE_NEGATIVE_TTL_S, pdFALSE, pdTRUE );
+			}
+		}
+		#else
+		{
+			/* Avoid compiler warnings. */
+			( void ) xRequestSent;
+		}
+		#endif /* ipconfigUSE_DNS_CACHE && ipconfigDNS_CACHE_NEGATIVE_TTL_S */
 	}
 
 	return ulIPAddress;
@@ -982,6 +1171,9 @@ BaseType_t xDoStore = xExpected;
 #if( ipconfigUSE_DNS_CACHE == 1 ) || ( ipconfigDNS_USE_CALLBACKS == 1 )
 	char pcName[ ipconfigDNS_CACHE_NAME_LENGTH ] = "";
 #endif
+#if( ipconfigUSE_DNS_CACHE == 1 )
+	BaseType_t xFirstAddress = pdTRUE;
+#endif
 
 	/* Ensure that the buffer is of at least minimal DNS message length. */
 	if( uxBufferLength < sizeof( DNSMessage_t ) )
@@ -1100,36 +1292,47 @@ BaseType_t xDoStore = xExpected;
 					/* Sanity check the data length of an IPv4 answer. */
 					if( FreeRTOS_ntohs( pxDNSAnswerRecord->usDataLength ) == sizeof( uint32_t ) )
 					{
+					uint32_t ulAnswerAddress;
+
 						/* Copy the IP address out of the record. */
-						memcpy( &ulIPAddress,
+						memcpy( &ulAnswerAddress,
 								pucByte + sizeof( DNSAnswerRecord_t ),
 								sizeof( uint32_t ) );
 
-						#if( ipconfigDNS_USE_CALLBACKS == 1 )
+						if( ulIPAddress == 0uL )
 						{
-							/* See if any asynchronous call was made to FreeRTOS_gethostbyname_a() */
-							if( xDNSDoCallback( ( TickType_t ) pxDNSMessageHeader->usIdentifier, pcName, ulIPAddress ) != pdFALSE )
+							/* The first A record is the address returned to
+							the caller. */
+							ulIPAddress = ulAnswerAddress;
+
+							#if( ipconfigDNS_USE_CALLBACKS == 1 )
 							{
-								/* This device has requested this DNS look-up.
-								The result may be stored in the DNS cache. */
-								xDoStore = pdTRUE;
+								/* See if any asynchronous call was made to FreeRTOS_gethostbyname_a() */
+								if( xDNSDoCallback( ( TickType_t ) pxDNSMessageHeader->usIdentifier, pcName, ulIPAddress ) != pdFALSE )
+								{
+									/* This device has requested this DNS look-up.
+									The result may be stored in the DNS cache. */
+									xDoStore = pdTRUE;
+								}
 							}
+							#endif /* ipconfigDNS_USE_CALLBACKS == 1 */
 						}
-						#endif /* ipconfigDNS_USE_CALLBACKS == 1 */
+
 						#if( ipconfigUSE_DNS_CACHE == 1 )
 						{
 							/* The reply will only be stored in the DNS cache when the
 							request was issued by this device. */
 							if( xDoStore != pdFALSE )
 							{
-								prvProcessDNSCache( pcName, &ulIPAddress, pxDNSAnswerRecord->ulTTL, pdFALSE );
+								( void ) prvProcessDNSCache( pcName, &ulAnswerAddress, FreeRTOS_ntohl( pxDNSAnswerRecord->ulTTL ), pdFALSE, xFirstAddress );
+								xFirstAddress = pdFALSE;
 							}
 
 							/* Show what has happened. */
 							FreeRTOS_printf( ( "DNS[0x%04X]: The answer to '%s' (%xip) will%s be stored\n",
 											   ( unsigned ) pxDNSMessageHeader->usIdentifier,
 											   pcName,
-											   ( unsigned ) FreeRTOS_ntohl( ulIPAddress ),
+											   ( unsigned ) FreeRTOS_ntohl( ulAnswerAddress ),
 											   ( xDoStore != 0 ) ? "" : " NOT" ) );
 						}
 						#endif /* ipconfigUSE_DNS_CACHE */
@@ -1137,7 +1340,21 @@ BaseType_t xDoStore = xExpected;
 
 					pucByte += sizeof( DNSAnswerRecord_t ) + sizeof( uint32_t );
 					uxSourceBytesRemaining -= ( sizeof( DNSAnswerRecord_t ) + sizeof( uint32_t ) );
-					break;
+
+					#if( ipconfigUSE_DNS_CACHE == 1 ) && ( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 1 )
+					{
+						/* Keep parsing: the following A records are stored in
+						the cache as alternative addresses for this name. */
+						if( ( ulIPAddress == 0uL ) || ( xDoStore == pdFALSE ) )
+						{
+							break;
+						}
+					}
+					#else
+					{
+						break;
+					}
+					#endif
 				}
 				else if( uxSourceBytesRemaining >= sizeof( DNSAnswerRecord_t ) )
 				{
@@ -1165,6 +1382,31 @@ BaseType_t xDoStore = xExpected;
 			}
 		}
 
+#if( ( ipconfigUSE_DNS_CACHE == 1 ) && ( ipconfigDNS_CACHE_NEGATIVE_TTL_S != 0 ) ) || ( ipconfigDNS_USE_CALLBACKS == 1 )
+		else if( ( pxDNSMessageHeader->usFlags & dnsRX_FLAGS_MASK ) == dnsNXDOMAIN_RX_FLAGS )
+		{
+			/* The name does not exist.  Tell an asynchronous caller right
+			away instead of letting its request time out. */
+			#if( ipconfigDNS_USE_CALLBACKS == 1 )
+			{
+				if( xDNSDoCallback( ( TickType_t ) pxDNSMessageHeader->usIdentifier, pcName, 0uL ) != pdFALSE )
+				{
+					xDoStore = pdTRUE;
+				}
+			}
+			#endif /* ipconfigDNS_USE_CALLBACKS == 1 */
+			#if( ipconfigUSE_DNS_CACHE == 1 ) && ( ipconfigDNS_CACHE_NEGATIVE_TTL_S != 0 )
+			{
+				if( ( xDoStore != pdFALSE ) && ( pcName[ 0 ] != 0 ) )
+				{
+					/* Remember the failure, so that reconnect attempts do not
+					query the DNS server for this name again. */
+					( void ) prvProcessDNSCache( pcName, &ulIPAddress, ipconfigDNS_CACHE_NEGATIVE_TTL_S, pdFALSE, pdTRUE );
+				}
+			}
+			#endif /* ipconfigUSE_DNS_CACHE && ipconfigDNS_CACHE_NEGATIVE_TTL_S */
+		}
+#endif /* ipconfigUSE_DNS_CACHE || ipconfigDNS_USE_CALLBACKS */
 #if( ipconfigUSE_LLMNR == 1 )
 		else if( usQuestions && ( usType == dnsTYPE_A_HOST ) && ( usClass == dnsCLASS_IN ) )
 		{
@@ -1312,7 +1554,7 @@ BaseType_t xDoStore = xExpected;
 				{
 					/* If this is a response from another device,
 					add the name to the DNS cache */
-					prvProcessDNSCache( ( char * ) ucNBNSName, &ulIPAddress, 0, pdFALSE );
+					( void ) prvProcessDNSCache( ( char * ) ucNBNSName, &ulIPAddress, 0, pdFALSE, pdTRUE );
 				}
 			}
 			#else
@@ -1463,77 +1705,241 @@ BaseType_t xReturn;
 
 #if( ipconfigUSE_DNS_CACHE == 1 )
 
-	static void prvProcessDNSCache( const char *pcName,
-									uint32_t *pulIP,
-									uint32_t ulTTL,
-									BaseType_t xLookUp )
+	/* Return a hash of a host name (32-bit FNV-1a), used to select a bucket in
+	usDNSCacheBuckets[]. */
+	static uint32_t prvDNSCacheHash( const char *pcName )
+	{
+	uint32_t ulHash = 2166136261uL;
+
+		while( *pcName != '\0' )
+		{
+			ulHash ^= ( uint32_t ) ( uint8_t ) *pcName;
+			ulHash *= 16777619uL;
+			pcName++;
+		}
+
+		return ulHash;
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Return pdTRUE if the entry has not yet outlived its TTL.  The
+	subtraction keeps working when the seconds counter wraps. */
+	static BaseType_t prvDNSCacheIsFresh( const DNSCacheRow_t *pxRow,
+										  uint32_t ulCurrentTimeSeconds )
+	{
+	BaseType_t xResult = pdFALSE;
+
+		if( ( ulCurrentTimeSeconds - pxRow->ulTimeWhenAddedInSeconds ) < pxRow->ulTTL )
+		{
+			xResult = pdTRUE;
+		}
+
+		return xResult;
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Walk the hash chain of 'ulHash' and return the index of the entry that
+	holds 'pcName', or -1 if the name is not cached. */
+	static BaseType_t prvDNSCacheFind( const char *pcName,
+									   uint32_t ulHash )
 	{
-	BaseType_t x;
+	uint16_t usEntry = usDNSCacheBuckets[ ulHash % ipconfigDNS_CACHE_HASH_SIZE ];
+	BaseType_t xResult = -1;
+
+		while( usEntry != 0u )
+		{
+		const DNSCacheRow_t *pxRow = &( xDNSCache[ usEntry - 1u ] );
+
+			if( ( pxRow->ulHash == ulHash ) && ( strcmp( pxRow->pcName, pcName ) == 0 ) )
+			{
+				xResult = ( BaseType_t ) usEntry - 1;
+				break;
+			}
+
+			usEntry = pxRow->usNextInBucket;
+		}
+
+		return xResult;
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Unlink an entry from its hash chain and mark it as free. */
+	static void prvDNSCacheRemove( BaseType_t xEntry )
+	{
+	DNSCacheRow_t *pxRow = &( xDNSCache[ xEntry ] );
+	uint16_t *pusLink = &( usDNSCacheBuckets[ pxRow->ulHash % ipconfigDNS_CACHE_HASH_SIZE ] );
+
+		while( *pusLink != 0u )
+		{
+			if( *pusLink == ( uint16_t ) ( xEntry + 1 ) )
+			{
+				*pusLink = pxRow->usNextInBucket;
+				break;
+			}
+
+			pusLink = &( xDNSCache[ *pusLink - 1u ].usNextInBucket );
+		}
+
+		pxRow->pcName[ 0 ] = 0;
+		pxRow->usNextInBucket = 0u;
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Find a row for a new name.  A free or expired row is preferred,
+	otherwise the least recently used entry is evicted.  The linear scan only
+	happens when a reply is stored, look-ups use the hash chains. */
+	static BaseType_t prvDNSCacheAllocate( uint32_t ulCurrentTimeSeconds )
+	{
+	BaseType_t x, xVictim = 0;
+	uint32_t ulAge, ulOldestAge = 0uL;
+
+		for( x = 0; x < ipconfigDNS_CACHE_ENTRIES; x++ )
+		{
+			if( ( xDNSCache[ x ].pcName[ 0 ] == 0 ) ||
+				( prvDNSCacheIsFresh( &( xDNSCache[ x ] ), ulCurrentTimeSeconds ) == pdFALSE ) )
+			{
+				xVictim = x;
+				break;
+			}
+
+			ulAge = ulDNSCacheUseCount - xDNSCache[ x ].ulLastUsed;
+
+			if( ulAge >= ulOldestAge )
+			{
+				ulOldestAge = ulAge;
+				xVictim = x;
+			}
+		}
+
+		if( xDNSCache[ xVictim ].pcName[ 0 ] != 0 )
+		{
+			prvDNSCacheRemove( xVictim );
+		}
+
+		return xVictim;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvProcessDNSCache( const char *pcName,
+										  uint32_t *pulIP,
+										  uint32_t ulTTL,
+										  BaseType_t xLookUp,
+										  BaseType_t xFirstAddress )
+	{
+	BaseType_t xEntry;
 	BaseType_t xFound = pdFALSE;
-	uint32_t ulCurrentTimeSeconds = ( xTaskGetTickCount() / portTICK_PERIOD_MS ) / 1000;
-	static BaseType_t xFreeEntry = 0;
+	uint32_t ulCurrentTimeSeconds = ( uint32_t ) ( xTaskGetTickCount() / configTICK_RATE_HZ );
+	uint32_t ulHash;
+	DNSCacheRow_t *pxRow = NULL;
 		configASSERT(pcName);
 
-		/* For each entry in the DNS cache table. */
-		for( x = 0; x < ipconfigDNS_CACHE_ENTRIES; x++ )
+		ulHash = prvDNSCacheHash( pcName );
+		xEntry = prvDNSCacheFind( pcName, ulHash );
+		ulDNSCacheUseCount++;
+
+		if( xEntry >= 0 )
 		{
-			if( xDNSCache[ x ].pcName[ 0 ] == 0 )
+			if( prvDNSCacheIsFresh( &( xDNSCache[ xEntry ] ), ulCurrentTimeSeconds ) != pdFALSE )
 			{
-				continue;
+				pxRow = &( xDNSCache[ xEntry ] );
 			}
+			else
+			{
+				/* Age out the old cached record. */
+				prvDNSCacheRemove( xEntry );
+			}
+		}
 
-			if( 0 == strcmp( xDNSCache[ x ].pcName, pcName ) )
+		/* Is this function called for a lookup or to add/update an IP address? */
+		if( xLookUp != pdFALSE )
+		{
+			*pulIP = 0uL;
+
+			if( pxRow != NULL )
 			{
-				/* Is this function called for a lookup or to add/update an IP address? */
-				if( xLookUp != pdFALSE )
+				pxRow->ulLastUsed = ulDNSCacheUseCount;
+
+				/* A negative entry has no addresses and yields 0. */
+				if( pxRow->ucNumIPAddresses != 0u )
 				{
-					/* Confirm that the record is still fresh. */
-					if( ulCurrentTimeSeconds < ( xDNSCache[ x ].ulTimeWhenAddedInSeconds + FreeRTOS_ntohl( xDNSCache[ x ].ulTTL ) ) )
-					{
-						*pulIP = xDNSCache[ x ].ulIPAddress;
-					}
-					else
+					/* Hand out the addresses in a round-robin way. */
+					*pulIP = pxRow->ulIPAddresses[ pxRow->ucCurrentIPAddress ];
+					pxRow->ucCurrentIPAddress++;
+
+					if( pxRow->ucCurrentIPAddress >= pxRow->ucNumIPAddresses )
 					{
-						/* Age out the old cached record. */
-						xDNSCache[ x ].pcName[ 0 ] = 0;
+						pxRow->ucCurrentIPAddress = 0u;
 					}
 				}
-				else
-				{
-					xDNSCache[ x ].ulIPAddress = *pulIP;
-					xDNSCache[ x ].ulTTL = ulTTL;
-					xDNSCache[ x ].ulTimeWhenAddedInSeconds = ulCurrentTimeSeconds;
-				}
 
 				xFound = pdTRUE;
-				break;
 			}
 		}
-
-		if( xFound == pdFALSE )
+		else if( ( *pulIP == 0uL ) && ( pxRow != NULL ) && ( pxRow->ucNumIPAddresses != 0u ) )
 		{
-			if( xLookUp != pdFALSE )
+			/* A failed look-up must not hide addresses that are still
+			valid. */
+		}
+		else
+		{
+			if( pxRow == NULL )
 			{
-				*pulIP = 0;
+				if( strlen( pcName ) < ipconfigDNS_CACHE_NAME_LENGTH )
+				{
+					xEntry = prvDNSCacheAllocate( ulCurrentTimeSeconds );
+					pxRow = &( xDNSCache[ xEntry ] );
+
+					strcpy( pxRow->pcName, pcName );
+					pxRow->ulHash = ulHash;
+					pxRow->ucNumIPAddresses = 0u;
+					pxRow->ucCurrentIPAddress = 0u;
+
+					/* Insert the new entry at the head of its hash chain. */
+					pxRow->usNextInBucket = usDNSCacheBuckets[ ulHash % ipconfigDNS_CACHE_HASH_SIZE ];
+					usDNSCacheBuckets[ ulHash % ipconfigDNS_CACHE_HASH_SIZE ] = ( uint16_t ) ( xEntry + 1 );
+				}
 			}
-			else
+
+			if( pxRow != NULL )
 			{
-				/* Add or update the item. */
-				if( strlen( pcName ) < ipconfigDNS_CACHE_NAME_LENGTH )
+				if( *pulIP != 0uL )
 				{
-					strcpy( xDNSCache[ xFreeEntry ].pcName, pcName );
+				uint8_t ucIndex;
 
-					xDNSCache[ xFreeEntry ].ulIPAddress = *pulIP;
-					xDNSCache[ xFreeEntry ].ulTTL = ulTTL;
-					xDNSCache[ xFreeEntry ].ulTimeWhenAddedInSeconds = ulCurrentTimeSeconds;
+					if( xFirstAddress != pdFALSE )
+					{
+						/* A new reply replaces the whole answer set. */
+						pxRow->ucNumIPAddresses = 0u;
+						pxRow->ucCurrentIPAddress = 0u;
+					}
 
-					xFreeEntry++;
+					for( ucIndex = 0u; ucIndex < pxRow->ucNumIPAddresses; ucIndex++ )
+					{
+						if( pxRow->ulIPAddresses[ ucIndex ] == *pulIP )
+						{
+							break;
+						}
+					}
 
-					if( xFreeEntry == ipconfigDNS_CACHE_ENTRIES )
+					if( ucIndex == pxRow->ucNumIPAddresses )
 					{
-						xFreeEntry = 0;
+						if( pxRow->ucNumIPAddresses < ( uint8_t ) ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY )
+						{
+							pxRow->ucNumIPAddresses++;
+						}
+						else
+						{
+							/* The entry is full, replace the last address. */
+							ucIndex--;
+						}
+
+						pxRow->ulIPAddresses[ ucIndex ] = *pulIP;
 					}
 				}
+
+				pxRow->ulTTL = ulTTL;
+				pxRow->ulTimeWhenAddedInSeconds = ulCurrentTimeSeconds;
+				pxRow->ulLastUsed = ulDNSCacheUseCount;
 			}
 		}
 
@@ -1541,6 +1947,8 @@ BaseType_t xReturn;
 		{
 			FreeRTOS_debug_printf( ( "prvProcessDNSCache: %s: '%s' @ %lxip\n", xLookUp ? "look-up" : "add", pcName, FreeRTOS_ntohl( *pulIP ) ) );
 		}
+
+		return xFound;
 	}
 
 #endif /* ipconfigUSE_DNS_CACHE */
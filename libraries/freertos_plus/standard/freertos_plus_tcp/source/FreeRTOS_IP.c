@@ -46,6 +46,16 @@
 #include "NetworkBufferManagement.h"
 #include "FreeRTOS_DNS.h"
 
+#if( ipconfigUSE_64BIT_CHECKSUM == 1 ) && ( ipconfigUSE_SIMD_CHECKSUM == 1 )
+	#if defined( __SSE2__ )
+		#include <emmintrin.h>
+		#define ipCHECKSUM_USE_SSE2		1
+	#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+		#include <arm_neon.h>
+		#define ipCHECKSUM_USE_NEON		1
+	#endif
+#endif
+
 
 /* Used to ensure the structure packing is having the desired effect.  The
 'volatile' is used to prevent compiler warnings about comparing a constant with
@@ -498,6 +508,18 @@ struct freertos_sockaddr xAddress;
 				#endif /* ipconfigUSE_TCP */
 				break;
 
+			case eSocketHashEvent:
+				/* The state of a TCP socket was changed by an API call, such
+				as FreeRTOS_listen() or FreeRTOS_connect().  Only the IP-task
+				may change the socket hash tables, so the socket is moved to
+				its new bucket here. */
+				#if( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 ) )
+				{
+					vTCPSocketHashUpdate( ( FreeRTOS_Socket_t * ) ( xReceivedEvent.pvData ) );
+				}
+				#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 ) */
+				break;
+
 			case eTCPNetStat:
 				/* FreeRTOS_netstat() was called to have the IP-task print an
 				overview of all sockets and their connections */
@@ -1730,7 +1752,6 @@ uint8_t ucProtocol;
 	{
 	ICMPHeader_t *pxICMPHeader;
 	IPHeader_t *pxIPHeader;
-	uint16_t usRequest;
 
 		pxICMPHeader = &( pxICMPPacket->xICMPHeader );
 		pxIPHeader = &( pxICMPPacket->xIPHeader );
@@ -1750,22 +1771,12 @@ uint8_t ucProtocol;
 		has been changed to ipICMP_ECHO_REPLY.  This is faster than calling
 		usGenerateChecksum(). */
 
-		/* due to compiler warning "integer operation result is out of range" */
+		/* The type is the high byte of the first 16-bit word of the header,
+		the code field (0) is the low byte. */
+		pxICMPHeader->usChecksum = usIncrementalChecksum16( pxICMPHeader->usChecksum,
+			FreeRTOS_htons( ( uint16_t ) ( ( uint16_t ) ipICMP_ECHO_REQUEST << 8 ) ),
+			FreeRTOS_htons( ( uint16_t ) ( ( uint16_t ) ipICMP_ECHO_REPLY << 8 ) ) );
 
-		usRequest = ( uint16_t ) ( ( uint16_t )ipICMP_ECHO_REQUEST << 8 );
-
-		if( pxICMPHeader->usChecksum >= FreeRTOS_htons( 0xFFFFu - usRequest ) )
-		{
-			pxICMPHeader->usChecksum = ( uint16_t )
-				( ( ( uint32_t ) pxICMPHeader->usChecksum ) +
-					FreeRTOS_htons( usRequest + 1UL ) );
-		}
-		else
-		{
-			pxICMPHeader->usChecksum = ( uint16_t )
-				( ( ( uint32_t ) pxICMPHeader->usChecksum ) +
-					FreeRTOS_htons( usRequest ) );
-		}
 		return eReturnEthernetFrame;
 	}
 
@@ -2045,7 +2056,10 @@ uint8_t ucProtocol;
  */
 uint16_t usGenerateChecksum( uint32_t ulSum, const uint8_t * pucNextData, size_t uxDataLengthBytes )
 {
-xUnion32 xSum2, xSum, xTerm;
+xUnion32 xSum, xTerm;
+#if( ipconfigUSE_64BIT_CHECKSUM == 0 )
+	xUnion32 xSum2;
+#endif
 xUnionPtr xSource;		/* Points to first byte */
 xUnionPtr xLastSource;	/* Points to last byte plus one */
 uint32_t ulAlignBits, ulCarry = 0ul;
@@ -2082,6 +2096,64 @@ uint32_t ulAlignBits, ulCarry = 0ul;
 	/* Word (32-bit) aligned, do the most part. */
 	xLastSource.u32ptr = ( xSource.u32ptr + ( uxDataLengthBytes / 4u ) ) - 3u;
 
+#if( ipconfigUSE_64BIT_CHECKSUM == 1 )
+	{
+	uint64_t ullSum = xSum.u32;
+
+		/* A 64-bit accumulator can absorb the carries of 2^32 additions, so
+		there is no need to test for an overflow after every addition. */
+		#if defined( ipCHECKSUM_USE_SSE2 )
+		{
+		__m128i xAccumulator = _mm_setzero_si128();
+		const __m128i xZero = _mm_setzero_si128();
+		__m128i xWords;
+		uint64_t ullLanes[ 2 ];
+
+			/* Widen four 32-bit words to 64 bits and add them to two lanes. */
+			while( xSource.u32ptr < xLastSource.u32ptr )
+			{
+				xWords = _mm_loadu_si128( ( const __m128i * ) xSource.u32ptr );
+				xAccumulator = _mm_add_epi64( xAccumulator, _mm_unpacklo_epi32( xWords, xZero ) );
+				xAccumulator = _mm_add_epi64( xAccumulator, _mm_unpackhi_epi32( xWords, xZero ) );
+				xSource.u32ptr += 4;
+			}
+			_mm_storeu_si128( ( __m128i * ) ullLanes, xAccumulator );
+			ullSum += ullLanes[ 0 ];
+			ullSum += ullLanes[ 1 ];
+		}
+		#elif defined( ipCHECKSUM_USE_NEON )
+		{
+		uint64x2_t xAccumulator = vdupq_n_u64( 0u );
+
+			/* Add pairs of 32-bit words to two 64-bit lanes. */
+			while( xSource.u32ptr < xLastSource.u32ptr )
+			{
+				xAccumulator = vpadalq_u32( xAccumulator, vld1q_u32( xSource.u32ptr ) );
+				xSource.u32ptr += 4;
+			}
+			ullSum += vgetq_lane_u64( xAccumulator, 0 );
+			ullSum += vgetq_lane_u64( xAccumulator, 1 );
+		}
+		#else
+		{
+			while( xSource.u32ptr < xLastSource.u32ptr )
+			{
+				ullSum += xSource.u32ptr[ 0 ];
+				ullSum += xSource.u32ptr[ 1 ];
+				ullSum += xSource.u32ptr[ 2 ];
+				ullSum += xSource.u32ptr[ 3 ];
+				xSource.u32ptr += 4;
+			}
+		}
+		#endif
+
+		/* Fold the 64-bit sum into 32 bits, twice because the first addition
+		may produce a carry. */
+		ullSum = ( ullSum & 0xffffffffull ) + ( ullSum >> 32 );
+		ullSum = ( ullSum & 0xffffffffull ) + ( ullSum >> 32 );
+		xSum.u32 = ( uint32_t ) ullSum;
+	}
+#else
 	/* In this loop, four 32-bit additions will be done, in total 16 bytes.
 	Indexing with constants (0,1,2,3) gives faster code than using
 	post-increments. */
@@ -2120,6 +2192,7 @@ uint32_t ulAlignBits, ulCarry = 0ul;
 		/* And finally advance the pointer 4 * 4 = 16 bytes. */
 		xSource.u32ptr += 4;
 	}
+#endif /* ipconfigUSE_64BIT_CHECKSUM */
 
 	/* Now add all carries. */
 	xSum.u32 = ( uint32_t )xSum.u16[ 0 ] + xSum.u16[ 1 ] + ulCarry;
@@ -2159,6 +2232,52 @@ uint32_t ulAlignBits, ulCarry = 0ul;
 }
 /*-----------------------------------------------------------*/
 
+/**
+ * Update a checksum after one 16-bit word of the data has changed, without
+ * summing all data again.  RFC 1624, equation 3:
+ *   HC' = ~( ~HC + ~m + m' )
+ * Unlike the older form HC' = HC + m - m' (RFC 1141), it never produces
+ * 0x0000 when the correct result is 0xFFFF.
+ *
+ * usChecksum, usOldValue and usNewValue must all be in the same byte order,
+ * normally as they are found in the packet.  The result is in that order as
+ * well.
+ */
+uint16_t usIncrementalChecksum16( uint16_t usChecksum, uint16_t usOldValue, uint16_t usNewValue )
+{
+uint32_t ulSum;
+
+	ulSum = ( uint32_t ) ( uint16_t ) ~usChecksum;
+	ulSum += ( uint32_t ) ( uint16_t ) ~usOldValue;
+	ulSum += ( uint32_t ) usNewValue;
+
+	/* Add the carries, at most two times. */
+	ulSum = ( ulSum & 0xffffUL ) + ( ulSum >> 16 );
+	ulSum = ( ulSum & 0xffffUL ) + ( ulSum >> 16 );
+
+	return ( uint16_t ) ~ulSum;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * The same as usIncrementalChecksum16(), for a 32-bit field such as an IP
+ * address.  The values are taken as they are found in the packet.
+ */
+uint16_t usIncrementalChecksum32( uint16_t usChecksum, uint32_t ulOldValue, uint32_t ulNewValue )
+{
+xUnion32 xOld, xNew;
+uint16_t usResult;
+
+	xOld.u32 = ulOldValue;
+	xNew.u32 = ulNewValue;
+
+	usResult = usIncrementalChecksum16( usChecksum, xOld.u16[ 0 ], xNew.u16[ 0 ] );
+	usResult = usIncrementalChecksum16( usResult, xOld.u16[ 1 ], xNew.u16[ 1 ] );
+
+	return usResult;
+}
+/*-----------------------------------------------------------*/
+
 void vReturnEthernetFrame( NetworkBufferDescriptor_t * pxNetworkBuffer, BaseType_t xReleaseAfterSend )
 {
 EthernetHeader_t *pxEthernetHeader;
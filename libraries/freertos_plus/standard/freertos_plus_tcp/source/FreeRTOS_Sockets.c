@@ -158,6 +158,27 @@ static BaseType_t prvDetermineSocketSize( BaseType_t xDomain, BaseType_t xType,
 	static FreeRTOS_Socket_t *prvFindSelectedSocket( SocketSelect_t *pxSocketSet );
 
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
+
+#if( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 0 )
+	/*
+	 * Look up a TCP socket by walking through xBoundTCPSocketsList.
+	 */
+	static FreeRTOS_Socket_t *prvTCPSocketListLookup( UBaseType_t uxLocalPort, uint32_t ulRemoteIP, UBaseType_t uxRemotePort );
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 0 ) */
+
+#if( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+	/*
+	 * Return the index of the bucket in xTCPSocketHash for a given local port
+	 * and remote address.
+	 */
+	static UBaseType_t prvTCPSocketHash( UBaseType_t uxLocalPort, uint32_t ulRemoteIP, UBaseType_t uxRemotePort );
+
+	/*
+	 * Look up a TCP socket in the hash tables.  Every bound TCP socket is
+	 * placed in them by the IP-task, so a miss means there is no such socket.
+	 */
+	static FreeRTOS_Socket_t *prvTCPSocketHashLookup( UBaseType_t uxLocalPort, uint32_t ulRemoteIP, UBaseType_t uxRemotePort );
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 ) */
 /*-----------------------------------------------------------*/
 
 /* The list that contains mappings between sockets and port numbers.  Accesses
@@ -168,6 +189,15 @@ List_t xBoundUDPSocketsList;
 	List_t xBoundTCPSocketsList;
 #endif /* ipconfigUSE_TCP == 1 */
 
+#if( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+	/* Hash tables that index the sockets in xBoundTCPSocketsList.  Listening
+	sockets are found in xTCPListenSocketHash by their local port, all other
+	bound sockets in xTCPSocketHash by their local port and remote address.
+	Like xBoundTCPSocketsList, these lists are only accessed by the IP-task. */
+	static List_t xTCPSocketHash[ ipconfigTCP_SOCKET_HASH_SIZE ];
+	static List_t xTCPListenSocketHash[ ipconfigTCP_SOCKET_HASH_SIZE ];
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 ) */
+
 /*-----------------------------------------------------------*/
 
 static BaseType_t prvValidSocket( FreeRTOS_Socket_t *pxSocket, BaseType_t xProtocol, BaseType_t xIsBound )
@@ -200,6 +230,18 @@ BaseType_t vNetworkSocketsInit( void )
 	#if( ipconfigUSE_TCP == 1 )
 	{
 		vListInitialise( &xBoundTCPSocketsList );
+
+		#if( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+		{
+		UBaseType_t uxIndex;
+
+			for( uxIndex = 0u; uxIndex < ( UBaseType_t ) ipconfigTCP_SOCKET_HASH_SIZE; uxIndex++ )
+			{
+				vListInitialise( &( xTCPSocketHash[ uxIndex ] ) );
+				vListInitialise( &( xTCPListenSocketHash[ uxIndex ] ) );
+			}
+		}
+		#endif /* ipconfigUSE_TCP_SOCKET_HASH */
 	}
 	#endif  /* ipconfigUSE_TCP == 1 */
 
@@ -333,6 +375,12 @@ Socket_t xReturn;
 					/* StreamSize is expressed in number of bytes */
 					/* Round up buffer sizes to nearest multiple of MSS */
 					pxSocket->u.xTCP.usInitMSS	= pxSocket->u.xTCP.usCurMSS = ipconfigTCP_MSS;
+					#if( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+					{
+						vListInitialiseItem( &( pxSocket->u.xTCP.xHashListItem ) );
+						listSET_LIST_ITEM_OWNER( &( pxSocket->u.xTCP.xHashListItem ), ( void * ) pxSocket );
+					}
+					#endif /* ipconfigUSE_TCP_SOCKET_HASH */
 					pxSocket->u.xTCP.uxRxStreamSize = ( size_t ) ipconfigTCP_RX_BUFFER_LENGTH;
 					pxSocket->u.xTCP.uxTxStreamSize = ( size_t ) FreeRTOS_round_up( ipconfigTCP_TX_BUFFER_LENGTH, ipconfigTCP_MSS );
 					/* Use half of the buffer size of the TCP windows */
@@ -1062,6 +1110,15 @@ List_t *pxSocketList;
 				/* Add the socket to 'xBoundUDPSocketsList' or 'xBoundTCPSocketsList' */
 				vListInsertEnd( pxSocketList, &( pxSocket->xBoundSocketListItem ) );
 
+				#if( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+				{
+					if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+					{
+						vTCPSocketHashUpdate( pxSocket );
+					}
+				}
+				#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 ) */
+
 				#if( ipconfigETHERNET_DRIVER_FILTERS_PACKETS == 1 )
 				{
 					xTaskResumeAll();
@@ -1195,6 +1252,17 @@ NetworkBufferDescriptor_t *pxNetworkBuffer;
 
 		uxListRemove( &( pxSocket->xBoundSocketListItem ) );
 
+		#if( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+		{
+			if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+			{
+				/* Now that the socket is not bound, this removes it from the
+				hash tables. */
+				vTCPSocketHashUpdate( pxSocket );
+			}
+		}
+		#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 ) */
+
 		#if( ipconfigETHERNET_DRIVER_FILTERS_PACKETS == 1 )
 		{
 			xTaskResumeAll();
@@ -2840,23 +2908,14 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 #endif /* ipconfigUSE_TCP */
 /*-----------------------------------------------------------*/
 
-#if( ipconfigUSE_TCP == 1 )
+#if( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 0 )
 
-	/*
-	 * TCP: as multiple sockets may be bound to the same local port number
-	 * looking up a socket is a little more complex:
-	 * Both a local port, and a remote port and IP address are being used
-	 * For a socket in listening mode, the remote port and IP address are both 0
-	 */
-	FreeRTOS_Socket_t *pxTCPSocketLookup( uint32_t ulLocalIP, UBaseType_t uxLocalPort, uint32_t ulRemoteIP, UBaseType_t uxRemotePort )
+	static FreeRTOS_Socket_t *prvTCPSocketListLookup( UBaseType_t uxLocalPort, uint32_t ulRemoteIP, UBaseType_t uxRemotePort )
 	{
 	ListItem_t *pxIterator;
 	FreeRTOS_Socket_t *pxResult = NULL, *pxListenSocket = NULL;
 	MiniListItem_t *pxEnd = ( MiniListItem_t* )listGET_END_MARKER( &xBoundTCPSocketsList );
 
-		/* Parameter not yet supported. */
-		( void ) ulLocalIP;
-
 		for( pxIterator  = ( ListItem_t * ) listGET_NEXT( pxEnd );
 			 pxIterator != ( ListItem_t * ) pxEnd;
 			 pxIterator  = ( ListItem_t * ) listGET_NEXT( pxIterator ) )
@@ -2890,6 +2949,140 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 		return pxResult;
 	}
 
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 0 ) */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+
+	static UBaseType_t prvTCPSocketHash( UBaseType_t uxLocalPort, uint32_t ulRemoteIP, UBaseType_t uxRemotePort )
+	{
+	uint32_t ulHash;
+
+		/* Combine the address and both port numbers, then spread the bits
+		with a multiplication by the 32-bit golden ratio.  Folding the high
+		half back in makes the low bits, which select the bucket, depend on
+		all of the input.  Peers often differ only in consecutive addresses
+		or port numbers, which a simple sum or multiply-by-31 would put in a
+		few buckets. */
+		ulHash = ulRemoteIP ^ ( ( ( uint32_t ) uxRemotePort & 0xffffUL ) << 16 ) ^ ( ( uint32_t ) uxLocalPort & 0xffffUL );
+		ulHash *= 0x9E3779B1UL;
+		ulHash ^= ulHash >> 16;
+
+		return ( UBaseType_t ) ( ulHash % ( uint32_t ) ipconfigTCP_SOCKET_HASH_SIZE );
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTCPSocketHashUpdate( FreeRTOS_Socket_t *pxSocket )
+	{
+	List_t *pxBucket;
+
+		if( listLIST_ITEM_CONTAINER( &( pxSocket->u.xTCP.xHashListItem ) ) != NULL )
+		{
+			( void ) uxListRemove( &( pxSocket->u.xTCP.xHashListItem ) );
+		}
+
+		if( socketSOCKET_IS_BOUND( pxSocket ) != pdFALSE )
+		{
+			if( pxSocket->u.xTCP.ucTCPState == ( uint8_t ) eTCP_LISTEN )
+			{
+				pxBucket = &( xTCPListenSocketHash[ pxSocket->usLocalPort % ( UBaseType_t ) ipconfigTCP_SOCKET_HASH_SIZE ] );
+			}
+			else
+			{
+				pxBucket = &( xTCPSocketHash[ prvTCPSocketHash( pxSocket->usLocalPort,
+																pxSocket->u.xTCP.ulRemoteIP,
+																pxSocket->u.xTCP.usRemotePort ) ] );
+			}
+
+			vListInsertEnd( pxBucket, &( pxSocket->u.xTCP.xHashListItem ) );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static FreeRTOS_Socket_t *prvTCPSocketHashLookup( UBaseType_t uxLocalPort, uint32_t ulRemoteIP, UBaseType_t uxRemotePort )
+	{
+	const ListItem_t *pxIterator;
+	const MiniListItem_t *pxEnd;
+	FreeRTOS_Socket_t *pxSocket, *pxResult = NULL;
+
+		/* A socket is placed in a bucket by the IP-task.  FreeRTOS_listen()
+		and FreeRTOS_connect() change the state of a socket from an application
+		task and then send an eSocketHashEvent, so until that event is handled
+		the socket may be in the wrong table or bucket.  That is why the current
+		fields of a socket are compared, in stead of relying on the bucket it
+		is found in. */
+		pxEnd = ( const MiniListItem_t * ) listGET_END_MARKER( &( xTCPSocketHash[ prvTCPSocketHash( uxLocalPort, ulRemoteIP, uxRemotePort ) ] ) );
+
+		for( pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxEnd );
+			 pxIterator != ( const ListItem_t * ) pxEnd;
+			 pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxIterator ) )
+		{
+			pxSocket = ( FreeRTOS_Socket_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+
+			if( ( pxSocket->usLocalPort == ( uint16_t ) uxLocalPort ) &&
+				( pxSocket->u.xTCP.ucTCPState != ( uint8_t ) eTCP_LISTEN ) &&
+				( pxSocket->u.xTCP.usRemotePort == ( uint16_t ) uxRemotePort ) &&
+				( pxSocket->u.xTCP.ulRemoteIP == ulRemoteIP ) )
+			{
+				pxResult = pxSocket;
+				break;
+			}
+		}
+
+		if( pxResult == NULL )
+		{
+			/* An exact match was not found, look for a listening socket. */
+			pxEnd = ( const MiniListItem_t * ) listGET_END_MARKER( &( xTCPListenSocketHash[ uxLocalPort % ( UBaseType_t ) ipconfigTCP_SOCKET_HASH_SIZE ] ) );
+
+			for( pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxEnd );
+				 pxIterator != ( const ListItem_t * ) pxEnd;
+				 pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxIterator ) )
+			{
+				pxSocket = ( FreeRTOS_Socket_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+
+				if( ( pxSocket->usLocalPort == ( uint16_t ) uxLocalPort ) &&
+					( pxSocket->u.xTCP.ucTCPState == ( uint8_t ) eTCP_LISTEN ) )
+				{
+					pxResult = pxSocket;
+					break;
+				}
+			}
+		}
+
+		return pxResult;
+	}
+
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_TCP == 1 )
+
+	/*
+	 * TCP: as multiple sockets may be bound to the same local port number
+	 * looking up a socket is a little more complex:
+	 * Both a local port, and a remote port and IP address are being used
+	 * For a socket in listening mode, the remote port and IP address are both 0
+	 */
+	FreeRTOS_Socket_t *pxTCPSocketLookup( uint32_t ulLocalIP, UBaseType_t uxLocalPort, uint32_t ulRemoteIP, UBaseType_t uxRemotePort )
+	{
+	FreeRTOS_Socket_t *pxResult;
+
+		/* Parameter not yet supported. */
+		( void ) ulLocalIP;
+
+		#if( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+		{
+			pxResult = prvTCPSocketHashLookup( uxLocalPort, ulRemoteIP, uxRemotePort );
+		}
+		#else
+		{
+			pxResult = prvTCPSocketListLookup( uxLocalPort, ulRemoteIP, uxRemotePort );
+		}
+		#endif /* ipconfigUSE_TCP_SOCKET_HASH */
+
+		return pxResult;
+	}
+
 #endif /* ipconfigUSE_TCP */
 /*-----------------------------------------------------------*/
 
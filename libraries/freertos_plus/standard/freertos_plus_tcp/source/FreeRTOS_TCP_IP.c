@@ -67,6 +67,14 @@ the defined MTU size can contain at least a complete TCP packet. */
 	#error The ipconfigTCP_MSS setting in FreeRTOSIPConfig.h is too large.
 #endif
 
+#if( ipconfigTCP_LARGE_SEND_OFFLOAD != 0 )
+	/* A large segment, including 40 bytes of options, must fit in the 16-bit
+	length field of the IP header. */
+	#if ( ( ( ipconfigTCP_LARGE_SEND_SEGMENTS * ipconfigTCP_MSS ) + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER + 40 ) > 0xffff )
+		#error ipconfigTCP_LARGE_SEND_SEGMENTS is too large.
+	#endif
+#endif
+
 /*
  * The meaning of the TCP flags:
  */
@@ -259,6 +267,70 @@ static void prvTCPTouchSocket( FreeRTOS_Socket_t *pxSocket );
  */
 static int32_t prvTCPPrepareSend( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t **ppxNetworkBuffer, UBaseType_t uxOptionsLength );
 
+#if( ipconfigTCP_LARGE_SEND != 0 )
+	/*
+	 * Return the amount of data that a large send, starting with the segment
+	 * that was just fetched from the sliding window, may carry.
+	 */
+	static int32_t prvTCPLargeSendLength( FreeRTOS_Socket_t *pxSocket, int32_t lStreamPos, int32_t lDataLen );
+
+	/*
+	 * Fetch the new segments that follow the first one.  With
+	 * ipconfigTCP_LARGE_SEND_OFFLOAD, their data is copied behind it.  Returns
+	 * the total length of the data.
+	 */
+	static int32_t prvTCPLargeSendAppend( FreeRTOS_Socket_t *pxSocket, uint8_t *pucSendData, int32_t lDataLen, int32_t lMaxLength );
+
+	#if( ipconfigTCP_LARGE_SEND_OFFLOAD == 0 )
+		/* The state of a large send while it is cut into frames. */
+		typedef struct xTCP_LARGE_SEND
+		{
+			size_t uxTCPHeaderLength;			/* The length of the TCP header, including options. */
+			size_t uxHeaderLength;				/* The length of all headers of a frame. */
+			size_t uxLength;					/* The payload length of the current frame. */
+			size_t uxOffset;					/* The offset in txStream of the next payload. */
+			size_t uxRemaining;					/* The data that still has to be put in a frame. */
+			uint32_t ulSequenceNumber;			/* The sequence number of the current frame, in host order. */
+			uint8_t ucLastFlags;				/* The TCP flags of the last frame. */
+			#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+				uint32_t ulFirstSequenceNumber;	/* The fields of the first frame, as they were summed. */
+				uint16_t usFirstLength;
+				uint16_t usFirstIdentification;
+				uint16_t usIPChecksum;			/* The IP checksum of the first frame. */
+				uint16_t usTCPChecksum;			/* The sum of the pseudo header and the TCP header. */
+				uint16_t usMiddleFlags;			/* The 16-bit words holding the flags of a middle frame, */
+				uint16_t usLastFlags;			/* and of the last frame. */
+			#endif
+		} TCPLargeSend_t;
+
+		/*
+		 * Take over the large send that prvTCPPrepareSend() claimed, and
+		 * prepare the first frame.
+		 */
+		static void prvTCPLargeSendStart( FreeRTOS_Socket_t *pxSocket, TCPLargeSend_t *pxLargeSend, NetworkBufferDescriptor_t *pxNetworkBuffer );
+
+		/*
+		 * Set the IP and TCP checksums of a frame, updating the sums of the
+		 * first frame.
+		 */
+		#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+			static void prvTCPLargeSendChecksum( const TCPLargeSend_t *pxLargeSend, NetworkBufferDescriptor_t *pxFrame );
+		#endif
+
+		/*
+		 * Allocate the frame that follows 'pxPrevious', and fill it with the
+		 * next slice of data.  Returns NULL when no buffer is available.
+		 */
+		static NetworkBufferDescriptor_t *prvTCPLargeSendNext( FreeRTOS_Socket_t *pxSocket, TCPLargeSend_t *pxLargeSend, const NetworkBufferDescriptor_t *pxPrevious );
+
+		/*
+		 * Send the first frame of a large send, followed by frames of at most
+		 * MSS bytes, which take their data from txStream.
+		 */
+		static void prvTCPLargeSendSlice( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer, BaseType_t xReleaseAfterSend );
+	#endif
+#endif /* ipconfigTCP_LARGE_SEND */
+
 /*
  * Calculate when this socket needs to be checked to do (re-)transmissions.
  */
@@ -708,6 +780,9 @@ EthernetHeader_t *pxEthernetHeader;
 uint32_t ulFrontSpace, ulSpace, ulSourceAddress, ulWinSize;
 TCPWindow_t *pxTCPWindow;
 NetworkBufferDescriptor_t xTempBuffer;
+#if( ipconfigTCP_LARGE_SEND != 0 )
+	BaseType_t xLargeSend = pdFALSE;
+#endif
 /* For sending, a pseudo network buffer will be used, as explained above. */
 
 	if( pxNetworkBuffer == NULL )
@@ -832,6 +907,13 @@ NetworkBufferDescriptor_t xTempBuffer;
 			/* The new window size has been advertised, switch off the flag. */
 			pxSocket->u.xTCP.bits.bWinChange = pdFALSE_UNSIGNED;
 
+			#if( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_DELAYED_ACK_SEGMENTS > 0 ) )
+			{
+				/* Every packet sent acknowledges all data received so far. */
+				pxSocket->u.xTCP.ucDelayedAckCount = 0u;
+			}
+			#endif
+
 			/* Later on, when deciding to delay an ACK, a precise estimate is needed
 			of the free RX space.  At this moment, 'ulHighestRxAllowed' would be the
 			highest sequence number minus 1 that the socket will accept. */
@@ -859,6 +941,12 @@ NetworkBufferDescriptor_t xTempBuffer;
 					/* Suppress FIN in case this packet carries earlier data to be
 					retransmitted. */
 					uint32_t ulDataLen = ( uint32_t ) ( ulLen - ( ipSIZE_OF_TCP_HEADER + ipSIZE_OF_IPv4_HEADER ) );
+					#if( ( ipconfigTCP_LARGE_SEND != 0 ) && ( ipconfigTCP_LARGE_SEND_OFFLOAD == 0 ) )
+					{
+						/* Count the frames of a large send that will follow. */
+						ulDataLen += ( uint32_t ) pxSocket->u.xTCP.uxLargeSendLength;
+					}
+					#endif
 					if( ( pxTCPWindow->ulOurSequenceNumber + ulDataLen ) != pxTCPWindow->tx.ulFINSequenceNumber )
 					{
 						pxTCPPacket->xTCPHeader.ucTCPFlags &= ( ( uint8_t ) ~ipTCP_FLAG_FIN );
@@ -903,7 +991,33 @@ NetworkBufferDescriptor_t xTempBuffer;
 		usPacketIdentifier++;
 		pxIPHeader->usFragmentOffset = 0u;
 
+		#if( ipconfigTCP_LARGE_SEND_OFFLOAD != 0 )
+		{
+			/* A packet with more than one MSS of data was prepared by
+			prvTCPPrepareSend() as a large send.  The interface will cut it into
+			frames, and calculate the checksums of each frame. */
+			if( ( pxSocket != NULL ) &&
+				( ( ulLen - ( uint32_t ) ipSIZE_OF_IPv4_HEADER - ( uint32_t ) ( ( pxTCPPacket->xTCPHeader.ucTCPOffset >> 4 ) << 2 ) ) > ( uint32_t ) pxSocket->u.xTCP.xTCPWindow.usMSS ) )
+			{
+				xLargeSend = pdTRUE;
+			}
+		}
+		#elif( ipconfigTCP_LARGE_SEND != 0 )
+		{
+			/* prvTCPPrepareSend() claimed more segments than the one in this
+			packet.  Their frames will follow, and the checksums of all frames
+			are calculated by prvTCPLargeSendSlice(). */
+			if( ( pxSocket != NULL ) && ( pxSocket->u.xTCP.uxLargeSendLength != 0u ) )
+			{
+				xLargeSend = pdTRUE;
+			}
+		}
+		#endif /* ipconfigTCP_LARGE_SEND */
+
 		#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+		#if( ipconfigTCP_LARGE_SEND != 0 )
+		if( xLargeSend == pdFALSE )
+		#endif
 		{
 			/* calculate the IP header checksum, in case the driver won't do that. */
 			pxIPHeader->usHeaderChecksum = 0x00u;
@@ -952,7 +1066,25 @@ NetworkBufferDescriptor_t xTempBuffer;
 		#endif
 
 		/* Send! */
-		xNetworkInterfaceOutput( pxNetworkBuffer, xReleaseAfterSend );
+		#if( ipconfigTCP_LARGE_SEND != 0 )
+		if( xLargeSend != pdFALSE )
+		{
+			#if( ipconfigTCP_LARGE_SEND_OFFLOAD != 0 )
+			{
+				/* The interface will cut it into frames. */
+				xNetworkInterfaceOutputLarge( pxNetworkBuffer, pxSocket->u.xTCP.xTCPWindow.usMSS, xReleaseAfterSend );
+			}
+			#else
+			{
+				prvTCPLargeSendSlice( pxSocket, pxNetworkBuffer, xReleaseAfterSend );
+			}
+			#endif
+		}
+		else
+		#endif /* ipconfigTCP_LARGE_SEND */
+		{
+			xNetworkInterfaceOutput( pxNetworkBuffer, xReleaseAfterSend );
+		}
 
 		if( xReleaseAfterSend == pdFALSE )
 		{
@@ -1484,6 +1616,9 @@ BaseType_t bAfter  = ( BaseType_t ) NOW_CONNECTED( eTCPState );						/* Is it co
 #if( ipconfigUSE_CALLBACKS == 1 )
 	FreeRTOS_Socket_t *xConnected = NULL;
 #endif
+#if( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+	IPStackEvent_t xHashEvent;
+#endif
 
 	/* Has the connected status changed? */
 	if( bBefore != bAfter )
@@ -1614,6 +1749,28 @@ BaseType_t bAfter  = ( BaseType_t ) NOW_CONNECTED( eTCPState );						/* Is it co
 	/* Fill in the new state. */
 	pxSocket->u.xTCP.ucTCPState = ( uint8_t ) eTCPState;
 
+	#if( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+	{
+		/* The hash tables may only be changed by the IP-task.  When an API
+		such as FreeRTOS_listen() or FreeRTOS_connect() changes the state, the
+		IP-task is asked to move the socket.  The event is queued before any
+		packet that is sent on behalf of the new state, so the socket is in its
+		new bucket before a reply can be looked up. */
+		if( xIsCallingFromIPTask() != pdFALSE )
+		{
+			vTCPSocketHashUpdate( pxSocket );
+		}
+		else
+		{
+			xHashEvent.eEventType = eSocketHashEvent;
+			xHashEvent.pvData = ( void * ) pxSocket;
+
+			/* Like binding, this must succeed, so wait as long as needed. */
+			( void ) xSendEventStructToIPTask( &xHashEvent, ( TickType_t ) portMAX_DELAY );
+		}
+	}
+	#endif /* ipconfigUSE_TCP_SOCKET_HASH */
+
 	/* touch the alive timers because moving to another state. */
 	prvTCPTouchSocket( pxSocket );
 
@@ -1727,6 +1884,7 @@ uint32_t ulDataGot, ulDistance;
 TCPWindow_t *pxTCPWindow;
 NetworkBufferDescriptor_t *pxNewBuffer;
 int32_t lStreamPos;
+int32_t lMaxLength;
 
 	if( ( *ppxNetworkBuffer ) != NULL )
 	{
@@ -1745,6 +1903,12 @@ int32_t lStreamPos;
 	lStreamPos = 0;
 	pxTCPPacket->xTCPHeader.ucTCPFlags |= ipTCP_FLAG_ACK;
 
+	#if( ( ipconfigTCP_LARGE_SEND != 0 ) && ( ipconfigTCP_LARGE_SEND_OFFLOAD == 0 ) )
+	{
+		pxSocket->u.xTCP.uxLargeSendLength = 0u;
+	}
+	#endif
+
 	if( pxSocket->u.xTCP.txStream != NULL )
 	{
 		/* ulTCPWindowTxGet will return the amount of data which may be sent
@@ -1758,9 +1922,36 @@ int32_t lStreamPos;
 
 		if( lDataLen > 0 )
 		{
+			lMaxLength = lDataLen;
+
+			#if( ipconfigTCP_LARGE_SEND != 0 )
+			{
+				/* See if more segments can be sent along with this one. */
+				lMaxLength = prvTCPLargeSendLength( pxSocket, lStreamPos, lDataLen );
+			}
+			#endif
+
 			/* Check if the current network buffer is big enough, if not,
 			resize it. */
-			pxNewBuffer = prvTCPBufferResize( pxSocket, *ppxNetworkBuffer, lDataLen, uxOptionsLength );
+			#if( ipconfigTCP_LARGE_SEND_OFFLOAD != 0 )
+			{
+				pxNewBuffer = prvTCPBufferResize( pxSocket, *ppxNetworkBuffer, lMaxLength, uxOptionsLength );
+
+				if( ( pxNewBuffer == NULL ) && ( lMaxLength > lDataLen ) )
+				{
+					/* There is no buffer for a large send, send one segment. */
+					lMaxLength = lDataLen;
+					pxNewBuffer = prvTCPBufferResize( pxSocket, *ppxNetworkBuffer, lDataLen, uxOptionsLength );
+				}
+			}
+			#else
+			{
+				/* Also for a large send, the buffer holds only the first
+				segment.  The frames that follow take their data from txStream
+				when they are sent. */
+				pxNewBuffer = prvTCPBufferResize( pxSocket, *ppxNetworkBuffer, lDataLen, uxOptionsLength );
+			}
+			#endif
 
 			if( pxNewBuffer != NULL )
 			{
@@ -1778,6 +1969,32 @@ int32_t lStreamPos;
 				when the packets are acked, the tail marker will be updated. */
 				ulDataGot = ( uint32_t ) uxStreamBufferGet( pxSocket->u.xTCP.txStream, uxOffset, pucSendData, ( size_t ) lDataLen, pdTRUE );
 
+				#if( ipconfigTCP_LARGE_SEND != 0 )
+				{
+					if( lMaxLength > lDataLen )
+					{
+						/* Add the segments that follow. */
+						lMaxLength = prvTCPLargeSendAppend( pxSocket, pucSendData, lDataLen, lMaxLength );
+						ulDataGot += ( uint32_t ) ( lMaxLength - lDataLen );
+
+						#if( ipconfigTCP_LARGE_SEND_OFFLOAD != 0 )
+						{
+							pxNewBuffer->xDataLength = ( size_t ) ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER + uxOptionsLength ) + ( size_t ) lMaxLength;
+						}
+						#else
+						{
+							/* Remember where their data is, it is fetched by
+							prvTCPLargeSendSlice(). */
+							pxSocket->u.xTCP.uxLargeSendOffset = uxOffset + ( size_t ) lDataLen;
+							pxSocket->u.xTCP.uxLargeSendLength = ( size_t ) ( lMaxLength - lDataLen );
+						}
+						#endif
+
+						lDataLen = lMaxLength;
+					}
+				}
+				#endif
+
 				#if( ipconfigHAS_DEBUG_PRINTF != 0 )
 				{
 					if( ulDataGot != ( uint32_t ) lDataLen )
@@ -1892,6 +2109,13 @@ int32_t lStreamPos;
 			pxTCPPacket->xTCPHeader.ucTCPFlags |= ( uint8_t ) ipTCP_FLAG_PSH;
 		}
 
+		#if( ( ipconfigTCP_LARGE_SEND != 0 ) && ( ipconfigTCP_LARGE_SEND_OFFLOAD == 0 ) )
+		{
+			/* Return the length of the first frame of a large send. */
+			lDataLen -= ( int32_t ) pxSocket->u.xTCP.uxLargeSendLength;
+		}
+		#endif
+
 		lDataLen += ( int32_t ) ( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER + uxOptionsLength );
 	}
 
@@ -1899,6 +2123,291 @@ int32_t lStreamPos;
 }
 /*-----------------------------------------------------------*/
 
+#if( ipconfigTCP_LARGE_SEND != 0 )
+
+	static int32_t prvTCPLargeSendLength( FreeRTOS_Socket_t *pxSocket, int32_t lStreamPos, int32_t lDataLen )
+	{
+	TCPWindow_t *pxTCPWindow = &( pxSocket->u.xTCP.xTCPWindow );
+	int32_t lMaxLength = lDataLen;
+	int32_t lQueued;
+	BaseType_t xPossible = pdTRUE;
+
+		#if( ipconfigTCP_LARGE_SEND_OFFLOAD != 0 )
+		{
+			/* The large segment is passed whole to the interface, it needs a
+			network buffer of a variable size. */
+			if( xBufferAllocFixedSize != pdFALSE )
+			{
+				xPossible = pdFALSE;
+			}
+		}
+		#endif
+
+		/* A large send starts with a full-sized segment, which is the last one
+		fetched from the TX queue, so that new segments will follow it
+		directly. */
+		if( ( xPossible != pdFALSE ) &&
+			( lDataLen == ( int32_t ) pxTCPWindow->usMSS ) &&
+			( ( pxTCPWindow->ulOurSequenceNumber + ( uint32_t ) lDataLen ) == pxTCPWindow->tx.ulHighestSequenceNumber ) )
+		{
+			/* Not more than the data in txStream from this segment onwards. */
+			lQueued = ( int32_t ) uxStreamBufferDistance( pxSocket->u.xTCP.txStream, ( size_t ) lStreamPos, pxSocket->u.xTCP.txStream->uxHead );
+			lMaxLength = FreeRTOS_min_int32( lQueued, ( int32_t ) ipconfigTCP_LARGE_SEND_SEGMENTS * ( int32_t ) pxTCPWindow->usMSS );
+			lMaxLength = FreeRTOS_max_int32( lMaxLength, lDataLen );
+		}
+
+		return lMaxLength;
+	}
+	/*-----------------------------------------------------------*/
+
+	static int32_t prvTCPLargeSendAppend( FreeRTOS_Socket_t *pxSocket, uint8_t *pucSendData, int32_t lDataLen, int32_t lMaxLength )
+	{
+	TCPWindow_t *pxTCPWindow = &( pxSocket->u.xTCP.xTCPWindow );
+	int32_t lLength, lStreamPos = 0;
+	#if( ipconfigTCP_LARGE_SEND_OFFLOAD != 0 )
+		size_t uxOffset;
+	#endif
+
+		while( lDataLen < lMaxLength )
+		{
+			lLength = ( int32_t ) ulTCPWindowTxGetNext( pxTCPWindow, pxSocket->u.xTCP.ulWindowSize, ( uint32_t ) ( lMaxLength - lDataLen ), &lStreamPos );
+
+			if( lLength <= 0 )
+			{
+				break;
+			}
+
+			#if( ipconfigTCP_LARGE_SEND_OFFLOAD != 0 )
+			{
+				uxOffset = uxStreamBufferDistance( pxSocket->u.xTCP.txStream, pxSocket->u.xTCP.txStream->uxTail, ( size_t ) lStreamPos );
+				lLength = ( int32_t ) uxStreamBufferGet( pxSocket->u.xTCP.txStream, uxOffset, pucSendData + lDataLen, ( size_t ) lLength, pdTRUE );
+			}
+			#else
+			{
+				/* The segments are contiguous in txStream, their data is
+				fetched when the frames are sent. */
+				( void ) pucSendData;
+			}
+			#endif
+
+			lDataLen += lLength;
+
+			if( lLength < ( int32_t ) pxTCPWindow->usMSS )
+			{
+				/* Only the last frame may be shorter than MSS. */
+				break;
+			}
+		}
+
+		return lDataLen;
+	}
+	/*-----------------------------------------------------------*/
+
+	#if( ipconfigTCP_LARGE_SEND_OFFLOAD == 0 )
+
+		static void prvTCPLargeSendStart( FreeRTOS_Socket_t *pxSocket, TCPLargeSend_t *pxLargeSend, NetworkBufferDescriptor_t *pxNetworkBuffer )
+		{
+		TCPPacket_t *pxTCPPacket = ( TCPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer;
+
+			pxLargeSend->uxTCPHeaderLength = ( size_t ) ( ( pxTCPPacket->xTCPHeader.ucTCPOffset >> 4 ) << 2 );
+			pxLargeSend->uxHeaderLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + pxLargeSend->uxTCPHeaderLength;
+			pxLargeSend->uxLength = ( size_t ) FreeRTOS_ntohs( pxTCPPacket->xIPHeader.usLength ) - ( ipSIZE_OF_IPv4_HEADER + pxLargeSend->uxTCPHeaderLength );
+			pxLargeSend->ulSequenceNumber = FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulSequenceNumber );
+
+			/* The data that follows the first frame, as claimed by
+			prvTCPPrepareSend(). */
+			pxLargeSend->uxOffset = pxSocket->u.xTCP.uxLargeSendOffset;
+			pxLargeSend->uxRemaining = pxSocket->u.xTCP.uxLargeSendLength;
+			pxSocket->u.xTCP.uxLargeSendLength = 0u;
+
+			/* All frames but the last are sent without PSH and FIN. */
+			pxLargeSend->ucLastFlags = pxTCPPacket->xTCPHeader.ucTCPFlags;
+			pxTCPPacket->xTCPHeader.ucTCPFlags = ( uint8_t ) ( pxLargeSend->ucLastFlags & ~( ipTCP_FLAG_PSH | ipTCP_FLAG_FIN ) );
+
+			#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+			{
+				pxTCPPacket->xIPHeader.usHeaderChecksum = 0x00u;
+				pxLargeSend->usIPChecksum = usGenerateChecksum( 0UL, ( uint8_t * ) &( pxTCPPacket->xIPHeader.ucVersionHeaderLength ), ipSIZE_OF_IPv4_HEADER );
+				pxLargeSend->usIPChecksum = ~FreeRTOS_htons( pxLargeSend->usIPChecksum );
+
+				/* The protocol field of the pseudo header, the IP addresses and
+				the TCP header.  The TCP length will be added per frame. */
+				pxTCPPacket->xTCPHeader.usChecksum = 0x00u;
+				pxLargeSend->usTCPChecksum = usGenerateChecksum( ( uint32_t ) ipPROTOCOL_TCP, ( uint8_t * ) &( pxTCPPacket->xIPHeader.ulSourceIPAddress ),
+					( 2u * sizeof( pxTCPPacket->xIPHeader.ulSourceIPAddress ) ) + pxLargeSend->uxTCPHeaderLength );
+				pxLargeSend->usTCPChecksum = ~FreeRTOS_htons( pxLargeSend->usTCPChecksum );
+
+				/* The fields that differ per frame, as they were summed. */
+				pxLargeSend->usFirstLength = pxTCPPacket->xIPHeader.usLength;
+				pxLargeSend->usFirstIdentification = pxTCPPacket->xIPHeader.usIdentification;
+				pxLargeSend->ulFirstSequenceNumber = pxTCPPacket->xTCPHeader.ulSequenceNumber;
+
+				/* The flags share a 16-bit word with the header length. */
+				memcpy( &( pxLargeSend->usMiddleFlags ), &( pxTCPPacket->xTCPHeader.ucTCPOffset ), sizeof( pxLargeSend->usMiddleFlags ) );
+				pxTCPPacket->xTCPHeader.ucTCPFlags = pxLargeSend->ucLastFlags;
+				memcpy( &( pxLargeSend->usLastFlags ), &( pxTCPPacket->xTCPHeader.ucTCPOffset ), sizeof( pxLargeSend->usLastFlags ) );
+				pxTCPPacket->xTCPHeader.ucTCPFlags = ( uint8_t ) ( pxLargeSend->ucLastFlags & ~( ipTCP_FLAG_PSH | ipTCP_FLAG_FIN ) );
+			}
+			#endif /* ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 */
+		}
+		/*-----------------------------------------------------------*/
+
+		#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+
+			static void prvTCPLargeSendChecksum( const TCPLargeSend_t *pxLargeSend, NetworkBufferDescriptor_t *pxFrame )
+			{
+			TCPPacket_t *pxTCPPacket = ( TCPPacket_t * ) pxFrame->pucEthernetBuffer;
+			uint32_t ulSum;
+			uint16_t usChecksum, usFrameFlags;
+
+				usChecksum = usIncrementalChecksum16( pxLargeSend->usIPChecksum, pxLargeSend->usFirstLength, pxTCPPacket->xIPHeader.usLength );
+				pxTCPPacket->xIPHeader.usHeaderChecksum = usIncrementalChecksum16( usChecksum, pxLargeSend->usFirstIdentification, pxTCPPacket->xIPHeader.usIdentification );
+
+				usChecksum = usIncrementalChecksum32( pxLargeSend->usTCPChecksum, pxLargeSend->ulFirstSequenceNumber, pxTCPPacket->xTCPHeader.ulSequenceNumber );
+				memcpy( &usFrameFlags, &( pxTCPPacket->xTCPHeader.ucTCPOffset ), sizeof( usFrameFlags ) );
+				if( usFrameFlags != pxLargeSend->usMiddleFlags )
+				{
+					usChecksum = usIncrementalChecksum16( usChecksum, pxLargeSend->usMiddleFlags, pxLargeSend->usLastFlags );
+				}
+
+				/* Back to a running sum, add the TCP length and the payload. */
+				ulSum = ( uint32_t ) ( uint16_t ) ~FreeRTOS_ntohs( usChecksum );
+				ulSum += ( uint32_t ) ( pxLargeSend->uxTCPHeaderLength + pxLargeSend->uxLength );
+				ulSum = ( ulSum & 0xffffUL ) + ( ulSum >> 16 );
+				usChecksum = ( uint16_t ) ~usGenerateChecksum( ulSum, pxFrame->pucEthernetBuffer + pxLargeSend->uxHeaderLength, pxLargeSend->uxLength );
+
+				/* A calculated checksum of 0 must be inverted as 0 means the
+				checksum is disabled. */
+				if( usChecksum == 0x00u )
+				{
+					usChecksum = 0xffffu;
+				}
+				pxTCPPacket->xTCPHeader.usChecksum = FreeRTOS_htons( usChecksum );
+			}
+			/*-----------------------------------------------------------*/
+
+		#endif /* ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 */
+
+		static NetworkBufferDescriptor_t *prvTCPLargeSendNext( FreeRTOS_Socket_t *pxSocket, TCPLargeSend_t *pxLargeSend, const NetworkBufferDescriptor_t *pxPrevious )
+		{
+		NetworkBufferDescriptor_t *pxFrame;
+		TCPPacket_t *pxTCPPacket;
+
+			pxLargeSend->ulSequenceNumber += ( uint32_t ) pxLargeSend->uxLength;
+			pxLargeSend->uxLength = ( size_t ) FreeRTOS_min_uint32( ( uint32_t ) pxSocket->u.xTCP.xTCPWindow.usMSS, ( uint32_t ) pxLargeSend->uxRemaining );
+
+			pxFrame = pxGetNetworkBufferWithDescriptor( pxLargeSend->uxHeaderLength + pxLargeSend->uxLength, ( TickType_t ) 0 );
+
+			if( pxFrame != NULL )
+			{
+				memcpy( pxFrame->pucEthernetBuffer, pxPrevious->pucEthernetBuffer, pxLargeSend->uxHeaderLength );
+
+				/* Copy the payload from txStream in 'peek' mode, like
+				prvTCPPrepareSend() does. */
+				( void ) uxStreamBufferGet( pxSocket->u.xTCP.txStream, pxLargeSend->uxOffset, pxFrame->pucEthernetBuffer + pxLargeSend->uxHeaderLength, pxLargeSend->uxLength, pdTRUE );
+				pxLargeSend->uxOffset += pxLargeSend->uxLength;
+				pxLargeSend->uxRemaining -= pxLargeSend->uxLength;
+				pxFrame->xDataLength = pxLargeSend->uxHeaderLength + pxLargeSend->uxLength;
+
+				#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+				{
+					pxFrame->pxNextBuffer = NULL;
+				}
+				#endif
+
+				pxTCPPacket = ( TCPPacket_t * ) pxFrame->pucEthernetBuffer;
+				pxTCPPacket->xIPHeader.usLength = FreeRTOS_htons( ( uint16_t ) ( ipSIZE_OF_IPv4_HEADER + pxLargeSend->uxTCPHeaderLength + pxLargeSend->uxLength ) );
+				pxTCPPacket->xIPHeader.usIdentification = FreeRTOS_htons( usPacketIdentifier );
+				usPacketIdentifier++;
+				pxTCPPacket->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( pxLargeSend->ulSequenceNumber );
+
+				if( pxLargeSend->uxRemaining == 0u )
+				{
+					pxTCPPacket->xTCPHeader.ucTCPFlags = pxLargeSend->ucLastFlags;
+				}
+
+				#if defined( ipconfigETHERNET_MINIMUM_PACKET_BYTES )
+				{
+					if( pxFrame->xDataLength < ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES )
+					{
+					BaseType_t xIndex;
+
+						for( xIndex = ( BaseType_t ) pxFrame->xDataLength; xIndex < ( BaseType_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES; xIndex++ )
+						{
+							pxFrame->pucEthernetBuffer[ xIndex ] = 0u;
+						}
+						pxFrame->xDataLength = ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES;
+					}
+				}
+				#endif
+			}
+
+			return pxFrame;
+		}
+		/*-----------------------------------------------------------*/
+
+		/*
+		 * The first frame of a large send has been prepared as usual, except
+		 * for the checksums.  Every next frame is allocated before the previous
+		 * one is sent, and gets a copy of its headers, in which only the
+		 * sequence number, the lengths, the IP identification and the flags
+		 * PSH and FIN differ.  The payload is copied from txStream directly
+		 * into the frame.  The IP checksum and the sum of the pseudo header
+		 * plus TCP header are calculated once, and are updated for each frame
+		 * with usIncrementalChecksum16/32().  Only the payload must still be
+		 * summed.
+		 */
+		static void prvTCPLargeSendSlice( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer, BaseType_t xReleaseAfterSend )
+		{
+		TCPLargeSend_t xLargeSend;
+		NetworkBufferDescriptor_t *pxFrame = pxNetworkBuffer;
+		NetworkBufferDescriptor_t *pxPrevious = NULL;
+		BaseType_t xPreviousRelease = xReleaseAfterSend;
+
+			prvTCPLargeSendStart( pxSocket, &xLargeSend, pxNetworkBuffer );
+
+			for( ;; )
+			{
+				#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+				{
+					prvTCPLargeSendChecksum( &xLargeSend, pxFrame );
+				}
+				#endif
+
+				/* The headers of the previous frame have been copied, it can be
+				sent now. */
+				if( pxPrevious != NULL )
+				{
+					xNetworkInterfaceOutput( pxPrevious, xPreviousRelease );
+					xPreviousRelease = pdTRUE;
+				}
+				pxPrevious = pxFrame;
+
+				if( xLargeSend.uxRemaining == 0u )
+				{
+					break;
+				}
+
+				pxFrame = prvTCPLargeSendNext( pxSocket, &xLargeSend, pxPrevious );
+
+				if( pxFrame == NULL )
+				{
+					/* The segments that were not sent are queued for a resend
+					with priority, which does not wait for a time-out. */
+					FreeRTOS_debug_printf( ( "prvTCPLargeSendSlice: no buffer for %u bytes\n", ( unsigned ) xLargeSend.uxRemaining ) );
+					vTCPWindowTxRequeue( &( pxSocket->u.xTCP.xTCPWindow ), xLargeSend.ulSequenceNumber );
+					break;
+				}
+			}
+
+			xNetworkInterfaceOutput( pxPrevious, xPreviousRelease );
+		}
+
+	#endif /* ipconfigTCP_LARGE_SEND_OFFLOAD == 0 */
+
+#endif /* ipconfigTCP_LARGE_SEND != 0 */
+/*-----------------------------------------------------------*/
+
 /*
  * Calculate after how much time this socket needs to be checked again.
  */
@@ -2574,6 +3083,11 @@ int32_t lRxSpace;
 	#else
 		int32_t lMinLength;
 	#endif
+	#if( ipconfigTCP_DELAYED_ACK_SEGMENTS == 0 )
+		const BaseType_t xAckDue = pdFALSE;
+	#else
+		BaseType_t xAckDue = pdFALSE;
+	#endif
 #endif
 
 	/* Set the time-out field, so that we'll be called by the IP-task in case no
@@ -2588,9 +3102,26 @@ int32_t lRxSpace;
 		}
 		#endif /* ipconfigTCP_ACK_EARLIER_PACKET */
 
+		#if( ipconfigTCP_DELAYED_ACK_SEGMENTS > 0 )
+		{
+			/* Segments that are received in a burst are acknowledged together,
+			but not more than ipconfigTCP_DELAYED_ACK_SEGMENTS at a time. */
+			if( ulReceiveLength > 0u )
+			{
+				pxSocket->u.xTCP.ucDelayedAckCount++;
+
+				if( pxSocket->u.xTCP.ucDelayedAckCount >= ( uint8_t ) ipconfigTCP_DELAYED_ACK_SEGMENTS )
+				{
+					xAckDue = pdTRUE;
+				}
+			}
+		}
+		#endif /* ipconfigTCP_DELAYED_ACK_SEGMENTS */
+
 		/* In case we're receiving data continuously, we might postpone sending
 		an ACK to gain performance. */
 		if( ( ulReceiveLength > 0 ) &&							/* Data was sent to this socket. */
+			( xAckDue == pdFALSE ) &&							/* Not enough segments were received to require an ACK. */
 			( lRxSpace >= lMinLength ) &&						/* There is Rx space for more data. */
 			( pxSocket->u.xTCP.bits.bFinSent == pdFALSE_UNSIGNED ) &&	/* Not in a closure phase. */
 			( xSendLength == ( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER ) ) && /* No Tx data or options to be sent. */
@@ -197,6 +197,22 @@ extern void vListInsertGeneric( List_t * const pxList, ListItem_t * const pxNewL
 	static uint32_t prvTCPWindowFastRetransmit( TCPWindow_t *pxWindow, uint32_t ulFirst );
 #endif /* ipconfigUSE_TCP_WIN == 1 */
 
+/*
+ * Return the bucket of the segment index in which a segment with a given
+ * sequence number is stored.
+ */
+#if( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 ) )
+	static List_t *prvTCPWindowIndexBucket( uint32_t ulSequenceNumber );
+#endif
+
+/*
+ * Find the segment that starts at 'ulSequenceNumber' in one of the segment
+ * lists of a window, 'xRxSegments' or 'xTxSegments', using the segment index.
+ */
+#if( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 ) )
+	static TCPSegment_t *prvTCPWindowIndexFind( const List_t *pxSegments, uint32_t ulSequenceNumber );
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* TCP segment pool. */
@@ -209,6 +225,13 @@ extern void vListInsertGeneric( List_t * const pxList, ListItem_t * const pxNewL
 	static List_t xSegmentList;
 #endif
 
+/* Segments in use, indexed on their sequence number.  A segment is identified
+by its sequence number together with the list that owns it, so a single table
+can be shared by all windows. */
+#if( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 ) )
+	static List_t xSegmentIndex[ ipconfigTCP_WIN_SEGMENT_HASH_SIZE ];
+#endif
+
 /* Logging verbosity level. */
 BaseType_t xTCPWindowLoggingLevel = 0;
 
@@ -307,6 +330,16 @@ void vListInsertGeneric( List_t * const pxList, ListItem_t * const pxNewListItem
 		/* Allocate space for 'xTCPSegments' and store them in 'xSegmentList'. */
 
 		vListInitialise( &xSegmentList );
+
+		#if( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+		{
+			for( xIndex = 0; xIndex < ipconfigTCP_WIN_SEGMENT_HASH_SIZE; xIndex++ )
+			{
+				vListInitialise( &( xSegmentIndex[ xIndex ] ) );
+			}
+		}
+		#endif /* ipconfigUSE_TCP_WIN_SEGMENT_INDEX */
+
 		xTCPSegments = ( TCPSegment_t * ) pvPortMallocLarge( ipconfigTCP_WIN_SEG_COUNT * sizeof( xTCPSegments[ 0 ] ) );
 
 		if( xTCPSegments == NULL )
@@ -327,6 +360,11 @@ void vListInsertGeneric( List_t * const pxList, ListItem_t * const pxNewListItem
 				nulled already.  Set the owner to a segment descriptor. */
 				listSET_LIST_ITEM_OWNER( &( xTCPSegments[ xIndex ].xListItem ), ( void* ) &( xTCPSegments[ xIndex ] ) );
 				listSET_LIST_ITEM_OWNER( &( xTCPSegments[ xIndex ].xQueueItem ), ( void* ) &( xTCPSegments[ xIndex ] ) );
+				#if( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+				{
+					listSET_LIST_ITEM_OWNER( &( xTCPSegments[ xIndex ].xIndexItem ), ( void* ) &( xTCPSegments[ xIndex ] ) );
+				}
+				#endif
 
 				/* And add it to the pool of available segments */
 				vListInsertFifo( &xSegmentList, &( xTCPSegments[xIndex].xListItem ) );
@@ -345,27 +383,34 @@ void vListInsertGeneric( List_t * const pxList, ListItem_t * const pxNewListItem
 
 	static TCPSegment_t *xTCPWindowRxFind( TCPWindow_t *pxWindow, uint32_t ulSequenceNumber )
 	{
-	const ListItem_t *pxIterator;
-	const MiniListItem_t* pxEnd;
-	TCPSegment_t *pxSegment, *pxReturn = NULL;
+	TCPSegment_t *pxReturn = NULL;
 
 		/* Find a segment with a given sequence number in the list of received
 		segments. */
-
-		pxEnd = ( const MiniListItem_t* )listGET_END_MARKER( &pxWindow->xRxSegments );
-
-		for( pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxEnd );
-			 pxIterator != ( const ListItem_t * ) pxEnd;
-			 pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxIterator ) )
+		#if( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
 		{
-			pxSegment = ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+			pxReturn = prvTCPWindowIndexFind( &( pxWindow->xRxSegments ), ulSequenceNumber );
+		}
+		#else
+		{
+		const ListItem_t *pxIterator;
+		const MiniListItem_t* pxEnd = ( const MiniListItem_t* )listGET_END_MARKER( &pxWindow->xRxSegments );
+		TCPSegment_t *pxSegment;
 
-			if( pxSegment->ulSequenceNumber == ulSequenceNumber )
+			for( pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxEnd );
+				 pxIterator != ( const ListItem_t * ) pxEnd;
+				 pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxIterator ) )
 			{
-				pxReturn = pxSegment;
-				break;
+				pxSegment = ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+
+				if( pxSegment->ulSequenceNumber == ulSequenceNumber )
+				{
+					pxReturn = pxSegment;
+					break;
+				}
 			}
 		}
+		#endif /* ipconfigUSE_TCP_WIN_SEGMENT_INDEX */
 
 		return pxReturn;
 	}
@@ -379,6 +424,10 @@ void vListInsertGeneric( List_t * const pxList, ListItem_t * const pxNewListItem
 	{
 	TCPSegment_t *pxSegment;
 	ListItem_t * pxItem;
+	#if( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+		MiniListItem_t *pxWhere;
+		const MiniListItem_t *pxEnd;
+	#endif
 
 		/* Allocate a new segment.  The socket will borrow all segments from a
 		common pool: 'xSegmentList', which is a list of 'TCPSegment_t' */
@@ -403,7 +452,28 @@ void vListInsertGeneric( List_t * const pxList, ListItem_t * const pxNewListItem
 			uxListRemove( pxItem );
 
 			/* Add it to either the connections' Rx or Tx queue. */
-			vListInsertFifo( xIsForRx ? &pxWindow->xRxSegments : &pxWindow->xTxSegments, pxItem );
+			#if( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+			if( xIsForRx != 0 )
+			{
+				/* Keep the Rx segments sorted on sequence number.  Out-of-order
+				segments normally arrive in increasing order, so start looking
+				for the position at the tail of the list. */
+				pxEnd = ( const MiniListItem_t * ) listGET_END_MARKER( &pxWindow->xRxSegments );
+				pxWhere = ( MiniListItem_t * ) pxEnd;
+
+				while( ( pxWhere->pxPrevious != ( ListItem_t * ) pxEnd ) &&
+					   ( xSequenceGreaterThan( ( ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxWhere->pxPrevious ) )->ulSequenceNumber, ulSequenceNumber ) != pdFALSE ) )
+				{
+					pxWhere = ( MiniListItem_t * ) pxWhere->pxPrevious;
+				}
+
+				vListInsertGeneric( &pxWindow->xRxSegments, pxItem, pxWhere );
+			}
+			else
+			#endif /* ipconfigUSE_TCP_WIN_SEGMENT_INDEX */
+			{
+				vListInsertFifo( xIsForRx ? &pxWindow->xRxSegments : &pxWindow->xTxSegments, pxItem );
+			}
 
 			/* And set the segment's timer to zero */
 			vTCPTimerSet( &pxSegment->xTransmitTimer );
@@ -413,6 +483,15 @@ void vListInsertGeneric( List_t * const pxList, ListItem_t * const pxNewListItem
 			pxSegment->lMaxLength = lCount;
 			pxSegment->lDataLength = lCount;
 			pxSegment->ulSequenceNumber = ulSequenceNumber;
+
+			#if( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+			{
+				/* The sequence number of a segment does not change while it is
+				in use, so it can be indexed now. */
+				vListInsertFifo( prvTCPWindowIndexBucket( ulSequenceNumber ), &( pxSegment->xIndexItem ) );
+			}
+			#endif /* ipconfigUSE_TCP_WIN_SEGMENT_INDEX */
+
 			#if( ipconfigHAS_DEBUG_PRINTF != 0 )
 			{
 			static UBaseType_t xLowestLength = ipconfigTCP_WIN_SEG_COUNT;
@@ -541,6 +620,16 @@ void vListInsertGeneric( List_t * const pxList, ListItem_t * const pxNewListItem
 			uxListRemove( &( pxSegment->xListItem ) );
 		}
 
+		#if( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+		{
+			/* And out of the segment index. */
+			if( listLIST_ITEM_CONTAINER( &( pxSegment->xIndexItem ) ) != NULL )
+			{
+				uxListRemove( &( pxSegment->xIndexItem ) );
+			}
+		}
+		#endif /* ipconfigUSE_TCP_WIN_SEGMENT_INDEX */
+
 		/* Return it to xSegmentList */
 		vListInsertFifo( &xSegmentList, &( pxSegment->xListItem ) );
 	}
@@ -548,6 +637,53 @@ void vListInsertGeneric( List_t * const pxList, ListItem_t * const pxNewListItem
 #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
+#if( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 ) )
+
+	static List_t *prvTCPWindowIndexBucket( uint32_t ulSequenceNumber )
+	{
+	uint32_t ulHash;
+
+		/* Consecutive segments differ by about one MSS, so mix the bits before
+		taking the modulo (Knuth's multiplicative hash). */
+		ulHash = ( ulSequenceNumber * 2654435761UL ) >> 16;
+
+		return &( xSegmentIndex[ ulHash % ( uint32_t ) ipconfigTCP_WIN_SEGMENT_HASH_SIZE ] );
+	}
+
+#endif /* ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 ) )
+
+	static TCPSegment_t *prvTCPWindowIndexFind( const List_t *pxSegments, uint32_t ulSequenceNumber )
+	{
+	const List_t *pxBucket = prvTCPWindowIndexBucket( ulSequenceNumber );
+	const MiniListItem_t *pxEnd = ( const MiniListItem_t * ) listGET_END_MARKER( pxBucket );
+	const ListItem_t *pxIterator;
+	TCPSegment_t *pxSegment, *pxReturn = NULL;
+
+		/* All windows share the index.  A segment belongs to the window if its
+		'xListItem' is linked in the window's xRxSegments or xTxSegments. */
+		for( pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxEnd );
+			 pxIterator != ( const ListItem_t * ) pxEnd;
+			 pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxIterator ) )
+		{
+			pxSegment = ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+
+			if( ( pxSegment->ulSequenceNumber == ulSequenceNumber ) &&
+				( ( const List_t * ) listLIST_ITEM_CONTAINER( &( pxSegment->xListItem ) ) == pxSegments ) )
+			{
+				pxReturn = pxSegment;
+				break;
+			}
+		}
+
+		return pxReturn;
+	}
+
+#endif /* ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 ) */
+/*-----------------------------------------------------------*/
+
 #if( ipconfigUSE_TCP_WIN == 1 )
 
 	void vTCPWindowDestroy( TCPWindow_t *pxWindow )
@@ -741,6 +877,17 @@ const int32_t l500ms = 500;
 					pxBest = pxSegment;
 				}
 			}
+
+			#if( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+			{
+				/* xRxSegments is sorted on sequence number: the first match is
+				the lowest, and no match can follow a segment beyond the range. */
+				if( ( pxBest != NULL ) || ( xSequenceGreaterThanOrEqual( pxSegment->ulSequenceNumber, ulNextSequenceNumber ) != pdFALSE ) )
+				{
+					break;
+				}
+			}
+			#endif /* ipconfigUSE_TCP_WIN_SEGMENT_INDEX */
 		}
 
 		if( ( pxBest != NULL ) &&
@@ -1439,6 +1586,85 @@ const int32_t l500ms = 500;
 #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
+#if( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_LARGE_SEND != 0 ) )
+
+	uint32_t ulTCPWindowTxGetNext( TCPWindow_t *pxWindow, uint32_t ulWindowSize, uint32_t ulMaxLength, int32_t *plPosition )
+	{
+	TCPSegment_t *pxSegment;
+	uint32_t ulReturn = 0UL;
+
+		/* Only new messages are added to a large send.  Segments that must be
+		resent with priority are fetched by the next ulTCPWindowTxGet(). */
+		if( listLIST_IS_EMPTY( &( pxWindow->xPriorityQueue ) ) != pdFALSE )
+		{
+			pxSegment = xTCPWindowPeekHead( &( pxWindow->xTxQueue ) );
+
+			if( ( pxSegment != NULL ) &&
+				( pxSegment->ulSequenceNumber == pxWindow->tx.ulHighestSequenceNumber ) &&
+				( ( uint32_t ) pxSegment->lDataLength <= ulMaxLength ) &&
+				( ( pxWindow->u.bits.bSendFullSize == pdFALSE_UNSIGNED ) || ( pxSegment->lDataLength >= pxSegment->lMaxLength ) ) &&
+				( prvTCPWindowTxHasSpace( pxWindow, ulWindowSize ) != pdFALSE ) )
+			{
+				/* Move it out of the Tx queue, as ulTCPWindowTxGet() does. */
+				pxSegment = xTCPWindowGetHead( &( pxWindow->xTxQueue ) );
+
+				if( pxWindow->pxHeadSegment == pxSegment )
+				{
+					pxWindow->pxHeadSegment = NULL;
+				}
+
+				pxWindow->tx.ulHighestSequenceNumber = pxSegment->ulSequenceNumber + ( ( uint32_t ) pxSegment->lDataLength );
+
+				vListInsertFifo( &pxWindow->xWaitQueue, &pxSegment->xQueueItem );
+				pxSegment->u.bits.bOutstanding = pdTRUE_UNSIGNED;
+				( pxSegment->u.bits.ucTransmitCount )++;
+				vTCPTimerSet( &( pxSegment->xTransmitTimer ) );
+
+				*plPosition = pxSegment->lStreamPos;
+				ulReturn = ( uint32_t ) pxSegment->lDataLength;
+			}
+		}
+
+		return ulReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTCPWindowTxRequeue( TCPWindow_t *pxWindow, uint32_t ulFirst )
+	{
+	const ListItem_t *pxIterator;
+	const MiniListItem_t *pxEnd;
+	TCPSegment_t *pxSegment;
+
+		/* The last segments fetched for a large send could not be sent.  Like
+		prvTCPWindowFastRetransmit(), move them from xWaitQueue to the priority
+		queue, so that they will be sent without waiting for a time-out. */
+		pxEnd = ( const MiniListItem_t * ) listGET_END_MARKER( &( pxWindow->xWaitQueue ) );
+
+		for( pxIterator = ( const ListItem_t * ) listGET_NEXT( pxEnd );
+			 pxIterator != ( const ListItem_t * ) pxEnd; )
+		{
+			pxSegment = ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+
+			/* Hop to the next item before the current gets unlinked. */
+			pxIterator = ( const ListItem_t * ) listGET_NEXT( pxIterator );
+
+			if( xSequenceLessThan( pxSegment->ulSequenceNumber, ulFirst ) == pdFALSE )
+			{
+				/* It was counted as transmitted when it was fetched. */
+				if( pxSegment->u.bits.ucTransmitCount > 0u )
+				{
+					( pxSegment->u.bits.ucTransmitCount )--;
+				}
+
+				uxListRemove( &pxSegment->xQueueItem );
+				vListInsertFifo( &( pxWindow->xPriorityQueue ), &( pxSegment->xQueueItem ) );
+			}
+		}
+	}
+
+#endif /* ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_LARGE_SEND != 0 ) */
+/*-----------------------------------------------------------*/
+
 #if( ipconfigUSE_TCP_WIN == 1 )
 
 	static uint32_t prvTCPWindowTxCheckAck( TCPWindow_t *pxWindow, uint32_t ulFirst, uint32_t ulLast )
@@ -1470,8 +1696,29 @@ const int32_t l500ms = 500;
 		 A Smoothed RTT will increase quickly, but it is conservative when
 		 becoming smaller. */
 
-		for(
-				pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxEnd );
+		#if( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+		{
+			/* Start at the segment that begins at 'ulFirst', in stead of
+			skipping all segments in front of it.  When there is no such
+			segment, the loop below would not confirm any data either. */
+			pxSegment = prvTCPWindowIndexFind( &( pxWindow->xTxSegments ), ulFirst );
+
+			if( pxSegment != NULL )
+			{
+				pxIterator = ( const ListItem_t * ) &( pxSegment->xListItem );
+			}
+			else
+			{
+				pxIterator = ( const ListItem_t * ) pxEnd;
+			}
+		}
+		#else
+		{
+			pxIterator = ( const ListItem_t * ) listGET_NEXT( pxEnd );
+		}
+		#endif /* ipconfigUSE_TCP_WIN_SEGMENT_INDEX */
+
+		for( ;
 				( pxIterator != ( const ListItem_t * ) pxEnd ) && ( xSequenceLessThan( ulSequenceNumber, ulLast ) != 0 );
 			)
 		{
@@ -259,6 +259,16 @@ UDPPacket_t *pxUDPPacket = (UDPPacket_t *) pxNetworkBuffer->pucEthernetBuffer;
 	/* Caller must check for minimum packet size. */
 	pxSocket = pxUDPSocketLookup( usPort );
 
+	#if( ipconfigUSE_DNS == 1 ) && ( ipconfigDNS_USE_CALLBACKS == 1 )
+		if( ( pxSocket != NULL ) && ( xIsDNSSocket( pxSocket ) != pdFALSE ) )
+		{
+			/* A reply to an asynchronous DNS look-up.  It is handled right
+			here instead of being queued on the shared DNS socket. */
+			vARPRefreshCacheEntry( &( pxUDPPacket->xEthernetHeader.xSourceAddress ), pxUDPPacket->xIPHeader.ulSourceIPAddress );
+			xReturn = ( BaseType_t )ulDNSHandlePacket( pxNetworkBuffer );
+		}
+		else
+	#endif
 	if( pxSocket )
 	{
 
@@ -0,0 +1,966 @@
+/*
+ * FreeRTOS+TCP V2.2.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/******************************************************************************
+ *
+ * See the following web page for essential buffer allocation scheme usage and
+ * configuration details:
+ * http://www.FreeRTOS.org/FreeRTOS-Plus/FreeRTOS_Plus_TCP/Embedded_Ethernet_Buffer_Management.html
+ *
+ ******************************************************************************/
+
+/* BufferAllocation_3.c hands out network buffers without taking a semaphore
+and without a critical section around the free list:
+
+ + Like BufferAllocation_1.c, all storage is allocated statically.  The
+   storage is declared in this file, so vNetworkInterfaceAllocateRAMToBuffers()
+   is not used.  pvPortMalloc() is only called to create one semaphore, and
+   not at all when configSUPPORT_STATIC_ALLOCATION is 1.
+
+ + The buffers come in two size classes: ipconfigBUFFER_ALLOC_3_SMALL_BUFFERS
+   buffers of ipconfigBUFFER_ALLOC_3_SMALL_SIZE bytes, and the remaining
+   descriptors get a full Ethernet frame of ipTOTAL_ETHERNET_FRAME_SIZE bytes.
+   A request is served from the smallest class that can hold it.  When that
+   class is empty, the next larger class is used.
+
+ + The free buffers of each class are kept on a stack of descriptor indexes.
+   The head of the stack is a 32-bit word holding a 16-bit index and a 16-bit
+   tag, and it is updated with a compare-and-swap.  The tag changes on every
+   update, so a CAS can not succeed when the same buffer was taken and given
+   back in the mean time (the ABA problem).
+
+ + When ipconfigBUFFER_ALLOC_3_CACHE_SIZE is non-zero, every core keeps a small
+   cache (a "magazine") of free buffers per class.  A core uses its own cache
+   with the local interrupts masked.  Each cache also has a lock flag, taken
+   with a compare-and-swap, so that another core can flush it.  Nobody waits
+   for that lock: when it is held, the caller uses the shared free lists.
+   When the free lists are empty, the requesting core moves the buffers in all
+   caches back to the free lists and tries once more.  Applications can do
+   the same with vNetworkBufferFlushCaches().  Define
+   ipconfigBUFFER_ALLOC_3_CORES and ipconfigBUFFER_ALLOC_3_CORE_ID() on
+   multi-core ports.
+
+A task that asks for a buffer while none is free registers itself as a waiter
+and blocks on a counting semaphore, until a buffer is released or its block
+time expires.  The semaphore is only given when a buffer is released while a
+task is waiting, so it costs nothing while buffers are available.
+
+These statistics are kept:
+ + uxGetNetworkBufferAllocFailures(): the number of failed requests;
+ + uxGetNetworkBufferAllocRetries(): the number of CAS retries;
+ + uxGetNetworkBufferAllocWaits(): the number of requests that had to wait;
+ + xGetNetworkBufferTotalWaitTime(): the sum of those waits;
+ + xGetNetworkBufferMaxWaitTime(): the longest wait.
+
+No board in this repository links this file, so it is not part of any build.
+It has been compiled and exercised on a host with stub kernel functions only;
+it has not run on a target, and it has not been measured. */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "atomic.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "NetworkInterface.h"
+#include "NetworkBufferManagement.h"
+
+/* The number of descriptors that get a small buffer.  All other descriptors
+get a buffer that can hold the biggest Ethernet frame. */
+#ifndef ipconfigBUFFER_ALLOC_3_SMALL_BUFFERS
+	#define ipconfigBUFFER_ALLOC_3_SMALL_BUFFERS	0
+#endif
+
+/* The size of a small buffer, not counting ipBUFFER_PADDING. */
+#ifndef ipconfigBUFFER_ALLOC_3_SMALL_SIZE
+	#define ipconfigBUFFER_ALLOC_3_SMALL_SIZE		256
+#endif
+
+/* The number of free buffers per class that each core may keep aside, or 0 to
+always use the shared free lists. */
+#ifndef ipconfigBUFFER_ALLOC_3_CACHE_SIZE
+	#define ipconfigBUFFER_ALLOC_3_CACHE_SIZE		0
+#endif
+
+/* The number of cores, and a macro that returns the number of the core that it
+is called on, between 0 and ipconfigBUFFER_ALLOC_3_CORES - 1. */
+#ifndef ipconfigBUFFER_ALLOC_3_CORES
+	#define ipconfigBUFFER_ALLOC_3_CORES			1
+#endif
+
+#ifndef ipconfigBUFFER_ALLOC_3_CORE_ID
+	#define ipconfigBUFFER_ALLOC_3_CORE_ID()		0
+#endif
+
+#if( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS >= 0xffff )
+	#error BufferAllocation_3.c supports at most 65534 network buffers
+#endif
+
+#if( ipconfigBUFFER_ALLOC_3_SMALL_BUFFERS >= ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS )
+	#error ipconfigBUFFER_ALLOC_3_SMALL_BUFFERS must leave at least one full-size network buffer
+#endif
+
+/* The obtained network buffer must be large enough to hold a packet that might
+replace the packet that was requested to be sent. */
+#if ipconfigUSE_TCP == 1
+	#define baMINIMAL_BUFFER_SIZE		sizeof( TCPPacket_t )
+#else
+	#define baMINIMAL_BUFFER_SIZE		sizeof( ARPPacket_t )
+#endif /* ipconfigUSE_TCP == 1 */
+
+/* For an Ethernet interrupt to be able to obtain a network buffer there must
+be at least this number of buffers available. */
+#define baINTERRUPT_BUFFER_GET_THRESHOLD	( 3 )
+
+#define baLARGE_BUFFERS			( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS - ipconfigBUFFER_ALLOC_3_SMALL_BUFFERS )
+#define baLARGE_BUFFER_SIZE		( ( size_t ) ipTOTAL_ETHERNET_FRAME_SIZE )
+#define baSMALL_BUFFER_SIZE		( ( size_t ) ipconfigBUFFER_ALLOC_3_SMALL_SIZE )
+
+/* The storage is declared as arrays of size_t, so that the pointer to the
+descriptor, which is stored in front of each buffer, is properly aligned. */
+#define baSTORAGE_WORDS( xSize )	( ( ( xSize ) + ipBUFFER_PADDING + sizeof( size_t ) - 1u ) / sizeof( size_t ) )
+
+/* Indexes into xBufferClasses[]. */
+#define baCLASS_SMALL			( 0 )
+#define baCLASS_LARGE			( 1 )
+#define baNUM_CLASSES			( 2 )
+
+/* The head of a free list: a tag in the high 16 bits and the index of the
+first free descriptor in the low 16 bits. */
+#define baINDEX_MASK			( 0x0000ffffUL )
+#define baTAG_INCREMENT			( 0x00010000UL )
+#define baNO_INDEX				( 0x0000ffffUL )
+
+typedef struct xBUFFER_CLASS
+{
+	volatile uint32_t ulHead;	/* Tag and index of the first free buffer. */
+	size_t uxBufferSize;		/* The size of the buffers in this class. */
+} BufferClass_t;
+
+#if( ipconfigBUFFER_ALLOC_3_CACHE_SIZE > 0 )
+	typedef struct xBUFFER_CACHE
+	{
+		volatile uint32_t ulLocked;	/* Non-zero while the cache is in use. */
+		UBaseType_t uxCount;
+		NetworkBufferDescriptor_t *pxBuffers[ ipconfigBUFFER_ALLOC_3_CACHE_SIZE ];
+	} BufferCache_t;
+#endif
+
+/* The descriptors.  The payload of a descriptor may be exchanged with the
+payload of another descriptor (see pxResizeNetworkBufferWithDescriptor()), so
+the size class of a buffer is found from the address of its payload. */
+static NetworkBufferDescriptor_t xNetworkBuffers[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ];
+
+/* The storage of the payloads. */
+static size_t uxLargeStorage[ baLARGE_BUFFERS ][ baSTORAGE_WORDS( baLARGE_BUFFER_SIZE ) ];
+#if( ipconfigBUFFER_ALLOC_3_SMALL_BUFFERS > 0 )
+	static size_t uxSmallStorage[ ipconfigBUFFER_ALLOC_3_SMALL_BUFFERS ][ baSTORAGE_WORDS( baSMALL_BUFFER_SIZE ) ];
+#endif
+
+static BufferClass_t xBufferClasses[ baNUM_CLASSES ];
+
+/* For every descriptor on a free list, the index of the next one. */
+static uint16_t usNextFree[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ];
+
+/* A bit is set for every descriptor that is free, so that a second release of
+the same buffer can be detected. */
+static volatile uint32_t ulFreeBits[ ( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS + 31 ) / 32 ];
+
+#if( ipconfigBUFFER_ALLOC_3_CACHE_SIZE > 0 )
+	static BufferCache_t xBufferCaches[ ipconfigBUFFER_ALLOC_3_CORES ][ baNUM_CLASSES ];
+#endif
+
+/* Some statistics about the use of buffers. */
+static volatile uint32_t ulFreeCount = 0u;
+static volatile uint32_t ulMinimumFreeNetworkBuffers = 0u;
+static volatile uint32_t ulAllocFailures = 0u;
+static volatile uint32_t ulAllocRetries = 0u;
+static volatile uint32_t ulAllocWaits = 0u;
+static volatile uint32_t ulTotalWaitTime = 0u;
+static TickType_t xMaxWaitTime = 0u;
+
+static BaseType_t xBuffersInitialised = pdFALSE;
+
+/* A task that has to wait for a buffer blocks on this semaphore.  It is only
+given when a buffer is released while ulWaitingTasks is non-zero. */
+static SemaphoreHandle_t xBufferReleasedSemaphore = NULL;
+static volatile uint32_t ulWaitingTasks = 0u;
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	static StaticSemaphore_t xBufferReleasedSemaphoreBuffer;
+#endif
+
+/* When all buffers have the maximum size, FreeRTOS_TCP_IP.c does not have to
+resize them. */
+#if( ipconfigBUFFER_ALLOC_3_SMALL_BUFFERS == 0 )
+	const BaseType_t xBufferAllocFixedSize = pdTRUE;
+#else
+	const BaseType_t xBufferAllocFixedSize = pdFALSE;
+#endif
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Return the index of a descriptor, or baNO_INDEX if it is not one of
+ * xNetworkBuffers[].
+ */
+static uint32_t prvBufferIndex( const NetworkBufferDescriptor_t *pxBuffer );
+
+/*
+ * Return the size class of the payload that a descriptor currently has.
+ */
+static BaseType_t prvBufferClass( const NetworkBufferDescriptor_t *pxBuffer );
+
+/*
+ * Store a pointer to the descriptor in front of its payload.
+ */
+static void prvSetBackPointer( NetworkBufferDescriptor_t *pxBuffer );
+
+/*
+ * Push a buffer on, or pop a buffer from, the free list of a size class.
+ */
+static void prvPushFreeBuffer( NetworkBufferDescriptor_t *pxBuffer, BaseType_t xClass );
+static NetworkBufferDescriptor_t *prvPopFreeBuffer( BaseType_t xClass );
+
+/*
+ * Take a buffer from class xFirstClass or from a larger class, without
+ * blocking.
+ */
+static NetworkBufferDescriptor_t *prvTakeBuffer( BaseType_t xFirstClass );
+
+/*
+ * Take a buffer that can hold xRequestedSizeBytes, without blocking.
+ */
+static NetworkBufferDescriptor_t *prvGetBuffer( size_t xRequestedSizeBytes );
+
+/*
+ * Give back a buffer.  Returns pdFALSE if it was free already.
+ */
+static BaseType_t prvReleaseBuffer( NetworkBufferDescriptor_t *pxBuffer );
+
+/*
+ * Latch the lowest number of free buffers.
+ */
+static void prvUpdateMinimum( uint32_t ulCount );
+
+#if( ipconfigBUFFER_ALLOC_3_CACHE_SIZE > 0 )
+	/*
+	 * Take a buffer from, or put a buffer in, the cache of the current core.
+	 */
+	static NetworkBufferDescriptor_t *prvCacheGet( BaseType_t xClass );
+	static BaseType_t prvCachePut( NetworkBufferDescriptor_t *pxBuffer, BaseType_t xClass );
+
+	/*
+	 * Try to lock, or unlock, a cache.  The lock is never waited for.
+	 */
+	static BaseType_t prvCacheTryLock( BufferCache_t *pxCache );
+	static void prvCacheUnlock( BufferCache_t *pxCache );
+
+	/*
+	 * Move the buffers in the caches of all cores back to the free lists.
+	 * Returns the number of buffers moved.
+	 */
+	static UBaseType_t prvFlushCaches( void );
+#endif
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvBufferIndex( const NetworkBufferDescriptor_t *pxBuffer )
+{
+size_t uxOffset;
+uint32_t ulReturn = baNO_INDEX;
+
+	uxOffset = ( size_t ) ( ( ( const uint8_t * ) pxBuffer ) - ( ( const uint8_t * ) xNetworkBuffers ) );
+
+	if( ( ( const uint8_t * ) pxBuffer >= ( const uint8_t * ) xNetworkBuffers ) &&
+		( uxOffset < sizeof( xNetworkBuffers ) ) &&
+		( ( uxOffset % sizeof( xNetworkBuffers[ 0 ] ) ) == 0u ) )
+	{
+		ulReturn = ( uint32_t ) ( uxOffset / sizeof( xNetworkBuffers[ 0 ] ) );
+	}
+
+	return ulReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvBufferClass( const NetworkBufferDescriptor_t *pxBuffer )
+{
+BaseType_t xReturn = baCLASS_LARGE;
+
+	#if( ipconfigBUFFER_ALLOC_3_SMALL_BUFFERS > 0 )
+	{
+	const uint8_t *pucStorage = pxBuffer->pucEthernetBuffer - ipBUFFER_PADDING;
+
+		if( ( pucStorage >= ( const uint8_t * ) uxSmallStorage ) &&
+			( pucStorage < ( ( const uint8_t * ) uxSmallStorage ) + sizeof( uxSmallStorage ) ) )
+		{
+			xReturn = baCLASS_SMALL;
+		}
+	}
+	#else
+	{
+		( void ) pxBuffer;
+	}
+	#endif
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetBackPointer( NetworkBufferDescriptor_t *pxBuffer )
+{
+	*( ( NetworkBufferDescriptor_t ** ) ( pxBuffer->pucEthernetBuffer - ipBUFFER_PADDING ) ) = pxBuffer;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPushFreeBuffer( NetworkBufferDescriptor_t *pxBuffer, BaseType_t xClass )
+{
+BufferClass_t *pxClass = &( xBufferClasses[ xClass ] );
+uint32_t ulIndex = prvBufferIndex( pxBuffer );
+uint32_t ulOldHead, ulNewHead;
+
+	for( ;; )
+	{
+		ulOldHead = pxClass->ulHead;
+		usNextFree[ ulIndex ] = ( uint16_t ) ( ulOldHead & baINDEX_MASK );
+		ulNewHead = ( ( ulOldHead + baTAG_INCREMENT ) & ~baINDEX_MASK ) | ulIndex;
+
+		if( Atomic_CompareAndSwap_u32( &( pxClass->ulHead ), ulNewHead, ulOldHead ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+		{
+			break;
+		}
+
+		( void ) Atomic_Increment_u32( &ulAllocRetries );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static NetworkBufferDescriptor_t *prvPopFreeBuffer( BaseType_t xClass )
+{
+BufferClass_t *pxClass = &( xBufferClasses[ xClass ] );
+NetworkBufferDescriptor_t *pxReturn = NULL;
+uint32_t ulOldHead, ulNewHead, ulIndex;
+
+	for( ;; )
+	{
+		ulOldHead = pxClass->ulHead;
+		ulIndex = ulOldHead & baINDEX_MASK;
+
+		if( ulIndex == baNO_INDEX )
+		{
+			break;
+		}
+
+		/* usNextFree[ ulIndex ] may be changed by another task once the
+		buffer has been taken, but then the tag has changed and the CAS
+		fails. */
+		ulNewHead = ( ( ulOldHead + baTAG_INCREMENT ) & ~baINDEX_MASK ) | usNextFree[ ulIndex ];
+
+		if( Atomic_CompareAndSwap_u32( &( pxClass->ulHead ), ulNewHead, ulOldHead ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+		{
+			pxReturn = &( xNetworkBuffers[ ulIndex ] );
+			break;
+		}
+
+		( void ) Atomic_Increment_u32( &ulAllocRetries );
+	}
+
+	return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if( ipconfigBUFFER_ALLOC_3_CACHE_SIZE > 0 )
+
+	static NetworkBufferDescriptor_t *prvCacheGet( BaseType_t xClass )
+	{
+	NetworkBufferDescriptor_t *pxReturn = NULL;
+	BufferCache_t *pxCache;
+	UBaseType_t uxSavedInterruptStatus;
+
+		/* The interrupts are masked before the core ID is read, so the task can
+		not move to another core while it uses the cache. */
+		uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			pxCache = &( xBufferCaches[ ipconfigBUFFER_ALLOC_3_CORE_ID() ][ xClass ] );
+
+			/* If another core is flushing this cache, it is empty anyway. */
+			if( prvCacheTryLock( pxCache ) != pdFALSE )
+			{
+				if( pxCache->uxCount > 0u )
+				{
+					pxCache->uxCount--;
+					pxReturn = pxCache->pxBuffers[ pxCache->uxCount ];
+				}
+
+				prvCacheUnlock( pxCache );
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		return pxReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvCachePut( NetworkBufferDescriptor_t *pxBuffer, BaseType_t xClass )
+	{
+	BaseType_t xReturn = pdFALSE;
+	BufferCache_t *pxCache;
+	UBaseType_t uxSavedInterruptStatus;
+
+		uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			pxCache = &( xBufferCaches[ ipconfigBUFFER_ALLOC_3_CORE_ID() ][ xClass ] );
+
+			if( prvCacheTryLock( pxCache ) != pdFALSE )
+			{
+				if( pxCache->uxCount < ( UBaseType_t ) ipconfigBUFFER_ALLOC_3_CACHE_SIZE )
+				{
+					pxCache->pxBuffers[ pxCache->uxCount ] = pxBuffer;
+					pxCache->uxCount++;
+					xReturn = pdTRUE;
+				}
+
+				prvCacheUnlock( pxCache );
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvCacheTryLock( BufferCache_t *pxCache )
+	{
+	BaseType_t xReturn = pdFALSE;
+
+		if( Atomic_CompareAndSwap_u32( &( pxCache->ulLocked ), 1u, 0u ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+		{
+			xReturn = pdTRUE;
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvCacheUnlock( BufferCache_t *pxCache )
+	{
+		( void ) Atomic_AND_u32( &( pxCache->ulLocked ), 0u );
+	}
+	/*-----------------------------------------------------------*/
+
+	static UBaseType_t prvFlushCaches( void )
+	{
+	UBaseType_t uxCore, uxMoved = 0u;
+	BaseType_t xClass;
+	BufferCache_t *pxCache;
+	UBaseType_t uxSavedInterruptStatus;
+
+		for( uxCore = 0u; uxCore < ( UBaseType_t ) ipconfigBUFFER_ALLOC_3_CORES; uxCore++ )
+		{
+			for( xClass = 0; xClass < baNUM_CLASSES; xClass++ )
+			{
+				pxCache = &( xBufferCaches[ uxCore ][ xClass ] );
+
+				/* Mask the interrupts so that the lock is held as briefly as
+				possible.  A cache that is in use by its own core is skipped. */
+				uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+				{
+					if( prvCacheTryLock( pxCache ) != pdFALSE )
+					{
+						while( pxCache->uxCount > 0u )
+						{
+							pxCache->uxCount--;
+							prvPushFreeBuffer( pxCache->pxBuffers[ pxCache->uxCount ], xClass );
+							uxMoved++;
+						}
+
+						prvCacheUnlock( pxCache );
+					}
+				}
+				portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+			}
+		}
+
+		return uxMoved;
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* ipconfigBUFFER_ALLOC_3_CACHE_SIZE */
+
+static void prvUpdateMinimum( uint32_t ulCount )
+{
+uint32_t ulMinimum = ulMinimumFreeNetworkBuffers;
+
+	/* Lower the minimum unless another task lowered it below ulCount. */
+	while( ( ulCount < ulMinimum ) &&
+		   ( Atomic_CompareAndSwap_u32( &ulMinimumFreeNetworkBuffers, ulCount, ulMinimum ) != ATOMIC_COMPARE_AND_SWAP_SUCCESS ) )
+	{
+		ulMinimum = ulMinimumFreeNetworkBuffers;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static NetworkBufferDescriptor_t *prvTakeBuffer( BaseType_t xFirstClass )
+{
+NetworkBufferDescriptor_t *pxReturn = NULL;
+BaseType_t xClass;
+
+	/* Try the smallest class that fits, then the larger ones. */
+	for( xClass = xFirstClass; ( xClass < baNUM_CLASSES ) && ( pxReturn == NULL ); xClass++ )
+	{
+		#if( ipconfigBUFFER_ALLOC_3_CACHE_SIZE > 0 )
+		{
+			pxReturn = prvCacheGet( xClass );
+		}
+		#endif
+
+		if( pxReturn == NULL )
+		{
+			pxReturn = prvPopFreeBuffer( xClass );
+		}
+	}
+
+	return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+static NetworkBufferDescriptor_t *prvGetBuffer( size_t xRequestedSizeBytes )
+{
+NetworkBufferDescriptor_t *pxReturn = NULL;
+BaseType_t xClass;
+uint32_t ulIndex, ulCount;
+
+	if( xRequestedSizeBytes <= baLARGE_BUFFER_SIZE )
+	{
+		#if( ipconfigBUFFER_ALLOC_3_SMALL_BUFFERS > 0 )
+		{
+			xClass = ( xRequestedSizeBytes <= baSMALL_BUFFER_SIZE ) ? baCLASS_SMALL : baCLASS_LARGE;
+		}
+		#else
+		{
+			xClass = baCLASS_LARGE;
+		}
+		#endif
+
+		pxReturn = prvTakeBuffer( xClass );
+
+		#if( ipconfigBUFFER_ALLOC_3_CACHE_SIZE > 0 )
+		{
+			/* The free lists are empty, but the caches of other cores may still
+			hold free buffers.  Steal them and try once more. */
+			if( ( pxReturn == NULL ) && ( prvFlushCaches() > 0u ) )
+			{
+				pxReturn = prvTakeBuffer( xClass );
+			}
+		}
+		#endif
+	}
+
+	if( pxReturn != NULL )
+	{
+		ulIndex = prvBufferIndex( pxReturn );
+		( void ) Atomic_AND_u32( &( ulFreeBits[ ulIndex / 32u ] ), ~( 1UL << ( ulIndex % 32u ) ) );
+
+		/* Atomic_Decrement_u32() returns the value before the decrement. */
+		ulCount = Atomic_Decrement_u32( &ulFreeCount ) - 1u;
+		prvUpdateMinimum( ulCount );
+
+		pxReturn->xDataLength = xRequestedSizeBytes;
+
+		#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+		{
+			/* make sure the buffer is not linked */
+			pxReturn->pxNextBuffer = NULL;
+		}
+		#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+	}
+
+	return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReleaseBuffer( NetworkBufferDescriptor_t *pxBuffer )
+{
+BaseType_t xReturn = pdFALSE;
+BaseType_t xClass;
+uint32_t ulIndex, ulBit;
+
+	ulIndex = prvBufferIndex( pxBuffer );
+	ulBit = 1UL << ( ulIndex % 32u );
+
+	/* Only the caller that sets the bit may put the buffer on a free list. */
+	if( ( Atomic_OR_u32( &( ulFreeBits[ ulIndex / 32u ] ), ulBit ) & ulBit ) == 0u )
+	{
+		xClass = prvBufferClass( pxBuffer );
+
+		#if( ipconfigBUFFER_ALLOC_3_CACHE_SIZE > 0 )
+		{
+			if( prvCachePut( pxBuffer, xClass ) == pdFALSE )
+			{
+				prvPushFreeBuffer( pxBuffer, xClass );
+			}
+		}
+		#else
+		{
+			prvPushFreeBuffer( pxBuffer, xClass );
+		}
+		#endif
+
+		( void ) Atomic_Increment_u32( &ulFreeCount );
+		xReturn = pdTRUE;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if( ipconfigTCP_IP_SANITY != 0 )
+
+	UBaseType_t bIsValidNetworkDescriptor( const NetworkBufferDescriptor_t * pxDesc )
+	{
+	uint32_t ulIndex = prvBufferIndex( pxDesc );
+
+		return ( ulIndex == baNO_INDEX ) ? pdFALSE_UNSIGNED : ( UBaseType_t ) ( ulIndex + 1u );
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t prvIsFreeBuffer( const NetworkBufferDescriptor_t *pxDescr )
+	{
+	uint32_t ulIndex = prvBufferIndex( pxDescr );
+	BaseType_t xReturn = pdFALSE;
+
+		if( ( ulIndex != baNO_INDEX ) && ( ( ulFreeBits[ ulIndex / 32u ] & ( 1UL << ( ulIndex % 32u ) ) ) != 0u ) )
+		{
+			xReturn = pdTRUE;
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* ipconfigTCP_IP_SANITY */
+
+BaseType_t xNetworkBuffersInitialise( void )
+{
+BaseType_t x;
+uint8_t *pucStorage;
+
+	/* Only initialise the buffers if they have not been initialised before. */
+	if( xBufferReleasedSemaphore == NULL )
+	{
+		#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+		{
+			xBufferReleasedSemaphore = xSemaphoreCreateCountingStatic( ( UBaseType_t ) ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, ( UBaseType_t ) 0u,
+				&xBufferReleasedSemaphoreBuffer );
+		}
+		#else
+		{
+			xBufferReleasedSemaphore = xSemaphoreCreateCounting( ( UBaseType_t ) ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, ( UBaseType_t ) 0u );
+		}
+		#endif
+		configASSERT( xBufferReleasedSemaphore );
+	}
+
+	if( ( xBuffersInitialised == pdFALSE ) && ( xBufferReleasedSemaphore != NULL ) )
+	{
+		#if( ipconfigBUFFER_ALLOC_3_SMALL_BUFFERS > 0 )
+		{
+			/* ARP packets can replace application packets, so a small buffer
+			must be at least large enough to hold an ARP or a TCP packet. */
+			configASSERT( baSMALL_BUFFER_SIZE >= baMINIMAL_BUFFER_SIZE );
+		}
+		#endif
+
+		xBufferClasses[ baCLASS_SMALL ].ulHead = baNO_INDEX;
+		xBufferClasses[ baCLASS_SMALL ].uxBufferSize = baSMALL_BUFFER_SIZE;
+		xBufferClasses[ baCLASS_LARGE ].ulHead = baNO_INDEX;
+		xBufferClasses[ baCLASS_LARGE ].uxBufferSize = baLARGE_BUFFER_SIZE;
+
+		/* Push in reverse order, so the first descriptors are used first. */
+		for( x = ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS - 1; x >= 0; x-- )
+		{
+			#if( ipconfigBUFFER_ALLOC_3_SMALL_BUFFERS > 0 )
+			if( x < ipconfigBUFFER_ALLOC_3_SMALL_BUFFERS )
+			{
+				pucStorage = ( uint8_t * ) uxSmallStorage[ x ];
+			}
+			else
+			#endif
+			{
+				pucStorage = ( uint8_t * ) uxLargeStorage[ x - ipconfigBUFFER_ALLOC_3_SMALL_BUFFERS ];
+			}
+
+			xNetworkBuffers[ x ].pucEthernetBuffer = pucStorage + ipBUFFER_PADDING;
+			prvSetBackPointer( &( xNetworkBuffers[ x ] ) );
+
+			/* The list item is not used here, but drivers may expect it to
+			point to its descriptor. */
+			vListInitialiseItem( &( xNetworkBuffers[ x ].xBufferListItem ) );
+			listSET_LIST_ITEM_OWNER( &( xNetworkBuffers[ x ].xBufferListItem ), &xNetworkBuffers[ x ] );
+
+			ulFreeBits[ x / 32 ] |= 1UL << ( x % 32 );
+			prvPushFreeBuffer( &( xNetworkBuffers[ x ] ), prvBufferClass( &( xNetworkBuffers[ x ] ) ) );
+		}
+
+		ulFreeCount = ( uint32_t ) ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS;
+		ulMinimumFreeNetworkBuffers = ( uint32_t ) ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS;
+		xBuffersInitialised = pdTRUE;
+	}
+
+	return ( xBuffersInitialised != pdFALSE ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+NetworkBufferDescriptor_t *pxGetNetworkBufferWithDescriptor( size_t xRequestedSizeBytes, TickType_t xBlockTimeTicks )
+{
+NetworkBufferDescriptor_t *pxReturn = NULL;
+TimeOut_t xTimeOut;
+TickType_t xStartTime, xWaited;
+
+	if( xBuffersInitialised != pdFALSE )
+	{
+		pxReturn = prvGetBuffer( xRequestedSizeBytes );
+
+		if( ( pxReturn == NULL ) && ( xBlockTimeTicks != ( TickType_t ) 0u ) && ( xRequestedSizeBytes <= baLARGE_BUFFER_SIZE ) )
+		{
+			xStartTime = xTaskGetTickCount();
+			vTaskSetTimeOutState( &xTimeOut );
+
+			/* Register as a waiter before looking once more.  A buffer that is
+			released after this look is followed by a give, so the wake-up
+			can not be lost. */
+			( void ) Atomic_Increment_u32( &ulWaitingTasks );
+			pxReturn = prvGetBuffer( xRequestedSizeBytes );
+
+			/* Another waiter may be faster, or a give may be left over from a
+			buffer that was found without blocking: look again after every
+			wake-up, until the block time has expired. */
+			while( ( pxReturn == NULL ) && ( xTaskCheckForTimeOut( &xTimeOut, &xBlockTimeTicks ) == pdFALSE ) )
+			{
+				( void ) xSemaphoreTake( xBufferReleasedSemaphore, xBlockTimeTicks );
+				pxReturn = prvGetBuffer( xRequestedSizeBytes );
+			}
+
+			( void ) Atomic_Decrement_u32( &ulWaitingTasks );
+
+			xWaited = xTaskGetTickCount() - xStartTime;
+			( void ) Atomic_Increment_u32( &ulAllocWaits );
+			( void ) Atomic_Add_u32( &ulTotalWaitTime, ( uint32_t ) xWaited );
+
+			/* A lost update of this statistic is harmless. */
+			if( xMaxWaitTime < xWaited )
+			{
+				xMaxWaitTime = xWaited;
+			}
+		}
+	}
+
+	if( pxReturn == NULL )
+	{
+		( void ) Atomic_Increment_u32( &ulAllocFailures );
+		iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER();
+	}
+	else
+	{
+		iptraceNETWORK_BUFFER_OBTAINED( pxReturn );
+	}
+
+	return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+NetworkBufferDescriptor_t *pxNetworkBufferGetFromISR( size_t xRequestedSizeBytes )
+{
+NetworkBufferDescriptor_t *pxReturn = NULL;
+
+	/* Only take a buffer if there are at least baINTERRUPT_BUFFER_GET_THRESHOLD
+	buffers remaining.  This prevents, to a certain degree at least, a rapidly
+	executing interrupt exhausting buffer and in so doing preventing tasks from
+	continuing. */
+	if( ( xBuffersInitialised != pdFALSE ) && ( ulFreeCount > ( uint32_t ) baINTERRUPT_BUFFER_GET_THRESHOLD ) )
+	{
+		pxReturn = prvGetBuffer( xRequestedSizeBytes );
+	}
+
+	if( pxReturn == NULL )
+	{
+		( void ) Atomic_Increment_u32( &ulAllocFailures );
+		iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER_FROM_ISR();
+	}
+	else
+	{
+		iptraceNETWORK_BUFFER_OBTAINED_FROM_ISR( pxReturn );
+	}
+
+	return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t vNetworkBufferReleaseFromISR( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	if( prvBufferIndex( pxNetworkBuffer ) != baNO_INDEX )
+	{
+		/* The buffer is on a free list before a waiting task is woken. */
+		if( ( prvReleaseBuffer( pxNetworkBuffer ) != pdFALSE ) && ( ulWaitingTasks != 0u ) )
+		{
+			( void ) xSemaphoreGiveFromISR( xBufferReleasedSemaphore, &xHigherPriorityTaskWoken );
+		}
+		iptraceNETWORK_BUFFER_RELEASED( pxNetworkBuffer );
+	}
+
+	return xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+void vReleaseNetworkBufferAndDescriptor( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+{
+	if( prvBufferIndex( pxNetworkBuffer ) == baNO_INDEX )
+	{
+		FreeRTOS_debug_printf( ( "vReleaseNetworkBufferAndDescriptor: Invalid buffer %p\n", pxNetworkBuffer ) );
+	}
+	else
+	{
+		if( prvReleaseBuffer( pxNetworkBuffer ) == pdFALSE )
+		{
+			FreeRTOS_debug_printf( ( "vReleaseNetworkBufferAndDescriptor: %p ALREADY RELEASED (now %lu)\n",
+				pxNetworkBuffer, uxGetNumberOfFreeNetworkBuffers( ) ) );
+		}
+		else if( ulWaitingTasks != 0u )
+		{
+			/* The buffer is on a free list before a waiting task is woken. */
+			( void ) xSemaphoreGive( xBufferReleasedSemaphore );
+		}
+		else
+		{
+			/* Nobody is waiting. */
+		}
+		iptraceNETWORK_BUFFER_RELEASED( pxNetworkBuffer );
+	}
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxGetMinimumFreeNetworkBuffers( void )
+{
+	return ( UBaseType_t ) ulMinimumFreeNetworkBuffers;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxGetNumberOfFreeNetworkBuffers( void )
+{
+	return ( UBaseType_t ) ulFreeCount;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxGetNetworkBufferAllocFailures( void )
+{
+	return ( UBaseType_t ) ulAllocFailures;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxGetNetworkBufferAllocRetries( void )
+{
+	return ( UBaseType_t ) ulAllocRetries;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxGetNetworkBufferAllocWaits( void )
+{
+	return ( UBaseType_t ) ulAllocWaits;
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xGetNetworkBufferTotalWaitTime( void )
+{
+	return ( TickType_t ) ulTotalWaitTime;
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xGetNetworkBufferMaxWaitTime( void )
+{
+	return xMaxWaitTime;
+}
+/*-----------------------------------------------------------*/
+
+void vNetworkBufferFlushCaches( void )
+{
+	#if( ipconfigBUFFER_ALLOC_3_CACHE_SIZE > 0 )
+	{
+		( void ) prvFlushCaches();
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+NetworkBufferDescriptor_t *pxResizeNetworkBufferWithDescriptor( NetworkBufferDescriptor_t * pxNetworkBuffer, size_t xNewSizeBytes )
+{
+NetworkBufferDescriptor_t *pxLarger;
+uint8_t *pucBuffer;
+size_t uxCopyLength;
+
+	if( xNewSizeBytes > xBufferClasses[ prvBufferClass( pxNetworkBuffer ) ].uxBufferSize )
+	{
+		pxLarger = pxGetNetworkBufferWithDescriptor( xNewSizeBytes, ( TickType_t ) 0u );
+
+		if( pxLarger == NULL )
+		{
+			/* In case the allocation fails, return NULL. */
+			pxNetworkBuffer = NULL;
+		}
+		else
+		{
+			uxCopyLength = FreeRTOS_min_uint32( pxNetworkBuffer->xDataLength,
+				xBufferClasses[ prvBufferClass( pxNetworkBuffer ) ].uxBufferSize );
+			memcpy( pxLarger->pucEthernetBuffer, pxNetworkBuffer->pucEthernetBuffer, uxCopyLength );
+
+			/* Exchange the payloads, so the caller keeps its descriptor, and
+			release the descriptor that now has the smaller payload. */
+			pucBuffer = pxLarger->pucEthernetBuffer;
+			pxLarger->pucEthernetBuffer = pxNetworkBuffer->pucEthernetBuffer;
+			pxNetworkBuffer->pucEthernetBuffer = pucBuffer;
+			prvSetBackPointer( pxLarger );
+			prvSetBackPointer( pxNetworkBuffer );
+
+			vReleaseNetworkBufferAndDescriptor( pxLarger );
+		}
+	}
+
+	if( pxNetworkBuffer != NULL )
+	{
+		pxNetworkBuffer->xDataLength = xNewSizeBytes;
+	}
+
+	return pxNetworkBuffer;
+}
+/*-----------------------------------------------------------*/
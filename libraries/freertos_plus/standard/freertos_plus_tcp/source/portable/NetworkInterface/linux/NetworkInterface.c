@@ -0,0 +1,740 @@
+/*
+FreeRTOS+TCP V2.2.1
+Copyright (C) 2019 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ http://aws.amazon.com/freertos
+ http://www.FreeRTOS.org
+*/
+
+/*
+ * Network interface for the FreeRTOS POSIX (Linux) simulator.
+ *
+ * Two back-ends are supported:
+ *
+ * - A TAP device (the default).  The device is opened by name, as set by
+ *   configLINUX_TAP_DEVICE_NAME.  To run without root privileges, create a
+ *   persistent device owned by the user first, then give the host side an
+ *   address in the same subnet as the FreeRTOS+TCP application:
+ *
+ *       sudo ip tuntap add dev tap0 mode tap user $USER
+ *       sudo ip addr add 192.168.10.1/24 dev tap0
+ *       sudo ip link set tap0 up
+ *
+ * - A pcap replay file, selected by defining configLINUX_PCAP_REPLAY_FILE.
+ *   Every frame in the file is passed to the IP-task as a received frame.
+ *   Frames sent by the stack are appended to configLINUX_PCAP_OUTPUT_FILE
+ *   when it is defined, or discarded otherwise.  This mode needs neither a
+ *   network nor any privileges, so it can be used for regression tests.
+ *
+ * Frames are read directly into network buffers and written directly from
+ * them, so no intermediate copies are made.  With ipconfigZERO_COPY_TX_DRIVER
+ * set to 1 the driver releases every buffer once it has been written.  The
+ * driver works with both BufferAllocation_1.c and BufferAllocation_2.c.
+ *
+ * Like the WinPCap driver, a FreeRTOS task simulates the Ethernet interrupt.
+ * It reads all frames that are available, then sleeps for
+ * configLINUX_MAC_INTERRUPT_SIMULATOR_DELAY ticks.  No threads outside the
+ * control of the FreeRTOS simulator are used.
+ *
+ * When ipconfigUSE_LINKED_RX_MESSAGES is set to 1, the frames read in one
+ * poll are chained through 'pxNextBuffer' and passed to the IP-task in a
+ * single eNetworkRxEvent, up to configLINUX_MAX_FRAMES_PER_RX_EVENT frames at
+ * a time.  Comparing ulLinuxFramesReceived with ulLinuxRxEvents shows how
+ * many frames were passed per event.
+ *
+ * This driver is not part of any build target in this tree, because the tree
+ * has no POSIX port of the kernel and no board that uses it.  It has been
+ * compiled to an object file against a host configuration, but it has not
+ * been linked or run.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/time.h>
+#include <net/if.h>
+#include <linux/if_tun.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "NetworkBufferManagement.h"
+#include "NetworkInterface.h"
+
+/* If ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES is set to 1, then the Ethernet
+driver will filter incoming packets and only pass the stack those packets it
+considers need processing. */
+#if( ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES == 0 )
+	#define ipCONSIDER_FRAME_FOR_PROCESSING( pucEthernetBuffer ) eProcessBuffer
+#else
+	#define ipCONSIDER_FRAME_FOR_PROCESSING( pucEthernetBuffer ) eConsiderFrameForProcessing( ( pucEthernetBuffer ) )
+#endif
+
+/* The name of the TAP device to open. */
+#ifndef configLINUX_TAP_DEVICE_NAME
+	#define configLINUX_TAP_DEVICE_NAME		"tap0"
+#endif
+
+/* The number of ticks the interrupt simulator task sleeps when there are no
+more frames to read. */
+#ifndef configLINUX_MAC_INTERRUPT_SIMULATOR_DELAY
+	#define configLINUX_MAC_INTERRUPT_SIMULATOR_DELAY	( ( TickType_t ) 1 )
+#endif
+
+/* The priority of the task that simulates the Ethernet interrupt. */
+#ifndef configMAC_ISR_SIMULATOR_PRIORITY
+	#define configMAC_ISR_SIMULATOR_PRIORITY	( configMAX_PRIORITIES - 1 )
+#endif
+
+/* When set to 1, the replay file is read again from the start once its last
+frame has been passed to the IP-task. */
+#ifndef configLINUX_PCAP_REPLAY_LOOP
+	#define configLINUX_PCAP_REPLAY_LOOP	0
+#endif
+
+/* The maximum number of frames that are chained into a single eNetworkRxEvent
+when ipconfigUSE_LINKED_RX_MESSAGES is 1.  A limit makes sure that a long
+burst does not hold on to all network buffers before the IP-task sees it. */
+#ifndef configLINUX_MAX_FRAMES_PER_RX_EVENT
+	#define configLINUX_MAX_FRAMES_PER_RX_EVENT	16u
+#endif
+
+/* The largest frame that is read from the TAP device or the replay file. */
+#define niMAX_FRAME_SIZE			( ( size_t ) ipTOTAL_ETHERNET_FRAME_SIZE )
+
+/* The space taken by one network buffer when BufferAllocation_1.c is used,
+rounded up so every buffer starts at an 8-byte boundary. */
+#define niBUFFER_SIZE				( ( niMAX_FRAME_SIZE + ipBUFFER_PADDING + 7u ) & ~( ( size_t ) 7u ) )
+
+/* pcap file format constants. */
+#define niPCAP_MAGIC				0xa1b2c3d4UL
+#define niPCAP_MAGIC_SWAPPED		0xd4c3b2a1UL
+#define niPCAP_MAGIC_NSEC			0xa1b23c4dUL
+#define niPCAP_MAGIC_NSEC_SWAPPED	0x4d3cb2a1UL
+#define niPCAP_LINKTYPE_ETHERNET	1UL
+
+/*-----------------------------------------------------------*/
+
+/* The global header at the start of a pcap file. */
+typedef struct xPCAP_FILE_HEADER
+{
+	uint32_t ulMagic;
+	uint16_t usVersionMajor;
+	uint16_t usVersionMinor;
+	int32_t lThisZone;
+	uint32_t ulSigFigs;
+	uint32_t ulSnapLength;
+	uint32_t ulLinkType;
+} PcapFileHeader_t;
+
+/* The header in front of every frame in a pcap file. */
+typedef struct xPCAP_RECORD_HEADER
+{
+	uint32_t ulSeconds;
+	uint32_t ulFraction;
+	uint32_t ulCapturedLength;
+	uint32_t ulOriginalLength;
+} PcapRecordHeader_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Open the TAP device or the replay file.  Returns pdPASS on success.
+ */
+static BaseType_t prvOpenInterface( void );
+
+/*
+ * Read one frame into a new network buffer.  Returns NULL when there is no
+ * frame available, or when no network buffer could be obtained.
+ */
+static NetworkBufferDescriptor_t *prvReadFrame( void );
+
+/*
+ * A function that simulates Ethernet interrupts by polling the TAP device or
+ * the replay file for new frames.
+ */
+static void prvInterruptSimulatorTask( void *pvParameters );
+
+/*
+ * Pass a received frame, or a chain of frames when ipconfigUSE_LINKED_RX_MESSAGES
+ * is 1, to the IP-task.  The buffers are released if the IP-task's queue is full.
+ */
+static void prvPassEthMessages( NetworkBufferDescriptor_t *pxDescriptor );
+
+#if defined( configLINUX_PCAP_REPLAY_FILE )
+
+	/*
+	 * Read and check the global header of the replay file.
+	 */
+	static BaseType_t prvReadPcapFileHeader( void );
+
+	/*
+	 * Convert a 32-bit field of the replay file to host byte order.
+	 */
+	static uint32_t prvPcapToHost32( uint32_t ulValue );
+
+	/*
+	 * Append a frame to the output capture file.
+	 */
+	static void prvWritePcapRecord( const uint8_t *pucFrame, size_t uxLength );
+
+#endif /* configLINUX_PCAP_REPLAY_FILE */
+
+/*-----------------------------------------------------------*/
+
+/* The TAP device, or -1 when it has not been opened. */
+static int iTapDevice = -1;
+
+#if defined( configLINUX_PCAP_REPLAY_FILE )
+	/* The file that received frames are read from. */
+	static FILE *pxReplayFile = NULL;
+
+	/* The file that sent frames are written to, if any. */
+	static FILE *pxOutputFile = NULL;
+
+	/* Set when the replay file uses the opposite byte order of the host. */
+	static BaseType_t xReplaySwapped = pdFALSE;
+
+	/* The length of the frame of which the record header has been read, but
+	for which no network buffer was available yet. */
+	static size_t uxPendingReplayLength = 0u;
+#endif /* configLINUX_PCAP_REPLAY_FILE */
+
+/* The handle of the interrupt simulator task, created once. */
+static TaskHandle_t xInterruptSimulatorTask = NULL;
+
+/* Counters for viewing in the debugger only. */
+static volatile uint32_t ulLinuxSendFailures = 0;
+static volatile uint32_t ulLinuxFramesReceived = 0;
+static volatile uint32_t ulLinuxFramesSent = 0;
+static volatile uint32_t ulLinuxRxEvents = 0;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xNetworkInterfaceInitialise( void )
+{
+BaseType_t xReturn = pdPASS;
+
+	if( ( iTapDevice < 0 )
+		#if defined( configLINUX_PCAP_REPLAY_FILE )
+			&& ( pxReplayFile == NULL )
+		#endif
+	  )
+	{
+		xReturn = prvOpenInterface();
+	}
+
+	if( ( xReturn == pdPASS ) && ( xInterruptSimulatorTask == NULL ) )
+	{
+		/* Create a task that simulates an interrupt in a real system.  It
+		polls for frames, then sends a message to the IP task when data is
+		available. */
+		if( xTaskCreate( prvInterruptSimulatorTask,
+						 "MAC_ISR",
+						 configMINIMAL_STACK_SIZE,
+						 NULL,
+						 configMAC_ISR_SIMULATOR_PRIORITY,
+						 &xInterruptSimulatorTask ) != pdPASS )
+		{
+			xReturn = pdFAIL;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xNetworkInterfaceOutput( NetworkBufferDescriptor_t * const pxNetworkBuffer, BaseType_t bReleaseAfterSend )
+{
+	iptraceNETWORK_INTERFACE_TRANSMIT();
+
+	if( pxNetworkBuffer->xDataLength <= niMAX_FRAME_SIZE )
+	{
+		#if defined( configLINUX_PCAP_REPLAY_FILE )
+		{
+			prvWritePcapRecord( pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength );
+			ulLinuxFramesSent++;
+		}
+		#else
+		{
+		ssize_t xWritten;
+
+			/* The frame is written straight from the network buffer.  A TAP
+			device accepts or drops a whole frame at once. */
+			do
+			{
+				xWritten = write( iTapDevice, pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength );
+			} while( ( xWritten < 0 ) && ( errno == EINTR ) );
+
+			if( xWritten == ( ssize_t ) pxNetworkBuffer->xDataLength )
+			{
+				ulLinuxFramesSent++;
+			}
+			else
+			{
+				ulLinuxSendFailures++;
+			}
+		}
+		#endif /* configLINUX_PCAP_REPLAY_FILE */
+	}
+	else
+	{
+		FreeRTOS_debug_printf( ( "xNetworkInterfaceOutput: frame too long %lu\n", ( unsigned long ) pxNetworkBuffer->xDataLength ) );
+		ulLinuxSendFailures++;
+	}
+
+	/* The frame has been written, so the buffer can be released.  When
+	ipconfigZERO_COPY_TX_DRIVER is 1, bReleaseAfterSend is always true. */
+	if( bReleaseAfterSend != pdFALSE )
+	{
+		vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+	}
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+void vNetworkInterfaceAllocateRAMToBuffers( NetworkBufferDescriptor_t pxNetworkBuffers[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ] )
+{
+static uint8_t ucNetworkPackets[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS * niBUFFER_SIZE ] __attribute__ ( ( aligned( 8 ) ) );
+uint8_t *pucRAMBuffer = ucNetworkPackets;
+uint32_t ul;
+
+	/* Only called when BufferAllocation_1.c is used.  The first bytes of the
+	padding in front of each buffer point back to its descriptor, as expected
+	by pxPacketBuffer_to_NetworkBuffer(). */
+	for( ul = 0; ul < ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS; ul++ )
+	{
+		pxNetworkBuffers[ ul ].pucEthernetBuffer = pucRAMBuffer + ipBUFFER_PADDING;
+		*( ( NetworkBufferDescriptor_t ** ) pucRAMBuffer ) = &( pxNetworkBuffers[ ul ] );
+		pucRAMBuffer += niBUFFER_SIZE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvOpenInterface( void )
+{
+BaseType_t xReturn = pdFAIL;
+
+	#if defined( configLINUX_PCAP_REPLAY_FILE )
+	{
+		pxReplayFile = fopen( configLINUX_PCAP_REPLAY_FILE, "rb" );
+
+		if( pxReplayFile == NULL )
+		{
+			printf( "Could not open replay file %s: %s\n", configLINUX_PCAP_REPLAY_FILE, strerror( errno ) );
+		}
+		else if( prvReadPcapFileHeader() == pdPASS )
+		{
+			xReturn = pdPASS;
+
+			#if defined( configLINUX_PCAP_OUTPUT_FILE )
+			{
+			PcapFileHeader_t xHeader;
+
+				pxOutputFile = fopen( configLINUX_PCAP_OUTPUT_FILE, "wb" );
+
+				if( pxOutputFile == NULL )
+				{
+					printf( "Could not open output file %s: %s\n", configLINUX_PCAP_OUTPUT_FILE, strerror( errno ) );
+				}
+				else
+				{
+					/* The output file is always written in host byte order. */
+					xHeader.ulMagic = niPCAP_MAGIC;
+					xHeader.usVersionMajor = 2u;
+					xHeader.usVersionMinor = 4u;
+					xHeader.lThisZone = 0;
+					xHeader.ulSigFigs = 0u;
+					xHeader.ulSnapLength = ( uint32_t ) niMAX_FRAME_SIZE;
+					xHeader.ulLinkType = niPCAP_LINKTYPE_ETHERNET;
+					( void ) fwrite( &xHeader, sizeof( xHeader ), 1u, pxOutputFile );
+				}
+			}
+			#endif /* configLINUX_PCAP_OUTPUT_FILE */
+		}
+		else
+		{
+			fclose( pxReplayFile );
+			pxReplayFile = NULL;
+		}
+	}
+	#else
+	{
+	struct ifreq xRequest;
+	int iFlags;
+
+		iTapDevice = open( "/dev/net/tun", O_RDWR );
+
+		if( iTapDevice < 0 )
+		{
+			printf( "Could not open /dev/net/tun: %s\n", strerror( errno ) );
+		}
+		else
+		{
+			/* Attach to the TAP device.  IFF_NO_PI means that every read or
+			write is exactly one Ethernet frame, without a packet header. */
+			memset( &xRequest, '\0', sizeof( xRequest ) );
+			xRequest.ifr_flags = IFF_TAP | IFF_NO_PI;
+			strncpy( xRequest.ifr_name, configLINUX_TAP_DEVICE_NAME, IFNAMSIZ - 1 );
+
+			if( ioctl( iTapDevice, TUNSETIFF, ( void * ) &xRequest ) < 0 )
+			{
+				printf( "Could not attach to %s: %s\n", configLINUX_TAP_DEVICE_NAME, strerror( errno ) );
+			}
+			else
+			{
+				/* Reads must not block, as they are made from a FreeRTOS task. */
+				iFlags = fcntl( iTapDevice, F_GETFL, 0 );
+
+				if( ( iFlags >= 0 ) && ( fcntl( iTapDevice, F_SETFL, iFlags | O_NONBLOCK ) >= 0 ) )
+				{
+					printf( "Successfully opened %s.\n", configLINUX_TAP_DEVICE_NAME );
+					xReturn = pdPASS;
+				}
+			}
+
+			if( xReturn != pdPASS )
+			{
+				close( iTapDevice );
+				iTapDevice = -1;
+			}
+		}
+	}
+	#endif /* configLINUX_PCAP_REPLAY_FILE */
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static NetworkBufferDescriptor_t *prvReadFrame( void )
+{
+NetworkBufferDescriptor_t *pxNetworkBuffer = NULL;
+
+	#if defined( configLINUX_PCAP_REPLAY_FILE )
+	{
+	PcapRecordHeader_t xRecord;
+	size_t uxCaptured;
+	BaseType_t xHaveRecord = pdTRUE;
+
+		if( uxPendingReplayLength == 0u )
+		{
+			if( fread( &xRecord, sizeof( xRecord ), 1u, pxReplayFile ) != 1u )
+			{
+				#if( configLINUX_PCAP_REPLAY_LOOP == 1 )
+				{
+					/* Start again after the global header. */
+					( void ) fseek( pxReplayFile, ( long ) sizeof( PcapFileHeader_t ), SEEK_SET );
+				}
+				#endif
+
+				xHaveRecord = pdFALSE;
+			}
+			else
+			{
+				uxCaptured = ( size_t ) prvPcapToHost32( xRecord.ulCapturedLength );
+
+				if( uxCaptured > niMAX_FRAME_SIZE )
+				{
+					/* Skip frames that do not fit in a network buffer. */
+					( void ) fseek( pxReplayFile, ( long ) uxCaptured, SEEK_CUR );
+					xHaveRecord = pdFALSE;
+				}
+				else
+				{
+					uxPendingReplayLength = uxCaptured;
+				}
+			}
+		}
+
+		if( xHaveRecord != pdFALSE )
+		{
+			/* In replay mode no frames are dropped for lack of buffers: the
+			frame stays pending until a buffer becomes available. */
+			pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxPendingReplayLength, 0 );
+
+			if( pxNetworkBuffer != NULL )
+			{
+				pxNetworkBuffer->xDataLength = fread( pxNetworkBuffer->pucEthernetBuffer, 1u, uxPendingReplayLength, pxReplayFile );
+				uxPendingReplayLength = 0u;
+			}
+		}
+	}
+	#else
+	{
+	ssize_t xReceived;
+
+		pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( niMAX_FRAME_SIZE, 0 );
+
+		if( pxNetworkBuffer != NULL )
+		{
+			/* The frame is read straight into the network buffer. */
+			do
+			{
+				xReceived = read( iTapDevice, pxNetworkBuffer->pucEthernetBuffer, niMAX_FRAME_SIZE );
+			} while( ( xReceived < 0 ) && ( errno == EINTR ) );
+
+			if( xReceived > 0 )
+			{
+				pxNetworkBuffer->xDataLength = ( size_t ) xReceived;
+			}
+			else
+			{
+				/* EAGAIN: there are no more frames to read. */
+				vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+				pxNetworkBuffer = NULL;
+			}
+		}
+	}
+	#endif /* configLINUX_PCAP_REPLAY_FILE */
+
+	return pxNetworkBuffer;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInterruptSimulatorTask( void *pvParameters )
+{
+NetworkBufferDescriptor_t *pxNetworkBuffer;
+eFrameProcessingResult_t eResult;
+#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+	NetworkBufferDescriptor_t *pxFirstDescriptor = NULL;
+	NetworkBufferDescriptor_t *pxLastDescriptor = NULL;
+	UBaseType_t uxChainLength = 0u;
+#endif
+
+	/* Remove compiler warnings about unused parameters. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Pass on all frames that are available, then let other tasks run. */
+		while( ( pxNetworkBuffer = prvReadFrame() ) != NULL )
+		{
+			ulLinuxFramesReceived++;
+
+			/* Check for minimal size. */
+			if( pxNetworkBuffer->xDataLength >= sizeof( EthernetHeader_t ) )
+			{
+				eResult = ipCONSIDER_FRAME_FOR_PROCESSING( pxNetworkBuffer->pucEthernetBuffer );
+			}
+			else
+			{
+				eResult = eReleaseBuffer;
+			}
+
+			if( eResult != eProcessBuffer )
+			{
+				vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+			}
+			else
+			{
+				#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+				{
+					pxNetworkBuffer->pxNextBuffer = NULL;
+
+					if( pxFirstDescriptor == NULL )
+					{
+						/* Becomes the first message. */
+						pxFirstDescriptor = pxNetworkBuffer;
+					}
+					else
+					{
+						/* Add to the tail. */
+						pxLastDescriptor->pxNextBuffer = pxNetworkBuffer;
+					}
+
+					pxLastDescriptor = pxNetworkBuffer;
+					uxChainLength++;
+
+					if( uxChainLength >= ( UBaseType_t ) configLINUX_MAX_FRAMES_PER_RX_EVENT )
+					{
+						prvPassEthMessages( pxFirstDescriptor );
+						pxFirstDescriptor = NULL;
+						uxChainLength = 0u;
+					}
+				}
+				#else
+				{
+					prvPassEthMessages( pxNetworkBuffer );
+				}
+				#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+			}
+		}
+
+		#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+		{
+			/* Pass the rest of the burst. */
+			if( pxFirstDescriptor != NULL )
+			{
+				prvPassEthMessages( pxFirstDescriptor );
+				pxFirstDescriptor = NULL;
+				uxChainLength = 0u;
+			}
+		}
+		#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+
+		/* There is no real way of simulating an interrupt.  Make sure other
+		tasks can run. */
+		vTaskDelay( configLINUX_MAC_INTERRUPT_SIMULATOR_DELAY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvPassEthMessages( NetworkBufferDescriptor_t *pxDescriptor )
+{
+IPStackEvent_t xRxEvent;
+UBaseType_t uxFrames = 1u;
+
+	#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+	{
+	NetworkBufferDescriptor_t *pxFrame;
+
+		/* Count the frames before the chain is posted: the IP-task may release
+		them as soon as it has the event. */
+		for( pxFrame = pxDescriptor->pxNextBuffer; pxFrame != NULL; pxFrame = pxFrame->pxNextBuffer )
+		{
+			uxFrames++;
+		}
+	}
+	#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+
+	xRxEvent.eEventType = eNetworkRxEvent;
+	xRxEvent.pvData = ( void * ) pxDescriptor;
+
+	/* Data was received and stored.  Send a message to the IP task to let it
+	know. */
+	if( xSendEventStructToIPTask( &xRxEvent, ( TickType_t ) 0 ) == pdFAIL )
+	{
+		/* The buffer(s) could not be sent to the IP-task.  Release them. */
+		#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+		{
+			do
+			{
+				NetworkBufferDescriptor_t *pxNext = pxDescriptor->pxNextBuffer;
+				vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+				pxDescriptor = pxNext;
+			} while( pxDescriptor != NULL );
+		}
+		#else
+		{
+			vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+		}
+		#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+		iptraceETHERNET_RX_EVENT_LOST();
+	}
+	else
+	{
+		/* Trace every frame, not every event, so that the trace does not
+		depend on ipconfigUSE_LINKED_RX_MESSAGES. */
+		while( uxFrames > 0u )
+		{
+			iptraceNETWORK_INTERFACE_RECEIVE();
+			uxFrames--;
+		}
+		ulLinuxRxEvents++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if defined( configLINUX_PCAP_REPLAY_FILE )
+
+	static BaseType_t prvReadPcapFileHeader( void )
+	{
+	PcapFileHeader_t xHeader;
+	BaseType_t xReturn = pdFAIL;
+
+		if( fread( &xHeader, sizeof( xHeader ), 1u, pxReplayFile ) != 1u )
+		{
+			printf( "Replay file %s is too short\n", configLINUX_PCAP_REPLAY_FILE );
+		}
+		else
+		{
+			if( ( xHeader.ulMagic == niPCAP_MAGIC ) || ( xHeader.ulMagic == niPCAP_MAGIC_NSEC ) )
+			{
+				xReplaySwapped = pdFALSE;
+				xReturn = pdPASS;
+			}
+			else if( ( xHeader.ulMagic == niPCAP_MAGIC_SWAPPED ) || ( xHeader.ulMagic == niPCAP_MAGIC_NSEC_SWAPPED ) )
+			{
+				xReplaySwapped = pdTRUE;
+				xReturn = pdPASS;
+			}
+			else
+			{
+				printf( "Replay file %s is not a pcap file\n", configLINUX_PCAP_REPLAY_FILE );
+			}
+
+			if( ( xReturn == pdPASS ) && ( prvPcapToHost32( xHeader.ulLinkType ) != niPCAP_LINKTYPE_ETHERNET ) )
+			{
+				printf( "Replay file %s does not contain Ethernet frames\n", configLINUX_PCAP_REPLAY_FILE );
+				xReturn = pdFAIL;
+			}
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static uint32_t prvPcapToHost32( uint32_t ulValue )
+	{
+		if( xReplaySwapped != pdFALSE )
+		{
+			ulValue = ( ( ulValue & 0x000000ffUL ) << 24 ) |
+					  ( ( ulValue & 0x0000ff00UL ) << 8 ) |
+					  ( ( ulValue & 0x00ff0000UL ) >> 8 ) |
+					  ( ( ulValue & 0xff000000UL ) >> 24 );
+		}
+
+		return ulValue;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvWritePcapRecord( const uint8_t *pucFrame, size_t uxLength )
+	{
+	PcapRecordHeader_t xRecord;
+	struct timeval xNow;
+
+		if( pxOutputFile != NULL )
+		{
+			( void ) gettimeofday( &xNow, NULL );
+
+			xRecord.ulSeconds = ( uint32_t ) xNow.tv_sec;
+			xRecord.ulFraction = ( uint32_t ) xNow.tv_usec;
+			xRecord.ulCapturedLength = ( uint32_t ) uxLength;
+			xRecord.ulOriginalLength = ( uint32_t ) uxLength;
+
+			( void ) fwrite( &xRecord, sizeof( xRecord ), 1u, pxOutputFile );
+			( void ) fwrite( pucFrame, 1u, uxLength, pxOutputFile );
+			( void ) fflush( pxOutputFile );
+		}
+	}
+
+#endif /* configLINUX_PCAP_REPLAY_FILE */
+/*-----------------------------------------------------------*/
@@ -0,0 +1,581 @@
+/*
+ * FreeRTOS+TCP V2.2.1
+ * Copyright (C) 2019 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_freertos_tcp_perf.c
+ * @brief Throughput and latency harness for FreeRTOS+TCP.
+ *
+ * The harness is meant to run on the POSIX simulator with the Linux TAP
+ * network interface, with standard tools on the host side of the TAP device:
+ *
+ * - TCP sink (receive throughput), port perfTCP_PORT:
+ *       iperf -c <FreeRTOS IP> -p 5001 -t 10
+ * - UDP sink (receive rate and loss), port perfUDP_PORT.  The first 4 bytes
+ *   of every datagram are read as a sequence number, as sent by iperf 2:
+ *       iperf -u -c <FreeRTOS IP> -p 5001 -b 50M -t 10
+ * - TCP echo server (latency measured by the host), port perfECHO_PORT.
+ *
+ * When a peer address is given, two clients are started as well:
+ *
+ * - TCP source (transmit throughput) to port perfTCP_PORT of the peer:
+ *       iperf -s -p 5001
+ * - Latency client to port perfECHO_PORT of the peer, which must echo:
+ *       socat TCP-LISTEN:7,fork,reuseaddr EXEC:cat
+ *
+ * Round trips are timed with perfGET_TIME_US(), which reads CLOCK_MONOTONIC
+ * unless a board defines it to read a hardware timer.
+ *
+ * This file is not part of any build target in this tree, because the tree
+ * has no POSIX port of the kernel and no board that uses the Linux network
+ * interface.  It has been compiled to an object file against a host
+ * configuration, but it has not been linked or run.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+
+/* Harness include. */
+#include "iot_freertos_tcp_perf.h"
+
+/**
+ * @brief Configuration for the harness.
+ */
+#ifndef perfTCP_PORT
+    #define perfTCP_PORT                5001
+#endif
+#ifndef perfUDP_PORT
+    #define perfUDP_PORT                5001
+#endif
+#ifndef perfECHO_PORT
+    #define perfECHO_PORT               7
+#endif
+#ifndef perfTASK_PRIORITY
+    #define perfTASK_PRIORITY           ( tskIDLE_PRIORITY + 2 )
+#endif
+#ifndef perfTASK_STACK_SIZE
+    #define perfTASK_STACK_SIZE         ( configMINIMAL_STACK_SIZE * 4 )
+#endif
+#ifndef perfBUFFER_SIZE
+    #define perfBUFFER_SIZE             ( 4 * ipconfigTCP_MSS )
+#endif
+#ifndef perfTCP_WINDOW_SIZE
+    #define perfTCP_WINDOW_SIZE         8 /* Unit: MSS. */
+#endif
+#ifndef perfTCP_SOURCE_BYTES
+    #define perfTCP_SOURCE_BYTES        ( 16UL * 1024UL * 1024UL )
+#endif
+#ifndef perfLATENCY_MESSAGE_SIZE
+    #define perfLATENCY_MESSAGE_SIZE    64
+#endif
+#ifndef perfLATENCY_ROUNDS
+    #define perfLATENCY_ROUNDS          1000
+#endif
+#ifndef perfUDP_REPORT_INTERVAL_MS
+    #define perfUDP_REPORT_INTERVAL_MS  1000
+#endif
+#ifndef perfGET_TIME_US
+    #define perfGET_TIME_US()           prvGetTimeMicroseconds()
+#endif
+#define perfRECEIVE_TIMEOUT_MS          5000
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Accept TCP connections and discard all data, then print the rate.
+ */
+static void prvTCPSinkTask( void * pvParameters );
+
+/**
+ * @brief Receive UDP datagrams and print rate and loss once per interval.
+ */
+static void prvUDPSinkTask( void * pvParameters );
+
+/**
+ * @brief Accept TCP connections and send back all data.
+ */
+static void prvTCPEchoTask( void * pvParameters );
+
+/**
+ * @brief Send perfTCP_SOURCE_BYTES to the peer and print the rate.
+ */
+static void prvTCPSourceTask( void * pvParameters );
+
+/**
+ * @brief Measure round trip times to the echo server of the peer.
+ */
+static void prvLatencyTask( void * pvParameters );
+
+/**
+ * @brief Create a TCP socket with the harness window properties.
+ */
+static Socket_t prvCreateTCPSocket( void );
+
+/**
+ * @brief Create a TCP socket that listens on a port.
+ */
+static Socket_t prvCreateListeningSocket( uint16_t usPort );
+
+/**
+ * @brief Read CLOCK_MONOTONIC of the host in microseconds.
+ */
+static uint64_t prvGetTimeMicroseconds( void );
+
+/**
+ * @brief Compute a rate in kbit/s.
+ */
+static uint32_t prvKbitPerSecond( uint64_t ullBytes,
+                                  TickType_t xTicks );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Address of the peer for the client tasks, in network byte order.
+ */
+static uint32_t ulPerfPeerAddress = 0;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xFreeRTOS_TCP_PerfStart( uint32_t ulPeerAddress )
+{
+    BaseType_t xResult = pdPASS;
+
+    ulPerfPeerAddress = ulPeerAddress;
+
+    if( ( xTaskCreate( prvTCPSinkTask, "PerfTCPSink", perfTASK_STACK_SIZE, NULL, perfTASK_PRIORITY, NULL ) != pdPASS ) ||
+        ( xTaskCreate( prvUDPSinkTask, "PerfUDPSink", perfTASK_STACK_SIZE, NULL, perfTASK_PRIORITY, NULL ) != pdPASS ) ||
+        ( xTaskCreate( prvTCPEchoTask, "PerfEcho", perfTASK_STACK_SIZE, NULL, perfTASK_PRIORITY, NULL ) != pdPASS ) )
+    {
+        xResult = pdFAIL;
+    }
+
+    if( ( xResult == pdPASS ) && ( ulPeerAddress != 0UL ) )
+    {
+        if( ( xTaskCreate( prvTCPSourceTask, "PerfTCPSrc", perfTASK_STACK_SIZE, NULL, perfTASK_PRIORITY, NULL ) != pdPASS ) ||
+            ( xTaskCreate( prvLatencyTask, "PerfLatency", perfTASK_STACK_SIZE, NULL, perfTASK_PRIORITY, NULL ) != pdPASS ) )
+        {
+            xResult = pdFAIL;
+        }
+    }
+
+    return xResult;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeMicroseconds( void )
+{
+    struct timespec xNow;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000ULL ) + ( ( uint64_t ) xNow.tv_nsec / 1000ULL );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvKbitPerSecond( uint64_t ullBytes,
+                                  TickType_t xTicks )
+{
+    uint64_t ullMilliseconds = ( uint64_t ) xTicks * ( uint64_t ) portTICK_PERIOD_MS;
+
+    if( ullMilliseconds == 0ULL )
+    {
+        ullMilliseconds = 1ULL;
+    }
+
+    /* bytes * 8 / ms gives bit/ms, which is kbit/s. */
+    return ( uint32_t ) ( ( ullBytes * 8ULL ) / ullMilliseconds );
+}
+/*-----------------------------------------------------------*/
+
+static Socket_t prvCreateTCPSocket( void )
+{
+    Socket_t xSocket;
+    TickType_t xTimeout = pdMS_TO_TICKS( perfRECEIVE_TIMEOUT_MS );
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+        WinProperties_t xWinProperties;
+    #endif
+
+    xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+
+    if( xSocket != FREERTOS_INVALID_SOCKET )
+    {
+        ( void ) FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+        ( void ) FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_SNDTIMEO, &xTimeout, sizeof( xTimeout ) );
+
+        #if ( ipconfigUSE_TCP_WIN == 1 )
+            {
+                /* Large windows are needed to reach line rate. */
+                memset( &xWinProperties, 0, sizeof( xWinProperties ) );
+                xWinProperties.lTxBufSize = perfTCP_WINDOW_SIZE * ipconfigTCP_MSS;
+                xWinProperties.lTxWinSize = perfTCP_WINDOW_SIZE;
+                xWinProperties.lRxBufSize = perfTCP_WINDOW_SIZE * ipconfigTCP_MSS;
+                xWinProperties.lRxWinSize = perfTCP_WINDOW_SIZE;
+                ( void ) FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_WIN_PROPERTIES, &xWinProperties, sizeof( xWinProperties ) );
+            }
+        #endif
+    }
+
+    return xSocket;
+}
+/*-----------------------------------------------------------*/
+
+static Socket_t prvCreateListeningSocket( uint16_t usPort )
+{
+    Socket_t xSocket = prvCreateTCPSocket();
+    struct freertos_sockaddr xAddress;
+
+    if( xSocket != FREERTOS_INVALID_SOCKET )
+    {
+        xAddress.sin_addr = 0;
+        xAddress.sin_port = FreeRTOS_htons( usPort );
+
+        if( ( FreeRTOS_bind( xSocket, &xAddress, sizeof( xAddress ) ) != 0 ) ||
+            ( FreeRTOS_listen( xSocket, 1 ) != 0 ) )
+        {
+            ( void ) FreeRTOS_closesocket( xSocket );
+            xSocket = FREERTOS_INVALID_SOCKET;
+        }
+    }
+
+    return xSocket;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTCPSinkTask( void * pvParameters )
+{
+    static uint8_t ucBuffer[ perfBUFFER_SIZE ];
+    Socket_t xListeningSocket, xConnectedSocket;
+    struct freertos_sockaddr xClient;
+    socklen_t xSize = sizeof( xClient );
+    uint64_t ullBytes;
+    TickType_t xStartTime;
+    int32_t lReceived;
+
+    ( void ) pvParameters;
+
+    xListeningSocket = prvCreateListeningSocket( perfTCP_PORT );
+    configASSERT( xListeningSocket != FREERTOS_INVALID_SOCKET );
+
+    for( ; ; )
+    {
+        xConnectedSocket = FreeRTOS_accept( xListeningSocket, &xClient, &xSize );
+
+        if( ( xConnectedSocket == NULL ) || ( xConnectedSocket == FREERTOS_INVALID_SOCKET ) )
+        {
+            continue;
+        }
+
+        ullBytes = 0;
+        xStartTime = xTaskGetTickCount();
+
+        /* Discard everything until the peer closes the connection. */
+        while( ( lReceived = FreeRTOS_recv( xConnectedSocket, ucBuffer, sizeof( ucBuffer ), 0 ) ) > 0 )
+        {
+            ullBytes += ( uint64_t ) lReceived;
+        }
+
+        configPRINTF( ( "TCP sink: %lu bytes at %lu kbit/s\r\n",
+                        ( unsigned long ) ullBytes,
+                        ( unsigned long ) prvKbitPerSecond( ullBytes, xTaskGetTickCount() - xStartTime ) ) );
+
+        ( void ) FreeRTOS_shutdown( xConnectedSocket, FREERTOS_SHUT_RDWR );
+        ( void ) FreeRTOS_closesocket( xConnectedSocket );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvUDPSinkTask( void * pvParameters )
+{
+    static uint8_t ucBuffer[ ipconfigNETWORK_MTU ];
+    Socket_t xSocket;
+    struct freertos_sockaddr xAddress;
+    socklen_t xSize = sizeof( xAddress );
+    TickType_t xTimeout = pdMS_TO_TICKS( perfUDP_REPORT_INTERVAL_MS );
+    TickType_t xStartTime;
+    uint64_t ullBytes = 0;
+    uint32_t ulDatagrams = 0, ulLost = 0, ulExpected = 0, ulSequence;
+    int32_t lReceived;
+
+    ( void ) pvParameters;
+
+    xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+    configASSERT( xSocket != FREERTOS_INVALID_SOCKET );
+
+    ( void ) FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+
+    xAddress.sin_addr = 0;
+    xAddress.sin_port = FreeRTOS_htons( perfUDP_PORT );
+    ( void ) FreeRTOS_bind( xSocket, &xAddress, sizeof( xAddress ) );
+
+    xStartTime = xTaskGetTickCount();
+
+    for( ; ; )
+    {
+        lReceived = FreeRTOS_recvfrom( xSocket, ucBuffer, sizeof( ucBuffer ), 0, &xAddress, &xSize );
+
+        if( lReceived >= ( int32_t ) sizeof( ulSequence ) )
+        {
+            ullBytes += ( uint64_t ) lReceived;
+            ulDatagrams++;
+
+            /* iperf 2 puts a sequence number in front of every datagram. A
+             * negative number marks the last datagram of a run. */
+            memcpy( &ulSequence, ucBuffer, sizeof( ulSequence ) );
+            ulSequence = FreeRTOS_ntohl( ulSequence );
+
+            if( ( ulSequence & 0x80000000UL ) == 0UL )
+            {
+                if( ulSequence > ulExpected )
+                {
+                    ulLost += ulSequence - ulExpected;
+                }
+
+                ulExpected = ulSequence + 1UL;
+            }
+        }
+
+        if( ( xTaskGetTickCount() - xStartTime ) >= pdMS_TO_TICKS( perfUDP_REPORT_INTERVAL_MS ) )
+        {
+            if( ulDatagrams > 0UL )
+            {
+                configPRINTF( ( "UDP sink: %lu datagrams, %lu lost, %lu kbit/s\r\n",
+                                ( unsigned long ) ulDatagrams,
+                                ( unsigned long ) ulLost,
+                                ( unsigned long ) prvKbitPerSecond( ullBytes, xTaskGetTickCount() - xStartTime ) ) );
+            }
+            else
+            {
+                /* Nothing was received during the interval: a new run starts
+                 * counting from sequence number 0 again. */
+                ulExpected = 0;
+            }
+
+            ullBytes = 0;
+            ulDatagrams = 0;
+            ulLost = 0;
+            xStartTime = xTaskGetTickCount();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvTCPEchoTask( void * pvParameters )
+{
+    static uint8_t ucBuffer[ perfBUFFER_SIZE ];
+    Socket_t xListeningSocket, xConnectedSocket;
+    struct freertos_sockaddr xClient;
+    socklen_t xSize = sizeof( xClient );
+    int32_t lReceived, lSent, lTotalSent;
+
+    ( void ) pvParameters;
+
+    xListeningSocket = prvCreateListeningSocket( perfECHO_PORT );
+    configASSERT( xListeningSocket != FREERTOS_INVALID_SOCKET );
+
+    for( ; ; )
+    {
+        xConnectedSocket = FreeRTOS_accept( xListeningSocket, &xClient, &xSize );
+
+        if( ( xConnectedSocket == NULL ) || ( xConnectedSocket == FREERTOS_INVALID_SOCKET ) )
+        {
+            continue;
+        }
+
+        while( ( lReceived = FreeRTOS_recv( xConnectedSocket, ucBuffer, sizeof( ucBuffer ), 0 ) ) > 0 )
+        {
+            for( lTotalSent = 0; lTotalSent < lReceived; lTotalSent += lSent )
+            {
+                lSent = FreeRTOS_send( xConnectedSocket, &( ucBuffer[ lTotalSent ] ), ( size_t ) ( lReceived - lTotalSent ), 0 );
+
+                if( lSent <= 0 )
+                {
+                    break;
+                }
+            }
+
+            if( lTotalSent < lReceived )
+            {
+                break;
+            }
+        }
+
+        ( void ) FreeRTOS_shutdown( xConnectedSocket, FREERTOS_SHUT_RDWR );
+        ( void ) FreeRTOS_closesocket( xConnectedSocket );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvTCPSourceTask( void * pvParameters )
+{
+    static uint8_t ucBuffer[ perfBUFFER_SIZE ];
+    Socket_t xSocket;
+    struct freertos_sockaddr xPeer;
+    uint64_t ullBytes = 0;
+    TickType_t xStartTime;
+    int32_t lSent;
+
+    ( void ) pvParameters;
+
+    memset( ucBuffer, 0x5a, sizeof( ucBuffer ) );
+
+    xPeer.sin_addr = ulPerfPeerAddress;
+    xPeer.sin_port = FreeRTOS_htons( perfTCP_PORT );
+
+    xSocket = prvCreateTCPSocket();
+
+    if( ( xSocket != FREERTOS_INVALID_SOCKET ) &&
+        ( FreeRTOS_connect( xSocket, &xPeer, sizeof( xPeer ) ) == 0 ) )
+    {
+        xStartTime = xTaskGetTickCount();
+
+        while( ullBytes < ( uint64_t ) perfTCP_SOURCE_BYTES )
+        {
+            lSent = FreeRTOS_send( xSocket, ucBuffer, sizeof( ucBuffer ), 0 );
+
+            if( lSent <= 0 )
+            {
+                break;
+            }
+
+            ullBytes += ( uint64_t ) lSent;
+        }
+
+        configPRINTF( ( "TCP source: %lu bytes at %lu kbit/s\r\n",
+                        ( unsigned long ) ullBytes,
+                        ( unsigned long ) prvKbitPerSecond( ullBytes, xTaskGetTickCount() - xStartTime ) ) );
+
+        ( void ) FreeRTOS_shutdown( xSocket, FREERTOS_SHUT_RDWR );
+    }
+    else
+    {
+        configPRINTF( ( "TCP source: could not connect to the peer\r\n" ) );
+    }
+
+    if( xSocket != FREERTOS_INVALID_SOCKET )
+    {
+        ( void ) FreeRTOS_closesocket( xSocket );
+    }
+
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvLatencyTask( void * pvParameters )
+{
+    static uint8_t ucMessage[ perfLATENCY_MESSAGE_SIZE ];
+    static uint8_t ucReply[ perfLATENCY_MESSAGE_SIZE ];
+    Socket_t xSocket;
+    struct freertos_sockaddr xPeer;
+    uint64_t ullStartTime, ullRoundTrip, ullTotal = 0, ullMinimum = UINT64_MAX, ullMaximum = 0;
+    BaseType_t xRound = 0;
+    int32_t lReceived, lTotalReceived;
+
+    ( void ) pvParameters;
+
+    memset( ucMessage, 0xa5, sizeof( ucMessage ) );
+
+    xPeer.sin_addr = ulPerfPeerAddress;
+    xPeer.sin_port = FreeRTOS_htons( perfECHO_PORT );
+
+    xSocket = prvCreateTCPSocket();
+
+    if( ( xSocket != FREERTOS_INVALID_SOCKET ) &&
+        ( FreeRTOS_connect( xSocket, &xPeer, sizeof( xPeer ) ) == 0 ) )
+    {
+        for( xRound = 0; xRound < perfLATENCY_ROUNDS; xRound++ )
+        {
+            ullStartTime = perfGET_TIME_US();
+
+            if( FreeRTOS_send( xSocket, ucMessage, sizeof( ucMessage ), 0 ) != ( int32_t ) sizeof( ucMessage ) )
+            {
+                break;
+            }
+
+            for( lTotalReceived = 0; lTotalReceived < ( int32_t ) sizeof( ucReply ); lTotalReceived += lReceived )
+            {
+                lReceived = FreeRTOS_recv( xSocket, &( ucReply[ lTotalReceived ] ), sizeof( ucReply ) - ( size_t ) lTotalReceived, 0 );
+
+                if( lReceived <= 0 )
+                {
+                    break;
+                }
+            }
+
+            if( lTotalReceived < ( int32_t ) sizeof( ucReply ) )
+            {
+                break;
+            }
+
+            /* Round trips are often shorter than a tick, so a microsecond
+             * timer is used in stead of the tick count. */
+            ullRoundTrip = perfGET_TIME_US() - ullStartTime;
+            ullTotal += ullRoundTrip;
+
+            if( ullRoundTrip < ullMinimum )
+            {
+                ullMinimum = ullRoundTrip;
+            }
+
+            if( ullRoundTrip > ullMaximum )
+            {
+                ullMaximum = ullRoundTrip;
+            }
+        }
+
+        if( xRound > 0 )
+        {
+            configPRINTF( ( "Latency: %ld rounds of %d bytes, min %lu us, avg %lu us, max %lu us\r\n",
+                            ( long ) xRound,
+                            ( int ) perfLATENCY_MESSAGE_SIZE,
+                            ( unsigned long ) ullMinimum,
+                            ( unsigned long ) ( ullTotal / ( uint64_t ) xRound ),
+                            ( unsigned long ) ullMaximum ) );
+        }
+
+        ( void ) FreeRTOS_shutdown( xSocket, FREERTOS_SHUT_RDWR );
+    }
+    else
+    {
+        configPRINTF( ( "Latency: could not connect to the peer\r\n" ) );
+    }
+
+    if( xSocket != FREERTOS_INVALID_SOCKET )
+    {
+        ( void ) FreeRTOS_closesocket( xSocket );
+    }
+
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
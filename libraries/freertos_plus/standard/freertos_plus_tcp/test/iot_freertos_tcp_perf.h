@@ -0,0 +1,49 @@
+/*
+ * FreeRTOS+TCP V2.2.1
+ * Copyright (C) 2019 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_freertos_tcp_perf.h
+ * @brief Throughput and latency harness for FreeRTOS+TCP.
+ */
+
+#ifndef _IOT_FREERTOS_TCP_PERF_H_
+#define _IOT_FREERTOS_TCP_PERF_H_
+
+/**
+ * @brief Start the throughput and latency harness.
+ *
+ * Always starts a TCP sink, a UDP sink and a TCP echo server.  When
+ * ulPeerAddress is not 0, also starts a TCP source and a latency client that
+ * connect to that peer.  Results are printed with configPRINTF.
+ *
+ * Must be called after the network is up.
+ *
+ * @param[in] ulPeerAddress IP address of the peer in network byte order, or 0.
+ *
+ * @return pdPASS if all tasks were created; pdFAIL otherwise.
+ */
+BaseType_t xFreeRTOS_TCP_PerfStart( uint32_t ulPeerAddress );
+
+#endif /* ifndef _IOT_FREERTOS_TCP_PERF_H_ */
@@ -30,9 +30,36 @@ uint32_t TEST_FreeRTOS_TCP_prvParseDNSReply( uint8_t * pucUDPPayloadBuffer,
                                              size_t xBufferLength,
                                              TickType_t xIdentifier );
 
+#if ( ipconfigDNS_USE_CALLBACKS == 1 )
+    BaseType_t TEST_FreeRTOS_TCP_xDNSCallbackAttempts( void * pvSearchID );
+#endif
+
 void TEST_FreeRTOS_TCP_prvCheckOptions( FreeRTOS_Socket_t * pxSocket,
                                         NetworkBufferDescriptor_t * pxNetworkBuffer );
 
 void TEST_FreeRTOS_TCP_prvTCPCreateWindow( FreeRTOS_Socket_t * pxSocket );
 
+BaseType_t TEST_FreeRTOS_TCP_prvSendData( FreeRTOS_Socket_t * pxSocket,
+                                          NetworkBufferDescriptor_t ** ppxNetworkBuffer,
+                                          uint32_t ulReceiveLength,
+                                          BaseType_t xSendLength );
+
+#if ( ipconfigTCP_LARGE_SEND != 0 )
+    int32_t TEST_FreeRTOS_TCP_prvTCPLargeSendLength( FreeRTOS_Socket_t * pxSocket,
+                                                     int32_t lStreamPos,
+                                                     int32_t lDataLen );
+
+    int32_t TEST_FreeRTOS_TCP_prvTCPLargeSendAppend( FreeRTOS_Socket_t * pxSocket,
+                                                     uint8_t * pucSendData,
+                                                     int32_t lDataLen,
+                                                     int32_t lMaxLength );
+#endif
+
+#if ( ipconfigTCP_LARGE_SEND != 0 ) && ( ipconfigTCP_LARGE_SEND_OFFLOAD == 0 )
+    BaseType_t TEST_FreeRTOS_TCP_prvTCPLargeSendFrames( FreeRTOS_Socket_t * pxSocket,
+                                                        NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                                        NetworkBufferDescriptor_t ** ppxFrames,
+                                                        BaseType_t xMaxFrames );
+#endif
+
 #endif /* ifndef _AWS_FREERTOS_TCP_TEST_ACCESS_DECLARE_H_ */
@@ -45,4 +45,33 @@ uint32_t TEST_FreeRTOS_TCP_prvParseDNSReply( uint8_t * pucUDPPayloadBuffer,
 }
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigDNS_USE_CALLBACKS == 1 )
+    BaseType_t TEST_FreeRTOS_TCP_xDNSCallbackAttempts( void * pvSearchID )
+    {
+        const ListItem_t * pxIterator;
+        const MiniListItem_t * xEnd = ( const MiniListItem_t * ) listGET_END_MARKER( &xCallbackList );
+        BaseType_t xAttempts = 0;
+
+        vTaskSuspendAll();
+        {
+            for( pxIterator = ( const ListItem_t * ) listGET_NEXT( xEnd );
+                 pxIterator != ( const ListItem_t * ) xEnd;
+                 pxIterator = ( const ListItem_t * ) listGET_NEXT( pxIterator ) )
+            {
+                DNSCallback_t * pxCallback = ( DNSCallback_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+
+                if( pxCallback->pvSearchID == pvSearchID )
+                {
+                    xAttempts = pxCallback->xAttempts;
+                    break;
+                }
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        return xAttempts;
+    }
+/*-----------------------------------------------------------*/
+#endif /* if ( ipconfigDNS_USE_CALLBACKS == 1 ) */
+
 #endif /* ifndef _AWS_FREERTOS_TCP_TEST_ACCESS_DNS_DEFINE_H_ */
@@ -50,4 +50,69 @@ void TEST_FreeRTOS_TCP_prvTCPCreateWindow( FreeRTOS_Socket_t * pxSocket )
 }
 /*-----------------------------------------------------------*/
 
+BaseType_t TEST_FreeRTOS_TCP_prvSendData( FreeRTOS_Socket_t * pxSocket,
+                                          NetworkBufferDescriptor_t ** ppxNetworkBuffer,
+                                          uint32_t ulReceiveLength,
+                                          BaseType_t xSendLength )
+{
+    return prvSendData( pxSocket, ppxNetworkBuffer, ulReceiveLength, xSendLength );
+}
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigTCP_LARGE_SEND != 0 )
+    int32_t TEST_FreeRTOS_TCP_prvTCPLargeSendLength( FreeRTOS_Socket_t * pxSocket,
+                                                     int32_t lStreamPos,
+                                                     int32_t lDataLen )
+    {
+        return prvTCPLargeSendLength( pxSocket, lStreamPos, lDataLen );
+    }
+/*-----------------------------------------------------------*/
+
+    int32_t TEST_FreeRTOS_TCP_prvTCPLargeSendAppend( FreeRTOS_Socket_t * pxSocket,
+                                                     uint8_t * pucSendData,
+                                                     int32_t lDataLen,
+                                                     int32_t lMaxLength )
+    {
+        return prvTCPLargeSendAppend( pxSocket, pucSendData, lDataLen, lMaxLength );
+    }
+/*-----------------------------------------------------------*/
+#endif /* if ( ipconfigTCP_LARGE_SEND != 0 ) */
+
+#if ( ipconfigTCP_LARGE_SEND != 0 ) && ( ipconfigTCP_LARGE_SEND_OFFLOAD == 0 )
+
+    /* Cut a large send into frames as prvTCPLargeSendSlice() does, but return
+     * the frames in stead of sending them.  The first frame is pxNetworkBuffer. */
+    BaseType_t TEST_FreeRTOS_TCP_prvTCPLargeSendFrames( FreeRTOS_Socket_t * pxSocket,
+                                                        NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                                        NetworkBufferDescriptor_t ** ppxFrames,
+                                                        BaseType_t xMaxFrames )
+    {
+        TCPLargeSend_t xLargeSend;
+        NetworkBufferDescriptor_t * pxFrame = pxNetworkBuffer;
+        BaseType_t xCount = 0;
+
+        prvTCPLargeSendStart( pxSocket, &xLargeSend, pxNetworkBuffer );
+
+        while( ( pxFrame != NULL ) && ( xCount < xMaxFrames ) )
+        {
+            #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+                prvTCPLargeSendChecksum( &xLargeSend, pxFrame );
+            #endif
+
+            ppxFrames[ xCount ] = pxFrame;
+            xCount++;
+
+            if( xLargeSend.uxRemaining == 0u )
+            {
+                break;
+            }
+
+            pxFrame = prvTCPLargeSendNext( pxSocket, &xLargeSend, pxFrame );
+        }
+
+        return xCount;
+    }
+/*-----------------------------------------------------------*/
+#endif /* if ( ipconfigTCP_LARGE_SEND != 0 ) && ( ipconfigTCP_LARGE_SEND_OFFLOAD == 0 ) */
+
 #endif /* ifndef _AWS_FREERTOS_TCP_TEST_ACCESS_TCP_DEFINE_H_ */
@@ -30,10 +30,16 @@
 
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
 #include "list.h"
 #include "FreeRTOS_IP.h"
 #include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_ARP.h"
+#include "FreeRTOS_Sockets.h"
 #include "FreeRTOS_DNS.h"
+#include "FreeRTOS_TCP_WIN.h"
+#include "NetworkBufferManagement.h"
 
 /* Test includes. */
 #include "unity_fixture.h"
@@ -43,6 +49,58 @@
 /**
  * @brief Configuration for this test group.
  */
+#ifndef tcptestLOOKUP_SOCKETS
+    #define tcptestLOOKUP_SOCKETS      32
+#endif
+#ifndef tcptestLOOKUP_ITERATIONS
+    #define tcptestLOOKUP_ITERATIONS    20000
+#endif
+#define tcptestLOOKUP_LOCAL_PORT       ( 40000u )
+#define tcptestLOOKUP_REMOTE_PORT      ( 1024u )
+#define tcptestLOOKUP_REMOTE_IP        ( 0x0a000001UL )
+#ifndef tcptestWIN_SEGMENTS
+    #define tcptestWIN_SEGMENTS        32
+#endif
+#ifndef tcptestWIN_ROUNDS
+    #define tcptestWIN_ROUNDS          500
+#endif
+#define tcptestWIN_MSS                 ( 1460UL )
+#define tcptestWIN_LENGTH              ( 2UL * tcptestWIN_SEGMENTS * tcptestWIN_MSS )
+#define tcptestWIN_RX_ISN              ( 0xffff0000UL ) /* Wraps around during the test. */
+#define tcptestWIN_TX_ISN              ( 0xfffff000UL )
+#define tcptestWIN_QUIET_PORT          ( 23u )
+#define tcptestACK_PEER_IP             FreeRTOS_inet_addr_quick( 192, 0, 2, 2 ) /* TEST-NET-1, the ACKs go nowhere. */
+#define tcptestACK_PEER_PORT           ( 1024u )
+#define tcptestTCP_FLAG_ACK            ( 0x10u ) /* As ipTCP_FLAG_ACK in FreeRTOS_TCP_IP.c. */
+#define tcptestTCP_FLAG_PSH            ( 0x08u )
+#define tcptestTCP_FLAG_FIN            ( 0x01u )
+#define tcptestCORRECT_CRC             ( 0xffffu ) /* As ipCORRECT_CRC in FreeRTOS_IP.c. */
+#define tcptestLARGE_OPTIONS           ( 12u )
+#define tcptestLARGE_MSS               ( tcptestWIN_MSS - tcptestLARGE_OPTIONS ) /* Room for the options in a full-sized frame. */
+#define tcptestLARGE_SHORT_LENGTH      ( 100u )
+#define tcptestLARGE_DATA_LENGTH       ( ( ( ipconfigTCP_LARGE_SEND_SEGMENTS - 1u ) * tcptestLARGE_MSS ) + tcptestLARGE_SHORT_LENGTH )
+#define tcptestLARGE_STREAM_LENGTH     ( ( ipconfigTCP_LARGE_SEND_SEGMENTS * tcptestLARGE_MSS ) + 4u )
+#ifndef tcptestCHECKSUM_FUZZ_ROUNDS
+    #define tcptestCHECKSUM_FUZZ_ROUNDS    2000
+#endif
+#ifndef tcptestCHECKSUM_BENCH_ROUNDS
+    #define tcptestCHECKSUM_BENCH_ROUNDS   20000
+#endif
+#define tcptestCHECKSUM_MAX_LENGTH     ( 1500u )
+#ifndef tcptestARP_ITERATIONS
+    #define tcptestARP_ITERATIONS      20000
+#endif
+#define tcptestARP_NETMASK             ( 0x0000ffffUL ) /* 255.255.0.0 in network byte order. */
+#define tcptestDNS_SILENT_SERVER       FreeRTOS_inet_addr_quick( 192, 0, 2, 1 ) /* TEST-NET-1, never answers. */
+#ifndef tcptestBUFFER_ALLOCATION_3
+    #define tcptestBUFFER_ALLOCATION_3    0 /* Set to 1 when the board links BufferAllocation_3.c. */
+#endif
+#ifndef tcptestBUFFER_ROUNDS
+    #define tcptestBUFFER_ROUNDS          5000
+#endif
+#define tcptestBUFFER_TASKS               ( 2 )
+#define tcptestBUFFER_HELD                ( 4 )
+#define tcptestBUFFER_SIZE                ( 128u )
 
 /*
  * @brief Test group definition.
@@ -63,11 +121,41 @@ TEST_GROUP_RUNNER( Full_FREERTOS_TCP )
     RUN_TEST_CASE( Full_FREERTOS_TCP, prvParseDnsResponse );
     RUN_TEST_CASE( Full_FREERTOS_TCP, ulDNSHandlePacket );
 
+    /* DNS cache test. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, DNSCache );
+
+    /* Asynchronous DNS resend test. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, DNSCallbackResend );
+
     /* prvCheckOptions test. */
     RUN_TEST_CASE( Full_FREERTOS_TCP, prvCheckOptions );
 
     /* xProcessReceivedUDPPacket test. */
     RUN_TEST_CASE( Full_FREERTOS_TCP, UDPPacketLength );
+
+    /* pxTCPSocketLookup test. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, pxTCPSocketLookup );
+
+    /* ARP cache lookup test. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, ARPCacheLookup );
+
+    /* TCP sliding window loss recovery test. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, TCPWindowLossRecovery );
+
+    /* TCP large send test. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, TCPWindowLargeSend );
+    RUN_TEST_CASE( Full_FREERTOS_TCP, TCPLargeSendSlice );
+
+    /* TCP delayed ACK test. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, TCPDelayedAck );
+
+    /* Checksum tests. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, usGenerateChecksum );
+    RUN_TEST_CASE( Full_FREERTOS_TCP, usIncrementalChecksum );
+
+    /* Network buffer allocation tests. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, NetworkBufferExhaustion );
+    RUN_TEST_CASE( Full_FREERTOS_TCP, NetworkBufferStress );
 }
 
 TEST( Full_FREERTOS_TCP, prvParseDnsResponse )
@@ -302,6 +390,143 @@ TEST( Full_FREERTOS_TCP, ulDNSHandlePacket )
     TEST_ASSERT_EQUAL_UINT32( 0, ulResult );
 }
 
+TEST( Full_FREERTOS_TCP, DNSCache )
+{
+    #if ( ipconfigUSE_DNS_CACHE == 1 )
+        uint8_t ucTwoAddressResponse[] =
+        {
+            0x12, 0x34, 0x81, 0x80, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x04, 0x74, 0x65, 0x73,
+            0x74, 0x03, 0x63, 0x6f, 0x6d, 0x00, 0x00, 0x01, 0x00, 0x01, 0xc0, 0x0c, 0x00, 0x01, 0x00, 0x01,
+            0x00, 0x00, 0x01, 0x2c, 0x00, 0x04, 0x0a, 0x00, 0x00, 0x01, 0xc0, 0x0c, 0x00, 0x01, 0x00, 0x01,
+            0x00, 0x00, 0x01, 0x2c, 0x00, 0x04, 0x0a, 0x00, 0x00, 0x02
+        };
+        #if ( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 1 )
+            uint8_t ucChangedAddressResponse[] =
+            {
+                0x12, 0x36, 0x81, 0x80, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x04, 0x74, 0x65, 0x73,
+                0x74, 0x03, 0x63, 0x6f, 0x6d, 0x00, 0x00, 0x01, 0x00, 0x01, 0xc0, 0x0c, 0x00, 0x01, 0x00, 0x01,
+                0x00, 0x00, 0x01, 0x2c, 0x00, 0x04, 0x0a, 0x00, 0x00, 0x03, 0xc0, 0x0c, 0x00, 0x01, 0x00, 0x01,
+                0x00, 0x00, 0x01, 0x2c, 0x00, 0x04, 0x0a, 0x00, 0x00, 0x04
+            };
+            const uint32_t ulThirdAddress = FreeRTOS_inet_addr_quick( 10, 0, 0, 3 );
+            const uint32_t ulFourthAddress = FreeRTOS_inet_addr_quick( 10, 0, 0, 4 );
+        #endif
+        uint8_t ucNameErrorResponse[] =
+        {
+            0x12, 0x35, 0x81, 0x83, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x6e, 0x78, 0x04,
+            0x74, 0x65, 0x73, 0x74, 0x03, 0x63, 0x6f, 0x6d, 0x00, 0x00, 0x01, 0x00, 0x01
+        };
+        const uint32_t ulFirstAddress = FreeRTOS_inet_addr_quick( 10, 0, 0, 1 );
+        const uint32_t ulSecondAddress = FreeRTOS_inet_addr_quick( 10, 0, 0, 2 );
+        uint32_t ulAddress;
+
+        FreeRTOS_dnsclear();
+
+        /* The first A record is returned and both are cached. */
+        ulAddress = TEST_FreeRTOS_TCP_prvParseDNSReply(
+            ucTwoAddressResponse,
+            sizeof( ucTwoAddressResponse ),
+            *( uint16_t * ) ucTwoAddressResponse );
+        TEST_ASSERT_EQUAL_UINT32( ulFirstAddress, ulAddress );
+        TEST_ASSERT_EQUAL_UINT32( ulFirstAddress, FreeRTOS_dnslookup( "test.com" ) );
+
+        #if ( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 1 )
+            /* Further look-ups rotate through the cached addresses. */
+            TEST_ASSERT_EQUAL_UINT32( ulSecondAddress, FreeRTOS_dnslookup( "test.com" ) );
+            TEST_ASSERT_EQUAL_UINT32( ulFirstAddress, FreeRTOS_dnslookup( "test.com" ) );
+
+            /* A later reply with other addresses replaces the cached set. */
+            ulAddress = TEST_FreeRTOS_TCP_prvParseDNSReply(
+                ucChangedAddressResponse,
+                sizeof( ucChangedAddressResponse ),
+                *( uint16_t * ) ucChangedAddressResponse );
+            TEST_ASSERT_EQUAL_UINT32( ulThirdAddress, ulAddress );
+            TEST_ASSERT_EQUAL_UINT32( ulThirdAddress, FreeRTOS_dnslookup( "test.com" ) );
+            TEST_ASSERT_EQUAL_UINT32( ulFourthAddress, FreeRTOS_dnslookup( "test.com" ) );
+            TEST_ASSERT_EQUAL_UINT32( ulThirdAddress, FreeRTOS_dnslookup( "test.com" ) );
+        #else
+            ( void ) ulSecondAddress;
+        #endif
+
+        /* An NXDOMAIN reply resolves to nothing. */
+        ulAddress = TEST_FreeRTOS_TCP_prvParseDNSReply(
+            ucNameErrorResponse,
+            sizeof( ucNameErrorResponse ),
+            *( uint16_t * ) ucNameErrorResponse );
+        TEST_ASSERT_EQUAL_UINT32( 0, ulAddress );
+        TEST_ASSERT_EQUAL_UINT32( 0, FreeRTOS_dnslookup( "nx.test.com" ) );
+
+        #if ( ipconfigDNS_CACHE_NEGATIVE_TTL_S != 0 )
+            {
+                TickType_t xStart = xTaskGetTickCount();
+
+                /* The negative entry answers without querying the server. */
+                TEST_ASSERT_EQUAL_UINT32( 0, FreeRTOS_gethostbyname( "nx.test.com" ) );
+                TEST_ASSERT_TRUE( ( xTaskGetTickCount() - xStart ) < ipconfigDNS_RECEIVE_BLOCK_TIME_TICKS );
+            }
+        #endif
+
+        FreeRTOS_dnsclear();
+        TEST_ASSERT_EQUAL_UINT32( 0, FreeRTOS_dnslookup( "test.com" ) );
+    #endif /* if ( ipconfigUSE_DNS_CACHE == 1 ) */
+}
+
+#if ( ipconfigDNS_USE_CALLBACKS == 1 )
+    static volatile BaseType_t xDNSTestCallbacks = 0;
+
+    static void prvDNSTestCallback( const char * pcName,
+                                    void * pvSearchID,
+                                    uint32_t ulIPAddress )
+    {
+        ( void ) pcName;
+        ( void ) pvSearchID;
+        ( void ) ulIPAddress;
+
+        xDNSTestCallbacks++;
+    }
+#endif /* if ( ipconfigDNS_USE_CALLBACKS == 1 ) */
+
+/*
+ * An asynchronous look-up that gets no reply must be sent again by the DNS
+ * timer in the IP-task, without calling the callback, until it is cancelled.
+ * The DNS server is replaced by an address that never answers.
+ */
+TEST( Full_FREERTOS_TCP, DNSCallbackResend )
+{
+    #if ( ipconfigDNS_USE_CALLBACKS == 1 ) && ( ipconfigDNS_REQUEST_ATTEMPTS > 1 )
+        static uint8_t ucSearchID;
+        uint32_t ulSavedDNSServer = 0, ulSilentDNSServer = tcptestDNS_SILENT_SERVER;
+        uint32_t ulAddress = 0;
+        BaseType_t xFirstAttempts = 0, xLaterAttempts = 0, xCancelledAttempts = 0;
+
+        FreeRTOS_GetAddressConfiguration( NULL, NULL, NULL, &ulSavedDNSServer );
+        FreeRTOS_SetAddressConfiguration( NULL, NULL, NULL, &ulSilentDNSServer );
+        xDNSTestCallbacks = 0;
+
+        ulAddress = FreeRTOS_gethostbyname_a( "resend.tcptest.invalid",
+                                              prvDNSTestCallback,
+                                              &ucSearchID,
+                                              ( TickType_t ) ( ( ipconfigDNS_REQUEST_ATTEMPTS + 2 ) *
+                                                               ipconfigDNS_RECEIVE_BLOCK_TIME_TICKS * portTICK_PERIOD_MS ) );
+        xFirstAttempts = TEST_FreeRTOS_TCP_xDNSCallbackAttempts( &ucSearchID );
+
+        /* The DNS timer runs at least once a second. */
+        vTaskDelay( ipconfigDNS_RECEIVE_BLOCK_TIME_TICKS + pdMS_TO_TICKS( 1500 ) );
+        xLaterAttempts = TEST_FreeRTOS_TCP_xDNSCallbackAttempts( &ucSearchID );
+
+        FreeRTOS_gethostbyname_cancel( &ucSearchID );
+        xCancelledAttempts = TEST_FreeRTOS_TCP_xDNSCallbackAttempts( &ucSearchID );
+
+        FreeRTOS_SetAddressConfiguration( NULL, NULL, NULL, &ulSavedDNSServer );
+
+        TEST_ASSERT_EQUAL_UINT32( 0, ulAddress );
+        TEST_ASSERT_EQUAL( 1, xFirstAttempts );
+        TEST_ASSERT_TRUE( xLaterAttempts >= 2 );
+        TEST_ASSERT_EQUAL( 0, xCancelledAttempts );
+        TEST_ASSERT_EQUAL( 0, xDNSTestCallbacks );
+    #endif /* if ( ipconfigDNS_USE_CALLBACKS == 1 ) && ( ipconfigDNS_REQUEST_ATTEMPTS > 1 ) */
+}
+
 TEST( Full_FREERTOS_TCP, prvCheckOptions )
 {
     uint8_t ucDivideByZero[] =
@@ -360,3 +585,1091 @@ TEST( Full_FREERTOS_TCP, UDPPacketLength )
     xReturn = xProcessReceivedUDPPacket( &xNetworkBuffer, usPort );
     TEST_ASSERT_EQUAL_UINT32( pdFAIL, xReturn );
 }
+
+/*
+ * Bind sockets to consecutive local ports, give each a different remote
+ * address, and check that pxTCPSocketLookup() finds all of them.  The time
+ * taken by the lookups is printed for a growing number of sockets, to compare
+ * builds with and without ipconfigUSE_TCP_SOCKET_HASH.  A socket that is put
+ * in listening mode by an application task must be found as well.
+ */
+TEST( Full_FREERTOS_TCP, pxTCPSocketLookup )
+{
+    static Socket_t xSockets[ tcptestLOOKUP_SOCKETS ];
+    Socket_t xListenSocket, xSyncSocket;
+    FreeRTOS_Socket_t * pxSocket = NULL;
+    struct freertos_sockaddr xAddress;
+    BaseType_t xIndex = 0, xCount = 0, xIteration = 0;
+    BaseType_t xResult = 0;
+    TickType_t xStartTime = 0, xElapsed = 0;
+
+    for( xCount = 0; xCount < tcptestLOOKUP_SOCKETS; xCount++ )
+    {
+        xSockets[ xCount ] = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+        TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, xSockets[ xCount ] );
+
+        /* Pretend that the socket is connected to a remote peer.  The address
+         * is set before binding, so the IP-task places the socket in the right
+         * hash table bucket when it binds the socket. */
+        pxSocket = ( FreeRTOS_Socket_t * ) xSockets[ xCount ];
+        pxSocket->u.xTCP.ulRemoteIP = tcptestLOOKUP_REMOTE_IP + ( uint32_t ) xCount;
+        pxSocket->u.xTCP.usRemotePort = ( uint16_t ) ( tcptestLOOKUP_REMOTE_PORT + ( uint16_t ) xCount );
+
+        xAddress.sin_addr = 0;
+        xAddress.sin_port = FreeRTOS_htons( ( uint16_t ) ( tcptestLOOKUP_LOCAL_PORT + ( uint16_t ) xCount ) );
+        xResult = FreeRTOS_bind( xSockets[ xCount ], &xAddress, sizeof( xAddress ) );
+        TEST_ASSERT_EQUAL( 0, xResult );
+
+        /* Measure when the number of sockets reaches a power of two. */
+        if( ( ( xCount + 1 ) & xCount ) == 0 )
+        {
+            xStartTime = xTaskGetTickCount();
+            vTaskSuspendAll();
+            {
+                for( xIteration = 0; xIteration < tcptestLOOKUP_ITERATIONS; xIteration++ )
+                {
+                    xIndex = xIteration % ( xCount + 1 );
+                    pxSocket = pxTCPSocketLookup( 0,
+                                                  tcptestLOOKUP_LOCAL_PORT + ( UBaseType_t ) xIndex,
+                                                  tcptestLOOKUP_REMOTE_IP + ( uint32_t ) xIndex,
+                                                  tcptestLOOKUP_REMOTE_PORT + ( UBaseType_t ) xIndex );
+
+                    if( pxSocket != ( FreeRTOS_Socket_t * ) xSockets[ xIndex ] )
+                    {
+                        break;
+                    }
+                }
+            }
+            ( void ) xTaskResumeAll();
+            xElapsed = xTaskGetTickCount() - xStartTime;
+
+            TEST_ASSERT_EQUAL( tcptestLOOKUP_ITERATIONS, xIteration );
+
+            configPRINTF( ( "pxTCPSocketLookup: %d sockets, %d lookups in %u ms\r\n",
+                            ( int ) ( xCount + 1 ),
+                            ( int ) tcptestLOOKUP_ITERATIONS,
+                            ( unsigned ) ( xElapsed * portTICK_PERIOD_MS ) ) );
+        }
+    }
+
+    /* A segment from an unknown peer must not match any of the sockets. */
+    vTaskSuspendAll();
+    {
+        pxSocket = pxTCPSocketLookup( 0,
+                                      tcptestLOOKUP_LOCAL_PORT,
+                                      tcptestLOOKUP_REMOTE_IP + ( uint32_t ) tcptestLOOKUP_SOCKETS,
+                                      tcptestLOOKUP_REMOTE_PORT );
+    }
+    ( void ) xTaskResumeAll();
+    TEST_ASSERT_NULL( pxSocket );
+
+    /* FreeRTOS_listen() changes the state in this task, and the IP-task moves
+     * the socket to the listening sockets.  Binding another socket waits for
+     * the IP-task, which handles its events in order, so the listening socket
+     * has been moved by the time FreeRTOS_bind() returns. */
+    xListenSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+    TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, xListenSocket );
+    xSyncSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+    TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, xSyncSocket );
+
+    xAddress.sin_port = FreeRTOS_htons( ( uint16_t ) ( tcptestLOOKUP_LOCAL_PORT + ( uint16_t ) tcptestLOOKUP_SOCKETS ) );
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_bind( xListenSocket, &xAddress, sizeof( xAddress ) ) );
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_listen( xListenSocket, 1 ) );
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_bind( xSyncSocket, NULL, 0 ) );
+
+    vTaskSuspendAll();
+    {
+        pxSocket = pxTCPSocketLookup( 0,
+                                      tcptestLOOKUP_LOCAL_PORT + ( UBaseType_t ) tcptestLOOKUP_SOCKETS,
+                                      tcptestLOOKUP_REMOTE_IP,
+                                      tcptestLOOKUP_REMOTE_PORT );
+    }
+    ( void ) xTaskResumeAll();
+    TEST_ASSERT_EQUAL_PTR( xListenSocket, pxSocket );
+
+    ( void ) FreeRTOS_closesocket( xListenSocket );
+    ( void ) FreeRTOS_closesocket( xSyncSocket );
+
+    for( xCount = 0; xCount < tcptestLOOKUP_SOCKETS; xCount++ )
+    {
+        ( void ) FreeRTOS_closesocket( xSockets[ xCount ] );
+    }
+}
+
+/*
+ * Fill the ARP cache with 10, 100 and 500 neighbours (at most
+ * ipconfigARP_CACHE_ENTRIES), check that eARPGetCacheEntry() finds all of them
+ * and print the time taken by the lookups, to compare builds with and without
+ * ipconfigUSE_ARP_CACHE_HASH.  The netmask is widened to 255.255.0.0 while the
+ * scheduler is suspended, so that all neighbours are on the local network.
+ */
+TEST( Full_FREERTOS_TCP, ARPCacheLookup )
+{
+    static const BaseType_t xNeighbours[] = { 10, 100, 500 };
+    BaseType_t xTest = 0, xCount = 0, xIndex = 0, xIteration = 0;
+    uint32_t ulSavedNetMask = 0, ulBase = 0, ulIPAddress = 0;
+    MACAddress_t xMACAddress;
+    eARPLookupResult_t eResult = eARPCacheMiss;
+    TickType_t xStartTime = 0, xElapsed = 0;
+
+    for( xTest = 0; xTest < ( BaseType_t ) ( sizeof( xNeighbours ) / sizeof( xNeighbours[ 0 ] ) ); xTest++ )
+    {
+        xCount = xNeighbours[ xTest ];
+
+        if( xCount > ( BaseType_t ) ipconfigARP_CACHE_ENTRIES )
+        {
+            xCount = ( BaseType_t ) ipconfigARP_CACHE_ENTRIES;
+        }
+
+        /* The tick count does not advance while the scheduler is suspended.
+         * The time includes filling the cache, which is small compared to
+         * the look-ups. */
+        xStartTime = xTaskGetTickCount();
+        vTaskSuspendAll();
+        {
+            ulSavedNetMask = xNetworkAddressing.ulNetMask;
+            xNetworkAddressing.ulNetMask = tcptestARP_NETMASK;
+            ulBase = FreeRTOS_ntohl( *ipLOCAL_IP_ADDRESS_POINTER & tcptestARP_NETMASK ) + 0x8000UL;
+
+            FreeRTOS_ClearARP();
+
+            for( xIndex = 0; xIndex < xCount; xIndex++ )
+            {
+                memset( xMACAddress.ucBytes, 0, sizeof( xMACAddress.ucBytes ) );
+                xMACAddress.ucBytes[ 0 ] = 0x02u; /* Locally administered. */
+                xMACAddress.ucBytes[ 4 ] = ( uint8_t ) ( xIndex >> 8 );
+                xMACAddress.ucBytes[ 5 ] = ( uint8_t ) xIndex;
+                vARPRefreshCacheEntry( &xMACAddress, FreeRTOS_htonl( ulBase + ( uint32_t ) xIndex ) );
+            }
+
+            for( xIteration = 0; xIteration < tcptestARP_ITERATIONS; xIteration++ )
+            {
+                /* Send a few frames to each neighbour in turn. */
+                xIndex = ( xIteration / 4 ) % xCount;
+                ulIPAddress = FreeRTOS_htonl( ulBase + ( uint32_t ) xIndex );
+                eResult = eARPGetCacheEntry( &ulIPAddress, &xMACAddress );
+
+                if( ( eResult != eARPCacheHit ) || ( xMACAddress.ucBytes[ 5 ] != ( uint8_t ) xIndex ) )
+                {
+                    break;
+                }
+            }
+
+            FreeRTOS_ClearARP();
+            xNetworkAddressing.ulNetMask = ulSavedNetMask;
+        }
+        ( void ) xTaskResumeAll();
+        xElapsed = xTaskGetTickCount() - xStartTime;
+
+        TEST_ASSERT_EQUAL( tcptestARP_ITERATIONS, xIteration );
+
+        configPRINTF( ( "eARPGetCacheEntry: %d neighbours, %d lookups in %u ms\r\n",
+                        ( int ) xCount,
+                        ( int ) tcptestARP_ITERATIONS,
+                        ( unsigned ) ( xElapsed * portTICK_PERIOD_MS ) ) );
+    }
+}
+
+/*
+ * Loss injection for the TCP sliding window.  In every round the first of
+ * tcptestWIN_SEGMENTS segments is lost:
+ * - Rx: the other segments arrive and are stored out of order, then the lost
+ *   segment arrives and all data must be passed to the user at once.
+ * - Tx: the peer acknowledges the other segments one by one with a growing
+ *   SACK block, the lost segment is retransmitted, and a final ACK confirms
+ *   all data.
+ * The time taken is printed, to compare builds with and without
+ * ipconfigUSE_TCP_WIN_SEGMENT_INDEX.
+ */
+TEST( Full_FREERTOS_TCP, TCPWindowLossRecovery )
+{
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+        static TCPWindow_t xWindow;
+        BaseType_t xRound = 0, xSegment = 0, xFailed = pdFALSE;
+        BaseType_t xSavedLoggingLevel = xTCPWindowLoggingLevel;
+        int32_t lResult = 0, lPosition = 0;
+        uint32_t ulConfirmed = 0;
+        TickType_t xStartTime = 0, xRxElapsed = 0, xTxElapsed = 0;
+
+        /* The segment pool is shared with the IP-task, so the scheduler is
+         * suspended while the window is in use.  As nothing can be printed
+         * meanwhile, logging is switched off, and the window uses a port for
+         * which ipconfigTCP_MAY_LOG_PORT() suppresses the remaining messages. */
+        xTCPWindowLoggingLevel = 0;
+
+        xStartTime = xTaskGetTickCount();
+        vTaskSuspendAll();
+        {
+            for( xRound = 0; ( xRound < tcptestWIN_ROUNDS ) && ( xFailed == pdFALSE ); xRound++ )
+            {
+                memset( &xWindow, '\0', sizeof( xWindow ) );
+                vTCPWindowCreate( &xWindow, tcptestWIN_LENGTH, tcptestWIN_LENGTH, tcptestWIN_RX_ISN, tcptestWIN_TX_ISN, tcptestWIN_MSS );
+                xWindow.usOurPortNumber = tcptestWIN_QUIET_PORT;
+
+                /* Segment 0 is lost, the others are stored. */
+                for( xSegment = 1; xSegment < tcptestWIN_SEGMENTS; xSegment++ )
+                {
+                    lResult = lTCPWindowRxCheck( &xWindow,
+                                                 tcptestWIN_RX_ISN + ( ( uint32_t ) xSegment * tcptestWIN_MSS ),
+                                                 tcptestWIN_MSS,
+                                                 tcptestWIN_LENGTH );
+
+                    if( lResult != ( int32_t ) ( ( uint32_t ) xSegment * tcptestWIN_MSS ) )
+                    {
+                        xFailed = pdTRUE;
+                    }
+                }
+
+                /* The lost segment arrives and fills the gap. */
+                lResult = lTCPWindowRxCheck( &xWindow, tcptestWIN_RX_ISN, tcptestWIN_MSS, tcptestWIN_LENGTH );
+
+                if( ( lResult != 0 ) ||
+                    ( xWindow.ulUserDataLength != ( ( tcptestWIN_SEGMENTS - 1UL ) * tcptestWIN_MSS ) ) ||
+                    ( xTCPWindowRxEmpty( &xWindow ) == pdFALSE ) )
+                {
+                    xFailed = pdTRUE;
+                }
+
+                vTCPWindowDestroy( &xWindow );
+            }
+        }
+        ( void ) xTaskResumeAll();
+        xRxElapsed = xTaskGetTickCount() - xStartTime;
+
+        TEST_ASSERT_FALSE( xFailed );
+
+        xStartTime = xTaskGetTickCount();
+        vTaskSuspendAll();
+        {
+            for( xRound = 0; ( xRound < tcptestWIN_ROUNDS ) && ( xFailed == pdFALSE ); xRound++ )
+            {
+                memset( &xWindow, '\0', sizeof( xWindow ) );
+                vTCPWindowCreate( &xWindow, tcptestWIN_LENGTH, tcptestWIN_LENGTH, tcptestWIN_RX_ISN, tcptestWIN_TX_ISN, tcptestWIN_MSS );
+                xWindow.usOurPortNumber = tcptestWIN_QUIET_PORT;
+
+                /* Queue and send all segments. */
+                if( lTCPWindowTxAdd( &xWindow, tcptestWIN_SEGMENTS * tcptestWIN_MSS, 0, ( int32_t ) tcptestWIN_LENGTH ) !=
+                    ( int32_t ) ( tcptestWIN_SEGMENTS * tcptestWIN_MSS ) )
+                {
+                    xFailed = pdTRUE;
+                }
+
+                for( xSegment = 0; xSegment < tcptestWIN_SEGMENTS; xSegment++ )
+                {
+                    if( ulTCPWindowTxGet( &xWindow, tcptestWIN_LENGTH, &lPosition ) != tcptestWIN_MSS )
+                    {
+                        xFailed = pdTRUE;
+                    }
+                }
+
+                /* Segment 0 is lost: every ACK repeats it, with a SACK block
+                 * that grows by one segment. */
+                for( xSegment = 1; xSegment < tcptestWIN_SEGMENTS; xSegment++ )
+                {
+                    ulConfirmed = ulTCPWindowTxSack( &xWindow,
+                                                     tcptestWIN_TX_ISN + tcptestWIN_MSS,
+                                                     tcptestWIN_TX_ISN + ( ( uint32_t ) ( xSegment + 1 ) * tcptestWIN_MSS ) );
+
+                    if( ulConfirmed != 0UL )
+                    {
+                        xFailed = pdTRUE;
+                    }
+                }
+
+                /* After three duplicate ACKs, segment 0 is retransmitted. */
+                if( ( ulTCPWindowTxGet( &xWindow, tcptestWIN_LENGTH, &lPosition ) != tcptestWIN_MSS ) || ( lPosition != 0 ) )
+                {
+                    xFailed = pdTRUE;
+                }
+
+                /* And all data is acknowledged. */
+                ulConfirmed = ulTCPWindowTxAck( &xWindow, ( uint32_t ) ( tcptestWIN_TX_ISN + ( tcptestWIN_SEGMENTS * tcptestWIN_MSS ) ) );
+
+                if( ( ulConfirmed != ( tcptestWIN_SEGMENTS * tcptestWIN_MSS ) ) || ( xTCPWindowTxDone( &xWindow ) == pdFALSE ) )
+                {
+                    xFailed = pdTRUE;
+                }
+
+                vTCPWindowDestroy( &xWindow );
+            }
+        }
+        ( void ) xTaskResumeAll();
+        xTxElapsed = xTaskGetTickCount() - xStartTime;
+
+        xTCPWindowLoggingLevel = xSavedLoggingLevel;
+
+        TEST_ASSERT_FALSE( xFailed );
+
+        configPRINTF( ( "TCP window: %d segments, %d rounds: Rx recovery %u ms, Tx recovery %u ms (%d ACKs)\r\n",
+                        ( int ) tcptestWIN_SEGMENTS,
+                        ( int ) tcptestWIN_ROUNDS,
+                        ( unsigned ) ( xRxElapsed * portTICK_PERIOD_MS ),
+                        ( unsigned ) ( xTxElapsed * portTICK_PERIOD_MS ),
+                        ( int ) ( tcptestWIN_ROUNDS * tcptestWIN_SEGMENTS ) ) );
+    #else /* if ( ipconfigUSE_TCP_WIN == 1 ) */
+        TEST_IGNORE_MESSAGE( "ipconfigUSE_TCP_WIN is not enabled." );
+    #endif /* if ( ipconfigUSE_TCP_WIN == 1 ) */
+}
+
+/*
+ * A large send takes the first segment with ulTCPWindowTxGet() and the
+ * segments that follow it with ulTCPWindowTxGetNext().  Check that these are
+ * contiguous in the TX stream, that the room left in the large segment is
+ * respected, and that 'ulOurSequenceNumber' stays at the first segment.
+ * Segments that could not be sent must be fetched again at once after
+ * vTCPWindowTxRequeue(), without waiting for a time-out.
+ */
+TEST( Full_FREERTOS_TCP, TCPWindowLargeSend )
+{
+    #if ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_LARGE_SEND != 0 )
+        static TCPWindow_t xWindow;
+        BaseType_t xSegment = 0;
+        BaseType_t xSavedLoggingLevel = xTCPWindowLoggingLevel;
+        int32_t lPosition = 0;
+        uint32_t ulLength[ 6 ];
+        int32_t lPositions[ 6 ];
+        uint32_t ulOurSequenceNumber = 0, ulShort = 0;
+        uint32_t ulRequeued[ 3 ];
+        int32_t lRequeuedPositions[ 3 ];
+
+        xTCPWindowLoggingLevel = 0;
+
+        vTaskSuspendAll();
+        {
+            memset( &xWindow, '\0', sizeof( xWindow ) );
+            vTCPWindowCreate( &xWindow, tcptestWIN_LENGTH, tcptestWIN_LENGTH, tcptestWIN_RX_ISN, tcptestWIN_TX_ISN, tcptestWIN_MSS );
+            xWindow.usOurPortNumber = tcptestWIN_QUIET_PORT;
+
+            /* Four full segments and a short one. */
+            ( void ) lTCPWindowTxAdd( &xWindow, ( 4UL * tcptestWIN_MSS ) + 100UL, 0, ( int32_t ) tcptestWIN_LENGTH );
+
+            ulLength[ 0 ] = ulTCPWindowTxGet( &xWindow, tcptestWIN_LENGTH, &( lPositions[ 0 ] ) );
+
+            for( xSegment = 1; xSegment < 6; xSegment++ )
+            {
+                ulLength[ xSegment ] = ulTCPWindowTxGetNext( &xWindow, tcptestWIN_LENGTH, 4UL * tcptestWIN_MSS, &( lPositions[ xSegment ] ) );
+            }
+
+            ulOurSequenceNumber = xWindow.ulOurSequenceNumber;
+
+            /* A segment that does not fit in the room left is not taken. */
+            ( void ) lTCPWindowTxAdd( &xWindow, tcptestWIN_MSS, ( int32_t ) ( ( 4UL * tcptestWIN_MSS ) + 100UL ), ( int32_t ) tcptestWIN_LENGTH );
+            ulShort = ulTCPWindowTxGetNext( &xWindow, tcptestWIN_LENGTH, tcptestWIN_MSS - 1UL, &lPosition );
+
+            /* The frames from the third segment onwards were not sent. */
+            vTCPWindowTxRequeue( &xWindow, tcptestWIN_TX_ISN + ( 2UL * tcptestWIN_MSS ) );
+
+            for( xSegment = 0; xSegment < 3; xSegment++ )
+            {
+                ulRequeued[ xSegment ] = ulTCPWindowTxGet( &xWindow, tcptestWIN_LENGTH, &( lRequeuedPositions[ xSegment ] ) );
+            }
+
+            vTCPWindowDestroy( &xWindow );
+        }
+        ( void ) xTaskResumeAll();
+
+        xTCPWindowLoggingLevel = xSavedLoggingLevel;
+
+        for( xSegment = 0; xSegment < 4; xSegment++ )
+        {
+            TEST_ASSERT_EQUAL_UINT32( tcptestWIN_MSS, ulLength[ xSegment ] );
+            TEST_ASSERT_EQUAL_INT32( ( int32_t ) ( ( uint32_t ) xSegment * tcptestWIN_MSS ), lPositions[ xSegment ] );
+        }
+
+        TEST_ASSERT_EQUAL_UINT32( 100UL, ulLength[ 4 ] );
+        TEST_ASSERT_EQUAL_INT32( ( int32_t ) ( 4UL * tcptestWIN_MSS ), lPositions[ 4 ] );
+        TEST_ASSERT_EQUAL_UINT32( 0UL, ulLength[ 5 ] );
+        TEST_ASSERT_EQUAL_UINT32( tcptestWIN_TX_ISN, ulOurSequenceNumber );
+        TEST_ASSERT_EQUAL_UINT32( 0UL, ulShort );
+
+        TEST_ASSERT_EQUAL_UINT32( tcptestWIN_MSS, ulRequeued[ 0 ] );
+        TEST_ASSERT_EQUAL_INT32( ( int32_t ) ( 2UL * tcptestWIN_MSS ), lRequeuedPositions[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT32( tcptestWIN_MSS, ulRequeued[ 1 ] );
+        TEST_ASSERT_EQUAL_INT32( ( int32_t ) ( 3UL * tcptestWIN_MSS ), lRequeuedPositions[ 1 ] );
+        TEST_ASSERT_EQUAL_UINT32( 100UL, ulRequeued[ 2 ] );
+        TEST_ASSERT_EQUAL_INT32( ( int32_t ) ( 4UL * tcptestWIN_MSS ), lRequeuedPositions[ 2 ] );
+    #else /* if ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_LARGE_SEND != 0 ) */
+        TEST_IGNORE_MESSAGE( "ipconfigTCP_LARGE_SEND is not enabled." );
+    #endif /* if ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_LARGE_SEND != 0 ) */
+}
+
+/*
+ * Claim a large send as prvTCPPrepareSend() does, and cut it into frames as
+ * prvTCPLargeSendSlice() does.  The data starts at a sequence number that
+ * wraps around, and the TCP header has options.  Check the IP and TCP
+ * checksums of every frame against a full calculation, and check the
+ * sequence numbers, the payload, and that only the last frame has PSH and FIN.
+ */
+TEST( Full_FREERTOS_TCP, TCPLargeSendSlice )
+{
+    #if ( ipconfigTCP_LARGE_SEND != 0 ) && ( ipconfigTCP_LARGE_SEND_OFFLOAD == 0 ) && ( ipconfigTCP_LARGE_SEND_SEGMENTS > 1 )
+        static FreeRTOS_Socket_t xSocket;
+        static uint8_t ucData[ tcptestLARGE_DATA_LENGTH ];
+        NetworkBufferDescriptor_t * pxFrames[ ipconfigTCP_LARGE_SEND_SEGMENTS + 1 ];
+        NetworkBufferDescriptor_t * pxNetworkBuffer = NULL;
+        TCPPacket_t * pxTCPPacket = NULL;
+        StreamBuffer_t * pxStream = NULL;
+        BaseType_t xSavedLoggingLevel = xTCPWindowLoggingLevel;
+        BaseType_t xFrameCount = 0, xFrame = 0;
+        int32_t lStreamPos = 0, lDataLen = 0, lMaxLength = 0;
+        size_t uxIndex = 0, uxPayload = 0, uxExpected = 0;
+        const size_t uxHeaderLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER + tcptestLARGE_OPTIONS;
+
+        xTCPWindowLoggingLevel = 0;
+
+        for( uxIndex = 0; uxIndex < sizeof( ucData ); uxIndex++ )
+        {
+            ucData[ uxIndex ] = ( uint8_t ) ( ( uxIndex * 7u ) + ( uxIndex >> 8 ) );
+        }
+
+        pxStream = ( StreamBuffer_t * ) pvPortMalloc( sizeof( *pxStream ) - sizeof( pxStream->ucArray ) + tcptestLARGE_STREAM_LENGTH );
+        TEST_ASSERT_NOT_NULL( pxStream );
+        memset( pxStream, '\0', sizeof( *pxStream ) - sizeof( pxStream->ucArray ) );
+        pxStream->LENGTH = tcptestLARGE_STREAM_LENGTH;
+
+        memset( &xSocket, '\0', sizeof( xSocket ) );
+        xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_TCP;
+        xSocket.usLocalPort = tcptestWIN_QUIET_PORT;
+        xSocket.u.xTCP.txStream = pxStream;
+        xSocket.u.xTCP.ulWindowSize = tcptestWIN_LENGTH;
+        vTCPWindowCreate( &( xSocket.u.xTCP.xTCPWindow ), tcptestWIN_LENGTH, tcptestWIN_LENGTH, tcptestWIN_RX_ISN, tcptestWIN_TX_ISN, tcptestLARGE_MSS );
+        xSocket.u.xTCP.xTCPWindow.usOurPortNumber = tcptestWIN_QUIET_PORT;
+
+        /* Full segments, followed by a short one. */
+        TEST_ASSERT_EQUAL_UINT32( sizeof( ucData ), uxStreamBufferAdd( pxStream, 0u, ucData, sizeof( ucData ) ) );
+        ( void ) lTCPWindowTxAdd( &( xSocket.u.xTCP.xTCPWindow ), ( uint32_t ) sizeof( ucData ), 0, ( int32_t ) tcptestWIN_LENGTH );
+
+        /* The first segment, and the segments that may follow it. */
+        lDataLen = ( int32_t ) ulTCPWindowTxGet( &( xSocket.u.xTCP.xTCPWindow ), xSocket.u.xTCP.ulWindowSize, &lStreamPos );
+        TEST_ASSERT_EQUAL_INT32( ( int32_t ) tcptestLARGE_MSS, lDataLen );
+        lMaxLength = TEST_FreeRTOS_TCP_prvTCPLargeSendLength( &xSocket, lStreamPos, lDataLen );
+        TEST_ASSERT_EQUAL_INT32( ( int32_t ) sizeof( ucData ), lMaxLength );
+
+        pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxHeaderLength + tcptestLARGE_MSS, pdMS_TO_TICKS( 1000 ) );
+        TEST_ASSERT_NOT_NULL( pxNetworkBuffer );
+
+        /* The first frame, as prvTCPReturnPacket() passes it. */
+        pxNetworkBuffer->xDataLength = uxHeaderLength + tcptestLARGE_MSS;
+        memset( pxNetworkBuffer->pucEthernetBuffer, '\0', uxHeaderLength );
+        pxTCPPacket = ( TCPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer;
+        pxTCPPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+        pxTCPPacket->xIPHeader.ucVersionHeaderLength = 0x45u;
+        pxTCPPacket->xIPHeader.ucTimeToLive = ( uint8_t ) ipconfigTCP_TIME_TO_LIVE;
+        pxTCPPacket->xIPHeader.ucProtocol = ( uint8_t ) ipPROTOCOL_TCP;
+        pxTCPPacket->xIPHeader.usLength = FreeRTOS_htons( ( uint16_t ) ( uxHeaderLength - ipSIZE_OF_ETH_HEADER + tcptestLARGE_MSS ) );
+        pxTCPPacket->xIPHeader.usIdentification = FreeRTOS_htons( 0x1234u );
+        pxTCPPacket->xIPHeader.ulSourceIPAddress = *ipLOCAL_IP_ADDRESS_POINTER;
+        pxTCPPacket->xIPHeader.ulDestinationIPAddress = tcptestACK_PEER_IP;
+        pxTCPPacket->xTCPHeader.usSourcePort = FreeRTOS_htons( tcptestWIN_QUIET_PORT );
+        pxTCPPacket->xTCPHeader.usDestinationPort = FreeRTOS_htons( tcptestACK_PEER_PORT );
+        pxTCPPacket->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( xSocket.u.xTCP.xTCPWindow.ulOurSequenceNumber );
+        pxTCPPacket->xTCPHeader.ulAckNr = FreeRTOS_htonl( tcptestWIN_RX_ISN );
+        pxTCPPacket->xTCPHeader.ucTCPOffset = ( uint8_t ) ( ( ipSIZE_OF_TCP_HEADER + tcptestLARGE_OPTIONS ) << 2 );
+        pxTCPPacket->xTCPHeader.ucTCPFlags = tcptestTCP_FLAG_ACK | tcptestTCP_FLAG_PSH | tcptestTCP_FLAG_FIN;
+        pxTCPPacket->xTCPHeader.usWindow = FreeRTOS_htons( 0x4000u );
+
+        /* A NOP, a NOP and a time stamp. */
+        pxTCPPacket->xTCPHeader.ucOptdata[ 0 ] = 0x01u;
+        pxTCPPacket->xTCPHeader.ucOptdata[ 1 ] = 0x01u;
+        pxTCPPacket->xTCPHeader.ucOptdata[ 2 ] = 0x08u;
+        pxTCPPacket->xTCPHeader.ucOptdata[ 3 ] = 0x0au;
+        pxTCPPacket->xTCPHeader.ucOptdata[ 4 ] = 0x5au;
+        pxTCPPacket->xTCPHeader.ucOptdata[ 11 ] = 0xa5u;
+
+        ( void ) uxStreamBufferGet( pxStream, ( size_t ) lStreamPos, pxNetworkBuffer->pucEthernetBuffer + uxHeaderLength, ( size_t ) lDataLen, pdTRUE );
+
+        /* The segments that follow are claimed, but not copied. */
+        lMaxLength = TEST_FreeRTOS_TCP_prvTCPLargeSendAppend( &xSocket, pxNetworkBuffer->pucEthernetBuffer + uxHeaderLength, lDataLen, lMaxLength );
+        TEST_ASSERT_EQUAL_INT32( ( int32_t ) sizeof( ucData ), lMaxLength );
+        TEST_ASSERT_EQUAL_UINT32( ( uint32_t ) ( tcptestWIN_TX_ISN + sizeof( ucData ) ), xSocket.u.xTCP.xTCPWindow.tx.ulHighestSequenceNumber );
+        xSocket.u.xTCP.uxLargeSendOffset = ( size_t ) lStreamPos + ( size_t ) lDataLen;
+        xSocket.u.xTCP.uxLargeSendLength = ( size_t ) ( lMaxLength - lDataLen );
+
+        xFrameCount = TEST_FreeRTOS_TCP_prvTCPLargeSendFrames( &xSocket, pxNetworkBuffer, pxFrames, ( BaseType_t ) ( ipconfigTCP_LARGE_SEND_SEGMENTS + 1 ) );
+        TEST_ASSERT_EQUAL( ipconfigTCP_LARGE_SEND_SEGMENTS, xFrameCount );
+        TEST_ASSERT_EQUAL_UINT32( 0u, xSocket.u.xTCP.uxLargeSendLength );
+
+        for( xFrame = 0; xFrame < xFrameCount; xFrame++ )
+        {
+            pxTCPPacket = ( TCPPacket_t * ) pxFrames[ xFrame ]->pucEthernetBuffer;
+            uxExpected = ( xFrame < ( xFrameCount - 1 ) ) ? tcptestLARGE_MSS : tcptestLARGE_SHORT_LENGTH;
+            uxPayload = ( size_t ) FreeRTOS_ntohs( pxTCPPacket->xIPHeader.usLength ) - ( uxHeaderLength - ipSIZE_OF_ETH_HEADER );
+
+            TEST_ASSERT_EQUAL_UINT32( uxExpected, uxPayload );
+            TEST_ASSERT_EQUAL_UINT32( ( uint32_t ) ( tcptestWIN_TX_ISN + ( ( uint32_t ) xFrame * tcptestLARGE_MSS ) ), FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulSequenceNumber ) );
+            TEST_ASSERT_EQUAL_UINT8( ( ipSIZE_OF_TCP_HEADER + tcptestLARGE_OPTIONS ) << 2, pxTCPPacket->xTCPHeader.ucTCPOffset );
+            TEST_ASSERT_EQUAL_UINT8( 0xa5u, pxTCPPacket->xTCPHeader.ucOptdata[ 11 ] );
+            TEST_ASSERT_EQUAL_MEMORY( &( ucData[ ( size_t ) xFrame * tcptestLARGE_MSS ] ), pxFrames[ xFrame ]->pucEthernetBuffer + uxHeaderLength, uxPayload );
+
+            if( xFrame < ( xFrameCount - 1 ) )
+            {
+                TEST_ASSERT_EQUAL_UINT8( tcptestTCP_FLAG_ACK, pxTCPPacket->xTCPHeader.ucTCPFlags );
+            }
+            else
+            {
+                TEST_ASSERT_EQUAL_UINT8( tcptestTCP_FLAG_ACK | tcptestTCP_FLAG_PSH | tcptestTCP_FLAG_FIN, pxTCPPacket->xTCPHeader.ucTCPFlags );
+            }
+
+            #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+                TEST_ASSERT_EQUAL_UINT16( tcptestCORRECT_CRC, usGenerateChecksum( 0UL, ( uint8_t * ) &( pxTCPPacket->xIPHeader.ucVersionHeaderLength ), ipSIZE_OF_IPv4_HEADER ) );
+                TEST_ASSERT_EQUAL_UINT16( tcptestCORRECT_CRC, usGenerateProtocolChecksum( pxFrames[ xFrame ]->pucEthernetBuffer, pxFrames[ xFrame ]->xDataLength, pdFALSE ) );
+            #endif
+        }
+
+        for( xFrame = 0; xFrame < xFrameCount; xFrame++ )
+        {
+            vReleaseNetworkBufferAndDescriptor( pxFrames[ xFrame ] );
+        }
+
+        vTCPWindowDestroy( &( xSocket.u.xTCP.xTCPWindow ) );
+        vPortFree( pxStream );
+        xTCPWindowLoggingLevel = xSavedLoggingLevel;
+    #else /* if ( ipconfigTCP_LARGE_SEND != 0 ) && ( ipconfigTCP_LARGE_SEND_OFFLOAD == 0 ) && ( ipconfigTCP_LARGE_SEND_SEGMENTS > 1 ) */
+        TEST_IGNORE_MESSAGE( "ipconfigTCP_LARGE_SEND is not enabled, or it is offloaded." );
+    #endif /* if ( ipconfigTCP_LARGE_SEND != 0 ) && ( ipconfigTCP_LARGE_SEND_OFFLOAD == 0 ) && ( ipconfigTCP_LARGE_SEND_SEGMENTS > 1 ) */
+}
+
+#if ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_DELAYED_ACK_SEGMENTS > 0 )
+
+    /* Let the socket receive one full-sized segment in order, and pass the ACK
+     * that answers it to prvSendData().  Returns the number of bytes sent, 0 when
+     * the ACK was delayed, or -1 when the segment could not be delivered. */
+    static BaseType_t prvDeliverSegment( FreeRTOS_Socket_t * pxSocket )
+    {
+        NetworkBufferDescriptor_t * pxNetworkBuffer;
+        TCPPacket_t * pxTCPPacket;
+        BaseType_t xResult = -1;
+        const MACAddress_t xPeerMAC = { { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 } };
+
+        pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER,
+                                                            pdMS_TO_TICKS( 1000 ) );
+
+        if( pxNetworkBuffer != NULL )
+        {
+            /* The answer as prvTCPPrepareSend() leaves it: the headers of the
+             * received segment, with only the ACK flag set. */
+            pxNetworkBuffer->xDataLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER;
+            memset( pxNetworkBuffer->pucEthernetBuffer, '\0', pxNetworkBuffer->xDataLength );
+            pxTCPPacket = ( TCPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer;
+            memcpy( &( pxTCPPacket->xEthernetHeader.xSourceAddress ), &xPeerMAC, sizeof( xPeerMAC ) );
+            pxTCPPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+            pxTCPPacket->xIPHeader.ucVersionHeaderLength = 0x45u;
+            pxTCPPacket->xIPHeader.ucProtocol = ( uint8_t ) ipPROTOCOL_TCP;
+            pxTCPPacket->xIPHeader.ulSourceIPAddress = tcptestACK_PEER_IP;
+            pxTCPPacket->xIPHeader.ulDestinationIPAddress = *ipLOCAL_IP_ADDRESS_POINTER;
+            pxTCPPacket->xTCPHeader.usSourcePort = FreeRTOS_htons( tcptestACK_PEER_PORT );
+            pxTCPPacket->xTCPHeader.usDestinationPort = FreeRTOS_htons( tcptestWIN_QUIET_PORT );
+            pxTCPPacket->xTCPHeader.ucTCPOffset = 0x50u;
+            pxTCPPacket->xTCPHeader.ucTCPFlags = tcptestTCP_FLAG_ACK;
+
+            if( lTCPWindowRxCheck( &( pxSocket->u.xTCP.xTCPWindow ),
+                                   pxSocket->u.xTCP.xTCPWindow.rx.ulCurrentSequenceNumber,
+                                   tcptestWIN_MSS,
+                                   tcptestWIN_LENGTH ) == 0 )
+            {
+                xResult = TEST_FreeRTOS_TCP_prvSendData( pxSocket,
+                                                         &pxNetworkBuffer,
+                                                         tcptestWIN_MSS,
+                                                         ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER );
+            }
+
+            /* A delayed ACK is owned by the socket now, and a zero-copy driver
+             * owns a buffer that was sent. */
+            if( ( pxNetworkBuffer != NULL ) && ( pxNetworkBuffer != pxSocket->u.xTCP.pxAckMessage ) )
+            {
+                vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+            }
+        }
+
+        return xResult;
+    }
+
+#endif /* if ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_DELAYED_ACK_SEGMENTS > 0 ) */
+
+/*
+ * Received segments are acknowledged together, but not more than
+ * ipconfigTCP_DELAYED_ACK_SEGMENTS at a time.  Deliver segments in order to an
+ * established socket and check that only the last segment of each group is
+ * answered at once.  Then deliver a group that is one segment short, and
+ * check that the delayed ACK goes out when the socket timer expires.
+ * The ACKs are sent to a TEST-NET-1 address.
+ */
+TEST( Full_FREERTOS_TCP, TCPDelayedAck )
+{
+    #if ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_DELAYED_ACK_SEGMENTS > 0 )
+        static FreeRTOS_Socket_t xSocket;
+        BaseType_t xRound = 0, xSegment = 0, xResult = 0;
+        BaseType_t xSavedLoggingLevel = xTCPWindowLoggingLevel;
+
+        xTCPWindowLoggingLevel = 0;
+
+        memset( &xSocket, '\0', sizeof( xSocket ) );
+        xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_TCP;
+        xSocket.usLocalPort = tcptestWIN_QUIET_PORT;
+        xSocket.u.xTCP.ucTCPState = ( uint8_t ) eESTABLISHED;
+        xSocket.u.xTCP.ulRemoteIP = FreeRTOS_ntohl( tcptestACK_PEER_IP );
+        xSocket.u.xTCP.usRemotePort = tcptestACK_PEER_PORT;
+        xSocket.u.xTCP.usInitMSS = ( uint16_t ) tcptestWIN_MSS;
+        xSocket.u.xTCP.usCurMSS = ( uint16_t ) tcptestWIN_MSS;
+        xSocket.u.xTCP.uxRxStreamSize = tcptestWIN_LENGTH;
+        vTCPWindowCreate( &( xSocket.u.xTCP.xTCPWindow ), tcptestWIN_LENGTH, tcptestWIN_LENGTH, tcptestWIN_RX_ISN, tcptestWIN_TX_ISN, tcptestWIN_MSS );
+        xSocket.u.xTCP.xTCPWindow.usOurPortNumber = tcptestWIN_QUIET_PORT;
+        xSocket.u.xTCP.ulHighestRxAllowed = ( uint32_t ) ( tcptestWIN_RX_ISN + tcptestWIN_LENGTH );
+
+        /* Two groups of segments, each answered by its last segment. */
+        for( xRound = 0; xRound < 2; xRound++ )
+        {
+            for( xSegment = 1; xSegment <= ( BaseType_t ) ipconfigTCP_DELAYED_ACK_SEGMENTS; xSegment++ )
+            {
+                xResult = prvDeliverSegment( &xSocket );
+
+                if( xSegment < ( BaseType_t ) ipconfigTCP_DELAYED_ACK_SEGMENTS )
+                {
+                    TEST_ASSERT_EQUAL( 0, xResult );
+                    TEST_ASSERT_NOT_NULL( xSocket.u.xTCP.pxAckMessage );
+                    TEST_ASSERT_EQUAL_UINT8( ( uint8_t ) xSegment, xSocket.u.xTCP.ucDelayedAckCount );
+                    TEST_ASSERT_NOT_EQUAL( 0, xSocket.u.xTCP.usTimeout );
+                }
+                else
+                {
+                    TEST_ASSERT_EQUAL( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER, xResult );
+                    TEST_ASSERT_NULL( xSocket.u.xTCP.pxAckMessage );
+                    TEST_ASSERT_EQUAL_UINT8( 0u, xSocket.u.xTCP.ucDelayedAckCount );
+                }
+            }
+        }
+
+        #if ( ipconfigTCP_DELAYED_ACK_SEGMENTS > 1 )
+            {
+                /* A group that is one segment short waits for the timer. */
+                for( xSegment = 1; xSegment < ( BaseType_t ) ipconfigTCP_DELAYED_ACK_SEGMENTS; xSegment++ )
+                {
+                    TEST_ASSERT_EQUAL( 0, prvDeliverSegment( &xSocket ) );
+                }
+
+                TEST_ASSERT_NOT_NULL( xSocket.u.xTCP.pxAckMessage );
+
+                /* Expire the timer as xTCPTimerCheck() does. */
+                xSocket.u.xTCP.usTimeout = 0u;
+                ( void ) xTCPSocketCheck( &xSocket );
+
+                TEST_ASSERT_NULL( xSocket.u.xTCP.pxAckMessage );
+                TEST_ASSERT_EQUAL_UINT8( 0u, xSocket.u.xTCP.ucDelayedAckCount );
+
+                /* The next group counts from the start again. */
+                TEST_ASSERT_EQUAL( 0, prvDeliverSegment( &xSocket ) );
+                TEST_ASSERT_EQUAL_UINT8( 1u, xSocket.u.xTCP.ucDelayedAckCount );
+                xSocket.u.xTCP.usTimeout = 0u;
+                ( void ) xTCPSocketCheck( &xSocket );
+                TEST_ASSERT_NULL( xSocket.u.xTCP.pxAckMessage );
+            }
+        #endif /* if ( ipconfigTCP_DELAYED_ACK_SEGMENTS > 1 ) */
+
+        vTCPWindowDestroy( &( xSocket.u.xTCP.xTCPWindow ) );
+        xTCPWindowLoggingLevel = xSavedLoggingLevel;
+    #else /* if ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_DELAYED_ACK_SEGMENTS > 0 ) */
+        TEST_IGNORE_MESSAGE( "ipconfigTCP_DELAYED_ACK_SEGMENTS is not enabled." );
+    #endif /* if ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_DELAYED_ACK_SEGMENTS > 0 ) */
+}
+
+/* A simple and repeatable pseudo random generator for the checksum tests. */
+static uint32_t prvChecksumRandom( void )
+{
+    static uint32_t ulState = 0x12345678UL;
+
+    ulState = ( ulState * 1103515245UL ) + 12345UL;
+
+    return ulState >> 8;
+}
+
+/* The plain RFC 1071 sum, one 16-bit big-endian word at a time, in the format
+ * that usGenerateChecksum() uses. */
+static uint16_t prvReferenceChecksum( uint16_t usSum,
+                                      const uint8_t * pucData,
+                                      size_t uxLength )
+{
+    uint32_t ulSum = usSum;
+    size_t uxIndex = 0;
+
+    for( uxIndex = 0; ( uxIndex + 1u ) < uxLength; uxIndex += 2u )
+    {
+        ulSum += ( ( uint32_t ) pucData[ uxIndex ] << 8 ) | pucData[ uxIndex + 1u ];
+    }
+
+    if( ( uxLength & 1u ) != 0u )
+    {
+        ulSum += ( uint32_t ) pucData[ uxLength - 1u ] << 8;
+    }
+
+    while( ( ulSum >> 16 ) != 0UL )
+    {
+        ulSum = ( ulSum & 0xffffUL ) + ( ulSum >> 16 );
+    }
+
+    return ( uint16_t ) ulSum;
+}
+
+/*
+ * Compare usGenerateChecksum() with the reference for random data, lengths
+ * and alignments, and print the time needed to checksum full-sized frames.
+ * A start value other than 0 is only tested for data starting at an even
+ * address, which is how the stack uses it.
+ */
+TEST( Full_FREERTOS_TCP, usGenerateChecksum )
+{
+    static uint32_t ulBuffer[ ( tcptestCHECKSUM_MAX_LENGTH + 8u ) / 4u ];
+    uint8_t * pucBuffer = ( uint8_t * ) ulBuffer;
+    BaseType_t xRound = 0;
+    size_t uxLength = 0, uxOffset = 0, uxIndex = 0;
+    uint16_t usStart = 0, usResult = 0, usExpected = 0;
+    TickType_t xStartTime = 0, xElapsed = 0;
+
+    for( xRound = 0; xRound < tcptestCHECKSUM_FUZZ_ROUNDS; xRound++ )
+    {
+        uxLength = prvChecksumRandom() % ( tcptestCHECKSUM_MAX_LENGTH + 1u );
+        uxOffset = prvChecksumRandom() % 8u;
+        usStart = ( ( uxOffset & 1u ) == 0u ) ? ( uint16_t ) prvChecksumRandom() : 0u;
+
+        for( uxIndex = 0; uxIndex < uxLength; uxIndex++ )
+        {
+            pucBuffer[ uxOffset + uxIndex ] = ( uint8_t ) prvChecksumRandom();
+        }
+
+        usResult = usGenerateChecksum( usStart, &( pucBuffer[ uxOffset ] ), uxLength );
+        usExpected = prvReferenceChecksum( usStart, &( pucBuffer[ uxOffset ] ), uxLength );
+
+        if( usResult != usExpected )
+        {
+            configPRINTF( ( "usGenerateChecksum: length %u offset %u start %04X: %04X != %04X\r\n",
+                            ( unsigned ) uxLength, ( unsigned ) uxOffset, usStart, usResult, usExpected ) );
+        }
+
+        TEST_ASSERT_EQUAL_UINT16( usExpected, usResult );
+    }
+
+    /* All ones must give 0xFFFF, never 0x0000. */
+    memset( pucBuffer, 0xff, tcptestCHECKSUM_MAX_LENGTH );
+    TEST_ASSERT_EQUAL_UINT16( 0xffffu, usGenerateChecksum( 0UL, pucBuffer, tcptestCHECKSUM_MAX_LENGTH ) );
+
+    xStartTime = xTaskGetTickCount();
+
+    for( xRound = 0; xRound < tcptestCHECKSUM_BENCH_ROUNDS; xRound++ )
+    {
+        usResult += usGenerateChecksum( 0UL, &( pucBuffer[ 2 ] ), tcptestCHECKSUM_MAX_LENGTH - 2u );
+    }
+
+    xElapsed = xTaskGetTickCount() - xStartTime;
+
+    configPRINTF( ( "usGenerateChecksum: %d x %u bytes in %u ms (%04X)\r\n",
+                    ( int ) tcptestCHECKSUM_BENCH_ROUNDS,
+                    ( unsigned ) ( tcptestCHECKSUM_MAX_LENGTH - 2u ),
+                    ( unsigned ) ( xElapsed * portTICK_PERIOD_MS ),
+                    usResult ) );
+}
+
+/*
+ * Change 16-bit and 32-bit fields of random IP headers, update the header
+ * checksum with usIncrementalChecksum16/32(), and compare it with a checksum
+ * of the whole header.
+ */
+TEST( Full_FREERTOS_TCP, usIncrementalChecksum )
+{
+    IPHeader_t xHeader;
+    uint8_t * pucHeader = ( uint8_t * ) &xHeader;
+    BaseType_t xRound = 0;
+    size_t uxIndex = 0;
+    uint16_t usOld = 0, usNew = 0, usUpdated = 0;
+    uint32_t ulOld = 0, ulNew = 0;
+
+    for( xRound = 0; xRound < tcptestCHECKSUM_FUZZ_ROUNDS; xRound++ )
+    {
+        for( uxIndex = 0; uxIndex < sizeof( xHeader ); uxIndex++ )
+        {
+            pucHeader[ uxIndex ] = ( uint8_t ) prvChecksumRandom();
+        }
+
+        xHeader.usHeaderChecksum = 0u;
+        xHeader.usHeaderChecksum = ( uint16_t ) ~usGenerateChecksum( 0UL, pucHeader, sizeof( xHeader ) );
+        xHeader.usHeaderChecksum = FreeRTOS_htons( xHeader.usHeaderChecksum );
+
+        /* A TTL change, as a router would make it. */
+        memcpy( &usOld, &( xHeader.ucTimeToLive ), sizeof( usOld ) );
+        xHeader.ucTimeToLive--;
+        memcpy( &usNew, &( xHeader.ucTimeToLive ), sizeof( usNew ) );
+        usUpdated = usIncrementalChecksum16( xHeader.usHeaderChecksum, usOld, usNew );
+
+        /* An address rewrite. */
+        ulOld = xHeader.ulSourceIPAddress;
+        ulNew = prvChecksumRandom() ^ ( prvChecksumRandom() << 16 );
+        xHeader.ulSourceIPAddress = ulNew;
+        usUpdated = usIncrementalChecksum32( usUpdated, ulOld, ulNew );
+
+        xHeader.usHeaderChecksum = usUpdated;
+        TEST_ASSERT_EQUAL_UINT16( 0xffffu, usGenerateChecksum( 0UL, pucHeader, sizeof( xHeader ) ) );
+    }
+}
+
+#if ( tcptestBUFFER_ALLOCATION_3 == 1 )
+
+    /* Released by prvBufferReleaseTask() while the test task waits for a buffer. */
+    static NetworkBufferDescriptor_t * volatile pxBufferToRelease = NULL;
+
+    static void prvBufferReleaseTask( void * pvParameters )
+    {
+        ( void ) pvParameters;
+
+        vTaskDelay( 2 );
+        vReleaseNetworkBufferAndDescriptor( pxBufferToRelease );
+        vTaskDelete( NULL );
+    }
+
+#endif /* if ( tcptestBUFFER_ALLOCATION_3 == 1 ) */
+
+/*
+ * Take every free network buffer, check that the pool reports itself empty,
+ * and give the buffers back.  The scheduler is suspended, so that the IP-task
+ * does not take or release buffers in the mean time.
+ * With BufferAllocation_3.c, also check the statistics of a request that has
+ * to wait, and that a waiting task is woken when a buffer is released.
+ */
+TEST( Full_FREERTOS_TCP, NetworkBufferExhaustion )
+{
+    static NetworkBufferDescriptor_t * pxBuffers[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ];
+    NetworkBufferDescriptor_t * pxExtra = NULL;
+    UBaseType_t uxFreeBefore = 0, uxFreeEmpty = 0, uxFreeAfter = 0, uxMinimum = 0;
+    BaseType_t xCount = 0, xIndex = 0, xCorrupt = pdFALSE;
+
+    #if ( tcptestBUFFER_ALLOCATION_3 == 1 )
+        UBaseType_t uxFailuresBefore = uxGetNetworkBufferAllocFailures();
+        UBaseType_t uxWaitsBefore = uxGetNetworkBufferAllocWaits();
+        TickType_t xWaitTimeBefore = xGetNetworkBufferTotalWaitTime();
+
+        /* Buffers cached by other cores are counted as free, but can only be
+         * taken once they are back on the shared free lists. */
+        vNetworkBufferFlushCaches();
+    #endif
+
+    vTaskSuspendAll();
+    {
+        uxFreeBefore = uxGetNumberOfFreeNetworkBuffers();
+
+        while( xCount < ( BaseType_t ) ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS )
+        {
+            pxBuffers[ xCount ] = pxGetNetworkBufferWithDescriptor( tcptestBUFFER_SIZE, 0 );
+
+            if( pxBuffers[ xCount ] == NULL )
+            {
+                break;
+            }
+
+            memset( pxBuffers[ xCount ]->pucEthernetBuffer, ( int ) xCount, tcptestBUFFER_SIZE );
+            xCount++;
+        }
+
+        uxFreeEmpty = uxGetNumberOfFreeNetworkBuffers();
+        uxMinimum = uxGetMinimumFreeNetworkBuffers();
+        pxExtra = pxGetNetworkBufferWithDescriptor( tcptestBUFFER_SIZE, 0 );
+
+        /* No two buffers may share storage. */
+        for( xIndex = 0; xIndex < xCount; xIndex++ )
+        {
+            if( pxBuffers[ xIndex ]->pucEthernetBuffer[ tcptestBUFFER_SIZE - 1u ] != ( uint8_t ) xIndex )
+            {
+                xCorrupt = pdTRUE;
+            }
+
+            vReleaseNetworkBufferAndDescriptor( pxBuffers[ xIndex ] );
+        }
+
+        uxFreeAfter = uxGetNumberOfFreeNetworkBuffers();
+    }
+    ( void ) xTaskResumeAll();
+
+    TEST_ASSERT_NULL( pxExtra );
+    TEST_ASSERT_EQUAL( pdFALSE, xCorrupt );
+    TEST_ASSERT_EQUAL( uxFreeBefore, ( UBaseType_t ) xCount );
+    TEST_ASSERT_EQUAL( 0, uxFreeEmpty );
+    TEST_ASSERT_EQUAL( 0, uxMinimum );
+    TEST_ASSERT_EQUAL( uxFreeBefore, uxFreeAfter );
+
+    #if ( tcptestBUFFER_ALLOCATION_3 == 1 )
+    {
+        BaseType_t xWaitFailed = pdFALSE, xTaskCreated = pdFALSE;
+        TickType_t xStartTime = 0, xWoken = 0;
+        NetworkBufferDescriptor_t * pxWoken = NULL;
+
+        /* Empty the pool again, with the scheduler running, and ask for one
+         * more buffer with a block time.  The IP-task may release a buffer in
+         * the mean time, so the request either waits and fails, or gets that
+         * buffer. */
+        vNetworkBufferFlushCaches();
+        xCount = 0;
+
+        while( xCount < ( BaseType_t ) ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS )
+        {
+            pxBuffers[ xCount ] = pxGetNetworkBufferWithDescriptor( tcptestBUFFER_SIZE, 0 );
+
+            if( pxBuffers[ xCount ] == NULL )
+            {
+                break;
+            }
+
+            xCount++;
+        }
+
+        pxExtra = pxGetNetworkBufferWithDescriptor( tcptestBUFFER_SIZE, 2 );
+
+        if( pxExtra == NULL )
+        {
+            xWaitFailed = pdTRUE;
+        }
+        else
+        {
+            vReleaseNetworkBufferAndDescriptor( pxExtra );
+        }
+
+        /* A waiting task is woken as soon as another task releases a buffer,
+         * long before its block time expires. */
+        if( xCount > 0 )
+        {
+            xCount--;
+            pxBufferToRelease = pxBuffers[ xCount ];
+
+            if( xTaskCreate( prvBufferReleaseTask,
+                             "BufRelease",
+                             configMINIMAL_STACK_SIZE,
+                             NULL,
+                             uxTaskPriorityGet( NULL ),
+                             NULL ) == pdPASS )
+            {
+                xTaskCreated = pdTRUE;
+                xStartTime = xTaskGetTickCount();
+                pxWoken = pxGetNetworkBufferWithDescriptor( tcptestBUFFER_SIZE, pdMS_TO_TICKS( 5000 ) );
+                xWoken = xTaskGetTickCount() - xStartTime;
+            }
+            else
+            {
+                vReleaseNetworkBufferAndDescriptor( pxBufferToRelease );
+            }
+        }
+
+        if( pxWoken != NULL )
+        {
+            vReleaseNetworkBufferAndDescriptor( pxWoken );
+        }
+
+        for( xIndex = 0; xIndex < xCount; xIndex++ )
+        {
+            vReleaseNetworkBufferAndDescriptor( pxBuffers[ xIndex ] );
+        }
+
+        TEST_ASSERT_TRUE( uxGetNetworkBufferAllocWaits() >= ( uxWaitsBefore + 1u ) );
+
+        if( xWaitFailed != pdFALSE )
+        {
+            TEST_ASSERT_TRUE( uxGetNetworkBufferAllocFailures() >= ( uxFailuresBefore + 2u ) );
+            TEST_ASSERT_TRUE( xGetNetworkBufferTotalWaitTime() >= ( xWaitTimeBefore + 1u ) );
+            TEST_ASSERT_TRUE( xGetNetworkBufferMaxWaitTime() >= 1u );
+        }
+
+        TEST_ASSERT_TRUE( xTaskCreated );
+        TEST_ASSERT_NOT_NULL( pxWoken );
+        TEST_ASSERT_TRUE( xWoken < pdMS_TO_TICKS( 1000 ) );
+    }
+    #endif /* if ( tcptestBUFFER_ALLOCATION_3 == 1 ) */
+}
+
+/* Shared by the NetworkBufferStress tasks. */
+static SemaphoreHandle_t xBufferStressDone = NULL;
+static volatile BaseType_t xBufferStressCorrupt = pdFALSE;
+
+/*
+ * Take and release small groups of network buffers, and check that no other
+ * task wrote into a buffer while it was held.
+ */
+static void prvBufferStressTask( void * pvParameters )
+{
+    NetworkBufferDescriptor_t * pxHeld[ tcptestBUFFER_HELD ];
+    uint8_t ucPattern = ( uint8_t ) ( ( uintptr_t ) pvParameters );
+    BaseType_t xRound = 0, xIndex = 0;
+    size_t uxOffset = 0;
+
+    for( xRound = 0; xRound < tcptestBUFFER_ROUNDS; xRound++ )
+    {
+        for( xIndex = 0; xIndex < tcptestBUFFER_HELD; xIndex++ )
+        {
+            pxHeld[ xIndex ] = pxGetNetworkBufferWithDescriptor( tcptestBUFFER_SIZE, 1 );
+
+            if( pxHeld[ xIndex ] != NULL )
+            {
+                memset( pxHeld[ xIndex ]->pucEthernetBuffer, ucPattern, tcptestBUFFER_SIZE );
+            }
+        }
+
+        for( xIndex = 0; xIndex < tcptestBUFFER_HELD; xIndex++ )
+        {
+            if( pxHeld[ xIndex ] != NULL )
+            {
+                for( uxOffset = 0; uxOffset < tcptestBUFFER_SIZE; uxOffset++ )
+                {
+                    if( pxHeld[ xIndex ]->pucEthernetBuffer[ uxOffset ] != ucPattern )
+                    {
+                        xBufferStressCorrupt = pdTRUE;
+                    }
+                }
+
+                vReleaseNetworkBufferAndDescriptor( pxHeld[ xIndex ] );
+            }
+        }
+    }
+
+    ( void ) xSemaphoreGive( xBufferStressDone );
+    vTaskDelete( NULL );
+}
+
+/*
+ * Several tasks of the same priority take and release network buffers at the
+ * same time.  The time taken is printed, to compare the buffer allocation
+ * schemes.
+ */
+TEST( Full_FREERTOS_TCP, NetworkBufferStress )
+{
+    BaseType_t xTask = 0, xFinished = 0;
+    TickType_t xStartTime = 0, xElapsed = 0;
+
+    xBufferStressCorrupt = pdFALSE;
+    xBufferStressDone = xSemaphoreCreateCounting( tcptestBUFFER_TASKS, 0 );
+    TEST_ASSERT_NOT_NULL( xBufferStressDone );
+
+    xStartTime = xTaskGetTickCount();
+
+    for( xTask = 0; xTask < tcptestBUFFER_TASKS; xTask++ )
+    {
+        TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvBufferStressTask,
+                                                "BufStress",
+                                                configMINIMAL_STACK_SIZE * 2,
+                                                ( void * ) ( uintptr_t ) ( xTask + 1 ),
+                                                tskIDLE_PRIORITY + 1,
+                                                NULL ) );
+    }
+
+    for( xFinished = 0; xFinished < tcptestBUFFER_TASKS; xFinished++ )
+    {
+        if( xSemaphoreTake( xBufferStressDone, pdMS_TO_TICKS( 60000 ) ) != pdTRUE )
+        {
+            break;
+        }
+    }
+
+    xElapsed = xTaskGetTickCount() - xStartTime;
+    vSemaphoreDelete( xBufferStressDone );
+
+    TEST_ASSERT_EQUAL( tcptestBUFFER_TASKS, xFinished );
+    TEST_ASSERT_EQUAL( pdFALSE, xBufferStressCorrupt );
+
+    configPRINTF( ( "Network buffers: %d tasks, %d x %d alloc/release in %u ms\r\n",
+                    ( int ) tcptestBUFFER_TASKS,
+                    ( int ) tcptestBUFFER_ROUNDS,
+                    ( int ) tcptestBUFFER_HELD,
+                    ( unsigned ) ( xElapsed * portTICK_PERIOD_MS ) ) );
+}
@@ -74,6 +74,10 @@ static void RunTests( void )
         RUN_TEST_GROUP( Common_Unit_Task_Pool );
     #endif
 
+    #if ( testrunnerFULL_STATIC_MEMORY_ENABLED == 1 )
+        RUN_TEST_GROUP( Common_Unit_Static_Memory );
+    #endif
+
     #if ( testrunnerFULL_WIFI_PROVISIONING_ENABLED == 1 )
         RUN_TEST_GROUP( Full_WiFi_Provisioning );
     #endif
@@ -173,6 +177,10 @@ static void RunTests( void )
         RUN_TEST_GROUP( UTIL_Platform_Threads );
     #endif
 
+    #if ( testrunnerUTIL_PLATFORM_NETWORK_ENABLED == 1 )
+        RUN_TEST_GROUP( UTIL_Platform_Network );
+    #endif
+
     #if ( testrunnerFULL_BLE_ENABLED == 1 )
         RUN_TEST_GROUP( Full_BLE );
     #endif
@@ -60,6 +60,9 @@ typedef struct xDNS_Callback {
 	TickType_t xRemaningTime;		/* Timeout in ms */
 	FOnDNSEvent pCallbackFunction;	/* Function to be called when the address has been found or when a timeout has beeen reached */
 	TimeOut_t xTimeoutState;
+	TickType_t xResendTime;			/* Ticks until the request is sent again */
+	TimeOut_t xResendState;
+	BaseType_t xAttempts;			/* The number of times the request has been sent */
 	void *pvSearchID;
 	struct xLIST_ITEM xListItem;
 	char pcName[ 1 ];
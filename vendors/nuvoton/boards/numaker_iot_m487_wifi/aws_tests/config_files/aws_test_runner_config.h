@@ -62,6 +62,7 @@
 #define testrunnerFULL_SERIALIZER_ENABLED             0
 #define testrunnerUTIL_PLATFORM_CLOCK_ENABLED         0
 #define testrunnerUTIL_PLATFORM_THREADS_ENABLED       0
+#define testrunnerUTIL_PLATFORM_NETWORK_ENABLED       0
 #define testrunnerFULL_HTTPS_CLIENT_ENABLED           0
 
 /* On systems using FreeRTOS+TCP (such as this one) the TCP segments must be